@@ -0,0 +1,357 @@
+// Copyright (c) 2014, Michael Boyle
+// See LICENSE file for details
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "Errors.hpp"
+#include "Utilities.hpp"
+#include "Quaternions.hpp"
+#include "Waveforms.hpp"
+#include "WaveformsAtAPointFT.hpp"
+#include "Scri.hpp"
+#include "Synthetic.hpp"
+using namespace std;
+using Quaternions::Quaternion;
+
+// To build this program, change any necessary paths in the
+// accompanying Makefile, and run 'make' (or 'make bench' from the top
+// directory).  Run it as
+//
+//   ./bench [EllMax [NTimes [Repetitions [Name]]]]
+//
+// Each benchmark operates on synthetic waveforms with all modes from
+// ell=2 through EllMax at NTimes uniformly spaced times.  One line of
+// JSON is printed for each benchmark, giving the best and mean wall
+// time over the repetitions, the throughput in samples*modes per
+// second, and the peak resident set size of the process so far.
+// Because the peak RSS only ever grows, pass a benchmark Name to run
+// just that one when its own memory footprint is needed.  Anything
+// the library prints while running is redirected to stderr, so stdout
+// contains only the results.
+
+namespace {
+
+  double WallTime() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + 1.e-6*now.tv_usec;
+  }
+
+  long PeakRSSkB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+    return usage.ru_maxrss/1024; // bytes on OS X
+    #else
+    return usage.ru_maxrss; // kilobytes on linux
+    #endif
+  }
+
+  struct Settings {
+    int EllMax;
+    int NTimes;
+    int Repetitions;
+    string Only; // Name of the single benchmark to run, if not empty
+  };
+
+  bool Selected(const Settings& S, const string& Name) {
+    return (S.Only.empty() || S.Only==Name);
+  }
+
+  // Base class for the individual benchmarks.  `Setup` is called
+  // (untimed) before each repetition; `Run` is what is timed; and
+  // `Work` is the number of samples*modes processed by one `Run`.
+  // Expensive preparation belongs in the constructors, so that it is
+  // skipped for benchmarks that are not selected.
+  class Benchmark {
+  public:
+    virtual ~Benchmark() { }
+    virtual void Setup() { }
+    virtual void Run() = 0;
+    virtual double Work() const = 0;
+  };
+
+  class FileConstructorBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+    string FileName, DataFormat;
+  public:
+    FileConstructorBenchmark(const GWFrames::Waveform& w, const string& Format)
+      : W(w), FileName(Format=="Binary" ? "BenchWaveform.bin" : (Format=="H5" ? "BenchWaveform.h5" : "BenchWaveform.dat")),
+        DataFormat(Format)
+    { W.Output(FileName); }
+    ~FileConstructorBenchmark() { std::remove(FileName.c_str()); }
+    void Run() { GWFrames::Waveform R(FileName, DataFormat); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  class InterpolateBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+    vector<double> NewTime;
+  public:
+    InterpolateBenchmark(const GWFrames::Waveform& w) : W(w), NewTime(w.NTimes()-1) {
+      for(unsigned int i_t=0; i_t<NewTime.size(); ++i_t) { NewTime[i_t] = 0.5*(W.T(i_t)+W.T(i_t+1)); }
+    }
+    void Run() { W.Interpolate(NewTime); }
+    double Work() const { return double(NewTime.size())*W.NModes(); }
+  };
+
+  class CorotatingFrameBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+    GWFrames::Waveform Copy;
+  public:
+    CorotatingFrameBenchmark(const GWFrames::Waveform& w) : W(w), Copy() { }
+    void Setup() { Copy = W; }
+    void Run() { Copy.TransformToCorotatingFrame(); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  class LLDominantEigenvectorBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+  public:
+    LLDominantEigenvectorBenchmark(const GWFrames::Waveform& w) : W(w) { }
+    void Run() { W.LLDominantEigenvector(); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  class EvaluateAtPointBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+  public:
+    EvaluateAtPointBenchmark(const GWFrames::Waveform& w) : W(w) { }
+    void Run() { W.EvaluateAtPoint(0.7, 0.3); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  class HybridizeBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+    GWFrames::Waveform A, B;
+    double t1, t2;
+  public:
+    HybridizeBenchmark(const GWFrames::Waveform& w)
+      : W(w), A(), B(), t1(w.T(0)+0.4*(w.T(w.NTimes()-1)-w.T(0))), t2(w.T(0)+0.6*(w.T(w.NTimes()-1)-w.T(0)))
+    {
+      A = W.SliceOfTimes(W.T(0), t2+10*TimeStep);
+      B = W.SliceOfTimes(t1-10*TimeStep, W.T(W.NTimes()-1));
+    }
+    void Run() { A.Hybridize(B, t1, t2); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  class AlignWaveformsBenchmark : public Benchmark {
+    GWFrames::Waveform A0, B0, A, B;
+    double t1, t2;
+  public:
+    AlignWaveformsBenchmark(const GWFrames::Waveform& w) : A0(w), B0(w), A(), B(), t1(0), t2(0) {
+      A0.TransformToCorotatingFrame();
+      B0 = A0;
+      B0.SetTime(B0.T()+3.0);
+      t1 = B0.T(0) + 0.4*(A0.T(A0.NTimes()-1)-B0.T(0));
+      t2 = B0.T(0) + 0.6*(A0.T(A0.NTimes()-1)-B0.T(0));
+    }
+    void Setup() { A = A0; B = B0; }
+    void Run() { GWFrames::AlignWaveforms(A, B, t1, t2); }
+    double Work() const { return double(A0.NTimes())*A0.NModes(); }
+  };
+
+  class WaveformAtAPointFTBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+  public:
+    WaveformAtAPointFTBenchmark(const GWFrames::Waveform& w) : W(w) { }
+    void Run() { GWFrames::WaveformAtAPointFT F(W, TimeStep, 0.7, 0.3, 60.0); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  class MatchBenchmark : public Benchmark {
+    GWFrames::WaveformAtAPointFT F1, F2;
+    vector<double> InversePSD;
+  public:
+    MatchBenchmark(const GWFrames::Waveform& w)
+      : F1(w, TimeStep, 0.7, 0.3, 60.0), F2(), InversePSD()
+    {
+      GWFrames::Waveform Shifted(w);
+      Shifted.SetTime(Shifted.T()+3.0);
+      F2 = GWFrames::WaveformAtAPointFT(Shifted, TimeStep, 0.7, 0.3, 60.0);
+      InversePSD = F1.InversePSD();
+    }
+    void Run() { F1.Match(F2, InversePSD); }
+    double Work() const { return double(F1.NFreq()); }
+  };
+
+  // With ReuseContext, one BMSTransformationContext is built for all
+  // the slices, rather than one for each
+  class BMSTransformationBenchmark : public Benchmark {
+    GWFrames::Scri S;
+    vector<double> u0;
+    GWFrames::ThreeVector v;
+    GWFrames::Modes delta;
+    bool ReuseContext;
+  public:
+    BMSTransformationBenchmark(const int EllMax, const int NTimes, const bool Reuse=false)
+      : S(SyntheticScri(EllMax, NTimes)), u0(16), v(3, 0.0), delta(), ReuseContext(Reuse)
+    {
+      // Sixteen slices spread through the middle half of the data
+      const vector<double> T = S.T();
+      for(unsigned int i=0; i<u0.size(); ++i) {
+        u0[i] = T[T.size()/4] + (T[3*T.size()/4]-T[T.size()/4])*i/double(u0.size());
+      }
+      v[0] = 0.01;
+      vector<complex<double> > Delta((EllMax+1)*(EllMax+1), 0.0);
+      Delta[0] = 0.1;
+      delta = GWFrames::Modes(0, Delta);
+    }
+    void Run() {
+      if(ReuseContext) {
+        const GWFrames::BMSTransformationContext Context(S.EllMax(), v, delta);
+        for(unsigned int i=0; i<u0.size(); ++i) { S.BMSTransformation(u0[i], Context, delta); }
+      } else {
+        for(unsigned int i=0; i<u0.size(); ++i) { S.BMSTransformation(u0[i], v, delta); }
+      }
+    }
+    double Work() const { return 7.0*u0.size()*(S.EllMax()+1)*(S.EllMax()+1); }
+  };
+
+  class TranslateBenchmark : public Benchmark {
+    const GWFrames::Waveform& W;
+    vector<vector<double> > deltax;
+  public:
+    TranslateBenchmark(const GWFrames::Waveform& w) : W(w), deltax(w.NTimes(), vector<double>(3)) {
+      for(unsigned int i_t=0; i_t<deltax.size(); ++i_t) {
+        deltax[i_t][0] = 0.1;
+        deltax[i_t][1] = -0.2;
+        deltax[i_t][2] = 0.05;
+      }
+    }
+    void Run() { W.Translate(deltax); }
+    double Work() const { return double(W.NTimes())*W.NModes(); }
+  };
+
+  // Escape a string for output as JSON
+  string JSONString(const string& s) {
+    string Escaped = "\"";
+    for(unsigned int i=0; i<s.size(); ++i) {
+      if(s[i]=='"' || s[i]=='\\') { Escaped += '\\'; }
+      Escaped += s[i];
+    }
+    return Escaped + "\"";
+  }
+
+  // Time the benchmark and print the result as one line of JSON
+  void Time(const string& Name, Benchmark& B, const Settings& S) {
+    const int Repetitions = S.Repetitions;
+    vector<double> Seconds(Repetitions);
+    std::streambuf* Output = cout.rdbuf(cerr.rdbuf());
+    for(int i_r=0; i_r<Repetitions; ++i_r) {
+      B.Setup();
+      const double Start = WallTime();
+      B.Run();
+      Seconds[i_r] = WallTime()-Start;
+    }
+    cout.rdbuf(Output);
+    const double Best = *std::min_element(Seconds.begin(), Seconds.end());
+    double Mean = 0.0;
+    for(int i_r=0; i_r<Repetitions; ++i_r) { Mean += Seconds[i_r]/Repetitions; }
+    cout.precision(6);
+    cout << "{\"benchmark\": " << JSONString(Name)
+         << ", \"ell_max\": " << S.EllMax
+         << ", \"n_times\": " << S.NTimes
+         << ", \"repetitions\": " << Repetitions
+         << ", \"threads\": " << GWFrames::MaxThreads()
+         << ", \"best_seconds\": " << Best
+         << ", \"mean_seconds\": " << Mean
+         << ", \"samples_modes_per_second\": " << (Best>0.0 ? B.Work()/Best : 0.0)
+         << ", \"peak_rss_kb\": " << PeakRSSkB()
+         << "}" << endl;
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+  Settings S;
+  S.EllMax = (argc>1 ? atoi(argv[1]) : 8);
+  S.NTimes = (argc>2 ? atoi(argv[2]) : 20000);
+  S.Repetitions = (argc>3 ? atoi(argv[3]) : 3);
+  S.Only = (argc>4 ? argv[4] : "");
+  if(S.EllMax<2 || S.NTimes<100 || S.Repetitions<1) {
+    cerr << "Usage: " << argv[0] << " [EllMax>=2 [NTimes>=100 [Repetitions>=1 [Name]]]]" << endl;
+    return 1;
+  }
+
+  try {
+    const GWFrames::Waveform W = SyntheticWaveform(2, S.EllMax, S.NTimes);
+    if(Selected(S, "Waveform(FileName, ReIm)")) {
+      FileConstructorBenchmark B(W, "ReIm");
+      Time("Waveform(FileName, ReIm)", B, S);
+    }
+    if(Selected(S, "Waveform(FileName, Binary)")) {
+      FileConstructorBenchmark B(W, "Binary");
+      Time("Waveform(FileName, Binary)", B, S);
+    }
+    #ifdef USE_HDF5
+    if(Selected(S, "Waveform(FileName, H5)")) {
+      FileConstructorBenchmark B(W, "H5");
+      Time("Waveform(FileName, H5)", B, S);
+    }
+    #endif
+    if(Selected(S, "Interpolate")) {
+      InterpolateBenchmark B(W);
+      Time("Interpolate", B, S);
+    }
+    if(Selected(S, "TransformToCorotatingFrame")) {
+      CorotatingFrameBenchmark B(W);
+      Time("TransformToCorotatingFrame", B, S);
+    }
+    if(Selected(S, "LLDominantEigenvector")) {
+      LLDominantEigenvectorBenchmark B(W);
+      Time("LLDominantEigenvector", B, S);
+    }
+    if(Selected(S, "EvaluateAtPoint")) {
+      EvaluateAtPointBenchmark B(W);
+      Time("EvaluateAtPoint", B, S);
+    }
+    if(Selected(S, "Hybridize")) {
+      HybridizeBenchmark B(W);
+      Time("Hybridize", B, S);
+    }
+    if(Selected(S, "AlignWaveforms")) {
+      AlignWaveformsBenchmark B(W);
+      Time("AlignWaveforms", B, S);
+    }
+    if(Selected(S, "WaveformAtAPointFT")) {
+      WaveformAtAPointFTBenchmark B(W);
+      Time("WaveformAtAPointFT", B, S);
+    }
+    if(Selected(S, "WaveformAtAPointFT::Match")) {
+      MatchBenchmark B(W);
+      Time("WaveformAtAPointFT::Match", B, S);
+    }
+    if(Selected(S, "Scri::BMSTransformation")) {
+      BMSTransformationBenchmark B(S.EllMax, S.NTimes);
+      Time("Scri::BMSTransformation", B, S);
+    }
+    if(Selected(S, "Scri::BMSTransformation(Context)")) {
+      BMSTransformationBenchmark B(S.EllMax, S.NTimes, true);
+      Time("Scri::BMSTransformation(Context)", B, S);
+    }
+    if(Selected(S, "Translate")) {
+      TranslateBenchmark B(W);
+      Time("Translate", B, S);
+    }
+    // With USE_INSTRUMENTATION, show where the time went
+    if(GWFrames::InstrumentationEnabled()) {
+      cerr << GWFrames::InstrumentationSummary() << flush;
+    }
+  } catch(int i) {
+    cerr << "Benchmark failed with GWFrames error code " << i << endl;
+    return 1;
+  }
+
+  return 0;
+}
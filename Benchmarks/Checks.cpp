@@ -0,0 +1,265 @@
+// Copyright (c) 2014, Michael Boyle
+// See LICENSE file for details
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include "Errors.hpp"
+#include "Utilities.hpp"
+#include "Quaternions.hpp"
+#include "Waveforms.hpp"
+#include "Scri.hpp"
+#include "Synthetic.hpp"
+using namespace std;
+
+// To build this program, change any necessary paths in the
+// accompanying Makefile, and run 'make check'.  Each check exercises
+// one part of the library end to end on synthetic data, and prints
+// one line beginning with PASS or FAIL.  The exit status is the
+// number of checks that failed.
+
+namespace {
+
+  // Largest absolute difference between the modes of A and B, with
+  // missing modes taken to be zero
+  double MaxDifference(const GWFrames::Modes& A, const GWFrames::Modes& B) {
+    double Max = 0.0;
+    for(unsigned int i_m=0; i_m<std::max(A.size(), B.size()); ++i_m) {
+      const complex<double> a = (i_m<A.size() ? A[i_m] : complex<double>(0.0));
+      const complex<double> b = (i_m<B.size() ? B[i_m] : complex<double>(0.0));
+      Max = std::max(Max, std::abs(a-b));
+    }
+    return Max;
+  }
+
+  class Check {
+  public:
+    virtual ~Check() { }
+    // Return an empty string on success, or a description of the failure
+    virtual string Run() = 0;
+  };
+
+  string Describe(const string& What, const double Value, const double Tolerance) {
+    ostringstream s;
+    s << What << " = " << Value << " > " << Tolerance;
+    return s.str();
+  }
+
+  // SuperMomenta must be constructible from Scri, with the same
+  // supermomentum as each slice gives on its own
+  class SuperMomentaFromScriCheck : public Check {
+  public:
+    string Run() {
+      const int EllMax = 4;
+      const GWFrames::Scri S = SyntheticScri(EllMax, 200);
+      const GWFrames::SuperMomenta Psi(S);
+      if(Psi.NTimes()!=S.NTimes()) {
+        return Describe("|NTimes difference|", std::abs(Psi.NTimes()-S.NTimes()), 0);
+      }
+      if(Psi.EllMax()!=2*EllMax) {
+        return Describe("|EllMax()-2*EllMax|", std::abs(Psi.EllMax()-2*EllMax), 0);
+      }
+      double Max = 0.0;
+      for(int i_t=0; i_t<S.NTimes(); i_t+=17) {
+        Max = std::max(Max, MaxDifference(Psi[i_t], S[i_t].SuperMomentum()));
+      }
+      if(Max>1.e-14) { return Describe("Largest supermomentum difference", Max, 1.e-14); }
+      return "";
+    }
+  };
+
+  // The Moreschi algorithm must recover a known boost and
+  // supertranslation.  The supermomentum is constant in time and
+  // given by
+  //   Psi = E K^3 + \eth^2\bar{\eth}^2 delta,
+  // where K is the conformal factor of the boost v, delta has only
+  // ell>=2 modes, and E is +1 or -1.  Its nice sections are u=u0+delta
+  // for any u0, on which the four-momentum is E gamma (1, v).  The
+  // solver starts from the identity, and must find v and delta, and a
+  // supermomentum on the nice section that is the constant E.  K^3 is
+  // not band-limited; its modes above ell fall off like |v|^ell, so
+  // |v| is kept small enough that truncating at EllMax is far below
+  // the tolerances.
+  class MoreschiSolveCheck : public Check {
+    const double Energy;
+  public:
+    MoreschiSolveCheck(const double E) : Energy(E) { }
+    string Run() {
+      const int EllMax = 8;
+      const int n = 2*EllMax+1;
+      const double sqrt4pi = std::sqrt(4*M_PI);
+      GWFrames::ThreeVector v(3);
+      v[0] = 0.02;
+      v[1] = -0.01;
+      v[2] = 0.015;
+      // A real supertranslation: delta_{ell,-m} = (-1)^m conj(delta_{ell,m})
+      vector<complex<double> > Delta((EllMax+1)*(EllMax+1), 0.0);
+      Delta[6] = 0.3;                          // (2,0)
+      Delta[8] = complex<double>(0.1, -0.05);  // (2,2)
+      Delta[4] = std::conj(Delta[8]);          // (2,-2)
+      Delta[12] = -0.2;                        // (3,0)
+      Delta[13] = complex<double>(0.04, 0.02); // (3,1)
+      Delta[11] = -std::conj(Delta[13]);       // (3,-1)
+      Delta[20] = 0.05;                        // (4,0)
+      const GWFrames::Modes deltaStar(0, Delta);
+      const GWFrames::Modes Psi = GWFrames::Modes(Energy*GWFrames::ConformalFactorGrid(v, n, n).pow(3), EllMax)
+        + deltaStar.edth2edthbar2();
+      vector<double> T(101);
+      for(unsigned int i_t=0; i_t<T.size(); ++i_t) { T[i_t] = i_t; }
+      const GWFrames::SuperMomenta S(T, vector<GWFrames::Modes>(T.size(), Psi));
+
+      // A single slice, starting from the identity
+      const double Tolerance = 1.e-9;
+      const double u0 = 50.0;
+      vector<complex<double> > Delta0((EllMax+1)*(EllMax+1), 0.0);
+      Delta0[0] = sqrt4pi*u0;
+      GWFrames::Modes OneOverK;
+      GWFrames::Modes delta(0, Delta0);
+      const int Iterations = S.MoreschiSolve(OneOverK, delta, 1.e-10, 50);
+      if(Iterations<0) { return "MoreschiSolve did not converge"; }
+      const GWFrames::ThreeVector vFound = GWFrames::vFromOneOverK(OneOverK);
+      double Max = 0.0;
+      for(int i=0; i<3; ++i) { Max = std::max(Max, std::abs(vFound[i]-v[i])); }
+      if(Max>Tolerance) { return Describe("Largest error in v", Max, Tolerance); }
+      if(std::abs(delta[0]-Delta0[0])>Tolerance) { return Describe("Change in delta[0]", std::abs(delta[0]-Delta0[0]), Tolerance); }
+      Max = 0.0;
+      for(unsigned int i_m=4; i_m<Delta.size(); ++i_m) { Max = std::max(Max, std::abs(delta[i_m]-Delta[i_m])); }
+      if(Max>Tolerance) { return Describe("Largest error in delta", Max, Tolerance); }
+
+      // The supermomentum on the nice section is E everywhere
+      const GWFrames::Modes PsiPrime = S.BMSTransform(OneOverK, delta);
+      Max = std::abs(PsiPrime[0]-sqrt4pi*Energy);
+      for(unsigned int i_m=1; i_m<PsiPrime.size(); ++i_m) { Max = std::max(Max, std::abs(PsiPrime[i_m])); }
+      if(Max>1.e-8) { return Describe("Largest error in the nice-section supermomentum", Max, 1.e-8); }
+
+      // Several slices at once, each of which should find the same
+      // boost and supertranslation
+      vector<double> u(3);
+      u[0] = 40.0;
+      u[1] = 50.0;
+      u[2] = 60.0;
+      vector<GWFrames::Modes> OneOverKs;
+      vector<GWFrames::Modes> deltas;
+      const vector<int> Iterations_u = S.MoreschiSolve(u, OneOverKs, deltas, 1.e-10, 50);
+      for(unsigned int i=0; i<u.size(); ++i) {
+        if(Iterations_u[i]<0) { return "MoreschiSolve(u) did not converge"; }
+        Max = std::abs(deltas[i][0]-sqrt4pi*u[i]);
+        for(unsigned int i_m=4; i_m<Delta.size(); ++i_m) { Max = std::max(Max, std::abs(deltas[i][i_m]-Delta[i_m])); }
+        for(unsigned int i_m=0; i_m<4; ++i_m) { Max = std::max(Max, std::abs(OneOverKs[i][i_m]-OneOverK[i_m])); }
+        if(Max>Tolerance) { return Describe("Largest error in MoreschiSolve(u)", Max, Tolerance); }
+      }
+      return "";
+    }
+  };
+
+  // Extrapolation must recover the infinite-radius data exactly when
+  // the finite-radius data are a polynomial in the fit variable of no
+  // higher degree than the fit.  Each mode at radius r is
+  //   h (1 + a x + b x^2),
+  // where h is the infinite-radius data, and x is 1/r, or 1/(r m
+  // Omega) for m!=0 modes when Omegas are given.  The radii change
+  // with time, so the weights differ from one time to the next.
+  class ExtrapolatedWaveformsCheck : public Check {
+    const bool UseOmegas;
+  public:
+    ExtrapolatedWaveformsCheck(const bool useOmegas) : UseOmegas(useOmegas) { }
+    string Run() {
+      const int NRadii = 6;
+      const GWFrames::Waveform h = SyntheticWaveform(2, 4, 600);
+      const complex<double> a(2.0, 1.0);
+      const complex<double> b(-30.0, 5.0);
+      vector<double> Omegas;
+      if(UseOmegas) {
+        for(unsigned int i_t=0; i_t<h.NTimes(); ++i_t) { Omegas.push_back(0.02+0.08*i_t/(h.NTimes()-1.0)); }
+      }
+      vector<GWFrames::Waveform> Ws(NRadii, h);
+      vector<vector<double> > Radii(NRadii, vector<double>(h.NTimes()));
+      for(int i_W=0; i_W<NRadii; ++i_W) {
+        for(unsigned int i_t=0; i_t<h.NTimes(); ++i_t) {
+          Radii[i_W][i_t] = 100.0 + 50.0*i_W + 0.01*h.T(i_t);
+        }
+        for(unsigned int i_m=0; i_m<h.NModes(); ++i_m) {
+          const int m = h.LM(i_m)[1];
+          for(unsigned int i_t=0; i_t<h.NTimes(); ++i_t) {
+            const double x = ((UseOmegas && m!=0) ? 1.0/(Radii[i_W][i_t]*m*Omegas[i_t]) : 1.0/Radii[i_W][i_t]);
+            Ws[i_W].SetData(i_m, i_t, h.Data(i_m, i_t)*(1.0 + a*x + b*x*x));
+          }
+        }
+      }
+      vector<int> Orders(3);
+      Orders[0] = -1;
+      Orders[1] = 2;
+      Orders[2] = 4;
+      const vector<GWFrames::Waveform> E = GWFrames::ExtrapolatedWaveforms(Ws, Radii, Orders, Omegas);
+      double Max = 0.0;
+      for(unsigned int i_m=0; i_m<h.NModes(); ++i_m) {
+        for(unsigned int i_t=0; i_t<h.NTimes(); ++i_t) {
+          Max = std::max(Max, std::abs(E[0].Data(i_m, i_t)-Ws[NRadii-1].Data(i_m, i_t)));
+        }
+      }
+      if(Max>0.0) { return Describe("Largest difference from the outermost Waveform for N=-1", Max, 0.0); }
+      for(int i_N=1; i_N<3; ++i_N) {
+        Max = 0.0;
+        for(unsigned int i_m=0; i_m<h.NModes(); ++i_m) {
+          for(unsigned int i_t=0; i_t<h.NTimes(); ++i_t) {
+            Max = std::max(Max, std::abs(E[i_N].Data(i_m, i_t)-h.Data(i_m, i_t)));
+          }
+        }
+        ostringstream What;
+        What << "Largest extrapolation error for N=" << Orders[i_N];
+        if(Max>1.e-10) { return Describe(What.str(), Max, 1.e-10); }
+      }
+      return "";
+    }
+  };
+
+  // Run one check, catching GWFrames errors, and report the result
+  bool Passed(const string& Name, Check& C) {
+    string Failure;
+    std::streambuf* Output = cout.rdbuf(cerr.rdbuf());
+    try {
+      Failure = C.Run();
+    } catch(int i) {
+      ostringstream s;
+      s << "threw GWFrames error code " << i;
+      Failure = s.str();
+    }
+    cout.rdbuf(Output);
+    if(Failure.empty()) {
+      cout << "PASS " << Name << endl;
+      return true;
+    }
+    cout << "FAIL " << Name << ": " << Failure << endl;
+    return false;
+  }
+
+}
+
+int main() {
+  int Failures = 0;
+  {
+    SuperMomentaFromScriCheck C;
+    if(!Passed("SuperMomenta(Scri)", C)) { ++Failures; }
+  }
+  {
+    MoreschiSolveCheck C(1.0);
+    if(!Passed("SuperMomenta::MoreschiSolve (positive energy)", C)) { ++Failures; }
+  }
+  {
+    MoreschiSolveCheck C(-1.0);
+    if(!Passed("SuperMomenta::MoreschiSolve (negative energy)", C)) { ++Failures; }
+  }
+  {
+    ExtrapolatedWaveformsCheck C(false);
+    if(!Passed("ExtrapolatedWaveforms (1/r)", C)) { ++Failures; }
+  }
+  {
+    ExtrapolatedWaveformsCheck C(true);
+    if(!Passed("ExtrapolatedWaveforms (1/(r m Omega))", C)) { ++Failures; }
+  }
+  return Failures;
+}
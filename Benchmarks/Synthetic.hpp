@@ -0,0 +1,75 @@
+// Copyright (c) 2014, Michael Boyle
+// See LICENSE file for details
+
+#ifndef SYNTHETIC_HPP
+#define SYNTHETIC_HPP
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <cstdlib>
+#include "Quaternions.hpp"
+#include "Waveforms.hpp"
+#include "Scri.hpp"
+
+// Synthetic data shared by the benchmark and check programs in this
+// directory.  Each program is a single translation unit, so these
+// live in an unnamed namespace.
+
+namespace {
+
+  const double TimeStep = 0.5;
+
+  // A chirping signal with every (ell,m) mode from EllMin through
+  // EllMax present and nonzero.  The orbital frequency increases
+  // linearly from 0.02 to 0.1, the amplitudes fall off with ell, and
+  // the phase of each mode is m times the orbital phase.
+  GWFrames::Waveform SyntheticWaveform(const int EllMin, const int EllMax, const int NTimes, const int SpinWeight=-2) {
+    const double Duration = TimeStep*(NTimes-1);
+    const double Omega0 = 0.02;
+    const double OmegaDot = (NTimes>1 ? (0.1-Omega0)/Duration : 0.0);
+    std::vector<double> T(NTimes);
+    std::vector<double> Phi(NTimes);
+    std::vector<double> Amp(NTimes);
+    for(int i_t=0; i_t<NTimes; ++i_t) {
+      T[i_t] = TimeStep*i_t;
+      Phi[i_t] = Omega0*T[i_t] + 0.5*OmegaDot*T[i_t]*T[i_t];
+      Amp[i_t] = std::pow(Omega0+OmegaDot*T[i_t], 2.0/3.0);
+    }
+    std::vector<std::vector<int> > LM;
+    std::vector<std::vector<std::complex<double> > > Data;
+    for(int ell=EllMin; ell<=EllMax; ++ell) {
+      for(int m=-ell; m<=ell; ++m) {
+        std::vector<int> lm(2);
+        lm[0] = ell;
+        lm[1] = m;
+        LM.push_back(lm);
+        const double Scale = std::pow(0.3, std::abs(ell-2)) * (m==0 ? 0.1 : 1.0/(1.0+ell-std::abs(m)));
+        std::vector<std::complex<double> > Mode(NTimes);
+        for(int i_t=0; i_t<NTimes; ++i_t) {
+          Mode[i_t] = std::polar(Scale*Amp[i_t], -m*Phi[i_t]);
+        }
+        Data.push_back(Mode);
+      }
+    }
+    GWFrames::Waveform W(T, LM, Data);
+    W.SetSpinWeight(SpinWeight);
+    W.SetFrame(std::vector<Quaternions::Quaternion>(1, Quaternions::Quaternion(1,0,0,0)));
+    W.SetFrameType(GWFrames::Inertial);
+    W.SetDataType(GWFrames::h);
+    W.SetRIsScaledOut(true);
+    W.SetMIsScaledOut(true);
+    return W;
+  }
+
+  // Scri data built from synthetic waveforms with every mode from
+  // ell=0 through EllMax, each with the spin weight of its field
+  GWFrames::Scri SyntheticScri(const int EllMax, const int NTimes) {
+    return GWFrames::Scri(SyntheticWaveform(0, EllMax, NTimes, 2), SyntheticWaveform(0, EllMax, NTimes, 1),
+                          SyntheticWaveform(0, EllMax, NTimes, 0), SyntheticWaveform(0, EllMax, NTimes, -1),
+                          SyntheticWaveform(0, EllMax, NTimes, -2), SyntheticWaveform(0, EllMax, NTimes, 2));
+  }
+
+}
+
+#endif // SYNTHETIC_HPP
@@ -168,7 +168,7 @@ def ReadFiniteRadiusWaveform(n, filename, WaveformName, ChMass, InitialAdmEnergy
         for m,DataSet in enumerate(YLMdata) :
             modedata = array(W[DataSet])
             Data[m,:] = (modedata[Indices,1] + 1j*modedata[Indices,2]) * RadiusRatio * UnitScaleFactor
-        Ws[n].SetData(Data)
+        Ws[n].SetDataFromArray(Data)
     finally :
         f.close()
     return Radii/ChMass
@@ -270,24 +270,17 @@ def ReadFiniteRadiusData(ChMass=0.0, filename='rh_FiniteRadii_CodeUnits.h5', Coo
 def SetCommonTime(Ws, Radii, MinTimeStep=0.005, EarliestTime=-3e300, LatestTime=3e300):
     """Interpolate Waveforms and radius data to a common set of times
 
-    This function replaces the old `SetCommonTime` function from
-    Waveforms.cpp, so that the Ws object seen here does not need to be
-    a GWFrames::Waveform object.  This simplifies much of the later
-    processing used in `Extrapolate` below.
+    The lists `Ws` and `Radii` are updated in place.  The work is done
+    by `GWFrames.WaveformsOnCommonTime`, which interpolates each
+    Waveform and its radii with the same spline factorization.
 
     """
-    from scipy import interpolate
-    from GWFrames import Intersection
-    NWaveforms = len(Radii)
-    TLimits = [EarliestTime, LatestTime]
-    # Get the new time data before any interpolations
-    T = Intersection(TLimits, Ws[0].T(), MinTimeStep, EarliestTime, LatestTime)
-    for i_W in range(1, NWaveforms):
-        T = Intersection(T, Ws[i_W].T());
-    # Interpolate Radii and then Ws (in that order!)
-    for i_W in range(NWaveforms):
-        Radii[i_W] = interpolate.splev(T, interpolate.splrep(Ws[i_W].T(), Radii[i_W], s=0), der=0)
-        Ws[i_W].InterpolateInPlace(T)
+    from numpy import array
+    from GWFrames import WaveformsOnCommonTime
+    NewWs, NewRadii = WaveformsOnCommonTime(Ws, [[float(r) for r in R] for R in Radii],
+                                            MinTimeStep, EarliestTime, LatestTime)
+    Ws[:] = [W for W in NewWs]
+    Radii[:] = [array(R) for R in NewRadii]
     return
 
 
@@ -846,178 +839,25 @@ def RunExtrapolation(TopLevelInputDir, TopLevelOutputDir, Subdirectory, DataFile
 
 
 def _Extrapolate(FiniteRadiusWaveforms, Radii, ExtrapolationOrders, Omegas=None, VersionHist=None):
-    import numpy
+    """Extrapolate with the native `GWFrames.ExtrapolatedWaveforms`
+
+    The data must already be on common times (see `SetCommonTime`).
+    The polynomial fits in 1/r are done in C++, with the fit weights
+    found once per time and order and applied to all modes at once.
+
+    """
     import GWFrames
 
-    # Get the various dimensions, etc.
-    MaxN = max(ExtrapolationOrders)
-    MinN = min(ExtrapolationOrders)
-    UseOmegas = ((Omegas is not None) and (len(Omegas)!=0))
-    NTimes = FiniteRadiusWaveforms[0].NTimes()
-    NModes = FiniteRadiusWaveforms[0].NModes()
-    NFiniteRadii = len(FiniteRadiusWaveforms)
-    NExtrapolations = len(ExtrapolationOrders)
-    SVDTol = 1.e-12; # Same as Numerical Recipes default in fitsvd.h
-
-    # Make sure everyone is playing with a full deck
-    if(abs(MinN)>NFiniteRadii):
-        print("""ERROR: Asking for finite-radius waveform {0}, but only got {1} finite-radius Waveform objects; need at least as {2} finite-radius waveforms.
-
-        """.format(MinN, NFiniteRadii, abs(MinN)))
-        raise ValueError("GWFrames_IndexOutOfBounds")
-    if(MaxN>0 and (MaxN+1)>=NFiniteRadii):
-        print("ERROR: Asking for extrapolation up to order {0}, but only got {1}"\
-              "finite-radius Waveform objects; need at least {2} waveforms.".format(MaxN, NFiniteRadii, MaxN+1))
-        raise ValueError("GWFrames_IndexOutOfBounds")
-    if(len(Radii)!=NFiniteRadii):
-        print("""ERROR: Mismatch in data to be extrapolated; there are different numbers of waveforms and radius vectors.
-        len(FiniteRadiusWaveforms)={0}; len(Radii)={1}
-        """.format(NFiniteRadii, len(Radii)))
-        raise ValueError("GWFrames_VectorSizeMismatch")
-    if(UseOmegas and len(Omegas)!=NTimes):
-        print("ERROR: NTimes mismatch in data to be extrapolated.\n"+
-              "       FiniteRadiusWaveforms[0].NTimes()={0}\n".format(NTimes)+
-              "       Omegas.size()={0}\n".format(len(Omegas))+
-              "\n")
-        raise ValueError("GWFrames_VectorSizeMismatch")
-    for i_W in range(1,NFiniteRadii):
-        if(FiniteRadiusWaveforms[i_W].NTimes() != NTimes):
-            print("ERROR: NTimes mismatch in data to be extrapolated.\n"+
-                  "       FiniteRadiusWaveforms[0].NTimes()={0}\n".format(NTimes)+
-                  "       FiniteRadiusWaveforms[{i_W}].NTimes()={0}\n".format(FiniteRadiusWaveforms[i_W].NTimes())+
-                  "\n")
-            raise ValueError("GWFrames_VectorSizeMismatch")
-        if(FiniteRadiusWaveforms[i_W].NModes() != NModes):
-            print("ERROR: NModes mismatch in data to be extrapolated.\n"+
-                  "       FiniteRadiusWaveforms[0].NModes()={0}\n".format(NModes)+
-                  "       FiniteRadiusWaveforms[{i_W}].NModes()={0}\n".format(FiniteRadiusWaveforms[i_W].NModes())+
-                  "\n")
-            raise ValueError("GWFrames_VectorSizeMismatch")
-        if(len(Radii[i_W]) != NTimes):
-            print("ERROR: NTimes mismatch in data to be extrapolated.\n"+
-                  "       FiniteRadiusWaveforms[0].NTimes()={0}\n".format(NTimes)+
-                  "       Radii[{i_W}].size()={0}\n".format(len(Radii[i_W]))+
-                  "\n")
-            raise ValueError("GWFrames_VectorSizeMismatch")
-
-    # Set up the containers that will be used to store the data during
-    # extrapolation.  These are needed so that we don't have to make too many
-    # calls to Waveform object methods, which have to go through the _Waveform
-    # wrapper, and are therefore slow.
-    data = numpy.array([W.Data() for W in FiniteRadiusWaveforms])
-    data = data.view(dtype=float).reshape((data.shape[0], data.shape[1], data.shape[2], 2))
-    extrapolated_data = numpy.empty((NExtrapolations, NModes, NTimes), dtype=complex)
-
-    # Set up the output data, recording everything but the mode data
-    ExtrapolatedWaveforms = [None]*NExtrapolations
-    for i_N in range(NExtrapolations):
-        N = ExtrapolationOrders[i_N]
-        if(N<0):
-            ExtrapolatedWaveforms[i_N] = GWFrames.Waveform(FiniteRadiusWaveforms[NFiniteRadii+N])
-        else:
-            # Do everything but set the data
-            ExtrapolatedWaveforms[i_N] = GWFrames.Waveform(FiniteRadiusWaveforms[NFiniteRadii-1].CopyWithoutData())
-            ExtrapolatedWaveforms[i_N].AppendHistory(str("### Extrapolating with N={0}\n".format(N)))
-            ExtrapolatedWaveforms[i_N].SetT(FiniteRadiusWaveforms[NFiniteRadii-1].T())
-            ExtrapolatedWaveforms[i_N].SetFrame(FiniteRadiusWaveforms[NFiniteRadii-1].Frame())
-            ExtrapolatedWaveforms[i_N].SetLM(FiniteRadiusWaveforms[NFiniteRadii-1].LM())
-            ExtrapolatedWaveforms[i_N].ResizeData(NModes, NTimes)
-            if VersionHist:
+    if Omegas is None:
+        Omegas = []
+    ExtrapolatedWaveforms = [GWFrames.Waveform(W) for W in
+                             GWFrames.ExtrapolatedWaveforms(FiniteRadiusWaveforms,
+                                                            [[float(r) for r in R] for R in Radii],
+                                                            [int(N) for N in ExtrapolationOrders],
+                                                            [float(Omega) for Omega in Omegas])]
+    if VersionHist:
+        for i_N,N in enumerate(ExtrapolationOrders):
+            if(N>=0):
                 ExtrapolatedWaveforms[i_N].SetVersionHist(VersionHist)
 
-    if(MaxN<0):
-        return ExtrapolatedWaveforms
-
-    MaxCoefficients = MaxN+1
-
-    # Loop over time
-    from sys import stdout
-    LengthProgressBar = 48 # characters, excluding ends
-    last_completed = 0
-    for i_t in range(NTimes):
-        if stdout.isatty():
-            completed = int(LengthProgressBar*i_t/float(NTimes-1))
-            if(completed>last_completed or i_t==0):
-                print("[{0}{1}]".format('#'*completed, '-'*(LengthProgressBar-completed)), end="\r")
-                stdout.flush()
-                last_completed=completed
-
-        # Set up the radius data (if we are NOT using Omega)
-        if not UseOmegas:
-            OneOverRadii = [1.0/Radii[i_W][i_t] for i_W in range(NFiniteRadii)]
-
-            Re = data[:, :, i_t, 0]
-            Im = data[:, :, i_t, 1]
-            # Re = [[FiniteRadiusWaveforms[i_W].Re(i_m,i_t)  for i_m in range(NModes)] for i_W in range(NFiniteRadii)]
-            # Im = [[FiniteRadiusWaveforms[i_W].Im(i_m,i_t)  for i_m in range(NModes)] for i_W in range(NFiniteRadii)]
-
-            # Loop over extrapolation orders
-            for i_N in range(NExtrapolations):
-                N = ExtrapolationOrders[i_N]
-
-                # If non-extrapolating, skip to the next one (the copying was
-                # done when ExtrapolatedWaveforms[i_N] was constructed)
-                if(N<0):
-                    continue
-
-                # Do the extrapolations
-                re = numpy.polyfit(OneOverRadii, Re, N)[-1,:]
-                im = numpy.polyfit(OneOverRadii, Im, N)[-1,:]
-
-                # Record the results
-                for i_m in range(NModes):
-                    extrapolated_data[i_N, i_m, i_t] = re[i_m]+1j*im[i_m]
-                    # ExtrapolatedWaveforms[i_N].SetData(i_m, i_t, re[i_m]+1j*im[i_m])
-
-        else: # UseOmegas
-
-            # Loop over modes
-            for i_m in range(NModes):
-
-                # Set up the radius data (if we ARE using Omega)
-                M = FiniteRadiusWaveforms[0].LM(i_m)[1];
-                if(UseOmegas):
-                    OneOverRadii = [1.0/(Radii[i_W][i_t]*M*Omegas[i_t]) if M!=0 else 1.0/(Radii[i_W][i_t]) for i_W in range(NFiniteRadii)]
-                    # for i_W in range(NFiniteRadii):
-                    #     OneOverRadius = 1.0/(Radii[i_W][i_t]*M*Omegas[i_t]) if M!=0 else 1.0/(Radii[i_W][i_t])
-                    #     OneOverRadii[i_W,0] = 1.0
-                    #     for i_N in range(1,MaxCoefficients):
-                    #         OneOverRadii[i_W, i_N] = OneOverRadius*OneOverRadii[i_W, i_N-1]
-
-                # Set up the mode data
-                # Re = numpy.empty([NFiniteRadii,])
-                # Im = numpy.empty([NFiniteRadii,])
-                # for i_W in range(NFiniteRadii):
-                #     Re[i_W] = FiniteRadiusWaveforms[i_W].Re(i_m,i_t)
-                #     Im[i_W] = FiniteRadiusWaveforms[i_W].Im(i_m,i_t)
-                Re = data[:, i_m, i_t, 0]
-                Im = data[:, i_m, i_t, 1]
-
-                # Loop over extrapolation orders
-                for i_N in range(NExtrapolations):
-                    N = ExtrapolationOrders[i_N]
-
-                    # If non-extrapolating, skip to the next one (the copying was
-                    # done when ExtrapolatedWaveforms[i_N] was constructed)
-                    if(N<0):
-                        continue
-
-                    # Do the extrapolations
-                    re = numpy.polyfit(OneOverRadii, Re, N)[-1]
-                    im = numpy.polyfit(OneOverRadii, Im, N)[-1]
-                    # OneOverRadii_N = OneOverRadii[:, :N+1]
-                    # gsl_multifit_linear_usvd(OneOverRadii_N.matrix, Re, SVDTol)
-                    # re = FitCoefficients_N.vector[0]
-                    # gsl_multifit_linear_usvd(OneOverRadii_N.matrix, Im, SVDTol)
-                    # im = FitCoefficients_N.vector[0]
-                    extrapolated_data[i_N, i_m, i_t] = re+1j*im
-                    # ExtrapolatedWaveforms[i_N].SetData(i_m, i_t, re+1j*im)
-
-    for i_N in range(NExtrapolations):
-        N = ExtrapolationOrders[i_N]
-        if(N>=0):
-            ExtrapolatedWaveforms[i_N].SetData(extrapolated_data[i_N])
-
-    print("")
-
     return ExtrapolatedWaveforms
@@ -4,6 +4,10 @@
 #include "Errors.hpp"
 #include "Interpolate.hpp"
 #include <limits>
+#include <map>
+#include <cmath>
+#include <fstream>
+#include <sstream>
 
 namespace WU = WaveformUtilities;
 using std::vector;
@@ -13,6 +17,7 @@ using std::min;
 using std::cerr;
 using std::endl;
 using std::numeric_limits;
+using std::map;
 using GWFrames::fabs;
 using GWFrames::exp;
 using GWFrames::log;
@@ -22,55 +27,27 @@ using GWFrames::operator*;
 vector<double> AdvLIGO_NSNSOptimal(const vector<double>& F, const bool Invert=false, const double NoiseFloor=0.0) {
   const double FMin = max(NoiseFloor, WU::AdvLIGOSeismicWall);
   const double FMax = 8192;
+  const double Log10 = std::log(10.0);
   vector<double> PSD(F.size(), 0.0);
-  if(Invert) {
-    for(unsigned int i=0; i<F.size(); ++i) {
-      if(fabs(F[i])<FMin || fabs(F[i])>FMax) { PSD[i] = 0.0; }
-      else {
-	PSD[i] = 1.0e49 / (pow(10, -4*(fabs(F[i])-7.9)*(fabs(F[i])-7.9)+16)
-			+ 2.4e-62*pow(fabs(F[i])/215.0,-50)
-			+ 0.08*pow(fabs(F[i])/215.0,-4.69)
-			+ 123.35*(1.0 - 0.23*(fabs(F[i])/215)*(fabs(F[i])/215) + 0.0764*(fabs(F[i])/215)*(fabs(F[i])/215)*(fabs(F[i])/215)*(fabs(F[i])/215)) / (1.0 + 0.17*(fabs(F[i])/215)*(fabs(F[i])/215)) );
-      }
-    }
-  } else {
-    for(unsigned int i=0; i<F.size(); ++i) {
-      if(fabs(F[i])<FMin || fabs(F[i])>FMax) { PSD[i] = numeric_limits<double>::infinity(); }
-      else {
-	PSD[i] = 1.0e-49*(pow(10, -4*(fabs(F[i])-7.9)*(fabs(F[i])-7.9)+16)
-			  + 2.4e-62*pow(fabs(F[i])/215.0,-50)
-			  + 0.08*pow(fabs(F[i])/215.0,-4.69)
-			  + 123.35*(1.0-0.23*(fabs(F[i])/215)*(fabs(F[i])/215)+ 0.0764*(fabs(F[i])/215)*(fabs(F[i])/215)*(fabs(F[i])/215)*(fabs(F[i])/215)) / (1.0 +0.17*(fabs(F[i])/215)*(fabs(F[i])/215)));
-      }
+  for(unsigned int i=0; i<F.size(); ++i) {
+    const double f = std::fabs(F[i]);
+    if(f<FMin || f>FMax) {
+      PSD[i] = (Invert ? 0.0 : numeric_limits<double>::infinity());
+      continue;
     }
+    // Share one logarithm among the power laws
+    const double x = f/215.0;
+    const double x2 = x*x;
+    const double logx = std::log(x);
+    const double S = 1.0e-49*(std::exp(Log10*(-4*(f-7.9)*(f-7.9)+16))
+                              + 2.4e-62*std::exp(-50*logx)
+                              + 0.08*std::exp(-4.69*logx)
+                              + 123.35*(1.0-0.23*x2+0.0764*x2*x2) / (1.0+0.17*x2));
+    PSD[i] = (Invert ? 1.0/S : S);
   }
   return PSD;
 }
 
-vector<double> AdvLIGO_ZeroDet_HighP(const vector<double>& F, const bool Invert=false, const double NoiseFloor=0.0) {
-  #include "NoiseCurves/AdvLIGO_ZeroDet_HighP.ipp"
-  vector<double> LogPSD;
-  LogPSD = WU::Interpolate(ZERO_DET_high_PLogF, ZERO_DET_high_PLogPSD, log(fabs(F)));
-  const double MinFreq(max(NoiseFloor, WU::AdvLIGOSeismicWall));
-  const double MaxFreq(WU::AdvLIGOSamplingFreq);
-  for(unsigned int i=0; i<LogPSD.size(); ++i) {
-    if(fabs(F[i])<MinFreq || fabs(F[i])>MaxFreq) { LogPSD[i] = 500.0; }
-  }
-  if(Invert) { return exp(-1.0*LogPSD); }
-  return exp(LogPSD);
-}
-vector<double> AdvLIGO_ZeroDet_LowP(const vector<double>& F, const bool Invert=false, const double NoiseFloor=0.0) {
-  #include "NoiseCurves/AdvLIGO_ZeroDet_LowP.ipp"
-  vector<double> LogPSD(WU::Interpolate(ZERO_DET_low_PLogF, ZERO_DET_low_PLogPSD, log(fabs(F))));
-  const double MinFreq(max(NoiseFloor, WU::AdvLIGOSeismicWall));
-  const double MaxFreq(WU::AdvLIGOSamplingFreq);
-  for(unsigned int i=0; i<LogPSD.size(); ++i) {
-    if(fabs(F[i])<MinFreq || fabs(F[i])>MaxFreq) { LogPSD[i] = 500.0; }
-  }
-  if(Invert) { return exp(-1.0*LogPSD); }
-  return exp(LogPSD);
-}
-
 vector<double> IniLIGO_Approx(const vector<double>& F, const bool Invert=false, const double NoiseFloor=0.0) {
   const double FMin = max(NoiseFloor, WU::IniLIGOSeismicWall);
   const double FMax = WU::IniLIGOSamplingFreq;
@@ -106,20 +83,283 @@ vector<double> Flat(const vector<double>& F) {
 vector<double> WU::NoiseCurve(const vector<double>& F, const string& Detector, const bool Invert, const double NoiseFloor) {
   if(Detector.compare("AdvLIGO_NSNSOptimal")==0) {
     return AdvLIGO_NSNSOptimal(F, Invert, NoiseFloor);
-  } else if(Detector.compare("AdvLIGO_ZeroDet_HighP")==0) {
-    return AdvLIGO_ZeroDet_HighP(F, Invert, NoiseFloor);
-  } else if(Detector.compare("AdvLIGO_ZeroDet_LowP")==0) {
-    return AdvLIGO_ZeroDet_LowP(F, Invert, NoiseFloor);
   } else if(Detector.compare("IniLIGO_Approx")==0) {
     return IniLIGO_Approx(F, Invert, NoiseFloor);
   } else if(Detector.compare("Flat")==0) {
     return Flat(F);
   } else {
-    cerr << "\nUnknown Detector type: '" << Detector << "'" << endl;
-    throw(GWFrames_UnknownDetector);
+    // AdvLIGO_ZeroDet_HighP, AdvLIGO_ZeroDet_LowP, and loaded curves
+    return TabulatedNoiseCurve(Detector)(F, Invert, NoiseFloor);
   }
 }
 
 vector<double> WU::InverseNoiseCurve(const vector<double>& F, const string& Detector, const double NoiseFloor) {
   return NoiseCurve(F, Detector, true, NoiseFloor);
 }
+
+#ifndef DOXYGEN
+namespace {
+
+  // Identifies a uniformly spaced frequency grid and detector
+  struct NoiseCurveKey {
+    string Detector;
+    double NoiseFloor, f0, df;
+    unsigned int N;
+    bool operator<(const NoiseCurveKey& b) const {
+      if(N != b.N) { return N < b.N; }
+      if(f0 != b.f0) { return f0 < b.f0; }
+      if(df != b.df) { return df < b.df; }
+      if(NoiseFloor != b.NoiseFloor) { return NoiseFloor < b.NoiseFloor; }
+      return Detector < b.Detector;
+    }
+  };
+
+  // Only touched while holding NoiseCurveCacheMutex.  Entries are
+  // never erased or modified once inserted, so references to them
+  // may be used after the mutex is released.
+  map<NoiseCurveKey, vector<double> > NoiseCurveCache;
+  GWFrames::Mutex& NoiseCurveCacheMutex() {
+    static GWFrames::Mutex M;
+    return M;
+  }
+
+}
+#endif // DOXYGEN
+
+const vector<double>& WU::CachedInverseNoiseCurve(const vector<double>& F, const string& Detector, const double NoiseFloor) {
+  /// \param[in] F Uniformly spaced frequencies (in Hz)
+  /// \param[in] Detector Name of the noise curve; see NoiseCurve
+  /// \param[in] NoiseFloor As in NoiseCurve
+  ///
+  /// The grid is identified by its first element, spacing, and size,
+  /// so F must be uniformly spaced; an exception is thrown otherwise.
+  NoiseCurveKey Key;
+  Key.Detector = Detector;
+  Key.NoiseFloor = NoiseFloor;
+  Key.N = F.size();
+  Key.f0 = (F.size()>0 ? F[0] : 0.0);
+  Key.df = (F.size()>1 ? F[1]-F[0] : 0.0);
+  for(unsigned int i=2; i<F.size(); ++i) {
+    if(fabs(F[i]-(Key.f0+i*Key.df)) > 1e-10*fabs(F[i])+numeric_limits<double>::min()) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Frequencies are not uniformly spaced; "
+           << "F[" << i << "]=" << F[i] << " but F[0]+" << i << "*df=" << Key.f0+i*Key.df << endl;
+      throw(GWFrames_ValueError);
+    }
+  }
+  const GWFrames::MutexLock Lock(NoiseCurveCacheMutex());
+  map<NoiseCurveKey, vector<double> >::iterator it = NoiseCurveCache.find(Key);
+  if(it == NoiseCurveCache.end()) {
+    vector<double> InverseCurve = InverseNoiseCurve(F, Detector, NoiseFloor);
+    it = NoiseCurveCache.insert(std::make_pair(Key, vector<double>())).first;
+    it->second.swap(InverseCurve);
+  }
+  return it->second;
+}
+
+
+/// Tabulate a noise curve given on a grid in log-frequency
+WU::NoiseCurveTable::NoiseCurveTable(const vector<double>& LogF, const vector<double>& LogPSD,
+                                     const double MinFreq, const double MaxFreq)
+  : logF0(0.0), dLogF(0.0), minFreq(MinFreq), maxFreq(MaxFreq), coefficients()
+{
+  /// \param[in] LogF Natural logarithm of the frequencies (in Hz), increasing
+  /// \param[in] LogPSD Natural logarithm of the PSD at each frequency
+  /// \param[in] MinFreq Lowest frequency at which the PSD is finite
+  /// \param[in] MaxFreq Highest frequency at which the PSD is finite
+  ///
+  /// If LogF is not uniformly spaced, the data are first
+  /// interpolated onto a uniform grid with the same endpoints and
+  /// number of points.
+  SetCoefficients(LogF, LogPSD);
+}
+
+/// Read a noise curve from a text file of frequencies and square-root PSDs
+WU::NoiseCurveTable::NoiseCurveTable(const string& FileName, const double MinFreq, const double MaxFreq)
+  : logF0(0.0), dLogF(0.0), minFreq(MinFreq), maxFreq(MaxFreq), coefficients()
+{
+  /// \param[in] FileName Text file with columns of frequency (in Hz) and square-root PSD, like those in NoiseCurves/
+  /// \param[in] MinFreq Lowest frequency at which the PSD is finite
+  /// \param[in] MaxFreq Highest frequency at which the PSD is finite
+  ///
+  /// Blank lines and lines starting with '#' are skipped.
+  std::ifstream File(FileName.c_str());
+  if(!File) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << FileName << "'" << endl;
+    throw(GWFrames_BadFileName);
+  }
+  vector<double> LogF, LogPSD;
+  string Line;
+  while(std::getline(File, Line)) {
+    const string::size_type i = Line.find_first_not_of(" \t\r");
+    if(i==string::npos || Line[i]=='#') { continue; }
+    std::istringstream LineStream(Line);
+    double f, ASD;
+    if(!(LineStream >> f >> ASD) || f<=0.0 || ASD<=0.0) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't read a positive frequency and square-root PSD from line "
+           << LogF.size()+1 << " of '" << FileName << "':\n" << Line << endl;
+      throw(GWFrames_BadFileName);
+    }
+    LogF.push_back(std::log(f));
+    LogPSD.push_back(2.0*std::log(ASD));
+  }
+  SetCoefficients(LogF, LogPSD);
+}
+
+/// Find the natural cubic spline of LogPSD on a uniform grid in LogF
+void WU::NoiseCurveTable::SetCoefficients(const vector<double>& LogF, const vector<double>& LogPSD) {
+  const unsigned int N = LogF.size();
+  if(N<2 || LogPSD.size()!=N) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": LogF.size()=" << N << "; LogPSD.size()=" << LogPSD.size()
+         << "; need at least two points of each" << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  for(unsigned int i=1; i<N; ++i) {
+    if(!(LogF[i]>LogF[i-1])) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": The frequencies are not increasing at index " << i << endl;
+      throw(GWFrames_ValueError);
+    }
+  }
+  logF0 = LogF[0];
+  dLogF = (LogF[N-1]-LogF[0])/double(N-1);
+
+  // Resample onto a uniform grid, if necessary
+  vector<double> Y(LogPSD);
+  for(unsigned int i=1; i<N-1; ++i) {
+    if(std::fabs(LogF[i]-(logF0+i*dLogF)) > 1.e-8*dLogF) {
+      vector<double> X(N);
+      for(unsigned int j=0; j<N; ++j) { X[j] = logF0+j*dLogF; }
+      X[N-1] = LogF[N-1];
+      Y = WU::Interpolate(LogF, LogPSD, X);
+      break;
+    }
+  }
+
+  // Second derivatives (times dLogF^2) of the natural spline, with
+  // the Thomas algorithm for the tridiagonal system
+  vector<double> M(N, 0.0);
+  if(N>2) {
+    vector<double> c(N, 0.0);
+    for(unsigned int i=1; i<N-1; ++i) {
+      const double Pivot = 4.0-(i>1 ? c[i-1] : 0.0);
+      c[i] = 1.0/Pivot;
+      M[i] = (6.0*(Y[i+1]-2.0*Y[i]+Y[i-1]) - (i>1 ? M[i-1] : 0.0)) / Pivot;
+    }
+    for(unsigned int i=N-3; i>0; --i) {
+      M[i] -= c[i]*M[i+1];
+    }
+  }
+
+  // The cubic on interval i, in terms of the fraction t of the interval
+  coefficients.resize(4*(N-1));
+  for(unsigned int i=0; i<N-1; ++i) {
+    coefficients[4*i] = Y[i];
+    coefficients[4*i+1] = Y[i+1]-Y[i] - (2.0*M[i]+M[i+1])/6.0;
+    coefficients[4*i+2] = M[i]/2.0;
+    coefficients[4*i+3] = (M[i+1]-M[i])/6.0;
+  }
+}
+
+/// Evaluate the PSD (or its inverse) at N frequencies
+void WU::NoiseCurveTable::Evaluate(const double* F, double* PSD, const unsigned int N, const bool Invert, const double NoiseFloor) const {
+  /// \param[in] F Frequencies (in Hz); only the absolute values are used
+  /// \param[out] PSD Output array of N values
+  /// \param[in] N Number of frequencies
+  /// \param[in] Invert If true, return the inverse of the PSD
+  /// \param[in] NoiseFloor Frequency below which the PSD is infinite, if greater than MinFreq()
+  ///
+  /// Frequencies beyond the ends of the table use the cubic of the
+  /// first or last interval.
+  const double FMin = max(NoiseFloor, minFreq);
+  const double InverseDLogF = 1.0/dLogF;
+  const double LastInterval = double(coefficients.size()/4-1);
+  const double Sign = (Invert ? -1.0 : 1.0);
+  const double* c = &coefficients[0];
+  for(unsigned int i=0; i<N; ++i) {
+    const double f = std::fabs(F[i]);
+    const double x = (std::log(f)-logF0)*InverseDLogF;
+    const double xClamped = (x>0.0 ? (x<LastInterval ? x : LastInterval) : 0.0); // Also catches NaN
+    const int j = int(xClamped);
+    const double t = x-j;
+    const double* cj = c+4*j;
+    const double LogPSD = cj[0]+t*(cj[1]+t*(cj[2]+t*cj[3]));
+    PSD[i] = std::exp(Sign*((f>=FMin && f<=maxFreq) ? LogPSD : 500.0));
+  }
+}
+
+/// Return the PSD (or its inverse) at the frequencies F
+vector<double> WU::NoiseCurveTable::operator()(const vector<double>& F, const bool Invert, const double NoiseFloor) const {
+  /// \param[in] F Frequencies (in Hz); only the absolute values are used
+  /// \param[in] Invert If true, return the inverse of the PSD
+  /// \param[in] NoiseFloor Frequency below which the PSD is infinite, if greater than MinFreq()
+  vector<double> PSD(F.size());
+  if(F.size()>0) { Evaluate(&F[0], &PSD[0], F.size(), Invert, NoiseFloor); }
+  return PSD;
+}
+
+#ifndef DOXYGEN
+namespace {
+
+  // The tables compiled into the library are built on first use
+  const WU::NoiseCurveTable& AdvLIGO_ZeroDet_HighP() {
+    #include "NoiseCurves/AdvLIGO_ZeroDet_HighP.ipp"
+    static const WU::NoiseCurveTable Table(ZERO_DET_high_PLogF, ZERO_DET_high_PLogPSD, WU::AdvLIGOSeismicWall, WU::AdvLIGOSamplingFreq);
+    return Table;
+  }
+  const WU::NoiseCurveTable& AdvLIGO_ZeroDet_LowP() {
+    #include "NoiseCurves/AdvLIGO_ZeroDet_LowP.ipp"
+    static const WU::NoiseCurveTable Table(ZERO_DET_low_PLogF, ZERO_DET_low_PLogPSD, WU::AdvLIGOSeismicWall, WU::AdvLIGOSamplingFreq);
+    return Table;
+  }
+
+  // Only touched while holding LoadedNoiseCurvesMutex.  Entries are
+  // never removed, so references to them stay valid.
+  map<string, WU::NoiseCurveTable> LoadedNoiseCurves;
+  GWFrames::Mutex& LoadedNoiseCurvesMutex() {
+    static GWFrames::Mutex M;
+    return M;
+  }
+
+  bool IsBuiltInNoiseCurve(const string& Detector) {
+    return (Detector=="AdvLIGO_NSNSOptimal" || Detector=="AdvLIGO_ZeroDet_HighP" || Detector=="AdvLIGO_ZeroDet_LowP"
+            || Detector=="IniLIGO_Approx" || Detector=="Flat");
+  }
+
+}
+#endif // DOXYGEN
+
+void WU::LoadNoiseCurve(const string& Detector, const string& FileName, const double MinFreq, const double MaxFreq) {
+  /// \param[in] Detector Name by which the curve will be known
+  /// \param[in] FileName Text file with columns of frequency (in Hz) and square-root PSD
+  /// \param[in] MinFreq Lowest frequency at which the PSD is finite
+  /// \param[in] MaxFreq Highest frequency at which the PSD is finite
+  ///
+  /// This may be called from any thread.
+  const NoiseCurveTable Table(FileName, MinFreq, MaxFreq);
+  bool Duplicate = IsBuiltInNoiseCurve(Detector);
+  if(!Duplicate) {
+    const GWFrames::MutexLock Lock(LoadedNoiseCurvesMutex());
+    Duplicate = !LoadedNoiseCurves.insert(std::make_pair(Detector, Table)).second;
+  }
+  if(Duplicate) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": The noise curve '" << Detector << "' already exists" << endl;
+    throw(GWFrames_ValueError);
+  }
+  return;
+}
+
+const WU::NoiseCurveTable& WU::TabulatedNoiseCurve(const string& Detector) {
+  /// \param[in] Detector 'AdvLIGO_ZeroDet_HighP', 'AdvLIGO_ZeroDet_LowP', or the name of a loaded curve
+  if(Detector.compare("AdvLIGO_ZeroDet_HighP")==0) { return AdvLIGO_ZeroDet_HighP(); }
+  if(Detector.compare("AdvLIGO_ZeroDet_LowP")==0) { return AdvLIGO_ZeroDet_LowP(); }
+  const NoiseCurveTable* Table = 0;
+  {
+    const GWFrames::MutexLock Lock(LoadedNoiseCurvesMutex());
+    const map<string, NoiseCurveTable>::const_iterator it = LoadedNoiseCurves.find(Detector);
+    if(it!=LoadedNoiseCurves.end()) { Table = &(it->second); }
+  }
+  if(!Table) {
+    cerr << "\nUnknown Detector type: '" << Detector << "'" << endl;
+    throw(GWFrames_UnknownDetector);
+  }
+  return *Table;
+}
@@ -14,6 +14,7 @@ namespace WaveformUtilities {
   ///   AdvLIGO_ZeroDet_LowP -- LIGO-T0900288-v3
   ///   AdvLIGO_NSNSOptimal -- Collin Capano's fit for the NS-NS optimized noise curve
   ///   Flat -- Uses a PSD equal to one everywhere
+  /// along with any curves added by LoadNoiseCurve.
   std::vector<double> NoiseCurve(const std::vector<double>& F,
                                  const std::string& Detector="AdvLIGO_ZeroDet_HighP",
                                  const bool Invert=false,
@@ -22,6 +23,15 @@ namespace WaveformUtilities {
                                         const std::string& Detector="AdvLIGO_ZeroDet_HighP",
                                         const double NoiseFloor=0.0);
 
+  /// Like InverseNoiseCurve, but the result is computed only once for
+  /// each detector, noise floor, and uniformly spaced frequency grid
+  /// F; later calls -- from any thread -- return a reference to the
+  /// same immutable data.  The cache only ever grows, so the
+  /// reference remains valid for the life of the program.
+  const std::vector<double>& CachedInverseNoiseCurve(const std::vector<double>& F,
+                                                     const std::string& Detector="AdvLIGO_ZeroDet_HighP",
+                                                     const double NoiseFloor=0.0);
+
   /// These constants are reported in the Advanced LIGO design study http://www.ligo.caltech.edu/docs/T/T010075-00.pdf
   /// Note that the sampling rate is frequently cut down by data analysts to 1/2 or 1/4 before any data is processed.
   /// Also note that a more realistic seismic wall early in Adv. LIGO's life will be more like 20Hz.
@@ -34,6 +44,44 @@ namespace WaveformUtilities {
   const double VirgoSeismicWall = 10.0; // Units of Hz
   const double VirgoSamplingFreq = 16384.0; // Units of Hz
 
+  /// Noise curve tabulated on a uniform grid in log-frequency
+  ///
+  /// The log of the PSD is interpolated by a natural cubic spline in
+  /// the log of the frequency, as the tabulated AdvLIGO curves always
+  /// have been.  The spline coefficients are found once, when the
+  /// table is constructed, and the grid is uniform, so evaluating at
+  /// a frequency just finds its interval arithmetically and evaluates
+  /// one cubic.  The evaluation loop has no branches, so that the
+  /// compiler can vectorize it.  Frequencies outside [MinFreq,MaxFreq]
+  /// (or below the noise floor) get an effectively infinite PSD.
+  class NoiseCurveTable {
+  private:
+    double logF0; // Log of the first frequency in the table
+    double dLogF; // Spacing of the table in log-frequency
+    double minFreq;
+    double maxFreq;
+    std::vector<double> coefficients; // Four cubic coefficients for each interval, in terms of the fraction of the interval
+    void SetCoefficients(const std::vector<double>& LogF, const std::vector<double>& LogPSD);
+  public:
+    NoiseCurveTable(const std::vector<double>& LogF, const std::vector<double>& LogPSD,
+                    const double MinFreq, const double MaxFreq);
+    NoiseCurveTable(const std::string& FileName, const double MinFreq, const double MaxFreq);
+    inline unsigned int NPoints() const { return coefficients.size()/4+1; }
+    inline double MinFreq() const { return minFreq; }
+    inline double MaxFreq() const { return maxFreq; }
+    void Evaluate(const double* F, double* PSD, const unsigned int N, const bool Invert=false, const double NoiseFloor=0.0) const;
+    std::vector<double> operator()(const std::vector<double>& F, const bool Invert=false, const double NoiseFloor=0.0) const;
+  };
+
+  /// Read a noise curve from a text file with columns of frequency
+  /// (in Hz) and square-root PSD, as in the files in NoiseCurves/,
+  /// and make it available to NoiseCurve and everything else taking
+  /// a Detector name.  The name must not already be in use.
+  void LoadNoiseCurve(const std::string& Detector, const std::string& FileName,
+                      const double MinFreq=AdvLIGOSeismicWall, const double MaxFreq=AdvLIGOSamplingFreq);
+  /// Return the table for a tabulated or loaded noise curve
+  const NoiseCurveTable& TabulatedNoiseCurve(const std::string& Detector);
+
 }
 
 #endif // NOISECURVES_HPP
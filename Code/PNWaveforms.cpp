@@ -46,28 +46,9 @@ GWFrames::PNWaveform::PNWaveform() :
   SetDataType(GWFrames::h);
   SetRIsScaledOut(true);
   SetMIsScaledOut(true);
-  { // Overwrite the history from Waveform
-    char path[MAXPATHLEN];
-    char* result = getcwd(path, MAXPATHLEN);
-    if(!result) {
-      cerr << "\n" << __FILE__ << ":" << __LINE__ << ": getcwd error." << endl;
-      throw(GWFrames_FailedSystemCall);
-    }
-    string pwd = path;
-    char host[MAXHOSTNAMELEN];
-    gethostname(host, MAXHOSTNAMELEN);
-    string hostname = host;
-    time_t rawtime;
-    time ( &rawtime );
-    string date = asctime ( localtime ( &rawtime ) );
-    history.str("");
-    history.clear();
-    history << "### Code revision (`git rev-parse HEAD` or arXiv version) = " << CodeRevision << std::endl
-            << "### pwd = " << pwd << std::endl
-            << "### hostname = " << hostname << std::endl
-            << "### date = " << date // comes with a newline
-            << "### PNWaveform(); // empty constructor" << std::endl;
-  }
+  // Overwrite the history from Waveform
+  history = History::Session();
+  history << "### PNWaveform(); // empty constructor" << std::endl;
 }
 
 /// Copy constructor
@@ -76,7 +57,54 @@ GWFrames::PNWaveform::PNWaveform(const PNWaveform& a) :
 {
   /// Simply copies all fields in the input object to the constructed
   /// object, including history
-  history.seekp(0, std::ios_base::end);
+}
+
+/// Assignment operator
+GWFrames::PNWaveform& GWFrames::PNWaveform::operator=(const PNWaveform& a) {
+  Waveform::operator=(a);
+  mchi1 = a.mchi1;
+  mchi2 = a.mchi2;
+  mOmega_orb = a.mOmega_orb;
+  mOmega_prec = a.mOmega_prec;
+  mL = a.mL;
+  mPhi_orb = a.mPhi_orb;
+  return *this;
+}
+
+#ifdef GWFrames_MoveSemantics
+/// Move constructor
+GWFrames::PNWaveform::PNWaveform(PNWaveform&& a) :
+  Waveform(std::move(a)), mchi1(std::move(a.mchi1)), mchi2(std::move(a.mchi2)), mOmega_orb(std::move(a.mOmega_orb)),
+  mOmega_prec(std::move(a.mOmega_prec)), mL(std::move(a.mL)), mPhi_orb(std::move(a.mPhi_orb))
+{ }
+
+/// Move assignment operator
+GWFrames::PNWaveform& GWFrames::PNWaveform::operator=(PNWaveform&& a) {
+  if(this != &a) {
+    mchi1 = std::move(a.mchi1);
+    mchi2 = std::move(a.mchi2);
+    mOmega_orb = std::move(a.mOmega_orb);
+    mOmega_prec = std::move(a.mOmega_prec);
+    mL = std::move(a.mL);
+    mPhi_orb = std::move(a.mPhi_orb);
+    Waveform::operator=(std::move(a));
+  }
+  return *this;
+}
+#endif // GWFrames_MoveSemantics
+
+/// Efficiently swap data between two PNWaveform objects
+void GWFrames::PNWaveform::swap(GWFrames::PNWaveform& b) {
+  /// This function uses the std::vector method 'swap' which simply
+  /// swaps pointers to data, for efficiency.
+  Waveform::swap(b);
+  mchi1.swap(b.mchi1);
+  mchi2.swap(b.mchi2);
+  mOmega_orb.swap(b.mOmega_orb);
+  mOmega_prec.swap(b.mOmega_prec);
+  mL.swap(b.mL);
+  mPhi_orb.swap(b.mPhi_orb);
+  return;
 }
 
 
@@ -85,11 +113,121 @@ GWFrames::PNWaveform::PNWaveform(const std::string& Approximant, const double de
                                  const std::vector<double>& chi1_i, const std::vector<double>& chi2_i,
                                  const double Omega_orb_i, double Omega_orb_0,
                                  const Quaternions::Quaternion& R_frame_i, const unsigned int MinStepsPerOrbit,
-                                 const double PNWaveformModeOrder, const double PNOrbitalEvolutionOrder) :
+                                 const double PNWaveformModeOrder, const double PNOrbitalEvolutionOrder,
+                                 const bool ModesOnly) :
+  Waveform(), mchi1(0), mchi2(0), mOmega_orb(0), mOmega_prec(0), mL(0), mPhi_orb(0)
+{
+  /// See GWFrames/Code/SWIG/Extensions.py for the docstring for this object
+
+  { // Overwrite the history from Waveform
+    history = History::Session();
+    history << "W = PNWaveform(" << Approximant << ", " << delta << ", " << VectorStringForm(chi1_i) << ", " << VectorStringForm(chi2_i)
+            << ", " << Omega_orb_i << ", " << Omega_orb_0 << ", " << R_frame_i << ", " << MinStepsPerOrbit
+            << ", " << PNWaveformModeOrder << ", " << PNOrbitalEvolutionOrder << ", " << (ModesOnly ? "true" : "false") << ");" << std::endl;
+  }
+
+  Initialize(Approximant, delta, chi1_i, chi2_i, Omega_orb_i, Omega_orb_0, R_frame_i, MinStepsPerOrbit,
+             PNWaveformModeOrder, PNOrbitalEvolutionOrder, vector<double>(0), ModesOnly);
+} // end PN constructor
+
+/// Constructor of PN waveform from parameters, evaluated on the given times
+GWFrames::PNWaveform::PNWaveform(const std::string& Approximant, const double delta,
+                                 const std::vector<double>& chi1_i, const std::vector<double>& chi2_i,
+                                 const double Omega_orb_i, const std::vector<double>& T, double Omega_orb_0,
+                                 const Quaternions::Quaternion& R_frame_i, const unsigned int MinStepsPerOrbit,
+                                 const double PNWaveformModeOrder, const double PNOrbitalEvolutionOrder,
+                                 const bool ModesOnly) :
   Waveform(), mchi1(0), mchi2(0), mOmega_orb(0), mOmega_prec(0), mL(0), mPhi_orb(0)
 {
   /// See GWFrames/Code/SWIG/Extensions.py for the docstring for this object
+  ///
+  /// This is the same as the other constructor, except that the
+  /// orbital variables are interpolated from the evolution onto the
+  /// times `T` before the waveform is computed, and everything is
+  /// stored only on those times.  The orbital variables (the
+  /// velocity, spins, angular momentum, phase, and co-orbital frame)
+  /// are smooth even over long inspirals, so they are accurately
+  /// interpolated with far fewer steps per orbit than the modes
+  /// would need; `MinStepsPerOrbit` can usually be reduced.  The
+  /// modes themselves are evaluated directly on `T`, with no further
+  /// interpolation.  The times `T` must lie within the times covered
+  /// by the evolution.
+
+  if(T.size()==0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Asking for empty PNWaveform." << endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+
+  { // Overwrite the history from Waveform
+    history = History::Session();
+    history << "W = PNWaveform(" << Approximant << ", " << delta << ", " << VectorStringForm(chi1_i) << ", " << VectorStringForm(chi2_i)
+            << ", " << Omega_orb_i << ", T, " << Omega_orb_0 << ", " << R_frame_i << ", " << MinStepsPerOrbit
+            << ", " << PNWaveformModeOrder << ", " << PNOrbitalEvolutionOrder << ", " << (ModesOnly ? "true" : "false") << ");"
+            << "  # T has " << T.size() << " times from " << std::setprecision(16) << T[0] << " to " << T.back() << std::endl;
+  }
+
+  Initialize(Approximant, delta, chi1_i, chi2_i, Omega_orb_i, Omega_orb_0, R_frame_i, MinStepsPerOrbit,
+             PNWaveformModeOrder, PNOrbitalEvolutionOrder, T, ModesOnly);
+}
+
+/// Interpolate the evolved orbital variables to new times
+void GWFrames::PNWaveform::ResampleOrbitalVariables(const std::vector<double>& T, std::vector<double>& v) {
+  ///
+  /// \param T New times, which must lie within the current times
+  /// \param v Orbital velocity parameter, which is interpolated along with the member data
+  ///
+  /// The real quantities are packed in pairs into the real and
+  /// imaginary parts of the rows of one complex matrix, so that a
+  /// single spline plan interpolates them all at once.  The frame is
+  /// interpolated with `Squad`.
+  const unsigned int NOld = t.size();
+  const unsigned int NNew = T.size();
+  MatrixC Old(6, NOld);
+  for(unsigned int i=0; i<NOld; ++i) {
+    Old[0][i] = std::complex<double>(v[i], mPhi_orb[i]);
+    Old[1][i] = std::complex<double>(mchi1[i][0], mchi1[i][1]);
+    Old[2][i] = std::complex<double>(mchi1[i][2], mchi2[i][0]);
+    Old[3][i] = std::complex<double>(mchi2[i][1], mchi2[i][2]);
+    Old[4][i] = std::complex<double>(mL[i][0], mL[i][1]);
+    Old[5][i] = std::complex<double>(mL[i][2], 0.0);
+  }
+  MatrixC New(6, NNew);
+  const SplineInterpolationPlan Plan(t, T);
+  Plan.Interpolate(Old, New);
+
+  v.resize(NNew);
+  mPhi_orb.resize(NNew);
+  mchi1.assign(NNew, vector<double>(3));
+  mchi2.assign(NNew, vector<double>(3));
+  mL.assign(NNew, vector<double>(3));
+  for(unsigned int i=0; i<NNew; ++i) {
+    v[i] = std::real(New[0][i]);
+    mPhi_orb[i] = std::imag(New[0][i]);
+    mchi1[i][0] = std::real(New[1][i]);
+    mchi1[i][1] = std::imag(New[1][i]);
+    mchi1[i][2] = std::real(New[2][i]);
+    mchi2[i][0] = std::imag(New[2][i]);
+    mchi2[i][1] = std::real(New[3][i]);
+    mchi2[i][2] = std::imag(New[3][i]);
+    mL[i][0] = std::real(New[4][i]);
+    mL[i][1] = std::imag(New[4][i]);
+    mL[i][2] = std::real(New[5][i]);
+  }
+
+  frame = Quaternions::Squad(frame, t, T);
+  t = T;
+  return;
+}
+
 
+/// Evolve the PN system, and evaluate the waveform on the evolved or requested times
+void GWFrames::PNWaveform::Initialize(const std::string& Approximant, const double delta,
+                                      const std::vector<double>& chi1_i, const std::vector<double>& chi2_i,
+                                      const double Omega_orb_i, const double Omega_orb_0,
+                                      const Quaternions::Quaternion& R_frame_i, const unsigned int MinStepsPerOrbit,
+                                      const double PNWaveformModeOrder, const double PNOrbitalEvolutionOrder,
+                                      const std::vector<double>& T, const bool ModesOnly)
+{
   const double v_i = std::pow(Omega_orb_i, 1./3.);
   const double m1 = (1.0+delta)/2.0;
   const double m2 = (1.0-delta)/2.0;
@@ -100,39 +238,26 @@ GWFrames::PNWaveform::PNWaveform(const std::string& Approximant, const double de
   SetRIsScaledOut(true);
   SetMIsScaledOut(true);
 
-  { // Overwrite the history from Waveform
-    char path[MAXPATHLEN];
-    char* result = getcwd(path, MAXPATHLEN);
-    if(!result) {
-      cerr << "\n" << __FILE__ << ":" << __LINE__ << ": getcwd error." << endl;
-      throw(GWFrames_FailedSystemCall);
-    }
-    string pwd = path;
-    char host[MAXHOSTNAMELEN];
-    gethostname(host, MAXHOSTNAMELEN);
-    string hostname = host;
-    time_t rawtime;
-    time ( &rawtime );
-    string date = asctime ( localtime ( &rawtime ) );
-    history.str("");
-    history.clear();
-    history << "# Code revision (`git rev-parse HEAD` or arXiv version) = " << CodeRevision << std::endl
-            << "# pwd = " << pwd << std::endl
-            << "# hostname = " << hostname << std::endl
-            << "# date = " << date // comes with a newline
-            << "W = PNWaveform(" << Approximant << ", " << delta << ", " << VectorStringForm(chi1_i) << ", " << VectorStringForm(chi2_i)
-            << ", " << Omega_orb_i << ", " << Omega_orb_0 << ", " << R_frame_i << ", " << MinStepsPerOrbit
-            << ", " << PNWaveformModeOrder << ", " << PNOrbitalEvolutionOrder << ");" << std::endl;
-  }
-
   vector<double> v;
 
   PostNewtonian::EvolvePN_Q(Approximant, PNOrbitalEvolutionOrder, v_0, v_i, m1, m2, chi1_i, chi2_i, R_frame_i,
                             t, v, mchi1, mchi2, frame, mPhi_orb, mL,
                             MinStepsPerOrbit);
 
-  mOmega_orb = GWFrames::pow(v,3)*PostNewtonian::ellHat(frame);
-  mOmega_prec = Quaternions::vec(Quaternions::FrameAngularVelocity(frame, t)) - mOmega_orb;
+  // Evaluate the orbital variables on the requested times, if any
+  if(T.size()>0) {
+    if(T[0]<t[0] || T.back()>t.back()) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": The requested times (" << T[0] << ", " << T.back()
+           << ") are not all inside the evolved times (" << t[0] << ", " << t.back() << ")." << endl;
+      throw(GWFrames_EmptyIntersection);
+    }
+    ResampleOrbitalVariables(T, v);
+  }
+
+  if(!ModesOnly) {
+    mOmega_orb = GWFrames::pow(v,3)*PostNewtonian::ellHat(frame);
+    mOmega_prec = Quaternions::vec(Quaternions::FrameAngularVelocity(frame, t)) - mOmega_orb;
+  }
 
   // Set up the (ell,m) data
   // We need (2*ell+1) coefficients for each value of ell from 2 up to
@@ -156,6 +281,7 @@ GWFrames::PNWaveform::PNWaveform(const std::string& Approximant, const double de
       }
     }
   }
+  UpdateModeLayout();
 
   // Evaluate the waveform data itself, noting that we always use the
   // frame in standard position (BHs on the x axis, with angular
@@ -172,11 +298,122 @@ GWFrames::PNWaveform::PNWaveform(const std::string& Approximant, const double de
                                               Quaternions::vec(Quaternions::conjugate(frame)*Quaternions::QuaternionArray(mchi2)*frame),
                                               PNWaveformModeOrder));
 
-} // end PN constructor
+  // The spins were needed for the modes, but need not be kept
+  if(ModesOnly) {
+    vector<vector<double> >().swap(mchi1);
+    vector<vector<double> >().swap(mchi2);
+    vector<vector<double> >().swap(mL);
+    vector<double>().swap(mPhi_orb);
+  }
+
+}
+
+
+/// Construct PN waveforms for many sets of parameters
+std::vector<GWFrames::PNWaveform> GWFrames::PNWaveforms(const std::string& Approximant, const std::vector<double>& delta,
+                                                        const std::vector<std::vector<double> >& chi1_i,
+                                                        const std::vector<std::vector<double> >& chi2_i,
+                                                        const std::vector<double>& Omega_orb_i, const std::vector<double>& Omega_orb_0,
+                                                        const std::vector<Quaternions::Quaternion>& R_frame_i,
+                                                        const unsigned int MinStepsPerOrbit, const double PNWaveformModeOrder,
+                                                        const double PNOrbitalEvolutionOrder, const bool ModesOnly)
+{
+  ///
+  /// \param Approximant 'TaylorT1'|'TaylorT4'|'TaylorT5'
+  /// \param delta Normalized BH mass difference (M1-M2)/(M1+M2) for each waveform
+  /// \param chi1_i Initial dimensionless spin vector of BH1 for each waveform
+  /// \param chi2_i Initial dimensionless spin vector of BH2 for each waveform
+  /// \param Omega_orb_i Initial orbital angular frequency for each waveform
+  /// \param Omega_orb_0 Earliest orbital angular frequency to compute for each waveform (default: Omega_orb_i)
+  /// \param R_frame_i Initial rotation of the binary for each waveform (default: No rotation)
+  /// \param MinStepsPerOrbit Minimum number of time steps at which to evaluate (default: 32)
+  /// \param PNWaveformModeOrder PN order at which to compute waveform modes (default: 3.5)
+  /// \param PNOrbitalEvolutionOrder PN order at which to compute orbital evolution (default: 4.0)
+  /// \param ModesOnly If true, keep only the modes, times, and frame of each waveform (default: false)
+  ///
+  /// Element `i` of the result is the same as `PNWaveform` constructed
+  /// with element `i` of each of the vector arguments.  Any of those
+  /// arguments may instead have just one element, which is then used
+  /// for every waveform.
+  ///
+  /// When compiled with OpenMP, the waveforms are distributed over
+  /// threads.  Each evolution allocates its own GSL integrator, so
+  /// the threads share no workspace.  With `ModesOnly`, the evolved
+  /// spins, angular velocities, angular momentum, and orbital phase
+  /// are dropped as soon as the modes are computed (their accessors
+  /// throw), which saves a few hundred bytes per time
+  /// step of each waveform.
+
+  // Find the number of waveforms, and check that all sizes agree
+  unsigned int N = 1;
+  const unsigned int Sizes[6] = { static_cast<unsigned int>(delta.size()), static_cast<unsigned int>(chi1_i.size()),
+                                  static_cast<unsigned int>(chi2_i.size()), static_cast<unsigned int>(Omega_orb_i.size()),
+                                  static_cast<unsigned int>(Omega_orb_0.size()), static_cast<unsigned int>(R_frame_i.size()) };
+  for(unsigned int j=0; j<6; ++j) {
+    if(Sizes[j]!=1) { N = Sizes[j]; }
+  }
+  for(unsigned int j=0; j<6; ++j) {
+    if(Sizes[j]!=1 && Sizes[j]!=N) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": delta.size()=" << delta.size() << "; chi1_i.size()=" << chi1_i.size()
+           << "; chi2_i.size()=" << chi2_i.size() << "; Omega_orb_i.size()=" << Omega_orb_i.size()
+           << "; Omega_orb_0.size()=" << Omega_orb_0.size() << "; R_frame_i.size()=" << R_frame_i.size()
+           << ".\nEach parameter must be given once, or once for each waveform." << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+  for(unsigned int i=0; i<chi1_i.size(); ++i) {
+    if(chi1_i[i].size()!=3) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": chi1_i[" << i << "].size()=" << chi1_i[i].size() << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+  for(unsigned int i=0; i<chi2_i.size(); ++i) {
+    if(chi2_i[i].size()!=3) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": chi2_i[" << i << "].size()=" << chi2_i[i].size() << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
 
+  // Exceptions may not leave the parallel region, so they are caught
+  // and the first is re-thrown afterwards
+  vector<PNWaveform> Waveforms(N);
+  vector<int> Failed(N, 0);
+  vector<int> Thrown(N, 0);
+  #pragma omp parallel for schedule(dynamic) if(N>1) num_threads(GWFrames::MaxThreads())
+  for(int i=0; i<int(N); ++i) {
+    try {
+      PNWaveform W(Approximant, delta[delta.size()==1 ? 0 : i],
+                   chi1_i[chi1_i.size()==1 ? 0 : i], chi2_i[chi2_i.size()==1 ? 0 : i],
+                   Omega_orb_i[Omega_orb_i.size()==1 ? 0 : i], Omega_orb_0[Omega_orb_0.size()==1 ? 0 : i],
+                   R_frame_i[R_frame_i.size()==1 ? 0 : i], MinStepsPerOrbit, PNWaveformModeOrder, PNOrbitalEvolutionOrder,
+                   ModesOnly);
+      Waveforms[i].swap(W);
+    } catch(int thrown) {
+      Failed[i] = 1;
+      Thrown[i] = thrown;
+    }
+  }
+  for(unsigned int i=0; i<N; ++i) {
+    if(Failed[i]) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Constructing PN waveform " << i << " failed." << endl;
+      throw(Thrown[i]);
+    }
+  }
+
+  return Waveforms;
+}
+
+
+/// Report an attempt to use the orbital variables dropped with ModesOnly
+void GWFrames::PNWaveform::OrbitalVariablesDropped() const {
+  cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": The spins, angular velocities, angular momentum, and orbital phase"
+       << " of this PNWaveform were not kept (ModesOnly=true)." << endl;
+  throw(GWFrames_ValueError);
+}
 
 /// Total angular velocity of PN binary at an instant of time
 std::vector<double> GWFrames::PNWaveform::Omega_tot(const unsigned int iTime) const {
+  RequireOrbitalVariables();
   std::vector<double> Tot(3);
   Tot[0] = mOmega_orb[iTime][0]+mOmega_prec[iTime][0];
   Tot[1] = mOmega_orb[iTime][1]+mOmega_prec[iTime][1];
@@ -196,6 +433,7 @@ std::vector<std::vector<double> > GWFrames::PNWaveform::Omega_tot() const {
 
 /// Vector of magnitudes of Omega_orb at each instant of time
 std::vector<double> GWFrames::PNWaveform::Omega_orbMag() const {
+  RequireOrbitalVariables();
   const double NT = NTimes();
   std::vector<double> Mag(NT);
   for(unsigned int i=0; i<NT; ++i) {
@@ -206,6 +444,7 @@ std::vector<double> GWFrames::PNWaveform::Omega_orbMag() const {
 
 /// Vector of magnitudes of Omega_prec at each instant of time
 std::vector<double> GWFrames::PNWaveform::Omega_precMag() const {
+  RequireOrbitalVariables();
   const double NT = NTimes();
   std::vector<double> Mag(NT);
   for(unsigned int i=0; i<NT; ++i) {
@@ -226,6 +465,7 @@ std::vector<double> GWFrames::PNWaveform::Omega_totMag() const {
 
 /// Vector of magnitudes of angular momentum L at each instant of time
 std::vector<double> GWFrames::PNWaveform::LMag() const {
+  RequireOrbitalVariables();
   const double NT = NTimes();
   std::vector<double> Mag(NT);
   for(unsigned int i=0; i<NT; ++i) {
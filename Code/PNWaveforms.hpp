@@ -16,10 +16,22 @@ namespace GWFrames {
   public:  // Constructors and Destructor
     PNWaveform();
     PNWaveform(const PNWaveform& W);
+    PNWaveform& operator=(const PNWaveform& W);
+    #ifdef GWFrames_MoveSemantics
+    PNWaveform(PNWaveform&& W);
+    PNWaveform& operator=(PNWaveform&& W);
+    #endif
     PNWaveform(const std::string& Approximant, const double delta, const std::vector<double>& chi1_i, const std::vector<double>& chi2_i,
                const double Omega_orb_i, double Omega_orb_0=-1.0, const Quaternions::Quaternion& R_frame_i=Quaternions::Quaternion(1,0,0,0),
-               const unsigned int MinStepsPerOrbit=32, const double PNWaveformModeOrder=3.5, const double PNOrbitalEvolutionOrder=4.0);
+               const unsigned int MinStepsPerOrbit=32, const double PNWaveformModeOrder=3.5, const double PNOrbitalEvolutionOrder=4.0,
+               const bool ModesOnly=false);
+    PNWaveform(const std::string& Approximant, const double delta, const std::vector<double>& chi1_i, const std::vector<double>& chi2_i,
+               const double Omega_orb_i, const std::vector<double>& T, double Omega_orb_0=-1.0,
+               const Quaternions::Quaternion& R_frame_i=Quaternions::Quaternion(1,0,0,0),
+               const unsigned int MinStepsPerOrbit=32, const double PNWaveformModeOrder=3.5, const double PNOrbitalEvolutionOrder=4.0,
+               const bool ModesOnly=false);
     ~PNWaveform() { }
+    void swap(PNWaveform& b);
 
   private:  // Member data
     // std::stringstream history;           // inherited from Waveform
@@ -34,53 +46,71 @@ namespace GWFrames {
     std::vector<std::vector<double> > mL;
     std::vector<double> mPhi_orb;
 
+  private:  // Helpers for the constructors
+    void Initialize(const std::string& Approximant, const double delta, const std::vector<double>& chi1_i, const std::vector<double>& chi2_i,
+                    const double Omega_orb_i, const double Omega_orb_0, const Quaternions::Quaternion& R_frame_i,
+                    const unsigned int MinStepsPerOrbit, const double PNWaveformModeOrder, const double PNOrbitalEvolutionOrder,
+                    const std::vector<double>& T, const bool ModesOnly);
+    void ResampleOrbitalVariables(const std::vector<double>& T, std::vector<double>& v);
+    // The constructors drop the orbital variables with ModesOnly, after
+    // which their accessors throw
+    void OrbitalVariablesDropped() const;
+    inline void RequireOrbitalVariables() const { if(mPhi_orb.empty()) { OrbitalVariablesDropped(); } }
+
   public:  // Data access functions
     // Vector a specific time index
-    inline const std::vector<double>& chi1(const unsigned int iTime) const { return mchi1[iTime]; }
-    inline const std::vector<double>& chi2(const unsigned int iTime) const { return mchi2[iTime]; }
-    inline const std::vector<double>& Omega_orb(const unsigned int iTime) const { return mOmega_orb[iTime]; }
-    inline const std::vector<double>& Omega_prec(const unsigned int iTime) const { return mOmega_prec[iTime]; }
+    inline const std::vector<double>& chi1(const unsigned int iTime) const { RequireOrbitalVariables(); return mchi1[iTime]; }
+    inline const std::vector<double>& chi2(const unsigned int iTime) const { RequireOrbitalVariables(); return mchi2[iTime]; }
+    inline const std::vector<double>& Omega_orb(const unsigned int iTime) const { RequireOrbitalVariables(); return mOmega_orb[iTime]; }
+    inline const std::vector<double>& Omega_prec(const unsigned int iTime) const { RequireOrbitalVariables(); return mOmega_prec[iTime]; }
     std::vector<double> Omega_tot(const unsigned int iTime) const;
-    inline const std::vector<double>& L(const unsigned int iTime) const { return mL[iTime]; }
+    inline const std::vector<double>& L(const unsigned int iTime) const { RequireOrbitalVariables(); return mL[iTime]; }
     // Magnitude at a specific time index
-    inline double chi1Mag(const unsigned int iTime) const { return GWFrames::abs(mchi1[iTime]); }
-    inline double chi2Mag(const unsigned int iTime) const { return GWFrames::abs(mchi2[iTime]); }
-    inline double Omega_orbMag(const unsigned int iTime) const { return GWFrames::abs(mOmega_orb[iTime]); }
-    inline double Omega_precMag(const unsigned int iTime) const { return GWFrames::abs(mOmega_prec[iTime]); }
-    inline double Omega_totMag(const unsigned int iTime) const { return GWFrames::abs(mOmega_orb[iTime]+mOmega_prec[iTime]); }
-    inline double LMag(const unsigned int iTime) const { return GWFrames::abs(mL[iTime]); }
+    inline double chi1Mag(const unsigned int iTime) const { RequireOrbitalVariables(); return GWFrames::abs(mchi1[iTime]); }
+    inline double chi2Mag(const unsigned int iTime) const { RequireOrbitalVariables(); return GWFrames::abs(mchi2[iTime]); }
+    inline double Omega_orbMag(const unsigned int iTime) const { RequireOrbitalVariables(); return GWFrames::abs(mOmega_orb[iTime]); }
+    inline double Omega_precMag(const unsigned int iTime) const { RequireOrbitalVariables(); return GWFrames::abs(mOmega_prec[iTime]); }
+    inline double Omega_totMag(const unsigned int iTime) const { RequireOrbitalVariables(); return GWFrames::abs(mOmega_orb[iTime]+mOmega_prec[iTime]); }
+    inline double LMag(const unsigned int iTime) const { RequireOrbitalVariables(); return GWFrames::abs(mL[iTime]); }
     // Direction at a specific time index
-    inline std::vector<double> chiHat1(const unsigned int iTime) const { return mchi1[iTime]/GWFrames::abs(mchi1[iTime]); }
-    inline std::vector<double> chiHat2(const unsigned int iTime) const { return mchi2[iTime]/GWFrames::abs(mchi2[iTime]); }
-    inline std::vector<double> OmegaHat_orb(const unsigned int iTime) const { return mOmega_orb[iTime]/GWFrames::abs(mOmega_orb[iTime]); }
-    inline std::vector<double> OmegaHat_prec(const unsigned int iTime) const { return mOmega_prec[iTime]/GWFrames::abs(mOmega_prec[iTime]); }
-    inline std::vector<double> OmegaHat_tot(const unsigned int iTime) const { return Omega_tot(iTime)/GWFrames::abs(Omega_tot(iTime)); }
-    inline std::vector<double> LHat(const unsigned int iTime) const { return mL[iTime]/GWFrames::abs(mL[iTime]); }
+    inline std::vector<double> chiHat1(const unsigned int iTime) const { RequireOrbitalVariables(); return mchi1[iTime]/GWFrames::abs(mchi1[iTime]); }
+    inline std::vector<double> chiHat2(const unsigned int iTime) const { RequireOrbitalVariables(); return mchi2[iTime]/GWFrames::abs(mchi2[iTime]); }
+    inline std::vector<double> OmegaHat_orb(const unsigned int iTime) const { RequireOrbitalVariables(); return mOmega_orb[iTime]/GWFrames::abs(mOmega_orb[iTime]); }
+    inline std::vector<double> OmegaHat_prec(const unsigned int iTime) const { RequireOrbitalVariables(); return mOmega_prec[iTime]/GWFrames::abs(mOmega_prec[iTime]); }
+    inline std::vector<double> OmegaHat_tot(const unsigned int iTime) const { RequireOrbitalVariables(); return Omega_tot(iTime)/GWFrames::abs(Omega_tot(iTime)); }
+    inline std::vector<double> LHat(const unsigned int iTime) const { RequireOrbitalVariables(); return mL[iTime]/GWFrames::abs(mL[iTime]); }
     // Vector at all times
-    inline const std::vector<std::vector<double> >& chi1() const { return mchi1; }
-    inline const std::vector<std::vector<double> >& chi2() const { return mchi2; }
-    inline const std::vector<std::vector<double> >& Omega_orb() const { return mOmega_orb; }
-    inline const std::vector<std::vector<double> >& Omega_prec() const { return mOmega_prec; }
+    inline const std::vector<std::vector<double> >& chi1() const { RequireOrbitalVariables(); return mchi1; }
+    inline const std::vector<std::vector<double> >& chi2() const { RequireOrbitalVariables(); return mchi2; }
+    inline const std::vector<std::vector<double> >& Omega_orb() const { RequireOrbitalVariables(); return mOmega_orb; }
+    inline const std::vector<std::vector<double> >& Omega_prec() const { RequireOrbitalVariables(); return mOmega_prec; }
     std::vector<std::vector<double> > Omega_tot() const;
-    inline const std::vector<std::vector<double> >& L() const { return mL; }
+    inline const std::vector<std::vector<double> >& L() const { RequireOrbitalVariables(); return mL; }
     // Magnitude at all times
     std::vector<double> Omega_orbMag() const;
     std::vector<double> Omega_precMag() const;
     std::vector<double> Omega_totMag() const;
     std::vector<double> LMag() const;
     // Direction at all times
-    inline std::vector<std::vector<double> > chiHat1() const { return mchi1/GWFrames::abs(mchi1); }
-    inline std::vector<std::vector<double> > chiHat2() const { return mchi2/GWFrames::abs(mchi2); }
-    inline std::vector<std::vector<double> > OmegaHat_orb() const { return mOmega_orb/Omega_orbMag(); }
-    inline std::vector<std::vector<double> > OmegaHat_prec() const { return mOmega_prec/Omega_precMag(); }
-    inline std::vector<std::vector<double> > OmegaHat_tot() const { return Omega_tot()/Omega_totMag(); }
-    inline std::vector<std::vector<double> > LHat() const { return mL/LMag(); }
+    inline std::vector<std::vector<double> > chiHat1() const { RequireOrbitalVariables(); return mchi1/GWFrames::abs(mchi1); }
+    inline std::vector<std::vector<double> > chiHat2() const { RequireOrbitalVariables(); return mchi2/GWFrames::abs(mchi2); }
+    inline std::vector<std::vector<double> > OmegaHat_orb() const { RequireOrbitalVariables(); return mOmega_orb/Omega_orbMag(); }
+    inline std::vector<std::vector<double> > OmegaHat_prec() const { RequireOrbitalVariables(); return mOmega_prec/Omega_precMag(); }
+    inline std::vector<std::vector<double> > OmegaHat_tot() const { RequireOrbitalVariables(); return Omega_tot()/Omega_totMag(); }
+    inline std::vector<std::vector<double> > LHat() const { RequireOrbitalVariables(); return mL/LMag(); }
     // Phase
-    inline double Phi_orb(const unsigned int iTime) const { return mPhi_orb[iTime]; }
-    inline const std::vector<double>& Phi_orb() const { return mPhi_orb; }
+    inline double Phi_orb(const unsigned int iTime) const { RequireOrbitalVariables(); return mPhi_orb[iTime]; }
+    inline const std::vector<double>& Phi_orb() const { RequireOrbitalVariables(); return mPhi_orb; }
 
   }; // class PNWaveform
 
+  std::vector<PNWaveform> PNWaveforms(const std::string& Approximant, const std::vector<double>& delta,
+                                      const std::vector<std::vector<double> >& chi1_i, const std::vector<std::vector<double> >& chi2_i,
+                                      const std::vector<double>& Omega_orb_i, const std::vector<double>& Omega_orb_0=std::vector<double>(1,-1.0),
+                                      const std::vector<Quaternions::Quaternion>& R_frame_i=std::vector<Quaternions::Quaternion>(1,Quaternions::Quaternion(1,0,0,0)),
+                                      const unsigned int MinStepsPerOrbit=32, const double PNWaveformModeOrder=3.5, const double PNOrbitalEvolutionOrder=4.0,
+                                      const bool ModesOnly=false);
+
 } // namespace GWFrames
 
 #endif // PNWAVEFORMS_HPP
@@ -39,6 +39,11 @@ class Waveform(_Waveform):
     the standard (x,y,z) basis into the (X,Y,Z) basis with respect to
     which the Waveform's mode `data` are decomposed.
 
+    The methods `Data()`, `T()`, `Re()`, etc., return copies.  To
+    avoid copying, `DataView()` and `TView()` return numpy arrays
+    that share memory with the Waveform, and `SetDataFromArray` and
+    `SetTimeFromArray` take numpy arrays with just one copy.
+
     Note on Waveform Types:
     In any system, h -- being strain -- should be dimensionless.
     When G=c=1, the dimensionless quantities are rMPsi4, rhdot, and
@@ -56,7 +61,7 @@ class Waveform(_Waveform):
     -----------
       int spinweight
       int boostweight
-      std::stringstream history
+      GWFrames::History history
       std::vector<double> t
       std::vector<Quaternions::Quaternion> frame
       WaveformFrameType frameType
@@ -118,9 +123,18 @@ class PNWaveform(_PNWaveform):
       MinStepsPerOrbit: Minimum number of time steps at which to evaluate (default: 32)
       PNWaveformModeOrder: PN order at which to compute waveform modes (default: 3.5)
       PNOrbitalEvolutionOrder: PN order at which to compute orbital evolution (default: 4.0)
+      ModesOnly: Keep only the modes, times, and frame, dropping chi1, chi2, etc., whose accessors then raise (default: False)
 
     [There is also a copy constructor.]
 
+    Alternatively, a vector of times `T` may be given just after
+    Omega_orb_i, with the remaining parameters as above.  The orbital
+    variables are then interpolated from the evolution onto those
+    times, and the modes are computed directly on them, so the fine
+    time steps of the evolution are never stored.  Since the orbital
+    variables are smooth, MinStepsPerOrbit can usually be reduced in
+    this case.  The times must lie within those of the evolution.
+
     The PN system is defined with respect to an inertial basis
     (x,y,z).  The input spin vectors must be defined with respect to
     this basis.  A new basis is (X,Y,Z) is created by rotating (x,y,z)
@@ -145,6 +159,11 @@ class PNWaveform(_PNWaveform):
     TransformToInertialFrame(), then the method
     TransformToCororatingFrame().
 
+    To construct many PNWaveforms at once (in parallel, if compiled
+    with OpenMP), use the function GWFrames.PNWaveforms, which takes
+    the same arguments, but with a list of values for each of delta,
+    chi1_i, chi2_i, Omega_orb_i, Omega_orb_0, and R_frame_i.
+
     """
     __metaclass__ = _MetaPNWaveform
 
@@ -4,7 +4,7 @@
 // Copyright (c) 2014, Michael Boyle
 // See LICENSE file for details
 
-%module GWFrames
+%module(threads="1") GWFrames
 
 // Quiet warnings about overloaded operators being ignored.
 //#pragma SWIG nowarn=362,389,401,509
@@ -21,6 +21,7 @@
   #include <sstream>
   #include <iomanip>
   #include <complex>
+  #include <cstring>
   #include "../Utilities.hpp"
   #include "Quaternions.hpp"
   #include "IntegrateAngularVelocity.hpp"
@@ -28,6 +29,7 @@
   #include "SWSHs.hpp"
   #include "../Waveforms.hpp"
   #include "../PNWaveforms.hpp"
+  #include "../NoiseCurves.hpp"
   #include "../WaveformsAtAPointFT.hpp"
 
 %}
@@ -75,6 +77,48 @@
 %include "Exceptions.i"
 
 
+///////////////////////////////////////////////////////////////////
+//// Release the GIL only around the long-running c++ routines ////
+///////////////////////////////////////////////////////////////////
+// Most wrappers are quick, and some of the extensions touch python
+// objects directly, so the GIL is held by default.  The routines
+// below only work on c++ data, so other python threads may run while
+// they do.  The caches they share (FFTW and SHT plans, noise curves)
+// are guarded by GWFrames::Mutex rather than `omp critical`, so this
+// is safe whether or not the library was built with OpenMP.  The GIL
+// is reacquired before any exception is translated.
+%nothread;
+%thread GWFrames::Waveform::Interpolate;
+%thread GWFrames::Waveform::InterpolateInPlace;
+%thread GWFrames::Waveform::TransformModesToRotatedFrame;
+%thread GWFrames::Waveform::RotatePhysicalSystem;
+%thread GWFrames::Waveform::RotateDecompositionBasis;
+%thread GWFrames::Waveform::TransformToCoprecessingFrame;
+%thread GWFrames::Waveform::TransformToAngularVelocityFrame;
+%thread GWFrames::Waveform::TransformToCorotatingFrame;
+%thread GWFrames::Waveform::TransformToInertialFrame;
+%thread GWFrames::Waveform::Compare;
+%thread GWFrames::Waveform::Hybridize;
+%thread GWFrames::WaveformPair::WaveformPair;
+%thread GWFrames::Waveform::Translate;
+%thread GWFrames::Waveform::BoostPsi4;
+%thread GWFrames::Waveform::BoostHFaked;
+%thread GWFrames::Waveform::BoostedPsi4;
+%thread GWFrames::Waveform::BoostedHFaked;
+%thread GWFrames::AlignWaveforms;
+%thread GWFrames::AlignedWaveforms;
+%thread GWFrames::WaveformsOnCommonTime;
+%thread GWFrames::ExtrapolatedWaveforms;
+%thread GWFrames::PNWaveform::PNWaveform;
+%thread GWFrames::PNWaveforms;
+%thread GWFrames::WaveformAtAPointFT::WaveformAtAPointFT;
+%thread GWFrames::WaveformAtAPointFT::Match;
+%thread GWFrames::Scri::BMSTransformation;
+%thread GWFrames::SliceModes::BMSTransformationOnSlice;
+%thread GWFrames::SuperMomenta::BMSTransform;
+%thread GWFrames::SuperMomenta::MoreschiSolve;
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //// This ensures that GWFrames has local copies of these modules imported ////
 ///////////////////////////////////////////////////////////////////////////////
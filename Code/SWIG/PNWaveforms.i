@@ -29,3 +29,8 @@
 #endif
 //// Parse the header file to generate wrappers
 %include "../PNWaveforms.hpp"
+
+//// Make sure vectors of PNWaveform are understood
+namespace std {
+  %template(_vectorPNWaveform) vector<GWFrames::PNWaveform>;
+};
@@ -11,8 +11,13 @@
 %rename(__getitem__) GWFrames::SliceGrid::operator [](unsigned int const) const;
 %rename(__setitem__) GWFrames::SliceGrid::operator [](unsigned int const);
 %rename(__getitem__) GWFrames::Scri::operator [](unsigned int const) const;
-%rename(__setitem__) GWFrames::Scri::operator [](unsigned int const);
 #endif // SWIG_BUILTIN
+%ignore GWFrames::SHTPlan;
+%ignore GWFrames::ScriArena;
+%ignore GWFrames::ScriAllocator;
+%ignore GWFrames::ModesTensor::ModeData;
+%ignore GWFrames::BMSTransformationContext::BoostedGrid(const int, const unsigned int, const std::complex<double>*) const;
+%ignore GWFrames::BMSTransformationContext::BoostedGrids;
 typedef std::vector<double> ThreeVector;
 typedef std::vector<double> FourVector;
 %include "../Scri.hpp"
@@ -20,6 +25,10 @@ namespace GWFrames {
   %template(SliceOfScriGrid) SliceOfScri<DataGrid>;
   %template(SliceOfScriModes) SliceOfScri<Modes>;
 }
+//// Make sure vectors of Modes are understood
+namespace std {
+  %template(_vectorModes) vector<GWFrames::Modes>;
+};
 %extend GWFrames::DataGrid { // None of the above seem to work, so...
   const std::complex<double> __getitem__(const unsigned int i) const { return $self->operator[](i); }
   void __setitem__(const unsigned int i, const std::complex<double>& a) { $self->operator[](i)=a; }
@@ -38,9 +47,9 @@ namespace GWFrames {
 /* }; */
 %extend GWFrames::Scri { // None of the above seem to work, so...
   /* const GWFrames::SliceModes __getitem__(const unsigned int i) const { return $self->operator[](i); } */
-  void __setitem__(const unsigned int i, const GWFrames::SliceModes& a) { $self->operator[](i) = a; }
+  void __setitem__(const unsigned int i, const GWFrames::SliceModes& a) { $self->SetSlice(i, a); }
 };
 %extend GWFrames::SuperMomenta { // None of the above seem to work, so...
   const GWFrames::Modes __getitem__(const unsigned int i) const { return $self->operator[](i); }
-  void __setitem__(const unsigned int i, const GWFrames::Modes& a) { $self->operator[](i) = a; }
+  void __setitem__(const unsigned int i, const GWFrames::Modes& a) { $self->SetModes(i, a); }
 };
@@ -3,6 +3,16 @@
 //////////////////////////
 %ignore GWFrames::Matrix::operator=;
 %ignore GWFrames::Matrix::operator[];
+%ignore GWFrames::MatrixC::RealView;
+%ignore GWFrames::MatrixC::ImagView;
+%ignore GWFrames::SplitMatrixC;
+%ignore GWFrames::History;
+%ignore GWFrames::InstrumentationCounter;
+%ignore GWFrames::InstrumentationScope;
+%ignore GWFrames::SymmetricEigensystem;
+%ignore GWFrames::DerivativePlan::Differentiate(const double*, double*) const;
+%ignore GWFrames::DerivativePlan::Differentiate(const std::complex<double>*, std::complex<double>*) const;
+%ignore GWFrames::DominantPrincipalAxes(const unsigned int, const double*, double*, const double*);
 %ignore GWFrames::operator+;
 %ignore GWFrames::operator-;
 %ignore GWFrames::operator*;
@@ -14,6 +24,7 @@ namespace std {
   %template(_vectorM) vector<GWFrames::Matrix>;
   %template() pair<string,string>;
   %template() vector<pair<string,string> >;
+  %template(_vectorInstrumentationRecord) vector<GWFrames::InstrumentationRecord>;
 };
 %extend GWFrames::Matrix {
   // Print the Matrix nicely at the prompt
@@ -14,6 +14,13 @@
 %ignore GWFrames::Waveform::operator=;
 %ignore GWFrames::Waveforms::operator[];
 %rename(__getitem__) GWFrames::Waveforms::operator[] const;
+%ignore GWFrames::WaveformView::operator()(const unsigned int) const;
+%ignore GWFrames::WaveformView::Parent;
+%ignore GWFrames::Waveform::HistoryStream;
+%ignore GWFrames::Waveform::DataPointer;
+%ignore GWFrames::CompactWaveform::operator()(const unsigned int) const;
+// Python can't see changes to the arguments; use WaveformsOnCommonTime
+%ignore GWFrames::SetCommonTime;
 
 //// These will convert the output data to numpy.ndarray for easier use
 #ifndef SWIGPYTHON_BUILTIN
@@ -35,6 +42,34 @@
 %feature("pythonappend") GWFrames::Waveform::CorotatingFrame() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
 %feature("pythonappend") GWFrames::Waveform::PNEquivalentOrbitalAV() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
 %feature("pythonappend") GWFrames::Waveform::PNEquivalentPrecessionalAV() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") GWFrames::Waveform::EvaluateAtPoints %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") GWFrames::CompactWaveform::T() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") GWFrames::CompactWaveform::Norm() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") GWFrames::CompactWaveform::LLMatrix() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") GWFrames::WaveformPair::T() const %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") GWFrames::WaveformPair::DifferenceNorm %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+#endif
+
+//// A WaveformView only points to its parent Waveform, so each python
+//// view holds a reference to the python object it was made from, to
+//// keep the parent alive as long as the view.  Without pythonappend
+//// (as with -builtin), views cannot be made safely from python.
+#ifndef SWIGPYTHON_BUILTIN
+%feature("pythonappend") GWFrames::Waveform::View %{ val._parent = self %}
+%feature("pythonappend") GWFrames::Waveform::ViewOfTimeIndices %{ val._parent = self %}
+%feature("pythonappend") GWFrames::Waveform::ViewOfTimes %{ val._parent = self %}
+%feature("pythonappend") GWFrames::WaveformView::WaveformView %{ self._parent = args[0] %}
+%feature("pythonappend") GWFrames::WaveformView::ViewOfTimeIndices %{ val._parent = self %}
+%feature("pythonappend") GWFrames::WaveformView::ViewOfTimes %{ val._parent = self %}
+%feature("pythonappend") GWFrames::WaveformView::ViewOfEllModes %{ val._parent = self %}
+#else
+%ignore GWFrames::Waveform::View;
+%ignore GWFrames::Waveform::ViewOfTimeIndices;
+%ignore GWFrames::Waveform::ViewOfTimes;
+%ignore GWFrames::WaveformView::WaveformView;
+%ignore GWFrames::WaveformView::ViewOfTimeIndices;
+%ignore GWFrames::WaveformView::ViewOfTimes;
+%ignore GWFrames::WaveformView::ViewOfEllModes;
 #endif
 
 %apply double& OUTPUT { double& deltat };
@@ -45,10 +80,92 @@
 //// Make sure vectors of Waveform are understood
 namespace std {
   %template(_vectorW) vector<GWFrames::Waveform>;
+  %template() vector<bool>;
+  %template(_vectorCompactWaveform) vector<GWFrames::CompactWaveform>;
+  %template() pair<vector<GWFrames::Waveform>, vector<vector<double> > >;
 };
 
+//// Wrap memory owned by a C++ object as a numpy array, without
+//// copying.  The array holds a reference to `Owner` (the python
+//// object), so that the memory stays valid while the array exists.
+%{
+  PyObject* GWFramesNumpyView(const int ND, npy_intp* Dims, const int TypeNum, void* Data,
+                              PyObject* Owner, const bool Writeable) {
+    PyObject* View = PyArray_New(&PyArray_Type, ND, Dims, TypeNum, NULL, Data, 0,
+                                 (Writeable ? NPY_ARRAY_CARRAY : NPY_ARRAY_CARRAY_RO), NULL);
+    if(!View) { return NULL; }
+    Py_INCREF(Owner);
+    if(PyArray_SetBaseObject((PyArrayObject*)View, Owner)<0) {
+      Py_DECREF(View);
+      return NULL;
+    }
+    return View;
+  }
+%}
+
 //// Make any additions to the Waveform class here
 %extend GWFrames::Waveform {
+  //// Views of the data and times; see `DataView` and `TView` below
+  PyObject* _DataView(PyObject* Owner) {
+    // The shape comes from the data themselves, which need not match
+    // the times while a Waveform is being assembled
+    npy_intp Dims[2] = { npy_intp($self->NModes()), npy_intp($self->NDataTimes()) };
+    if(Dims[0]*Dims[1]==0) {
+      return PyArray_ZEROS(2, Dims, NPY_CDOUBLE, 0);
+    }
+    return GWFramesNumpyView(2, Dims, NPY_CDOUBLE, (void*)($self->DataPointer()), Owner, true);
+  }
+  PyObject* _TView(PyObject* Owner) {
+    npy_intp Dims[1] = { npy_intp($self->NTimes()) };
+    return GWFramesNumpyView(1, Dims, NPY_DOUBLE, ($self->NTimes()>0 ? (void*)(&($self->T()[0])) : NULL), Owner, false);
+  }
+  //// Set the data or times from anything numpy can convert, with one copy
+  GWFrames::Waveform& SetDataFromArray(PyObject* Input) {
+    PyArrayObject* Array = (PyArrayObject*) PyArray_FROMANY(Input, NPY_CDOUBLE, 2, 2, NPY_ARRAY_IN_ARRAY);
+    if(!Array) { throw(GWFrames_ValueError); }
+    const npy_intp NModes = PyArray_DIM(Array, 0);
+    const npy_intp NTimes = PyArray_DIM(Array, 1);
+    $self->ResizeData(NModes, NTimes);
+    if(NModes*NTimes>0) {
+      std::memcpy((void*)($self->DataPointer()), PyArray_DATA(Array), sizeof(std::complex<double>)*NModes*NTimes);
+    }
+    Py_DECREF(Array);
+    return *$self;
+  }
+  GWFrames::Waveform& SetTimeFromArray(PyObject* Input) {
+    PyArrayObject* Array = (PyArrayObject*) PyArray_FROMANY(Input, NPY_DOUBLE, 1, 1, NPY_ARRAY_IN_ARRAY);
+    if(!Array) { throw(GWFrames_ValueError); }
+    const double* Data = (const double*) PyArray_DATA(Array);
+    $self->SetTime(std::vector<double>(Data, Data+PyArray_DIM(Array, 0)));
+    Py_DECREF(Array);
+    return *$self;
+  }
+  %insert("python") %{
+    def DataView(self) :
+      """Return the mode data as a numpy array sharing memory with this Waveform
+
+      The array has shape (NModes, NTimes) and dtype complex, with each
+      mode contiguous in memory.  (If the data have been resized to a
+      number of times other than NTimes, the array has the shape of
+      the data; empty data give an empty array.)  No data are copied, and changes to
+      the array change this Waveform.  The real and imaginary parts,
+      as well as slices like `DataView()[i_mode]`, are also views.
+
+      The view refers to the current storage, so it must not be used
+      after any operation that replaces or resizes the data (e.g.,
+      `SetData`, `ResizeData`, `InterpolateInPlace`, or other in-place
+      transformations that change the number of modes or times).
+
+      """
+      return self._DataView(self)
+    def TView(self) :
+      """Return the times as a read-only numpy array sharing memory with this Waveform
+
+      See `DataView` for the caveats.
+
+      """
+      return self._TView(self)
+  %}
   //// This function is called when printing the Waveform object
   std::string __str__() {
     std::stringstream S;
@@ -74,32 +191,45 @@ namespace std {
   %insert("python") %{
     def __getstate__(self) :
       return (self.HistoryStr(),
-              self.T(),
+              self.TView(),
               self.Frame(),
               self.FrameType(),
               self.DataType(),
               self.RIsScaledOut(),
               self.MIsScaledOut(),
               self.LM(),
-              self.Data()
+              self.DataView()
               )
     __safe_for_unpickling__ = True
     def __reduce__(self) :
         return (Waveform, (), self.__getstate__())
     def __setstate__(self, data) :
         self.SetHistory(data[0])
-        self.SetTime(data[1])
+        self.SetTimeFromArray(data[1])
         self.SetFrame(data[2])
         self.SetFrameType(data[3])
         self.SetDataType(data[4])
         self.SetRIsScaledOut(data[5])
         self.SetMIsScaledOut(data[6])
         self.SetLM(data[7].tolist())
-        self.SetData(data[8])
+        self.SetDataFromArray(data[8])
   %}
  };
 
 
+//////////////////////////////
+//// Read in noise curves ////
+//////////////////////////////
+#ifndef SWIGPYTHON_BUILTIN
+%feature("pythonappend") WaveformUtilities::NoiseCurve %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") WaveformUtilities::InverseNoiseCurve %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") WaveformUtilities::CachedInverseNoiseCurve %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+%feature("pythonappend") WaveformUtilities::NoiseCurveTable::operator() %{ if isinstance(val, tuple) : val = numpy.array(val) %}
+#endif
+%ignore WaveformUtilities::NoiseCurveTable::Evaluate;
+%include "../NoiseCurves.hpp"
+
+
 ////////////////////////////////////////////
 //// Read in the WaveformAtAPoint class ////
 ////////////////////////////////////////////
@@ -107,4 +237,16 @@ namespace std {
 %apply double *INOUT { double& timeOffset };
 %apply double *INOUT { double& phaseOffset };
 %apply double *INOUT { double& match };
+//// The batched Match returns its vectors, rather than taking them as input
+%typemap(in, numinputs=0) std::vector<double>& timeOffsets (std::vector<double> temp),
+                          std::vector<double>& phaseOffsets (std::vector<double> temp),
+                          std::vector<double>& matches (std::vector<double> temp) { $1 = &temp; }
+%typemap(argout) std::vector<double>& timeOffsets, std::vector<double>& phaseOffsets, std::vector<double>& matches {
+  $result = SWIG_Python_AppendOutput($result, swig::from(*$1));
+}
 %include "../WaveformsAtAPointFT.hpp"
+
+//// Make sure vectors of WaveformAtAPointFT are understood
+namespace std {
+  %template(_vectorWaveformAtAPointFT) vector<GWFrames::WaveformAtAPointFT>;
+};
@@ -6,6 +6,7 @@
 // #include <omp.h>
 
 #include <algorithm>
+#include <map>
 
 
 // The following are for spinsfast
@@ -30,10 +31,8 @@ namespace GWFrames {
 };
 #endif // DOXYGEN
 
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_spline.h>
-
 #include "Utilities.hpp"
+#include "fft.hpp"
 #include "Quaternions.hpp"
 #include "SphericalFunctions/SWSHs.hpp"
 #include "Waveforms.hpp"
@@ -80,6 +79,72 @@ namespace {
     const double magv = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
     return acosh(1.0/std::sqrt(1.0-magv*magv));
   }
+
+  /// Linear weights for natural cubic-spline interpolation on fixed knots
+  class NaturalSplineWeights {
+    /// A natural cubic spline (as with `gsl_interp_cspline`) is linear
+    /// in the data, so its value at any u is a weighted sum of the data
+    /// at the knots, with weights that depend only on the knots and u.
+    /// The knot-dependent part is factored once here, so the same
+    /// object can interpolate any number of data sets sharing those
+    /// knots.
+  private:
+    std::vector<double> x, h;
+    std::vector<std::vector<double> > C; // Second derivatives at the knots, as linear functions of the data
+  public:
+    NaturalSplineWeights(const std::vector<double>& Knots) : x(Knots), h(Knots.size()-1), C(Knots.size(), std::vector<double>(Knots.size(), 0.0)) {
+      const int n = x.size();
+      for(int i=0; i<n-1; ++i) { h[i] = x[i+1]-x[i]; }
+      if(n<3) { return; } // All second derivatives vanish
+      // Thomas algorithm on the interior rows, once for each unit data vector
+      std::vector<double> cprime(n), dprime(n);
+      for(int j=0; j<n; ++j) {
+        for(int i=1; i<n-1; ++i) {
+          const double r = 6*( ((i+1==j) - (i==j))/h[i] - ((i==j) - (i-1==j))/h[i-1] );
+          const double b = 2*(h[i-1]+h[i]);
+          const double a = (i>1 ? h[i-1] : 0.0);
+          const double denom = b - a*cprime[i-1];
+          cprime[i] = h[i]/denom;
+          dprime[i] = (r - a*dprime[i-1])/denom;
+        }
+        C[n-2][j] = dprime[n-2];
+        for(int i=n-3; i>0; --i) {
+          C[i][j] = dprime[i] - cprime[i]*C[i+1][j];
+        }
+      }
+    }
+    /// Fill w with the weight of each knot's data in the value at u
+    void operator()(const double u, std::vector<double>& w) const {
+      const int n = x.size();
+      w.assign(n, 0.0);
+      int k = int(std::upper_bound(x.begin(), x.end(), u) - x.begin()) - 1;
+      k = std::max(0, std::min(k, n-2));
+      const double t = x[k+1]-u, s = u-x[k], H = h[k];
+      const double c = (t*t*t/H - H*t)/6.0, d = (s*s*s/H - H*s)/6.0;
+      w[k] += t/H;
+      w[k+1] += s/H;
+      for(int j=0; j<n; ++j) {
+        w[j] += c*C[k][j] + d*C[k+1][j];
+      }
+    }
+  };
+
+  // The spline weights for the time u[i_g] at each grid point, as a
+  // row of NKnots values for each point in turn
+  std::vector<double> SplineWeightsOnGrid(const NaturalSplineWeights& Weights, const unsigned int NKnots, const DataGrid& u) {
+    const int n_g = u.size();
+    std::vector<double> W(std::size_t(n_g)*NKnots);
+    #pragma omp parallel if(n_g>1) num_threads(GWFrames::MaxThreads())
+    {
+      std::vector<double> w(NKnots);
+      #pragma omp for schedule(static)
+      for(int i_g=0; i_g<n_g; ++i_g) {
+        Weights(std::real(u[i_g]), w);
+        std::copy(w.begin(), w.end(), W.begin()+std::size_t(i_g)*NKnots);
+      }
+    }
+    return W;
+  }
 }
 #endif
 
@@ -135,12 +200,368 @@ Quaternions::Quaternion GWFrames::Boost(ThreeVector v, ThreeVector n) {
 }
 
 
+///////////////
+// ScriArena //
+///////////////
+
+#ifndef DOXYGEN
+namespace {
+  // Blocks are rounded up to one of the sizes 64, 96, 128, 192, 256,
+  // ... bytes (wasting at most a third of each); anything larger than
+  // the maximum is never pooled
+  const std::size_t ScriArenaMinimumBytes = 64;
+  const std::size_t ScriArenaMaximumBytes = std::size_t(1)<<24;
+  const int ScriArenaNClasses = 2*18+1;
+
+  // Index of the smallest size class holding Bytes, or -1 if it is too large
+  int ScriArenaClass(const std::size_t Bytes, std::size_t& ClassBytes) {
+    if(Bytes>ScriArenaMaximumBytes) {
+      ClassBytes = Bytes;
+      return -1;
+    }
+    std::size_t Power = ScriArenaMinimumBytes;
+    for(int i=0; ; i+=2, Power*=2) {
+      if(Bytes<=Power) { ClassBytes = Power; return i; }
+      if(Bytes<=Power+Power/2) { ClassBytes = Power+Power/2; return i+1; }
+    }
+  }
+
+  // Blocks freed while an arena is active, sorted by size class
+  struct ScriArenaPool {
+    std::vector<std::vector<void*> > FreeBlocks;
+    ScriArenaPool() : FreeBlocks(ScriArenaNClasses) { }
+    ~ScriArenaPool() {
+      for(unsigned int i=0; i<FreeBlocks.size(); ++i) {
+        for(unsigned int j=0; j<FreeBlocks[i].size(); ++j) {
+          ::operator delete(FreeBlocks[i][j]);
+        }
+      }
+    }
+  };
+
+  // The pool of the outermost arena on this thread, if any.  This is
+  // thread-local storage, rather than OpenMP threadprivate, so that
+  // threads not started by OpenMP (such as python threads running
+  // while the GIL is released) also get pools of their own.
+  #if __cplusplus >= 201103L
+  thread_local ScriArenaPool* CurrentScriArenaPool = 0;
+  #else
+  __thread ScriArenaPool* CurrentScriArenaPool = 0;
+  #endif
+}
+#endif // DOXYGEN
+
+/// Start recycling storage on this thread, unless an arena already exists
+GWFrames::ScriArena::ScriArena()
+  : owner(CurrentScriArenaPool==0)
+{
+  if(owner) {
+    CurrentScriArenaPool = new ScriArenaPool;
+  }
+}
+
+/// Release the recycled storage, if this is the outermost arena on this thread
+GWFrames::ScriArena::~ScriArena() {
+  if(owner) {
+    delete CurrentScriArenaPool;
+    CurrentScriArenaPool = 0;
+  }
+}
+
+/// Get a block of at least `Bytes` bytes, from the current pool if possible
+void* GWFrames::ScriArena::Allocate(const std::size_t Bytes) {
+  /// Blocks are always rounded up to their size class, whether or not
+  /// an arena is active, so that any block may be pooled when freed.
+  std::size_t ClassBytes;
+  const int i_c = ScriArenaClass(Bytes, ClassBytes);
+  if(CurrentScriArenaPool && i_c>=0) {
+    std::vector<void*>& Blocks = CurrentScriArenaPool->FreeBlocks[i_c];
+    if(!Blocks.empty()) {
+      void* p = Blocks.back();
+      Blocks.pop_back();
+      return p;
+    }
+  }
+  return ::operator new(ClassBytes);
+}
+
+/// Return a block obtained from `Allocate(Bytes)` to the current pool, or free it
+void GWFrames::ScriArena::Deallocate(void* p, const std::size_t Bytes) {
+  if(!p) { return; }
+  std::size_t ClassBytes;
+  const int i_c = ScriArenaClass(Bytes, ClassBytes);
+  if(CurrentScriArenaPool && i_c>=0) {
+    try {
+      CurrentScriArenaPool->FreeBlocks[i_c].push_back(p);
+      return;
+    } catch(...) { } // If the pool cannot grow, just free the block
+  }
+  ::operator delete(p);
+}
+
+
+/////////////
+// SHTPlan //
+/////////////
+
+#ifndef DOXYGEN
+namespace {
+  // (-1)^m, for any integer m
+  inline int SignParity(const int m) { return ((m&1) ? -1 : 1); }
+  // i^m, for any integer m
+  inline std::complex<double> IPow(const int m) {
+    const std::complex<double> Powers[4] = { std::complex<double>(1,0), std::complex<double>(0,1),
+                                             std::complex<double>(-1,0), std::complex<double>(0,-1) };
+    return Powers[((m%4)+4)%4];
+  }
+}
+#endif // DOXYGEN
+
+struct GWFrames::SHTPlan::Tables {
+  std::vector<std::vector<double> > Delta; // Delta[l][mp*(l+1)+m] = d^l_{mp,m}(pi/2), for mp,m>=0
+  std::vector<double> W; // Real-space quadrature weights on the extended theta grid
+  fftw_plan PhiFFT; // Forward FFT in phi of each theta ring (out of place)
+  fftw_plan ThetaFFT; // Forward FFT in extended theta of each m column (out of place)
+  fftw_plan BackwardFFT; // Inverse 2-d FFT of the extended grid (in place)
+};
+
+GWFrames::SHTPlan::SHTPlan(const int Spin, const int EllMax, const int N_theta, const int N_phi)
+  : s(Spin), ellMax(EllMax), n_theta(N_theta), n_phi(N_phi), tables(new Tables)
+{
+  GWFrames_INSTRUMENT("SHTPlan::SHTPlan");
+  if(n_theta<2 || n_phi<1 || ellMax<0) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: Cannot transform with ellMax=" << ellMax << " on a grid of size n_theta=" << n_theta << ", n_phi=" << n_phi << "\n"
+              << std::endl;
+    throw(GWFrames_ValueError);
+  }
+  const int wsize = 2*(n_theta-1);
+
+  // Wigner d(pi/2) quarter planes
+  wdhp_TN_helper* DeltaTN = wdhp_TN_helper_init(ellMax);
+  tables->Delta.resize(ellMax+1);
+  for(int l=0; l<=ellMax; ++l) {
+    tables->Delta[l].resize((l+1)*(l+1));
+    wdhp_get_quarter_plane(l, DeltaTN->sqt, DeltaTN->invsqt, DeltaTN->D_all_llm, &tables->Delta[l][0]);
+  }
+  wdhp_TN_helper_free(DeltaTN);
+
+  // Quadrature weights, and FFTW plans made on scratch arrays
+  // (FFTW_UNALIGNED lets them run on any arrays).  The weights are
+  // found with an FFTW plan that spinsfast makes and destroys itself,
+  // so they also need the planner lock.
+  std::vector<std::complex<double> > W(wsize);
+  {
+    const MutexLock Lock(WaveformUtilities::FFTWPlannerMutex());
+    spinsfast_quadrature_weights(reinterpret_cast<fftw_complex*>(&W[0]), wsize);
+    fftw_complex* a = (fftw_complex*) fftw_malloc(sizeof(fftw_complex)*wsize*n_phi);
+    fftw_complex* b = (fftw_complex*) fftw_malloc(sizeof(fftw_complex)*wsize*n_phi);
+    int n = n_phi;
+    tables->PhiFFT = fftw_plan_many_dft(1, &n, n_theta, a, &n, 1, n_phi, b, &n, 1, n_phi,
+                                        FFTW_FORWARD, FFTW_ESTIMATE|FFTW_UNALIGNED|FFTW_PRESERVE_INPUT);
+    n = wsize;
+    tables->ThetaFFT = fftw_plan_many_dft(1, &n, n_phi, a, &n, n_phi, 1, b, &n, n_phi, 1,
+                                          FFTW_FORWARD, FFTW_ESTIMATE|FFTW_UNALIGNED);
+    tables->BackwardFFT = fftw_plan_dft_2d(wsize, n_phi, a, a, FFTW_BACKWARD, FFTW_ESTIMATE|FFTW_UNALIGNED);
+    fftw_free(b);
+    fftw_free(a);
+  }
+  tables->W.resize(wsize);
+  for(int i=0; i<wsize; ++i) {
+    tables->W[i] = std::real(W[i]);
+  }
+  if(!tables->PhiFFT || !tables->ThetaFFT || !tables->BackwardFFT) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: FFTW could not plan transforms for n_theta=" << n_theta << ", n_phi=" << n_phi << "\n"
+              << std::endl;
+    throw(GWFrames_FailedSystemCall);
+  }
+}
+
+/// Return the (cached) plan for the given spin, ellMax, and grid size
+const GWFrames::SHTPlan& GWFrames::SHTPlan::Get(const int Spin, const int EllMax, const int N_theta, const int N_phi) {
+  static std::map<std::vector<int>, SHTPlan*> Plans;
+  static Mutex PlansMutex;
+  std::vector<int> Key(4);
+  Key[0] = Spin; Key[1] = EllMax; Key[2] = N_theta; Key[3] = N_phi;
+  const MutexLock Lock(PlansMutex);
+  std::map<std::vector<int>, SHTPlan*>::const_iterator it = Plans.find(Key);
+  if(it != Plans.end()) {
+    return *(it->second);
+  }
+  SHTPlan* Plan = new SHTPlan(Spin, EllMax, N_theta, N_phi);
+  Plans[Key] = Plan;
+  return *Plan;
+}
+
+/// Transform from values on the grid to mode weights
+void GWFrames::SHTPlan::Forward(const std::complex<double>* Grid, std::complex<double>* ModeData) const {
+  /// \param Grid Input array of n_theta*n_phi values, theta-major
+  /// \param ModeData Output array of (ellMax+1)^2 modes
+  ///
+  /// This is equivalent to spinsfast's `spinsfast_map2salm`.
+  GWFrames_INSTRUMENT("SHTPlan::Forward");
+  const int lmax = ellMax;
+  const int Nm = 2*lmax+1;
+  const int wsize = 2*(n_theta-1);
+  const double norm = M_PI/n_phi/(n_theta-1); // = 2pi/Nphi/Ntheta_extended
+  const std::vector<double>& W = tables->W;
+
+  // Extend the data to the whole sphere (the method of McEwen & Wiaux) and transform
+  GWFrames::ScriStorage fm(n_theta*n_phi), Fm(wsize*n_phi), F(wsize*n_phi);
+  fftw_execute_dft(tables->PhiFFT, reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>*>(Grid)),
+                   reinterpret_cast<fftw_complex*>(&fm[0])); // The plan preserves its input
+  const int signs = SignParity(s);
+  for(int itheta=0; itheta<n_theta; ++itheta) {
+    for(int im=0; im<n_phi; ++im) {
+      const int m = (im <= n_phi/2) ? im : (im - n_phi);
+      Fm[itheta*n_phi + im] = W[itheta] * fm[itheta*n_phi + im] * norm;
+      if(itheta > 0) {
+        Fm[(wsize-itheta)*n_phi + im] = double(signs*SignParity(m)) * W[wsize-itheta] * fm[itheta*n_phi + im] * norm;
+      }
+    }
+  }
+  fftw_execute_dft(tables->ThetaFFT, reinterpret_cast<fftw_complex*>(&Fm[0]), reinterpret_cast<fftw_complex*>(&F[0]));
+
+  // Copy the relevant frequencies into Imm
+  GWFrames::ScriStorage Imm(Nm*Nm, zero);
+  int limit = lmax;
+  if(2*limit+1 > n_phi) { limit = (n_phi-1)/2; }
+  if(2*limit+1 > wsize) { limit = n_theta-3; }
+  for(int mp=0; mp<=limit; ++mp) {
+    for(int m=0; m<=limit; ++m) {
+      Imm[mp*Nm + m] = F[mp*n_phi + m];
+      if(m > 0) { Imm[mp*Nm + (Nm-m)] = F[mp*n_phi + (n_phi-m)]; }
+      if(mp > 0) { Imm[(Nm-mp)*Nm + m] = F[(wsize-mp)*n_phi + m]; }
+      if(mp > 0 && m > 0) { Imm[(Nm-mp)*Nm + (Nm-m)] = F[(wsize-mp)*n_phi + (n_phi-m)]; }
+    }
+  }
+
+  // Combine m' and -m' into Jmm
+  GWFrames::ScriStorage Jmm(Nm*(lmax+1));
+  for(int mp=0; mp<=lmax; ++mp) {
+    const int negmpmod = (Nm-mp)%Nm;
+    for(int m=-lmax; m<=lmax; ++m) {
+      const int mmod = (Nm+m)%Nm;
+      if(mp==0) {
+        Jmm[mp*Nm + mmod] = Imm[mp*Nm + mmod];
+      } else {
+        Jmm[mp*Nm + mmod] = Imm[mp*Nm + mmod] + double(SignParity(m)*signs)*Imm[negmpmod*Nm + mmod];
+      }
+    }
+  }
+
+  // Contract with the Wigner d matrices
+  const int Nlm = (lmax+1)*(lmax+1);
+  for(int i=0; i<Nlm; ++i) { ModeData[i] = zero; }
+  const int abss = std::abs(s);
+  for(int l=abss; l<=lmax; ++l) {
+    std::complex<double>* asl = &ModeData[l*l+l];
+    const double norml = std::sqrt(2*l+1)/2./std::sqrt(M_PI);
+    const int negtol = SignParity(l);
+    for(int mp=0; mp<=l; ++mp) {
+      const double* Delta_mp = &tables->Delta[l][mp*(l+1)];
+      const int signnegm = negtol*SignParity(mp);
+      const int s_sign_fudge = (s>=0) ? 1 : SignParity(l+mp);
+      const double Deltamps_norml = Delta_mp[abss] * norml * s_sign_fudge;
+      const std::complex<double>* Jmp = &Jmm[mp*Nm];
+      for(int m=0; m<=l; ++m) {
+        const double fact = Delta_mp[m] * Deltamps_norml;
+        asl[m] += (fact*signnegm) * Jmp[m];
+        asl[-m] += fact * Jmp[(Nm-m)%Nm];
+      }
+    }
+  }
+
+  // Set the phases
+  const std::complex<double> negItos = IPow(-s);
+  for(int l=abss; l<=lmax; ++l) {
+    std::complex<double>* asl = &ModeData[l*l+l];
+    asl[0] /= 2;
+    for(int m=-l; m<=l; ++m) {
+      asl[m] *= IPow(m)*negItos;
+    }
+  }
+}
+
+/// Transform from mode weights to values on the grid
+void GWFrames::SHTPlan::Backward(const std::complex<double>* ModeData, std::complex<double>* Grid) const {
+  /// \param ModeData Input array of (ellMax+1)^2 modes
+  /// \param Grid Output array of n_theta*n_phi values, theta-major
+  ///
+  /// This is equivalent to spinsfast's `spinsfast_salm2map`.
+  GWFrames_INSTRUMENT("SHTPlan::Backward");
+  const int lmax = ellMax;
+  const int Nm = 2*lmax+1;
+  const int wsize = 2*(n_theta-1);
+  const int abss = std::abs(s);
+
+  // Contract with the Wigner d matrices to find Gm'm for m'>=0
+  GWFrames::ScriStorage Gmm(Nm*Nm, zero);
+  for(int l=abss; l<=lmax; ++l) {
+    const std::complex<double>* asl = &ModeData[l*l+l];
+    const double norml = std::sqrt(2*l+1)/2./std::sqrt(M_PI);
+    const int negtol = SignParity(l);
+    for(int mp=0; mp<=l; ++mp) {
+      const double* Delta_mp = &tables->Delta[l][mp*(l+1)];
+      std::complex<double>* Gmp = &Gmm[mp*Nm];
+      const int s_sign_fudge = (s>=0) ? 1 : SignParity(l+mp);
+      const double Deltamps_norml = s_sign_fudge * Delta_mp[abss] * norml;
+      const double Deltamps_norml_negtol = Deltamps_norml * negtol;
+      Gmp[0] += (Delta_mp[0] * Deltamps_norml_negtol) * asl[0];
+      for(int m=1; m<=l; ++m) {
+        Gmp[m] += (Delta_mp[m] * Deltamps_norml_negtol) * asl[m];
+        Gmp[Nm-m] += (Delta_mp[m] * Deltamps_norml) * asl[-m];
+      }
+    }
+  }
+
+  // Set the phases, and use the symmetry G_(-m')m = (-1)^(m+s) G_m'm
+  for(int mp=0; mp<=lmax; ++mp) {
+    std::complex<double>* Gmp = &Gmm[mp*Nm];
+    for(int m=-lmax; m<=lmax; ++m) {
+      Gmp[(Nm+m)%Nm] *= IPow(s)*IPow(m);
+    }
+    for(int m=0; m<=lmax; ++m) {
+      Gmp[m] *= double(SignParity(mp+m));
+    }
+    for(int m=-lmax; m<0; ++m) {
+      Gmp[Nm+m] *= double(SignParity(m));
+    }
+  }
+  for(int mp=0; mp<=lmax; ++mp) {
+    const std::complex<double>* Gmp = &Gmm[mp*Nm];
+    std::complex<double>* Gnegmp = &Gmm[((Nm-mp)%Nm)*Nm];
+    for(int m=-lmax; m<=lmax; ++m) {
+      const int mmod = (Nm+m)%Nm;
+      Gnegmp[mmod] = double(SignParity(m+s))*Gmp[mmod];
+    }
+  }
+
+  // Copy into the extended grid, and transform
+  GWFrames::ScriStorage F(wsize*n_phi, zero);
+  int limit = lmax;
+  if(2*limit+1 > n_phi) { limit = (n_phi-1)/2; }
+  if(2*limit+1 > wsize) { limit = n_theta-3; }
+  for(int mp=0; mp<=limit; ++mp) {
+    for(int m=0; m<=limit; ++m) {
+      F[mp*n_phi + m] = Gmm[mp*Nm + m];
+      if(m > 0) { F[mp*n_phi + (n_phi-m)] = Gmm[mp*Nm + (Nm-m)]; }
+      if(mp > 0) { F[(wsize-mp)*n_phi + m] = Gmm[(Nm-mp)*Nm + m]; }
+      if(mp > 0 && m > 0) { F[(wsize-mp)*n_phi + (n_phi-m)] = Gmm[(Nm-mp)*Nm + (Nm-m)]; }
+    }
+  }
+  fftw_execute_dft(tables->BackwardFFT, reinterpret_cast<fftw_complex*>(&F[0]), reinterpret_cast<fftw_complex*>(&F[0]));
+  std::copy(F.begin(), F.begin()+n_theta*n_phi, Grid);
+}
+
+
 //////////////
 // DataGrid //
 //////////////
 
 DataGrid::DataGrid(const int Spin, const int N_theta, const int N_phi, const std::vector<std::complex<double> >& D)
-  : s(Spin), n_theta(N_theta), n_phi(N_phi), data(D)
+  : s(Spin), n_theta(N_theta), n_phi(N_phi), data(D.begin(), D.end())
 {
   // Check that we have the right amount of data
   if(n_theta*n_phi != int(D.size())) {
@@ -152,12 +573,10 @@ DataGrid::DataGrid(const int Spin, const int N_theta, const int N_phi, const std
   }
 }
 
-DataGrid::DataGrid(Modes M, const int N_theta, const int N_phi)
+DataGrid::DataGrid(const Modes& M, const int N_theta, const int N_phi)
   : s(M.Spin()), n_theta(std::max(N_theta, 2*M.EllMax()+1)), n_phi(std::max(N_phi, 2*M.EllMax()+1)), data(n_phi*n_theta, zero)
 {
-  spinsfast_salm2map(reinterpret_cast<fftw_complex*>(&M[0]),
-                     reinterpret_cast<fftw_complex*>(&data[0]),
-                     M.Spin(), n_theta, n_phi, M.EllMax());
+  SHTPlan::Get(M.Spin(), M.EllMax(), n_theta, n_phi).Backward(&M.data[0], &data[0]);
 }
 
 DataGrid::DataGrid(const Modes& M, const GWFrames::ThreeVector& v, const int N_theta, const int N_phi)
@@ -202,120 +621,140 @@ DataGrid::DataGrid(const int Spin, const int N_theta, const int N_phi, const GWF
   }
 }
 
-DataGrid DataGrid::operator*(const DataGrid& A) const {
-  const DataGrid& B=*this;
-
+/// Multiply pointwise by another grid, in place
+DataGrid& DataGrid::operator*=(const DataGrid& A) {
   // Check that we have the same amounts of data
-  if(A.n_theta != B.n_theta) {
+  if(A.n_theta != n_theta) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << B.n_theta << ")"
+              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << n_theta << ")"
               << "\n       Cannot multiply data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
-  if(A.n_phi != B.n_phi) {
+  if(A.n_phi != n_phi) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << B.n_phi << ")"
+              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << n_phi << ")"
               << "\n       Cannot multiply data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
 
   // Do the work
-  DataGrid C(B);
   for(unsigned int i=0; i<data.size(); ++i) {
-    C.data[i] *= A.data[i];
+    data[i] *= A.data[i];
   }
-  C.s = s + A.s;
-
-  return C;
+  s += A.s;
+  return *this;
 }
 
-DataGrid DataGrid::operator/(const DataGrid& A) const {
-  const DataGrid& B=*this;
-
+/// Divide pointwise by another grid, in place
+DataGrid& DataGrid::operator/=(const DataGrid& A) {
   // Check that we have the same amounts of data
-  if(A.n_theta != B.n_theta) {
+  if(A.n_theta != n_theta) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << B.n_theta << ")"
+              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << n_theta << ")"
               << "\n       Cannot divide data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
-  if(A.n_phi != B.n_phi) {
+  if(A.n_phi != n_phi) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << B.n_phi << ")"
+              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << n_phi << ")"
               << "\n       Cannot divide data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
 
   // Do the work
-  DataGrid C(B);
   for(unsigned int i=0; i<data.size(); ++i) {
-    C.data[i] /= A.data[i];
+    data[i] /= A.data[i];
   }
-  C.s = s - A.s;
-
-  return C;
+  s -= A.s;
+  return *this;
 }
 
-DataGrid DataGrid::operator+(const DataGrid& A) const {
-  const DataGrid& B=*this;
-
+/// Add another grid, in place
+DataGrid& DataGrid::operator+=(const DataGrid& A) {
   // Check that we have the same amounts of data
-  if(A.n_theta != B.n_theta) {
+  if(A.n_theta != n_theta) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << B.n_theta << ")"
+              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << n_theta << ")"
               << "\n       Cannot add data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
-  if(A.n_phi != B.n_phi) {
+  if(A.n_phi != n_phi) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << B.n_phi << ")"
+              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << n_phi << ")"
               << "\n       Cannot add data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
 
   // Do the work
-  DataGrid C(B);
   for(unsigned int i=0; i<data.size(); ++i) {
-    C.data[i] += A.data[i];
+    data[i] += A.data[i];
   }
-
-  return C;
+  return *this;
 }
 
-DataGrid DataGrid::operator-(const DataGrid& A) const {
-  const DataGrid& B=*this;
-
+/// Subtract another grid, in place
+DataGrid& DataGrid::operator-=(const DataGrid& A) {
   // Check that we have the same amounts of data
-  if(A.n_theta != B.n_theta) {
+  if(A.n_theta != n_theta) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << B.n_theta << ")"
+              << "\nError: (A.n_theta=" << A.n_theta << ") != (B.n_theta=" << n_theta << ")"
               << "\n       Cannot subtract data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
-  if(A.n_phi != B.n_phi) {
+  if(A.n_phi != n_phi) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << B.n_phi << ")"
+              << "\nError: (A.n_phi=" << A.n_phi << ") != (B.n_phi=" << n_phi << ")"
               << "\n       Cannot subtract data of different sizes\n"
               << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
 
   // Do the work
-  DataGrid C(B);
   for(unsigned int i=0; i<data.size(); ++i) {
-    C.data[i] -= A.data[i];
+    data[i] -= A.data[i];
   }
+  return *this;
+}
 
+DataGrid DataGrid::operator*(const DataGrid& A) const {
+  DataGrid C(*this);
+  C *= A;
   return C;
 }
 
+DataGrid DataGrid::operator/(const DataGrid& A) const {
+  DataGrid C(*this);
+  C /= A;
+  return C;
+}
+
+DataGrid DataGrid::operator+(const DataGrid& A) const {
+  DataGrid C(*this);
+  C += A;
+  return C;
+}
+
+DataGrid DataGrid::operator-(const DataGrid& A) const {
+  DataGrid C(*this);
+  C -= A;
+  return C;
+}
+
+DataGrid& DataGrid::operator*=(const double a) {
+  const unsigned int N = data.size();
+  for(unsigned int i=0; i<N; ++i) {
+    data[i] *= a;
+  }
+  return *this;
+}
+
 DataGrid DataGrid::pow(const int p) const {
   DataGrid c(*this);
   const int N = c.N_theta()*c.N_phi();
@@ -427,7 +866,7 @@ DataGrid GWFrames::InverseConformalFactorBoostedGrid(const GWFrames::ThreeVector
 ///////////
 
 Modes::Modes(const int spin, const std::vector<std::complex<double> >& Data)
-  : s(spin), ellMax(0), data(Data)
+  : s(spin), ellMax(0), data(Data.begin(), Data.end())
 {
   // Find the appropriate ellMax for this data length
   for(; ellMax<=SphericalFunctions::ellMax; ++ellMax) {
@@ -446,12 +885,10 @@ Modes::Modes(const int spin, const std::vector<std::complex<double> >& Data)
   }
 }
 
-Modes::Modes(DataGrid D, const int L)
+Modes::Modes(const DataGrid& D, const int L)
   : s(D.Spin()), ellMax(std::max(std::min((D.N_theta()-1)/2, (D.N_phi()-1)/2), L)), data(N_lm(ellMax))
 {
-  spinsfast_map2salm(reinterpret_cast<fftw_complex*>(&D[0]),
-                     reinterpret_cast<fftw_complex*>(&data[0]),
-                     s, D.N_theta(), D.N_phi(), ellMax);
+  SHTPlan::Get(s, ellMax, D.N_theta(), D.N_phi()).Forward(&D.data[0], &data[0]);
 }
 
 GWFrames::Modes& GWFrames::Modes::operator=(const Modes& B) {
@@ -700,6 +1137,137 @@ GWFrames::ThreeVector GWFrames::vFromOneOverK(const GWFrames::Modes& OneOverK) {
 
 
 
+/////////////////
+// ModesTensor //
+/////////////////
+
+#ifndef DOXYGEN
+namespace {
+  // Number of times (or modes) handled together when transposing
+  // Waveform data, chosen so that a block comfortably fits in cache
+  const int TransposeBlockSize = 64;
+}
+#endif // DOXYGEN
+
+/// Constructor with zeroed storage
+GWFrames::ModesTensor::ModesTensor(const int NFields, const int NTimes, const int EllMax)
+  : nFields(NFields), nTimes(NTimes), ellMax(EllMax), spins(NFields, 0), data(std::size_t(NFields)*NTimes*(EllMax+1)*(EllMax+1))
+{ }
+
+/// Copy the modes of a Waveform into one field
+GWFrames::ModesTensor& GWFrames::ModesTensor::SetField(const unsigned int i_field, const GWFrames::Waveform& W) {
+  /// \param i_field Index of the field to set
+  /// \param W Waveform with the same number of times as this object
+  ///
+  /// Every (ell,m) mode up to ellMax must be present in `W`; modes in
+  /// `W` with ell>ellMax are ignored.  The spin weight of the field is
+  /// not changed.
+  if(int(W.NTimes())!=nTimes) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: W.NTimes()=" << W.NTimes() << " != NTimes()=" << nTimes << "\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  const int NM = NModes();
+  vector<const complex<double>*> In(NM); // Look up each mode just once
+  for(int i_m=0, ell=0; ell<=ellMax; ++ell) {
+    for(int m=-ell; m<=ell; ++m, ++i_m) {
+      In[i_m] = W(W.FindModeIndex(ell,m));
+    }
+  }
+  complex<double>* Out = ModeData(i_field, 0);
+  // Transpose [mode][time] to [time][mode] one block of times at a time
+  const int NBlocks = (nTimes+TransposeBlockSize-1)/TransposeBlockSize;
+  #pragma omp parallel for schedule(static) if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+  for(int i_b=0; i_b<NBlocks; ++i_b) {
+    const int i_t_a = i_b*TransposeBlockSize;
+    const int i_t_b = std::min(nTimes, i_t_a+TransposeBlockSize);
+    for(int i_m=0; i_m<NM; ++i_m) {
+      const complex<double>* In_m = In[i_m];
+      for(int i_t=i_t_a; i_t<i_t_b; ++i_t) {
+        Out[std::size_t(i_t)*NM+i_m] = In_m[i_t];
+      }
+    }
+  }
+  return *this;
+}
+
+/// Copy the time derivatives of the modes of a Waveform into one field
+GWFrames::ModesTensor& GWFrames::ModesTensor::SetFieldDot(const unsigned int i_field, const GWFrames::Waveform& W) {
+  /// \param i_field Index of the field to set
+  /// \param W Waveform with the same number of times as this object
+  ///
+  /// This is equivalent to `SetField` applied to the derivative of
+  /// `W`, as computed by `Waveform::DataDot`, though the stencil
+  /// weights are computed just once for all modes.
+  if(int(W.NTimes())!=nTimes) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: W.NTimes()=" << W.NTimes() << " != NTimes()=" << nTimes << "\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  const int NM = NModes();
+  vector<unsigned int> Index(NM);
+  for(int i_m=0, ell=0; ell<=ellMax; ++ell) {
+    for(int m=-ell; m<=ell; ++m, ++i_m) {
+      Index[i_m] = W.FindModeIndex(ell,m);
+    }
+  }
+  complex<double>* Out = ModeData(i_field, 0);
+  const DerivativePlan Derivative(W.T());
+  // Differentiate a block of modes, then transpose that block into place
+  const int NBlocks = (NM+TransposeBlockSize-1)/TransposeBlockSize;
+  #pragma omp parallel for schedule(dynamic) if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+  for(int i_b=0; i_b<NBlocks; ++i_b) {
+    const int i_m_a = i_b*TransposeBlockSize;
+    const int i_m_b = std::min(NM, i_m_a+TransposeBlockSize);
+    vector<vector<complex<double> > > Dots(i_m_b-i_m_a, vector<complex<double> >(nTimes));
+    for(int i_m=i_m_a; i_m<i_m_b; ++i_m) {
+      Derivative.Differentiate(W(Index[i_m]), &Dots[i_m-i_m_a][0]);
+    }
+    for(int i_t=0; i_t<nTimes; ++i_t) {
+      complex<double>* Out_t = &Out[std::size_t(i_t)*NM];
+      for(int i_m=i_m_a; i_m<i_m_b; ++i_m) {
+        Out_t[i_m] = Dots[i_m-i_m_a][i_t];
+      }
+    }
+  }
+  return *this;
+}
+
+/// Copy a single set of modes into one field at one time
+GWFrames::ModesTensor& GWFrames::ModesTensor::SetModes(const unsigned int i_field, const unsigned int i_t, const Modes& M) {
+  /// \param i_field Index of the field to set
+  /// \param i_t Index of the time to set
+  /// \param M Modes with the same ellMax as this object
+  ///
+  /// The spin weight of the field is set to that of `M`.
+  if(int(M.size())!=NModes()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: M.size()=" << M.size() << " != NModes()=" << NModes() << "\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  spins[i_field] = M.Spin();
+  complex<double>* Out = ModeData(i_field, i_t);
+  for(int i_m=0; i_m<NModes(); ++i_m) {
+    Out[i_m] = M[i_m];
+  }
+  return *this;
+}
+
+/// Copy one field at one time into a Modes object
+Modes GWFrames::ModesTensor::GetModes(const unsigned int i_field, const unsigned int i_t) const {
+  const complex<double>* In = ModeData(i_field, i_t);
+  Modes M(NModes());
+  M.SetSpin(spins[i_field]).SetEllMax(ellMax);
+  for(int i_m=0; i_m<NModes(); ++i_m) {
+    M[i_m] = In[i_m];
+  }
+  return M;
+}
+
+
 /////////////////
 // SliceOfScri //
 /////////////////
@@ -731,6 +1299,21 @@ SliceModes::SliceModes(const int ellMax)
   sigmadot.SetEllMax(ellMax);
 }
 
+/// Constructor from one time of a tensor holding psi0, ..., psi4, sigma, sigmadot
+SliceModes::SliceModes(const GWFrames::ModesTensor& T, const unsigned int i_t)
+  : SliceOfScri<Modes>()
+{
+  if(T.NFields()!=7) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: T.NFields()=" << T.NFields() << " != 7\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  for(int i_D=0; i_D<7; ++i_D) {
+    (*this)[i_D] = T.GetModes(i_D, i_t);
+  }
+}
+
 /// Find largest ell value in the data on this slice
 int SliceModes::EllMax() const {
   return std::max(psi0.EllMax(),
@@ -746,6 +1329,142 @@ int SliceModes::EllMax() const {
                   );
 }
 
+#ifndef DOXYGEN
+namespace {
+  // The (Bondi) four-momentum given by the ell=0 and ell=1 modes of a
+  // supermomentum
+  FourVector FourMomentumFromSuperMomentum(const Modes& Psi) {
+    FourVector p(4);
+    p[0] = std::real(Psi[0])/sqrt4pi;
+    // The following are divided by 3 relative to what I would naively
+    // expect.  I don't understand why, but this is written into the
+    // definition of the vector l^a, so it must be incorporated each
+    // time that vector appears.
+    p[1] = std::real((Psi[1]-Psi[3]))/(sqrt3*sqrt8pi);
+    p[2] = -std::real(complexi*(Psi[1]+Psi[3]))/(sqrt3*sqrt8pi);
+    p[3] = std::real(Psi[2])/(sqrt3*sqrt4pi);
+    return p;
+  }
+
+  // The Moreschi algorithm needs the ell=1 modes to find the
+  // four-momentum
+  void CheckMoreschiEllMax(const int ellMax) {
+    if(ellMax<1) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: EllMax()=" << ellMax << " < 1"
+                << "\n       The four-momentum needs the ell=1 modes.\n"
+                << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+  }
+
+  // Make sure the initial guesses for the Moreschi algorithm have all
+  // the modes the iteration will set.  Empty inputs are replaced by
+  // the identity transformation; missing higher modes are zero.
+  void PrepareMoreschiGuess(const int ellMax, Modes& OneOverK, Modes& delta) {
+    if(OneOverK.size()<4) {
+      vector<complex<double> > D(4, zero);
+      D[0] = (OneOverK.size()>0 ? OneOverK[0] : complex<double>(sqrt4pi, 0.0));
+      OneOverK = Modes(0, D);
+    }
+    if(int(delta.size())!=(ellMax+1)*(ellMax+1)) {
+      vector<complex<double> > D = delta.Data();
+      D.resize((ellMax+1)*(ellMax+1), zero);
+      delta = Modes(0, D);
+    }
+  }
+
+  // The inverse conformal factor 1/K = s (p^0 - \vec{p}.\hat{n}) / M
+  // of the boost to the rest frame of p, where M is the mass and s is
+  // the sign of p^0, so that 1/K>0.  Its ell=1 modes are the
+  // components of \vec{p} without the factor of 3 that
+  // FourMomentumFromSuperMomentum divides out.
+  Modes OneOverKFromFourMomentum(const FourVector& p) {
+    const double MSquared = p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3];
+    if(!(MSquared>0.0)) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: p=(" << p[0] << ", " << p[1] << ", " << p[2] << ", " << p[3] << ") is not timelike."
+                << "\n       There is no rest frame to boost to.\n"
+                << std::endl;
+      throw(GWFrames_ValueError);
+    }
+    const double sOverM = (p[0]<0.0 ? -1.0 : 1.0) / std::sqrt(MSquared);
+    vector<complex<double> > D(4);
+    D[0] = sOverM * sqrt4pi * p[0];
+    D[1] = -sOverM * (sqrt8pi/(2*sqrt3)) * complex<double>(p[1], p[2]);
+    D[2] = -sOverM * (sqrt4pi/sqrt3) * p[3];
+    D[3] = -sOverM * (sqrt8pi/(2*sqrt3)) * complex<double>(-p[1], p[2]);
+    return Modes(0, D);
+  }
+
+  // The four-momentum pPrime, measured in the frame moving with
+  // velocity v relative to the original frame, expressed in the
+  // original frame
+  FourVector BoostToOriginalFrame(const ThreeVector& v, const FourVector& pPrime) {
+    const double vSquared = v[0]*v[0]+v[1]*v[1]+v[2]*v[2];
+    FourVector p(pPrime);
+    if(vSquared==0.0) { return p; }
+    const double gamma = 1.0/std::sqrt(1.0-vSquared);
+    const double vDotp = v[0]*pPrime[1]+v[1]*pPrime[2]+v[2]*pPrime[3];
+    const double factor = (gamma-1.0)*vDotp/vSquared + gamma*pPrime[0];
+    p[0] = gamma*(pPrime[0]+vDotp);
+    for(int i=0; i<3; ++i) {
+      p[i+1] += factor*v[i];
+    }
+    return p;
+  }
+
+  // Set OneOverK to the boost to the rest frame of p, and the ell>=2
+  // modes of Delta to the supertranslation of the nice section
+  //   \eth^2\bar{\eth}^2 Delta = Psi - s M K^3,
+  // where Psi is the supermomentum on the current section and s M is
+  // the energy in the rest frame.  The operator is inverted with the
+  // same eigenvalues as Modes::edth2edthbar2, which is what
+  // BMSTransform subtracts, so that BMSTransform(OneOverK,Delta)
+  // returns the constant s M when Psi does not change from one
+  // section to the next.
+  void NiceSectionUpdate(const Modes& Psi, const FourVector& p, Modes& OneOverK, Modes& Delta) {
+    OneOverK = OneOverKFromFourMomentum(p);
+    const double sM = (p[0]<0.0 ? -1.0 : 1.0) * std::sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]);
+
+    // The grid is large enough to keep every mode of K^3 that Psi has
+    const int ellMax = std::min(Delta.EllMax(), Psi.EllMax());
+    const int n = 2*Psi.EllMax()+1;
+    const Modes deltaderiv = Psi - Modes(sM/DataGrid(OneOverK, n, n).pow(3), Psi.EllMax());
+    for(int i_m=4, ell=2; ell<=ellMax; ++ell) {
+      const double factor = 1.0/((ell-1.0)*(ell)*(ell+1.0)*(ell+2.0));
+      for(int m=-ell; m<=ell; ++m, ++i_m) {
+        Delta[i_m] = factor*deltaderiv[i_m];
+      }
+    }
+  }
+
+  // Replace (OneOverK, delta) by the next step of the Moreschi
+  // algorithm, given the supermomentum Psi_i of the original frame on
+  // the section u=delta(x) -- without the conformal factor or the
+  // \eth^2\bar{\eth}^2 delta term that BMSTransform applies.  Both
+  // are found afresh from Psi_i, so the step is the Dain-Moreschi
+  // fixed-point map for the nice section, which contracts when Psi
+  // changes slowly across the section.  The ell<2 modes of delta (the
+  // translation) are left unchanged.
+  void MoreschiUpdate(const Modes& Psi_i, Modes& OneOverK, Modes& delta) {
+    NiceSectionUpdate(Psi_i, FourMomentumFromSuperMomentum(Psi_i), OneOverK, delta);
+  }
+
+  // Sum of the squared magnitudes of modes [i_a,i_b) of A-B, and of A;
+  // by Parseval's theorem, these are the squared L^2 norms on the
+  // sphere, so no grid is needed
+  void AccumulateModeChange(const Modes& A, const Modes& B, const unsigned int i_a, const unsigned int i_b,
+                            double& ChangeSquared, double& NormSquared) {
+    for(unsigned int i_m=i_a; i_m<i_b && i_m<A.size(); ++i_m) {
+      const complex<double> b = (i_m<B.size() ? B[i_m] : zero);
+      ChangeSquared += std::norm(A[i_m]-b);
+      NormSquared += std::norm(A[i_m]);
+    }
+  }
+}
+#endif // DOXYGEN
+
 /// Calculate the mass of the system from the four-momentum
 double SliceModes::Mass() const {
   const FourVector p = FourMomentum();
@@ -756,17 +1475,7 @@ double SliceModes::Mass() const {
 GWFrames::FourVector SliceModes::FourMomentum() const {
   /// The (Bondi) four-momentum is given by the ell=0 and ell=1 modes
   /// of the supermomentum.
-  const Modes Psi = SuperMomentum();
-  FourVector p(4);
-  p[0] = std::real(Psi[0])/sqrt4pi;
-  // The following are divided by 3 relative to what I would naively
-  // expect.  I don't understand why, but this is written into the
-  // definition of the vector l^a, so it must be incorporated each
-  // time that vector appears.
-  p[1] = std::real((Psi[1]-Psi[3]))/(sqrt3*sqrt8pi);
-  p[2] = -std::real(complexi*(Psi[1]+Psi[3]))/(sqrt3*sqrt8pi);
-  p[3] = std::real(Psi[2])/(sqrt3*sqrt4pi);
-  return p;
+  return FourMomentumFromSuperMomentum(SuperMomentum());
 }
 
 /// Find the Moreschi supermomentum
@@ -785,62 +1494,509 @@ GWFrames::SliceGrid SliceModes::BMSTransformationOnSlice(const double u, const T
   /// point, and the change of grid points themselves.  The returned
   /// object is a `DataGrid` object, each point of which can then be
   /// used to interpolate to the supertranslated time.
+  ///
+  /// When transforming many slices with the same `v` and `delta`,
+  /// construct a `BMSTransformationContext` once and use the
+  /// overload taking that object instead.
+  return BMSTransformationContext(EllMax(), v, delta).TransformSlice(u, *this);
+}
 
-  const int n_theta = 2*EllMax()+1;
-  const int n_phi = n_theta;
+GWFrames::SliceGrid SliceModes::BMSTransformationOnSlice(const double u, const GWFrames::BMSTransformationContext& Context) const {
+  /// \param u Time of this slice
+  /// \param Context Precomputed data for the BMS transformation
+  return Context.TransformSlice(u, *this);
+}
+
+
+/////////////////////////////////
+// BMS transformation contexts //
+/////////////////////////////////
+
+GWFrames::BMSTransformationContext::BMSTransformationContext(const int EllMax, const ThreeVector& V, const Modes& delta)
+  : ellMax(EllMax), n_theta(2*EllMax+1), n_phi(2*EllMax+1), v(V), SWSHs(5)
+{
+  /// \param EllMax Largest ell value of the slices to be transformed
+  /// \param V Three-vector of the boost relative to the current frame
+  /// \param delta Spherical-harmonic modes of the supertranslation
+  InitializeBoost();
+  SetSupertranslation(delta);
+}
+
+GWFrames::BMSTransformationContext::BMSTransformationContext(const int EllMax, const ThreeVector& V)
+  : ellMax(EllMax), n_theta(2*EllMax+1), n_phi(2*EllMax+1), v(V), SWSHs(5)
+{
+  /// \param EllMax Largest ell value of the slices to be transformed
+  /// \param V Three-vector of the boost relative to the current frame
+  ///
+  /// The supertranslation is zero; it may be set later with
+  /// `SetSupertranslation`, which is much cheaper than constructing a
+  /// new context.
+  InitializeBoost();
+  SetSupertranslation(Modes());
+}
+
+/// Evaluate everything that depends only on ellMax and the boost
+void GWFrames::BMSTransformationContext::InitializeBoost() {
+  GWFrames::ScriArena Arena;
 
-  // Evaluate the functions we need on the boosted (and appropriately spin-transformed) grid
-  const DataGrid oneoverK_g = GWFrames::InverseConformalFactorBoostedGrid(v, n_theta, n_phi);
-  const DataGrid oneoverKcubed_g = oneoverK_g.pow(3);
-  const DataGrid ethethdelta_g(delta.edth().edth(), v, n_theta, n_phi);
-  const DataGrid ethupok_g = DataGrid(Modes((u-DataGrid(delta,n_theta,n_phi))/GWFrames::InverseConformalFactorGrid(v, n_theta, n_phi)).edth(),
-                                      v, n_theta, n_phi)*oneoverK_g; // (\eth u') / K
-  const DataGrid psi0_g(psi0, v, n_theta, n_phi);
-  const DataGrid psi1_g(psi1, v, n_theta, n_phi);
-  const DataGrid psi2_g(psi2, v, n_theta, n_phi);
-  const DataGrid psi3_g(psi3, v, n_theta, n_phi);
-  const DataGrid psi4_g(psi4, v, n_theta, n_phi);
-  const DataGrid sigma_g(sigma, v, n_theta, n_phi);
-  const DataGrid sigmadot_g(sigmadot, v, n_theta, n_phi);
-
-  // Construct new data accounting for changes of tetrad
+  // Evaluate the SWSHs at the boosted grid points, for each spin weight needed
+  const int n_g = n_theta*n_phi;
+  const int NModes = (ellMax+1)*(ellMax+1);
+  const double dtheta = M_PI/double(n_theta-1); // theta should return to M_PI
+  const double dphi = 2*M_PI/double(n_phi); // phi should not return to 2*M_PI
+  for(int s=-2; s<=2; ++s) {
+    SWSHs[s+2].resize(n_g*NModes);
+  }
+  // Evaluate one SWSH of each spin weight first.  This initializes
+  // the SphericalFunctions singletons before any threads are started.
+  for(int s=-2; s<=2; ++s) {
+    SphericalFunctions::SWSH Y(s);
+    Y.SetRotation(Quaternion(1,0,0,0));
+    Y(ellMax,0);
+  }
+  #pragma omp parallel if(n_g>1) num_threads(GWFrames::MaxThreads())
+  {
+    vector<SphericalFunctions::SWSH> Y;
+    for(int s=-2; s<=2; ++s) { Y.push_back(SphericalFunctions::SWSH(s)); }
+    #pragma omp for schedule(static)
+    for(int i_g=0; i_g<n_g; ++i_g) {
+      const int i_theta = i_g/n_phi;
+      const int i_phi = i_g%n_phi;
+      const Quaternion Rp(dtheta*i_theta, dphi*i_phi);
+      const Quaternion R_b = Boost(-v, (Rp*zHat*Rp.conjugate()).vec());
+      for(int s=-2; s<=2; ++s) {
+        Y[s+2].SetRotation(R_b*Rp);
+        complex<double>* Y_g = &SWSHs[s+2][i_g*NModes];
+        for(int i_m=0, ell=0; ell<=ellMax; ++ell) {
+          for(int m=-ell; m<=ell; ++m, ++i_m) {
+            Y_g[i_m] = Y[s+2](ell,m);
+          }
+        }
+      }
+    }
+  }
+
+  // Evaluate the boost-dependent functions on the boosted grid
+  oneoverK_g = GWFrames::InverseConformalFactorBoostedGrid(v, n_theta, n_phi);
+  oneoverKsquared_g = oneoverK_g.pow(2);
+  oneoverKcubed_g = oneoverK_g.pow(3);
+  // The slice-dependent (\eth u') / K = (\eth [(u-delta)*K]) / K is linear
+  // in u, so we store the coefficients (\eth K) / K and (\eth [delta*K]) / K;
+  // the latter is set with the supertranslation
+  const DataGrid K = 1.0/GWFrames::InverseConformalFactorGrid(v, n_theta, n_phi);
+  ethKoverK_g = BoostedGrid(Modes(K).edth())*oneoverK_g;
+}
+
+/// Replace the supertranslation, keeping everything that depends only on the boost
+GWFrames::BMSTransformationContext& GWFrames::BMSTransformationContext::SetSupertranslation(const Modes& delta) {
+  /// \param delta Spherical-harmonic modes of the supertranslation (empty for zero)
+  ///
+  /// The SWSH tables are kept, so this costs about as much as
+  /// transforming a single slice.  It must not be called while the
+  /// context is in use on another thread.
+  GWFrames::ScriArena Arena;
+  const int n_g = n_theta*n_phi;
+  if(delta.size()==0) {
+    ethethdelta_g = DataGrid(2, n_theta, n_phi, vector<complex<double> >(n_g));
+    ethdeltaKoverK_g = DataGrid(1, n_theta, n_phi, vector<complex<double> >(n_g));
+    return *this;
+  }
+  ethethdelta_g = BoostedGrid(delta.edth().edth());
+  const DataGrid K = 1.0/GWFrames::InverseConformalFactorGrid(v, n_theta, n_phi);
+  ethdeltaKoverK_g = BoostedGrid(Modes(DataGrid(delta,n_theta,n_phi)*K).edth())*oneoverK_g;
+  return *this;
+}
+
+/// Evaluate Modes on the boosted grid, as with DataGrid(M, v, n_theta, n_phi)
+DataGrid GWFrames::BMSTransformationContext::BoostedGrid(const Modes& M) const {
+  const int NModes = (ellMax+1)*(ellMax+1);
+  if(M.Spin()<-2 || M.Spin()>2 || M.EllMax()>ellMax || int(M.size())>NModes) {
+    // We don't have the SWSHs for these modes, so fall back on the general approach
+    return DataGrid(M, v, n_theta, n_phi);
+  }
+  if(M.size()==0) {
+    return DataGrid(M.Spin(), n_theta, n_phi, vector<complex<double> >(n_theta*n_phi));
+  }
+  return BoostedGrid(M.Spin(), M.data.size(), &M.data[0]);
+}
+
+/// Evaluate modes stored elsewhere on the boosted grid
+DataGrid GWFrames::BMSTransformationContext::BoostedGrid(const int Spin, const unsigned int NM, const std::complex<double>* M) const {
+  /// \param Spin Spin weight of the data
+  /// \param NM Number of modes in the data
+  /// \param M Array of the modes, in the order of `Modes`
+  ///
+  /// This allows data held in a `ModesTensor` to be used without
+  /// first copying it into a `Modes` object.
+  const int n_g = n_theta*n_phi;
+  const int NModes = (ellMax+1)*(ellMax+1);
+  if(Spin<-2 || Spin>2 || int(NM)>NModes) {
+    // We don't have the SWSHs for these modes, so fall back on the general approach
+    return DataGrid(Modes(Spin, vector<complex<double> >(M, M+NM)), v, n_theta, n_phi);
+  }
+  const vector<complex<double> >& Y = SWSHs[Spin+2];
+  DataGrid D(n_g);
+  D.SetSpin(Spin).SetNTheta(n_theta).SetNPhi(n_phi);
+  for(int i_g=0; i_g<n_g; ++i_g) {
+    const complex<double>* Y_g = &Y[i_g*NModes];
+    complex<double> d(0.0, 0.0);
+    for(unsigned int i_m=0; i_m<NM; ++i_m) {
+      d += M[i_m]*Y_g[i_m];
+    }
+    D[i_g] = d;
+  }
+  return D;
+}
+
+/// Evaluate many sets of modes stored elsewhere on the boosted grid at once
+void GWFrames::BMSTransformationContext::BoostedGrids(const std::vector<int>& Spins, const unsigned int NM,
+                                                      const std::vector<const std::complex<double>*>& M,
+                                                      std::vector<DataGrid>& Grids) const {
+  /// \param Spins Spin weight of each data set
+  /// \param NM Number of modes in every data set
+  /// \param M Array of the modes of each data set, in the order of `Modes`
+  /// \param Grids Output; one grid for each data set
+  ///
+  /// This gives the same results as calling `BoostedGrid` on each
+  /// data set, but the SWSHs at each grid point are read just once
+  /// for all the data sets, rather than streaming the whole table
+  /// through the cache once per data set.  When compiled with
+  /// OpenMP, the grid points are distributed over threads.
+  if(Spins.size()!=M.size()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: Spins.size()=" << Spins.size() << " != M.size()=" << M.size() << "\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  const int NSets = M.size();
+  const int n_g = n_theta*n_phi;
+  const int NModes = (ellMax+1)*(ellMax+1);
+  Grids.resize(NSets);
+  bool Supported = (int(NM)<=NModes);
+  for(int i_s=0; i_s<NSets; ++i_s) {
+    if(Spins[i_s]<-2 || Spins[i_s]>2) { Supported = false; }
+  }
+  if(!Supported) {
+    // We don't have the SWSHs for some of these modes, so fall back on the general approach
+    for(int i_s=0; i_s<NSets; ++i_s) {
+      Grids[i_s] = BoostedGrid(Spins[i_s], NM, M[i_s]);
+    }
+    return;
+  }
+  for(int i_s=0; i_s<NSets; ++i_s) {
+    Grids[i_s] = DataGrid(n_g);
+    Grids[i_s].SetSpin(Spins[i_s]).SetNTheta(n_theta).SetNPhi(n_phi);
+  }
+  #pragma omp parallel for schedule(static) if(n_g>1) num_threads(GWFrames::MaxThreads())
+  for(int i_g=0; i_g<n_g; ++i_g) {
+    for(int i_s=0; i_s<NSets; ++i_s) {
+      const complex<double>* Y_g = &SWSHs[Spins[i_s]+2][i_g*NModes];
+      const complex<double>* M_s = M[i_s];
+      complex<double> d(0.0, 0.0);
+      for(unsigned int i_m=0; i_m<NM; ++i_m) {
+        d += M_s[i_m]*Y_g[i_m];
+      }
+      Grids[i_s][i_g] = d;
+    }
+  }
+}
+
+/// Transform the data on a slice, as in SliceModes::BMSTransformationOnSlice
+GWFrames::SliceGrid GWFrames::BMSTransformationContext::TransformSlice(const double u, const SliceModes& S) const {
+  /// \param u Time of this slice
+  /// \param S Slice to be transformed
+  ///
+  /// This function does not use any shared mutable state, so it may
+  /// be called on different slices simultaneously.
+
+  // Evaluate the slice's data on the boosted (and appropriately spin-transformed) grid
+  SliceGrid Grids;
+  for(int i_D=0; i_D<7; ++i_D) {
+    Grids[i_D] = BoostedGrid(S[i_D]);
+  }
+  TransformBoostedGrids(u, Grids);
+  return Grids;
+}
+
+/// Transform the data at one time in a tensor of psi0, ..., psi4, sigma, sigmadot
+GWFrames::SliceGrid GWFrames::BMSTransformationContext::TransformSlice(const double u, const ModesTensor& T, const unsigned int i_t) const {
+  /// \param u Time of this slice
+  /// \param T Tensor holding the slices, as in `Scri`
+  /// \param i_t Index of the slice to be transformed
+  ///
+  /// This is equivalent to `TransformSlice(u, SliceModes(T, i_t))`,
+  /// but reads the modes directly from the tensor.
+  if(T.NFields()!=7) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: T.NFields()=" << T.NFields() << " != 7\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
   SliceGrid Grids;
-  Grids.psi4 = oneoverKcubed_g*(psi4_g);
-  Grids.psi3 = oneoverKcubed_g*(psi3_g - ethupok_g*psi4_g);
-  Grids.psi2 = oneoverKcubed_g*(psi2_g - ethupok_g*(2*psi3_g - ethupok_g*psi4_g));
-  Grids.psi1 = oneoverKcubed_g*(psi1_g - ethupok_g*(3*psi2_g - ethupok_g*(3*psi3_g - ethupok_g*psi4_g)));
-  Grids.psi0 = oneoverKcubed_g*(psi0_g - ethupok_g*(4*psi1_g - ethupok_g*(6*psi2_g - ethupok_g*(4*psi3_g - ethupok_g*psi4_g))));
-  Grids.sigma = oneoverK_g*(sigma_g - ethethdelta_g);
-  Grids.sigmadot = sigmadot_g*(oneoverK_g.pow(2));
+  for(int i_D=0; i_D<7; ++i_D) {
+    Grids[i_D] = BoostedGrid(T.Spin(i_D), T.NModes(), T.ModeData(i_D, i_t));
+  }
+  TransformBoostedGrids(u, Grids);
+  return Grids;
+}
+
+#ifndef DOXYGEN
+namespace {
+  // Make sure that T has NFields fields and the slices [i_t_a,i_t_a+NSlices)
+  void CheckSlices(const GWFrames::ModesTensor& T, const int NFields, const unsigned int i_t_a, const unsigned int NSlices) {
+    if(T.NFields()!=NFields) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: T.NFields()=" << T.NFields() << " != " << NFields << "\n"
+                << std::endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    if(i_t_a+NSlices>(unsigned int)(T.NTimes())) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: i_t_a=" << i_t_a << " + NSlices=" << NSlices << " > T.NTimes()=" << T.NTimes() << "\n"
+                << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+  }
+
+  // Make sure that there is at least one slice to interpolate, and
+  // that Weights has NSlices values for each of n_g grid points
+  void CheckWeights(const std::vector<double>& Weights, const int n_g, const unsigned int NSlices) {
+    if(NSlices==0) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: There are no slices to interpolate.\n"
+                << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+    if(Weights.size()!=std::size_t(n_g)*NSlices) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: Weights.size()=" << Weights.size() << " != n_g*NSlices=" << std::size_t(n_g)*NSlices << "\n"
+                << std::endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+}
+#endif // DOXYGEN
+
+/// Transform the data at a series of consecutive times in a tensor of psi0, ..., psi4, sigma, sigmadot
+std::vector<GWFrames::SliceGrid> GWFrames::BMSTransformationContext::TransformSlices(const std::vector<double>& u, const ModesTensor& T,
+                                                                                     const unsigned int i_t_a) const {
+  /// \param u Time of each slice
+  /// \param T Tensor holding the slices, as in `Scri`
+  /// \param i_t_a Index of the slice at time u[0]; the others follow consecutively
+  ///
+  /// This is equivalent to calling `TransformSlice(u[i], T, i_t_a+i)`
+  /// for each i, but all the slices are evaluated on the boosted grid
+  /// together with `BoostedGrids`.
+  GWFrames_INSTRUMENT("BMSTransformationContext::TransformSlices");
+  const unsigned int NSlices = u.size();
+  CheckSlices(T, 7, i_t_a, NSlices);
+
+  // Evaluate every field of every slice on the boosted grid
+  vector<int> Spins(7*NSlices);
+  vector<const complex<double>*> M(7*NSlices);
+  for(unsigned int i_s=0; i_s<NSlices; ++i_s) {
+    for(int i_D=0; i_D<7; ++i_D) {
+      Spins[7*i_s+i_D] = T.Spin(i_D);
+      M[7*i_s+i_D] = T.ModeData(i_D, i_t_a+i_s);
+    }
+  }
+  vector<DataGrid> Boosted;
+  BoostedGrids(Spins, T.NModes(), M, Boosted);
+
+  // Apply the tetrad formulas to each slice
+  vector<SliceGrid> Grids(NSlices);
+  #pragma omp parallel if(NSlices>1) num_threads(GWFrames::MaxThreads())
+  {
+    GWFrames::ScriArena ThreadArena;
+    #pragma omp for schedule(static)
+    for(int i_s=0; i_s<int(NSlices); ++i_s) {
+      for(int i_D=0; i_D<7; ++i_D) {
+        Grids[i_s][i_D].swap(Boosted[7*i_s+i_D]);
+      }
+      TransformBoostedGrids(u[i_s], Grids[i_s]);
+    }
+  }
+  return Grids;
+}
+
+/// Transform consecutive slices of a tensor of psi0, ..., psi4, sigma, sigmadot, and interpolate them in time
+GWFrames::SliceGrid GWFrames::BMSTransformationContext::TransformAndInterpolate(const std::vector<double>& u, const ModesTensor& T,
+                                                                                const unsigned int i_t_a,
+                                                                                const std::vector<double>& Weights) const {
+  /// \param u Time of each slice
+  /// \param T Tensor holding the slices, as in `Scri`
+  /// \param i_t_a Index of the slice at time u[0]; the others follow consecutively
+  /// \param Weights Interpolation weights, u.size() values for each grid point in turn
+  ///
+  /// The value at grid point i_g is the sum over slices i_s of
+  /// `Weights[i_g*u.size()+i_s]` times the value of
+  /// `TransformSlices(u, T, i_t_a)[i_s]` there.
+  GWFrames_INSTRUMENT("BMSTransformationContext::TransformAndInterpolate");
+  const unsigned int NSlices = u.size();
+  const int n_g = n_theta*n_phi;
+  CheckSlices(T, 7, i_t_a, NSlices);
+  CheckWeights(Weights, n_g, NSlices);
+  SliceGrid Grids(n_g);
+  for(int i_D=0; i_D<7; ++i_D) {
+    Grids[i_D].SetSpin(T.Spin(i_D)).SetNTheta(n_theta).SetNPhi(n_phi);
+  }
 
+  const vector<SliceGrid> transformedslices = TransformSlices(u, T, i_t_a);
+  // Gather the data as contiguous arrays, slice-major within each data type
+  vector<const complex<double>*> In(7*NSlices);
+  vector<complex<double>*> Out(7);
+  for(int i_D=0; i_D<7; ++i_D) {
+    Out[i_D] = &Grids[i_D][0];
+    for(unsigned int i_s=0; i_s<NSlices; ++i_s) {
+      In[i_D*NSlices+i_s] = &transformedslices[i_s][i_D][0];
+    }
+  }
+  #pragma omp parallel for schedule(static) if(n_g>1) num_threads(GWFrames::MaxThreads())
+  for(int i_g=0; i_g<n_g; ++i_g) {
+    const double* w = &Weights[std::size_t(i_g)*NSlices];
+    for(int i_D=0; i_D<7; ++i_D) { // Loop over data types
+      const complex<double>* const* In_D = &In[i_D*NSlices];
+      complex<double> value(0.0, 0.0);
+      for(unsigned int i_s=0; i_s<NSlices; ++i_s) {
+        value += w[i_s]*In_D[i_s][i_g];
+      }
+      Out[i_D][i_g] = value;
+    }
+  }
   return Grids;
 }
 
+/// Evaluate consecutive slices of one field on the boosted grid, rescale them, and interpolate them in time
+DataGrid GWFrames::BMSTransformationContext::BoostAndInterpolate(const ModesTensor& T, const unsigned int i_field,
+                                                                 const unsigned int i_t_a, const unsigned int NSlices,
+                                                                 const std::vector<double>& Weights) const {
+  /// \param T Tensor holding the slices
+  /// \param i_field Field of T to use
+  /// \param i_t_a Index of the first slice; the others follow consecutively
+  /// \param NSlices Number of slices
+  /// \param Weights Interpolation weights, NSlices values for each grid point in turn
+  ///
+  /// The value at grid point i_g is the sum over slices i_s of
+  /// `Weights[i_g*NSlices+i_s]` times `BoostedGrid(slice i_s)` there,
+  /// which is the form of `SuperMomenta::BMSTransform`.
+  GWFrames_INSTRUMENT("BMSTransformationContext::BoostAndInterpolate");
+  const int n_g = n_theta*n_phi;
+  if(i_field>=(unsigned int)(T.NFields())) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: i_field=" << i_field << " >= T.NFields()=" << T.NFields() << "\n"
+              << std::endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  CheckSlices(T, T.NFields(), i_t_a, NSlices);
+  CheckWeights(Weights, n_g, NSlices);
+  DataGrid Grid(n_g);
+  Grid.SetSpin(T.Spin(i_field)).SetNTheta(n_theta).SetNPhi(n_phi);
+
+  vector<DataGrid> transformedslices;
+  {
+    vector<int> Spins(NSlices, T.Spin(i_field));
+    vector<const complex<double>*> M(NSlices);
+    for(unsigned int i_s=0; i_s<NSlices; ++i_s) {
+      M[i_s] = T.ModeData(i_field, i_t_a+i_s);
+    }
+    BoostedGrids(Spins, T.NModes(), M, transformedslices);
+  }
+  #pragma omp parallel for schedule(static) if(n_g>1) num_threads(GWFrames::MaxThreads())
+  for(int i_g=0; i_g<n_g; ++i_g) {
+    const double* w = &Weights[std::size_t(i_g)*NSlices];
+    complex<double> value(0.0, 0.0);
+    for(unsigned int i_s=0; i_s<NSlices; ++i_s) {
+      value += w[i_s]*transformedslices[i_s][i_g];
+    }
+    Grid[i_g] = value;
+  }
+  return Grid;
+}
+
+/// Account for the change of tetrad, given the slice's data on the boosted grid
+void GWFrames::BMSTransformationContext::TransformBoostedGrids(const double u, SliceGrid& Grids) const {
+  /// \param u Time of this slice
+  /// \param Grids On input, the slice's data on the boosted grid; on output, the transformed data
+  ///
+  /// The tetrad formulas are evaluated in a single pass over the
+  /// grid, in place, so no intermediate grids are allocated.
+  const int n_g = n_theta*n_phi;
+  for(int i_D=0; i_D<7; ++i_D) {
+    if(Grids[i_D].N_theta()!=n_theta || Grids[i_D].N_phi()!=n_phi) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                << "\nError: Grids[" << i_D << "] has size " << Grids[i_D].N_theta() << "x" << Grids[i_D].N_phi()
+                << "; expected " << n_theta << "x" << n_phi << "\n"
+                << std::endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+  complex<double>* psi0 = &Grids.psi0[0];
+  complex<double>* psi1 = &Grids.psi1[0];
+  complex<double>* psi2 = &Grids.psi2[0];
+  complex<double>* psi3 = &Grids.psi3[0];
+  complex<double>* psi4 = &Grids.psi4[0];
+  complex<double>* sigma = &Grids.sigma[0];
+  complex<double>* sigmadot = &Grids.sigmadot[0];
+  const complex<double>* oneoverK = &oneoverK_g[0];
+  const complex<double>* oneoverKsquared = &oneoverKsquared_g[0];
+  const complex<double>* oneoverKcubed = &oneoverKcubed_g[0];
+  const complex<double>* ethethdelta = &ethethdelta_g[0];
+  const complex<double>* ethKoverK = &ethKoverK_g[0];
+  const complex<double>* ethdeltaKoverK = &ethdeltaKoverK_g[0];
+  for(int i_g=0; i_g<n_g; ++i_g) {
+    const complex<double> ethupok = u*ethKoverK[i_g] - ethdeltaKoverK[i_g]; // (\eth u') / K
+    const complex<double> p0 = psi0[i_g], p1 = psi1[i_g], p2 = psi2[i_g], p3 = psi3[i_g], p4 = psi4[i_g];
+    const complex<double> K3 = oneoverKcubed[i_g];
+    psi4[i_g] = K3*(p4);
+    psi3[i_g] = K3*(p3 - ethupok*p4);
+    psi2[i_g] = K3*(p2 - ethupok*(2.0*p3 - ethupok*p4));
+    psi1[i_g] = K3*(p1 - ethupok*(3.0*p2 - ethupok*(3.0*p3 - ethupok*p4)));
+    psi0[i_g] = K3*(p0 - ethupok*(4.0*p1 - ethupok*(6.0*p2 - ethupok*(4.0*p3 - ethupok*p4))));
+    sigma[i_g] = oneoverK[i_g]*(sigma[i_g] - ethethdelta[i_g]);
+    sigmadot[i_g] *= oneoverKsquared[i_g];
+  }
+}
+
 /// Find the next iteration of the BMS transformation via Moreschi's algorithm
 void SliceModes::MoreschiIteration(GWFrames::Modes& OneOverK_ip1, GWFrames::Modes& delta_ip1) const {
-  /// \param OneOverK_ip1 Inverse conformal factor for the next step
-  /// \param delta_ip1 Supertranslation for the next step
+  /// \param OneOverK_ip1 Inverse conformal factor (input/output)
+  /// \param delta_ip1 Supertranslation (input/output)
   ///
   /// This member function applies to a `SliceModes` object that has
   /// already been transformed by the BMS transformation represented
-  /// by \f$K_i\f$ and \f$\delta_i\f$.  This then takes the data on
-  /// that slice and computes the values of \f$K_{i+1}\f$ and
-  /// \f$\delta_{i+1}\f$, returning them by reference.
-
+  /// by \f$K_i\f$ and \f$\delta_i\f$, which are the input values of
+  /// the arguments.  This then takes the data on that slice and
+  /// computes the values of \f$K_{i+1}\f$ and \f$\delta_{i+1}\f$,
+  /// returning them by reference.  Empty inputs are taken to be the
+  /// identity transformation.
+  ///
+  /// Because the supermomentum on this slice already includes the
+  /// transformation, the step is incremental: the four-momentum
+  /// measured here is boosted back to the original frame to give
+  /// \f$K_{i+1}\f$, and the nice-section supertranslation measured
+  /// here is added to the ell>=2 modes of \f$\delta_i\f$.  The
+  /// increment vanishes exactly when this slice is a nice section in
+  /// its rest frame, so the fixed point is the same as that of
+  /// `SuperMomenta::MoreschiIteration`, which works from the
+  /// untransformed data and should be preferred when it is available.
   const Modes Psi = SuperMomentum();
-  const double M = Mass();
-
-  // 1/K is just Psi/M in the first two ell values
-  OneOverK_ip1 = Modes(4);
-  OneOverK_ip1.SetEllMax(1);
-  OneOverK_ip1[0] = Psi[0]/M;
-  OneOverK_ip1[1] = Psi[1]/M;
-  OneOverK_ip1[2] = Psi[2]/M;
-  OneOverK_ip1[3] = Psi[3]/M;
-
-  //
-
-  throw(GWFrames_NotYetImplemented);
+  if(Psi.size()<4) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: Psi.EllMax()=" << Psi.EllMax() << " < 1"
+              << "\n       The four-momentum needs the ell=1 modes.\n"
+              << std::endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  PrepareMoreschiGuess(Psi.EllMax(), OneOverK_ip1, delta_ip1);
+  const FourVector pPrime = FourMomentumFromSuperMomentum(Psi);
+  const ThreeVector v_i = vFromOneOverK(OneOverK_ip1);
+  Modes OneOverKPrime;
+  Modes Delta(0, vector<complex<double> >(delta_ip1.size(), zero));
+  NiceSectionUpdate(Psi, pPrime, OneOverKPrime, Delta);
+  for(unsigned int i_m=4; i_m<delta_ip1.size(); ++i_m) {
+    delta_ip1[i_m] += Delta[i_m];
+  }
+  OneOverK_ip1 = OneOverKFromFourMomentum(BoostToOriginalFrame(v_i, pPrime));
   return;
 }
 
@@ -855,8 +2011,9 @@ template class GWFrames::SliceOfScri<Modes>;
 Scri::Scri(const GWFrames::Waveform& psi0, const GWFrames::Waveform& psi1,
            const GWFrames::Waveform& psi2, const GWFrames::Waveform& psi3,
            const GWFrames::Waveform& psi4, const GWFrames::Waveform& sigma)
-  : t(psi0.T()), slices(t.size(), SliceModes(psi0.EllMax()))
+  : t(psi0.T()), data(7, t.size(), psi0.EllMax())
 {
+  GWFrames_INSTRUMENT("Scri::Scri");
   // Check that everyone has the same NTimes().  This is a poor man's
   // way of making sure we have all the same times, and is of course
   // only necessary, not sufficient proof that the times are the same.
@@ -882,30 +2039,28 @@ Scri::Scri(const GWFrames::Waveform& psi0, const GWFrames::Waveform& psi1,
     throw(GWFrames_VectorSizeMismatch);
   }
 
-  // Fill the new data
-  const unsigned int ntimes = t.size();
-  for(unsigned int i_t=0; i_t<ntimes; ++i_t) { // Fill everything but sigmadot
-    GWFrames::SliceModes& slice = slices[i_t];
-    int i_ellm=0;
-    for(int ell=0; ell<=ellMax; ++ell) {
-      for(int m=-ell; m<=ell; ++m, ++i_ellm) {
-        slice[0][i_ellm] = psi0.Data(psi0.FindModeIndex(ell,m), i_t);
-        slice[1][i_ellm] = psi1.Data(psi1.FindModeIndex(ell,m), i_t);
-        slice[2][i_ellm] = psi2.Data(psi2.FindModeIndex(ell,m), i_t);
-        slice[3][i_ellm] = psi3.Data(psi3.FindModeIndex(ell,m), i_t);
-        slice[4][i_ellm] = psi4.Data(psi4.FindModeIndex(ell,m), i_t);
-        slice[5][i_ellm] = sigma.Data(sigma.FindModeIndex(ell,m), i_t);
-      }
-    }
+  // Fill the new data, with the same spins as SliceModes
+  const int Spins[7] = { 2, 1, 0, -1, -2, 2, 2 };
+  for(int i_D=0; i_D<7; ++i_D) {
+    data.SetSpin(i_D, Spins[i_D]);
   }
-  for(int i_ellm=0, ell=0; ell<=ellMax; ++ell) {
-    for(int m=-ell; m<=ell; ++m, ++i_ellm) {
-      const std::vector<std::complex<double> > sigmadot = sigma.DataDot(sigma.FindModeIndex(ell,m));
-      for(unsigned int i_t=0; i_t<ntimes; ++i_t) { // Fill sigmadot
-        slices[i_t][6][i_ellm] = sigmadot[i_t];
-      }
-    }
+  data.SetField(0, psi0);
+  data.SetField(1, psi1);
+  data.SetField(2, psi2);
+  data.SetField(3, psi3);
+  data.SetField(4, psi4);
+  data.SetField(5, sigma);
+  data.SetFieldDot(6, sigma);
+}
+
+/// Replace the data on one slice
+Scri& Scri::SetSlice(const unsigned int i, const SliceModes& S) {
+  /// \param i Index of the slice
+  /// \param S New data, with the same ellMax as this object
+  for(int i_D=0; i_D<7; ++i_D) {
+    data.SetModes(i_D, i, S[i_D]);
   }
+  return *this;
 }
 
 /// Apply a (constant) BMS transformation to data on null infinity
@@ -943,8 +2098,33 @@ SliceModes Scri::BMSTransformation(const double& u0, const ThreeVector& v, const
   /// arbitrarily set \f$u' = 0\f$, because any other choice can be
   /// absorbed into a time- and space-translation.  This does not
   /// matter, of course, because that choice is not stored in any way.
+  ///
+  /// When transforming several slices with the same `v` and `delta`,
+  /// construct a `BMSTransformationContext` once and use the
+  /// overload taking that object instead.
+  return BMSTransformation(u0, GWFrames::BMSTransformationContext(data.EllMax(), v, delta), delta);
+}
 
-  const int n_theta = 2*slices[0].EllMax()+1;
+/// Apply a (constant) BMS transformation to data on null infinity, using precomputed data for the transformation
+SliceModes Scri::BMSTransformation(const double& u0, const GWFrames::BMSTransformationContext& Context,
+                                   const GWFrames::Modes& delta) const {
+  /// \param u0 Initial time slice to transform
+  /// \param Context Precomputed data for the boost and the supertranslation `delta`
+  /// \param delta Spherical-harmonic modes of the supertranslation
+  ///
+  /// The context must have the same ellMax as this object.  Its
+  /// tables are reused for every slice it is applied to.
+  GWFrames_INSTRUMENT("Scri::BMSTransformation");
+  GWFrames::ScriArena Arena;
+  if(Context.EllMax()!=data.EllMax()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: Context.EllMax()=" << Context.EllMax() << " != EllMax()=" << data.EllMax()
+              << "\n       The context must be constructed for this data.\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+
+  const int n_theta = 2*data.EllMax()+1;
   const int n_phi = n_theta;
 
   // (0) Find current time slices on which we need data to interpolate
@@ -973,54 +2153,30 @@ SliceModes Scri::BMSTransformation(const double& u0, const ThreeVector& v, const
   iMax = std::min(int(t.size())-1, std::max(iMin+7, iMax+3));
 
   // (1) Evaluate BMS-transformed data on equi-angular grids of the final frame at a series of times
+  // (2) Interpolate to new retarded time
+  // Both happen in one call, so that each grid point is interpolated
+  // as soon as its transformed values are found
   const unsigned int Nslices = iMax-iMin+1;
-  vector<SliceGrid> transformedslices(Nslices);
   vector<double> u_original(Nslices);
   for(int i=iMin; i<=iMax; ++i) {
     u_original[i-iMin] = t[i];
-    transformedslices[i-iMin] = slices[i].BMSTransformationOnSlice(t[i], v, delta);
   }
-  const int n_theta2 = transformedslices[0][0].N_theta();
-  const int n_phi2 = transformedslices[0][0].N_phi();
-
-  // (2) Interpolate to new retarded time
-  // Create new object to hold the data
-  SliceGrid BMStransformedGrid(n_theta2*n_phi2);
-  // Initialize the GSL interpolators for the data
-  gsl_interp_accel* accRe = gsl_interp_accel_alloc();
-  gsl_interp_accel* accIm = gsl_interp_accel_alloc();
-  gsl_spline* splineRe = gsl_spline_alloc(gsl_interp_cspline, Nslices);
-  gsl_spline* splineIm = gsl_spline_alloc(gsl_interp_cspline, Nslices);
-  // Loop through, doing the work
-  for(int i_g=0, i_t=0; i_t<n_theta2; ++i_t) { // Loop over theta points
-    for(int i_p=0; i_p<n_phi2; ++i_p, ++i_g) { // Loop over phi points
-      const double u_i = std::real(u[i_g]); // Interpolate the data at this point to u_i (measured in the current frame)
-      for(int i_D=0; i_D<7; ++i_D) { // Loop over data types
-        // Fill the storage vectors for extrapolation
-        vector<double> re(Nslices);
-        vector<double> im(Nslices);
-        for(unsigned int i_s=0; i_s<Nslices; ++i_s) {
-          re[i_s] = std::real(transformedslices[i_s][i_D][i_g]);
-          im[i_s] = std::imag(transformedslices[i_s][i_D][i_g]);
-        }
-        // Initialize the interpolators for this data set
-        gsl_spline_init(splineRe, &(u_original)[0], &re[0], Nslices);
-        gsl_spline_init(splineIm, &(u_original)[0], &im[0], Nslices);
-        // Extrapolate real and imaginary parts and store data
-        BMStransformedGrid[i_D][i_g] = complex<double>( gsl_spline_eval(splineRe, u_i, accRe), gsl_spline_eval(splineIm, u_i, accIm) );
-      }
-    }
+  // The knots are the same at every point, so the spline is factored
+  // just once, and each point needs only its weights for u_i
+  const vector<double> Weights = SplineWeightsOnGrid(NaturalSplineWeights(u_original), Nslices, u);
+  SliceGrid BMStransformedGrid;
+  {
+    GWFrames_INSTRUMENT("Scri::BMSTransformation: transform slices and interpolate in time");
+    BMStransformedGrid = Context.TransformAndInterpolate(u_original, data, iMin, Weights);
   }
-  // Free the interpolators
-  gsl_interp_accel_free(accRe);
-  gsl_interp_accel_free(accIm);
-  gsl_spline_free(splineRe);
-  gsl_spline_free(splineIm);
 
   // (3) Transform back to spectral space
-  SliceModes BMStransformed(slices[0].EllMax());
-  for(int i_D=0; i_D<7; ++i_D) { // Loop over data types
-    BMStransformed[i_D] = Modes(BMStransformedGrid[i_D]);
+  SliceModes BMStransformed(data.EllMax());
+  {
+    GWFrames_INSTRUMENT("Scri::BMSTransformation: transform to modes");
+    for(int i_D=0; i_D<7; ++i_D) { // Loop over data types
+      BMStransformed[i_D] = Modes(BMStransformedGrid[i_D]);
+    }
   }
 
   return BMStransformed;
@@ -1029,20 +2185,73 @@ SliceModes Scri::BMSTransformation(const double& u0, const ThreeVector& v, const
 
 
 
+GWFrames::SuperMomenta::SuperMomenta(const std::vector<double>& T, const std::vector<Modes>& psi)
+  : t(T), Psi(1, psi.size(), (psi.size()>0 ? psi[0].EllMax() : 0))
+{
+  for(unsigned int i_t=0; i_t<psi.size(); ++i_t) {
+    Psi.SetModes(0, i_t, psi[i_t]);
+  }
+}
+
+#ifndef DOXYGEN
+namespace {
+  // The supermomentum involves products of the fields, which have
+  // twice the ellMax of the fields themselves
+  int SuperMomentumEllMax(const Scri& scri) {
+    if(scri.NTimes()==0) { return 2*scri.EllMax(); }
+    GWFrames::ScriArena Arena;
+    return scri[0].SuperMomentum().EllMax();
+  }
+}
+#endif // DOXYGEN
+
 GWFrames::SuperMomenta::SuperMomenta(const Scri& scri)
-  : t(scri.T()), Psi(scri.NTimes())
+  : t(scri.T()), Psi(1, scri.NTimes(), SuperMomentumEllMax(scri))
 {
+  /// The supermomentum at each time is `scri[i].SuperMomentum()`,
+  /// which is stored with all of its modes, so `EllMax()` is twice
+  /// that of `scri`.
+  GWFrames::ScriArena Arena;
   const unsigned int NTimes = scri.NTimes();
   for(unsigned int i_t=0; i_t<NTimes; ++i_t) {
-    Psi[i_t] = scri[i_t].SuperMomentum();
+    Psi.SetModes(0, i_t, scri[i_t].SuperMomentum());
   }
 }
 
 /// Return value of Psi on u'=const slice centered at delta[0]
 GWFrames::Modes GWFrames::SuperMomenta::BMSTransform(const GWFrames::Modes& OneOverK, const GWFrames::Modes& delta) const {
-  const int n_theta = 2*Psi[0].EllMax()+1;
+  /// When transforming repeatedly with the same `OneOverK`,
+  /// construct a `BMSTransformationContext` once and use the overload
+  /// taking that object instead.
+  return BMSTransform(GWFrames::BMSTransformationContext(Psi.EllMax(), GWFrames::vFromOneOverK(OneOverK)), OneOverK, delta);
+}
+
+/// Return value of Psi on u'=const slice centered at delta[0], using precomputed data for the transformation
+GWFrames::Modes GWFrames::SuperMomenta::BMSTransform(const GWFrames::BMSTransformationContext& Context,
+                                                     const GWFrames::Modes& OneOverK, const GWFrames::Modes& delta) const {
+  /// \param Context Precomputed data for the boost `vFromOneOverK(OneOverK)`
+  /// \param OneOverK Inverse conformal factor
+  /// \param delta Supertranslation
+  ///
+  /// The context must have the same ellMax as this object.  Only the
+  /// parts of it that depend on the boost are used, so its
+  /// supertranslation need not be `delta`, and one context serves
+  /// any number of supertranslations.  As in the original version,
+  /// each slice is multiplied by \f$K^{-3}\f$ in mode space, and
+  /// truncated to the larger ellMax of the factors; only the
+  /// evaluation of those products on the boosted grid uses the
+  /// context's tables.
+  GWFrames_INSTRUMENT("SuperMomenta::BMSTransform");
+  GWFrames::ScriArena Arena;
+  if(Context.EllMax()!=Psi.EllMax()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: Context.EllMax()=" << Context.EllMax() << " != EllMax()=" << Psi.EllMax()
+              << "\n       The context must be constructed for this data.\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  const int n_theta = 2*Psi.EllMax()+1;
   const int n_phi = n_theta;
-  const ThreeVector v = GWFrames::vFromOneOverK(OneOverK);
 
   // (0) Find current time slices on which we need data to interpolate
   ////////////////////////////////////////////////////////////////////
@@ -1072,98 +2281,207 @@ GWFrames::Modes GWFrames::SuperMomenta::BMSTransform(const GWFrames::Modes& OneO
   // (1) Evaluate BMS-transformed data on equi-angular grids of the final frame at a series of times
   //////////////////////////////////////////////////////////////////////////////////////////////////
   const unsigned int Nslices = iMax-iMin+1;
-  vector<DataGrid> transformedslices(Nslices);
   vector<double> u_original(Nslices);
+  const Modes ethbar2eth2delta = delta.edth2edthbar2();
+  const Modes OneOverKcubed = OneOverK.pow(3);
+  ModesTensor transformedslices;
   for(int i=iMin; i<=iMax; ++i) {
     u_original[i-iMin] = t[i];
-    transformedslices[i-iMin] = DataGrid((Psi[i] - delta.edth2edthbar2())*OneOverK.pow(3), v, n_theta, n_phi);
+    const Modes transformedslice = (Psi.GetModes(0, i) - ethbar2eth2delta)*OneOverKcubed;
+    if(i==iMin) { transformedslices = ModesTensor(1, Nslices, transformedslice.EllMax()); }
+    transformedslices.SetModes(0, i-iMin, transformedslice);
   }
-  const int n_theta2 = transformedslices[0].N_theta();
-  const int n_phi2 = transformedslices[0].N_phi();
 
   // (2) Interpolate to new retarded time
   ///////////////////////////////////////
-  // Create new object to hold the data
-  DataGrid BMStransformedGrid(n_theta2*n_phi2);
-  // Initialize the GSL interpolators for the data
-  gsl_interp_accel* accRe = gsl_interp_accel_alloc();
-  gsl_interp_accel* accIm = gsl_interp_accel_alloc();
-  gsl_spline* splineRe = gsl_spline_alloc(gsl_interp_cspline, Nslices);
-  gsl_spline* splineIm = gsl_spline_alloc(gsl_interp_cspline, Nslices);
-  // Loop through, doing the work
-  for(int i_g=0, i_t=0; i_t<n_theta2; ++i_t) { // Loop over theta points
-    for(int i_p=0; i_p<n_phi2; ++i_p, ++i_g) { // Loop over phi points
-      const double u_i = std::real(u[i_g]); // Interpolate the data at this point to u_i (measured in the current frame)
-      // Fill the storage vectors for extrapolation
-      vector<double> re(Nslices);
-      vector<double> im(Nslices);
-      for(unsigned int i_s=0; i_s<Nslices; ++i_s) {
-        re[i_s] = std::real(transformedslices[i_s][i_g]);
-        im[i_s] = std::imag(transformedslices[i_s][i_g]);
-      }
-      // Initialize the interpolators for this data set
-      gsl_spline_init(splineRe, &(u_original)[0], &re[0], Nslices);
-      gsl_spline_init(splineIm, &(u_original)[0], &im[0], Nslices);
-      // Extrapolate real and imaginary parts and store data
-      BMStransformedGrid[i_g] = complex<double>( gsl_spline_eval(splineRe, u_i, accRe), gsl_spline_eval(splineIm, u_i, accIm) );
-    }
-  }
-  // Free the interpolators
-  gsl_interp_accel_free(accRe);
-  gsl_interp_accel_free(accIm);
-  gsl_spline_free(splineRe);
-  gsl_spline_free(splineIm);
+  // This happens in the same call as step (1).  The knots are the
+  // same at every point, so factor the spline once.
+  const vector<double> Weights = SplineWeightsOnGrid(NaturalSplineWeights(u_original), Nslices, u);
+  const DataGrid BMStransformedGrid = Context.BoostAndInterpolate(transformedslices, 0, 0, Nslices, Weights);
 
   // (3) Transform back to spectral space
   ///////////////////////////////////////
   return Modes(BMStransformedGrid);
 }
 
+/// Return value of Psi of this frame on the section u=delta(x)
+GWFrames::Modes GWFrames::SuperMomenta::SuperMomentumOnSection(const GWFrames::Modes& delta) const {
+  /// \param delta Supertranslation giving the section
+  ///
+  /// When evaluating on many sections, construct an identity-boost
+  /// context `BMSTransformationContext(EllMax(), ThreeVector(3, 0.0))`
+  /// once and use the overload taking that object instead.
+  return SuperMomentumOnSection(GWFrames::BMSTransformationContext(Psi.EllMax(), GWFrames::ThreeVector(3, 0.0)), delta);
+}
+
+/// Return value of Psi of this frame on the section u=delta(x), using a precomputed identity boost
+GWFrames::Modes GWFrames::SuperMomenta::SuperMomentumOnSection(const GWFrames::BMSTransformationContext& Identity,
+                                                               const GWFrames::Modes& delta) const {
+  /// \param Identity Context for the identity boost, with the same ellMax as this object
+  /// \param delta Supertranslation giving the section
+  ///
+  /// This is `BMSTransform` with the identity boost, with the
+  /// \f$\eth^2\bar{\eth}^2 \delta\f$ term added back, which is
+  /// exact in modes.  The result is what the Moreschi algorithm
+  /// needs to find the next section.  Only the SWSH tables of the
+  /// context are used, so it need not be updated as delta changes.
+  const ThreeVector& v = Identity.V();
+  if(v.size()!=3 || v[0]!=0.0 || v[1]!=0.0 || v[2]!=0.0) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: The context must be for the identity boost.\n"
+              << std::endl;
+    throw(GWFrames_ValueError);
+  }
+  vector<complex<double> > IdentityModes(4, zero);
+  IdentityModes[0] = sqrt4pi;
+  const Modes OneOverK(0, IdentityModes);
+  return BMSTransform(Identity, OneOverK, delta) + delta.edth2edthbar2();
+}
+
 /// Transform to given slice with given BMS transformation, and return next step in Moreschi algorithm
 void GWFrames::SuperMomenta::MoreschiIteration(GWFrames::Modes& OneOverK, GWFrames::Modes& delta) const {
   /// \param OneOverK Inverse conformal factor (input/output)
   /// \param delta Supertranslation (input/output)
   ///
-  /// This function first transforms Psi to a u'=constant slice
-  /// centered at the value delta[0] with the given BMS transformation.  It
-  /// then replaces the values of that BMS transformation with the
-  /// next step in the Moreschi algorithm.
-
-  // Record the values of the supermomentum, four-momentum, and mass on this slice
-  const Modes Psi_i = BMSTransform(OneOverK, delta);
-  FourVector p(4);
-  p[0] = std::real(Psi_i[0])/sqrt4pi;
-  // The following are divided by 3 relative to what I would naively
-  // expect.  I don't understand why, but this is written into the
-  // definition of the vector l^a, so it must be incorporated each
-  // time that vector appears.
-  p[1] = std::real((Psi_i[1]-Psi_i[3]))/(sqrt3*sqrt8pi);
-  p[2] = -std::real(complexi*(Psi_i[1]+Psi_i[3]))/(sqrt3*sqrt8pi);
-  p[3] = std::real(Psi_i[2])/(sqrt3*sqrt4pi);
-  const double M = std::sqrt(p[0]*p[0]-p[1]*p[1]-p[2]*p[2]-p[3]*p[3]);
-
-  // Increment the values of delta to the next step
-  const int ellMax = delta.EllMax();
-  const Modes deltaderiv = Psi_i + Modes(M/DataGrid(OneOverK, 7, 7).pow(3));
-  for(int i_m=4, ell=2; ell<=ellMax; ++ell) {
-    const double factor = 4.0/((ell-1.0)*(ell)*(ell+1.0)*(ell+2.0));
-    for(int m=-ell; m<=ell; ++m, ++i_m) {
-      delta[i_m] = factor*deltaderiv[i_m];
+  /// This function first evaluates Psi on the section u=delta(x) of
+  /// the original frame.  It then replaces the values of the BMS
+  /// transformation with the next step in the Moreschi algorithm:
+  /// OneOverK is the boost to the rest frame of the four-momentum on
+  /// that section, and the ell>=2 modes of delta solve
+  /// \f$\eth^2\bar{\eth}^2 \delta = \Psi(\delta_i) - M K^3\f$ (with
+  /// the sign of the energy on M).  The input OneOverK is only used
+  /// to fill in missing modes; the ell<2 modes of delta are not
+  /// changed, and delta is given the same ellMax as this object.
+  PrepareMoreschiGuess(Psi.EllMax(), OneOverK, delta);
+  MoreschiUpdate(SuperMomentumOnSection(delta), OneOverK, delta);
+  return;
+}
+
+/// Iterate Moreschi's algorithm to convergence on one slice
+int GWFrames::SuperMomenta::MoreschiSolve(GWFrames::Modes& OneOverK, GWFrames::Modes& delta,
+                                          const double Tolerance, const int MaxIterations) const {
+  /// \param OneOverK Inverse conformal factor (initial guess on input, solution on output)
+  /// \param delta Supertranslation (initial guess on input, solution on output)
+  /// \param Tolerance Largest relative change in the final iteration
+  /// \param MaxIterations Largest number of iterations to take
+  ///
+  /// The slice is the u'=0 slice centered at delta[0]; the ell<2
+  /// modes of delta (the translation) are held fixed, while the
+  /// others and OneOverK are found by `MoreschiIteration`.  The
+  /// iteration stops when the L^2 norm of the change in OneOverK
+  /// and the ell>=2 modes of delta, which is computed directly from
+  /// the modes, is at most `Tolerance` times the norm of those
+  /// modes.  The return value is the number of iterations taken, or
+  /// -1 if the iteration did not converge within `MaxIterations`.
+  ///
+  /// The SWSH tables needed to evaluate the supermomentum on each
+  /// section are found once, and reused by every iteration.
+  GWFrames_INSTRUMENT("SuperMomenta::MoreschiSolve");
+  CheckMoreschiEllMax(Psi.EllMax());
+  GWFrames::ScriArena Arena;
+  return MoreschiSolve(GWFrames::BMSTransformationContext(Psi.EllMax(), GWFrames::ThreeVector(3, 0.0)),
+                       OneOverK, delta, Tolerance, MaxIterations);
+}
+
+/// Iterate Moreschi's algorithm to convergence on one slice, using a precomputed identity boost
+int GWFrames::SuperMomenta::MoreschiSolve(const GWFrames::BMSTransformationContext& Identity,
+                                          GWFrames::Modes& OneOverK, GWFrames::Modes& delta,
+                                          const double Tolerance, const int MaxIterations) const {
+  GWFrames::ScriArena Arena;
+  PrepareMoreschiGuess(Psi.EllMax(), OneOverK, delta);
+  for(int i_iteration=1; i_iteration<=MaxIterations; ++i_iteration) {
+    const Modes OneOverK_i(OneOverK);
+    const Modes delta_i(delta);
+    MoreschiUpdate(SuperMomentumOnSection(Identity, delta), OneOverK, delta);
+    double ChangeSquared = 0.0;
+    double NormSquared = 0.0;
+    AccumulateModeChange(OneOverK, OneOverK_i, 0, OneOverK.size(), ChangeSquared, NormSquared);
+    AccumulateModeChange(delta, delta_i, 4, delta.size(), ChangeSquared, NormSquared);
+    if(ChangeSquared<=Tolerance*Tolerance*NormSquared) {
+      return i_iteration;
     }
   }
+  return -1;
+}
 
-  // Increment the values of OneOverK to the next step
-  OneOverK[0] = Psi_i[0]/M;
-  // The following are divided by 3 relative to what I would naively
-  // expect.  I don't understand why, but this is written into the
-  // definition of the vector l^a, so it must be incorporated each
-  // time that vector appears.
-  //
-  // Also note that I reverse the signs of the following, so that the
-  // boost will be cancelled out next time, rather than just reported.
-  OneOverK[1] = -Psi_i[1]/(3*M);
-  OneOverK[2] = -Psi_i[2]/(3*M);
-  OneOverK[3] = -Psi_i[3]/(3*M);
+/// Iterate Moreschi's algorithm to convergence on a series of slices
+std::vector<int> GWFrames::SuperMomenta::MoreschiSolve(const std::vector<double>& u,
+                                                       std::vector<GWFrames::Modes>& OneOverK, std::vector<GWFrames::Modes>& delta,
+                                                       const double Tolerance, const int MaxIterations) const {
+  /// \param u Times at the centers of the slices, preferably in order
+  /// \param OneOverK Inverse conformal factors (initial guess on input, solutions on output)
+  /// \param delta Supertranslations (initial guess on input, solutions on output)
+  /// \param Tolerance As in the single-slice `MoreschiSolve`
+  /// \param MaxIterations As in the single-slice `MoreschiSolve`
+  ///
+  /// On input, `OneOverK` and `delta` may each be empty (meaning the
+  /// identity transformation) or hold a single initial guess; on
+  /// output, they hold the solution for each element of `u`.  The
+  /// ell=0 mode of each supertranslation is set to place the slice
+  /// at u; the ell=1 modes are taken from the initial guess.
+  ///
+  /// Nearby slices have nearly the same solution, so each slice
+  /// starts from the solution of the previous one, which usually
+  /// needs only a few iterations.  When compiled with OpenMP, `u` is
+  /// split into one contiguous run of slices per thread, each of
+  /// which starts from the initial guess.  A slice that does not
+  /// converge is reported as -1 in the returned vector of iteration
+  /// counts, and the next slice starts from the initial guess again.
+  GWFrames_INSTRUMENT("SuperMomenta::MoreschiSolve(u)");
+  if(OneOverK.size()>1 || delta.size()>1) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+              << "\nError: OneOverK.size()=" << OneOverK.size() << "  delta.size()=" << delta.size()
+              << "\n       Only a single initial guess may be given.\n"
+              << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  CheckMoreschiEllMax(Psi.EllMax());
+  Modes OneOverK_0 = (OneOverK.size()>0 ? OneOverK[0] : Modes());
+  Modes delta_0 = (delta.size()>0 ? delta[0] : Modes());
+  PrepareMoreschiGuess(Psi.EllMax(), OneOverK_0, delta_0);
+
+  // The SWSH tables are found once, before any threads are started,
+  // and shared by every slice
+  const GWFrames::BMSTransformationContext Identity(Psi.EllMax(), GWFrames::ThreeVector(3, 0.0));
+
+  const int NSlices = u.size();
+  const int NChunks = std::max(1, std::min(GWFrames::MaxThreads(), NSlices));
+  vector<int> Iterations(NSlices, -1);
+  OneOverK.assign(NSlices, OneOverK_0);
+  delta.assign(NSlices, delta_0);
+
+  // Exceptions may not leave the parallel region, so they are caught
+  // and re-thrown afterwards
+  vector<int> Failed(NChunks, 0);
+  vector<int> Thrown(NChunks, 0);
+  #pragma omp parallel for schedule(dynamic) if(NChunks>1) num_threads(GWFrames::MaxThreads())
+  for(int i_c=0; i_c<NChunks; ++i_c) {
+    GWFrames::ScriArena ThreadArena;
+    Modes OneOverK_i(OneOverK_0);
+    Modes delta_i(delta_0);
+    const int i_a = (std::size_t(NSlices)*i_c)/NChunks;
+    const int i_b = (std::size_t(NSlices)*(i_c+1))/NChunks;
+    try {
+      for(int i=i_a; i<i_b; ++i) {
+        delta_i[0] = sqrt4pi*u[i];
+        Iterations[i] = MoreschiSolve(Identity, OneOverK_i, delta_i, Tolerance, MaxIterations);
+        OneOverK[i] = OneOverK_i;
+        delta[i] = delta_i;
+        if(Iterations[i]<0) {
+          OneOverK_i = OneOverK_0;
+          delta_i = delta_0;
+        }
+      }
+    } catch(int thrown) {
+      Failed[i_c] = 1;
+      Thrown[i_c] = thrown;
+    }
+  }
+  for(int i_c=0; i_c<NChunks; ++i_c) {
+    if(Failed[i_c]) {
+      throw(Thrown[i_c]);
+    }
+  }
 
-  return;
+  return Iterations;
 }
@@ -6,6 +6,8 @@
 
 #include <vector>
 #include <complex>
+#include <new>
+#include <cstddef>
 #include "Utilities.hpp"
 #include "Quaternions.hpp"
 #include "Waveforms.hpp"
@@ -18,10 +20,100 @@ namespace GWFrames {
   // this template; `SliceModes` has some extras
   //
 
+  class ScriArena {
+    /// While an object of this class exists, the storage of `Modes`
+    /// and `DataGrid` objects (and the scratch space of `SHTPlan`)
+    /// allocated or freed on the current thread is recycled through a
+    /// pool of blocks with a few sizes, instead of going to
+    /// malloc/free each time.  The blocks collected by the pool are
+    /// all released when the outermost arena on that thread is
+    /// destroyed; nested arenas simply share the outer one's pool.
+    ///
+    /// This is meant to be created as a local variable at the top of
+    /// an expensive transformation, and at the top of each parallel
+    /// region in it, since every thread has its own pool.  Objects
+    /// may safely outlive the arena they were created in, and may be
+    /// freed on any thread.  The current pool is thread-local, so
+    /// arenas on different threads -- whether those threads come from
+    /// OpenMP or elsewhere -- never share a pool.
+  private:
+    bool owner;
+    ScriArena(const ScriArena&);
+    ScriArena& operator=(const ScriArena&);
+  public:
+    ScriArena();
+    ~ScriArena();
+    static void* Allocate(const std::size_t Bytes);
+    static void Deallocate(void* p, const std::size_t Bytes);
+  }; // class ScriArena
+
+  template <class T>
+  class ScriAllocator {
+    /// Standard allocator drawing from the current `ScriArena`, if there is one
+  public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    template <class U> struct rebind { typedef ScriAllocator<U> other; };
+    ScriAllocator() { }
+    ScriAllocator(const ScriAllocator&) { }
+    template <class U> ScriAllocator(const ScriAllocator<U>&) { }
+    inline pointer address(reference x) const { return &x; }
+    inline const_pointer address(const_reference x) const { return &x; }
+    inline pointer allocate(const size_type n, const void* =0) { return static_cast<pointer>(ScriArena::Allocate(n*sizeof(T))); }
+    inline void deallocate(pointer p, const size_type n) { ScriArena::Deallocate(p, n*sizeof(T)); }
+    inline size_type max_size() const { return std::size_t(-1)/sizeof(T); }
+    inline void construct(pointer p, const T& val) { new(static_cast<void*>(p)) T(val); }
+    inline void destroy(pointer p) { p->~T(); }
+  }; // class ScriAllocator
+  template <class T, class U> inline bool operator==(const ScriAllocator<T>&, const ScriAllocator<U>&) { return true; }
+  template <class T, class U> inline bool operator!=(const ScriAllocator<T>&, const ScriAllocator<U>&) { return false; }
+
+  /// Storage for the data in `Modes` and `DataGrid`
+  typedef std::vector<std::complex<double>, ScriAllocator<std::complex<double> > > ScriStorage;
+
   class Modes; // Forward declaration for DataGrid constructor
   class ScriFunctor { public: virtual double operator()(const Quaternions::Quaternion&) const { return 0.0; } };
   Quaternions::Quaternion Boost(GWFrames::ThreeVector v, GWFrames::ThreeVector n);
 
+  class SHTPlan {
+    /// This object holds everything needed to transform spin-weighted
+    /// data between the `Modes` and `DataGrid` representations for a
+    /// given spin weight, ellMax, and grid size: the Wigner
+    /// \f$d(\pi/2)\f$ matrices for every \f$\ell\f$, the quadrature
+    /// weights, and the FFTW plans.  The algorithm is that of
+    /// spinsfast [Huffenberger & Wandelt, ApJS 189, 255 (2010)].
+    ///
+    /// Plans are obtained from `SHTPlan::Get`, which creates each one
+    /// the first time it is needed and returns the same object
+    /// thereafter; plans are never destroyed.  The transforms are
+    /// const and allocate their own scratch space on each call, so one
+    /// plan may be used by any number of threads at once.
+  private: // Data
+    struct Tables; // Defined in Scri.cpp, to keep FFTW and spinsfast out of this header
+    int s;
+    int ellMax;
+    int n_theta;
+    int n_phi;
+    Tables* tables;
+  private: // Constructors; use SHTPlan::Get
+    SHTPlan(const int Spin, const int EllMax, const int N_theta, const int N_phi);
+    SHTPlan(const SHTPlan&);
+    SHTPlan& operator=(const SHTPlan&);
+  public:
+    static const SHTPlan& Get(const int Spin, const int EllMax, const int N_theta, const int N_phi);
+    inline int Spin() const { return s; }
+    inline int EllMax() const { return ellMax; }
+    inline int N_theta() const { return n_theta; }
+    inline int N_phi() const { return n_phi; }
+    void Forward(const std::complex<double>* Grid, std::complex<double>* ModeData) const;
+    void Backward(const std::complex<double>* ModeData, std::complex<double>* Grid) const;
+  }; // class SHTPlan
+
   class DataGrid {
     /// This object holds complex spin-weighted data on the sphere in
     /// an equi-angular representation.  That is, given integers
@@ -35,18 +127,30 @@ namespace GWFrames {
     int s;
     int n_theta;
     int n_phi;
-    std::vector<std::complex<double> > data;
+    GWFrames::ScriStorage data;
+    friend class Modes;
   public: // Constructors
     DataGrid(const int size=0) : s(0), n_theta(std::sqrt(size)), n_phi(std::sqrt(size)), data(size) { }
     DataGrid(const DataGrid& A) : s(A.s), n_theta(A.n_theta), n_phi(A.n_phi), data(A.data) { }
+    DataGrid& operator=(const DataGrid& B) { s=B.s; n_theta=B.n_theta; n_phi=B.n_phi; data=B.data; return *this; }
+    #ifdef GWFrames_MoveSemantics
+    DataGrid(DataGrid&& A) : s(A.s), n_theta(A.n_theta), n_phi(A.n_phi), data(std::move(A.data)) { }
+    DataGrid& operator=(DataGrid&& B) { s=B.s; n_theta=B.n_theta; n_phi=B.n_phi; data=std::move(B.data); return *this; }
+    #endif
     DataGrid(const int Spin, const int N_theta, const int N_phi, const std::vector<std::complex<double> >& D);
-    explicit DataGrid(Modes M, const int N_theta=0, const int N_phi=0); // Can't be const& because of spinsfast design
+    explicit DataGrid(const Modes& M, const int N_theta=0, const int N_phi=0);
     DataGrid(const Modes& M, const GWFrames::ThreeVector& v, const int N_theta=0, const int N_phi=0);
     DataGrid(const int Spin, const int N_theta, const int N_phi, const GWFrames::ThreeVector& v, const ScriFunctor& f);
   public: // Modification
     inline DataGrid& SetSpin(const int ess) { s=ess; return *this; }
     inline DataGrid& SetNTheta(const int N_theta) { n_theta=N_theta; return *this; }
     inline DataGrid& SetNPhi(const int N_phi) { n_phi=N_phi; return *this; }
+    inline DataGrid& swap(DataGrid& B) {
+      const int s_B=B.s, n_theta_B=B.n_theta, n_phi_B=B.n_phi;
+      B.s=s; B.n_theta=n_theta; B.n_phi=n_phi; s=s_B; n_theta=n_theta_B; n_phi=n_phi_B;
+      data.swap(B.data);
+      return *this;
+    }
   public: // Access and operators
     inline unsigned int size() const { return data.size(); }
     inline int Spin() const { return s; }
@@ -54,7 +158,12 @@ namespace GWFrames {
     inline int N_phi() const { return n_phi; }
     inline const std::complex<double>& operator[](const unsigned int i) const { return data[i]; }
     inline std::complex<double>& operator[](const unsigned int i) { return data[i]; }
-    inline std::vector<std::complex<double> > Data() const { return data; }
+    inline std::vector<std::complex<double> > Data() const { return std::vector<std::complex<double> >(data.begin(), data.end()); }
+    DataGrid& operator*=(const DataGrid&);
+    DataGrid& operator/=(const DataGrid&);
+    DataGrid& operator+=(const DataGrid&);
+    DataGrid& operator-=(const DataGrid&);
+    DataGrid& operator*=(const double a);
     DataGrid operator*(const DataGrid&) const;
     DataGrid operator/(const DataGrid&) const;
     DataGrid operator+(const DataGrid&) const;
@@ -79,13 +188,19 @@ namespace GWFrames {
   private: // Data
     int s;
     int ellMax;
-    std::vector<std::complex<double> > data;
+    GWFrames::ScriStorage data;
+    friend class DataGrid;
+    friend class BMSTransformationContext;
   public: // Constructors
     Modes(const int size=0): s(0), ellMax(0), data(size) { }
     Modes(const Modes& A) : s(A.s), ellMax(A.ellMax), data(A.data) { }
     Modes(const int spin, const std::vector<std::complex<double> >& Data);
-    explicit Modes(DataGrid D, const int L=-1); // Can't be const& because of spinsfast design
+    explicit Modes(const DataGrid& D, const int L=-1);
     Modes& operator=(const Modes& B);
+    #ifdef GWFrames_MoveSemantics
+    Modes(Modes&& A) : s(A.s), ellMax(A.ellMax), data(std::move(A.data)) { }
+    Modes& operator=(Modes&& B) { s=B.s; ellMax=B.ellMax; data=std::move(B.data); return *this; }
+    #endif
   public: // Modification
     inline Modes& SetSpin(const int ess) { s=ess; return *this; }
     inline Modes& SetEllMax(const int ell) { ellMax=ell; return *this; }
@@ -95,7 +210,7 @@ namespace GWFrames {
     inline int EllMax() const { return ellMax; }
     inline std::complex<double> operator[](const unsigned int i) const { return data[i]; }
     inline std::complex<double>& operator[](const unsigned int i) { return data[i]; }
-    inline std::vector<std::complex<double> > Data() const { return data; }
+    inline std::vector<std::complex<double> > Data() const { return std::vector<std::complex<double> >(data.begin(), data.end()); }
   public: // Operations
     Modes pow(const int p) const { return Modes(DataGrid(*this, 2*EllMax()*p+1, 2*EllMax()*p+1).pow(p)); }
     Modes bar() const;
@@ -112,6 +227,43 @@ namespace GWFrames {
   GWFrames::ThreeVector vFromOneOverK(const GWFrames::Modes& OneOverK);
 
 
+  class ModesTensor {
+    /// This object holds the modes of several fields at a series of
+    /// times in a single contiguous block, ordered as
+    /// [field][time][mode].  The modes at each time are stored in the
+    /// same order as in `Modes`, so the data for any one field at any
+    /// one time can be used in place.  All fields share the same
+    /// number of times and the same ellMax; each field has its own
+    /// spin weight.
+  private: // Data
+    int nFields;
+    int nTimes;
+    int ellMax;
+    std::vector<int> spins;
+    std::vector<std::complex<double> > data;
+  public: // Constructors
+    ModesTensor(const int NFields=0, const int NTimes=0, const int EllMax=0);
+  public: // Modification
+    inline ModesTensor& SetSpin(const unsigned int i_field, const int s) { spins[i_field]=s; return *this; }
+    ModesTensor& SetField(const unsigned int i_field, const GWFrames::Waveform& W);
+    ModesTensor& SetFieldDot(const unsigned int i_field, const GWFrames::Waveform& W);
+    ModesTensor& SetModes(const unsigned int i_field, const unsigned int i_t, const GWFrames::Modes& M);
+  public: // Access
+    inline int NFields() const { return nFields; }
+    inline int NTimes() const { return nTimes; }
+    inline int EllMax() const { return ellMax; }
+    inline int NModes() const { return (ellMax+1)*(ellMax+1); }
+    inline int Spin(const unsigned int i_field) const { return spins[i_field]; }
+    inline const std::complex<double>* ModeData(const unsigned int i_field, const unsigned int i_t) const {
+      return &data[(std::size_t(i_field)*nTimes+i_t)*NModes()];
+    }
+    inline std::complex<double>* ModeData(const unsigned int i_field, const unsigned int i_t) {
+      return &data[(std::size_t(i_field)*nTimes+i_t)*NModes()];
+    }
+    Modes GetModes(const unsigned int i_field, const unsigned int i_t) const;
+  }; // class ModesTensor
+
+
   template <class D>
   class SliceOfScri {
     /// This class holds all the necessary objects needed to
@@ -121,6 +273,20 @@ namespace GWFrames {
   public: // Constructors
     SliceOfScri(const int size=0);
     SliceOfScri(const SliceOfScri& S) : psi0(S.psi0), psi1(S.psi1), psi2(S.psi2), psi3(S.psi3), psi4(S.psi4), sigma(S.sigma), sigmadot(S.sigmadot) { }
+    SliceOfScri& operator=(const SliceOfScri& S) {
+      psi0=S.psi0; psi1=S.psi1; psi2=S.psi2; psi3=S.psi3; psi4=S.psi4; sigma=S.sigma; sigmadot=S.sigmadot;
+      return *this;
+    }
+    #ifdef GWFrames_MoveSemantics
+    SliceOfScri(SliceOfScri&& S)
+      : psi0(std::move(S.psi0)), psi1(std::move(S.psi1)), psi2(std::move(S.psi2)), psi3(std::move(S.psi3)), psi4(std::move(S.psi4)),
+        sigma(std::move(S.sigma)), sigmadot(std::move(S.sigmadot)) { }
+    SliceOfScri& operator=(SliceOfScri&& S) {
+      psi0=std::move(S.psi0); psi1=std::move(S.psi1); psi2=std::move(S.psi2); psi3=std::move(S.psi3); psi4=std::move(S.psi4);
+      sigma=std::move(S.sigma); sigmadot=std::move(S.sigmadot);
+      return *this;
+    }
+    #endif
   public: //Access
     inline const D& operator[](const unsigned int i) const {
       if(i==0) { return psi0; }
@@ -145,13 +311,20 @@ namespace GWFrames {
   }; // class SliceOfScri
 
   typedef SliceOfScri<DataGrid> SliceGrid;
+  class BMSTransformationContext; // Forward declaration for SliceModes
 
 
   class SliceModes : public SliceOfScri<Modes> {
   public:
     // Constructors
     SliceModes(const int ellMax=0);
+    SliceModes(const ModesTensor& T, const unsigned int i_t);
     SliceModes(const SliceModes& S) : SliceOfScri<Modes>(S) { }
+    SliceModes& operator=(const SliceModes& S) { SliceOfScri<Modes>::operator=(S); return *this; }
+    #ifdef GWFrames_MoveSemantics
+    SliceModes(SliceModes&& S) : SliceOfScri<Modes>(std::move(S)) { }
+    SliceModes& operator=(SliceModes&& S) { SliceOfScri<Modes>::operator=(std::move(S)); return *this; }
+    #endif
     // Useful quantities
     int EllMax() const;
     double Mass() const;
@@ -159,11 +332,60 @@ namespace GWFrames {
     Modes SuperMomentum() const;
     // Transformations
     SliceGrid BMSTransformationOnSlice(const double u, const GWFrames::ThreeVector& v, const GWFrames::Modes& delta) const;
+    SliceGrid BMSTransformationOnSlice(const double u, const BMSTransformationContext& Context) const;
     // Moreschi algorithm
     void MoreschiIteration(GWFrames::Modes& OneOverK_ip1, GWFrames::Modes& delta_ip1) const;
   }; // class SliceModes
 
 
+  class BMSTransformationContext {
+    /// This object holds everything needed to apply a given BMS
+    /// transformation to a slice that depends only on the boost
+    /// velocity `v`, the supertranslation `delta`, and `ellMax` --
+    /// and not on the slice itself.  That includes the conformal
+    /// factor on the boosted grid, the boosted supertranslation terms,
+    /// and the spin-weighted spherical harmonics at each boosted grid
+    /// point for spins -2 through 2.  Constructing one is roughly as
+    /// costly as transforming a single slice, after which each slice
+    /// costs only a few matrix-vector products.  Most of that cost
+    /// is in the parts depending only on `v` and `ellMax`, so
+    /// `SetSupertranslation` replaces `delta` while keeping them.
+    /// Otherwise, the object is immutable, so it may be applied to
+    /// many slices in parallel.
+  private: // Data
+    int ellMax;
+    int n_theta;
+    int n_phi;
+    GWFrames::ThreeVector v;
+    DataGrid oneoverK_g, oneoverKsquared_g, oneoverKcubed_g, ethethdelta_g, ethKoverK_g, ethdeltaKoverK_g;
+    std::vector<std::vector<std::complex<double> > > SWSHs; // SWSHs[s+2][i_g*NModes+i_m]
+  public: // Constructors
+    BMSTransformationContext(const int EllMax, const GWFrames::ThreeVector& v, const GWFrames::Modes& delta);
+    BMSTransformationContext(const int EllMax, const GWFrames::ThreeVector& v);
+    BMSTransformationContext& SetSupertranslation(const GWFrames::Modes& delta);
+  public: // Access
+    inline int EllMax() const { return ellMax; }
+    inline int N_theta() const { return n_theta; }
+    inline int N_phi() const { return n_phi; }
+    inline const GWFrames::ThreeVector& V() const { return v; }
+  public: // Operations
+    DataGrid BoostedGrid(const Modes& M) const;
+    DataGrid BoostedGrid(const int Spin, const unsigned int NM, const std::complex<double>* M) const;
+    void BoostedGrids(const std::vector<int>& Spins, const unsigned int NM, const std::vector<const std::complex<double>*>& M,
+                      std::vector<DataGrid>& Grids) const;
+    SliceGrid TransformSlice(const double u, const SliceModes& S) const;
+    SliceGrid TransformSlice(const double u, const ModesTensor& T, const unsigned int i_t) const;
+    std::vector<SliceGrid> TransformSlices(const std::vector<double>& u, const ModesTensor& T, const unsigned int i_t_a) const;
+    SliceGrid TransformAndInterpolate(const std::vector<double>& u, const ModesTensor& T, const unsigned int i_t_a,
+                                      const std::vector<double>& Weights) const;
+    DataGrid BoostAndInterpolate(const ModesTensor& T, const unsigned int i_field, const unsigned int i_t_a, const unsigned int NSlices,
+                                 const std::vector<double>& Weights) const;
+  private:
+    void InitializeBoost();
+    void TransformBoostedGrids(const double u, SliceGrid& Grids) const;
+  }; // class BMSTransformationContext
+
+
   typedef std::vector<DataGrid> SliceOfScriGrids;
 
 
@@ -177,43 +399,73 @@ namespace GWFrames {
     /// symmetry transformation is an element of the
     /// Bondi--Metzner--Sachs (BMS) group, which transforms the data
     /// contained by `Scri` among itself.
+    ///
+    /// The data are stored as a `ModesTensor` with fields psi0, ...,
+    /// psi4, sigma, sigmadot (in that order); `operator[]` assembles
+    /// the `SliceModes` for a single time on demand.  Because that
+    /// slice is a copy, there is no longer a mutable `operator[]`;
+    /// use `SetSlice` to replace the data on a slice.
   private: // Member data
     std::vector<double> t;
-    std::vector<SliceModes> slices;
+    ModesTensor data;
   public: // Constructor
     Scri(const GWFrames::Waveform& psi0, const GWFrames::Waveform& psi1,
          const GWFrames::Waveform& psi2, const GWFrames::Waveform& psi3,
          const GWFrames::Waveform& psi4, const GWFrames::Waveform& sigma);
-    Scri(const Scri& S) : t(S.t), slices(S.slices) { }
+    Scri(const Scri& S) : t(S.t), data(S.data) { }
   public: // Member functions
     // Transformations
     SliceModes BMSTransformation(const double& u0, const GWFrames::ThreeVector& v, const GWFrames::Modes& delta) const;
+    SliceModes BMSTransformation(const double& u0, const GWFrames::BMSTransformationContext& Context, const GWFrames::Modes& delta) const;
     // Access
     inline int NTimes() const { return t.size(); }
+    inline int EllMax() const { return data.EllMax(); }
     inline const std::vector<double> T() const { return t; }
-    inline const SliceModes operator[](const unsigned int i) const { return slices[i]; }
-    inline SliceModes& operator[](const unsigned int i) { return slices[i]; }
+    inline const ModesTensor& Data() const { return data; }
+    inline const SliceModes operator[](const unsigned int i) const { return SliceModes(data, i); }
+    Scri& SetSlice(const unsigned int i, const SliceModes& S);
   }; // class Scri
 
 
   class SuperMomenta {
+    /// The Moreschi supermomentum at a series of times, stored as a
+    /// single-field `ModesTensor`.  As in `Scri`, `operator[]`
+    /// returns a copy of the modes at one time, so there is no
+    /// mutable `operator[]`; use `SetModes` instead.  The modes at
+    /// every time share one ellMax, which is given explicitly when
+    /// constructing from a size, and defaults to 0 (matching a
+    /// default-constructed `Modes`); it must match the `Modes`
+    /// later passed to `SetModes`.
   private:
     std::vector<double> t;
-    std::vector<Modes> Psi;
+    ModesTensor Psi; // A single field
   public:
     // Constructors
-    SuperMomenta(const unsigned int size) : t(size), Psi(size) { }
+    SuperMomenta(const unsigned int size, const int EllMax=0) : t(size), Psi(1, size, EllMax) { }
     SuperMomenta(const SuperMomenta& S) : t(S.t), Psi(S.Psi) { }
-    SuperMomenta(const std::vector<double>& T, const std::vector<Modes>& psi) : t(T), Psi(psi) { }
+    SuperMomenta(const std::vector<double>& T, const std::vector<Modes>& psi);
     SuperMomenta(const Scri& scri);
     // Access
     inline int NTimes() const { return t.size(); }
+    inline int EllMax() const { return Psi.EllMax(); }
     inline const std::vector<double> T() const { return t; }
-    inline const Modes operator[](const unsigned int i) const { return Psi[i]; }
-    inline Modes& operator[](const unsigned int i) { return Psi[i]; }
+    inline const ModesTensor& Data() const { return Psi; }
+    inline const Modes operator[](const unsigned int i) const { return Psi.GetModes(0, i); }
+    inline SuperMomenta& SetModes(const unsigned int i, const Modes& M) { Psi.SetModes(0, i, M); return *this; }
     // Transformations
     Modes BMSTransform(const GWFrames::Modes& OneOverK, const GWFrames::Modes& delta) const;
+    Modes BMSTransform(const GWFrames::BMSTransformationContext& Context, const GWFrames::Modes& OneOverK, const GWFrames::Modes& delta) const;
+    // Moreschi algorithm
+    Modes SuperMomentumOnSection(const GWFrames::Modes& delta) const;
+    Modes SuperMomentumOnSection(const GWFrames::BMSTransformationContext& Identity, const GWFrames::Modes& delta) const;
     void MoreschiIteration(GWFrames::Modes& OneOverK, GWFrames::Modes& delta) const;
+    int MoreschiSolve(GWFrames::Modes& OneOverK, GWFrames::Modes& delta,
+                      const double Tolerance=1.e-10, const int MaxIterations=100) const;
+    std::vector<int> MoreschiSolve(const std::vector<double>& u, std::vector<GWFrames::Modes>& OneOverK, std::vector<GWFrames::Modes>& delta,
+                                   const double Tolerance=1.e-10, const int MaxIterations=100) const;
+  private:
+    int MoreschiSolve(const GWFrames::BMSTransformationContext& Identity, GWFrames::Modes& OneOverK, GWFrames::Modes& delta,
+                      const double Tolerance, const int MaxIterations) const;
   }; // class SuperMomenta
 
 
@@ -50,9 +50,9 @@ def Hybridize(PathToSystem, Waveform='rhOverM_Asymptotic_GeometricUnits.h5/Extra
     # Place the merger (moment of greatest waveform norm) at t=0, as
     # the only generally meaningful time.
     t0 = -W_NR_corot.MaxNormTime()
-    W_NR_corot.SetT(W_NR_corot.T()+t0)
+    W_NR_corot.SetTimeFromArray(W_NR_corot.TView()+t0)
     if Debug:
-        W_NR_orig.SetT(W_NR_orig.T()+t0)
+        W_NR_orig.SetTimeFromArray(W_NR_orig.TView()+t0)
     t1 = t1 + t0
     if(t2==-sys.float_info.max):
         t2 = 0.75*t1
@@ -104,7 +104,7 @@ def Hybridize(PathToSystem, Waveform='rhOverM_Asymptotic_GeometricUnits.h5/Extra
     sys.stdout.flush()
     W_PN_corot = GWFrames.PNWaveform(Approximant, delta, chia_0, chib_0, Omega_orb_0, InitialOmega_orb, R_frame_i,
                                      MinStepsPerOrbit, PNWaveformModeOrder, PNOrbitalEvolutionOrder)
-    W_PN_corot.SetT(W_PN_corot.T()+t_i);
+    W_PN_corot.SetTimeFromArray(W_PN_corot.TView()+t_i);
     if Debug:
         W_PN_orig = GWFrames.PNWaveform(W_PN_corot)
     W_PN_corot.TransformToCorotatingFrame();
@@ -3,6 +3,15 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+#include <ctime>
+#include <map>
+#include <iomanip>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/param.h>
 #include "Utilities.hpp"
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_eigen.h>
@@ -10,8 +19,15 @@
 #include <gsl/gsl_cblas.h>
 #include "Quaternions.hpp"
 #include "Errors.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 using GWFrames::Matrix;
 using GWFrames::MatrixC;
+using GWFrames::SplitMatrixC;
+using GWFrames::SplineInterpolationPlan;
+using GWFrames::DerivativePlan;
+using GWFrames::History;
 using Quaternions::Quaternion;
 using std::vector;
 using std::complex;
@@ -288,8 +304,6 @@ double GWFrames::CumulativeScalarIntegral(const std::vector<double>& fdot, const
   return f;
 }
 
-inline double SQR(const double a) { return a*a; }
-
 /// Five-point finite-differencing of vector of doubles.
 std::vector<double> GWFrames::ScalarDerivative(const std::vector<double>& f, const std::vector<double>& t) {
   ///
@@ -305,145 +319,20 @@ std::vector<double> GWFrames::ScalarDerivative(const std::vector<double>& f, con
   /// simpler formulas.  If there are fewer than two points, or there
   /// are different numbers of points in the two input vectors, an
   /// exception is thrown.
+  ///
+  /// To differentiate several data sets given at the same times, it
+  /// is faster to construct a `DerivativePlan` once and use that.
 
   if(f.size() != t.size()) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": f.size()=" << f.size() << " != t.size()=" << t.size() << endl;
     throw(GWFrames_VectorSizeMismatch);
   }
-  if(f.size()<2) { cerr << "\n" << __FILE__ << ":" << __LINE__ << ": size=" << f.size() << endl; throw(GWFrames_NotEnoughPointsForDerivative); }
-
+  const DerivativePlan Plan(t);
   vector<double> D(f.size());
-  const unsigned int i_f = f.size()-1;
-
-  if(f.size()==2) {
-    D[0] = (f[1]-f[0])/(t[1]-t[0]);
-    D[1] = D[0];
-    return D;
-  }
-
-  if(f.size()==3 || f.size()==4) {
-    double hprev = t[1]-t[0];
-    { // Compute first point
-      const double hnext = t[2]-t[1];
-      D[0] = -((2*hprev+hnext)/(hprev*(hprev+hnext)))*f[0] + ((hnext+hprev)/(hnext*hprev))*f[1] - (hprev/(hnext*(hnext+hprev)))*f[2];
-    }
-    for(unsigned int i=1; i<i_f; ++i) { // Compute intermediate points
-      const double hnext = t[i+1]-t[i];
-      /// Sundqvist and Veronis, Tellus XXII (1970), 1
-      D[i] = (f[i+1] - f[i-1]*SQR(hnext/hprev) - f[i]*(1-SQR(hnext/hprev))) / (hnext*(1+hnext/hprev));
-      hprev = hnext;
-    }
-    { // Compute final point
-      const double hnext = t[i_f]  -t[i_f-1];
-      const double hprev = t[i_f-1]-t[i_f-2];
-      D[i_f] = (hnext/(hprev*(hprev+hnext)))*f[i_f-2] - ((hnext+hprev)/(hnext*hprev))*f[i_f-1] + ((hprev+2*hnext)/(hnext*(hnext+hprev)))*f[i_f];
-    }
-    return D;
-  }
-
-  for(unsigned int i=0; i<2; ++i) {
-    const double x = t[i];
-    const double& f1 = f[0];
-    const double& f2 = f[1];
-    const double& f3 = f[2];
-    const double& f4 = f[3];
-    const double& f5 = f[4];
-    const double& x1 = t[0];
-    const double& x2 = t[1];
-    const double& x3 = t[2];
-    const double& x4 = t[3];
-    const double& x5 = t[4];
-    const double h1 = x1 - x;
-    const double h2 = x2 - x;
-    const double h3 = x3 - x;
-    const double h4 = x4 - x;
-    const double h5 = x5 - x;
-    const double h12 = x1 - x2;
-    const double h13 = x1 - x3;
-    const double h14 = x1 - x4;
-    const double h15 = x1 - x5;
-    const double h23 = x2 - x3;
-    const double h24 = x2 - x4;
-    const double h25 = x2 - x5;
-    const double h34 = x3 - x4;
-    const double h35 = x3 - x5;
-    const double h45 = x4 - x5;
-    D[i] =
-      (-(h2*h3*h4 +h2*h3*h5 +h2*h4*h5 +h3*h4*h5)*f1/((h12)*(h13)*(h14)*(h15))
-       +(h1*h3*h4 + h1*h3*h5 + h1*h4*h5 + h3*h4*h5)*f2/((h12)*(h23)*(h24)*(h25))
-       -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)*f3/((h13)*(h23)*(h34)*(h35))
-       +(h1*h2*h3 + h1*h2*h5 + h1*h3*h5 + h2*h3*h5)*f4/((h14)*(h24)*(h34)*(h45))
-       -(h1*h2*h3 + h1*h2*h4 + h1*h3*h4 + h2*h3*h4)*f5/((h15)*(h25)*(h35)*(h45)));
-  }
-  for(unsigned int i=2; i<i_f-1; ++i) {
-    const double& f1 = f[i-2];
-    const double& f2 = f[i-1];
-    const double& f3 = f[i];
-    const double& f4 = f[i+1];
-    const double& f5 = f[i+2];
-    const double& x1 = t[i-2];
-    const double& x2 = t[i-1];
-    const double& x3 = t[i];
-    const double& x4 = t[i+1];
-    const double& x5 = t[i+2];
-    const double h1 = x1 - x3;
-    const double h2 = x2 - x3;
-    const double h4 = x4 - x3;
-    const double h5 = x5 - x3;
-    const double h12 = x1 - x2;
-    const double h13 = x1 - x3;
-    const double h14 = x1 - x4;
-    const double h15 = x1 - x5;
-    const double h23 = x2 - x3;
-    const double h24 = x2 - x4;
-    const double h25 = x2 - x5;
-    const double h34 = x3 - x4;
-    const double h35 = x3 - x5;
-    const double h45 = x4 - x5;
-    D[i] =
-      (-(h2*h4*h5)*f1/(h12*h13*h14*h15)
-       +(h1*h4*h5)*f2/(h12*h23*h24*h25)
-       -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)*f3/((h13)*(h23)*(h34)*(h35))
-       +(h1*h2*h5)*f4/(h14*h24*h34*h45)
-       -(h1*h2*h4)*f5/(h15*h25*h35*h45));
-  }
-  for(unsigned int i=i_f-1; i<i_f+1; ++i) {
-    const double x = t[i];
-    const double& f1 = f[i_f-4];
-    const double& f2 = f[i_f-3];
-    const double& f3 = f[i_f-2];
-    const double& f4 = f[i_f-1];
-    const double& f5 = f[i_f];
-    const double& x1 = t[i_f-4];
-    const double& x2 = t[i_f-3];
-    const double& x3 = t[i_f-2];
-    const double& x4 = t[i_f-1];
-    const double& x5 = t[i_f];
-    const double h1 = x1 - x;
-    const double h2 = x2 - x;
-    const double h3 = x3 - x;
-    const double h4 = x4 - x;
-    const double h5 = x5 - x;
-    const double h12 = x1 - x2;
-    const double h13 = x1 - x3;
-    const double h14 = x1 - x4;
-    const double h15 = x1 - x5;
-    const double h23 = x2 - x3;
-    const double h24 = x2 - x4;
-    const double h25 = x2 - x5;
-    const double h34 = x3 - x4;
-    const double h35 = x3 - x5;
-    const double h45 = x4 - x5;
-    D[i] =
-      (-(h2*h3*h4 +h2*h3*h5 +h2*h4*h5 +h3*h4*h5)*f1/((h12)*(h13)*(h14)*(h15))
-       +(h1*h3*h4 + h1*h3*h5 + h1*h4*h5 + h3*h4*h5)*f2/((h12)*(h23)*(h24)*(h25))
-       -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)*f3/((h13)*(h23)*(h34)*(h35))
-       +(h1*h2*h3 + h1*h2*h5 + h1*h3*h5 + h2*h3*h5)*f4/((h14)*(h24)*(h34)*(h45))
-       -(h1*h2*h3 + h1*h2*h4 + h1*h3*h4 + h2*h3*h4)*f5/((h15)*(h25)*(h35)*(h45)));
-  }
+  Plan.Differentiate(&f[0], &D[0]);
   return D;
-
 }
+
 /// Five-point finite-differencing of vector of complex numbers.
 std::vector<std::complex<double> > GWFrames::ComplexDerivative(const std::vector<std::complex<double> >& f, const std::vector<double>& t) {
   ///
@@ -459,144 +348,18 @@ std::vector<std::complex<double> > GWFrames::ComplexDerivative(const std::vector
   /// simpler formulas.  If there are fewer than two points, or there
   /// are different numbers of points in the two input vectors, an
   /// exception is thrown.
+  ///
+  /// To differentiate several data sets given at the same times, it
+  /// is faster to construct a `DerivativePlan` once and use that.
 
   if(f.size() != t.size()) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": f.size()=" << f.size() << " != t.size()=" << t.size() << endl;
     throw(GWFrames_VectorSizeMismatch);
   }
-  if(f.size()<2) { cerr << "\n" << __FILE__ << ":" << __LINE__ << ": size=" << f.size() << endl; throw(GWFrames_NotEnoughPointsForDerivative); }
-
+  const DerivativePlan Plan(t);
   vector<std::complex<double> > D(f.size());
-  const unsigned int i_f = f.size()-1;
-
-  if(f.size()==2) {
-    D[0] = (f[1]-f[0])/(t[1]-t[0]);
-    D[1] = D[0];
-    return D;
-  }
-
-  if(f.size()==3 || f.size()==4) {
-    double hprev = t[1]-t[0];
-    { // Compute first point
-      const double hnext = t[2]-t[1];
-      D[0] = -((2*hprev+hnext)/(hprev*(hprev+hnext)))*f[0] + ((hnext+hprev)/(hnext*hprev))*f[1] - (hprev/(hnext*(hnext+hprev)))*f[2];
-    }
-    for(unsigned int i=1; i<i_f; ++i) { // Compute intermediate points
-      const double hnext = t[i+1]-t[i];
-      /// Sundqvist and Veronis, Tellus XXII (1970), 1
-      D[i] = (f[i+1] - f[i-1]*SQR(hnext/hprev) - f[i]*(1-SQR(hnext/hprev))) / (hnext*(1+hnext/hprev));
-      hprev = hnext;
-    }
-    { // Compute final point
-      const double hnext = t[i_f]  -t[i_f-1];
-      const double hprev = t[i_f-1]-t[i_f-2];
-      D[i_f] = (hnext/(hprev*(hprev+hnext)))*f[i_f-2] - ((hnext+hprev)/(hnext*hprev))*f[i_f-1] + ((hprev+2*hnext)/(hnext*(hnext+hprev)))*f[i_f];
-    }
-    return D;
-  }
-
-  for(unsigned int i=0; i<2; ++i) {
-    const double x = t[i];
-    const std::complex<double>& f1 = f[0];
-    const std::complex<double>& f2 = f[1];
-    const std::complex<double>& f3 = f[2];
-    const std::complex<double>& f4 = f[3];
-    const std::complex<double>& f5 = f[4];
-    const double& x1 = t[0];
-    const double& x2 = t[1];
-    const double& x3 = t[2];
-    const double& x4 = t[3];
-    const double& x5 = t[4];
-    const double h1 = x1 - x;
-    const double h2 = x2 - x;
-    const double h3 = x3 - x;
-    const double h4 = x4 - x;
-    const double h5 = x5 - x;
-    const double h12 = x1 - x2;
-    const double h13 = x1 - x3;
-    const double h14 = x1 - x4;
-    const double h15 = x1 - x5;
-    const double h23 = x2 - x3;
-    const double h24 = x2 - x4;
-    const double h25 = x2 - x5;
-    const double h34 = x3 - x4;
-    const double h35 = x3 - x5;
-    const double h45 = x4 - x5;
-    D[i] =
-      (-(h2*h3*h4 +h2*h3*h5 +h2*h4*h5 +h3*h4*h5)*f1/((h12)*(h13)*(h14)*(h15))
-       +(h1*h3*h4 + h1*h3*h5 + h1*h4*h5 + h3*h4*h5)*f2/((h12)*(h23)*(h24)*(h25))
-       -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)*f3/((h13)*(h23)*(h34)*(h35))
-       +(h1*h2*h3 + h1*h2*h5 + h1*h3*h5 + h2*h3*h5)*f4/((h14)*(h24)*(h34)*(h45))
-       -(h1*h2*h3 + h1*h2*h4 + h1*h3*h4 + h2*h3*h4)*f5/((h15)*(h25)*(h35)*(h45)));
-  }
-  for(unsigned int i=2; i<i_f-1; ++i) {
-    const std::complex<double>& f1 = f[i-2];
-    const std::complex<double>& f2 = f[i-1];
-    const std::complex<double>& f3 = f[i];
-    const std::complex<double>& f4 = f[i+1];
-    const std::complex<double>& f5 = f[i+2];
-    const double& x1 = t[i-2];
-    const double& x2 = t[i-1];
-    const double& x3 = t[i];
-    const double& x4 = t[i+1];
-    const double& x5 = t[i+2];
-    const double h1 = x1 - x3;
-    const double h2 = x2 - x3;
-    const double h4 = x4 - x3;
-    const double h5 = x5 - x3;
-    const double h12 = x1 - x2;
-    const double h13 = x1 - x3;
-    const double h14 = x1 - x4;
-    const double h15 = x1 - x5;
-    const double h23 = x2 - x3;
-    const double h24 = x2 - x4;
-    const double h25 = x2 - x5;
-    const double h34 = x3 - x4;
-    const double h35 = x3 - x5;
-    const double h45 = x4 - x5;
-    D[i] =
-      (-(h2*h4*h5)*f1/(h12*h13*h14*h15)
-       +(h1*h4*h5)*f2/(h12*h23*h24*h25)
-       -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)*f3/((h13)*(h23)*(h34)*(h35))
-       +(h1*h2*h5)*f4/(h14*h24*h34*h45)
-       -(h1*h2*h4)*f5/(h15*h25*h35*h45));
-  }
-  for(unsigned int i=i_f-1; i<i_f+1; ++i) {
-    const double x = t[i];
-    const std::complex<double>& f1 = f[i_f-4];
-    const std::complex<double>& f2 = f[i_f-3];
-    const std::complex<double>& f3 = f[i_f-2];
-    const std::complex<double>& f4 = f[i_f-1];
-    const std::complex<double>& f5 = f[i_f];
-    const double& x1 = t[i_f-4];
-    const double& x2 = t[i_f-3];
-    const double& x3 = t[i_f-2];
-    const double& x4 = t[i_f-1];
-    const double& x5 = t[i_f];
-    const double h1 = x1 - x;
-    const double h2 = x2 - x;
-    const double h3 = x3 - x;
-    const double h4 = x4 - x;
-    const double h5 = x5 - x;
-    const double h12 = x1 - x2;
-    const double h13 = x1 - x3;
-    const double h14 = x1 - x4;
-    const double h15 = x1 - x5;
-    const double h23 = x2 - x3;
-    const double h24 = x2 - x4;
-    const double h25 = x2 - x5;
-    const double h34 = x3 - x4;
-    const double h35 = x3 - x5;
-    const double h45 = x4 - x5;
-    D[i] =
-      (-(h2*h3*h4 +h2*h3*h5 +h2*h4*h5 +h3*h4*h5)*f1/((h12)*(h13)*(h14)*(h15))
-       +(h1*h3*h4 + h1*h3*h5 + h1*h4*h5 + h3*h4*h5)*f2/((h12)*(h23)*(h24)*(h25))
-       -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)*f3/((h13)*(h23)*(h34)*(h35))
-       +(h1*h2*h3 + h1*h2*h5 + h1*h3*h5 + h2*h3*h5)*f4/((h14)*(h24)*(h34)*(h45))
-       -(h1*h2*h3 + h1*h2*h4 + h1*h3*h4 + h2*h3*h4)*f5/((h15)*(h25)*(h35)*(h45)));
-  }
+  Plan.Differentiate(&f[0], &D[0]);
   return D;
-
 }
 
 
@@ -903,6 +666,143 @@ std::vector<double> GWFrames::operator*(const std::vector<double>& a, const Matr
   return Result;
 }
 
+/// Eigenvalues and eigenvectors of a packed symmetric 3x3 matrix
+void GWFrames::SymmetricEigensystem(const double* Packed, double* Values, double* Vectors) {
+  /// \param Packed Upper triangle of the matrix: (xx, xy, xz, yy, yz, zz)
+  /// \param Values Output array of the three eigenvalues, in decreasing order
+  /// \param Vectors Output array of the corresponding unit eigenvectors, with component i of vector j at i+3*j
+  ///
+  /// This uses the cyclic Jacobi method, which is accurate even for
+  /// (nearly) degenerate eigenvalues, and converges in a handful of
+  /// sweeps for 3x3 matrices.  No memory is allocated, so this may be
+  /// called freely inside loops over time steps.  As with any
+  /// eigensolver, the sign of each eigenvector is arbitrary.
+  double a[3][3] = { {Packed[0], Packed[1], Packed[2]},
+                     {Packed[1], Packed[3], Packed[4]},
+                     {Packed[2], Packed[4], Packed[5]} };
+  double v[3][3] = { {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0} };
+  const int P[3] = {0, 0, 1};
+  const int Q[3] = {1, 2, 2};
+  for(int sweep=0; sweep<50; ++sweep) {
+    if(a[0][1]==0.0 && a[0][2]==0.0 && a[1][2]==0.0) { break; }
+    for(int i_pq=0; i_pq<3; ++i_pq) {
+      const int p = P[i_pq];
+      const int q = Q[i_pq];
+      if(a[p][q]==0.0) { continue; }
+      if(std::fabs(a[p][q]) <= 1.e-18*(std::fabs(a[p][p])+std::fabs(a[q][q]))) {
+        // Negligible compared to the diagonal; just drop it
+        a[p][q] = a[q][p] = 0.0;
+        continue;
+      }
+      // Choose the rotation angle phi in [-pi/4, pi/4] that zeroes a[p][q]
+      const double theta = (a[q][q]-a[p][p])/(2.0*a[p][q]);
+      const double t = (std::fabs(theta)>1.e150
+                        ? 0.5/theta
+                        : (theta>=0.0 ? 1.0 : -1.0)/(std::fabs(theta)+std::sqrt(theta*theta+1.0)));
+      const double c = 1.0/std::sqrt(t*t+1.0);
+      const double s = t*c;
+      for(int k=0; k<3; ++k) { // a <- a J
+        const double akp = a[k][p];
+        const double akq = a[k][q];
+        a[k][p] = c*akp - s*akq;
+        a[k][q] = s*akp + c*akq;
+      }
+      for(int k=0; k<3; ++k) { // a <- J^T a
+        const double apk = a[p][k];
+        const double aqk = a[q][k];
+        a[p][k] = c*apk - s*aqk;
+        a[q][k] = s*apk + c*aqk;
+      }
+      a[p][q] = a[q][p] = 0.0;
+      for(int k=0; k<3; ++k) { // v <- v J
+        const double vkp = v[k][p];
+        const double vkq = v[k][q];
+        v[k][p] = c*vkp - s*vkq;
+        v[k][q] = s*vkp + c*vkq;
+      }
+    }
+  }
+  // Sort by decreasing eigenvalue
+  int Order[3] = {0, 1, 2};
+  if(a[Order[0]][Order[0]] < a[Order[1]][Order[1]]) { std::swap(Order[0], Order[1]); }
+  if(a[Order[1]][Order[1]] < a[Order[2]][Order[2]]) { std::swap(Order[1], Order[2]); }
+  if(a[Order[0]][Order[0]] < a[Order[1]][Order[1]]) { std::swap(Order[0], Order[1]); }
+  for(int j=0; j<3; ++j) {
+    Values[j] = a[Order[j]][Order[j]];
+    for(int i=0; i<3; ++i) {
+      Vectors[i+3*j] = v[i][Order[j]];
+    }
+  }
+}
+
+/// Dominant eigenvectors of many packed symmetric 3x3 matrices, with continuous signs
+void GWFrames::DominantPrincipalAxes(const unsigned int N, const double* Packed, double* Axes, const double* RoughInitialDirection) {
+  /// \param N Number of matrices
+  /// \param Packed Array of 6*N doubles, each matrix given as in `SymmetricEigensystem`
+  /// \param Axes Output array of 3*N doubles for the unit eigenvectors
+  /// \param RoughInitialDirection Optional three-vector that the first axis should be closer to than not
+  ///
+  /// The sign of each axis after the first is chosen to be closer to
+  /// the previous axis than not, so that the output is continuous
+  /// whenever the dominant eigenvector itself is.  No memory is
+  /// allocated.
+  double Values[3];
+  double Vectors[9];
+  for(unsigned int i=0; i<N; ++i) {
+    SymmetricEigensystem(Packed+6*i, Values, Vectors);
+    double* Axis = Axes+3*i;
+    const double* Reference = (i==0 ? RoughInitialDirection : Axes+3*(i-1));
+    const bool Flip = (Reference!=0
+                       && Vectors[0]*Reference[0]+Vectors[1]*Reference[1]+Vectors[2]*Reference[2] < 0.0);
+    Axis[0] = (Flip ? -Vectors[0] : Vectors[0]);
+    Axis[1] = (Flip ? -Vectors[1] : Vectors[1]);
+    Axis[2] = (Flip ? -Vectors[2] : Vectors[2]);
+  }
+}
+
+/// Dominant eigenvectors of many packed symmetric 3x3 matrices, with continuous signs
+std::vector<std::vector<double> > GWFrames::DominantPrincipalAxes(const std::vector<std::vector<double> >& Packed,
+                                                                  const std::vector<double>& RoughInitialDirection) {
+  /// \param Packed Vector of matrices, each given as (xx, xy, xz, yy, yz, zz)
+  /// \param RoughInitialDirection Optional three-vector that the first axis should be closer to than not
+  ///
+  /// See the pointer version of this function for details.
+  if(RoughInitialDirection.size()!=0 && RoughInitialDirection.size()!=3) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": RoughInitialDirection.size()=" << RoughInitialDirection.size() << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  vector<double> Flat(6*Packed.size());
+  for(unsigned int i=0; i<Packed.size(); ++i) {
+    if(Packed[i].size()!=6) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Packed[" << i << "].size()=" << Packed[i].size()
+           << ".  Input is assumed to be packed symmetric 3x3 matrices." << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    std::copy(Packed[i].begin(), Packed[i].end(), Flat.begin()+6*i);
+  }
+  vector<double> Flat_Axes(3*Packed.size());
+  if(Packed.size()>0) {
+    DominantPrincipalAxes(Packed.size(), &Flat[0], &Flat_Axes[0],
+                          (RoughInitialDirection.size()==3 ? &RoughInitialDirection[0] : 0));
+  }
+  vector<vector<double> > Axes(Packed.size(), vector<double>(3));
+  for(unsigned int i=0; i<Packed.size(); ++i) {
+    Axes[i].assign(Flat_Axes.begin()+3*i, Flat_Axes.begin()+3*i+3);
+  }
+  return Axes;
+}
+
+#ifndef DOXYGEN
+namespace {
+  // Solve the eigensystem of a 3x3 Matrix, using its lower triangle
+  // (as gsl_eigen_symmv does)
+  void MatrixEigensystem(const GWFrames::Matrix& M, double* Values, double* Vectors) {
+    const double Packed[6] = { M(0,0), M(1,0), M(2,0), M(1,1), M(2,1), M(2,2) };
+    GWFrames::SymmetricEigensystem(Packed, Values, Vectors);
+  }
+}
+#endif // DOXYGEN
+
 std::vector<double> GWFrames::DominantPrincipalValue(std::vector<Matrix>& M) {
   if(M.size()==0) { return vector<double>(0); }
   if(M[0].nrows()!=3 || M[0].ncols()!=3) { // And otherwise, we're just gonna trust that that's the case
@@ -910,17 +810,12 @@ std::vector<double> GWFrames::DominantPrincipalValue(std::vector<Matrix>& M) {
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
   std::vector<double> Result(M.size());
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
+  double Values[3];
+  double Vectors[9];
   for(unsigned int i=0; i<M.size(); ++i) {
-    gsl_eigen_symmv(M[i].gslobj(), eval, evec, w); // Do the work
-    gsl_eigen_symmv_free(w);
-    gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_DESC); // Sort by eigenvalue magnitude
-    Result[i] = gsl_vector_get(eval, 0);
+    MatrixEigensystem(M[i], Values, Vectors);
+    Result[i] = Values[0];
   }
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
   return Result;
 }
 
@@ -931,17 +826,12 @@ std::vector<double> GWFrames::SubordinatePrincipalValue(std::vector<Matrix>& M)
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
   std::vector<double> Result(M.size());
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
-  for(unsigned int i=0; i<Result.size(); ++i) {
-    gsl_eigen_symmv(M[i].gslobj(), eval, evec, w); // Do the work
-    gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_ASC); // Sort by eigenvalue magnitude
-    Result[i] = gsl_vector_get(eval, 0);
-  }
-  gsl_eigen_symmv_free(w);
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
+  double Values[3];
+  double Vectors[9];
+  for(unsigned int i=0; i<M.size(); ++i) {
+    MatrixEigensystem(M[i], Values, Vectors);
+    Result[i] = Values[2];
+  }
   return Result;
 }
 
@@ -950,20 +840,10 @@ std::vector<double> GWFrames::DominantPrincipalAxis(Matrix& M) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": M.nrows()=" << M.nrows() << "; M.ncols()=" << M.ncols() << endl;
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
-  gsl_eigen_symmv(M.gslobj(), eval, evec, w); // Do the work
-  gsl_eigen_symmv_free(w);
-  gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_DESC); // Sort by eigenvalue magnitude
-  gsl_vector_const_view evec_Dominant = gsl_matrix_const_column(evec, 0);
-  vector<double> Result(3);
-  for(unsigned int i=0; i<3; ++i) {
-    Result[i] = gsl_vector_get(&evec_Dominant.vector, i);
-  }
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
-  return Result;
+  double Values[3];
+  double Vectors[9];
+  MatrixEigensystem(M, Values, Vectors);
+  return vector<double>(Vectors, Vectors+3);
 }
 
 std::vector<double> GWFrames::SubordinatePrincipalAxis(Matrix& M) {
@@ -971,20 +851,10 @@ std::vector<double> GWFrames::SubordinatePrincipalAxis(Matrix& M) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": M.nrows()=" << M.nrows() << "; M.ncols()=" << M.ncols() << endl;
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
-  gsl_eigen_symmv(M.gslobj(), eval, evec, w); // Do the work
-  gsl_eigen_symmv_free(w);
-  gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_ASC); // Sort by eigenvalue magnitude
-  gsl_vector_const_view evec_Subordinate = gsl_matrix_const_column(evec, 0);
-  vector<double> Result(3);
-  for(unsigned int i=0; i<3; ++i) {
-    Result[i] = gsl_vector_get(&evec_Subordinate.vector, i);
-  }
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
-  return Result;
+  double Values[3];
+  double Vectors[9];
+  MatrixEigensystem(M, Values, Vectors);
+  return vector<double>(Vectors+6, Vectors+9);
 }
 
 std::vector<double> GWFrames::Eigenvalues(Matrix& M) {
@@ -992,19 +862,10 @@ std::vector<double> GWFrames::Eigenvalues(Matrix& M) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": M.nrows()=" << M.nrows() << "; M.ncols()=" << M.ncols() << endl;
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
-  gsl_eigen_symmv(M.gslobj(), eval, evec, w); // Do the work
-  gsl_eigen_symmv_free(w);
-  gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_DESC); // Sort by eigenvalue magnitude
-  vector<double> Result(3);
-  for(unsigned int i=0; i<3; ++i) {
-    Result[i] = gsl_vector_get(eval, i);
-  }
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
-  return Result;
+  double Values[3];
+  double Vectors[9];
+  MatrixEigensystem(M, Values, Vectors);
+  return vector<double>(Values, Values+3);
 }
 
 std::vector<double> GWFrames::Eigenvectors(Matrix& M) {
@@ -1012,22 +873,10 @@ std::vector<double> GWFrames::Eigenvectors(Matrix& M) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": M.nrows()=" << M.nrows() << "; M.ncols()=" << M.ncols() << endl;
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
-  gsl_eigen_symmv(M.gslobj(), eval, evec, w); // Do the work
-  gsl_eigen_symmv_free(w);
-  gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_DESC); // Sort by eigenvalue magnitude
-  vector<double> Result(9);
-  for(unsigned int j=0; j<3; ++j) {
-    gsl_vector_const_view evec_Dominant = gsl_matrix_const_column(evec, j);
-    for(unsigned int i=0; i<3; ++i) {
-      Result[i+3*j] = gsl_vector_get(&evec_Dominant.vector, i);
-    }
-  }
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
-  return Result;
+  double Values[3];
+  double Vectors[9];
+  MatrixEigensystem(M, Values, Vectors);
+  return vector<double>(Vectors, Vectors+9);
 }
 
 std::vector<double> GWFrames::Eigensystem(Matrix& M) {
@@ -1035,22 +884,16 @@ std::vector<double> GWFrames::Eigensystem(Matrix& M) {
     cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": M.nrows()=" << M.nrows() << "; M.ncols()=" << M.ncols() << endl;
     throw(GWFrames_MatrixSizeAssumedToBeThree);
   }
-  gsl_vector *eval = gsl_vector_alloc (3);
-  gsl_matrix *evec = gsl_matrix_alloc (3, 3);
-  gsl_eigen_symmv_workspace * w = gsl_eigen_symmv_alloc (3);
-  gsl_eigen_symmv(M.gslobj(), eval, evec, w); // Do the work
-  gsl_eigen_symmv_free(w);
-  gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_DESC); // Sort by eigenvalue magnitude
+  double Values[3];
+  double Vectors[9];
+  MatrixEigensystem(M, Values, Vectors);
   vector<double> Result(12);
   for(unsigned int j=0; j<3; ++j) {
-    gsl_vector_const_view evec_Dominant = gsl_matrix_const_column(evec, j);
     for(unsigned int i=0; i<3; ++i) {
-      Result[i+4*j] = gsl_vector_get(&evec_Dominant.vector, i);
+      Result[i+4*j] = Vectors[i+3*j];
     }
-    Result[3+4*j] = gsl_vector_get(eval, j);
+    Result[3+4*j] = Values[j];
   }
-  gsl_vector_free(eval);
-  gsl_matrix_free(evec);
   return Result;
 }
 
@@ -1069,128 +912,537 @@ double GWFrames::Determinant(Matrix& M) {
 
 ////////////////////////////////////////////////////////////////
 
+#ifndef DOXYGEN
+namespace {
+  // Aligned allocation of nel elements of T (or NULL if nel==0)
+  template <typename T>
+  T* AlignedAllocate(const int nel) {
+    if(nel<=0) { return NULL; }
+    void* p = NULL;
+    if(posix_memalign(&p, GWFrames::MatrixCAlignment, sizeof(T)*size_t(nel))!=0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(p);
+  }
+}
+#endif // DOXYGEN
+
 MatrixC::MatrixC()
   : nn(0), mm(0), v(NULL)
 { }
 
 MatrixC::MatrixC(int n, int m)
-  : nn(n), mm(m), v(n>0 ? new std::complex<double>*[n] : NULL)
+  : nn(n), mm(m), v(AlignedAllocate<std::complex<double> >(n*m))
 {
-  const int nel=m*n;
-  if(v) v[0] = nel>0 ? new std::complex<double>[nel] : NULL;
-  for(int i=1;i<n;i++) {
-    v[i] = v[i-1] + m;
-  }
+  std::fill(v, v+nn*mm, std::complex<double>());
 }
 
 MatrixC::MatrixC(int n, int m, const std::complex<double> &a)
-  : nn(n), mm(m), v(n>0 ? new std::complex<double>*[n] : NULL)
+  : nn(n), mm(m), v(AlignedAllocate<std::complex<double> >(n*m))
 {
-  const int nel=m*n;
-  if (v) v[0] = nel>0 ? new std::complex<double>[nel] : NULL;
-  for (int i=1; i< n; i++) v[i] = v[i-1] + m;
-  for (int i=0; i< n; i++) for (int j=0; j<m; j++) v[i][j] = a;
+  std::fill(v, v+nn*mm, a);
 }
 
 MatrixC::MatrixC(int n, int m, const std::complex<double> *a)
-  : nn(n), mm(m), v(n>0 ? new std::complex<double>*[n] : NULL)
+  : nn(n), mm(m), v(AlignedAllocate<std::complex<double> >(n*m))
 {
-  const int nel=m*n;
-  if (v) v[0] = nel>0 ? new std::complex<double>[nel] : NULL;
-  for (int i=1; i<n; i++) v[i] = v[i-1] + m;
-  for (int i=0; i<n; i++) for (int j=0; j<m; j++) v[i][j] = *a++;
+  std::copy(a, a+nn*mm, v);
 }
 
 MatrixC::MatrixC(const MatrixC &rhs)
-  : nn(rhs.nn), mm(rhs.mm), v(nn>0 ? new std::complex<double>*[nn] : NULL)
+  : nn(rhs.nn), mm(rhs.mm), v(AlignedAllocate<std::complex<double> >(rhs.nn*rhs.mm))
 {
-  const int nel=mm*nn;
-  if (v) v[0] = nel>0 ? new std::complex<double>[nel] : NULL;
-  for (int i=1; i<nn; i++) v[i] = v[i-1] + mm;
-  for (int i=0; i<nn; i++) for (int j=0; j<mm; j++) v[i][j] = rhs[i][j];
+  std::copy(rhs.v, rhs.v+nn*mm, v);
 }
 
 MatrixC::MatrixC(const std::vector<std::vector<std::complex<double> > >& rhs)
-  : nn(rhs.size()), mm(nn>0 ? rhs[0].size() : 0), v(nn>0 ? new std::complex<double>*[nn] : NULL)
+  : nn(rhs.size()), mm(nn>0 ? rhs[0].size() : 0), v(AlignedAllocate<std::complex<double> >(nn*mm))
 {
-  const int nel=mm*nn;
-  if (v) v[0] = nel>0 ? new std::complex<double>[nel] : NULL;
-  for (int i=1; i<nn; i++) v[i] = v[i-1] + mm;
-  for (int i=0; i<nn; i++) for (int j=0; j<mm; j++) v[i][j] = rhs[i][j];
+  for (int i=0; i<nn; i++) std::copy(rhs[i].begin(), rhs[i].begin()+mm, v+i*mm);
 }
 
 MatrixC & MatrixC::operator=(const MatrixC &rhs) {
   if (this != &rhs) {
-    if (nn != rhs.nn || mm != rhs.mm) {
-      if (v != NULL) {
-        delete[] (v[0]);
-        delete[] (v);
-      }
-      nn=rhs.nn;
-      mm=rhs.mm;
-      v = nn>0 ? new std::complex<double>*[nn] : NULL;
-      const int nel = mm*nn;
-      if (v) v[0] = nel>0 ? new std::complex<double>[nel] : NULL;
-      for (int i=1; i< nn; i++) v[i] = v[i-1] + mm;
-    }
-    for (int i=0; i<nn; i++) for (int j=0; j<mm; j++) v[i][j] = rhs[i][j];
+    resize(rhs.nn, rhs.mm);
+    std::copy(rhs.v, rhs.v+nn*mm, v);
   }
   return *this;
 }
 
+#ifdef GWFrames_MoveSemantics
+MatrixC::MatrixC(MatrixC&& rhs)
+  : nn(rhs.nn), mm(rhs.mm), v(rhs.v)
+{
+  rhs.nn = 0;
+  rhs.mm = 0;
+  rhs.v = NULL;
+}
+
+MatrixC & MatrixC::operator=(MatrixC&& rhs) {
+  // The old data of this object will be freed along with rhs
+  swap(rhs);
+  return *this;
+}
+#endif // GWFrames_MoveSemantics
+
 void MatrixC::swap(MatrixC& b) {
   { const int n = b.nn; b.nn=nn; nn=n; }
   { const int m = b.mm; b.mm=mm; mm=m; }
-  { std::complex<double>** vv=b.v; b.v=v; v=vv; }
+  { std::complex<double>* vv=b.v; b.v=v; v=vv; }
   return;
 }
 
 // / \@cond
 void MatrixC::resize(int newn, int newm) {
-  if (newn != nn || newm != mm) {
-    if (v != NULL) {
-      delete[] (v[0]);
-      delete[] (v);
-    }
-    nn = newn;
-    mm = newm;
-    v = nn>0 ? new std::complex<double>*[nn] : NULL;
-    const int nel = mm*nn;
-    if (v) { v[0] = nel>0 ? new std::complex<double>[nel] : NULL; }
-    for(int i=1; i< nn; i++) {
-      v[i] = v[i-1] + mm;
-    }
+  if (newn*newm != nn*mm) {
+    free(v);
+    v = AlignedAllocate<std::complex<double> >(newn*newm);
+    std::fill(v, v+newn*newm, std::complex<double>());
   }
+  nn = newn;
+  mm = newm;
 }
 // / \@endcond
 
 void MatrixC::assign(int newn, int newm, const std::complex<double>& a) {
-  if (newn != nn || newm != mm) {
-    if (v != NULL) {
-      delete[] (v[0]);
-      delete[] (v);
+  resize(newn, newm);
+  std::fill(v, v+nn*mm, a);
+}
+
+MatrixC::~MatrixC()
+{
+  free(v);
+}
+
+
+SplitMatrixC::SplitMatrixC()
+  : nn(0), mm(0), re(NULL), im(NULL)
+{ }
+
+SplitMatrixC::SplitMatrixC(int n, int m)
+  : nn(n), mm(m), re(AlignedAllocate<double>(n*m)), im(AlignedAllocate<double>(n*m))
+{
+  std::fill(re, re+nn*mm, 0.0);
+  std::fill(im, im+nn*mm, 0.0);
+}
+
+SplitMatrixC::SplitMatrixC(const MatrixC& rhs)
+  : nn(0), mm(0), re(NULL), im(NULL)
+{
+  *this = rhs;
+}
+
+SplitMatrixC::SplitMatrixC(const SplitMatrixC& rhs)
+  : nn(rhs.nn), mm(rhs.mm), re(AlignedAllocate<double>(rhs.nn*rhs.mm)), im(AlignedAllocate<double>(rhs.nn*rhs.mm))
+{
+  std::copy(rhs.re, rhs.re+nn*mm, re);
+  std::copy(rhs.im, rhs.im+nn*mm, im);
+}
+
+SplitMatrixC& SplitMatrixC::operator=(const SplitMatrixC& rhs) {
+  if (this != &rhs) {
+    resize(rhs.nn, rhs.mm);
+    std::copy(rhs.re, rhs.re+nn*mm, re);
+    std::copy(rhs.im, rhs.im+nn*mm, im);
+  }
+  return *this;
+}
+
+SplitMatrixC& SplitMatrixC::operator=(const MatrixC& rhs) {
+  resize(rhs.nrows(), rhs.ncols());
+  for (int i=0; i<nn; i++) {
+    const std::complex<double>* row = rhs[i];
+    double* rowre = re+i*mm;
+    double* rowim = im+i*mm;
+    for (int j=0; j<mm; j++) {
+      rowre[j] = row[j].real();
+      rowim[j] = row[j].imag();
+    }
+  }
+  return *this;
+}
+
+#ifdef GWFrames_MoveSemantics
+SplitMatrixC::SplitMatrixC(SplitMatrixC&& rhs)
+  : nn(rhs.nn), mm(rhs.mm), re(rhs.re), im(rhs.im)
+{
+  rhs.nn = 0;
+  rhs.mm = 0;
+  rhs.re = NULL;
+  rhs.im = NULL;
+}
+
+SplitMatrixC& SplitMatrixC::operator=(SplitMatrixC&& rhs) {
+  swap(rhs);
+  return *this;
+}
+#endif // GWFrames_MoveSemantics
+
+void SplitMatrixC::swap(SplitMatrixC& b) {
+  { const int n = b.nn; b.nn=nn; nn=n; }
+  { const int m = b.mm; b.mm=mm; mm=m; }
+  { double* vv=b.re; b.re=re; re=vv; }
+  { double* vv=b.im; b.im=im; im=vv; }
+  return;
+}
+
+void SplitMatrixC::resize(int newn, int newm) {
+  if (newn*newm != nn*mm) {
+    free(re);
+    free(im);
+    re = AlignedAllocate<double>(newn*newm);
+    im = AlignedAllocate<double>(newn*newm);
+    std::fill(re, re+newn*newm, 0.0);
+    std::fill(im, im+newn*newm, 0.0);
+  }
+  nn = newn;
+  mm = newm;
+}
+
+/// Copy the data back into the interleaved layout of MatrixC
+MatrixC SplitMatrixC::Interleaved() const {
+  MatrixC M(nn, mm);
+  for (int i=0; i<nn; i++) {
+    std::complex<double>* row = M[i];
+    const double* rowre = re+i*mm;
+    const double* rowim = im+i*mm;
+    for (int j=0; j<mm; j++) {
+      row[j] = std::complex<double>(rowre[j], rowim[j]);
     }
-    nn = newn;
-    mm = newm;
-    v = nn>0 ? new std::complex<double>*[nn] : NULL;
-    const int nel = mm*nn;
-    if(v) { v[0] = nel>0 ? new std::complex<double>[nel] : NULL; }
-    for(int i=1; i< nn; i++) {
-      v[i] = v[i-1] + mm;
+  }
+  return M;
+}
+
+SplitMatrixC::~SplitMatrixC()
+{
+  free(re);
+  free(im);
+}
+
+
+/// Factor the spline system for knots X, and locate the points XNew
+SplineInterpolationPlan::SplineInterpolationPlan(const std::vector<double>& X, const std::vector<double>& XNew)
+  : h(X.size()>0 ? X.size()-1 : 0), l(), dinv(), index(XNew.size()), delx(XNew.size())
+{
+  ///
+  /// \param X Knots (strictly increasing) of the input data
+  /// \param XNew Points at which the splines will be evaluated
+  ///
+  /// Points of XNew outside [X[0], X.back()] are evaluated using the
+  /// first or last polynomial segment; the caller should check the
+  /// domain if extrapolation is not wanted.
+  GWFrames_INSTRUMENT("SplineInterpolationPlan::SplineInterpolationPlan");
+  if(X.size()<2) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Need at least 2 knots for a spline; got " << X.size() << endl;
+    throw(GWFrames_NotEnoughPointsForDerivative);
+  }
+  const unsigned int N = X.size();
+  for(unsigned int i=0; i<N-1; ++i) {
+    h[i] = X[i+1]-X[i];
+  }
+
+  // LDL^T factorization of the symmetric tridiagonal system for the
+  // interior coefficients, with diagonal 2*(h[i]+h[i+1]) and
+  // off-diagonal h[i+1]
+  if(N>2) {
+    const unsigned int n = N-2;
+    l.resize(n, 0.0);
+    dinv.resize(n);
+    double d = 2.0*(h[0]+h[1]);
+    dinv[0] = 1.0/d;
+    for(unsigned int i=1; i<n; ++i) {
+      l[i] = h[i]*dinv[i-1];
+      d = 2.0*(h[i]+h[i+1]) - l[i]*h[i];
+      dinv[i] = 1.0/d;
     }
   }
-  for(int i=0; i< nn; i++) {
-    for(int j=0; j<mm; j++) {
-      v[i][j] = a;
+
+  // Find the interval containing each new point, hunting from the
+  // previous one (which is fast when XNew is sorted)
+  unsigned int i_x = 0;
+  for(unsigned int i=0; i<XNew.size(); ++i) {
+    const double x = XNew[i];
+    if(x<X[i_x]) {
+      i_x = std::upper_bound(X.begin(), X.begin()+i_x, x) - X.begin();
+      i_x = (i_x>0 ? i_x-1 : 0);
     }
+    while(i_x<N-2 && X[i_x+1]<=x) { ++i_x; }
+    index[i] = i_x;
+    delx[i] = x-X[i_x];
   }
 }
 
-MatrixC::~MatrixC()
+/// Interpolate one complex data set
+void SplineInterpolationPlan::Interpolate(const std::complex<double>* Y, std::complex<double>* YNew,
+                                          std::vector<std::complex<double> >& Work) const {
+  ///
+  /// \param Y Data at the knots
+  /// \param YNew Output data at the new points
+  /// \param Work Scratch space, resized as needed
+  ///
+  /// Because the spline is linear in the data, the real and imaginary
+  /// parts are handled together.
+  const unsigned int N = NKnots();
+  std::vector<std::complex<double> >& c = Work;
+  c.resize(N);
+  c[0] = 0.0;
+  c[N-1] = 0.0;
+  if(N>2) {
+    const unsigned int n = N-2;
+    // Forward substitution
+    for(unsigned int i=0; i<n; ++i) {
+      c[i+1] = 3.0*((Y[i+2]-Y[i+1])/h[i+1] - (Y[i+1]-Y[i])/h[i]);
+      if(i>0) { c[i+1] -= l[i]*c[i]; }
+    }
+    // Diagonal and back substitution
+    c[n] *= dinv[n-1];
+    for(unsigned int i=n-1; i>0; --i) {
+      c[i] = c[i]*dinv[i-1] - l[i]*c[i+1];
+    }
+  }
+  for(unsigned int i=0; i<index.size(); ++i) {
+    const unsigned int j = index[i];
+    const double h_j = h[j];
+    const std::complex<double> b = (Y[j+1]-Y[j])/h_j - h_j*(c[j+1]+2.0*c[j])/3.0;
+    const std::complex<double> d = (c[j+1]-c[j])/(3.0*h_j);
+    const double dx = delx[i];
+    YNew[i] = Y[j] + dx*(b + dx*(c[j] + dx*d));
+  }
+}
+
+/// Interpolate each row of a matrix
+void SplineInterpolationPlan::Interpolate(const MatrixC& Y, MatrixC& YNew, const unsigned int Offset) const {
+  ///
+  /// \param Y Data at the knots, with one data set per row
+  /// \param YNew Output, with at least as many rows as Y, and at least Offset+NPoints() columns
+  /// \param Offset Column of YNew at which to start writing
+  ///
+  /// When compiled with OpenMP, the rows are distributed over threads.
+  GWFrames_INSTRUMENT("SplineInterpolationPlan::Interpolate");
+  if(Y.ncols()!=int(NKnots()) || YNew.nrows()<Y.nrows() || YNew.ncols()<int(Offset+NPoints())) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Y is " << Y.nrows() << "x" << Y.ncols()
+         << " and YNew is " << YNew.nrows() << "x" << YNew.ncols() << ", but the plan has "
+         << NKnots() << " knots and " << NPoints() << " points at offset " << Offset << endl;
+    throw(GWFrames_MatrixSizeMismatch);
+  }
+  const int NRows = Y.nrows();
+  #pragma omp parallel if(NRows>1) num_threads(GWFrames::MaxThreads())
+  {
+    std::vector<std::complex<double> > Work(NKnots());
+    #pragma omp for schedule(dynamic)
+    for(int i=0; i<NRows; ++i) {
+      Interpolate(Y[i], YNew[i]+Offset, Work);
+    }
+  }
+}
+
+
+#ifndef DOXYGEN
+namespace {
+  // Weights of the five-point formula for the derivative at x of data
+  // at x1..x5.  This is Eq. (A 5b) of Bowen and Smith, "Derivative
+  // formulas and errors for non-uniformly spaced points".
+  void FivePointDerivativeWeights(const double* X, const double x, double* w) {
+    const double& x1 = X[0];
+    const double& x2 = X[1];
+    const double& x3 = X[2];
+    const double& x4 = X[3];
+    const double& x5 = X[4];
+    const double h1 = x1 - x;
+    const double h2 = x2 - x;
+    const double h3 = x3 - x;
+    const double h4 = x4 - x;
+    const double h5 = x5 - x;
+    const double h12 = x1 - x2;
+    const double h13 = x1 - x3;
+    const double h14 = x1 - x4;
+    const double h15 = x1 - x5;
+    const double h23 = x2 - x3;
+    const double h24 = x2 - x4;
+    const double h25 = x2 - x5;
+    const double h34 = x3 - x4;
+    const double h35 = x3 - x5;
+    const double h45 = x4 - x5;
+    w[0] = -(h2*h3*h4 +h2*h3*h5 +h2*h4*h5 +h3*h4*h5)/((h12)*(h13)*(h14)*(h15));
+    w[1] = +(h1*h3*h4 + h1*h3*h5 + h1*h4*h5 + h3*h4*h5)/((h12)*(h23)*(h24)*(h25));
+    w[2] = -(h1*h2*h4 + h1*h2*h5 + h1*h4*h5 + h2*h4*h5)/((h13)*(h23)*(h34)*(h35));
+    w[3] = +(h1*h2*h3 + h1*h2*h5 + h1*h3*h5 + h2*h3*h5)/((h14)*(h24)*(h34)*(h45));
+    w[4] = -(h1*h2*h3 + h1*h2*h4 + h1*h3*h4 + h2*h3*h4)/((h15)*(h25)*(h35)*(h45));
+  }
+
+  // Relative variation in the time steps below which the grid is
+  // treated as uniform
+  const double UniformGridTolerance = 1.e-10;
+}
+#endif // DOXYGEN
+
+/// Compute the finite-difference weights for the times T
+DerivativePlan::DerivativePlan(const std::vector<double>& T)
+  : n(T.size()), dt(0.0), weights(), offset()
 {
-  if (v != NULL) {
-    delete[] (v[0]);
-    delete[] (v);
+  ///
+  /// \param T Times (strictly increasing) at which the data will be given
+  ///
+  /// With five or more points, the derivative is the fourth-order
+  /// five-point formula of Bowen and Smith, centered where possible;
+  /// with three or four points, it is second order; with two points
+  /// it is just the slope.  Fewer than two points is an error.
+  if(n<2) {
+    cerr << "\n" << __FILE__ << ":" << __LINE__ << ": size=" << n << endl;
+    throw(GWFrames_NotEnoughPointsForDerivative);
+  }
+
+  if(n==2) {
+    const double h = T[1]-T[0];
+    const double w[10] = { -1.0/h, 1.0/h, 0.0, 0.0, 0.0,
+                           -1.0/h, 1.0/h, 0.0, 0.0, 0.0 };
+    weights.assign(w, w+10);
+    offset.assign(2, 0);
+    return;
+  }
+
+  if(n==3 || n==4) {
+    const unsigned int i_f = n-1;
+    weights.assign(5*n, 0.0);
+    offset.resize(n);
+    double hprev = T[1]-T[0];
+    { // First point
+      const double hnext = T[2]-T[1];
+      offset[0] = 0;
+      weights[0] = -((2*hprev+hnext)/(hprev*(hprev+hnext)));
+      weights[1] = ((hnext+hprev)/(hnext*hprev));
+      weights[2] = -(hprev/(hnext*(hnext+hprev)));
+    }
+    for(unsigned int i=1; i<i_f; ++i) { // Intermediate points
+      /// Sundqvist and Veronis, Tellus XXII (1970), 1
+      const double hnext = T[i+1]-T[i];
+      const double r = hnext/hprev;
+      const double denominator = hnext*(1+r);
+      offset[i] = i-1;
+      weights[5*i] = -r*r/denominator;
+      weights[5*i+1] = -(1-r*r)/denominator;
+      weights[5*i+2] = 1.0/denominator;
+      hprev = hnext;
+    }
+    { // Final point
+      const double hnext = T[i_f]  -T[i_f-1];
+      const double hprev = T[i_f-1]-T[i_f-2];
+      offset[i_f] = i_f-2;
+      weights[5*i_f] = (hnext/(hprev*(hprev+hnext)));
+      weights[5*i_f+1] = -((hnext+hprev)/(hnext*hprev));
+      weights[5*i_f+2] = ((hprev+2*hnext)/(hnext*(hnext+hprev)));
+    }
+    return;
+  }
+
+  // Check whether the grid is uniform
+  const double dtAverage = (T[n-1]-T[0])/double(n-1);
+  bool IsUniform = true;
+  for(unsigned int i=1; i<n; ++i) {
+    if(std::fabs((T[i]-T[i-1])-dtAverage) > UniformGridTolerance*std::fabs(dtAverage)) {
+      IsUniform = false;
+      break;
+    }
+  }
+
+  // The two points at each end use off-centered stencils.  On a
+  // uniform grid, these are the only weights we store; otherwise, we
+  // store the weights for every point.
+  if(IsUniform) {
+    dt = dtAverage;
+    weights.resize(20);
+    offset.resize(4);
+    for(unsigned int i=0; i<2; ++i) {
+      offset[i] = 0;
+      FivePointDerivativeWeights(&T[0], T[i], &weights[5*i]);
+    }
+    for(unsigned int i=n-2; i<n; ++i) {
+      offset[i-n+4] = n-5;
+      FivePointDerivativeWeights(&T[n-5], T[i], &weights[5*(i-n+4)]);
+    }
+  } else {
+    weights.resize(5*n);
+    offset.resize(n);
+    for(unsigned int i=0; i<n; ++i) {
+      offset[i] = (i<2 ? 0 : (i>n-3 ? n-5 : i-2));
+      FivePointDerivativeWeights(&T[offset[i]], T[i], &weights[5*i]);
+    }
+  }
+}
+
+/// Apply the plan to one data set, with same type for data and derivative
+template <typename T>
+void DerivativePlan::Apply(const T* F, T* D) const {
+  if(n<5) {
+    // Short series use stencils of two or three points; the rest of
+    // each row of weights would point past the end of F
+    const unsigned int Width = (n==2 ? 2 : 3);
+    for(unsigned int i=0; i<n; ++i) {
+      const double* w = &weights[5*i];
+      const T* f = F+offset[i];
+      T d = w[0]*f[0];
+      for(unsigned int k=1; k<Width; ++k) { d += w[k]*f[k]; }
+      D[i] = d;
+    }
+    return;
+  }
+  if(dt==0.0) {
+    for(unsigned int i=0; i<n; ++i) {
+      const double* w = &weights[5*i];
+      const T* f = F+offset[i];
+      D[i] = w[0]*f[0] + w[1]*f[1] + w[2]*f[2] + w[3]*f[3] + w[4]*f[4];
+    }
+    return;
+  }
+  // Uniform grid: the centered stencil is (1, -8, 0, 8, -1)/(12*dt)
+  const double c1 = 1.0/(12.0*dt);
+  const double c2 = 8.0/(12.0*dt);
+  for(unsigned int i=0; i<4; ++i) {
+    const unsigned int j = (i<2 ? i : i+n-4);
+    const double* w = &weights[5*i];
+    const T* f = F+offset[i];
+    D[j] = w[0]*f[0] + w[1]*f[1] + w[2]*f[2] + w[3]*f[3] + w[4]*f[4];
+  }
+  for(unsigned int i=2; i<n-2; ++i) {
+    D[i] = c1*(F[i-2]-F[i+2]) + c2*(F[i+1]-F[i-1]);
+  }
+}
+
+/// Differentiate one real data set
+void DerivativePlan::Differentiate(const double* F, double* D) const {
+  ///
+  /// \param F Data at the NPoints() times of the plan
+  /// \param D Output array of NPoints() derivatives, which must not overlap F
+  Apply(F, D);
+}
+
+/// Differentiate one complex data set
+void DerivativePlan::Differentiate(const std::complex<double>* F, std::complex<double>* D) const {
+  ///
+  /// \param F Data at the NPoints() times of the plan
+  /// \param D Output array of NPoints() derivatives, which must not overlap F
+  Apply(F, D);
+}
+
+/// Differentiate each row of a matrix
+void DerivativePlan::Differentiate(const MatrixC& F, MatrixC& D) const {
+  ///
+  /// \param F Data, with one data set per row
+  /// \param D Output, which is resized to match F if necessary, and must not be F
+  ///
+  /// When compiled with OpenMP, the rows are distributed over threads.
+  if(F.ncols()!=int(n)) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": F is " << F.nrows() << "x" << F.ncols()
+         << ", but the plan has " << n << " points" << endl;
+    throw(GWFrames_MatrixSizeMismatch);
+  }
+  if(D.nrows()!=F.nrows() || D.ncols()!=F.ncols()) {
+    D.resize(F.nrows(), F.ncols());
+  }
+  const int NRows = F.nrows();
+  #pragma omp parallel for schedule(static) if(NRows>1) num_threads(GWFrames::MaxThreads())
+  for(int i=0; i<NRows; ++i) {
+    Apply(F[i], D[i]);
   }
 }
 
@@ -1245,3 +1497,348 @@ std::ostream& GWFrames::operator<<(std::ostream& out, const std::vector<unsigned
   out << "]" << std::flush;
   return out;
 }
+
+
+#ifndef DOXYGEN
+namespace {
+  bool RecordHistory = true;
+
+  // Requested number of threads; zero or less means the OpenMP default
+  int ThreadLimit = 0;
+
+  // Description of the code revision, directory, host, and time
+  std::string SessionDescription() {
+    char path[MAXPATHLEN];
+    char* result = getcwd(path, MAXPATHLEN);
+    if(!result) {
+      cerr << "\n" << __FILE__ << ":" << __LINE__ << ": getcwd error." << endl;
+      throw(GWFrames_FailedSystemCall);
+    }
+    std::string pwd = path;
+    char host[MAXHOSTNAMELEN];
+    gethostname(host, MAXHOSTNAMELEN);
+    std::string hostname = host;
+    time_t rawtime;
+    time ( &rawtime );
+    std::string date = asctime ( localtime ( &rawtime ) );
+    std::stringstream Description;
+    Description << "# Code revision (`git rev-parse HEAD` or arXiv version) = " << CodeRevision << endl
+                << "# pwd = " << pwd << endl
+                << "# hostname = " << hostname << endl
+                << "# date = " << date; // comes with a newline
+    return Description.str();
+  }
+}
+#endif // DOXYGEN
+
+/// Turn recording of History on or off for all objects
+void GWFrames::EnableHistory(const bool Enable) {
+  /// Batch runs that never look at the history of their Waveforms can
+  /// turn it off to avoid formatting and storing the text.  Objects
+  /// keep whatever they recorded before the call.
+  RecordHistory = Enable;
+}
+
+/// Return true if History is being recorded
+bool GWFrames::HistoryEnabled() {
+  return RecordHistory;
+}
+
+/// Set the number of threads used by all parallelized routines
+void GWFrames::SetMaxThreads(const int N) {
+  /// \param N Number of threads; 1 runs everything serially, and 0 (default) restores the OpenMP default
+  ///
+  /// Every OpenMP region in the library asks for `MaxThreads()`
+  /// threads, so this is the one place to limit oversubscription when
+  /// the library runs inside MPI or multiprocessing jobs.  The setting
+  /// applies to calls from all threads.  Without OpenMP, it has no
+  /// effect.
+  ThreadLimit = (N>0 ? N : 0);
+}
+
+/// Return the number of threads parallelized routines will use
+int GWFrames::MaxThreads() {
+  #ifdef _OPENMP
+  return (ThreadLimit>0 ? ThreadLimit : omp_get_max_threads());
+  #else
+  return 1;
+  #endif
+}
+
+
+#ifdef USE_INSTRUMENTATION
+#ifndef DOXYGEN
+namespace {
+  // Head of the list of every counter that has been used
+  GWFrames::InstrumentationCounter* InstrumentationCounters = 0;
+
+  unsigned long long Microseconds() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
+  }
+}
+#endif // DOXYGEN
+
+GWFrames::InstrumentationCounter::InstrumentationCounter(const char* name)
+  : Name(name), Calls(0), Microseconds(0), Bytes(0), Next(0)
+{
+  do {
+    Next = InstrumentationCounters;
+  } while(!__sync_bool_compare_and_swap(&InstrumentationCounters, Next, this));
+}
+
+GWFrames::InstrumentationScope::InstrumentationScope(InstrumentationCounter& C, const unsigned long long Bytes)
+  : Counter(C), Start(::Microseconds())
+{
+  __sync_add_and_fetch(&Counter.Calls, 1);
+  if(Bytes) { __sync_add_and_fetch(&Counter.Bytes, Bytes); }
+}
+
+GWFrames::InstrumentationScope::~InstrumentationScope() {
+  __sync_add_and_fetch(&Counter.Microseconds, ::Microseconds()-Start);
+}
+#endif // USE_INSTRUMENTATION
+
+/// Return true if the library was built with instrumentation
+bool GWFrames::InstrumentationEnabled() {
+  #ifdef USE_INSTRUMENTATION
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+/// Return the accumulated cost of each instrumented operation
+std::vector<GWFrames::InstrumentationRecord> GWFrames::InstrumentationRecords() {
+  ///
+  /// Counters with the same name are combined, and the records are
+  /// sorted by name, so that the phases of an operation (named as
+  /// 'Operation: phase') follow the operation itself.  The list is
+  /// empty if the library was built without USE_INSTRUMENTATION.
+  std::map<std::string, InstrumentationRecord> Records;
+  #ifdef USE_INSTRUMENTATION
+  for(const InstrumentationCounter* C=InstrumentationCounters; C; C=C->Next) {
+    const InstrumentationRecord Zero = { C->Name, 0, 0.0, 0 };
+    InstrumentationRecord& R = Records.insert(std::make_pair(std::string(C->Name), Zero)).first->second;
+    R.Calls += C->Calls;
+    R.Seconds += 1.e-6*C->Microseconds;
+    R.Bytes += C->Bytes;
+  }
+  #endif
+  vector<InstrumentationRecord> Result;
+  for(std::map<std::string, InstrumentationRecord>::const_iterator it=Records.begin(); it!=Records.end(); ++it) {
+    Result.push_back(it->second);
+  }
+  return Result;
+}
+
+/// Return a table of the accumulated cost of each instrumented operation
+std::string GWFrames::InstrumentationSummary() {
+  ///
+  /// The time is wall time, summed over threads for operations that
+  /// run inside parallel regions.  The bytes are those allocated for
+  /// the main data of each operation, not every temporary.
+  if(!InstrumentationEnabled()) {
+    return "# Instrumentation is disabled; rebuild with USE_INSTRUMENTATION set to enable it.\n";
+  }
+  const vector<InstrumentationRecord> Records = InstrumentationRecords();
+  std::ostringstream Summary;
+  Summary << std::left << std::setw(48) << "# Operation" << std::right
+          << std::setw(12) << "Calls" << std::setw(14) << "Seconds"
+          << std::setw(14) << "ms/call" << std::setw(14) << "MB" << "\n";
+  Summary << std::fixed;
+  for(unsigned int i=0; i<Records.size(); ++i) {
+    const InstrumentationRecord& R = Records[i];
+    Summary << std::left << std::setw(48) << R.Name << std::right
+            << std::setw(12) << R.Calls
+            << std::setw(14) << std::setprecision(6) << R.Seconds
+            << std::setw(14) << std::setprecision(4) << (R.Calls>0 ? 1000.0*R.Seconds/R.Calls : 0.0)
+            << std::setw(14) << std::setprecision(3) << R.Bytes/1048576.0 << "\n";
+  }
+  return Summary.str();
+}
+
+/// Set all instrumentation counters back to zero
+void GWFrames::ResetInstrumentation() {
+  #ifdef USE_INSTRUMENTATION
+  for(InstrumentationCounter* C=InstrumentationCounters; C; C=C->Next) {
+    C->Calls = 0;
+    C->Microseconds = 0;
+    C->Bytes = 0;
+  }
+  #endif
+}
+
+/// One piece of recorded text, shared by every History holding it
+struct GWFrames::History::Node {
+  int refs;
+  Node* prev; // Text recorded before this node
+  Node* included; // History included after `text`
+  std::string text;
+  Node(Node* Prev, const std::string& Text, Node* Included=0)
+    : refs(1), prev(Prev), included(Included), text(Text) { }
+  static Node* Retain(Node* N) {
+    if(N) { __sync_add_and_fetch(&N->refs, 1); }
+    return N;
+  }
+  static void Release(Node* N) {
+    // Walk along each chain and keep a list of the included chains
+    // still to be released, rather than recursing, so that long or
+    // deeply nested histories don't exhaust the stack
+    vector<Node*> Pending;
+    for(;;) {
+      while(N && __sync_sub_and_fetch(&N->refs, 1)==0) {
+        if(N->included) { Pending.push_back(N->included); }
+        Node* Prev = N->prev;
+        delete N;
+        N = Prev;
+      }
+      if(Pending.empty()) { return; }
+      N = Pending.back();
+      Pending.pop_back();
+    }
+  }
+  static void Render(const Node* N, std::string& Out) {
+    // Chains are pushed newest first, so the oldest node is on top;
+    // an included chain goes on top of the rest of its own chain, so
+    // it is rendered right after the text of the node including it
+    vector<const Node*> Pending;
+    for(; N; N=N->prev) { Pending.push_back(N); }
+    while(!Pending.empty()) {
+      const Node* Next = Pending.back();
+      Pending.pop_back();
+      Out += Next->text;
+      for(N=Next->included; N; N=N->prev) { Pending.push_back(N); }
+    }
+  }
+};
+
+History::History()
+  : head(0), buffer(0)
+{ }
+
+History::History(const std::string& Text)
+  : head(Text.empty() ? 0 : new Node(0, Text)), buffer(0)
+{ }
+
+History::History(const History& H)
+  : head(Node::Retain(H.head)), buffer(0)
+{
+  if(H.buffer) {
+    const std::string Pending = H.buffer->str();
+    if(!Pending.empty()) { head = new Node(head, Pending); }
+  }
+}
+
+History& History::operator=(const History& H) {
+  if(this != &H) {
+    History Copy(H);
+    swap(Copy);
+  }
+  return *this;
+}
+
+#ifdef GWFrames_MoveSemantics
+History::History(History&& H)
+  : head(H.head), buffer(H.buffer)
+{
+  H.head = 0;
+  H.buffer = 0;
+}
+
+History& History::operator=(History&& H) {
+  swap(H);
+  return *this;
+}
+#endif // GWFrames_MoveSemantics
+
+History::~History() {
+  Release();
+}
+
+void History::swap(History& H) {
+  { Node* h=H.head; H.head=head; head=h; }
+  { std::ostringstream* b=H.buffer; H.buffer=buffer; buffer=b; }
+  return;
+}
+
+void History::Release() {
+  Node::Release(head);
+  head = 0;
+  delete buffer;
+  buffer = 0;
+}
+
+std::ostringstream& History::Buffer() {
+  if(!buffer) { buffer = new std::ostringstream; }
+  return *buffer;
+}
+
+// Move any buffered text into a new node, keeping the buffer's formatting state
+void History::Flush() {
+  if(buffer) {
+    const std::string Pending = buffer->str();
+    if(!Pending.empty()) {
+      head = new Node(head, Pending);
+      buffer->str("");
+    }
+  }
+}
+
+History& History::operator<<(std::ostream& (*Manipulator)(std::ostream&)) {
+  if(HistoryEnabled()) {
+    Buffer() << Manipulator;
+    Flush();
+  }
+  return *this;
+}
+
+History& History::operator<<(std::ios_base& (*Manipulator)(std::ios_base&)) {
+  if(HistoryEnabled()) {
+    Buffer() << Manipulator;
+  }
+  return *this;
+}
+
+/// Record all of the History H at this point
+History& History::Include(const History& H) {
+  /// The text of H is shared, not copied, and appears in `str()` as
+  /// if it had been appended here.
+  if(HistoryEnabled()) {
+    Flush();
+    Node* Included = Node::Retain(H.head);
+    if(H.buffer) {
+      const std::string Pending = H.buffer->str();
+      if(!Pending.empty()) { Included = new Node(Included, Pending); }
+    }
+    if(Included) { head = new Node(head, "", Included); }
+  }
+  return *this;
+}
+
+/// Assemble the full text of the History
+std::string History::str() const {
+  std::string Out;
+  Node::Render(head, Out);
+  if(buffer) { Out += buffer->str(); }
+  return Out;
+}
+
+/// Replace the History with the given text
+void History::str(const std::string& Text) {
+  Release();
+  if(!Text.empty()) { head = new Node(0, Text); }
+}
+
+/// Description of this session, shared by all objects constructed in it
+const History& History::Session() {
+  /// The working directory, host name, and date are found the first
+  /// time this is called; every later call returns the same History,
+  /// so constructing an object does not need any system calls.  If
+  /// recording is disabled, this returns an empty History.
+  static const History Empty;
+  if(!HistoryEnabled()) { return Empty; }
+  static const History Description(SessionDescription());
+  return Description;
+}
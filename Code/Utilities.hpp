@@ -7,7 +7,21 @@
 #include <vector>
 #include <complex>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+#ifndef SWIG
+#include <pthread.h>
+#endif
+
+// Move constructors and move assignment are only compiled when the
+// compiler supports rvalue references.  SWIG sees the copy-only
+// interface, which is all python can use anyway.
+#if __cplusplus >= 201103L && !defined(SWIG)
+#define GWFrames_MoveSemantics
+#include <utility>
+#endif
 
 namespace GWFrames {
 
@@ -84,6 +98,10 @@ namespace GWFrames {
   };
   std::vector<double> operator*(const std::vector<double>& a, const Matrix& b);
   // Quaternion operator*(const Quaternion& a, const Matrix& b);
+  void SymmetricEigensystem(const double* Packed, double* Values, double* Vectors);
+  void DominantPrincipalAxes(const unsigned int N, const double* Packed, double* Axes, const double* RoughInitialDirection=0);
+  std::vector<std::vector<double> > DominantPrincipalAxes(const std::vector<std::vector<double> >& Packed,
+                                                         const std::vector<double>& RoughInitialDirection=std::vector<double>(0));
   std::vector<double> DominantPrincipalValue(std::vector<Matrix>& M);
   std::vector<double> SubordinatePrincipalValue(std::vector<Matrix>& M);
   std::vector<double> DominantPrincipalAxis(Matrix& M);
@@ -93,12 +111,21 @@ namespace GWFrames {
   std::vector<double> Eigensystem(Matrix& M);
   double Determinant(Matrix& M);
 
+  /// Alignment (in bytes) of the storage for MatrixC and SplitMatrixC
+  const unsigned int MatrixCAlignment = 64;
+
   /// Rectangular array of complex data; probably not needed directly
+  ///
+  /// The data are stored in a single block of memory aligned to
+  /// `MatrixCAlignment` bytes, with each row (mode) contiguous, and
+  /// row i starting at element i*stride().  The real and imaginary
+  /// parts of a (nonempty) row can be passed to GSL as strided
+  /// vectors through RealView and ImagView without copying.
   class MatrixC {
   private:
     int nn;
     int mm;
-    std::complex<double> **v;
+    std::complex<double> *v;
   public:
     MatrixC();
     MatrixC(int n, int m);			// Zero-based array
@@ -107,11 +134,20 @@ namespace GWFrames {
     MatrixC(const std::vector<std::vector<std::complex<double> > >& DataIn);
     MatrixC(const MatrixC &rhs);		// Copy constructor
     MatrixC& operator=(const MatrixC &rhs);	//assignment
+    #ifdef GWFrames_MoveSemantics
+    MatrixC(MatrixC&& rhs);			// Move constructor
+    MatrixC& operator=(MatrixC&& rhs);		// Move assignment
+    #endif
     void swap(MatrixC& b);
-    inline std::complex<double>* operator[](const int i) { return v[i]; }
-    inline const std::complex<double>* operator[](const int i) const { return v[i]; }
+    inline std::complex<double>* operator[](const int i) { return v+i*mm; }
+    inline const std::complex<double>* operator[](const int i) const { return v+i*mm; }
     inline int nrows() const { return nn; }
     inline int ncols() const { return mm; }
+    inline int stride() const { return mm; } // Distance (in complex elements) between the starts of consecutive rows
+    inline gsl_vector_view RealView(const int i) { return gsl_vector_view_array_with_stride(reinterpret_cast<double*>(v+i*mm), 2, mm); }
+    inline gsl_vector_view ImagView(const int i) { return gsl_vector_view_array_with_stride(reinterpret_cast<double*>(v+i*mm)+1, 2, mm); }
+    inline gsl_vector_const_view RealView(const int i) const { return gsl_vector_const_view_array_with_stride(reinterpret_cast<const double*>(v+i*mm), 2, mm); }
+    inline gsl_vector_const_view ImagView(const int i) const { return gsl_vector_const_view_array_with_stride(reinterpret_cast<const double*>(v+i*mm)+1, 2, mm); }
     // / \@cond
     void resize(int newn, int newm); // resize (contents not preserved)
     // / \@endcond
@@ -119,11 +155,257 @@ namespace GWFrames {
     ~MatrixC();
   };
 
+  /// Rectangular array of complex data stored as separate real and imaginary planes
+  ///
+  /// Each plane is a single aligned block with the same row layout as
+  /// MatrixC, so that Re(i) and Im(i) are contiguous arrays that can
+  /// be handed directly to GSL (e.g., `gsl_spline_init`), FFTW, or
+  /// numpy, and loops over time vectorize on real data.
+  class SplitMatrixC {
+  private:
+    int nn;
+    int mm;
+    double *re;
+    double *im;
+  public:
+    SplitMatrixC();
+    SplitMatrixC(int n, int m);
+    SplitMatrixC(const MatrixC& rhs);
+    SplitMatrixC(const SplitMatrixC& rhs);
+    SplitMatrixC& operator=(const SplitMatrixC& rhs);
+    SplitMatrixC& operator=(const MatrixC& rhs);
+    #ifdef GWFrames_MoveSemantics
+    SplitMatrixC(SplitMatrixC&& rhs);
+    SplitMatrixC& operator=(SplitMatrixC&& rhs);
+    #endif
+    void swap(SplitMatrixC& b);
+    inline double* Re(const int i) { return re+i*mm; }
+    inline const double* Re(const int i) const { return re+i*mm; }
+    inline double* Im(const int i) { return im+i*mm; }
+    inline const double* Im(const int i) const { return im+i*mm; }
+    inline std::complex<double> operator()(const int i, const int j) const { return std::complex<double>(re[i*mm+j], im[i*mm+j]); }
+    inline int nrows() const { return nn; }
+    inline int ncols() const { return mm; }
+    inline int stride() const { return mm; }
+    void resize(int newn, int newm); // resize (contents not preserved)
+    MatrixC Interleaved() const;
+    ~SplitMatrixC();
+  };
+
+  /// Natural cubic-spline interpolation of many data sets sharing the same knots
+  ///
+  /// The tridiagonal system for the spline coefficients depends only
+  /// on the knots X, so it is factored once when the plan is
+  /// constructed; the bracketing intervals and offsets for the new
+  /// points XNew are also found once.  Each data set then costs just
+  /// one forward and back substitution, and one pass of evaluation.
+  /// The splines are the same as GSL's `gsl_interp_cspline`.
+  class SplineInterpolationPlan {
+  private:
+    std::vector<double> h; // Knot spacings
+    std::vector<double> l; // Multipliers of the LDL^T factorization
+    std::vector<double> dinv; // Inverses of the pivots of the factorization
+    std::vector<unsigned int> index; // Knot at the start of the interval containing each new point
+    std::vector<double> delx; // Offset of each new point from that knot
+  public:
+    SplineInterpolationPlan(const std::vector<double>& X, const std::vector<double>& XNew);
+    inline unsigned int NKnots() const { return h.size()+1; }
+    inline unsigned int NPoints() const { return index.size(); }
+    void Interpolate(const std::complex<double>* Y, std::complex<double>* YNew, std::vector<std::complex<double> >& Work) const;
+    void Interpolate(const MatrixC& Y, MatrixC& YNew, const unsigned int Offset=0) const;
+  };
+
+  /// Five-point finite-difference derivatives of many data sets sampled at the same times
+  ///
+  /// The stencil weights depend only on the times, so they are
+  /// computed once when the plan is constructed, and each data set
+  /// then costs one weighted sum per point.  When the times are
+  /// uniformly spaced, only the weights for the two points at each
+  /// end are stored, and the interior uses the fixed centered
+  /// stencil.  The derivatives are the same as `ComplexDerivative`.
+  class DerivativePlan {
+  private:
+    unsigned int n;
+    double dt; // Time step if the grid is uniform, or 0.0 otherwise
+    std::vector<double> weights; // weights[5*i+k] multiplies F[offset[i]+k] (only k<2 or 3 for fewer than five points)
+    std::vector<unsigned int> offset; // First point of the stencil for each row of weights
+    template <typename T> void Apply(const T* F, T* D) const;
+  public:
+    DerivativePlan(const std::vector<double>& T);
+    inline unsigned int NPoints() const { return n; }
+    inline bool Uniform() const { return dt!=0.0; }
+    void Differentiate(const double* F, double* D) const;
+    void Differentiate(const std::complex<double>* F, std::complex<double>* D) const;
+    void Differentiate(const MatrixC& F, MatrixC& D) const;
+  };
+
   std::ostream& operator<<(std::ostream& out, const std::vector<double>& v);
   std::ostream& operator<<(std::ostream& out, const std::vector<int>& v);
   std::ostream& operator<<(std::ostream& out, const std::vector<std::vector<int> >& vv);
   std::ostream& operator<<(std::ostream& out, const std::vector<unsigned int>& v);
 
+  // Global switch for recording History; on by default
+  void EnableHistory(const bool Enable=true);
+  bool HistoryEnabled();
+
+  // Global limit on the number of threads used by parallelized
+  // routines; zero means the OpenMP default, and one runs serially
+  void SetMaxThreads(const int N=0);
+  int MaxThreads();
+
+  #ifndef SWIG
+  /// Mutual exclusion that works with or without OpenMP
+  ///
+  /// `#pragma omp critical` compiles to nothing without OpenMP, but
+  /// the python wrappers release the GIL around the long-running
+  /// routines, so caches shared by the whole process may still be
+  /// reached from several threads at once.  Those caches are guarded
+  /// by a Mutex, held by a `MutexLock` for the rest of the enclosing
+  /// scope.  A Mutex is not recursive.
+  class Mutex {
+  private:
+    friend class Condition;
+    pthread_mutex_t mutex;
+    Mutex(const Mutex&);
+    Mutex& operator=(const Mutex&);
+  public:
+    Mutex() { pthread_mutex_init(&mutex, 0); }
+    ~Mutex() { pthread_mutex_destroy(&mutex); }
+    inline void Lock() { pthread_mutex_lock(&mutex); }
+    inline void Unlock() { pthread_mutex_unlock(&mutex); }
+  };
+
+  /// Hold a Mutex for the lifetime of this object
+  class MutexLock {
+  private:
+    Mutex& mutex;
+    MutexLock(const MutexLock&);
+    MutexLock& operator=(const MutexLock&);
+  public:
+    explicit MutexLock(Mutex& M) : mutex(M) { mutex.Lock(); }
+    ~MutexLock() { mutex.Unlock(); }
+  };
+
+  /// Condition variable to wait on while holding a Mutex
+  ///
+  /// `Wait` releases the Mutex, which the caller must hold, until
+  /// another thread calls `NotifyAll`, and holds it again before
+  /// returning.  Wakeups may be spurious, so the caller should wait
+  /// in a loop that re-checks its condition.
+  class Condition {
+  private:
+    pthread_cond_t condition;
+    Condition(const Condition&);
+    Condition& operator=(const Condition&);
+  public:
+    Condition() { pthread_cond_init(&condition, 0); }
+    ~Condition() { pthread_cond_destroy(&condition); }
+    inline void Wait(Mutex& M) { pthread_cond_wait(&condition, &M.mutex); }
+    inline void NotifyAll() { pthread_cond_broadcast(&condition); }
+  };
+  #endif // SWIG
+
+  /// Accumulated cost of one instrumented operation
+  struct InstrumentationRecord {
+    std::string Name;
+    unsigned long long Calls;
+    double Seconds;
+    unsigned long long Bytes;
+  };
+
+  // Queries of the instrumentation counters; these all exist (and
+  // report nothing) when the library is built without
+  // USE_INSTRUMENTATION
+  bool InstrumentationEnabled();
+  std::vector<InstrumentationRecord> InstrumentationRecords();
+  std::string InstrumentationSummary();
+  void ResetInstrumentation();
+
+  #if defined(USE_INSTRUMENTATION) && !defined(SWIG)
+  /// Counter for one instrumented site
+  ///
+  /// Counters are created as function-local statics by the
+  /// `GWFrames_INSTRUMENT` macros, and register themselves in a
+  /// global list on first use.  All updates are atomic, so the same
+  /// counter may be used from several threads; the time is then the
+  /// sum over threads.
+  struct InstrumentationCounter {
+    const char* Name;
+    unsigned long long Calls;
+    unsigned long long Microseconds;
+    unsigned long long Bytes;
+    InstrumentationCounter* Next;
+    explicit InstrumentationCounter(const char* name);
+  };
+
+  /// Add the wall time of the enclosing scope to a counter
+  class InstrumentationScope {
+  private:
+    InstrumentationCounter& Counter;
+    unsigned long long Start;
+    InstrumentationScope(const InstrumentationScope&);
+    InstrumentationScope& operator=(const InstrumentationScope&);
+  public:
+    InstrumentationScope(InstrumentationCounter& C, const unsigned long long Bytes);
+    ~InstrumentationScope();
+  };
+
+  #define GWFrames_INSTRUMENT_JOIN2(a,b) a##b
+  #define GWFrames_INSTRUMENT_JOIN(a,b) GWFrames_INSTRUMENT_JOIN2(a,b)
+  #define GWFrames_INSTRUMENT_BYTES(Name, Bytes)                      \
+    static GWFrames::InstrumentationCounter GWFrames_INSTRUMENT_JOIN(GWFrames_Counter_,__LINE__)(Name); \
+    const GWFrames::InstrumentationScope GWFrames_INSTRUMENT_JOIN(GWFrames_Scope_,__LINE__)(GWFrames_INSTRUMENT_JOIN(GWFrames_Counter_,__LINE__), (Bytes))
+  #else
+  #define GWFrames_INSTRUMENT_BYTES(Name, Bytes)
+  #endif
+  // Count calls to and time spent in the rest of the enclosing scope
+  // (optionally along with the bytes it allocates), under the given
+  // name.  This compiles to nothing without USE_INSTRUMENTATION.
+  #define GWFrames_INSTRUMENT(Name) GWFrames_INSTRUMENT_BYTES(Name, 0)
+
+  /// Append-only record of the operations applied to an object
+  ///
+  /// The recorded text is stored in reference-counted, immutable
+  /// nodes that are shared between copies, so copying a History costs
+  /// the same no matter how long it is, and `Include` records another
+  /// object's whole History without copying its text.  Text is
+  /// appended with `<<` just as for a stream; it is formatted into a
+  /// small buffer that becomes a shared node at each `std::endl`.
+  /// The full text is only assembled when `str()` is called (e.g.,
+  /// for output).  When `EnableHistory(false)` has been called,
+  /// nothing is formatted or recorded.
+  class History {
+  private:
+    struct Node;
+    Node* head;
+    std::ostringstream* buffer; // Text appended since the last node was made
+    void Flush();
+    void Release();
+    std::ostringstream& Buffer();
+  public:
+    History();
+    explicit History(const std::string& Text);
+    History(const History& H);
+    History& operator=(const History& H);
+    #ifdef GWFrames_MoveSemantics
+    History(History&& H);
+    History& operator=(History&& H);
+    #endif
+    ~History();
+    void swap(History& H);
+    template <typename T>
+    inline History& operator<<(const T& x) {
+      if(HistoryEnabled()) { Buffer() << x; }
+      return *this;
+    }
+    History& operator<<(std::ostream& (*Manipulator)(std::ostream&));
+    History& operator<<(std::ios_base& (*Manipulator)(std::ios_base&));
+    History& Include(const History& H);
+    std::string str() const;
+    void str(const std::string& Text);
+    static const History& Session();
+  };
+
 } // namespace GWFrames
 
 #endif // UTILITIES_HPP
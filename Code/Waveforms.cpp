@@ -2,14 +2,22 @@
 // See LICENSE file for details
 
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/param.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <cstdio>
+#include <stdio.h>
 #include <cstdlib>
 #include <climits>
 #include <cmath>
+#include <cstring>
+#include <stdint.h>
+#include <iterator>
 
 #include <sys/time.h>
 #include <ctime>
@@ -27,12 +35,16 @@
 #include "SpacetimeAlgebra.hpp"
 #pragma clang diagnostic pop
 #include "Waveforms.hpp"
+#include "Scri.hpp"
 #include "Utilities.hpp"
 #include "Quaternions.hpp"
 #include "Quaternions/QuaternionUtilities.hpp"
 #include "IntegrateAngularVelocity.hpp"
 #include "SphericalFunctions/SWSHs.hpp"
 #include "Errors.hpp"
+#ifdef USE_HDF5
+#include <hdf5.h>
+#endif
 
 using Quaternions::Quaternion;
 using Quaternions::QuaternionArray;
@@ -90,95 +102,93 @@ std::string StringForm(const std::vector<int>& Lmodes) {
 
 /// Default constructor for an empty object
 GWFrames::Waveform::Waveform() :
-  spinweight(-2), boostweight(-1), history(""), versionHist(), t(0), frame(0), frameType(GWFrames::UnknownFrameType),
-  dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(), data()
+  spinweight(-2), boostweight(-1), history(History::Session()), versionHist(), t(0), frame(0), frameType(GWFrames::UnknownFrameType),
+  dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(), modeLayout(), data()
 {
-  {
-    char path[MAXPATHLEN];
-    char* result = getcwd(path, MAXPATHLEN);
-    if(!result) {
-      cerr << "\n" << __FILE__ << ":" << __LINE__ << ": getcwd error." << endl;
-      throw(GWFrames_FailedSystemCall);
-    }
-    string pwd = path;
-    char host[MAXHOSTNAMELEN];
-    gethostname(host, MAXHOSTNAMELEN);
-    string hostname = host;
-    time_t rawtime;
-    time ( &rawtime );
-    string date = asctime ( localtime ( &rawtime ) );
-    history << "# Code revision (`git rev-parse HEAD` or arXiv version) = " << CodeRevision << endl
-            << "# pwd = " << pwd << endl
-            << "# hostname = " << hostname << endl
-            << "# date = " << date // comes with a newline
-            << "Waveform(); // empty constructor" << endl;
-  }
+  history << "Waveform(); // empty constructor" << endl;
 }
 
 /// Copy constructor
 GWFrames::Waveform::Waveform(const GWFrames::Waveform& a) :
-  spinweight(a.spinweight), boostweight(a.boostweight), history(a.history.str()), versionHist(a.versionHist),
+  spinweight(a.spinweight), boostweight(a.boostweight), history(a.history), versionHist(a.versionHist),
   t(a.t), frame(a.frame), frameType(a.frameType), dataType(a.dataType), rIsScaledOut(a.rIsScaledOut),
-  mIsScaledOut(a.mIsScaledOut), lm(a.lm), data(a.data)
+  mIsScaledOut(a.mIsScaledOut), lm(a.lm), modeLayout(a.modeLayout), data(a.data)
 {
   /// Simply copies all fields in the input object to the constructed
-  /// object, including history
-  history.seekp(0, ios_base::end);
+  /// object, including history (whose text is shared, not copied)
+}
+
+#ifdef GWFrames_MoveSemantics
+/// Move constructor
+GWFrames::Waveform::Waveform(GWFrames::Waveform&& a) :
+  spinweight(a.spinweight), boostweight(a.boostweight), history(std::move(a.history)), versionHist(std::move(a.versionHist)),
+  t(std::move(a.t)), frame(std::move(a.frame)), frameType(a.frameType), dataType(a.dataType), rIsScaledOut(a.rIsScaledOut),
+  mIsScaledOut(a.mIsScaledOut), lm(std::move(a.lm)), modeLayout(a.modeLayout), data(std::move(a.data))
+{
+  /// Takes over the data of the input object without copying it.
+  /// The input object is left empty, but valid.
+  a.modeLayout = ModeLayout();
+}
+#endif // GWFrames_MoveSemantics
+
+#ifndef DOXYGEN
+namespace {
+  // Text files record the precision of the mode data in a header line
+  // starting with this (see Waveform::OutputText); H5 files use an
+  // attribute named BytesPerReal, as does the binary header
+  const std::string TextBytesPerRealHeader = "# BytesPerReal = ";
+
+  // Mode data are stored in files as either double or float
+  void CheckBytesPerReal(const int BytesPerReal, const std::string& FileName) {
+    if(BytesPerReal!=int(sizeof(double)) && BytesPerReal!=int(sizeof(float))) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' has BytesPerReal=" << BytesPerReal << endl;
+      throw(GWFrames_BadWaveformInformation);
+    }
+  }
 }
+#endif // DOXYGEN
 
 /// Constructor from data file
 GWFrames::Waveform::Waveform(const std::string& FileName, const std::string& DataFormat) :
-  spinweight(-2), boostweight(-1), history(""), versionHist(), t(0), frame(0), frameType(GWFrames::UnknownFrameType),
-  dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(), data()
+  spinweight(-2), boostweight(-1), history(History::Session()), versionHist(), t(0), frame(0), frameType(GWFrames::UnknownFrameType),
+  dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(), modeLayout(), data()
 {
   ///
   /// \param FileName Relative path to data file
-  /// \param DataFormat Either 'ReIm' or 'MagArg'
-  ///
-  /// NOTE: This function assumes that the data are stored as (ell,m)
-  /// modes, starting with (2,-2), incrementing m, then incrementing
-  /// ell and starting again at m=-ell.  If this is not how the modes
-  /// are stored, the 'lm' data of this object needs to be reset or
-  /// bad things will happen when trying to find the angular-momentum
-  /// vector or rotate the waveform.
-  {
-    char path[MAXPATHLEN];
-    char* result = getcwd(path, MAXPATHLEN);
-    if(!result) {
-      cerr << "\n" << __FILE__ << ":" << __LINE__ << ": getcwd error." << endl;
-      throw(GWFrames_FailedSystemCall);
-    }
-    string pwd = path;
-    char host[MAXHOSTNAMELEN];
-    gethostname(host, MAXHOSTNAMELEN);
-    string hostname = host;
-    time_t rawtime;
-    time ( &rawtime );
-    string date = asctime ( localtime ( &rawtime ) );
-    history << "# Code revision (`git rev-parse HEAD` or arXiv version) = " << CodeRevision << endl
-            << "# pwd = " << pwd << endl
-            << "# hostname = " << hostname << endl
-            << "# date = " << date // comes with a newline
-            << "Waveform(" << FileName << ", " << DataFormat << "); // Constructor from data file" << endl;
-  }
-
-  // Get the number of lines in the file
-  char LengthChar[9];
-  FILE* fp = popen(("wc -l " + FileName).c_str(), "r");
-  if(!fp) {
-    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Cannot call wc to get size of '" << FileName << "'" << endl;
-    throw(GWFrames_FailedSystemCall);
-  }
-  if(fgets(LengthChar, 9, fp) == NULL) {
-    cerr << "\n\n";
-    if(ferror(fp)) {
-      cerr << __FILE__ << ":" << __LINE__ << ": Read error in popen while calling wc. LengthChar='" << LengthChar << "'" << endl;
-    }
-    cerr << __FILE__ << ":" << __LINE__ << ": Failed calling wc to get size of '" << FileName << "'" << endl;
-    throw(GWFrames_FailedSystemCall);
-  }
-  pclose(fp);
-  const int FileLength = atoi(LengthChar);
+  /// \param DataFormat One of 'ReIm', 'MagArg', 'Binary', or 'H5'
+  ///
+  /// NOTE: For the text formats ('ReIm' and 'MagArg'), this function
+  /// assumes that the data are stored as (ell,m) modes, starting with
+  /// (2,-2), incrementing m, then incrementing ell and starting again
+  /// at m=-ell.  If this is not how the modes are stored, the 'lm'
+  /// data of this object needs to be reset or bad things will happen
+  /// when trying to find the angular-momentum vector or rotate the
+  /// waveform.
+  ///
+  /// The 'Binary' format stores all of the information needed to
+  /// reconstruct the Waveform (including the 'lm' data and frame),
+  /// and is read by mapping the file into memory, so that no parsing
+  /// is needed.  See `Waveform::ReadBinaryFile` for a description of
+  /// the layout.
+  ///
+  /// The 'H5' format reads all modes from an H5 file in NRAR format,
+  /// where FileName may also specify a group, as in 'File.h5/Group'.
+  /// See the H5 constructor taking a list of modes to read only some
+  /// of the data.
+  GWFrames_INSTRUMENT("Waveform::Waveform(FileName, DataFormat)");
+  history << "Waveform(" << FileName << ", " << DataFormat << "); // Constructor from data file" << endl;
+
+  // Binary files carry their own description, so just read them directly
+  if(tolower(DataFormat).find("binary")!=string::npos) {
+    ReadBinaryFile(FileName);
+    return;
+  }
+
+  // H5 files are read natively; see the constructor taking LM for partial reads
+  if(tolower(DataFormat).find("h5")!=string::npos) {
+    ReadH5File(FileName, vector<vector<int> >(0));
+    return;
+  }
 
   // Open the input file stream
   ifstream ifs(FileName.c_str(), ifstream::in);
@@ -187,8 +197,14 @@ GWFrames::Waveform::Waveform(const std::string& FileName, const std::string& Dat
     throw(GWFrames_BadFileName);
   }
 
+  // Get the number of lines in the file (equivalent to `wc -l`), and rewind
+  const int FileLength = std::count(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>(), '\n');
+  ifs.clear();
+  ifs.seekg(0, ios_base::beg);
+
   // Get the header and save to 'history'
   int HeaderLines = 0;
+  int BytesPerReal = sizeof(double);
   {
     history << "#### Begin Previous History\n";
     string Temp;
@@ -196,9 +212,16 @@ GWFrames::Waveform::Waveform(const std::string& FileName, const std::string& Dat
       getline(ifs, Temp);
       HeaderLines++;
       history << "#" << Temp << "\n";
+      if(Temp.compare(0, TextBytesPerRealHeader.size(), TextBytesPerRealHeader)==0) {
+        BytesPerReal = std::atoi(Temp.c_str()+TextBytesPerRealHeader.size());
+        CheckBytesPerReal(BytesPerReal, FileName);
+      }
     }
     history << "#### End Previous History\n";
   }
+  if(BytesPerReal==int(sizeof(float))) {
+    history << "// Mode data in '" << FileName << "' were stored in single precision" << endl;
+  }
 
   // Read the complex data
   vector<double> Line;
@@ -261,15 +284,700 @@ GWFrames::Waveform::Waveform(const std::string& FileName, const std::string& Dat
       }
     }
   }
+  UpdateModeLayout();
+}
+
+#ifndef DOXYGEN
+namespace {
+  // Position just past the '.h5' extension of FileName, or npos if
+  // FileName does not refer to an H5 file.  The extension must either
+  // end the name or be followed by a group, as in 'File.h5/Group'.
+  std::string::size_type H5ExtensionEnd(const std::string& FileName) {
+    std::string::size_type i = FileName.find(".h5");
+    while(i!=std::string::npos) {
+      const std::string::size_type End = i+3;
+      if(End==FileName.size() || FileName[End]=='/') { return End; }
+      i = FileName.find(".h5", i+1);
+    }
+    return std::string::npos;
+  }
+
+  // Return true if FileName refers to an H5 file (or a group in one)
+  bool IsH5FileName(const std::string& FileName) {
+    return H5ExtensionEnd(FileName)!=std::string::npos;
+  }
+
+  // Description of the binary file format; see Waveform::ReadBinaryFile
+  const char BinaryWaveformMagic[8] = { 'G', 'W', 'F', 'r', 'a', 'm', 'e', 's' };
+  const uint32_t BinaryWaveformByteOrderMark = 0x01020304;
+  const uint32_t BinaryWaveformFormatVersion = 2;
+  const uint64_t BinaryWaveformHeaderSizeVersion1 = 72; // Version 1 had no BytesPerReal or Reserved
+  struct BinaryWaveformHeader {
+    char Magic[8];
+    uint32_t ByteOrderMark;
+    uint32_t FormatVersion;
+    int32_t SpinWeight;
+    int32_t BoostWeight;
+    int32_t FrameType;
+    int32_t DataType;
+    int32_t RIsScaledOut;
+    int32_t MIsScaledOut;
+    uint64_t NModes;
+    uint64_t NTimes;
+    uint64_t NFrame;
+    uint64_t NHistory;
+    uint32_t BytesPerReal;
+    uint32_t Reserved;
+  };
+  // Byte offsets of the blocks following the header; the numeric
+  // arrays start on a 16-byte boundary.
+  struct BinaryWaveformOffsets {
+    uint64_t LM, History, T, Frame, Data, End;
+    BinaryWaveformOffsets(const BinaryWaveformHeader& H)
+      : LM(H.FormatVersion<2 ? BinaryWaveformHeaderSizeVersion1 : sizeof(BinaryWaveformHeader)),
+        History(LM + 2*sizeof(int32_t)*H.NModes),
+        T(16*((History + H.NHistory + 15)/16)),
+        Frame(T + sizeof(double)*H.NTimes),
+        Data(Frame + 4*sizeof(double)*H.NFrame),
+        End(Data + 2*uint64_t(H.BytesPerReal)*H.NModes*H.NTimes)
+    { }
+  };
+
+  // Read-only memory map of a binary Waveform file, whose header is
+  // checked on construction; the file is unmapped on destruction.
+  class BinaryWaveformMap {
+  private:
+    void* map;
+    uint64_t size;
+    BinaryWaveformMap(const BinaryWaveformMap&);
+    BinaryWaveformMap& operator=(const BinaryWaveformMap&);
+    static BinaryWaveformHeader ReadHeader(const void* Map, const uint64_t FileSize) {
+      BinaryWaveformHeader Header;
+      std::memset(&Header, 0, sizeof(BinaryWaveformHeader));
+      std::memcpy(&Header, Map, BinaryWaveformHeaderSizeVersion1);
+      if(Header.FormatVersion<2) {
+        Header.BytesPerReal = sizeof(double);
+      } else if(FileSize>=sizeof(BinaryWaveformHeader)) {
+        std::memcpy(&Header, Map, sizeof(BinaryWaveformHeader));
+      }
+      return Header;
+    }
+    static void* MapOrThrow(const std::string& FileName, uint64_t& FileSize) {
+      const int fd = open(FileName.c_str(), O_RDONLY);
+      if(fd<0) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << FileName << "'" << endl;
+        throw(GWFrames_BadFileName);
+      }
+      struct stat FileStat;
+      if(fstat(fd, &FileStat)!=0) {
+        close(fd);
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't stat '" << FileName << "'" << endl;
+        throw(GWFrames_FailedSystemCall);
+      }
+      FileSize = FileStat.st_size;
+      if(FileSize<BinaryWaveformHeaderSizeVersion1) {
+        close(fd);
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' is too small to be a binary Waveform file" << endl;
+        throw(GWFrames_BadFileName);
+      }
+      void* Map = mmap(0, FileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if(Map==MAP_FAILED) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't mmap '" << FileName << "'" << endl;
+        throw(GWFrames_FailedSystemCall);
+      }
+      madvise(Map, FileSize, MADV_SEQUENTIAL);
+      return Map;
+    }
+  public:
+    const BinaryWaveformHeader Header;
+    const BinaryWaveformOffsets Offsets;
+    const char* const Bytes;
+    explicit BinaryWaveformMap(const std::string& FileName)
+      : map(MapOrThrow(FileName, size)), Header(ReadHeader(map, size)), Offsets(Header), Bytes(static_cast<const char*>(map))
+    {
+      int Error = -1;
+      if(std::memcmp(Header.Magic, BinaryWaveformMagic, sizeof(BinaryWaveformMagic))!=0) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' is not a binary Waveform file" << endl;
+        Error = GWFrames_BadFileName;
+      } else if(Header.ByteOrderMark!=BinaryWaveformByteOrderMark) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' was written with a different byte order" << endl;
+        Error = GWFrames_BadFileName;
+      } else if(Header.FormatVersion<1 || Header.FormatVersion>BinaryWaveformFormatVersion) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' has unknown format version " << Header.FormatVersion << endl;
+        Error = GWFrames_NotYetImplemented;
+      } else if(size<Offsets.LM) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' is too small to be a binary Waveform file" << endl;
+        Error = GWFrames_BadFileName;
+      } else if(Header.BytesPerReal!=sizeof(double) && Header.BytesPerReal!=sizeof(float)) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' has BytesPerReal=" << Header.BytesPerReal << endl;
+        Error = GWFrames_BadWaveformInformation;
+      } else if(Header.FrameType<0 || Header.FrameType>=int(sizeof(GWFrames::WaveformFrameNames)/sizeof(GWFrames::WaveformFrameNames[0]))
+                || Header.DataType<0 || Header.DataType>=int(sizeof(GWFrames::WaveformDataNames)/sizeof(GWFrames::WaveformDataNames[0]))) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' has FrameType=" << Header.FrameType
+             << " and DataType=" << Header.DataType << endl;
+        Error = GWFrames_BadWaveformInformation;
+      } else if(Header.NModes>uint64_t(INT_MAX) || Header.NTimes>uint64_t(INT_MAX)
+                || (Header.NFrame!=0 && Header.NFrame!=1 && Header.NFrame!=Header.NTimes)) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' has NModes=" << Header.NModes
+             << ", NTimes=" << Header.NTimes << ", and NFrame=" << Header.NFrame << endl;
+        Error = GWFrames_BadWaveformInformation;
+      } else if(Offsets.End>size) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' is truncated; expected "
+             << Offsets.End << " bytes, but found " << size << endl;
+        Error = GWFrames_BadFileName;
+      }
+      if(Error>=0) {
+        munmap(map, size);
+        throw(Error);
+      }
+    }
+    ~BinaryWaveformMap() { munmap(map, size); }
+  };
+}
+#endif // DOXYGEN
+
+/// Read data from a binary Waveform file
+void GWFrames::Waveform::ReadBinaryFile(const std::string& FileName, std::vector<std::complex<float> >* SinglePrecisionData,
+                                        const unsigned int i_t_a, unsigned int i_t_b) {
+  ///
+  /// \param FileName Relative path to data file
+  /// \param SinglePrecisionData If nonzero, the mode data are stored here instead of in `data` (used by CompactWaveform)
+  /// \param i_t_a Index of the first time to read
+  /// \param i_t_b Index one past the last time to read (or beyond the end of the file for all times)
+  ///
+  /// The file is mapped into memory, and the arrays are copied
+  /// directly into this object's storage, with no parsing.  All
+  /// quantities are stored in the native byte order of the machine
+  /// that wrote them; a byte-order mark is checked on reading.  The
+  /// file consists of the following, in order:
+  ///
+  ///   1. char[8] "GWFrames" (with no terminating null)
+  ///   2. uint32 byte-order mark 0x01020304
+  ///   3. uint32 format version (currently 2)
+  ///   4. int32[6] SpinWeight, BoostWeight, FrameType, DataType,
+  ///      RIsScaledOut, MIsScaledOut
+  ///   5. uint64[4] NModes, NTimes, NFrame, NHistory
+  ///   5a. uint32[2] BytesPerReal (8 for double or 4 for float mode
+  ///       data) and zero; absent in version 1, whose data are double
+  ///   6. int32[NModes][2] (ell,m) values of each mode
+  ///   7. char[NHistory] history text (with no terminating null)
+  ///   8. zero padding to the next multiple of 16 bytes
+  ///   9. double[NTimes] time
+  ///   10. double[NFrame][4] frame quaternions, where NFrame is 0, 1,
+  ///       or NTimes
+  ///   11. complex<double>[NModes][NTimes] or
+  ///       complex<float>[NModes][NTimes] mode data, with each mode
+  ///       contiguous in time (the same layout as the `data` member)
+  ///
+  /// The header (items 1--5a) is 80 bytes long (72 in version 1).
+  /// Time and frame data are always double precision.  Single
+  /// precision mode data are converted to double when read into a
+  /// Waveform, and double precision data are rounded when read into a
+  /// CompactWaveform.
+
+  // Map the file and check the header
+  const BinaryWaveformMap File(FileName);
+  const BinaryWaveformHeader& Header = File.Header;
+  const BinaryWaveformOffsets& Offsets = File.Offsets;
+  const char* Bytes = File.Bytes;
+  const unsigned int NModes = Header.NModes;
+  const unsigned int NTimesInFile = Header.NTimes;
+  if(i_t_b>NTimesInFile) { i_t_b = NTimesInFile; }
+  if(i_t_a>i_t_b) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Requesting times [" << i_t_a << "," << i_t_b
+         << ") from '" << FileName << "', which has " << NTimesInFile << " times" << endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  const unsigned int NTimes = i_t_b-i_t_a;
+
+  // Copy the data
+  spinweight = Header.SpinWeight;
+  boostweight = Header.BoostWeight;
+  frameType = WaveformFrameType(Header.FrameType);
+  dataType = WaveformDataType(Header.DataType);
+  rIsScaledOut = (Header.RIsScaledOut!=0);
+  mIsScaledOut = (Header.MIsScaledOut!=0);
+  {
+    history << "#### Begin Previous History\n";
+    istringstream PreviousHistory(string(Bytes+Offsets.History, Header.NHistory));
+    string Temp;
+    while(getline(PreviousHistory, Temp)) {
+      history << "#" << Temp << "\n";
+    }
+    history << "#### End Previous History\n";
+  }
+  lm = vector<vector<int> >(NModes, vector<int>(2,0));
+  for(unsigned int i_m=0; i_m<NModes; ++i_m) {
+    int32_t ellm[2];
+    std::memcpy(ellm, Bytes+Offsets.LM+2*sizeof(int32_t)*i_m, 2*sizeof(int32_t));
+    lm[i_m][0] = ellm[0];
+    lm[i_m][1] = ellm[1];
+  }
+  UpdateModeLayout();
+  t.resize(NTimes);
+  if(NTimes>0) {
+    std::memcpy(&t[0], Bytes+Offsets.T+sizeof(double)*i_t_a, sizeof(double)*NTimes);
+  }
+  const unsigned int NFrame = (Header.NFrame>1 ? NTimes : Header.NFrame);
+  const unsigned int i_f_a = (Header.NFrame>1 ? i_t_a : 0);
+  frame.resize(NFrame);
+  for(unsigned int i_f=0; i_f<NFrame; ++i_f) {
+    double R[4];
+    std::memcpy(R, Bytes+Offsets.Frame+4*sizeof(double)*(i_f_a+i_f), 4*sizeof(double));
+    frame[i_f] = Quaternion(R[0], R[1], R[2], R[3]);
+  }
+  const bool SinglePrecisionFile = (Header.BytesPerReal==sizeof(float));
+  const std::size_t InStride = 2*Header.BytesPerReal;
+  if(SinglePrecisionFile) {
+    history << "// Mode data in '" << FileName << "' were stored in single precision" << endl;
+  }
+  if(SinglePrecisionData) {
+    std::vector<std::complex<float> >& Data = *SinglePrecisionData;
+    data.resize(0, 0);
+    Data.resize(std::size_t(NModes)*NTimes);
+    for(unsigned int i_m=0; i_m<NModes && NTimes>0; ++i_m) {
+      const char* In = Bytes+Offsets.Data+InStride*(std::size_t(i_m)*NTimesInFile+i_t_a);
+      std::complex<float>* Out = &Data[std::size_t(i_m)*NTimes];
+      if(SinglePrecisionFile) {
+        std::memcpy(Out, In, sizeof(std::complex<float>)*NTimes);
+      } else {
+        for(unsigned int i=0; i<NTimes; ++i, In+=InStride) {
+          std::complex<double> z;
+          std::memcpy(&z, In, sizeof(std::complex<double>));
+          Out[i] = std::complex<float>(z);
+        }
+      }
+    }
+  } else {
+    data.resize(NModes, NTimes);
+    for(unsigned int i_m=0; i_m<NModes && NTimes>0; ++i_m) {
+      const char* In = Bytes+Offsets.Data+InStride*(std::size_t(i_m)*NTimesInFile+i_t_a);
+      std::complex<double>* Out = data[i_m];
+      if(!SinglePrecisionFile) {
+        // Each mode is contiguous in time, just like the rows of a MatrixC
+        std::memcpy(Out, In, sizeof(std::complex<double>)*NTimes);
+      } else {
+        for(unsigned int i=0; i<NTimes; ++i, In+=InStride) {
+          std::complex<float> z;
+          std::memcpy(&z, In, sizeof(std::complex<float>));
+          Out[i] = std::complex<double>(z);
+        }
+      }
+    }
+  }
+  return;
+}
+
+/// Constructor from a subset of the modes in an HDF5 file
+GWFrames::Waveform::Waveform(const std::string& FileName, const std::vector<std::vector<int> >& LM,
+                             const double t_a, const double t_b) :
+  spinweight(-2), boostweight(-1), history(History::Session()), versionHist(), t(0), frame(0), frameType(GWFrames::UnknownFrameType),
+  dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(), modeLayout(), data()
+{
+  ///
+  /// \param FileName Relative path to H5 file, optionally followed by a group, as in 'File.h5/Group'
+  /// \param LM List of [ell,m] modes to read (all modes in the file if this is empty)
+  /// \param t_a Earliest time to read
+  /// \param t_b Latest time to read
+  ///
+  /// The file is expected to be in the NRAR format written by
+  /// `OutputToNRAR` or by `Output` with a FileName containing '.h5'.
+  /// Only the requested modes and times are read from disk, so this
+  /// is much faster than reading the whole file and then taking a
+  /// slice when only a few modes are needed.
+  GWFrames_INSTRUMENT("Waveform::Waveform(FileName, LM)");
+  history << "Waveform(" << FileName << ", LM, " << setprecision(16) << t_a << ", " << t_b
+          << "); // Constructor from H5 file with " << (LM.size()==0 ? "all" : "selected") << " modes" << endl;
+  ReadH5File(FileName, LM, t_a, t_b);
+}
+
+#ifndef DOXYGEN
+namespace {
+#ifdef USE_HDF5
+  // Closes an HDF5 object when it goes out of scope
+  class H5Handle {
+  private:
+    hid_t id;
+    herr_t (*closer)(hid_t);
+    H5Handle(const H5Handle&);
+    H5Handle& operator=(const H5Handle&);
+  public:
+    H5Handle(const hid_t ID, herr_t (*Closer)(hid_t)) : id(ID), closer(Closer) { }
+    ~H5Handle() { if(id>=0) { closer(id); } }
+    operator hid_t() const { return id; }
+  };
+
+  // Negative return values from the HDF5 library indicate failure
+  template <typename T>
+  T H5Check(const T Value, const int Line, const std::string& What) {
+    if(Value<0) {
+      cerr << "\n\n" << __FILE__ << ":" << Line << ": HDF5 failure in " << What << endl;
+      throw(GWFrames_FailedSystemCall);
+    }
+    return Value;
+  }
+
+  // Split "File.h5/Group" into "File.h5" and "/Group"
+  void SplitH5FileName(const std::string& FileName, std::string& File, std::string& Group) {
+    const std::string::size_type i = H5ExtensionEnd(FileName);
+    if(i==std::string::npos) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' does not name an H5 file" << endl;
+      throw(GWFrames_BadFileName);
+    }
+    File = FileName.substr(0, i);
+    Group = FileName.substr(i);
+    if(Group.empty()) { Group = "/"; }
+  }
+
+  int ReadH5IntAttribute(const hid_t Obj, const char* Name, const int Default) {
+    if(H5Aexists(Obj, Name)<=0) { return Default; }
+    H5Handle Attr(H5Check(H5Aopen(Obj, Name, H5P_DEFAULT), __LINE__, Name), H5Aclose);
+    int Value = Default;
+    H5Check(H5Aread(Attr, H5T_NATIVE_INT, &Value), __LINE__, Name);
+    return Value;
+  }
+
+  void WriteH5IntAttribute(const hid_t Obj, const char* Name, const int Value) {
+    H5Handle Space(H5Check(H5Screate(H5S_SCALAR), __LINE__, Name), H5Sclose);
+    H5Handle Attr(H5Check(H5Acreate2(Obj, Name, H5T_NATIVE_INT, Space, H5P_DEFAULT, H5P_DEFAULT), __LINE__, Name), H5Aclose);
+    H5Check(H5Awrite(Attr, H5T_NATIVE_INT, &Value), __LINE__, Name);
+  }
+
+  // Fixed-length string type holding Value (HDF5 can't describe zero-length strings)
+  hid_t H5StringType(const std::string& Value) {
+    const hid_t Type = H5Check(H5Tcopy(H5T_C_S1), __LINE__, "H5Tcopy");
+    H5Check(H5Tset_size(Type, std::max(Value.size(), size_t(1))), __LINE__, "H5Tset_size");
+    return Type;
+  }
+
+  void WriteH5StringAttribute(const hid_t Obj, const char* Name, const std::string& Value) {
+    H5Handle Type(H5StringType(Value), H5Tclose);
+    H5Handle Space(H5Check(H5Screate(H5S_SCALAR), __LINE__, Name), H5Sclose);
+    H5Handle Attr(H5Check(H5Acreate2(Obj, Name, Type, Space, H5P_DEFAULT, H5P_DEFAULT), __LINE__, Name), H5Aclose);
+    std::string Padded(Value);
+    Padded.resize(std::max(Value.size(), size_t(1)), '\0');
+    H5Check(H5Awrite(Attr, Type, Padded.c_str()), __LINE__, Name);
+  }
+
+  // Read either a variable- or a fixed-length string dataset
+  std::string ReadH5StringDataset(const hid_t Group, const char* Name) {
+    H5Handle DataSet(H5Check(H5Dopen2(Group, Name, H5P_DEFAULT), __LINE__, Name), H5Dclose);
+    H5Handle FileType(H5Check(H5Dget_type(DataSet), __LINE__, Name), H5Tclose);
+    if(H5Tget_class(FileType)!=H5T_STRING) { return ""; }
+    H5Handle Space(H5Check(H5Dget_space(DataSet), __LINE__, Name), H5Sclose);
+    if(H5Sget_simple_extent_npoints(Space)!=1) { return ""; }
+    std::string Value;
+    if(H5Tis_variable_str(FileType)>0) {
+      H5Handle MemType(H5Check(H5Tcopy(H5T_C_S1), __LINE__, Name), H5Tclose);
+      H5Check(H5Tset_size(MemType, H5T_VARIABLE), __LINE__, Name);
+      char* Buffer = 0;
+      H5Check(H5Dread(DataSet, MemType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &Buffer), __LINE__, Name);
+      if(Buffer) { Value = Buffer; }
+      H5Dvlen_reclaim(MemType, Space, H5P_DEFAULT, &Buffer);
+    } else {
+      const size_t Size = H5Tget_size(FileType);
+      H5Handle MemType(H5Check(H5Tcopy(H5T_C_S1), __LINE__, Name), H5Tclose);
+      H5Check(H5Tset_size(MemType, Size), __LINE__, Name);
+      std::vector<char> Buffer(Size+1, '\0');
+      H5Check(H5Dread(DataSet, MemType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &Buffer[0]), __LINE__, Name);
+      Value = std::string(&Buffer[0]);
+    }
+    return Value;
+  }
+
+  // Read columns [Col0,Col0+NCols) of rows [Row0,Row0+NRows) of a 2-d dataset of doubles
+  void ReadH5Block(const hid_t DataSet, const hsize_t Row0, const hsize_t NRows,
+                   const hsize_t Col0, const hsize_t NCols, double* Buffer) {
+    H5Handle FileSpace(H5Check(H5Dget_space(DataSet), __LINE__, "H5Dget_space"), H5Sclose);
+    const hsize_t Start[2] = { Row0, Col0 };
+    const hsize_t Count[2] = { NRows, NCols };
+    H5Check(H5Sselect_hyperslab(FileSpace, H5S_SELECT_SET, Start, 0, Count, 0), __LINE__, "H5Sselect_hyperslab");
+    const hsize_t NValues = NRows*NCols;
+    H5Handle MemSpace(H5Check(H5Screate_simple(1, &NValues, 0), __LINE__, "H5Screate_simple"), H5Sclose);
+    H5Check(H5Dread(DataSet, H5T_NATIVE_DOUBLE, MemSpace, FileSpace, H5P_DEFAULT, Buffer), __LINE__, "H5Dread");
+  }
+
+  // Dimensions of a 2-d dataset; anything else is an error
+  void H5Dims2(const hid_t DataSet, const std::string& Name, hsize_t Dims[2]) {
+    H5Handle Space(H5Check(H5Dget_space(DataSet), __LINE__, Name), H5Sclose);
+    if(H5Sget_simple_extent_ndims(Space)!=2) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Dataset '" << Name << "' is not two-dimensional" << endl;
+      throw(GWFrames_BadWaveformInformation);
+    }
+    H5Sget_simple_extent_dims(Space, Dims, 0);
+  }
+#endif // USE_HDF5
+
+  // Sort (ell,m) dataset names by ell, then by m
+  struct H5ModeName {
+    int ell, m;
+    std::string Name;
+    bool operator<(const H5ModeName& b) const { return (ell<b.ell || (ell==b.ell && m<b.m)); }
+  };
+}
+#endif // DOXYGEN
+
+/// Read (part of) a Waveform from an H5 file in NRAR format
+void GWFrames::Waveform::ReadH5File(const std::string& FileName, const std::vector<std::vector<int> >& LM,
+                                    const double t_a, const double t_b) {
+  ///
+  /// \param FileName Relative path to H5 file, optionally followed by a group, as in 'File.h5/Group'
+  /// \param LM List of [ell,m] modes to read (all modes in the file if this is empty)
+  /// \param t_a Earliest time to read
+  /// \param t_b Latest time to read
+  ///
+  /// The group is expected to contain datasets named 'Y_l{ell}_m{m}.dat', each holding an
+  /// array of shape (NTimes,3) with columns [t, Re, Im], as well as (optionally) a 'Frame'
+  /// dataset, a 'History.txt' dataset, and 'FrameType', 'DataType', 'RIsScaledOut', and
+  /// 'MIsScaledOut' attributes.  The time column is read only once, from the first mode;
+  /// after that, only the hyperslabs of the requested modes and time window are read, and
+  /// they are read directly into this object's storage.
+  ///
+  /// As in `ReadFromNRAR`, times that do not increase by at least 1e-5 are dropped.
+#ifdef USE_HDF5
+  string File, GroupName;
+  SplitH5FileName(FileName, File, GroupName);
+  H5Handle FileID(H5Fopen(File.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose);
+  if(FileID<0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << File << "'" << endl;
+    throw(GWFrames_BadFileName);
+  }
+  H5Handle Group(H5Gopen2(FileID, GroupName.c_str(), H5P_DEFAULT), H5Gclose);
+  if(Group<0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open group '" << GroupName << "' in '" << File << "'" << endl;
+    throw(GWFrames_BadFileName);
+  }
+
+  // Descriptive information
+  spinweight = ReadH5IntAttribute(Group, "SpinWeight", spinweight);
+  boostweight = ReadH5IntAttribute(Group, "BoostWeight", boostweight);
+  const int FrameTypeInt = ReadH5IntAttribute(Group, "FrameType", GWFrames::UnknownFrameType);
+  const int DataTypeInt = ReadH5IntAttribute(Group, "DataType", GWFrames::UnknownDataType);
+  if(FrameTypeInt<0 || FrameTypeInt>=int(sizeof(WaveformFrameNames)/sizeof(WaveformFrameNames[0]))
+     || DataTypeInt<0 || DataTypeInt>=int(sizeof(WaveformDataNames)/sizeof(WaveformDataNames[0]))) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' has FrameType=" << FrameTypeInt
+         << " and DataType=" << DataTypeInt << endl;
+    throw(GWFrames_BadWaveformInformation);
+  }
+  frameType = WaveformFrameType(FrameTypeInt);
+  dataType = WaveformDataType(DataTypeInt);
+  rIsScaledOut = (ReadH5IntAttribute(Group, "RIsScaledOut", 0)!=0);
+  mIsScaledOut = (ReadH5IntAttribute(Group, "MIsScaledOut", 0)!=0);
+  const int BytesPerReal = ReadH5IntAttribute(Group, "BytesPerReal", sizeof(double));
+  CheckBytesPerReal(BytesPerReal, FileName);
+  if(H5Lexists(Group, "History.txt", H5P_DEFAULT)>0) {
+    history << "#### Begin Previous History\n";
+    istringstream PreviousHistory(ReadH5StringDataset(Group, "History.txt"));
+    string Temp;
+    while(getline(PreviousHistory, Temp)) {
+      history << "#" << Temp << "\n";
+    }
+    history << "#### End Previous History\n";
+  }
+  if(BytesPerReal==int(sizeof(float))) {
+    history << "// Mode data in '" << FileName << "' were stored in single precision" << endl;
+  }
+
+  // Find the mode datasets, and select the requested ones in order
+  vector<H5ModeName> Modes;
+  {
+    H5G_info_t GroupInfo;
+    H5Check(H5Gget_info(Group, &GroupInfo), __LINE__, "H5Gget_info");
+    for(hsize_t i=0; i<GroupInfo.nlinks; ++i) {
+      const ssize_t Size = H5Check(H5Lget_name_by_idx(Group, ".", H5_INDEX_NAME, H5_ITER_INC, i, 0, 0, H5P_DEFAULT),
+                                   __LINE__, "H5Lget_name_by_idx");
+      vector<char> Name(Size+1, '\0');
+      H5Lget_name_by_idx(Group, ".", H5_INDEX_NAME, H5_ITER_INC, i, &Name[0], Size+1, H5P_DEFAULT);
+      H5ModeName Mode;
+      char Tail[5] = { '\0' };
+      if(std::sscanf(&Name[0], "Y_l%d_m%d%4s", &Mode.ell, &Mode.m, Tail)==3 && string(Tail)==".dat") {
+        Mode.Name = &Name[0];
+        if(LM.size()==0) {
+          Modes.push_back(Mode);
+        } else {
+          for(unsigned int i_m=0; i_m<LM.size(); ++i_m) {
+            if(LM[i_m].size()==2 && LM[i_m][0]==Mode.ell && LM[i_m][1]==Mode.m) {
+              Modes.push_back(Mode);
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+  if(Modes.size()==0 || (LM.size()>0 && Modes.size()!=LM.size())) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Found " << Modes.size() << " of the "
+         << LM.size() << " requested modes in '" << FileName << "'" << endl;
+    throw(GWFrames_WaveformMissingLMIndex);
+  }
+  std::sort(Modes.begin(), Modes.end());
+  const unsigned int NModes = Modes.size();
+
+  // Read the full time column once, and find the requested window
+  hsize_t Dims[2];
+  {
+    H5Handle DataSet(H5Check(H5Dopen2(Group, Modes[0].Name.c_str(), H5P_DEFAULT), __LINE__, Modes[0].Name), H5Dclose);
+    H5Dims2(DataSet, Modes[0].Name, Dims);
+    if(Dims[1]!=3) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Dataset '" << Modes[0].Name << "' has " << Dims[1]
+           << " columns, rather than [t, Re, Im]" << endl;
+      throw(GWFrames_BadWaveformInformation);
+    }
+    t.resize(Dims[0]);
+    if(Dims[0]>0) { ReadH5Block(DataSet, 0, Dims[0], 0, 1, &t[0]); }
+  }
+
+  // Keep only the times that increase monotonically (discarding the
+  // earlier segment wherever the time jumps backwards, as happens
+  // when a simulation is restarted) and lie in [t_a,t_b]
+  vector<unsigned int> Indices;
+  {
+    const double MinTimeStep = 1e-5;
+    for(unsigned int i_t=0; i_t<t.size(); ++i_t) {
+      while(Indices.size()>0 && t[Indices.back()]+MinTimeStep>=t[i_t]) { Indices.pop_back(); }
+      Indices.push_back(i_t);
+    }
+    vector<unsigned int> InWindow;
+    for(unsigned int i=0; i<Indices.size(); ++i) {
+      if(t[Indices[i]]>=t_a && t[Indices[i]]<=t_b) { InWindow.push_back(Indices[i]); }
+    }
+    Indices.swap(InWindow);
+  }
+  if(Indices.size()==0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": No times in '" << FileName << "' between "
+         << t_a << " and " << t_b << endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+  const unsigned int NTimes = Indices.size();
+  const hsize_t Row0 = Indices[0];
+  const hsize_t NRows = Indices.back()-Indices[0]+1;
+  const bool Contiguous = (NRows==NTimes);
+  {
+    vector<double> NewT(NTimes);
+    for(unsigned int i=0; i<NTimes; ++i) { NewT[i] = t[Indices[i]]; }
+    t.swap(NewT);
+  }
+
+  // Read just the requested blocks of the mode data
+  lm = vector<vector<int> >(NModes, vector<int>(2,0));
+  data.resize(NModes, NTimes);
+  vector<complex<double> > Buffer(Contiguous ? 0 : NRows);
+  for(unsigned int i_m=0; i_m<NModes; ++i_m) {
+    lm[i_m][0] = Modes[i_m].ell;
+    lm[i_m][1] = Modes[i_m].m;
+    H5Handle DataSet(H5Check(H5Dopen2(Group, Modes[i_m].Name.c_str(), H5P_DEFAULT), __LINE__, Modes[i_m].Name), H5Dclose);
+    hsize_t ModeDims[2];
+    H5Dims2(DataSet, Modes[i_m].Name, ModeDims);
+    if(ModeDims[0]!=Dims[0] || ModeDims[1]!=Dims[1]) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Dataset '" << Modes[i_m].Name << "' has shape ("
+           << ModeDims[0] << "," << ModeDims[1] << "), but '" << Modes[0].Name << "' has shape ("
+           << Dims[0] << "," << Dims[1] << ")" << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    // complex<double> is guaranteed to be laid out as two doubles
+    if(Contiguous) {
+      ReadH5Block(DataSet, Row0, NRows, 1, 2, reinterpret_cast<double*>(data[i_m]));
+    } else {
+      ReadH5Block(DataSet, Row0, NRows, 1, 2, reinterpret_cast<double*>(&Buffer[0]));
+      for(unsigned int i=0; i<NTimes; ++i) { data[i_m][i] = Buffer[Indices[i]-Row0]; }
+    }
+  }
+  UpdateModeLayout();
+
+  // Read the frame, if present
+  if(H5Lexists(Group, "Frame", H5P_DEFAULT)>0) {
+    H5Handle DataSet(H5Check(H5Dopen2(Group, "Frame", H5P_DEFAULT), __LINE__, "Frame"), H5Dclose);
+    hsize_t FrameDims[2];
+    H5Dims2(DataSet, "Frame", FrameDims);
+    if(FrameDims[1]!=4 || (FrameDims[0]!=1 && FrameDims[0]!=Dims[0])) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Dataset 'Frame' has shape (" << FrameDims[0] << ","
+           << FrameDims[1] << "), but there are " << Dims[0] << " times" << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    if(FrameDims[0]==1) {
+      double R[4];
+      ReadH5Block(DataSet, 0, 1, 0, 4, R);
+      frame = vector<Quaternion>(1, Quaternion(R[0], R[1], R[2], R[3]));
+    } else {
+      vector<double> R(4*NRows);
+      ReadH5Block(DataSet, Row0, NRows, 0, 4, &R[0]);
+      frame.resize(NTimes);
+      for(unsigned int i=0; i<NTimes; ++i) {
+        const unsigned int j = 4*(Indices[i]-Row0);
+        frame[i] = Quaternion(R[j], R[j+1], R[j+2], R[j+3]);
+      }
+    }
+  }
+
+#else // USE_HDF5
+  (void)LM; (void)t_a; (void)t_b;
+  cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Reading '" << FileName << "' requires HDF5.\n"
+       << "Recompile with HDF5_HOME set to enable it." << endl;
+  throw(GWFrames_NotYetImplemented);
+#endif // USE_HDF5
+  return;
+}
+
+#ifndef DOXYGEN
+namespace {
+  // Times that ReadH5File would read from the whole file, found from
+  // the time column of one mode dataset without reading any mode data
+  std::vector<double> ReadH5Times(const std::string& FileName) {
+    vector<double> T;
+#ifdef USE_HDF5
+    string File, GroupName;
+    SplitH5FileName(FileName, File, GroupName);
+    H5Handle FileID(H5Fopen(File.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose);
+    if(FileID<0) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << File << "'" << endl;
+      throw(GWFrames_BadFileName);
+    }
+    H5Handle Group(H5Gopen2(FileID, GroupName.c_str(), H5P_DEFAULT), H5Gclose);
+    if(Group<0) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open group '" << GroupName << "' in '" << File << "'" << endl;
+      throw(GWFrames_BadFileName);
+    }
+    H5G_info_t GroupInfo;
+    H5Check(H5Gget_info(Group, &GroupInfo), __LINE__, "H5Gget_info");
+    for(hsize_t i=0; i<GroupInfo.nlinks; ++i) {
+      const ssize_t Size = H5Check(H5Lget_name_by_idx(Group, ".", H5_INDEX_NAME, H5_ITER_INC, i, 0, 0, H5P_DEFAULT),
+                                   __LINE__, "H5Lget_name_by_idx");
+      vector<char> Name(Size+1, '\0');
+      H5Lget_name_by_idx(Group, ".", H5_INDEX_NAME, H5_ITER_INC, i, &Name[0], Size+1, H5P_DEFAULT);
+      int ell, m;
+      char Tail[5] = { '\0' };
+      if(std::sscanf(&Name[0], "Y_l%d_m%d%4s", &ell, &m, Tail)!=3 || string(Tail)!=".dat") { continue; }
+      H5Handle DataSet(H5Check(H5Dopen2(Group, &Name[0], H5P_DEFAULT), __LINE__, &Name[0]), H5Dclose);
+      hsize_t Dims[2];
+      H5Dims2(DataSet, &Name[0], Dims);
+      vector<double> AllT(Dims[0]);
+      if(Dims[0]>0) { ReadH5Block(DataSet, 0, Dims[0], 0, 1, &AllT[0]); }
+      // The same selection of monotonic times as in ReadH5File
+      const double MinTimeStep = 1e-5;
+      for(unsigned int i_t=0; i_t<AllT.size(); ++i_t) {
+        while(T.size()>0 && T.back()+MinTimeStep>=AllT[i_t]) { T.pop_back(); }
+        T.push_back(AllT[i_t]);
+      }
+      return T;
+    }
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Found no mode datasets in '" << FileName << "'" << endl;
+    throw(GWFrames_WaveformMissingLMIndex);
+#else // USE_HDF5
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Reading '" << FileName << "' requires HDF5.\n"
+         << "Recompile with HDF5_HOME set to enable it." << endl;
+    throw(GWFrames_NotYetImplemented);
+#endif // USE_HDF5
+    return T;
+  }
 }
+#endif // DOXYGEN
 
 /// Assignment operator
 GWFrames::Waveform& GWFrames::Waveform::operator=(const GWFrames::Waveform& a) {
   spinweight = a.spinweight;
   boostweight = a.boostweight;
-  history.str(a.history.str());
-  history.clear();
-  history.seekp(0, ios_base::end);
+  history = a.history;
   versionHist = a.versionHist;
   t = a.t;
   frame = a.frame;
@@ -278,18 +986,40 @@ GWFrames::Waveform& GWFrames::Waveform::operator=(const GWFrames::Waveform& a) {
   rIsScaledOut = a.rIsScaledOut;
   mIsScaledOut = a.mIsScaledOut;
   lm = a.lm;
+  modeLayout = a.modeLayout;
   data = a.data;
   return *this;
 }
 
+#ifdef GWFrames_MoveSemantics
+/// Move assignment operator
+GWFrames::Waveform& GWFrames::Waveform::operator=(GWFrames::Waveform&& a) {
+  if(this != &a) {
+    spinweight = a.spinweight;
+    boostweight = a.boostweight;
+    history = std::move(a.history);
+    versionHist = std::move(a.versionHist);
+    t = std::move(a.t);
+    frame = std::move(a.frame);
+    frameType = a.frameType;
+    dataType = a.dataType;
+    rIsScaledOut = a.rIsScaledOut;
+    mIsScaledOut = a.mIsScaledOut;
+    lm = std::move(a.lm);
+    modeLayout = a.modeLayout;
+    a.modeLayout = ModeLayout();
+    data = std::move(a.data);
+  }
+  return *this;
+}
+#endif // GWFrames_MoveSemantics
+
 /// Copy the Waveform, except for the data (t, frame, lm, data)
 GWFrames::Waveform GWFrames::Waveform::CopyWithoutData() const {
   Waveform that;
   that.spinweight = (*this).spinweight;
   that.boostweight = (*this).boostweight;
-  that.history.str((*this).history.str());
-  that.history.clear();
-  that.history.seekp(0, ios_base::end);
+  that.history = (*this).history;
   that.versionHist = (*this).versionHist;
   that.frameType = (*this).frameType;
   that.dataType = (*this).dataType;
@@ -328,6 +1058,7 @@ GWFrames::Waveform GWFrames::Waveform::SliceOfTimeIndices(const unsigned int i_t
   Waveform Slice = this->CopyWithoutData();
   Slice.history << "this->SliceOfTimeIndices(" << i_t_a << ", " << i_t_b << ");" << std::endl;
   Slice.lm = lm;
+  Slice.modeLayout = modeLayout;
   const unsigned int ntimes = i_t_b-i_t_a;
   const unsigned int nmodes = NModes();
   Slice.data.resize(nmodes, ntimes);
@@ -387,6 +1118,7 @@ GWFrames::Waveform GWFrames::Waveform::SliceOfTimeIndicesWithEll2(const unsigned
       Slice.data[m+2][i_t] = data[i_m][i_t+i_t_a];
     }
   }
+  Slice.UpdateModeLayout();
   if(frame.size() == NTimes()) {
     Slice.frame = vector<Quaternion>(frame.begin()+i_t_a, frame.begin()+i_t_b);
   } else if(frame.size()==1) {
@@ -434,6 +1166,153 @@ GWFrames::Waveform GWFrames::Waveform::SliceOfTimesWithoutModes(const double t_a
   return this->SliceOfTimeIndicesWithoutModes(i_t_a, i_t_b);
 }
 
+/// View of the whole Waveform without copying any data
+GWFrames::WaveformView GWFrames::Waveform::View() const {
+  return WaveformView(*this);
+}
+
+/// View of the Waveform between indices i_t_a and i_t_b without copying any data
+GWFrames::WaveformView GWFrames::Waveform::ViewOfTimeIndices(const unsigned int i_t_a, const unsigned int i_t_b) const {
+  return WaveformView(*this, i_t_a, i_t_b);
+}
+
+/// View of the Waveform between t_a and t_b without copying any data
+GWFrames::WaveformView GWFrames::Waveform::ViewOfTimes(const double t_a, const double t_b) const {
+  const unsigned int i_t_a = Quaternions::hunt(t, t_a);
+  const unsigned int i_t_b = Quaternions::huntRight(t, t_b, i_t_a);
+  return WaveformView(*this, i_t_a, i_t_b);
+}
+
+
+/// View all times and modes of the Waveform
+GWFrames::WaveformView::WaveformView(const GWFrames::Waveform& W)
+  : parent(&W), i_t_a(0), i_t_b(W.NTimes()), modes(W.NModes())
+{
+  for(unsigned int i_m=0; i_m<modes.size(); ++i_m) { modes[i_m] = i_m; }
+}
+
+/// View all modes of the Waveform between time indices i_t_a and i_t_b
+GWFrames::WaveformView::WaveformView(const GWFrames::Waveform& W, const unsigned int I_t_a, const unsigned int I_t_b)
+  : parent(&W), i_t_a(I_t_a), i_t_b(I_t_b), modes(W.NModes())
+{
+  ///
+  /// \param W Waveform to be viewed
+  /// \param I_t_a Index of initial time
+  /// \param I_t_b Index just beyond final time
+  ///
+  if(i_t_a>i_t_b) {
+    INFOTOCERR << ": Requesting impossible view"
+               << "\ni_t_a=" << i_t_a << "  >  i_t_b=" << i_t_b << std::endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+  if(i_t_b>W.NTimes()) {
+    INFOTOCERR << ": Requesting impossible view"
+               << "\ni_t_b=" << i_t_b << "  >  NTimes()=" << W.NTimes() << std::endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  for(unsigned int i_m=0; i_m<modes.size(); ++i_m) { modes[i_m] = i_m; }
+}
+
+/// View the given modes of the Waveform between time indices i_t_a and i_t_b
+GWFrames::WaveformView::WaveformView(const GWFrames::Waveform& W, const unsigned int I_t_a, const unsigned int I_t_b,
+                                     const std::vector<unsigned int>& ModeIndices)
+  : parent(&W), i_t_a(I_t_a), i_t_b(I_t_b), modes(ModeIndices)
+{
+  ///
+  /// \param W Waveform to be viewed
+  /// \param I_t_a Index of initial time
+  /// \param I_t_b Index just beyond final time
+  /// \param ModeIndices Indices (in `W`) of the modes to be viewed
+  ///
+  if(i_t_a>i_t_b) {
+    INFOTOCERR << ": Requesting impossible view"
+               << "\ni_t_a=" << i_t_a << "  >  i_t_b=" << i_t_b << std::endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+  if(i_t_b>W.NTimes()) {
+    INFOTOCERR << ": Requesting impossible view"
+               << "\ni_t_b=" << i_t_b << "  >  NTimes()=" << W.NTimes() << std::endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  for(unsigned int i_m=0; i_m<modes.size(); ++i_m) {
+    if(modes[i_m]>=W.NModes()) {
+      INFOTOCERR << ": Requesting mode index " << modes[i_m] << " in a Waveform with " << W.NModes() << " modes." << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+  }
+}
+
+/// View of this view between (view) indices i_t_a and i_t_b
+GWFrames::WaveformView GWFrames::WaveformView::ViewOfTimeIndices(const unsigned int I_t_a, const unsigned int I_t_b) const {
+  if(I_t_a>I_t_b || I_t_b>NTimes()) {
+    INFOTOCERR << ": Requesting impossible view"
+               << "\n[i_t_a,i_t_b)=[" << I_t_a << "," << I_t_b << ") of a view with " << NTimes() << " times." << std::endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  return WaveformView(*parent, i_t_a+I_t_a, i_t_a+I_t_b, modes);
+}
+
+/// View of this view between t_a and t_b
+GWFrames::WaveformView GWFrames::WaveformView::ViewOfTimes(const double t_a, const double t_b) const {
+  const std::vector<double>& t = parent->T();
+  const unsigned int I_t_a = std::max(Quaternions::hunt(t, t_a), i_t_a);
+  const unsigned int I_t_b = std::min(Quaternions::huntRight(t, t_b, I_t_a), i_t_b);
+  return WaveformView(*parent, I_t_a, std::max(I_t_a, I_t_b), modes);
+}
+
+/// View of only those modes with ell in the given list
+GWFrames::WaveformView GWFrames::WaveformView::ViewOfEllModes(const std::vector<int>& Lmodes) const {
+  std::vector<unsigned int> NewModes;
+  for(unsigned int i_m=0; i_m<modes.size(); ++i_m) {
+    if(std::find(Lmodes.begin(), Lmodes.end(), LM(i_m)[0]) != Lmodes.end()) {
+      NewModes.push_back(modes[i_m]);
+    }
+  }
+  return WaveformView(*parent, i_t_a, i_t_b, NewModes);
+}
+
+/// Copy the viewed data into an independent Waveform
+GWFrames::Waveform GWFrames::WaveformView::Copy() const {
+  Waveform Slice = parent->CopyWithoutData();
+  Slice.history << "this->View(" << i_t_a << ", " << i_t_b << ", [" << modes.size() << " modes]).Copy();" << std::endl;
+  const unsigned int ntimes = NTimes();
+  const unsigned int nmodes = NModes();
+  Slice.lm.resize(nmodes);
+  Slice.data.resize(nmodes, ntimes);
+  for(unsigned int i_m=0; i_m<nmodes; ++i_m) {
+    Slice.lm[i_m] = LM(i_m);
+    const std::complex<double>* D = (*this)(i_m);
+    std::copy(D, D+ntimes, Slice.data[i_m]);
+  }
+  Slice.UpdateModeLayout();
+  if(parent->frame.size() == parent->NTimes()) {
+    Slice.frame = vector<Quaternion>(parent->frame.begin()+i_t_a, parent->frame.begin()+i_t_b);
+  } else if(parent->frame.size()==1) {
+    Slice.frame = parent->frame;
+  } else if(parent->frame.size()!=0) {
+    INFOTOCERR << " I don't understand what to do with frame data of length " << parent->frame.size() << " in a Waveform with " << parent->NTimes() << " times." << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  Slice.t = T();
+  return Slice;
+}
+
+/// Find index (in the view) of mode with given (l,m) data.
+unsigned int GWFrames::WaveformView::FindModeIndex(const int l, const int m) const {
+  for(unsigned int i=0; i<NModes(); ++i) {
+    const std::vector<int>& LM_i = LM(i);
+    if(LM_i[0]==l && LM_i[1]==m) { return i; }
+  }
+  INFOTOCERR << " Can't find (ell,m)=(" << l << ", " << m << ")" << endl;
+  throw(GWFrames_WaveformMissingLMIndex);
+}
+
+/// Return time derivative of viewed data
+std::vector<std::complex<double> > GWFrames::WaveformView::DataDot(const unsigned int Mode) const {
+  const std::complex<double>* D = (*this)(Mode);
+  return ComplexDerivative(vector<std::complex<double> >(D,D+NTimes()), T());
+}
+
 /// Remove all data relating to times outside of the given range
 GWFrames::Waveform& GWFrames::Waveform::DropTimesOutside(const double t_a, const double t_b) {
   history << "this->DropTimesOutside(" << t_a << ", " << t_b << ");" << std::endl;
@@ -481,6 +1360,7 @@ GWFrames::Waveform& GWFrames::Waveform::DropEllModes(const std::vector<unsigned
     }
   }
   lm = newlm;
+  UpdateModeLayout();
   vector<vector<complex<double> > > NewData(IndicesToKeep.size(), vector<complex<double> >(NTimes()));
   for(unsigned int i_m=0; i_m<IndicesToKeep.size(); ++i_m) {
     NewData[i_m] = Data(IndicesToKeep[i_m]);
@@ -508,6 +1388,7 @@ GWFrames::Waveform& GWFrames::Waveform::KeepOnlyEllModes(const std::vector<unsig
     }
   }
   lm = newlm;
+  UpdateModeLayout();
   vector<vector<complex<double> > > NewData(IndicesToKeep.size(), vector<complex<double> >(NTimes()));
   for(unsigned int i_m=0; i_m<IndicesToKeep.size(); ++i_m) {
     NewData[i_m] = Data(IndicesToKeep[i_m]);
@@ -532,9 +1413,7 @@ void GWFrames::Waveform::swap(GWFrames::Waveform& b) {
   // because the histories are swapped
   { const int NewSpinWeight=b.spinweight; b.spinweight=spinweight; spinweight=NewSpinWeight; }
   { const int NewBoostWeight=b.boostweight; b.boostweight=boostweight; boostweight=NewBoostWeight; }
-  { const string historyb=b.history.str(); b.history.str(history.str()); history.str(historyb); }
-  history.seekp(0, ios_base::end);
-  b.history.seekp(0, ios_base::end);
+  history.swap(b.history);
   versionHist.swap(b.versionHist);
   t.swap(b.t);
   frame.swap(b.frame);
@@ -543,6 +1422,7 @@ void GWFrames::Waveform::swap(GWFrames::Waveform& b) {
   { const bool brIsScaledOut=b.rIsScaledOut; b.rIsScaledOut=rIsScaledOut; rIsScaledOut=brIsScaledOut; }
   { const bool bmIsScaledOut=b.mIsScaledOut; b.mIsScaledOut=mIsScaledOut; mIsScaledOut=bmIsScaledOut; }
   lm.swap(b.lm);
+  std::swap(modeLayout, b.modeLayout);
   data.swap(b.data);
   return;
 }
@@ -551,8 +1431,8 @@ void GWFrames::Waveform::swap(GWFrames::Waveform& b) {
 /// Explicit constructor from data
 GWFrames::Waveform::Waveform(const std::vector<double>& T, const std::vector<std::vector<int> >& LM,
                              const std::vector<std::vector<std::complex<double> > >& Data)
-  : spinweight(-2), boostweight(-1), history(""), t(T), frame(), frameType(GWFrames::UnknownFrameType),
-    dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(LM), data(Data)
+  : spinweight(-2), boostweight(-1), history(), t(T), frame(), frameType(GWFrames::UnknownFrameType),
+    dataType(GWFrames::UnknownDataType), rIsScaledOut(false), mIsScaledOut(false), lm(LM), modeLayout(LM), data(Data)
 {
   /// Arguments are T, LM, Data, which consist of the explicit data.
 
@@ -584,11 +1464,10 @@ GWFrames::Waveform& GWFrames::Waveform::Differentiate() {
     throw(GWFrames_NotYetImplemented);
   }
 
-  vector<vector<complex<double> > > NewData(NModes(), vector<complex<double> >(NTimes()));
-  for(unsigned int i_m=0; i_m<NModes(); ++i_m) {
-    NewData[i_m] = DataDot(i_m);
-  }
-  data = MatrixC(NewData);
+  // Differentiate all the modes at once, with one set of stencil weights
+  MatrixC NewData;
+  DerivativePlan(t).Differentiate(data, NewData);
+  data.swap(NewData);
 
   boostweight -= 1;
   if(dataType == GWFrames::h) {
@@ -603,31 +1482,131 @@ GWFrames::Waveform& GWFrames::Waveform::Differentiate() {
   return *this;
 }
 
-/// Return the norm (sum of squares of modes) of the waveform
-std::vector<double> GWFrames::Waveform::Norm(const bool TakeSquareRoot) const {
-  ///
-  /// \param TakeSquareRoot If true, the square root is taken at each instant before returning
-  ///
-  /// This returns the norm of the waveform, defined as the sum of the
-  /// complex norms of the modes.  Note that we are calling this norm
-  /// in analogy with the c++ std::complex norm, which is the square
-  /// of the absolute value.  However, there is also an option to take
-  /// the square root of the data at each time step, which would be
-  /// the usual L2 norm of the waveform.
-  ///
-  /// \sa MaxNormIndex
-  /// \sa MaxNormTime
-  ///
-  vector<double> norm(NTimes(), 0.0);
-  for(unsigned int i_t=0; i_t<NTimes(); ++i_t) {
-    for(unsigned int i_m=0; i_m<NModes(); ++i_m) {
-      norm[i_t] += std::norm(Data(i_m, i_t));
+#ifndef DOXYGEN
+namespace {
+  // Number of time steps each thread processes together in the
+  // reductions over the modes (Norm, the involution violations, and
+  // the dipole moment)
+  const int DiagnosticsBlockSize = 256;
+
+  // Mode iA is compared with Sign times the conjugate of mode iB
+  struct InvolutionTerm {
+    unsigned int iA, iB;
+    double Sign;
+  };
+
+  // Mode iA times the conjugate of mode iB, weighted into each
+  // component of the dipole moment: x gets cx*Re, y gets cy*Im, and
+  // z gets cz*Re
+  struct DipoleTerm {
+    unsigned int iA, iB;
+    double cx, cy, cz;
+  };
+
+  // The following loops treat the complex data as interleaved real
+  // and imaginary parts, so that the compiler can vectorize them
+
+  // v[i] += |F[i]|^2
+  inline void AccumulateNorm(const complex<double>* F, double* v, const int n) {
+    const double* f = reinterpret_cast<const double*>(F);
+    for(int i=0; i<n; ++i) {
+      v[i] += f[2*i]*f[2*i] + f[2*i+1]*f[2*i+1];
     }
-    if(TakeSquareRoot) {
-      norm[i_t] = std::sqrt(norm[i_t]);
+  }
+  inline void AccumulateNorm(const complex<float>* F, double* v, const int n) {
+    const float* f = reinterpret_cast<const float*>(F);
+    for(int i=0; i<n; ++i) {
+      const double re = f[2*i], im = f[2*i+1];
+      v[i] += re*re + im*im;
     }
   }
-  return norm;
+
+  // v[i] += |A[i] - Sign*conj(B[i])|^2 / 4
+  inline void AccumulateInvolutionViolation(const complex<double>* A, const complex<double>* B, const double Sign, double* v, const int n) {
+    const double* a = reinterpret_cast<const double*>(A);
+    const double* b = reinterpret_cast<const double*>(B);
+    for(int i=0; i<n; ++i) {
+      const double re = a[2*i] - Sign*b[2*i];
+      const double im = a[2*i+1] + Sign*b[2*i+1];
+      v[i] += 0.25*(re*re + im*im);
+    }
+  }
+
+  // d[3*i+j] += component j of Term at time i
+  inline void AccumulateDipole(const complex<double>* A, const complex<double>* B, const DipoleTerm& Term, double* d, const int n) {
+    const double* a = reinterpret_cast<const double*>(A);
+    const double* b = reinterpret_cast<const double*>(B);
+    const double cx = Term.cx, cy = Term.cy, cz = Term.cz;
+    for(int i=0; i<n; ++i) {
+      const double re = a[2*i]*b[2*i] + a[2*i+1]*b[2*i+1];
+      const double im = a[2*i+1]*b[2*i] - a[2*i]*b[2*i+1];
+      d[3*i] += cx*re;
+      d[3*i+1] += cy*im;
+      d[3*i+2] += cz*re;
+    }
+  }
+
+  // Shared by Waveform, WaveformView, and CompactWaveform; times
+  // before i_t_a are left as 0
+  template <typename WaveformType>
+  std::vector<double> NormOfModes(const WaveformType& W, const bool TakeSquareRoot, const unsigned int i_t_a=0) {
+    const int NTimes = W.NTimes();
+    const int NModes = W.NModes();
+    vector<double> norm(NTimes, 0.0);
+    const int NBlocks = (NTimes-int(i_t_a)+DiagnosticsBlockSize-1)/DiagnosticsBlockSize;
+    #pragma omp parallel for schedule(static) if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+    for(int i_b=0; i_b<NBlocks; ++i_b) {
+      const int i_t_0 = i_t_a+i_b*DiagnosticsBlockSize;
+      const int n = std::min(DiagnosticsBlockSize, NTimes-i_t_0);
+      double* v = &norm[i_t_0];
+      for(int i_m=0; i_m<NModes; ++i_m) {
+        AccumulateNorm(W(i_m)+i_t_0, v, n);
+      }
+      if(TakeSquareRoot) {
+        for(int i=0; i<n; ++i) {
+          v[i] = std::sqrt(v[i]);
+        }
+      }
+    }
+    return norm;
+  }
+
+  // Index of the largest norm at or after StartIndex
+  unsigned int IndexOfMaxNorm(const vector<double>& norm, const unsigned int StartIndex) {
+    unsigned int index = StartIndex;
+    double max = norm[index];
+    for(unsigned int i_t=StartIndex+1; i_t<norm.size(); ++i_t) {
+      if(norm[i_t]>max) {
+        index = i_t;
+        max = norm[index];
+      }
+    }
+    return index;
+  }
+}
+#endif // DOXYGEN
+
+/// Return the norm (sum of squares of modes) of the waveform
+std::vector<double> GWFrames::Waveform::Norm(const bool TakeSquareRoot) const {
+  ///
+  /// \param TakeSquareRoot If true, the square root is taken at each instant before returning
+  ///
+  /// This returns the norm of the waveform, defined as the sum of the
+  /// complex norms of the modes.  Note that we are calling this norm
+  /// in analogy with the c++ std::complex norm, which is the square
+  /// of the absolute value.  However, there is also an option to take
+  /// the square root of the data at each time step, which would be
+  /// the usual L2 norm of the waveform.
+  ///
+  /// \sa MaxNormIndex
+  /// \sa MaxNormTime
+  ///
+  return NormOfModes(*this, TakeSquareRoot);
+}
+
+/// Return the norm (sum of squares of modes) of the viewed data
+std::vector<double> GWFrames::WaveformView::Norm(const bool TakeSquareRoot) const {
+  return NormOfModes(*this, TakeSquareRoot);
 }
 
 /// Return the data index corresponding to the time of the largest norm
@@ -640,20 +1619,14 @@ unsigned int GWFrames::Waveform::MaxNormIndex(const unsigned int SkipFraction) c
   /// out junk radiation.  Note that this is integer division, so an
   /// argument of `NTimes()+1` will look through all of the data.
   ///
+  /// Only the norms at the times searched are computed.
+  ///
   /// \sa Norm()
   /// \sa MaxNormTime()
   ///
   const unsigned int StartIndex = NTimes()/SkipFraction;
-  const vector<double> norm = Norm(false); // don't bother taking the square root
-  unsigned int index = StartIndex;
-  double max = norm[index];
-  for(unsigned int i_t=StartIndex+1; i_t<NTimes(); ++i_t) {
-    if(norm[i_t]>max) {
-      index = i_t;
-      max = norm[index];
-    }
-  }
-  return index;
+  const vector<double> norm = NormOfModes(*this, false, StartIndex); // don't bother taking the square root
+  return IndexOfMaxNorm(norm, StartIndex);
 }
 
 // Return a descriptive string appropriate for a file name, like rhOverM.
@@ -820,6 +1793,56 @@ std::vector<std::vector<std::complex<double> > > GWFrames::Waveform::Data() cons
 }
 
 
+/// Empty layout
+GWFrames::ModeLayout::ModeLayout()
+  : nModes(0), ellMin(0), ellMax(-1), canonical(true), completeElls(true), index()
+{ }
+
+/// Build the lookup table for the given (ell,m) data
+GWFrames::ModeLayout::ModeLayout(const std::vector<std::vector<int> >& LM)
+  : nModes(LM.size()), ellMin(0), ellMax(-1), canonical(true), completeElls(true), index()
+{
+  ///
+  /// \param LM Vector of (ell,m) pairs, as stored in a Waveform
+  ///
+  /// The table has one entry for each (ell,m) with ell between the
+  /// smallest and largest ell values present.  If a mode appears more
+  /// than once, the first index is used, as a linear search would
+  /// find.  Entries with |m|>ell are not indexed.
+  if(nModes==0) { return; }
+  ellMin = LM[0][0];
+  ellMax = LM[0][0];
+  for(unsigned int i=1; i<nModes; ++i) {
+    ellMin = std::min(ellMin, LM[i][0]);
+    ellMax = std::max(ellMax, LM[i][0]);
+  }
+  ellMin = std::max(ellMin, 0);
+  const unsigned int NIndices = (ellMax+1)*(ellMax+1) - ellMin*ellMin;
+  index.assign(NIndices, -1);
+  unsigned int NIndexed = 0;
+  for(unsigned int i=0; i<nModes; ++i) {
+    const int ell = LM[i][0];
+    const int m = LM[i][1];
+    if(ell<ellMin || m<-ell || m>ell) {
+      canonical = false;
+      continue;
+    }
+    const unsigned int j = ell*(ell+1) + m - ellMin*ellMin;
+    if(j!=i) { canonical = false; }
+    if(index[j]<0) {
+      index[j] = i;
+      ++NIndexed;
+    } else {
+      canonical = false;
+    }
+  }
+  completeElls = (NIndexed==nModes && NIndexed==NIndices);
+  canonical = (canonical && completeElls);
+  if(canonical) { // Index() uses arithmetic in this case
+    std::vector<int>().swap(index);
+  }
+}
+
 /// Return greatest ell value present in the data.
 int GWFrames::Waveform::EllMax() const {
   int ell = lm[0][0];
@@ -831,14 +1854,8 @@ int GWFrames::Waveform::EllMax() const {
 
 /// Find index of mode with given (l,m) data.
 unsigned int GWFrames::Waveform::FindModeIndex(const int l, const int m) const {
-  const unsigned int i_expected = l*(l+1) + m - SpinWeight()*SpinWeight();
-  if (lm.size() > i_expected) {
-    if(lm[i_expected][0]==l && lm[i_expected][1]==m) { return i_expected; }
-  }
-  //ORIENTATION!!! following loop
-  for(unsigned int i=0; i<NModes(); ++i) {
-    if(lm[i][0]==l && lm[i][1]==m) { return i; }
-  }
+  const unsigned int i = FindModeIndexWithoutError(l, m);
+  if(i<NModes()) { return i; }
   INFOTOCERR << " Can't find (ell,m)=(" << l << ", " << m << ")" << endl;
   throw(GWFrames_WaveformMissingLMIndex);
 }
@@ -847,8 +1864,15 @@ unsigned int GWFrames::Waveform::FindModeIndex(const int l, const int m) const {
 unsigned int GWFrames::Waveform::FindModeIndexWithoutError(const int l, const int m) const {
   /// If the requested mode is not present, the returned index is 1
   /// beyond the end of the mode vector.
-  const unsigned int i_expected = l*(l+1) + m - SpinWeight()*SpinWeight();
-  if(lm[i_expected][0]==l && lm[i_expected][1]==m) { return i_expected; }
+  ///
+  /// The lookup uses the ModeLayout table, so it takes constant time.
+  /// If `lm` has been changed without updating that table, this falls
+  /// back to a linear search.
+  const int i_expected = modeLayout.Index(l, m);
+  if(modeLayout.NModes()==lm.size()) {
+    if(i_expected<0) { return NModes()+1; }
+    if(lm[i_expected][0]==l && lm[i_expected][1]==m) { return i_expected; }
+  }
   // ORIENTATION!!! following loop
   unsigned int i=0;
   for(; i<NModes(); ++i) {
@@ -858,6 +1882,103 @@ unsigned int GWFrames::Waveform::FindModeIndexWithoutError(const int l, const in
   return i;
 }
 
+#ifndef DOXYGEN
+namespace {
+  // Terms of the violation of an involution, which compares each
+  // mode (ell,m) with the conjugate of (ell,m) or (ell,-m) times a
+  // sign (-1)^ell, (-1)^m, or (-1)^(ell+m).  Only ell values in
+  // Lmodes are included, unless it is empty.
+  vector<InvolutionTerm> InvolutionTerms(const GWFrames::Waveform& W, const bool ReflectM, const bool EllSign, const bool MSign,
+                                         const vector<int>& Lmodes) {
+    vector<InvolutionTerm> Terms;
+    const int ellMax = W.EllMax();
+    for(int ell=std::abs(W.SpinWeight()); ell<=ellMax; ++ell) {
+      if(Lmodes.size()==0 || GWFrames::xINy(ell,Lmodes)) {
+        for(int m=-ell; m<=ell; ++m) {
+          InvolutionTerm Term;
+          Term.iA = W.FindModeIndex(ell,m);
+          Term.iB = (ReflectM ? W.FindModeIndex(ell,-m) : Term.iA);
+          const int Power = (EllSign ? ell : 0) + (MSign ? m : 0);
+          Term.Sign = ((Power%2)==0 ? 1.0 : -1.0);
+          Terms.push_back(Term);
+        }
+      }
+    }
+    return Terms;
+  }
+
+  // Terms of the dipole moment, with the Wigner 3-j symbols found
+  // once for each pair of modes
+  vector<DipoleTerm> DipoleTerms(const GWFrames::Waveform& W, const int ellMax) {
+    vector<DipoleTerm> Terms;
+    for(int ell=2; ell<=ellMax; ++ell) {
+      for(int m=-ell; m<=ell; ++m) {
+        for(int ellPrime=std::max(ell-1,2); ellPrime<=std::min(ell+1,ellMax); ++ellPrime) {
+          const double sqrtFactor = std::sqrt((2*ell+1)*(2*ellPrime+1)/2.);
+          const double Wigner3j_A = Wigner3j(ell, ellPrime, 1, 2, -2, 0);
+          for(int mPrime=std::max(m-1,-ellPrime); mPrime<=std::min(m+1,ellPrime); ++mPrime) {
+            const double c = (mPrime%2 == 0 ? 1.0 : -1.0) * sqrtFactor * Wigner3j(ell, ellPrime, 1, m, -mPrime, mPrime-m) * Wigner3j_A;
+            DipoleTerm Term;
+            Term.iA = W.FindModeIndex(ell,m);
+            Term.iB = W.FindModeIndex(ellPrime,mPrime);
+            if(mPrime==m) { // This will only affect the z component
+              Term.cx = 0.0;
+              Term.cy = 0.0;
+              Term.cz = std::sqrt(2.0) * c;
+            } else { // This will only affect the x and y components
+              Term.cx = (mPrime-m==1 ? -1. : 1.) * c;
+              Term.cy = -c;
+              Term.cz = 0.0;
+            }
+            Terms.push_back(Term);
+          }
+        }
+      }
+    }
+    return Terms;
+  }
+
+  // Fused kernel for Norm, the involution violations, and the dipole
+  // moment.  Each block of time steps is swept once for all of the
+  // requested quantities, with the blocks divided among the threads.
+  // On return, Norm is empty unless DoNorm is true; Violations has
+  // one element per set of involution terms; and Dipole holds the
+  // three components at each time (or is empty if there are no
+  // dipole terms).
+  void DiagnosticsKernel(const GWFrames::Waveform& W, const bool DoNorm, const vector<vector<InvolutionTerm> >& Involutions,
+                         const vector<DipoleTerm>& Dipoles, vector<double>& Norm, vector<vector<double> >& Violations, vector<double>& Dipole) {
+    const int NTimes = W.NTimes();
+    const int NModes = W.NModes();
+    const int NInvolutions = Involutions.size();
+    const int NDipoles = Dipoles.size();
+    Norm.assign(DoNorm ? NTimes : 0, 0.0);
+    Violations.assign(NInvolutions, vector<double>(NTimes, 0.0));
+    Dipole.assign(NDipoles>0 ? 3*NTimes : 0, 0.0);
+    const int NBlocks = (NTimes+DiagnosticsBlockSize-1)/DiagnosticsBlockSize;
+    #pragma omp parallel for schedule(static) if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+    for(int i_b=0; i_b<NBlocks; ++i_b) {
+      const int i_t_0 = i_b*DiagnosticsBlockSize;
+      const int n = std::min(DiagnosticsBlockSize, NTimes-i_t_0);
+      if(DoNorm) {
+        for(int i_m=0; i_m<NModes; ++i_m) {
+          AccumulateNorm(W(i_m)+i_t_0, &Norm[i_t_0], n);
+        }
+      }
+      for(int i_i=0; i_i<NInvolutions; ++i_i) {
+        const vector<InvolutionTerm>& Terms = Involutions[i_i];
+        double* v = &Violations[i_i][i_t_0];
+        for(unsigned int i_term=0; i_term<Terms.size(); ++i_term) {
+          AccumulateInvolutionViolation(W(Terms[i_term].iA)+i_t_0, W(Terms[i_term].iB)+i_t_0, Terms[i_term].Sign, v, n);
+        }
+      }
+      for(int i_term=0; i_term<NDipoles; ++i_term) {
+        AccumulateDipole(W(Dipoles[i_term].iA)+i_t_0, W(Dipoles[i_term].iB)+i_t_0, Dipoles[i_term], &Dipole[3*i_t_0], n);
+      }
+    }
+  }
+}
+#endif // DOXYGEN
+
 /// Return the normalized asymmetry as a function of time
 std::vector<double> GWFrames::Waveform::NormalizedAntisymmetry(std::vector<int> LModesForAsymmetry) const {
   /// \param LModesForAsymmetry \f$\ell\f$ modes to use when calculating numerator
@@ -874,34 +1995,20 @@ std::vector<double> GWFrames::Waveform::NormalizedAntisymmetry(std::vector<int>
   /// input, only modes with ell values in that argument will be used
   /// to calculate the asymmetry.  All modes will always be used to
   /// calculate the normalization.
-
+  ///
+  /// The numerator is the parity violation, so this equals
+  /// `sqrt(ParityViolationSquared(LModesForAsymmetry)/Norm())`; both
+  /// are found in one sweep over the data.
+  GWFrames_INSTRUMENT("Waveform::NormalizedAntisymmetry");
+
+  vector<double> norm, dipole;
+  vector<vector<double> > violations;
+  DiagnosticsKernel(*this, true, vector<vector<InvolutionTerm> >(1, InvolutionTerms(*this, true, true, true, LModesForAsymmetry)),
+                    vector<DipoleTerm>(0), norm, violations, dipole);
   const unsigned int ntimes = NTimes();
-  const int ellMax = EllMax();
   std::vector<double> asymmetry(ntimes);
-  double diff,norm;
   for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
-    diff = 0.;
-    norm = 0.;
-    for(int ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
-      if(LModesForAsymmetry.size()==0 || GWFrames::xINy(ell,LModesForAsymmetry)) {
-        for(int m=-ell; m<=ell; ++m) {
-          const complex<double> h_ell_m = Data(FindModeIndexWithoutError(ell,m), i_t);
-          const complex<double> hbar_ell_mm = std::conj(Data(FindModeIndexWithoutError(ell,-m), i_t));
-          if(((ell+m)%2)==0) {
-            diff += std::norm(h_ell_m - hbar_ell_mm);
-          } else {
-            diff += std::norm(h_ell_m + hbar_ell_mm);
-          }
-          norm += std::norm(h_ell_m);
-        }
-      } else{
-        for(int m=-ell; m<=ell; ++m) {
-          const complex<double> h_ell_m = Data(FindModeIndexWithoutError(ell,m), i_t);
-          norm += std::norm(h_ell_m);
-        }
-      }
-    }
-    asymmetry[i_t] = std::sqrt(diff/(4*norm));
+    asymmetry[i_t] = std::sqrt(violations[0][i_t]/norm[i_t]);
   }
   return asymmetry;
 }
@@ -915,59 +2022,21 @@ std::vector<std::vector<double> > GWFrames::Waveform::DipoleMoment(int ellMax) c
   /// \rvert^2 d\Omega\f$.  Up to a geometric factor, this function
   /// applied to \f$\dot{h}\f$ is the rate of emission of momentum in
   /// gravitational waves.
+  GWFrames_INSTRUMENT("Waveform::DipoleMoment");
 
   if(ellMax==0) {
     ellMax = EllMax();
   }
 
-  vector<vector<double> > D(NTimes(), vector<double>(3));
-  vector<complex<double> > d(3);
+  vector<double> norm, d;
+  vector<vector<double> > violations;
+  DiagnosticsKernel(*this, false, vector<vector<InvolutionTerm> >(0), DipoleTerms(*this, ellMax), norm, violations, d);
 
-  for(int i_t=0; i_t<NTimes(); ++i_t) {
-    d[0] = 0.0;
-    d[1] = 0.0;
-    d[2] = 0.0;
-    for(int ell=2; ell<=ellMax; ++ell) {
-      for(int m=-ell; m<=ell; ++m) {
-        for(int ellPrime=std::max(ell-1,2); ellPrime<=std::min(ell+1,ellMax); ++ellPrime) {
-          const double sqrtFactor = std::sqrt((2*ell+1)*(2*ellPrime+1)/2.);
-          const double Wigner3j_A = Wigner3j(ell, ellPrime, 1, 2, -2, 0);
-          for(int mPrime=std::max(m-1,-ellPrime); mPrime<=std::min(m+1,ellPrime); ++mPrime) {
-            // This is the whole thing, except for the n_j modes
-            if(mPrime%2 == 0) {
-              const complex<double> BasicFactor = Data(FindModeIndex(ell,m), i_t) * std::conj(Data(FindModeIndex(ellPrime,mPrime), i_t))
-                * sqrtFactor * Wigner3j(ell, ellPrime, 1, m, -mPrime, mPrime-m) * Wigner3j_A;
-              if(mPrime==m) { // This will only affect the z component
-                d[2] += std::sqrt(2) * BasicFactor;
-              } else { // This will only affect the x and y components
-                d[0] += (mPrime-m==1 ? -1. : 1.) * BasicFactor;
-                d[1] += ImaginaryI * BasicFactor;
-              }
-            } else {
-              const complex<double> BasicFactor = -Data(FindModeIndex(ell,m), i_t) * std::conj(Data(FindModeIndex(ellPrime,mPrime), i_t))
-                * sqrtFactor * Wigner3j(ell, ellPrime, 1, m, -mPrime, mPrime-m) * Wigner3j_A;
-              if(mPrime==m) { // This will only affect the z component
-                d[2] += std::sqrt(2) * BasicFactor;
-              } else { // This will only affect the x and y components
-                d[0] += (mPrime-m==1 ? -1. : 1.) * BasicFactor;
-                d[1] += ImaginaryI * BasicFactor;
-              }
-            }
-            // if(d[0]!=d[0] || d[1]!=d[1] || d[2]!=d[2]) { // DEBUG NANs
-            //   INFOTOCERR << i_t << ": (" << ell << "," << m << "); (" << ellPrime << "," << mPrime
-            //              << ")\n" << Data(FindModeIndex(ell,m), i_t) << " * " << std::conj(Data(FindModeIndex(ellPrime,mPrime), i_t))
-            //              << " * " << std::pow(-1,mPrime) << "*" << sqrtFactor << " * " << Wigner3j(ell, ellPrime, 1, m, -mPrime, mPrime-m)
-            //              << " * " << Wigner3j_A
-            //              << "=" << BasicFactor << "\t[" << d[0] << "," << d[1] << "," << d[2] << "]" << std::endl;
-            //   throw(GWFrames_ValueError);
-            // }
-          }
-        }
-      }
-    }
-    D[i_t][0] = d[0].real();
-    D[i_t][1] = d[1].real();
-    D[i_t][2] = d[2].real();
+  vector<vector<double> > D(NTimes(), vector<double>(3));
+  for(unsigned int i_t=0; i_t<NTimes(); ++i_t) {
+    D[i_t][0] = d[3*i_t];
+    D[i_t][1] = d[3*i_t+1];
+    D[i_t][2] = d[3*i_t+2];
   }
 
   return D;
@@ -975,22 +2044,26 @@ std::vector<std::vector<double> > GWFrames::Waveform::DipoleMoment(int ellMax) c
 
 
 // Local utility function for evaluating involution violation
-std::vector<double> GWFrames::Waveform::InvolutionViolationSquared(GWFrames::Waveform::WaveformInvolutionFunction Invol, std::vector<int> Lmodes) const {
-  vector<double> violation(NTimes(),0.0);
-
-  for(int ell=std::abs(SpinWeight()); ell<=EllMax(); ++ell) {
-    if(Lmodes.size()==0 || GWFrames::xINy(ell,Lmodes)) {
-      for(int m=-ell; m<=ell; ++m) {
-        const unsigned int i_m = FindModeIndex(ell,m);
-        const unsigned int i_mm = FindModeIndex(ell,-m);
-        for(unsigned int i_t=0; i_t<NTimes(); ++i_t) {
-          violation[i_t] += 0.25 * std::norm( Data(i_m,i_t) - (this->*Invol)(i_m,i_mm,i_t) );
-        }
-      }
-    }
-  }
-
-  return violation;
+std::vector<double> GWFrames::Waveform::InvolutionViolationSquared(const InvolutionType Invol, const std::vector<int>& Lmodes) const {
+  vector<InvolutionTerm> Terms;
+  switch(Invol) {
+  case XParityInvolutionType:
+    Terms = InvolutionTerms(*this, false, false, true, Lmodes);
+    break;
+  case YParityInvolutionType:
+    Terms = InvolutionTerms(*this, false, false, false, Lmodes);
+    break;
+  case ZParityInvolutionType:
+    Terms = InvolutionTerms(*this, true, true, false, Lmodes);
+    break;
+  case ParityInvolutionType:
+    Terms = InvolutionTerms(*this, true, true, true, Lmodes);
+    break;
+  }
+  vector<double> norm, dipole;
+  vector<vector<double> > violations;
+  DiagnosticsKernel(*this, false, vector<vector<InvolutionTerm> >(1, Terms), vector<DipoleTerm>(0), norm, violations, dipole);
+  return violations[0];
 }
 
 
@@ -1006,6 +2079,7 @@ GWFrames::Waveform GWFrames::Waveform::Involution(WaveformInvolutionFunction WIn
     B.frame[i] = QInvol(A.frame[i]);
   }
   B.lm = A.lm;
+  B.modeLayout = A.modeLayout;
   B.data.resize(A.NModes(), A.NTimes());
   for(int ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
     for(int m=-ell; m<=ell; ++m) {
@@ -1031,6 +2105,7 @@ GWFrames::Waveform GWFrames::Waveform::InvolutionSymmetricPart(WaveformInvolutio
     B.frame[i] = 0.5 * ( A.frame[i] +  QInvol(A.frame[i]) );
   }
   B.lm = A.lm;
+  B.modeLayout = A.modeLayout;
   B.data.resize(A.NModes(), A.NTimes());
   for(int ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
     for(int m=-ell; m<=ell; ++m) {
@@ -1056,6 +2131,7 @@ GWFrames::Waveform GWFrames::Waveform::InvolutionAntisymmetricPart(WaveformInvol
     B.frame[i] = 0.5 * ( A.frame[i] -  QInvol(A.frame[i]) );
   }
   B.lm = A.lm;
+  B.modeLayout = A.modeLayout;
   B.data.resize(A.NModes(), A.NTimes());
   for(int ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
     for(int m=-ell; m<=ell; ++m) {
@@ -1190,20 +2266,103 @@ std::vector<double> GWFrames::Waveform::MinimalParityViolation() const {
   /// square-root of that ratio is taken.
   ///
   /// This is performed iteratively at each time step, as the system
-  /// is rotated, and the parity violation is minimized.
+  /// is rotated, and the parity violation is minimized.  The time
+  /// steps are independent, so they are divided among threads (each
+  /// with its own minimizer) when compiled with OpenMP.
+  GWFrames_INSTRUMENT("Waveform::MinimalParityViolation");
 
-  const unsigned int ntimes = NTimes();
+  const int ntimes = NTimes();
   vector<double> violations(ntimes);
-  MinimalParityViolationMinimizer Minimizer(*this);
 
-  for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
-    INFOTOCERR << i_t+1 << "/" << ntimes << std::endl;
-    violations[i_t] = std::min(std::min(Minimizer.Minimize(i_t,0), Minimizer.Minimize(i_t,1)), Minimizer.Minimize(i_t,2));
+  // Build one minimizer and evaluate the quantity once first.  This
+  // initializes the SphericalFunctions singletons used by the
+  // rotations and the ladder operators before any threads are
+  // started.
+  if(ntimes>0) {
+    const MinimalParityViolationMinimizer Minimizer(*this);
+    Minimizer.EvaluateMinimizationQuantity(0.0, 0.0);
+  }
+
+  // Exceptions may not leave the parallel region, so they are caught
+  // and re-thrown afterwards
+  int Thrown = -1;
+  #pragma omp parallel if(ntimes>1) num_threads(GWFrames::MaxThreads())
+  {
+    MinimalParityViolationMinimizer* Minimizer = 0;
+    try {
+      Minimizer = new MinimalParityViolationMinimizer(*this);
+    } catch(int e) {
+      #pragma omp critical(GWFrames_MinimalParityViolation)
+      Thrown = e;
+    }
+    #pragma omp for schedule(dynamic)
+    for(int i_t=0; i_t<ntimes; ++i_t) {
+      if(!Minimizer) { continue; }
+      try {
+        violations[i_t] = std::min(std::min(Minimizer->Minimize(i_t,0), Minimizer->Minimize(i_t,1)), Minimizer->Minimize(i_t,2));
+      } catch(int e) {
+        #pragma omp critical(GWFrames_MinimalParityViolation)
+        Thrown = e;
+      }
+    }
+    delete Minimizer;
   }
+  if(Thrown>=0) { throw(Thrown); }
 
   return violations;
 }
 
+/// Find several quality diagnostics in one sweep over the data
+GWFrames::WaveformDiagnostics GWFrames::Waveform::Diagnostics(const unsigned int SkipFraction, const std::vector<int>& LModesForAsymmetry,
+                                                              const int ellMaxForDipole) const {
+  ///
+  /// \param SkipFraction As in `MaxNormIndex`
+  /// \param LModesForAsymmetry As in `NormalizedAntisymmetry`
+  /// \param ellMaxForDipole As the `ellMax` argument of `DipoleMoment`
+  ///
+  /// This returns the `Norm`, `MaxNormIndex`, the squared violations
+  /// of the four parity involutions (with all ell modes), the
+  /// `NormalizedAntisymmetry`, and the `DipoleMoment`.  Each block of
+  /// time steps is read once for all of them (in parallel, when
+  /// OpenMP is enabled), which is much faster than calling each of
+  /// those functions in turn.
+  GWFrames_INSTRUMENT_BYTES("Waveform::Diagnostics", NTimes()*NModes()*sizeof(std::complex<double>));
+
+  const std::vector<int> AllModes(0);
+  vector<vector<InvolutionTerm> > Involutions;
+  Involutions.push_back(InvolutionTerms(*this, false, false, true, AllModes));
+  Involutions.push_back(InvolutionTerms(*this, false, false, false, AllModes));
+  Involutions.push_back(InvolutionTerms(*this, true, true, false, AllModes));
+  Involutions.push_back(InvolutionTerms(*this, true, true, true, AllModes));
+  if(LModesForAsymmetry.size()>0) {
+    Involutions.push_back(InvolutionTerms(*this, true, true, true, LModesForAsymmetry));
+  }
+
+  WaveformDiagnostics D;
+  vector<vector<double> > violations;
+  vector<double> dipole;
+  DiagnosticsKernel(*this, true, Involutions, DipoleTerms(*this, (ellMaxForDipole==0 ? EllMax() : ellMaxForDipole)),
+                    D.Norm, violations, dipole);
+
+  const unsigned int ntimes = NTimes();
+  D.MaxNormIndex = IndexOfMaxNorm(D.Norm, ntimes/SkipFraction);
+  D.XParityViolationSquared.swap(violations[0]);
+  D.YParityViolationSquared.swap(violations[1]);
+  D.ZParityViolationSquared.swap(violations[2]);
+  D.ParityViolationSquared.swap(violations[3]);
+  const vector<double>& Asymmetry = (LModesForAsymmetry.size()>0 ? violations[4] : D.ParityViolationSquared);
+  D.NormalizedAntisymmetry.resize(ntimes);
+  D.DipoleMoment.assign(ntimes, vector<double>(3));
+  for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
+    D.NormalizedAntisymmetry[i_t] = std::sqrt(Asymmetry[i_t]/D.Norm[i_t]);
+    D.DipoleMoment[i_t][0] = dipole[3*i_t];
+    D.DipoleMoment[i_t][1] = dipole[3*i_t+1];
+    D.DipoleMoment[i_t][2] = dipole[3*i_t+2];
+  }
+
+  return D;
+}
+
 
 /// Rotate the physical content of the Waveform by a constant rotor.
 GWFrames::Waveform& GWFrames::Waveform::RotatePhysicalSystem(const Quaternions::Quaternion& R_phys) {
@@ -1356,6 +2515,15 @@ GWFrames::Waveform& GWFrames::Waveform::TransformModesToRotatedFrame(const std::
   /// does not adjust the `frameType`, which is left to the calling
   /// functions.
   ///
+  /// The time steps are processed in blocks.  For each time step, the
+  /// rotation is set just once, and the Wigner D elements for every
+  /// ell are stored so that the sums over m' run along contiguous
+  /// arrays in time.  When compiled with OpenMP (USE_OPENMP), the
+  /// blocks are distributed over threads.  Each output value is
+  /// computed by the same sequence of operations regardless of the
+  /// blocking or number of threads, so the results are identical to
+  /// the serial computation.
+  GWFrames_INSTRUMENT("Waveform::TransformModesToRotatedFrame");
 
   const int NModes = this->NModes();
   const int NTimes = this->NTimes();
@@ -1365,86 +2533,305 @@ GWFrames::Waveform& GWFrames::Waveform::TransformModesToRotatedFrame(const std::
     throw(GWFrames_VectorSizeMismatch);
   }
 
-  // Loop through each mode and do the rotation
+  // Use a vector of mode indices for each l, in case the modes are
+  // out of order.  This still assumes that we have each l from
+  // l=|s| up to some l_max, which the mode layout checks.
+  const int ellMin = std::abs(SpinWeight());
+  if(NModes==0 || NTimes==0) { return *this; }
+  if(modeLayout.NModes()!=lm.size()) { UpdateModeLayout(); }
+  if(!modeLayout.HasCompleteElls() || modeLayout.EllMin()!=ellMin) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Incomplete mode information in Waveform; cannot rotate." << endl;
+    throw(GWFrames_WaveformMissingLMIndex);
+  }
+  const int ellMax = modeLayout.EllMax();
+  const int NEll = ellMax-ellMin+1;
+  vector<vector<unsigned int> > ModeIndices(NEll);
+  for(int l=ellMin; l<=ellMax; ++l) {
+    vector<unsigned int>& Indices = ModeIndices[l-ellMin];
+    Indices.resize(2*l+1);
+    for(int m=-l, i=0; m<=l; ++m, ++i) {
+      Indices[i] = modeLayout.Index(l, m);
+    }
+  }
+
+  // The D matrices for all l are stored consecutively, with element
+  // (l,m',m) at DOffsets[l-ellMin]+(m'+l)*(2l+1)+(m+l); for
+  // time-dependent rotations, each element is followed by the values
+  // for the rest of the time steps in the block.
+  vector<int> DOffsets(NEll+1, 0);
+  for(int l=ellMin; l<=ellMax; ++l) {
+    DOffsets[l-ellMin+1] = DOffsets[l-ellMin] + (2*l+1)*(2*l+1);
+  }
+  const int NDs = DOffsets[NEll];
+  const bool ConstantRotation = (R_frame.size()==1);
+  const int BlockSize = (ConstantRotation ? 1024 : 64);
+  const int NBlocks = (NTimes+BlockSize-1)/BlockSize;
+
+  // Get the Wigner D matrix data just once if the rotation is
+  // constant.  This also initializes the SphericalFunctions
+  // singletons before any threads are started.
+  vector<complex<double> > ConstantDs(NDs);
   {
-    int mode=1;
-    for(int l=std::abs(SpinWeight()); l<NModes; ++l) {
-      if(NModes<mode) { break; }
-
-      // Use a vector of mode indices, in case the modes are out of
-      // order.  This still assumes that we have each l from l=2 up to
-      // some l_max, but it's better than assuming that, plus assuming
-      // that everything is in order.
-      vector<unsigned int> ModeIndices(2*l+1);
-      for(int m=-l, i=0; m<=l; ++m, ++i) {
-        try {
-          ModeIndices[i] = FindModeIndex(l, m);
-        } catch(int thrown) {
-          cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Incomplete mode information in Waveform; cannot rotate." << endl;
-          throw(thrown);
+    SphericalFunctions::WignerDMatrix D(R_frame[0]);
+    for(int l=ellMin; l<=ellMax; ++l) {
+      for(int mp=-l; mp<=l; ++mp) {
+        for(int m=-l; m<=l; ++m) {
+          ConstantDs[DOffsets[l-ellMin]+(mp+l)*(2*l+1)+(m+l)] = D(l,mp,m);
         }
       }
+    }
+  }
 
-      {
-
-        // Construct the D matrix and data storage
-        SphericalFunctions::WignerDMatrix D(R_frame[0]);
-        vector<vector<complex<double> > > Ds(2*l+1, vector<complex<double> >(2*l+1));
-        vector<complex<double> > Data(2*l+1);
-
-        if(R_frame.size()==1) {
-          // Get the Wigner D matrix data just once
-          for(int m=-l; m<=l; ++m) {
+  // Loop through each block of time steps
+  #pragma omp parallel if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+  {
+    SphericalFunctions::WignerDMatrix D(R_frame[0]);
+    vector<complex<double> > BlockDs(ConstantRotation ? 0 : NDs*BlockSize);
+    vector<complex<double> > Data((2*ellMax+1)*BlockSize);
+    vector<complex<double> > Sum(BlockSize);
+
+    #pragma omp for schedule(static)
+    for(int block=0; block<NBlocks; ++block) {
+      const int t0 = block*BlockSize;
+      const int nt = std::min(BlockSize, NTimes-t0);
+
+      // Get the Wigner D matrix data for all l at each time step
+      if(!ConstantRotation) {
+        GWFrames_INSTRUMENT("Waveform::TransformModesToRotatedFrame: Wigner D");
+        for(int i_t=0; i_t<nt; ++i_t) {
+          D.SetRotation(R_frame[t0+i_t]);
+          for(int l=ellMin; l<=ellMax; ++l) {
             for(int mp=-l; mp<=l; ++mp) {
-              Ds[mp+l][m+l] = D(l,mp,m);
+              for(int m=-l; m<=l; ++m) {
+                BlockDs[(DOffsets[l-ellMin]+(mp+l)*(2*l+1)+(m+l))*BlockSize+i_t] = D(l,mp,m);
+              }
             }
           }
-          // Loop through each time step
-          for(int t=0; t<NTimes; ++t) {
-            // Store the data for all m' modes at this time step
-            for(int mp=-l, i=0; mp<=l; ++mp, ++i) {
-              Data[mp+l] = this->operator()(ModeIndices[i], t);
-            }
-            // Compute the data at this time step for each m
-            for(int m=-l, i=0; m<=l; ++m, ++i) {
-              data[ModeIndices[i]][t] = 0.0;
-              for(int mp=-l; mp<=l; ++mp) { // Sum over m'
-                data[ModeIndices[i]][t] += Ds[mp+l][m+l]*Data[mp+l];
+        }
+      }
+
+      for(int l=ellMin; l<=ellMax; ++l) {
+        const vector<unsigned int>& Indices = ModeIndices[l-ellMin];
+        // Store the data for all m' modes in this block
+        for(int mp=-l; mp<=l; ++mp) {
+          const complex<double>* Mode = data[Indices[mp+l]]+t0;
+          std::copy(Mode, Mode+nt, &Data[(mp+l)*BlockSize]);
+        }
+        // Compute the data in this block for each m
+        for(int m=-l; m<=l; ++m) {
+          std::fill(Sum.begin(), Sum.begin()+nt, complex<double>(0.0));
+          for(int mp=-l; mp<=l; ++mp) { // Sum over m'
+            const int i_D = DOffsets[l-ellMin]+(mp+l)*(2*l+1)+(m+l);
+            const complex<double>* Data_mp = &Data[(mp+l)*BlockSize];
+            if(ConstantRotation) {
+              const complex<double> D_mp_m = ConstantDs[i_D];
+              for(int i_t=0; i_t<nt; ++i_t) {
+                Sum[i_t] += D_mp_m*Data_mp[i_t];
+              }
+            } else {
+              const complex<double>* D_mp_m = &BlockDs[i_D*BlockSize];
+              for(int i_t=0; i_t<nt; ++i_t) {
+                Sum[i_t] += D_mp_m[i_t]*Data_mp[i_t];
               }
             }
           }
-        } else {
-          // Loop through each time step
-          for(int t=0; t<NTimes; ++t) {
-            // Get the Wigner D matrix data at this time step
-            D.SetRotation(R_frame[t]);
-            for(int m=-l; m<=l; ++m) {
-              for(int mp=-l; mp<=l; ++mp) {
-                Ds[mp+l][m+l] = D(l,mp,m);
+          std::copy(Sum.begin(), Sum.begin()+nt, data[Indices[m+l]]+t0);
+        }
+      }
+    }
+  }
+
+  return *this;
+}
+
+#ifndef DOXYGEN
+namespace {
+  // The angular-momentum operators are applied as
+  //
+  // L+ = Lx + i Ly      Lx =    (L+ + L-) / 2     Im(Lx) =  ( Im(L+) + Im(L-) ) / 2
+  // L- = Lx - i Ly      Ly = -i (L+ - L-) / 2     Im(Ly) = -( Re(L+) - Re(L-) ) / 2
+  // Lz = Lz             Lz = Lz                   Im(Lz) = Im(Lz)
+  // LxLx =   (L+ + L-)(L+ + L-) / 4
+  // LxLy = -i(L+ + L-)(L+ - L-) / 4
+  // LxLz =   (L+ + L-)(  Lz   ) / 2
+  // LyLx = -i(L+ - L-)(L+ + L-) / 4
+  // LyLy =  -(L+ - L-)(L+ - L-) / 4
+  // LyLz = -i(L+ - L-)(  Lz   ) / 2
+  // LzLx =   (  Lz   )(L+ + L-) / 2
+  // LzLy = -i(  Lz   )(L+ - L-) / 2
+  // LzLz =   (  Lz   )(  Lz   )
+  //
+  // Only the symmetric part of <LL> is kept, so the terms involving
+  // Lz combine as LpLz+LzLp = (2M+1) c(L,M) conj(f_{M+1}) f_M, etc.
+
+  // Number of time steps each thread processes together
+  const int AngularMomentumBlockSize = 256;
+
+  // Everything needed from one (L,M) mode, with the ladder-operator
+  // factors looked up once rather than at every time step
+  struct AngularMomentumTerm {
+    int iM;
+    int iMm2, iMm1, iMp1, iMp2; // Index of each neighboring mode, or -1 if there is none
+    double M;
+    double cp;  // c(L,M) = LadderOperatorFactor(L, M)
+    double cm;  // c(L,-M)
+    double cpp; // c(L,M+1) c(L,M)
+    double cmm; // c(L,-(M-1)) c(L,-M)
+    double c0;  // c(L,M-1) c(L,-M) + c(L,-(M+1)) c(L,M), from LpLm+LmLp
+  };
+
+  // <L\partial_t> and the upper triangle of <LL> at one instant
+  struct AngularMomentumMoments {
+    double Ldt[3];
+    double LL[6]; // xx, xy, xz, yy, yz, zz
+  };
+
+  template <typename WaveformType>
+  vector<AngularMomentumTerm> AngularMomentumTerms(const WaveformType& W, vector<int> Lmodes) {
+    const LadderOperatorFactorSingleton& LadderOperatorFactor = LadderOperatorFactorSingleton::Instance();
+    if(Lmodes.size()==0) {
+      Lmodes.push_back(W.LM(0)[0]);
+      for(unsigned int i_m=0; i_m<W.NModes(); ++i_m) {
+        if(std::find(Lmodes.begin(), Lmodes.end(), W.LM(i_m)[0]) == Lmodes.end() ) {
+          Lmodes.push_back(W.LM(i_m)[0]);
+        }
+      }
+    }
+    vector<AngularMomentumTerm> Terms;
+    for(unsigned int iL=0; iL<Lmodes.size(); ++iL) {
+      const int L = Lmodes[iL];
+      for(int M=-L; M<=L; ++M) {
+        AngularMomentumTerm Term;
+        Term.iM   = W.FindModeIndex(L,M);
+        Term.iMm2 = (M-2>=-L ? int(W.FindModeIndex(L,M-2)) : -1);
+        Term.iMm1 = (M-1>=-L ? int(W.FindModeIndex(L,M-1)) : -1);
+        Term.iMp1 = (M+1<=L  ? int(W.FindModeIndex(L,M+1)) : -1);
+        Term.iMp2 = (M+2<=L  ? int(W.FindModeIndex(L,M+2)) : -1);
+        Term.M = double(M);
+        Term.cp = (M+1<=L ? LadderOperatorFactor(L, M) : 0.0);
+        Term.cm = (M-1>=-L ? LadderOperatorFactor(L, -M) : 0.0);
+        Term.cpp = (M+2<=L ? LadderOperatorFactor(L, M+1) * LadderOperatorFactor(L, M) : 0.0);
+        Term.cmm = (M-2>=-L ? LadderOperatorFactor(L, -(M-1)) * LadderOperatorFactor(L, -M) : 0.0);
+        Term.c0 = (M-1>=-L ? LadderOperatorFactor(L, M-1) * LadderOperatorFactor(L, -M) : 0.0)
+          + (M+1<=L ? LadderOperatorFactor(L, -(M+1)) * LadderOperatorFactor(L, M) : 0.0);
+        Terms.push_back(Term);
+      }
+    }
+    return Terms;
+  }
+
+  // Type of the stored mode data; each element is converted to
+  // complex<double> before it is used
+  template <typename WaveformType>
+  struct ModeDataType { typedef complex<double> Type; };
+  template <>
+  struct ModeDataType<GWFrames::CompactWaveform> { typedef complex<float> Type; };
+
+  // Differentiate one mode, for either type of stored data
+  inline void DifferentiateMode(const GWFrames::DerivativePlan& Derivative, const complex<double>* F, complex<double>* D) {
+    Derivative.Differentiate(F, D);
+  }
+  inline void DifferentiateMode(const GWFrames::DerivativePlan& Derivative, const complex<float>* F, complex<double>* D) {
+    const vector<complex<double> > FDouble(F, F+Derivative.NPoints());
+    Derivative.Differentiate(&FDouble[0], D);
+  }
+
+  // Fused kernel for LdtVector, LLMatrix, and AngularVelocityVector.
+  // All requested quantities are accumulated in one sweep over the
+  // data, a block of time steps at a time, with the blocks divided
+  // among the threads.
+  template <typename WaveformType>
+  vector<AngularMomentumMoments> AngularMomentumKernel(const WaveformType& W, const vector<int>& Lmodes,
+                                                       const bool DoLdt, const bool DoLL) {
+    typedef typename ModeDataType<WaveformType>::Type Complex;
+    const vector<AngularMomentumTerm> Terms = AngularMomentumTerms(W, Lmodes);
+    const int NTerms = Terms.size();
+    const int NTimes = W.NTimes();
+    const AngularMomentumMoments Zero = { {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0, 0.0, 0.0, 0.0} };
+    vector<AngularMomentumMoments> Moments(NTimes, Zero);
+    const int NBlocks = (NTimes+AngularMomentumBlockSize-1)/AngularMomentumBlockSize;
+
+    // The time derivatives are needed over the whole time series
+    vector<vector<complex<double> > > dDdt(DoLdt ? NTerms : 0);
+    if(DoLdt) {
+      const GWFrames::DerivativePlan Derivative(W.T());
+      #pragma omp parallel for schedule(static) if(NTerms>1) num_threads(GWFrames::MaxThreads())
+      for(int i_term=0; i_term<NTerms; ++i_term) {
+        dDdt[i_term].resize(NTimes);
+        DifferentiateMode(Derivative, W(Terms[i_term].iM), &dDdt[i_term][0]);
+      }
+    }
+
+    #pragma omp parallel if(NTerms*NTimes>AngularMomentumBlockSize) num_threads(GWFrames::MaxThreads())
+    {
+      #pragma omp for schedule(static)
+      for(int i_b=0; i_b<NBlocks; ++i_b) {
+        const int i_t_a = i_b*AngularMomentumBlockSize;
+        const int i_t_b = std::min(i_t_a+AngularMomentumBlockSize, NTimes);
+        for(int i_term=0; i_term<NTerms; ++i_term) {
+          const AngularMomentumTerm& Term = Terms[i_term];
+          const double M = Term.M;
+          const Complex* f   = W(Term.iM);
+          const Complex* fm2 = (Term.iMm2>=0 ? W(Term.iMm2) : 0);
+          const Complex* fm1 = (Term.iMm1>=0 ? W(Term.iMm1) : 0);
+          const Complex* fp1 = (Term.iMp1>=0 ? W(Term.iMp1) : 0);
+          const Complex* fp2 = (Term.iMp2>=0 ? W(Term.iMp2) : 0);
+          if(DoLdt) {
+            const complex<double>* df = &dDdt[i_term][0];
+            for(int i_t=i_t_a; i_t<i_t_b; ++i_t) {
+              double* l = Moments[i_t].Ldt;
+              if(fp1) { // L+
+                const complex<double> Lplus = Term.cp * conj(complex<double>(fp1[i_t])) * df[i_t];
+                l[0] += 0.5 * imag(Lplus);
+                l[1] -= 0.5 * real(Lplus);
               }
-            }
-            // Store the data for all m' modes at this time step
-            for(int mp=-l, i=0; mp<=l; ++mp, ++i) {
-              Data[mp+l] = this->operator()(ModeIndices[i], t);
-            }
-            // Compute the data at this time step for each m
-            for(int m=-l, i=0; m<=l; ++m, ++i) {
-              data[ModeIndices[i]][t] = 0.0;
-              for(int mp=-l; mp<=l; ++mp) { // Sum over m'
-                data[ModeIndices[i]][t] += Ds[mp+l][m+l]*Data[mp+l];
+              { // Lz; always evaluate this one
+                l[2] += M * imag(conj(complex<double>(f[i_t])) * df[i_t]);
               }
+              if(fm1) { // L-
+                const complex<double> Lminus = Term.cm * conj(complex<double>(fm1[i_t])) * df[i_t];
+                l[0] += 0.5 * imag(Lminus);
+                l[1] += 0.5 * real(Lminus);
+              }
+            }
+          }
+          if(DoLL) {
+            for(int i_t=i_t_a; i_t<i_t_b; ++i_t) {
+              double* ll = Moments[i_t].LL;
+              const complex<double> f_t(f[i_t]);
+              const double f2 = std::norm(f_t);
+              const complex<double> LpLp = (fp2 ? Term.cpp * conj(complex<double>(fp2[i_t])) * f_t : 0.0);
+              const complex<double> LmLm = (fm2 ? Term.cmm * conj(complex<double>(fm2[i_t])) * f_t : 0.0);
+              const complex<double> LpLz = (fp1 ? Term.cp * (2*M+1) * conj(complex<double>(fp1[i_t])) * f_t : 0.0); // LpLz+LzLp
+              const complex<double> LmLz = (fm1 ? Term.cm * (2*M-1) * conj(complex<double>(fm1[i_t])) * f_t : 0.0); // LmLz+LzLm
+              const double LpLmLmLp = Term.c0 * f2;
+              ll[0] += 0.25 * (real(LpLp + LmLm) + LpLmLmLp);
+              ll[1] += 0.25 * imag(LpLp - LmLm);
+              ll[2] += 0.25 * real(LpLz + LmLz);
+              ll[3] -= 0.25 * (real(LpLp + LmLm) - LpLmLmLp);
+              ll[4] += 0.25 * imag(LpLz - LmLz);
+              ll[5] += M * M * f2;
             }
           }
         }
-
       }
+    } // omp parallel
 
-      mode += 2*l+1;
-    }
+    return Moments;
   }
 
-  return *this;
+  // Shared by Waveform and WaveformView
+  template <typename WaveformType>
+  vector<vector<double> > LdtVectorOfModes(const WaveformType& W, vector<int> Lmodes) {
+    const vector<AngularMomentumMoments> Moments = AngularMomentumKernel(W, Lmodes, true, false);
+    vector<vector<double> > l(W.NTimes(), vector<double>(3));
+    for(unsigned int iTime=0; iTime<W.NTimes(); ++iTime) {
+      l[iTime].assign(Moments[iTime].Ldt, Moments[iTime].Ldt+3);
+    }
+    return l;
+  }
 }
+#endif // DOXYGEN
 
 /// Calculate the \f$<L \partial_t>\f$ quantity defined in the paper.
 vector<vector<double> > GWFrames::Waveform::LdtVector(vector<int> Lmodes) const {
@@ -1458,54 +2845,35 @@ vector<vector<double> > GWFrames::Waveform::LdtVector(vector<int> Lmodes) const
   /// (x,y,z).
   ///
   /// \f$<L \partial_t>^a = \sum_{\ell,m,m'} \Im [ \bar{f}^{\ell,m'} < \ell,m' | L_a | \ell,m > \dot{f}^{\ell,m} ]\f$
+  GWFrames_INSTRUMENT("Waveform::LdtVector");
+  return LdtVectorOfModes(*this, Lmodes);
+}
 
-  // L+ = Lx + i Ly      Lx =    (L+ + L-) / 2     Im(Lx) =  ( Im(L+) + Im(L-) ) / 2
-  // L- = Lx - i Ly      Ly = -i (L+ - L-) / 2     Im(Ly) = -( Re(L+) - Re(L-) ) / 2
-  // Lz = Lz             Lz = Lz                   Im(Lz) = Im(Lz)
+/// Calculate the \f$<L \partial_t>\f$ quantity for the viewed data.
+vector<vector<double> > GWFrames::WaveformView::LdtVector(vector<int> Lmodes) const {
+  return LdtVectorOfModes(*this, Lmodes);
+}
 
-  const LadderOperatorFactorSingleton& LadderOperatorFactor = LadderOperatorFactorSingleton::Instance();
-  if(Lmodes.size()==0) {
-    Lmodes.push_back(lm[0][0]);
-    for(unsigned int i_m=0; i_m<NModes(); ++i_m) {
-      if(std::find(Lmodes.begin(), Lmodes.end(), lm[i_m][0]) == Lmodes.end() ) {
-        Lmodes.push_back(lm[i_m][0]);
-      }
-    }
-  }
-  vector<vector<double> > l(NTimes(), vector<double>(3, 0.0));
-  for(unsigned int iL=0; iL<Lmodes.size(); ++iL) {
-    const int L = Lmodes[iL];
-    for(int M=-L; M<=L; ++M) {
-      const int iMode = FindModeIndex(L,M);
-      const vector<complex<double> > dDdt = DataDot(iMode);
-      if(M+1<=L) { // L+
-        const int iModep1 = FindModeIndex(L,M+1);
-        const double c_ell_posm = LadderOperatorFactor(L, M);
-        for(unsigned int iTime=0; iTime<NTimes(); ++iTime) {
-          const complex<double> Lplus  = c_ell_posm * conj(data[iModep1][iTime]) * dDdt[iTime];
-          l[iTime][0] += 0.5 * imag(Lplus);
-          l[iTime][1] -= 0.5 * real(Lplus);
-        }
-      }
-      { // Lz; always evaluate this one
-        for(unsigned int iTime=0; iTime<NTimes(); ++iTime) {
-          const complex<double> Lz = (conj(data[iMode][iTime]) * dDdt[iTime]) * double(M);
-          l[iTime][2] += imag(Lz);
-        }
-      }
-      if(M-1>=-L) { // L-
-        const int iModem1 = FindModeIndex(L,M-1);
-        const double c_ell_negm = LadderOperatorFactor(L, -M);
-        for(unsigned int iTime=0; iTime<NTimes(); ++iTime) {
-          const complex<double> Lminus  = c_ell_negm * conj(data[iModem1][iTime]) * dDdt[iTime];
-          l[iTime][0] += 0.5 * imag(Lminus);
-          l[iTime][1] += 0.5 * real(Lminus);
-        }
-      }
+#ifndef DOXYGEN
+namespace {
+  // Shared by Waveform and WaveformView
+  template <typename WaveformType>
+  vector<Matrix> LLMatrixOfModes(const WaveformType& W, vector<int> Lmodes) {
+    const vector<AngularMomentumMoments> Moments = AngularMomentumKernel(W, Lmodes, false, true);
+    vector<Matrix> ll(W.NTimes(), Matrix(3,3));
+    for(unsigned int iTime=0; iTime<W.NTimes(); ++iTime) {
+      const double* LL = Moments[iTime].LL;
+      ll[iTime](0,0) = LL[0];
+      ll[iTime](0,1) = ll[iTime](1,0) = LL[1];
+      ll[iTime](0,2) = ll[iTime](2,0) = LL[2];
+      ll[iTime](1,1) = LL[3];
+      ll[iTime](1,2) = ll[iTime](2,1) = LL[4];
+      ll[iTime](2,2) = LL[5];
     }
+    return ll;
   }
-  return l;
 }
+#endif // DOXYGEN
 
 /// Calculate the \f$<LL>\f$ quantity defined in the paper.
 vector<Matrix> GWFrames::Waveform::LLMatrix(vector<int> Lmodes) const {
@@ -1518,72 +2886,13 @@ vector<Matrix> GWFrames::Waveform::LLMatrix(vector<int> Lmodes) const {
   /// frame (X,Y,Z), rather than the inertial frame (x,y,z).
   ///
   /// \f$<LL>^{ab} = \sum_{\ell,m,m'} [\bar{f}^{\ell,m'} < \ell,m' | L_a L_b | \ell,m > f^{\ell,m} ]\f$
+  GWFrames_INSTRUMENT("Waveform::LLMatrix");
+  return LLMatrixOfModes(*this, Lmodes);
+}
 
-  // Big, bad, ugly, obvious way to do the calculation
-
-  // L+ = Lx + i Ly      Lx =    (L+ + L-) / 2     Im(Lx) =  ( Im(L+) + Im(L-) ) / 2
-  // L- = Lx - i Ly      Ly = -i (L+ - L-) / 2     Im(Ly) = -( Re(L+) - Re(L-) ) / 2
-  // Lz = Lz             Lz = Lz                   Im(Lz) = Im(Lz)
-  // LxLx =   (L+ + L-)(L+ + L-) / 4
-  // LxLy = -i(L+ + L-)(L+ - L-) / 4
-  // LxLz =   (L+ + L-)(  Lz   ) / 2
-  // LyLx = -i(L+ - L-)(L+ + L-) / 4
-  // LyLy =  -(L+ - L-)(L+ - L-) / 4
-  // LyLz = -i(L+ - L-)(  Lz   ) / 2
-  // LzLx =   (  Lz   )(L+ + L-) / 2
-  // LzLy = -i(  Lz   )(L+ - L-) / 2
-  // LzLz =   (  Lz   )(  Lz   )
-  vector<Matrix> ll(NTimes(), Matrix(3,3));
-  const complex<double> ImaginaryI(0.0,1.0);
-  if(Lmodes.size()==0) {
-    Lmodes.push_back(lm[0][0]);
-    for(unsigned int i_m=0; i_m<NModes(); ++i_m) {
-      if(std::find(Lmodes.begin(), Lmodes.end(), lm[i_m][0]) == Lmodes.end() ) {
-        Lmodes.push_back(lm[i_m][0]);
-      }
-    }
-  }
-  for(unsigned int iL=0; iL<Lmodes.size(); ++iL) {
-    const int L = Lmodes[iL];
-    for(int M=-L; M<=L; ++M) {
-      const int iMm2 = (M-2>=-L ? FindModeIndex(L,M-2) : 0);
-      const int iMm1 = (M-1>=-L ? FindModeIndex(L,M-1) : 0);
-      const int iM   = FindModeIndex(L,M);
-      const int iMp1 = (M+1<=L ? FindModeIndex(L,M+1) : 0);
-      const int iMp2 = (M+2<=L ? FindModeIndex(L,M+2) : 0);
-      for(unsigned int iTime=0; iTime<NTimes(); ++iTime) {
-        const complex<double> LpLp = (M+2<=L  ? conj(data[iMp2][iTime]) * LadderOperatorFactor(L, M+1)    * LadderOperatorFactor(L, M) * data[iM][iTime] : 0.0);
-        const complex<double> LpLm = (M-1>=-L ? conj(data[iM][iTime])   * LadderOperatorFactor(L, M-1)    * LadderOperatorFactor(L, -M) * data[iM][iTime] : 0.0);
-        const complex<double> LmLp = (M+1<=L  ? conj(data[iM][iTime])   * LadderOperatorFactor(L, -(M+1)) * LadderOperatorFactor(L, M) * data[iM][iTime] : 0.0);
-        const complex<double> LmLm = (M-2>=-L ? conj(data[iMm2][iTime]) * LadderOperatorFactor(L, -(M-1)) * LadderOperatorFactor(L, -M) * data[iM][iTime] : 0.0);
-        const complex<double> LpLz = (M+1<=L  ? conj(data[iMp1][iTime]) * LadderOperatorFactor(L, M) * double(M)      * data[iM][iTime] : 0.0);
-        const complex<double> LzLp = (M+1<=L  ? conj(data[iMp1][iTime]) * double(M+1) * LadderOperatorFactor(L, M)  * data[iM][iTime] : 0.0);
-        const complex<double> LmLz = (M-1>=-L ? conj(data[iMm1][iTime]) * LadderOperatorFactor(L, -M) * double(M)     * data[iM][iTime] : 0.0);
-        const complex<double> LzLm = (M-1>=-L ? conj(data[iMm1][iTime]) * double(M-1) * LadderOperatorFactor(L, -M) * data[iM][iTime] : 0.0);
-        const complex<double> LzLz = conj(data[iM][iTime]) * double(M) * double(M) * data[iM][iTime];
-        //
-        const complex<double> LxLx = 0.25 * (LpLp + LmLm + LmLp + LpLm);
-        const complex<double> LxLy = -0.25 * ImaginaryI * (LpLp - LmLm + LmLp - LpLm);
-        const complex<double> LxLz = 0.5 * (LpLz + LmLz);
-        const complex<double> LyLx = -0.25 * ImaginaryI * (LpLp - LmLp + LpLm - LmLm);
-        const complex<double> LyLy = -0.25 * (LpLp - LmLp - LpLm + LmLm);
-        const complex<double> LyLz = -0.5 * ImaginaryI * (LpLz - LmLz);
-        const complex<double> LzLx = 0.5 * (LzLp + LzLm);
-        const complex<double> LzLy = -0.5 * ImaginaryI * (LzLp - LzLm);
-        //const complex<double> LzLz = (LzLz);
-        ll[iTime](0,0) += real( LxLx );
-        ll[iTime](0,1) += real( LxLy + LyLx )/2.0;
-        ll[iTime](0,2) += real( LxLz + LzLx )/2.0;
-        ll[iTime](1,0) += real( LyLx + LxLy )/2.0;
-        ll[iTime](1,1) += real( LyLy );
-        ll[iTime](1,2) += real( LyLz + LzLy )/2.0;
-        ll[iTime](2,0) += real( LzLx + LxLz )/2.0;
-        ll[iTime](2,1) += real( LzLy + LyLz )/2.0;
-        ll[iTime](2,2) += real( LzLz );
-      }
-    }
-  }
-  return ll;
+/// Calculate the \f$<LL>\f$ quantity for the viewed data.
+vector<Matrix> GWFrames::WaveformView::LLMatrix(vector<int> Lmodes) const {
+  return LLMatrixOfModes(*this, Lmodes);
 }
 
 /// Calculate the principal axis of the LL matrix, as prescribed by O'Shaughnessy et al.
@@ -1606,59 +2915,66 @@ std::vector<std::vector<double> > GWFrames::Waveform::LLDominantEigenvector(cons
   ///
   /// The vector is given in the (possibly rotating) mode frame
   /// (X,Y,Z), rather than the inertial frame (x,y,z).
+  GWFrames_INSTRUMENT("Waveform::LLDominantEigenvector");
 
   // Calculate the LL matrix at each instant
-  vector<Matrix> ll = LLMatrix(Lmodes);
+  const vector<AngularMomentumMoments> Moments = AngularMomentumKernel(*this, Lmodes, false, true);
+  vector<double> Packed(6*NTimes());
+  for(unsigned int i=0; i<NTimes(); ++i) {
+    std::copy(Moments[i].LL, Moments[i].LL+6, Packed.begin()+6*i);
+  }
 
-  // Calculate the dominant principal axis (dpa) of LL at each instant
+  // Calculate the dominant principal axis (dpa) of LL at each
+  // instant, with the initial direction closer to
+  // RoughInitialEllDirection than not, and the rest continuous
+  const vector<double> InitialDirection = RoughInitialEllDirection.vec();
+  vector<double> Axes(3*NTimes());
+  if(NTimes()>0) {
+    GWFrames::DominantPrincipalAxes(NTimes(), &Packed[0], &Axes[0], &InitialDirection[0]);
+  }
   vector<vector<double> > dpa(NTimes(), vector<double>(3));
-  for(unsigned int i=0; i<ll.size(); ++i) {
-    dpa[i] = GWFrames::DominantPrincipalAxis(ll[i]);
-  }
-
-  // Make the initial direction closer to RoughInitialEllDirection than not
-  if(RoughInitialEllDirection.dot(dpa[0])<0.) {
-    dpa[0][0] = -dpa[0][0];
-    dpa[0][1] = -dpa[0][1];
-    dpa[0][2] = -dpa[0][2];
-  }
-
-  // Now, go through and make the vectors reasonably continuous.
-  if(dpa.size()>0) {
-    double LastNorm = std::sqrt(dpa[0][0]*dpa[0][0]+dpa[0][1]*dpa[0][1]+dpa[0][2]*dpa[0][2]);
-    for(unsigned int i=1; i<dpa.size(); ++i) {
-      const double x=dpa[i][0];
-      const double y=dpa[i][1];
-      const double z=dpa[i][2];
-      const double dx=x-dpa[i-1][0];
-      const double dy=y-dpa[i-1][1];
-      const double dz=z-dpa[i-1][2];
-      const double Norm = std::sqrt(x*x+y*y+z*z);
-      const double dNorm = std::sqrt(dx*dx+dy*dy+dz*dz);
-      if(dNorm>Norm) {
-        dpa[i][0] = -dpa[i][0];
-        dpa[i][1] = -dpa[i][1];
-        dpa[i][2] = -dpa[i][2];
-      }
-      // While we're here, let's just normalize that last one
-      if(LastNorm!=0.0) {
-        dpa[i-1][0] = dpa[i-1][0] / LastNorm;
-        dpa[i-1][1] = dpa[i-1][1] / LastNorm;
-        dpa[i-1][2] = dpa[i-1][2] / LastNorm;
-      }
-      LastNorm = Norm;
-    }
-    if(LastNorm!=0.0) {
-      const unsigned int i=dpa.size();
-      dpa[i-1][0] = dpa[i-1][0] / LastNorm;
-      dpa[i-1][1] = dpa[i-1][1] / LastNorm;
-      dpa[i-1][2] = dpa[i-1][2] / LastNorm;
-    }
+  for(unsigned int i=0; i<NTimes(); ++i) {
+    dpa[i].assign(Axes.begin()+3*i, Axes.begin()+3*i+3);
   }
 
   return dpa;
 }
 
+#ifndef DOXYGEN
+namespace {
+  // Shared by Waveform and WaveformView
+  template <typename WaveformType>
+  vector<vector<double> > AngularVelocityVectorOfModes(const WaveformType& W, const vector<int>& Lmodes) {
+
+    // Calculate the L vector and LL matrix at each instant, in one pass
+    const vector<AngularMomentumMoments> Moments = AngularMomentumKernel(W, Lmodes, true, true);
+
+    // Solve   -omega * LL = L   at each time step.  LL is symmetric,
+    // so we just use its adjugate.
+    vector<vector<double> > omega(W.NTimes(), vector<double>(3));
+    const int NTimes = W.NTimes();
+    #pragma omp parallel for schedule(static) if(NTimes>AngularMomentumBlockSize) num_threads(GWFrames::MaxThreads())
+    for(int iTime=0; iTime<NTimes; ++iTime) {
+      const double* l = Moments[iTime].Ldt;
+      const double* LL = Moments[iTime].LL;
+      const double xx=LL[0], xy=LL[1], xz=LL[2], yy=LL[3], yz=LL[4], zz=LL[5];
+      const double A00 = yy*zz-yz*yz;
+      const double A01 = xz*yz-xy*zz;
+      const double A02 = xy*yz-xz*yy;
+      const double A11 = xx*zz-xz*xz;
+      const double A12 = xy*xz-xx*yz;
+      const double A22 = xx*yy-xy*xy;
+      const double det = xx*A00 + xy*A01 + xz*A02;
+      omega[iTime][0] = -(A00*l[0] + A01*l[1] + A02*l[2]) / det;
+      omega[iTime][1] = -(A01*l[0] + A11*l[1] + A12*l[2]) / det;
+      omega[iTime][2] = -(A02*l[0] + A12*l[1] + A22*l[2]) / det;
+    }
+
+    return omega;
+  }
+}
+#endif // DOXYGEN
+
 /// Calculate the angular velocity of the Waveform.
 vector<vector<double> > GWFrames::Waveform::AngularVelocityVector(const vector<int>& Lmodes) const {
   ///
@@ -1674,35 +2990,13 @@ vector<vector<double> > GWFrames::Waveform::AngularVelocityVector(const vector<i
   /// Lmodes to [2] or [2,3,4], for example, restricts the range of
   /// the sum.
   ///
+  GWFrames_INSTRUMENT("Waveform::AngularVelocityVector");
+  return AngularVelocityVectorOfModes(*this, Lmodes);
+}
 
-  // Calculate the L vector and LL matrix at each instant
-  vector<vector<double> > l = LdtVector(Lmodes);
-  vector<Matrix> ll = LLMatrix(Lmodes);
-
-  // Construct some objects for storage
-  vector<vector<double> > omega(NTimes(), vector<double>(3));
-  int s;
-  gsl_vector* x = gsl_vector_alloc(3);
-  gsl_permutation* p = gsl_permutation_alloc(3);
-
-  // Loop through time steps
-  for(unsigned int iTime=0; iTime<omega.size(); ++iTime) {
-    // Solve   -omega * LL = L   at each time step, using LU decomposition
-    gsl_vector_view b = gsl_vector_view_array(&l[iTime][0], 3);
-    gsl_linalg_LU_decomp(ll[iTime].gslobj(), p, &s);
-    gsl_linalg_LU_solve(ll[iTime].gslobj(), p, &b.vector, x);
-
-    // Save data for this time step
-    omega[iTime][0] = -gsl_vector_get(x, 0);
-    omega[iTime][1] = -gsl_vector_get(x, 1);
-    omega[iTime][2] = -gsl_vector_get(x, 2);
-  }
-
-  // Free the memory
-  gsl_permutation_free(p);
-  gsl_vector_free(x);
-
-  return omega;
+/// Calculate the angular velocity of the viewed data.
+vector<vector<double> > GWFrames::WaveformView::AngularVelocityVector(const vector<int>& Lmodes) const {
+  return AngularVelocityVectorOfModes(*this, Lmodes);
 }
 
 /// Calculate the angular velocity of the Waveform.
@@ -1786,6 +3080,7 @@ GWFrames::Waveform& GWFrames::Waveform::TransformToCoprecessingFrame(const std::
   /// Lmodes to [2] or [2,3,4], for example, restricts the range of
   /// the sum.
   ///
+  GWFrames_INSTRUMENT("Waveform::TransformToCoprecessingFrame");
   Quaternions::Quaternion RoughInitialEllDirection;
   const unsigned int NPointsForDeriv = 7;
   if(NTimes()<=NPointsForDeriv || FrameType()==GWFrames::Coorbital || FrameType()==GWFrames::Corotating) {
@@ -1795,7 +3090,7 @@ GWFrames::Waveform& GWFrames::Waveform::TransformToCoprecessingFrame(const std::
     // output of GSL.
     RoughInitialEllDirection = Quaternions::zHat;
   } else {
-    const Waveform Segment = SliceOfTimeIndices(0, NPointsForDeriv);
+    const WaveformView Segment = ViewOfTimeIndices(0, NPointsForDeriv);
     RoughInitialEllDirection = Quaternions::Quaternion(Segment.AngularVelocityVector()[NPointsForDeriv/2]); // Using integer division
   }
   history << "this->TransformToCoprecessingFrame(" << StringForm(Lmodes) << ")\n#";
@@ -1817,6 +3112,7 @@ GWFrames::Waveform& GWFrames::Waveform::TransformToAngularVelocityFrame(const st
   /// Lmodes to [2] or [2,3,4], for example, restricts the range of
   /// the sum.
   ///
+  GWFrames_INSTRUMENT("Waveform::TransformToAngularVelocityFrame");
   history << "this->TransformToAngularVelocityFrame(" << StringForm(Lmodes) << ")\n#";
   vector<Quaternion> R_AV = normalized(QuaternionArray(this->AngularVelocityVector(Lmodes)));
   this->frameType = GWFrames::Coprecessing;
@@ -1838,6 +3134,7 @@ GWFrames::Waveform& GWFrames::Waveform::TransformToCorotatingFrame(const std::ve
   /// Lmodes to [2] or [2,3,4], for example, restricts the range of
   /// the sum.
   ///
+  GWFrames_INSTRUMENT("Waveform::TransformToCorotatingFrame");
 
   vector<Quaternion> R_corot = this->CorotatingFrame(Lmodes);
   this->frameType = GWFrames::Corotating;
@@ -1853,6 +3150,7 @@ GWFrames::Waveform& GWFrames::Waveform::TransformToInertialFrame() {
   /// stationary, inertial frame.  This is the usual frame of scri^+,
   /// and is the frame in which GW observations should be made.
   ///
+  GWFrames_INSTRUMENT("Waveform::TransformToInertialFrame");
 
   if(frameType == GWFrames::Inertial) {
     INFOTOCERR << "\nWarning: Waveform is already in the " << GWFrames::WaveformFrameNames[GWFrames::Inertial] << " frame;"
@@ -1901,6 +3199,7 @@ GWFrames::Waveform GWFrames::Waveform::Interpolate(const std::vector<double>& Ne
   /// time data.  If false, and such times are requested, an error
   /// will be thrown.
   ///
+  GWFrames_INSTRUMENT_BYTES("Waveform::Interpolate", NewTime.size()*NModes()*sizeof(std::complex<double>));
   if(NewTime.size()==0) {
     INFOTOCERR << ": Asking for empty Waveform." << std::endl;
     throw(GWFrames_EmptyIntersection);
@@ -1935,8 +3234,8 @@ GWFrames::Waveform GWFrames::Waveform::Interpolate(const std::vector<double>& Ne
 
   Waveform C;
   C.spinweight = this->spinweight;
-  C.history << HistoryStr()
-            << "### *this = this->Interpolate(NewTime," << AllowTimesOutsideCurrentDomain << ");" << std::endl;
+  C.history.Include(history);
+  C.history << "### *this = this->Interpolate(NewTime," << AllowTimesOutsideCurrentDomain << ");" << std::endl;
   C.t = NewTime;
   if(frame.size()==1) { // Assume we have just a constant non-trivial frame
     C.frame = frame;
@@ -1962,49 +3261,27 @@ GWFrames::Waveform GWFrames::Waveform::Interpolate(const std::vector<double>& Ne
   C.rIsScaledOut = rIsScaledOut;
   C.mIsScaledOut = mIsScaledOut;
   C.lm = lm;
+  C.modeLayout = modeLayout;
   C.data.resize(NModes(), NewTime.size());
-  // Initialize the GSL interpolators for the data
-  gsl_interp_accel* accRe = gsl_interp_accel_alloc();
-  gsl_interp_accel* accIm = gsl_interp_accel_alloc();
-  gsl_spline* splineRe = gsl_spline_alloc(gsl_interp_cspline, NTimes());
-  gsl_spline* splineIm = gsl_spline_alloc(gsl_interp_cspline, NTimes());
-  // Now loop over each mode filling in the waveform data
-  for(unsigned int i_m=0; i_m<C.NModes(); ++i_m) {
-    // Extract the real and imaginary parts of the data separately for GSL
-    const vector<double> re = Re(i_m);
-    const vector<double> im = Im(i_m);
-    // Initialize the interpolators for this data set
-    gsl_spline_init(splineRe, &(t)[0], &re[0], NTimes());
-    gsl_spline_init(splineIm, &(t)[0], &im[0], NTimes());
-    // Assign the interpolated data
-    if(AllowTimesOutsideCurrentDomain) {
-      for(unsigned int i_t=0; i_t<i0; ++i_t) {
-        C.data[i_m][i_t] = complex<double>( 0., 0. );
-      }
-      for(unsigned int i_t=i0; i_t<i1; ++i_t) {
-        C.data[i_m][i_t] = complex<double>( gsl_spline_eval(splineRe, NewTimesInsideCurrentDomain[i_t], accRe),
-                                            gsl_spline_eval(splineIm, NewTimesInsideCurrentDomain[i_t], accIm) );
-      }
-      for(unsigned int i_t=i1; i_t<i2; ++i_t) {
-        C.data[i_m][i_t] = complex<double>( 0., 0. );
-      }
-    } else {
-      for(unsigned int i_t=0; i_t<C.t.size(); ++i_t) {
-        C.data[i_m][i_t] = complex<double>( gsl_spline_eval(splineRe, C.t[i_t], accRe), gsl_spline_eval(splineIm, C.t[i_t], accIm) );
-      }
+  // Factor the spline system for these times just once, and
+  // interpolate all the modes with it (times outside the current
+  // domain are left as zero)
+  if(AllowTimesOutsideCurrentDomain) {
+    if(i1>i0) {
+      const GWFrames::SplineInterpolationPlan Plan(t, NewTimesInsideCurrentDomain);
+      Plan.Interpolate(data, C.data, i0);
     }
+  } else {
+    const GWFrames::SplineInterpolationPlan Plan(t, C.t);
+    Plan.Interpolate(data, C.data);
   }
-  // Free the interpolators
-  gsl_interp_accel_free(accRe);
-  gsl_interp_accel_free(accIm);
-  gsl_spline_free(splineRe);
-  gsl_spline_free(splineIm);
 
   return C;
 }
 
 /// Interpolate the Waveform to a new set of time instants.
 GWFrames::Waveform& GWFrames::Waveform::InterpolateInPlace(const std::vector<double>& NewTime) {
+  GWFrames_INSTRUMENT_BYTES("Waveform::InterpolateInPlace", NewTime.size()*NModes()*sizeof(std::complex<double>));
   if(NewTime.size()==0) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Asking for empty Waveform." << std::endl;
     throw(GWFrames_EmptyIntersection);
@@ -2020,8 +3297,7 @@ GWFrames::Waveform& GWFrames::Waveform::InterpolateInPlace(const std::vector<dou
     throw(GWFrames_EmptyIntersection);
   }
 
-  history << HistoryStr()
-          << "*this = this->Interpolate(NewTime);" << std::endl;
+  history << "*this = this->Interpolate(NewTime);" << std::endl;
   const vector<double> OldTime(t);
   if(frame.size()==1) { // Assume we have just a constant non-trivial frame
     frame = frame;
@@ -2030,35 +3306,154 @@ GWFrames::Waveform& GWFrames::Waveform::InterpolateInPlace(const std::vector<dou
   }
   MatrixC NewData;
   NewData.resize(NModes(), NewTime.size());
-  // Initialize the GSL interpolators for the data
-  gsl_interp_accel* accRe = gsl_interp_accel_alloc();
-  gsl_interp_accel* accIm = gsl_interp_accel_alloc();
-  gsl_spline* splineRe = gsl_spline_alloc(gsl_interp_cspline, OldTime.size());
-  gsl_spline* splineIm = gsl_spline_alloc(gsl_interp_cspline, OldTime.size());
-  // Now loop over each mode filling in the waveform data
-  for(unsigned int i_m=0; i_m<NModes(); ++i_m) {
-    // Extract the real and imaginary parts of the data separately for GSL
-    const vector<double> re(Re(i_m));
-    const vector<double> im(Im(i_m));
-    // Initialize the interpolators for this data set
-    gsl_spline_init(splineRe, &(OldTime)[0], &re[0], OldTime.size());
-    gsl_spline_init(splineIm, &(OldTime)[0], &im[0], OldTime.size());
-    // Assign the interpolated data
-    for(unsigned int i_t=0; i_t<NewTime.size(); ++i_t) {
-      NewData[i_m][i_t] = complex<double>( gsl_spline_eval(splineRe, NewTime[i_t], accRe), gsl_spline_eval(splineIm, NewTime[i_t], accIm) );
-    }
-  }
+  // Factor the spline system for these times just once, and
+  // interpolate all the modes with it
+  const GWFrames::SplineInterpolationPlan Plan(OldTime, NewTime);
+  Plan.Interpolate(data, NewData);
   data.swap(NewData);
   t = NewTime;
-  // Free the interpolators
-  gsl_interp_accel_free(accRe);
-  gsl_interp_accel_free(accIm);
-  gsl_spline_free(splineRe);
-  gsl_spline_free(splineIm);
 
   return *this;
 }
 
+/// Keep only enough time samples to reconstruct every mode to within a tolerance
+GWFrames::Waveform GWFrames::Waveform::Decimate(const double Tolerance, const bool AmplitudePhase) const {
+  ///
+  /// \param Tolerance Largest error allowed in any mode, relative to the largest mode amplitude
+  /// \param AmplitudePhase If true, reconstruct the amplitude and phase of each mode, rather than Re and Im
+  ///
+  /// The returned Waveform has a subset of the time samples of this
+  /// one, with their data and frame unchanged.  The subset is chosen
+  /// so that natural cubic splines through the remaining samples
+  /// reproduce each mode at every original time to within
+  /// `Tolerance` times the largest amplitude of any mode.  With the
+  /// default (Re and Im), this is exactly the reconstruction done by
+  /// `Interpolate(T())`.  With `AmplitudePhase`, the splines are of
+  /// the amplitude and unwrapped phase of each mode, which needs far
+  /// fewer samples for a slow inspiral, but the data must then be
+  /// reconstructed the same way.  The frame is not checked.
+  ///
+  /// Starting from a few evenly spaced samples, the worst sample
+  /// between each pair of kept samples is added wherever the error
+  /// exceeds the tolerance, until none does.
+  GWFrames_INSTRUMENT_BYTES("Waveform::Decimate", NModes()*NTimes()*sizeof(std::complex<double>));
+  const int N = NTimes();
+  const int NModes = this->NModes();
+  if(N<3 || NModes==0) {
+    Waveform W(*this);
+    W.history << "this->Decimate(" << Tolerance << ", " << AmplitudePhase << ");" << std::endl;
+    return W;
+  }
+
+  // The data to be splined
+  MatrixC AP;
+  if(AmplitudePhase) {
+    AP.resize(NModes, N);
+    for(int i_m=0; i_m<NModes; ++i_m) {
+      const vector<double> A = Abs(i_m);
+      const vector<double> Phi = ArgUnwrapped(i_m);
+      for(int i_t=0; i_t<N; ++i_t) {
+        AP[i_m][i_t] = std::complex<double>(A[i_t], Phi[i_t]);
+      }
+    }
+  }
+  const MatrixC& Y = (AmplitudePhase ? AP : data);
+  double MaxAmplitude = 0.0;
+  for(int i_m=0; i_m<NModes; ++i_m) {
+    for(int i_t=0; i_t<N; ++i_t) {
+      MaxAmplitude = std::max(MaxAmplitude, std::abs(data[i_m][i_t]));
+    }
+  }
+  const double AbsoluteTolerance = Tolerance*MaxAmplitude;
+
+  // Start with evenly spaced samples, including both ends
+  const int NInitial = std::min(N, 9);
+  vector<unsigned int> Kept(NInitial);
+  for(int k=0; k<NInitial; ++k) {
+    Kept[k] = (k*(N-1))/(NInitial-1);
+  }
+
+  const int BlockSize = 1024;
+  const int NBlocks = (N+BlockSize-1)/BlockSize;
+  vector<double> Error(N);
+  MatrixC YKept, YNew(NModes, N);
+  for(;;) {
+    const int NKept = Kept.size();
+    vector<double> TKept(NKept);
+    YKept.resize(NModes, NKept);
+    for(int k=0; k<NKept; ++k) {
+      TKept[k] = t[Kept[k]];
+    }
+    for(int i_m=0; i_m<NModes; ++i_m) {
+      for(int k=0; k<NKept; ++k) {
+        YKept[i_m][k] = Y[i_m][Kept[k]];
+      }
+    }
+    const GWFrames::SplineInterpolationPlan Plan(TKept, t);
+    Plan.Interpolate(YKept, YNew);
+
+    // Find the largest error of any mode at each time
+    #pragma omp parallel for schedule(static) if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+    for(int i_b=0; i_b<NBlocks; ++i_b) {
+      const int i_t_a = i_b*BlockSize;
+      const int i_t_b = std::min(N, i_t_a+BlockSize);
+      for(int i_t=i_t_a; i_t<i_t_b; ++i_t) { Error[i_t] = 0.0; }
+      for(int i_m=0; i_m<NModes; ++i_m) {
+        const std::complex<double>* h = data[i_m];
+        const std::complex<double>* hNew = YNew[i_m];
+        for(int i_t=i_t_a; i_t<i_t_b; ++i_t) {
+          const std::complex<double> Reconstructed
+            = (AmplitudePhase ? std::polar(std::real(hNew[i_t]), std::imag(hNew[i_t])) : hNew[i_t]);
+          Error[i_t] = std::max(Error[i_t], std::abs(Reconstructed-h[i_t]));
+        }
+      }
+    }
+
+    // Add the worst sample in each interval that fails
+    vector<unsigned int> NewKept;
+    NewKept.reserve(2*NKept);
+    for(int k=0; k<NKept-1; ++k) {
+      NewKept.push_back(Kept[k]);
+      unsigned int i_worst = Kept[k];
+      for(unsigned int i_t=Kept[k]+1; i_t<Kept[k+1]; ++i_t) {
+        if(Error[i_t]>Error[i_worst]) { i_worst = i_t; }
+      }
+      if(i_worst!=Kept[k] && Error[i_worst]>AbsoluteTolerance) {
+        NewKept.push_back(i_worst);
+      }
+    }
+    NewKept.push_back(Kept.back());
+    if(int(NewKept.size())==NKept) { break; }
+    Kept.swap(NewKept);
+  }
+
+  // Copy the kept samples
+  Waveform W = this->CopyWithoutData();
+  W.history << "this->Decimate(" << Tolerance << ", " << AmplitudePhase << ");" << std::endl;
+  const int NKept = Kept.size();
+  W.t.resize(NKept);
+  for(int k=0; k<NKept; ++k) {
+    W.t[k] = t[Kept[k]];
+  }
+  if(frame.size()>1) {
+    W.frame.resize(NKept);
+    for(int k=0; k<NKept; ++k) {
+      W.frame[k] = frame[Kept[k]];
+    }
+  } else {
+    W.frame = frame;
+  }
+  W.lm = lm;
+  W.modeLayout = modeLayout;
+  W.data.resize(NModes, NKept);
+  for(int i_m=0; i_m<NModes; ++i_m) {
+    for(int k=0; k<NKept; ++k) {
+      W.data[i_m][k] = data[i_m][Kept[k]];
+    }
+  }
+  return W;
+}
+
 /// Find the appropriate rotations to fix the attitude of the corotating frame.
 std::vector<Quaternions::Quaternion> GWFrames::Waveform::GetAlignmentsOfDecompositionFrameToModes(const std::vector<int>& Lmodes) const {
   ///
@@ -2284,25 +3679,22 @@ GWFrames::Waveform& GWFrames::Waveform::AlignDecompositionFrameToModes(const dou
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_min.h>
 #include <gsl/gsl_multimin.h>
-// This is a local object used by `AlignWaveforms`
-class WaveformAligner {
+// This is a local object used by `AlignWaveforms`, holding everything
+// that depends only on the fixed waveform and the alignment window.
+// It is computed once, and shared by every alignment against that
+// window.
+class AlignmentWindow {
 public:
-  std::vector<Quaternions::Quaternion> R_fA;
-  std::vector<double> t_A;
-  const GWFrames::Waveform& W_A;
-  const GWFrames::Waveform& W_B;
+  const double t_1;
+  const double t_2;
   const double t_mid;
-  std::vector<Quaternion> R_epsB;
-  bool R_epsB_is_set;
-  mutable unsigned int Rbar_epsB_i; // Just a guess to speed up hunting for the index
-  const bool Debug;
-  mutable ofstream UpsilonFile;
+  std::vector<double> t_A;
+  std::vector<Quaternions::Quaternion> R_fA;
+  std::vector<double> Weights; // Trapezoid-rule weights for integrals over t_A
+  GWFrames::Waveform W_A_interp; // W_A interpolated to t_A
 public:
-  WaveformAligner(const GWFrames::Waveform& iW_A, const GWFrames::Waveform& iW_B,
-                  const double t_1, const double t_2, const bool iDebug)
-    : R_fA(iW_A.Frame()), t_A(iW_A.T()), W_A(iW_A), W_B(iW_B), t_mid((t_1+t_2)/2.),
-      R_epsB(0), R_epsB_is_set(false), Rbar_epsB_i(0), Debug(iDebug),
-      UpsilonFile()
+  AlignmentWindow(const GWFrames::Waveform& W_A, const double it_1, const double it_2)
+    : t_1(it_1), t_2(it_2), t_mid((it_1+it_2)/2.), t_A(W_A.T()), R_fA(W_A.Frame()), Weights(), W_A_interp()
   {
     // Check to make sure we have sufficient times before any offset.
     // (This is necessary but not sufficient for the method to work.)
@@ -2316,18 +3708,6 @@ public:
                 << " does not occur in t_A (which has t_A.back()=" << t_A.back() << ")." << std::endl;
       throw(GWFrames_IndexOutOfBounds);
     }
-    if(W_B.NTimes()>0) {
-      if(t_1<W_B.T(0)) {
-        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Alignment time t_1=" << t_1
-                  << " does not occur in W_B (which has W_B.T(0)=" << W_B.T(0) << ")." << std::endl;
-        throw(GWFrames_IndexOutOfBounds);
-      }
-      if(t_2>W_B.T(W_B.NTimes()-1)) {
-        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Alignment time t_2=" << t_2
-                  << " does not occur in W_B (which has W_B.T(-1)=" << W_B.T(W_B.NTimes()-1) << ")." << std::endl;
-        throw(GWFrames_IndexOutOfBounds);
-      }
-    }
     // Trim the fixed frame (R_fA) and its set of times, to which we
     // will interpolate.
     unsigned int i=t_A.size()-1;
@@ -2338,6 +3718,64 @@ public:
     while(i<t_A.size() && t_A[i]<t_1) { ++i; }
     t_A.erase(t_A.begin(), t_A.begin()+i);
     R_fA.erase(R_fA.begin(), R_fA.begin()+i);
+    if(t_A.size()<2) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Only " << t_A.size()
+                << " time steps of W_A lie in the alignment window (" << t_1 << ", " << t_2 << ")." << std::endl;
+      throw(GWFrames_EmptyIntersection);
+    }
+
+    Weights.assign(t_A.size(), 0.0);
+    for(unsigned int j=1; j<t_A.size(); ++j) {
+      Weights[j-1] += (t_A[j]-t_A[j-1])/2.0;
+      Weights[j] += (t_A[j]-t_A[j-1])/2.0;
+    }
+
+    W_A_interp = W_A.Interpolate(t_A);
+  }
+};
+
+// This is a local object used by `AlignWaveforms`.  Apart from the
+// Debug output, its methods may be called from several threads at
+// once.
+class WaveformAligner {
+public:
+  const AlignmentWindow& Window;
+  const std::vector<Quaternions::Quaternion>& R_fA;
+  const std::vector<double>& t_A;
+  const GWFrames::Waveform& W_B;
+  const double t_mid;
+  std::vector<Quaternion> R_epsB;
+  bool R_epsB_is_set;
+  // The part of W_B's frame that can be reached by the allowed time
+  // offsets, with a few extra steps on each side so that the
+  // interpolation is identical to using the whole frame
+  std::vector<double> t_B;
+  std::vector<Quaternion> R_fB;
+  const bool Debug;
+  mutable ofstream UpsilonFile;
+public:
+  WaveformAligner(const AlignmentWindow& iWindow, const GWFrames::Waveform& iW_B,
+                  const double deltat_1, const double deltat_2, const bool iDebug)
+    : Window(iWindow), R_fA(iWindow.R_fA), t_A(iWindow.t_A), W_B(iW_B), t_mid(iWindow.t_mid),
+      R_epsB(0), R_epsB_is_set(false), t_B(), R_fB(), Debug(iDebug), UpsilonFile()
+  {
+    if(W_B.NTimes()>0) {
+      if(Window.t_1<W_B.T(0)) {
+        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Alignment time t_1=" << Window.t_1
+                  << " does not occur in W_B (which has W_B.T(0)=" << W_B.T(0) << ")." << std::endl;
+        throw(GWFrames_IndexOutOfBounds);
+      }
+      if(Window.t_2>W_B.T(W_B.NTimes()-1)) {
+        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Alignment time t_2=" << Window.t_2
+                  << " does not occur in W_B (which has W_B.T(-1)=" << W_B.T(W_B.NTimes()-1) << ")." << std::endl;
+        throw(GWFrames_IndexOutOfBounds);
+      }
+      const int Padding = 3;
+      const int i_a = std::max(int(Quaternions::hunt(W_B.T(), t_A[0]+deltat_1))-Padding, 0);
+      const int i_b = std::min(int(Quaternions::hunt(W_B.T(), t_A.back()+deltat_2))+Padding+2, int(W_B.NTimes()));
+      t_B.assign(W_B.T().begin()+i_a, W_B.T().begin()+i_b);
+      R_fB.assign(W_B.Frame().begin()+i_a, W_B.Frame().begin()+i_b);
+    }
 
     if(Debug) {
       INFOTOCERR << "Output to UpsilonIntegral.dat" << std::endl;
@@ -2364,8 +3802,15 @@ public:
     return;
   }
 
-  std::vector<Quaternion> Rbar_fB(const std::vector<double>& t) const {
-    return Quaternions::conjugate(Quaternions::Squad(W_B.Frame(), W_B.T(), t));
+  // The frame of W_B interpolated to the times t_A+deltat.  The
+  // result is the same whether or not the stored part of the frame is
+  // used; it is just faster when it is.
+  std::vector<Quaternion> R_fB_interp(const double deltat) const {
+    using namespace Quaternions; // Allow me to add a double to a vector<double> below
+    if(t_B.size()>4 && t_A[0]+deltat>=t_B[2] && t_A.back()+deltat<=t_B[t_B.size()-3]) {
+      return Quaternions::Squad(R_fB, t_B, t_A+deltat);
+    }
+    return Quaternions::Squad(W_B.Frame(), W_B.T(), t_A+deltat);
   }
 
   Quaternion Rbar_epsB(const double t) const {
@@ -2373,26 +3818,24 @@ public:
       std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": R_epsB has not yet been set." << std::endl;
       throw(GWFrames_ValueError);
     }
-    Rbar_epsB_i = Quaternions::hunt(W_B.T(), t, Rbar_epsB_i);
-    return Quaternions::conjugate(R_epsB[Rbar_epsB_i]);
+    return Quaternions::conjugate(R_epsB[Quaternions::hunt(W_B.T(), t)]);
   }
 
   void FindBestMinimizationWaveform(const std::vector<std::vector<double> >& optima, const std::vector<bool>& try_version,
                                     double& deltat, Quaternion& R_delta, Quaternion& R_eps) const {
-    using namespace Quaternions; // Allow me to add a double to a vector<double> below
-    const GWFrames::Waveform W_A_interp = W_A.Interpolate(t_A);
+    const GWFrames::Waveform& W_A_interp = Window.W_A_interp;
     vector<double> Norms(4, 1e300);
     const Quaternions::Quaternion R_eps0 = W_B.GetAlignmentOfDecompositionFrameToModes(t_mid, Quaternions::xHat);
+    const GWFrames::Waveform W_B_interp0 = W_B.Interpolate(t_A);
+    const unsigned int ntimes = W_B_interp0.NTimes();
+    const unsigned int nmodes = W_B_interp0.NModes();
     for(unsigned int branch_choice=0; branch_choice<4; ++branch_choice) {
-      GWFrames::Waveform W_B_interp = W_B.Interpolate(t_A+optima[branch_choice][0]);
-      const unsigned int ntimes = W_B_interp.NTimes();
-      const unsigned int nmodes = W_B_interp.NModes();
       if(try_version[branch_choice]) {
         if(branch_choice==0) { R_eps = R_eps0; }
         else if(branch_choice==1) { R_eps = -R_eps0; }
         else if(branch_choice==2) { R_eps = R_eps0*Quaternions::zHat; }
         else if(branch_choice==3) { R_eps = -R_eps0*Quaternions::zHat; }
-        W_B_interp = W_B.Interpolate(t_A);
+        GWFrames::Waveform W_B_interp(W_B_interp0);
         W_B_interp.RotateDecompositionBasis(R_eps);
         for(unsigned int i_B=0; i_B<nmodes; ++i_B) {
           const unsigned int i_A = W_A_interp.FindModeIndex(W_B.LM(i_B)[0], W_B.LM(i_B)[1]);
@@ -2430,33 +3873,403 @@ public:
     return;
   }
 
+  // The objective function, given W_B's frame interpolated to
+  // t_A+deltat.  Because the rotors R_delta and R_eps are constant,
+  // interpolating R_delta*R_fB*R_eps is the same as multiplying the
+  // interpolated R_fB, so one interpolation serves any number of
+  // rotations at the same deltat.
+  double Upsilon(const std::vector<Quaternion>& R_fB_i, const Quaternion& R_delta, const Quaternion& R_eps) const {
+    const unsigned int Size=R_fB_i.size();
+    double f = 0.0;
+    for(unsigned int i=0; i<Size; ++i) {
+      f += Window.Weights[i] * 4 * Quaternions::normsquared( Quaternions::logRotor( R_fA[i] * Quaternions::inverse(R_delta * R_fB_i[i] * R_eps) ) );
+    }
+    return f;
+  }
+
   double EvaluateMinimizationQuantity(const double deltat, const double deltax, const double deltay, const double deltaz) const {
-    using namespace Quaternions; // Allow me to add a double to a vector<double> below
     const Quaternions::Quaternion R_eps = W_B.GetAlignmentOfDecompositionFrameToModes(t_mid+deltat, Quaternions::xHat);
     const Quaternions::Quaternion R_delta = Quaternions::exp(Quaternions::Quaternion(0, deltax, deltay, deltaz));
-    const std::vector<Quaternions::Quaternion> R_Bprime = Quaternions::Squad(R_delta * W_B.Frame() * R_eps, W_B.T(), t_A+deltat);
-    const unsigned int Size=R_Bprime.size();
-    double f = 0.0;
-    double fdot_last = 4 * Quaternions::normsquared( Quaternions::logRotor( R_fA[0] * Quaternions::inverse(R_Bprime[0]) ) );
-    for(unsigned int i=1; i<Size; ++i) {
-      const double fdot = 4 * Quaternions::normsquared( Quaternions::logRotor( R_fA[i] * Quaternions::inverse(R_Bprime[i]) ) );
-      f += (t_A[i]-t_A[i-1])*(fdot+fdot_last)/2.0;
-      fdot_last = fdot;
-    }
+    const double f = Upsilon(R_fB_interp(deltat), R_delta, R_eps);
     if(Debug) {
       UpsilonFile << std::setprecision(15);
       UpsilonFile << deltat << " " << deltax << " " << deltay << " " << deltaz << " " << f << std::endl;
     }
     return f;
   }
+
+  // Use Nelder-Mead simplex minimization, starting from x.  On
+  // return, x holds the best point found and f holds the objective
+  // function there.  The returned value is the GSL status.
+  int Minimize(std::vector<double>& x, double& f, size_t& iter,
+               const double InitialTrialTimeStep, const double InitialTrialAngleStep) const;
 };
 double minfunc (const gsl_vector* delta, void* params) {
-  WaveformAligner* Aligner = (WaveformAligner*) params;
+  const WaveformAligner* Aligner = (const WaveformAligner*) params;
   return Aligner->EvaluateMinimizationQuantity(gsl_vector_get(delta,0),
                                                gsl_vector_get(delta,1),
                                                gsl_vector_get(delta,2),
                                                gsl_vector_get(delta,3));
 }
+int WaveformAligner::Minimize(std::vector<double>& x, double& f, size_t& iter,
+                              const double InitialTrialTimeStep, const double InitialTrialAngleStep) const {
+  const unsigned int NDimensions = 4;
+  const unsigned int MaxIterations = 2000;
+  const double MinSimplexSize = 2.0e-9;
+
+  const gsl_multimin_fminimizer_type* T =
+    gsl_multimin_fminimizer_nmsimplex2;
+  gsl_multimin_fminimizer* s = NULL;
+  gsl_vector* ss;
+  gsl_vector* x0;
+  gsl_multimin_function min_func;
+  int status = GSL_CONTINUE;
+  double size = 0.0;
+  iter = 0;
+
+  // Set initial values
+  x0 = gsl_vector_alloc(NDimensions);
+  for(unsigned int j=0; j<NDimensions; ++j) {
+    gsl_vector_set(x0, j, x[j]);
+  }
+
+  // Set initial step sizes
+  ss = gsl_vector_alloc(NDimensions);
+  gsl_vector_set(ss, 0, InitialTrialTimeStep);
+  gsl_vector_set(ss, 1, InitialTrialAngleStep);
+  gsl_vector_set(ss, 2, InitialTrialAngleStep);
+  gsl_vector_set(ss, 3, InitialTrialAngleStep);
+
+  min_func.n = NDimensions;
+  min_func.f = &minfunc;
+  min_func.params = (void*) this;
+
+  s = gsl_multimin_fminimizer_alloc(T, NDimensions);
+
+  // Run the minimization, making sure to free memory if the
+  // objective function throws
+  try {
+    gsl_multimin_fminimizer_set(s, &min_func, x0, ss);
+    while(status == GSL_CONTINUE && iter < MaxIterations) {
+      iter++;
+      status = gsl_multimin_fminimizer_iterate(s);
+      if(status) break;
+      size = gsl_multimin_fminimizer_size(s);
+      status = gsl_multimin_test_size(size, MinSimplexSize);
+    }
+  } catch(int thrown) {
+    gsl_vector_free(x0);
+    gsl_vector_free(ss);
+    gsl_multimin_fminimizer_free(s);
+    throw(thrown);
+  }
+  if(iter==MaxIterations) { status = GSL_EMAXITER; }
+
+  // Get time shift and rotation, and the objective function there
+  for(unsigned int j=0; j<NDimensions; ++j) {
+    x[j] = gsl_vector_get(s->x, j);
+  }
+  f = s->fval;
+
+  // Free allocated memory
+  gsl_vector_free(x0);
+  gsl_vector_free(ss);
+  gsl_multimin_fminimizer_free(s);
+
+  return status;
+}
+
+namespace {
+
+  // Align W_B to W_A, which must already be aligned to its modes at
+  // the middle of the window.  This is the part of `AlignWaveforms`
+  // after the checks on the inputs.
+  void AlignToWindow(const AlignmentWindow& Window, const GWFrames::Waveform& W_A, GWFrames::Waveform& W_B,
+                     const unsigned int InitialEvaluations, const bool Debug) {
+    const double t_1 = Window.t_1;
+    const double t_2 = Window.t_2;
+    const double t_mid = Window.t_mid;
+    Quaternion R_delta;
+    ofstream XiFile;
+
+    // We have two time offsets: deltat_1 being the most negative
+    // number; deltat_2 being the most positive number.  These are the
+    // offsets given to the time window on which we will evaluate W_B.
+    // That is, W_B is left in place, but we evaluate it on a shifting
+    // window of time (equivalent to shifting W_B by the opposite
+    // amount); W_A is always left in place, and we only evaluate it on
+    // the original window.  Thus, we set the bounds to ensure that
+    // W_B.T(0)<t_1+deltat_1 and W_B.T(-1)>t_2+deltat_2 -- which
+    // translate into deltat_1>W_B.T(0)-t_1 and deltat_2<W_B.T(-1)-t_2.
+    // Just for good measure, let's move those W_B.T indices in one.
+    // Also, we don't search more than (t2-t1)/2.0 to either left or
+    // right.
+    const double deltat_1 = std::max(W_B.T(1)-t_1, -(t_2-t_1)/2.);
+    const double deltat_2 = std::min(W_B.T(W_B.NTimes()-2)-t_2, (t_2-t_1)/2.);
+
+    // Align W_B initially as a first guess
+    const Quaternions::Quaternion R_A_mid = Quaternions::Squad(W_A.Frame(), W_A.T(), std::vector<double>(1,t_mid))[0];
+    const Quaternions::Quaternion nHat_A_mid = R_A_mid * Quaternions::xHat * R_A_mid.inverse();
+    W_B.AlignDecompositionFrameToModes(t_mid, nHat_A_mid);
+
+    WaveformAligner Aligner(Window, W_B, deltat_1, deltat_2, Debug);
+    const std::vector<double>& t_A = Aligner.t_A;
+    const std::vector<Quaternions::Quaternion>& R_fA = Aligner.R_fA;
+    std::vector<double> Upsilon(4, 1e300);
+    std::vector<bool> try_branch(4, false);
+    std::vector<std::vector<double> > optima(4, std::vector<double>(4));
+
+    struct timeval now;
+    gettimeofday(&now, NULL); unsigned long long tNow = now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
+
+    // First, minimize the dumb way, by just evaluating at every deltat
+    // in W_B so that we don't have to interpolate (which takes a *lot*
+    // of time).  This should get us a very good estimate of the true
+    // minimum.
+    {
+      // R_epsB is an array of R_eps rotors for waveform B, assuming the
+      // various deltat values
+      Aligner.SetR_epsB(W_B.GetAlignmentsOfDecompositionFrameToModes());
+
+      // Evaluate Xi_c for every deltat that won't require interpolating
+      // W_B to find R_eps_B (because interpolation is really slow)
+      const GWFrames::Waveform W_B_Interval = W_B.SliceOfTimesWithoutModes(t_mid+deltat_1, t_mid+deltat_2);
+      using namespace GWFrames; // To subtract double from vector<double> below
+      vector<double> deltats = W_B_Interval.T()-t_mid;
+      if(InitialEvaluations>0 && InitialEvaluations<deltats.size()) { // make sure deltats is small enough
+        vector<double> deltats_tmp;
+        const unsigned int step = deltats.size()/InitialEvaluations + 1;
+        deltats_tmp.reserve(InitialEvaluations);
+        for(unsigned int i=0; i<deltats.size(); i+=step) {
+          deltats_tmp.push_back(deltats[i]);
+        }
+        deltats_tmp.swap(deltats);
+      }
+
+      // Each deltat is independent, so these are distributed over
+      // threads; the results are then combined in order, so that the
+      // optima (and Debug output) are the same as for a serial scan.
+      // The times t_mid+deltats[i] are times of W_B, so none of these
+      // evaluations can leave its domain.  Exceptions may not leave
+      // the parallel region, so they are caught and re-thrown
+      // afterwards.
+      const int NDeltats = deltats.size();
+      vector<Quaternion> XiIntegral1(NDeltats);
+      vector<Quaternion> XiIntegral2(NDeltats);
+      vector<vector<Quaternion> > R_delta_logs(NDeltats, vector<Quaternion>(4));
+      vector<vector<double> > Upsilons(NDeltats, vector<double>(4));
+      vector<int> Failed(NDeltats, 0);
+      vector<int> Thrown(NDeltats, 0);
+      #pragma omp parallel for schedule(dynamic) if(NDeltats>1) num_threads(GWFrames::MaxThreads())
+      for(int i=0; i<NDeltats; ++i) {
+        try {
+          const vector<Quaternion> R_fB_i = Aligner.R_fB_interp(deltats[i]);
+          const vector<Quaternion> Rbar_fB_i = Quaternions::conjugate(R_fB_i);
+          const Quaternion Rbar_epsB_i = Aligner.Rbar_epsB(t_mid+deltats[i]);
+          XiIntegral1[i] = Quaternions::DefiniteIntegral(R_fA*Rbar_epsB_i*Rbar_fB_i, t_A);
+          XiIntegral2[i] = Quaternions::DefiniteIntegral(R_fA*(-Quaternions::zHat)*Rbar_epsB_i*Rbar_fB_i, t_A);
+          R_delta_logs[i][0] = Quaternions::logRotor(XiIntegral1[i].normalized());
+          R_delta_logs[i][1] = Quaternions::logRotor(-XiIntegral1[i].normalized());
+          R_delta_logs[i][2] = Quaternions::logRotor(XiIntegral2[i].normalized());
+          R_delta_logs[i][3] = Quaternions::logRotor(-XiIntegral2[i].normalized());
+          const Quaternion R_eps = W_B.GetAlignmentOfDecompositionFrameToModes(t_mid+deltats[i], Quaternions::xHat);
+          for(unsigned int j=0; j<4; ++j) {
+            const Quaternion R_delta_j = Quaternions::exp(Quaternion(0, R_delta_logs[i][j][1], R_delta_logs[i][j][2], R_delta_logs[i][j][3]));
+            Upsilons[i][j] = Aligner.Upsilon(R_fB_i, R_delta_j, R_eps);
+          }
+        } catch(int thrown) {
+          Failed[i] = 1;
+          Thrown[i] = thrown;
+        }
+      }
+      for(int i=0; i<NDeltats; ++i) {
+        if(Failed[i]) {
+          std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Initial evaluation failed for deltat=" << deltats[i] << std::endl;
+          throw(Thrown[i]);
+        }
+      }
+
+      for(int i=0; i<NDeltats; ++i) {
+        for(unsigned int j=0; j<4; ++j) {
+          if(Upsilons[i][j]<Upsilon[j]) {
+            Upsilon[j] = Upsilons[i][j];
+            optima[j][0] = deltats[i];
+            optima[j][1] = R_delta_logs[i][j][1];
+            optima[j][2] = R_delta_logs[i][j][2];
+            optima[j][3] = R_delta_logs[i][j][3];
+          }
+        }
+      }
+
+      if(Debug) {
+        INFOTOCERR << "Output to XiIntegral.dat" << std::endl;
+        XiFile.open ("XiIntegral.dat");
+        XiFile << "# deltats[i] |Xi1| |Xi2| "
+               << "Xi1.w Xi1.x Xi1.y Xi1.z "
+               << "Xi2.w Xi2.x Xi2.y Xi2.z "
+               << "Upsilon(Xi1) Upsilon(-Xi1) Upsilon(Xi2) Upsilon(-Xi2)"
+               << std::endl;
+        XiFile << std::setprecision(15);
+        Aligner.UpsilonFile << std::setprecision(15);
+        for(int i=0; i<NDeltats; ++i) {
+          for(unsigned int j=0; j<4; ++j) {
+            Aligner.UpsilonFile << deltats[i] << " " << R_delta_logs[i][j][1] << " " << R_delta_logs[i][j][2]
+                                << " " << R_delta_logs[i][j][3] << " " << Upsilons[i][j] << std::endl;
+          }
+          XiFile << deltats[i] << " "
+                 << 2*(t_2 - t_1 - Quaternions::abs(XiIntegral1[i])) << " "
+                 << 2*(t_2 - t_1 - Quaternions::abs(XiIntegral2[i])) << " "
+                 << XiIntegral1[i].str() << " " << XiIntegral2[i].str() << " "
+                 << Upsilons[i][0] << " " << Upsilons[i][1] << " " << Upsilons[i][2] << " " << Upsilons[i][3]
+                 << std::endl;
+        }
+        XiFile.close();
+        INFOTOCERR << "Output to XiIntegral.dat finished" << std::endl;
+      }
+
+      INFOTOCOUT << "Objective function values:\n";
+      for(unsigned int j=0; j<4; ++j) {
+        INFOTOCOUT << "\tUpsilon(deltat=" << optima[j][0] << ", r_delta=[" << optima[j][1] << "," << optima[j][2]
+                   << "," << optima[j][3] << "]) = " << Upsilon[j] << std::endl;
+      }
+
+
+    }
+
+    gettimeofday(&now, NULL); unsigned long long tThen = now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
+    INFOTOCOUT << "First stage took " << (tThen-tNow)/1000000.0L << " seconds." << std::endl;
+
+    { // Decide which of the four possible minima to test further
+      const double Upsilon_max = std::max(std::max(std::max(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
+      const double Upsilon_min = std::min(std::min(std::min(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
+      for(unsigned int j=0; j<4; ++j) {
+        if((Upsilon[j]-Upsilon_min)<(Upsilon_max-Upsilon_min)*1e-4) { try_branch[j] = true; }
+      }
+    }
+
+    // Next, minimize algorithmically, in four dimensions, accounting
+    // for all adjustments in generality.  This is very slow, but we've
+    // gotten a very good initial guess from the dumb way above.  The
+    // branches are independent, so each is given to its own thread,
+    // except in Debug mode, where they all write to the same file.
+    // Exceptions may not leave the parallel region, so they are
+    // caught and re-thrown afterwards.
+    const double InitialTrialTimeStep = std::max(W_A.T(1)-W_A.T(0), W_B.T(1)-W_B.T(0))/2.;
+    const double InitialTrialAngleStep = 1.0/(t_2-t_1);
+    std::vector<int> status(4, GSL_SUCCESS);
+    std::vector<size_t> iters(4, 0);
+    std::vector<int> Failed(4, 0);
+    std::vector<int> Thrown(4, 0);
+    #pragma omp parallel for schedule(dynamic) if(!Debug) num_threads(GWFrames::MaxThreads())
+    for(int branch_choice=0; branch_choice<4; ++branch_choice) {
+      if(try_branch[branch_choice]) {
+        try {
+          status[branch_choice] = Aligner.Minimize(optima[branch_choice], Upsilon[branch_choice], iters[branch_choice],
+                                                   InitialTrialTimeStep, InitialTrialAngleStep);
+        } catch(int thrown) {
+          Failed[branch_choice] = 1;
+          Thrown[branch_choice] = thrown;
+        }
+      }
+    }
+    size_t iter_tot = 0;
+    for(unsigned int branch_choice=0; branch_choice<4; ++branch_choice) {
+      if(Failed[branch_choice]) {
+        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Minimization failed for branch_choice=" << branch_choice << std::endl;
+        throw(Thrown[branch_choice]);
+      }
+      if(!try_branch[branch_choice]) { continue; }
+      iter_tot += iters[branch_choice];
+
+      if(status[branch_choice]==GSL_EBADFUNC) {
+        INFOTOCERR << "\nThe iteration encountered a singular point where the function evaluated to Inf or NaN"
+                   << "\nwhile minimizing at (" << optima[branch_choice][0] << ", " << optima[branch_choice][1]
+                   << ", " << optima[branch_choice][2] << ", " << optima[branch_choice][3] << ")." << std::endl;
+      }
+
+      if(status[branch_choice]==GSL_FAILURE) {
+        INFOTOCERR << "\nThe algorithm could not improve the current best approximation or bounding interval." << std::endl;
+      }
+
+      if(status[branch_choice]==GSL_ENOPROG) {
+        INFOTOCERR << "\nThe minimizer is unable to improve on its current estimate, either due to"
+                   << "\nnumerical difficulty or because a genuine local minimum has been reached." << std::endl;
+      }
+
+      if(status[branch_choice]==GSL_EMAXITER) {
+        INFOTOCERR << "\nWarning: Minimization ended because it went through " << iters[branch_choice] << " iterations."
+                   << "\n         This may indicate failure.  You may want to try with a better initial guess." << std::endl;
+      }
+
+      INFOTOCOUT << "Objective function value for branch_choice=" << branch_choice
+                 << " after " << iters[branch_choice] << " iterations:\n";
+      INFOTOCOUT << "\tUpsilon(deltat=" << optima[branch_choice][0] << ", r_delta=[" << optima[branch_choice][1]
+                 << "," << optima[branch_choice][2] << "," << optima[branch_choice][3] << "]) = " << Upsilon[branch_choice] << std::endl;
+    }
+
+    {  // Decide on the best choice of branch
+      const double Upsilon_max = std::max(std::max(std::max(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
+      const double Upsilon_min = std::min(std::min(std::min(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
+      for(unsigned int j=0; j<4; ++j) {
+        if((Upsilon[j]-Upsilon_min)<(Upsilon_max-Upsilon_min)*1e-4) {
+          try_branch[j] = true;
+        } else {
+          try_branch[j] = false;
+        }
+      }
+
+      double deltat;
+      Quaternions::Quaternion R_eps;
+      Aligner.FindBestMinimizationWaveform(optima, try_branch, deltat, R_delta, R_eps);
+
+      // Now, apply the transformations
+      using namespace GWFrames; // To subtract double from vector<double> below
+      W_B.SetTime(W_B.T()-deltat);
+      W_B.RotateDecompositionBasis(R_eps);
+      W_B.SetFrame(R_delta*W_B.Frame());
+
+      gettimeofday(&now, NULL); unsigned long long tWhen = now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
+      INFOTOCOUT << "Second stage took " << (tWhen-tThen)/1000000.0L
+                 << " seconds with " << iter_tot << " iterations." << std::endl;
+    }
+
+    return;
+  }
+
+  // Transform W to its co-rotating frame if it is in the inertial
+  // frame, and check that the result is co-rotating
+  void EnsureCorotatingForAlignment(GWFrames::Waveform& W, const std::string& Name) {
+    if(W.FrameType()==GWFrames::Inertial) {
+      INFOTOCOUT << "Transforming input Waveform " << Name << " (in place) to co-rotating frame." << std::endl;
+      W.TransformToCorotatingFrame();
+    }
+    if(W.FrameType()!=GWFrames::Corotating) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ":"
+                << "\nError: `AlignWaveforms` takes Waveforms in the "
+                << GWFrames::WaveformFrameNames[GWFrames::Inertial] << " or "
+                << GWFrames::WaveformFrameNames[GWFrames::Corotating] << " frames only."
+                << "\n       Waveform " << Name << " is in the " << W.FrameTypeString() << " frame." << std::endl;
+      throw(GWFrames_WrongFrameType);
+    }
+  }
+
+  // Make sure the various times fit together
+  void CheckAlignmentTimes(const GWFrames::Waveform& W_A, const GWFrames::Waveform& W_B, const double t_1, const double t_2) {
+    if(t_1>=t_2 || t_1<W_A.T(0) || t_2>W_A.T(W_A.NTimes()-1) || t_1<W_B.T(0) || t_2>W_B.T(W_B.NTimes()-1)) {
+      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ":"
+                << "\nError: Incompatible input times:"
+                << "\n       t_1 = " << t_1
+                << "\n       t_2 = " << t_2
+                << "\n       W_A.T(0) = " << W_A.T(0)
+                << "\n       W_A.T(" << W_A.NTimes()-1 << ") = " << W_A.T(W_A.NTimes()-1)
+                << "\n       W_B.T(0) = " << W_B.T(0)
+                << "\n       W_B.T(" << W_B.NTimes()-1 << ") = " << W_B.T(W_B.NTimes()-1)
+                << std::endl;
+      throw(GWFrames_EmptyIntersection);
+    }
+  }
+
+}
 #endif // DOXYGEN
 
 /// Do everything necessary to align two waveform objects
@@ -2502,358 +4315,138 @@ void GWFrames::AlignWaveforms(GWFrames::Waveform& W_A, GWFrames::Waveform& W_B,
   /// (Mike Boyle) do hereby guarantee that this algorithm will find
   /// the optimal alignment in both time and attitude.  Or your money
   /// back.
+  ///
+  /// When compiled with OpenMP, the initial evaluations and the
+  /// subsequent minimizations of the different branches are
+  /// distributed over threads.  In Debug mode, the minimizations are
+  /// done serially, so that the output files are in order.  To align
+  /// many waveforms against the same `W_A`, `AlignedWaveforms` reuses
+  /// the work that depends only on `W_A` and the window.
+  GWFrames_INSTRUMENT("AlignWaveforms");
 
   if(nHat_A.size()==0) {
     nHat_A = Quaternions::xHat.vec();
   }
 
   // Make sure W_A and W_B are in their co-rotating frames
-  if(W_A.FrameType()==GWFrames::Inertial) {
-    INFOTOCOUT << "Transforming input Waveform A (in place) to co-rotating frame." << std::endl;
-    W_A.TransformToCorotatingFrame();
-  }
-  if(W_B.FrameType()==GWFrames::Inertial) {
-    INFOTOCOUT << "Transforming input Waveform B (in place) to co-rotating frame." << std::endl;
-    W_B.TransformToCorotatingFrame();
-  }
-  if(W_A.FrameType()!=GWFrames::Corotating || W_B.FrameType()!=GWFrames::Corotating) {
-    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ":"
-              << "\nError: `AlignWaveforms` takes Waveforms in the "
-              << GWFrames::WaveformFrameNames[GWFrames::Inertial] << " or "
-              << GWFrames::WaveformFrameNames[GWFrames::Corotating] << " frames only."
-              << "\n       These Waveforms are in the " << W_A.FrameTypeString() << " and " << W_B.FrameTypeString() << " frames." << std::endl;
-    throw(GWFrames_WrongFrameType);
-  }
+  EnsureCorotatingForAlignment(W_A, "A");
+  EnsureCorotatingForAlignment(W_B, "B");
 
-  // Make sure the various times fit together
-  if(t_1>=t_2 || t_1<W_A.T(0) || t_2>W_A.T(W_A.NTimes()-1) || t_1<W_B.T(0) || t_2>W_B.T(W_B.NTimes()-1)) {
-    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ":"
-              << "\nError: Incompatible input times:"
-              << "\n       t_1 = " << t_1
-              << "\n       t_2 = " << t_2
-              << "\n       W_A.T(0) = " << W_A.T(0)
-              << "\n       W_A.T(" << W_A.NTimes()-1 << ") = " << W_A.T(W_A.NTimes()-1)
-              << "\n       W_B.T(0) = " << W_B.T(0)
-              << "\n       W_B.T(" << W_B.NTimes()-1 << ") = " << W_B.T(W_B.NTimes()-1)
-              << std::endl;
-    throw(GWFrames_EmptyIntersection);
-  }
+  CheckAlignmentTimes(W_A, W_B, t_1, t_2);
 
-  Quaternion R_delta;
+  // Align W_A forever
   const double t_mid = (t_1+t_2)/2.;
-  ofstream XiFile;
-
-  // We have two time offsets: deltat_1 being the most negative
-  // number; deltat_2 being the most positive number.  These are the
-  // offsets given to the time window on which we will evaluate W_B.
-  // That is, W_B is left in place, but we evaluate it on a shifting
-  // window of time (equivalent to shifting W_B by the opposite
-  // amount); W_A is always left in place, and we only evaluate it on
-  // the original window.  Thus, we set the bounds to ensure that
-  // W_B.T(0)<t_1+deltat_1 and W_B.T(-1)>t_2+deltat_2 -- which
-  // translate into deltat_1>W_B.T(0)-t_1 and deltat_2<W_B.T(-1)-t_2.
-  // Just for good measure, let's move those W_B.T indices in one.
-  // Also, we don't search more than (t2-t1)/2.0 to either left or
-  // right.
-  const double deltat_1 = std::max(W_B.T(1)-t_1, -(t_2-t_1)/2.);
-  const double deltat_2 = std::min(W_B.NTimes()-2-t_2, (t_2-t_1)/2.);
-
-  // Align W_A forever, and align W_B initially as a first guess
   W_A.AlignDecompositionFrameToModes(t_mid, nHat_A);
-  const Quaternions::Quaternion R_A_mid = Quaternions::Squad(W_A.Frame(), W_A.T(), std::vector<double>(1,t_mid))[0];
-  const Quaternions::Quaternion nHat_A_mid = R_A_mid * Quaternions::xHat * R_A_mid.inverse();
-  W_B.AlignDecompositionFrameToModes(t_mid, nHat_A_mid);
-
-  WaveformAligner Aligner(W_A, W_B, t_1, t_2, Debug);
-  const std::vector<double>& t_A = Aligner.t_A;
-  const std::vector<Quaternions::Quaternion>& R_fA = Aligner.R_fA;
-  std::vector<double> Upsilon(4, 1e300);
-  std::vector<bool> try_branch(4, false);
-  std::vector<std::vector<double> > optima(4, std::vector<double>(4));
-
-  struct timeval now;
-  gettimeofday(&now, NULL); unsigned long long tNow = now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
-
-  // First, minimize the dumb way, by just evaluating at every deltat
-  // in W_B so that we don't have to interpolate (which takes a *lot*
-  // of time).  This should get us a very good estimate of the true
-  // minimum.
-  {
-    // R_epsB is an array of R_eps rotors for waveform B, assuming the
-    // various deltat values
-    Aligner.SetR_epsB(W_B.GetAlignmentsOfDecompositionFrameToModes());
-
-    // Evaluate Xi_c for every deltat that won't require interpolating
-    // W_B to find R_eps_B (because interpolation is really slow)
-    const GWFrames::Waveform W_B_Interval = W_B.SliceOfTimesWithoutModes(t_mid+deltat_1, t_mid+deltat_2);
-    using namespace GWFrames; // To subtract double from vector<double> below
-    vector<double> deltats = W_B_Interval.T()-t_mid;
-    if(InitialEvaluations>0 && InitialEvaluations<deltats.size()) { // make sure deltats is small enough
-      vector<double> deltats_tmp;
-      const unsigned int step = deltats.size()/InitialEvaluations + 1;
-      deltats_tmp.reserve(InitialEvaluations);
-      for(unsigned int i=0; i<deltats.size(); i+=step) {
-        deltats_tmp.push_back(deltats[i]);
-      }
-      deltats_tmp.swap(deltats);
-    }
-    vector<Quaternion> XiIntegral1(deltats.size());
-    vector<Quaternion> XiIntegral2(deltats.size());
-    for(unsigned int i=0; i<XiIntegral1.size(); ++i) {
-      XiIntegral1[i] = Quaternions::DefiniteIntegral(R_fA
-                                                     *Aligner.Rbar_epsB(t_mid+deltats[i])
-                                                     *Aligner.Rbar_fB(t_A+deltats[i]), t_A);
-      XiIntegral2[i] = Quaternions::DefiniteIntegral(R_fA
-                                                     *(-Quaternions::zHat)*Aligner.Rbar_epsB(t_mid+deltats[i])
-                                                     *Aligner.Rbar_fB(t_A+deltats[i]), t_A);
-    }
-
-    if(Debug) {
-      INFOTOCERR << "Output to XiIntegral.dat" << std::endl;
-      XiFile.open ("XiIntegral.dat");
-      XiFile << "# deltats[i] |Xi1| |Xi2| "
-             << "Xi1.w Xi1.x Xi1.y Xi1.z "
-             << "Xi2.w Xi2.x Xi2.y Xi2.z "
-             << "Upsilon(Xi1) Upsilon(-Xi1) Upsilon(Xi2) Upsilon(-Xi2)"
-             << std::endl;
-      XiFile << std::setprecision(15);
-    }
-
-    for(unsigned int i=0; i<XiIntegral1.size(); ++i) {
-      const Quaternions::Quaternion R_delta_log1 = Quaternions::logRotor(XiIntegral1[i].normalized());
-      const Quaternions::Quaternion NegativeR_delta_log1 = Quaternions::logRotor(-XiIntegral1[i].normalized());
-      const Quaternions::Quaternion R_delta_log2 = Quaternions::logRotor(XiIntegral2[i].normalized());
-      const Quaternions::Quaternion NegativeR_delta_log2 = Quaternions::logRotor(-XiIntegral2[i].normalized());
-      const double Upsilon0 = Aligner.EvaluateMinimizationQuantity(deltats[i], R_delta_log1[1], R_delta_log1[2], R_delta_log1[3]);
-      const double Upsilon1 = Aligner.EvaluateMinimizationQuantity(deltats[i], NegativeR_delta_log1[1],
-                                                                   NegativeR_delta_log1[2], NegativeR_delta_log1[3]);
-      const double Upsilon2 = Aligner.EvaluateMinimizationQuantity(deltats[i], R_delta_log2[1], R_delta_log2[2], R_delta_log2[3]);
-      const double Upsilon3 = Aligner.EvaluateMinimizationQuantity(deltats[i], NegativeR_delta_log2[1],
-                                                                   NegativeR_delta_log2[2], NegativeR_delta_log2[3]);
-      if(Upsilon0<Upsilon[0]) {
-        Upsilon[0] = Upsilon0;
-        optima[0][0] = deltats[i];
-        optima[0][1] = R_delta_log1[1];
-        optima[0][2] = R_delta_log1[2];
-        optima[0][3] = R_delta_log1[3];
-      }
-      if(Upsilon1<Upsilon[1]) {
-        Upsilon[1] = Upsilon1;
-        optima[1][0] = deltats[i];
-        optima[1][1] = NegativeR_delta_log1[1];
-        optima[1][2] = NegativeR_delta_log1[2];
-        optima[1][3] = NegativeR_delta_log1[3];
-      }
-      if(Upsilon2<Upsilon[2]) {
-        Upsilon[2] = Upsilon2;
-        optima[2][0] = deltats[i];
-        optima[2][1] = R_delta_log2[1];
-        optima[2][2] = R_delta_log2[2];
-        optima[2][3] = R_delta_log2[3];
-      }
-      if(Upsilon3<Upsilon[3]) {
-        Upsilon[3] = Upsilon3;
-        optima[3][0] = deltats[i];
-        optima[3][1] = NegativeR_delta_log2[1];
-        optima[3][2] = NegativeR_delta_log2[2];
-        optima[3][3] = NegativeR_delta_log2[3];
-      }
-      if(Debug) {
-        XiFile << deltats[i] << " "
-               << 2*(t_2 - t_1 - Quaternions::abs(XiIntegral1[i])) << " "
-               << 2*(t_2 - t_1 - Quaternions::abs(XiIntegral2[i])) << " "
-               << XiIntegral1[i].str() << " " << XiIntegral2[i].str() << " "
-               << Upsilon0 << " " << Upsilon1 << " " << Upsilon2 << " " << Upsilon3
-               << std::endl;
-      }
-    }
 
-    if(Debug) {
-      XiFile.close();
-      INFOTOCERR << "Output to XiIntegral.dat finished" << std::endl;
-    }
-
-    INFOTOCOUT << "Objective function values:\n";
-    for(unsigned int j=0; j<4; ++j) {
-      INFOTOCOUT << "\tUpsilon(deltat=" << optima[j][0] << ", r_delta=[" << optima[j][1] << "," << optima[j][2]
-                 << "," << optima[j][3] << "]) = " << Upsilon[j] << std::endl;
-    }
+  const AlignmentWindow Window(W_A, t_1, t_2);
+  AlignToWindow(Window, W_A, W_B, InitialEvaluations, Debug);
 
+  return;
+}
 
+/// Align many waveforms to one fixed waveform
+std::vector<GWFrames::Waveform> GWFrames::AlignedWaveforms(const GWFrames::Waveform& W_A, const std::vector<GWFrames::Waveform>& W_B,
+                                                           const std::vector<double>& t_1, const std::vector<double>& t_2,
+                                                           unsigned int InitialEvaluations, std::vector<double> nHat_A)
+{
+  /// \param W_A Fixed waveform
+  /// \param W_B Waveforms to be aligned to `W_A`
+  /// \param t_1 Beginning of alignment interval for each of `W_B`, or one value for all
+  /// \param t_2 End of alignment interval for each of `W_B`, or one value for all
+  /// \param InitialEvaluations Number of evaluations for dumb initial optimization
+  /// \param nHat_A Approximate nHat vector at (t_1+t_2)/2. [optional]
+  ///
+  /// Each element of the returned vector is the corresponding element
+  /// of `W_B` (in its co-rotating frame), aligned to `W_A` exactly as
+  /// by `AlignWaveforms`.  This can be used to align a numerical
+  /// waveform against many post-Newtonian candidates, or one
+  /// candidate over several windows (by repeating it in `W_B`).
+  ///
+  /// Unlike `AlignWaveforms`, the input `W_A` is not changed.  Its
+  /// co-rotating frame is found once, and for each distinct window,
+  /// its alignment to the modes and the quantities depending only on
+  /// it and the window are found once, and shared by all the
+  /// alignments on that window.
+  GWFrames_INSTRUMENT("AlignedWaveforms");
+
+  if(t_1.size()!=t_2.size() || (t_1.size()!=1 && t_1.size()!=W_B.size())) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": t_1.size()=" << t_1.size() << "; t_2.size()=" << t_2.size()
+              << "; W_B.size()=" << W_B.size() << ".  The windows must be given once, or once for each W_B." << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
   }
 
-  gettimeofday(&now, NULL); unsigned long long tThen = now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
-  INFOTOCOUT << "First stage took " << (tThen-tNow)/1000000.0L << " seconds." << std::endl;
+  if(nHat_A.size()==0) {
+    nHat_A = Quaternions::xHat.vec();
+  }
 
-  { // Decide which of the four possible minima to test further
-    const double Upsilon_max = std::max(std::max(std::max(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
-    const double Upsilon_min = std::min(std::min(std::min(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
-    for(unsigned int j=0; j<4; ++j) {
-      if((Upsilon[j]-Upsilon_min)<(Upsilon_max-Upsilon_min)*1e-4) { try_branch[j] = true; }
+  GWFrames::Waveform W_A_corot(W_A);
+  EnsureCorotatingForAlignment(W_A_corot, "A");
+
+  std::vector<GWFrames::Waveform> Aligned(W_B);
+  for(unsigned int i=0; i<Aligned.size(); ++i) {
+    EnsureCorotatingForAlignment(Aligned[i], "B");
+    CheckAlignmentTimes(W_A_corot, Aligned[i], t_1[t_1.size()==1 ? 0 : i], t_2[t_2.size()==1 ? 0 : i]);
+  }
+
+  // Go through the distinct windows, aligning every W_B that uses each
+  std::vector<bool> Done(Aligned.size(), false);
+  for(unsigned int i=0; i<Aligned.size(); ++i) {
+    if(Done[i]) { continue; }
+    const double t_1_i = t_1[t_1.size()==1 ? 0 : i];
+    const double t_2_i = t_2[t_2.size()==1 ? 0 : i];
+    GWFrames::Waveform W_A_aligned(W_A_corot);
+    W_A_aligned.AlignDecompositionFrameToModes((t_1_i+t_2_i)/2., nHat_A);
+    const AlignmentWindow Window(W_A_aligned, t_1_i, t_2_i);
+    for(unsigned int j=i; j<Aligned.size(); ++j) {
+      if(Done[j] || t_1[t_1.size()==1 ? 0 : j]!=t_1_i || t_2[t_2.size()==1 ? 0 : j]!=t_2_i) { continue; }
+      AlignToWindow(Window, W_A_aligned, Aligned[j], InitialEvaluations, false);
+      Done[j] = true;
     }
   }
 
-  // Next, minimize algorithmically, in four dimensions, accounting
-  // for all adjustments in generality.  This is very slow, but we've
-  // gotten a very good initial guess from the dumb way above.
-  std::vector<double> difference_norm(4, 1e300);
-  size_t iter_tot = 0;
-  for(unsigned int branch_choice=0; branch_choice<4; ++branch_choice) {
-    if(try_branch[branch_choice]) {
-      const unsigned int NDimensions = 4;
-      const unsigned int MaxIterations = 2000;
-      const double MinSimplexSize = 2.0e-9;
-      const double InitialTrialTimeStep = std::max(W_A.T(1)-W_A.T(0), W_B.T(1)-W_B.T(0))/2.;
-      const double InitialTrialAngleStep = 1.0/(t_2-t_1);
-
-      // Use Nelder-Mead simplex minimization
-      const gsl_multimin_fminimizer_type* T =
-        gsl_multimin_fminimizer_nmsimplex2;
-      gsl_multimin_fminimizer* s = NULL;
-      gsl_vector* ss;
-      gsl_vector* x;
-      gsl_multimin_function min_func;
-      size_t iter = 0;
-      int status = GSL_CONTINUE;
-      double size = 0.0;
+  return Aligned;
+}
 
-      // Set initial values
-      x = gsl_vector_alloc(NDimensions);
-      for(unsigned int j=0; j<NDimensions; ++j) {
-        gsl_vector_set(x, j, optima[branch_choice][j]);
-      }
+/// Return a Waveform with differences between the two inputs.
+GWFrames::Waveform GWFrames::Waveform::Compare(const GWFrames::Waveform& A, const double MinTimeStep, const double MinTime) const {
+  /// This function simply subtracts the data in this Waveform from
+  /// the data in Waveform A, and finds the rotation needed to take
+  /// this frame into frame A.  Note that the waveform data are stored
+  /// as complex numbers, rather than as modulus and phase.
+  GWFrames_INSTRUMENT("Waveform::Compare");
 
-      // Set initial step sizes
-      ss = gsl_vector_alloc(NDimensions);
-      gsl_vector_set(ss, 0, InitialTrialTimeStep);
-      gsl_vector_set(ss, 1, InitialTrialAngleStep);
-      gsl_vector_set(ss, 2, InitialTrialAngleStep);
-      gsl_vector_set(ss, 3, InitialTrialAngleStep);
+  // Make B a convenient alias for *this
+  const GWFrames::Waveform& B = *this;
 
-      min_func.n = NDimensions;
-      min_func.f = &minfunc;
-      min_func.params = (void*) &Aligner;
+  // Check to see if the frameTypes are the same
+  if(frameType != A.frameType) {
+    INFOTOCERR << "\nWarning:"
+               << "\n       This Waveform is in the " << GWFrames::WaveformFrameNames[frameType] << " frame,"
+               << "\n       The Waveform in the argument is in the " << GWFrames::WaveformFrameNames[A.frameType] << " frame."
+               << "\n       Comparing them probably does not make sense.\n"
+               << std::endl;
+  }
 
-      s = gsl_multimin_fminimizer_alloc(T, NDimensions);
-      gsl_multimin_fminimizer_set(s, &min_func, x, ss);
+  // Make sure we have the same number of modes in the input data
+  if(NModes() != B.NModes()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Trying to Compare Waveforms with mismatched LM data."
+              << "\nA.NModes()=" << A.NModes() << "\tB.NModes()=" << B.NModes() << std::endl;
+    throw(GWFrames_WaveformMissingLMIndex);
+  }
 
-      // Run the minimization
-      while(status == GSL_CONTINUE && iter < MaxIterations) {
-        iter++;
-        status = gsl_multimin_fminimizer_iterate(s);
+  // We'll put all the data in a new Waveform C
+  GWFrames::Waveform C;
 
-        if(status==GSL_EBADFUNC) {
-          INFOTOCERR << "\nThe iteration encountered a singular point where the function evaluated to Inf or NaN"
-                     << "\nwhile minimizing at (" << gsl_vector_get(s->x, 0) << ", " << gsl_vector_get(s->x, 1)
-                     << ", " << gsl_vector_get(s->x, 2) << ", " << gsl_vector_get(s->x, 3) << ")." << std::endl;
-        }
+  // Store both old histories in C's
+  C.history << "B.Compare(A)\n"
+            << "#### A.history.str():\n";
+  C.history.Include(A.history);
+  C.history << "#### B.history.str():\n";
+  C.history.Include(B.history);
+  C.history << "#### End of old histories from `Compare`" << std::endl;
 
-        if(status==GSL_FAILURE) {
-          INFOTOCERR << "\nThe algorithm could not improve the current best approximation or bounding interval." << std::endl;
-        }
-
-        if(status==GSL_ENOPROG) {
-          INFOTOCERR << "\nThe minimizer is unable to improve on its current estimate, either due to"
-                     << "\nnumerical difficulty or because a genuine local minimum has been reached." << std::endl;
-        }
-
-        if(status) break;
-        size = gsl_multimin_fminimizer_size(s);
-        status = gsl_multimin_test_size(size, MinSimplexSize);
-      }
-
-      iter_tot += iter;
-
-      if(iter==MaxIterations) {
-        INFOTOCERR << "\nWarning: Minimization ended because it went through " << MaxIterations << " iterations."
-                   << "\n         This may indicate failure.  You may want to try with a better initial guess." << std::endl;
-      }
-
-      // Get time shift and rotation
-      for(unsigned int j=0; j<NDimensions; ++j) {
-        optima[branch_choice][j] = gsl_vector_get(s->x, j);
-      }
-
-      // Get value of objective function here
-      Upsilon[branch_choice] = s->fval;
-
-      INFOTOCOUT << "Objective function value for branch_choice=" << branch_choice
-                 << " after " << iter << " iterations:\n";
-      INFOTOCOUT << "\tUpsilon(deltat=" << optima[branch_choice][0] << ", r_delta=[" << optima[branch_choice][1]
-                 << "," << optima[branch_choice][2] << "," << optima[branch_choice][3] << "]) = " << Upsilon[branch_choice] << std::endl;
-
-      // Free allocated memory
-      gsl_vector_free(x);
-      gsl_vector_free(ss);
-      gsl_multimin_fminimizer_free(s);
-    }
-  }
-
-  {  // Decide on the best choice of branch
-    const double Upsilon_max = std::max(std::max(std::max(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
-    const double Upsilon_min = std::min(std::min(std::min(Upsilon[0], Upsilon[1]), Upsilon[2]), Upsilon[3]);
-    for(unsigned int j=0; j<4; ++j) {
-      if((Upsilon[j]-Upsilon_min)<(Upsilon_max-Upsilon_min)*1e-4) {
-        try_branch[j] = true;
-      } else {
-        try_branch[j] = false;
-      }
-    }
-
-    double deltat;
-    Quaternions::Quaternion R_eps;
-    Aligner.FindBestMinimizationWaveform(optima, try_branch, deltat, R_delta, R_eps);
-
-    // Now, apply the transformations
-    W_B.SetTime(W_B.T()-deltat);
-    W_B.RotateDecompositionBasis(R_eps);
-    W_B.SetFrame(R_delta*W_B.Frame());
-
-    gettimeofday(&now, NULL); unsigned long long tWhen = now.tv_usec + (unsigned long long)now.tv_sec * 1000000;
-    INFOTOCOUT << "Second stage took " << (tWhen-tThen)/1000000.0L
-               << " seconds with " << iter_tot << " iterations." << std::endl;
-  }
-
-  return;
-}
-
-/// Return a Waveform with differences between the two inputs.
-GWFrames::Waveform GWFrames::Waveform::Compare(const GWFrames::Waveform& A, const double MinTimeStep, const double MinTime) const {
-  /// This function simply subtracts the data in this Waveform from
-  /// the data in Waveform A, and finds the rotation needed to take
-  /// this frame into frame A.  Note that the waveform data are stored
-  /// as complex numbers, rather than as modulus and phase.
-
-  // Make B a convenient alias for *this
-  const GWFrames::Waveform& B = *this;
-
-  // Check to see if the frameTypes are the same
-  if(frameType != A.frameType) {
-    INFOTOCERR << "\nWarning:"
-               << "\n       This Waveform is in the " << GWFrames::WaveformFrameNames[frameType] << " frame,"
-               << "\n       The Waveform in the argument is in the " << GWFrames::WaveformFrameNames[A.frameType] << " frame."
-               << "\n       Comparing them probably does not make sense.\n"
-               << std::endl;
-  }
-
-  // Make sure we have the same number of modes in the input data
-  if(NModes() != B.NModes()) {
-    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Trying to Compare Waveforms with mismatched LM data."
-              << "\nA.NModes()=" << A.NModes() << "\tB.NModes()=" << B.NModes() << std::endl;
-    throw(GWFrames_WaveformMissingLMIndex);
-  }
-
-  // We'll put all the data in a new Waveform C
-  GWFrames::Waveform C;
-
-  // Store both old histories in C's
-  C.history << "B.Compare(A)\n"
-            << "#### A.history.str():\n" << A.history.str()
-            << "#### B.history.str():\n" << B.history.str()
-            << "#### End of old histories from `Compare`" << std::endl;
-
-  // The new time axis will be the intersection of the two old ones
-  C.t = GWFrames::Intersection(A.t, B.t);
+  // The new time axis will be the intersection of the two old ones
+  C.t = GWFrames::Intersection(A.t, B.t);
 
   // Copy the basics
   C.frameType = frameType;
@@ -2863,6 +4456,7 @@ GWFrames::Waveform GWFrames::Waveform::Compare(const GWFrames::Waveform& A, cons
   // We'll assume that {A.lm}=={B.lm} as sets, and account for
   // disordering below
   C.lm = A.lm;
+  C.modeLayout = A.modeLayout;
 
   // Process the frame, depending on the sizes of the input frames
   if(A.Frame().size()>1 && B.Frame().size()>1) {
@@ -2927,20 +4521,17 @@ GWFrames::Waveform GWFrames::Waveform::Compare(const GWFrames::Waveform& A, cons
   gsl_spline* splineReB = gsl_spline_alloc(gsl_interp_cspline, B.NTimes());
   gsl_spline* splineImB = gsl_spline_alloc(gsl_interp_cspline, B.NTimes());
 
+  // Split the real and imaginary parts of the data into contiguous planes for GSL
+  const GWFrames::SplitMatrixC SplitA(A.data), SplitB(B.data);
   // Now loop over each mode filling in the waveform data
   for(unsigned int Mode=0; Mode<A.NModes(); ++Mode) {
     // Assume that all the ell,m data are the same, but not necessarily in the same order
     const unsigned int BMode = B.FindModeIndex(A.lm[Mode][0], A.lm[Mode][1]);
-    // Extract the real and imaginary parts of the data separately for GSL
-    const vector<double> ReA = A.Re(Mode);
-    const vector<double> ImA = A.Im(Mode);
-    const vector<double> ReB = B.Re(BMode);
-    const vector<double> ImB = B.Im(BMode);
     // Initialize the interpolators for this data set
-    gsl_spline_init(splineReA, &(A.t)[0], &ReA[0], A.NTimes());
-    gsl_spline_init(splineImA, &(A.t)[0], &ImA[0], A.NTimes());
-    gsl_spline_init(splineReB, &(B.t)[0], &ReB[0], B.NTimes());
-    gsl_spline_init(splineImB, &(B.t)[0], &ImB[0], B.NTimes());
+    gsl_spline_init(splineReA, &(A.t)[0], SplitA.Re(Mode), A.NTimes());
+    gsl_spline_init(splineImA, &(A.t)[0], SplitA.Im(Mode), A.NTimes());
+    gsl_spline_init(splineReB, &(B.t)[0], SplitB.Re(BMode), B.NTimes());
+    gsl_spline_init(splineImB, &(B.t)[0], SplitB.Im(BMode), B.NTimes());
     // Assign the data from the transition
     for(unsigned int i_t=0; i_t<C.t.size(); ++i_t) {
       C.data[Mode][i_t] = complex<double>( gsl_spline_eval(splineReA, C.t[i_t], accReA), gsl_spline_eval(splineImA, C.t[i_t], accImA) )
@@ -2991,6 +4582,7 @@ GWFrames::Waveform GWFrames::Waveform::Hybridize(const GWFrames::Waveform& B, co
   ///
   /// Note that this function does NOT operate in place; a new
   /// Waveform object is constructed and returned.
+  GWFrames_INSTRUMENT("Waveform::Hybridize");
 
   // Make A a convenient alias
   const GWFrames::Waveform& A = *this;
@@ -3069,13 +4661,16 @@ GWFrames::Waveform GWFrames::Waveform::Hybridize(const GWFrames::Waveform& B, co
   C.rIsScaledOut = A.rIsScaledOut;
   C.mIsScaledOut = A.mIsScaledOut;
   C.history << "A.Hybridize(B, " << t1 << ", " << t2 << ", " << tMinStep << ")\n"
-            << "#### A.history.str():\n" << A.history.str()
-            << "#### B.history.str():\n" << B.history.str()
-            << "#### End of old histories from `Hybridize`" << std::endl;
+            << "#### A.history.str():\n";
+  C.history.Include(A.history);
+  C.history << "#### B.history.str():\n";
+  C.history.Include(B.history);
+  C.history << "#### End of old histories from `Hybridize`" << std::endl;
   C.versionHist = A.versionHist;
   C.t = GWFrames::Union(A.t, B.t, tMinStep);
   // We'll assume that A.lm==B.lm, though we'll account for disordering below
   C.lm = A.lm;
+  C.modeLayout = A.modeLayout;
   // Make sure the time stops at the end of B's time (in case A extended further)
   int i_t=C.t.size()-1;
   while(C.T(i_t)>B.t.back() && i_t>0) { --i_t; }
@@ -3114,20 +4709,17 @@ GWFrames::Waveform GWFrames::Waveform::Hybridize(const GWFrames::Waveform& B, co
   gsl_spline* splineImA = gsl_spline_alloc(gsl_interp_cspline, A.NTimes());
   gsl_spline* splineReB = gsl_spline_alloc(gsl_interp_cspline, B.NTimes());
   gsl_spline* splineImB = gsl_spline_alloc(gsl_interp_cspline, B.NTimes());
+  // Split the real and imaginary parts of the data into contiguous planes for GSL
+  const GWFrames::SplitMatrixC SplitA(A.data), SplitB(B.data);
   // Now loop over each mode filling in the waveform data
   for(unsigned int Mode=0; Mode<A.NModes(); ++Mode) {
     // Assume that all the ell,m data are the same, but not necessarily in the same order
     const unsigned int BMode = B.FindModeIndex(A.lm[Mode][0], A.lm[Mode][1]);
-    // Extract the real and imaginary parts of the data separately for GSL
-    const vector<double> ReA = A.Re(Mode);
-    const vector<double> ImA = A.Im(Mode);
-    const vector<double> ReB = B.Re(BMode);
-    const vector<double> ImB = B.Im(BMode);
     // Initialize the interpolators for this data set
-    gsl_spline_init(splineReA, &(A.t)[0], &ReA[0], A.NTimes());
-    gsl_spline_init(splineImA, &(A.t)[0], &ImA[0], A.NTimes());
-    gsl_spline_init(splineReB, &(B.t)[0], &ReB[0], B.NTimes());
-    gsl_spline_init(splineImB, &(B.t)[0], &ImB[0], B.NTimes());
+    gsl_spline_init(splineReA, &(A.t)[0], SplitA.Re(Mode), A.NTimes());
+    gsl_spline_init(splineImA, &(A.t)[0], SplitA.Im(Mode), A.NTimes());
+    gsl_spline_init(splineReB, &(B.t)[0], SplitB.Re(BMode), B.NTimes());
+    gsl_spline_init(splineImB, &(B.t)[0], SplitB.Im(BMode), B.NTimes());
     // Assign the data from earliest part
     for(unsigned int j=0; j<J01; ++j) {
       C.data[Mode][j] = complex<double>( gsl_spline_eval(splineReA, C.t[j], accReA), gsl_spline_eval(splineImA, C.t[j], accImA) );
@@ -3155,6 +4747,66 @@ GWFrames::Waveform GWFrames::Waveform::Hybridize(const GWFrames::Waveform& B, co
   return C;
 }
 
+#ifndef DOXYGEN
+namespace {
+  // Shared by Waveform and WaveformView
+  template <typename WaveformType>
+  std::vector<std::complex<double> > EvaluateModesAtPoint(const WaveformType& W, const double vartheta, const double varphi, const unsigned int i_0, int i_1) {
+
+    if(W.FrameType() == GWFrames::UnknownFrameType) {
+      INFOTOCERR << "\nWarning: Asking for a Waveform in the " << GWFrames::WaveformFrameNames[GWFrames::UnknownFrameType] << " frame to be evaluated at a point."
+                 << "\n         This assumes that the Waveform::frame member data is correct...\n"
+                 << std::endl;
+    }
+    if(i_1==-1) {
+      i_1 = W.NTimes();
+    }
+    if(i_0>=i_1) {
+      INFOTOCERR << "\nError: Asking to EvaluateAtPoint on indices (i_0=" << i_0 << ") >= (i_1=" << i_1 << ")."
+                 << "\n       This is impossible; i_1 should be at least 1 more than i_0." << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+    if(i_1>W.NTimes()) {
+      INFOTOCERR << "\nError: Asking to EvaluateAtPoint on indices [i_0,i_1)=[" << i_0 << "," << i_1 << ") in a Waveform with " << W.NTimes() << " time steps." << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+
+    const int NM = W.NModes();
+
+    vector<complex<double> > d(i_1-i_0, complex<double>(0.,0.)); // Be sure to initialize to 0.0
+    const Quaternions::Quaternion R_thetaphi(vartheta, varphi);
+    SphericalFunctions::SWSH Y(W.SpinWeight()); // Y can be evaluated in terms of a unit quaternion
+
+    if(W.NFrames()<2) {
+      if(W.NFrames()==0) {
+        Y.SetRotation(R_thetaphi);
+      } else { // W.NFrames()==1
+        Y.SetRotation(W.Frame(0).inverse()*R_thetaphi);
+      }
+      for(int i_m=0; i_m<NM; ++i_m) {
+        const int ell = W.LM(i_m)[0];
+        const int m   = W.LM(i_m)[1];
+        const complex<double> Ylm = Y(ell,m);
+        for(int i_t=i_0; i_t<i_1; ++i_t) {
+          d[i_t-i_0] += W.Data(i_m, i_t) * Ylm;
+        }
+      }
+    } else {
+      for(unsigned int i_t=i_0; i_t<i_1; ++i_t) {
+        Y.SetRotation(W.Frame(i_t).inverse()*R_thetaphi);
+        for(int i_m=0; i_m<NM; ++i_m) {
+          const int ell = W.LM(i_m)[0];
+          const int m   = W.LM(i_m)[1];
+          d[i_t-i_0] += W.Data(i_m, i_t) * Y(ell,m);
+        }
+      }
+    }
+
+    return d;
+  }
+}
+#endif // DOXYGEN
+
 /// Evaluate Waveform at a particular sky location
 std::vector<std::complex<double> > GWFrames::Waveform::EvaluateAtPoint(const double vartheta, const double varphi, const unsigned int i_0, int i_1) const {
   ///
@@ -3174,57 +4826,140 @@ std::vector<std::complex<double> > GWFrames::Waveform::EvaluateAtPoint(const dou
   /// Waveform into the inertial frame.  This saves significant
   /// computational cost.
   ///
+  GWFrames_INSTRUMENT_BYTES("Waveform::EvaluateAtPoint", NTimes()*sizeof(std::complex<double>));
+  return EvaluateModesAtPoint(*this, vartheta, varphi, i_0, i_1);
+}
 
-  if(frameType == GWFrames::UnknownFrameType) {
-    INFOTOCERR << "\nWarning: Asking for a Waveform in the " << GWFrames::WaveformFrameNames[GWFrames::UnknownFrameType] << " frame to be evaluated at a point."
-               << "\n         This assumes that the Waveform::frame member data is correct...\n"
-               << std::endl;
-  }
-  if(i_1==-1) {
-    i_1 = NTimes();
-  }
-  if(i_0>=i_1) {
-    INFOTOCERR << "\nError: Asking to EvaluateAtPoint on indices (i_0=" << i_0 << ") >= (i_1=" << i_1 << ")."
-               << "\n       This is impossible; i_1 should be at least 1 more than i_0." << std::endl;
-    throw(GWFrames_IndexOutOfBounds);
-  }
-  if(i_1>NTimes()) {
-    INFOTOCERR << "\nError: Asking to EvaluateAtPoint on indices [i_0,i_1)=[" << i_0 << "," << i_1 << ") in a Waveform with " << NTimes() << " time steps." << std::endl;
-    throw(GWFrames_IndexOutOfBounds);
-  }
+/// Evaluate the viewed data at a particular sky location
+std::vector<std::complex<double> > GWFrames::WaveformView::EvaluateAtPoint(const double vartheta, const double varphi, const unsigned int i_0, int i_1) const {
+  return EvaluateModesAtPoint(*this, vartheta, varphi, i_0, i_1);
+}
 
-  const int NM = NModes();
+#ifndef DOXYGEN
+namespace {
+  // Shared by Waveform and WaveformView
+  template <typename WaveformType>
+  std::vector<std::vector<std::complex<double> > > EvaluateModesAtPoints(const WaveformType& W, const std::vector<std::vector<double> >& ThetaPhi,
+                                                                         const unsigned int i_0, int i_1) {
+
+    if(W.FrameType() == GWFrames::UnknownFrameType) {
+      INFOTOCERR << "\nWarning: Asking for a Waveform in the " << GWFrames::WaveformFrameNames[GWFrames::UnknownFrameType] << " frame to be evaluated at points."
+                 << "\n         This assumes that the Waveform::frame member data is correct...\n"
+                 << std::endl;
+    }
+    if(i_1==-1) {
+      i_1 = W.NTimes();
+    }
+    if(i_0>=i_1) {
+      INFOTOCERR << "\nError: Asking to EvaluateAtPoints on indices (i_0=" << i_0 << ") >= (i_1=" << i_1 << ")."
+                 << "\n       This is impossible; i_1 should be at least 1 more than i_0." << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
+    if(i_1>W.NTimes()) {
+      INFOTOCERR << "\nError: Asking to EvaluateAtPoints on indices [i_0,i_1)=[" << i_0 << "," << i_1 << ") in a Waveform with " << W.NTimes() << " time steps." << std::endl;
+      throw(GWFrames_IndexOutOfBounds);
+    }
 
-  vector<complex<double> > d(i_1-i_0, complex<double>(0.,0.)); // Be sure to initialize to 0.0
-  const Quaternions::Quaternion R_thetaphi(vartheta, varphi);
-  SphericalFunctions::SWSH Y(SpinWeight()); // Y can be evaluated in terms of a unit quaternion
+    const int NP = ThetaPhi.size();
+    const int NM = W.NModes();
+    const int NT = i_1-i_0;
 
-  if(frame.size()<2) {
-    if(frame.size()==0) {
-      Y.SetRotation(R_thetaphi);
-    } else { // frame.size()==1
-      Y.SetRotation(frame[0].inverse()*R_thetaphi);
+    // Rotors taking the z axis to each point, and the (ell,m) of each mode
+    vector<Quaternion> R_thetaphi(NP);
+    for(int i_p=0; i_p<NP; ++i_p) {
+      if(ThetaPhi[i_p].size()!=2) {
+        INFOTOCERR << "\nError: Point " << i_p << " has " << ThetaPhi[i_p].size() << " components; expected [vartheta, varphi]." << std::endl;
+        throw(GWFrames_VectorSizeMismatch);
+      }
+      R_thetaphi[i_p] = Quaternion(ThetaPhi[i_p][0], ThetaPhi[i_p][1]);
     }
+    vector<int> ell(NM), m(NM);
     for(int i_m=0; i_m<NM; ++i_m) {
-      const int ell = LM(i_m)[0];
-      const int m   = LM(i_m)[1];
-      const complex<double> Ylm = Y(ell,m);
-      for(int i_t=i_0; i_t<i_1; ++i_t) {
-        d[i_t-i_0] += Data(i_m, i_t) * Ylm;
-      }
+      ell[i_m] = W.LM(i_m)[0];
+      m[i_m] = W.LM(i_m)[1];
     }
-  } else {
-    for(unsigned int i_t=i_0; i_t<i_1; ++i_t) {
-      Y.SetRotation(frame[i_t].inverse()*R_thetaphi);
-      for(int i_m=0; i_m<NM; ++i_m) {
-        const int ell = LM(i_m)[0];
-        const int m   = LM(i_m)[1];
-        d[i_t-i_0] += Data(i_m, i_t) * Y(ell,m);
+
+    // Evaluate one SWSH first.  This initializes the SphericalFunctions
+    // singletons before any threads are started.
+    if(NM>0) {
+      SphericalFunctions::SWSH Y(W.SpinWeight());
+      Y.SetRotation(Quaternion(1,0,0,0));
+      Y(ell[0],m[0]);
+    }
+
+    vector<vector<complex<double> > > d(NP, vector<complex<double> >(NT, complex<double>(0.,0.))); // Be sure to initialize to 0.0
+
+    if(W.NFrames()<2) {
+      // The harmonics are constant in time, so each point is a weighted sum of the mode rows
+      const Quaternion R_frame = (W.NFrames()==0 ? Quaternion(1,0,0,0) : W.Frame(0).inverse());
+      #pragma omp parallel if(NP>1) num_threads(GWFrames::MaxThreads())
+      {
+        SphericalFunctions::SWSH Y(W.SpinWeight()); // Y can be evaluated in terms of a unit quaternion
+        #pragma omp for schedule(static)
+        for(int i_p=0; i_p<NP; ++i_p) {
+          Y.SetRotation(R_frame*R_thetaphi[i_p]);
+          complex<double>* d_p = &d[i_p][0];
+          for(int i_m=0; i_m<NM; ++i_m) {
+            const complex<double> Ylm = Y(ell[i_m],m[i_m]);
+            const complex<double>* D = W(i_m)+i_0;
+            for(int i_t=0; i_t<NT; ++i_t) {
+              d_p[i_t] += D[i_t] * Ylm;
+            }
+          }
+        }
+      }
+    } else {
+      // The frame is inverted just once for each time, and reused for every point
+      vector<Quaternion> R_frame(NT);
+      for(int i_t=0; i_t<NT; ++i_t) {
+        R_frame[i_t] = W.Frame(i_0+i_t).inverse();
+      }
+      #pragma omp parallel if(NP>1) num_threads(GWFrames::MaxThreads())
+      {
+        SphericalFunctions::SWSH Y(W.SpinWeight());
+        #pragma omp for schedule(static)
+        for(int i_p=0; i_p<NP; ++i_p) {
+          complex<double>* d_p = &d[i_p][0];
+          for(int i_t=0; i_t<NT; ++i_t) {
+            Y.SetRotation(R_frame[i_t]*R_thetaphi[i_p]);
+            complex<double> sum(0.,0.);
+            for(int i_m=0; i_m<NM; ++i_m) {
+              sum += W(i_m)[i_0+i_t] * Y(ell[i_m],m[i_m]);
+            }
+            d_p[i_t] = sum;
+          }
+        }
       }
     }
+
+    return d;
   }
+}
+#endif // DOXYGEN
+
+/// Evaluate Waveform at many sky locations
+std::vector<std::vector<std::complex<double> > > GWFrames::Waveform::EvaluateAtPoints(const std::vector<std::vector<double> >& ThetaPhi,
+                                                                                     const unsigned int i_0, int i_1) const {
+  ///
+  /// \param ThetaPhi List of [vartheta, varphi] pairs giving the points
+  /// \param i_0 Index of first time step to evaluate (default: 0)
+  /// \param i_1 Index one past the last time step to evaluate (default: -1, meaning NTimes())
+  ///
+  /// The returned array has shape (ThetaPhi.size(), i_1-i_0), and
+  /// each row agrees with `EvaluateAtPoint` for the corresponding
+  /// point.  In a rotating frame, the inverse of each frame rotor is
+  /// found once and reused for all points; in an inertial or
+  /// constant frame, the harmonics are found once per point.  The
+  /// points are divided among threads when compiled with OpenMP.
+  ///
+  GWFrames_INSTRUMENT_BYTES("Waveform::EvaluateAtPoints", ThetaPhi.size()*NTimes()*sizeof(std::complex<double>));
+  return EvaluateModesAtPoints(*this, ThetaPhi, i_0, i_1);
+}
 
-  return d;
+/// Evaluate the viewed data at many sky locations
+std::vector<std::vector<std::complex<double> > > GWFrames::WaveformView::EvaluateAtPoints(const std::vector<std::vector<double> >& ThetaPhi,
+                                                                                         const unsigned int i_0, int i_1) const {
+  return EvaluateModesAtPoints(*this, ThetaPhi, i_0, i_1);
 }
 
 /// Evaluate Waveform at a particular sky location and an instant of time
@@ -3243,6 +4978,7 @@ std::complex<double> GWFrames::Waveform::InterpolateToPoint(const double varthet
   ///
   /// Pointers to GSL interpolation objects can be passed in, which
   /// eliminates the need to re-allocate them for each interpolation.
+  /// To evaluate many points, use a `PointInterpolator` instead.
 
   bool ThisFunctionOwnsThePointers = (accRe==0);
 
@@ -3301,6 +5037,342 @@ std::complex<double> GWFrames::Waveform::InterpolateToPoint(const double varthet
   return value;
 }
 
+#ifndef DOXYGEN
+namespace {
+  // Orders points by time, then by angle, so that points sharing a
+  // time (and possibly a direction) are adjacent
+  struct PointOrder {
+    const std::vector<double>& Vartheta;
+    const std::vector<double>& Varphi;
+    const std::vector<double>& T;
+    PointOrder(const std::vector<double>& vartheta, const std::vector<double>& varphi, const std::vector<double>& t)
+      : Vartheta(vartheta), Varphi(varphi), T(t) { }
+    bool operator()(const int a, const int b) const {
+      if(T[a]!=T[b]) { return T[a]<T[b]; }
+      if(Vartheta[a]!=Vartheta[b]) { return Vartheta[a]<Vartheta[b]; }
+      return Varphi[a]<Varphi[b];
+    }
+  };
+}
+#endif // DOXYGEN
+
+/// Find the spline coefficients of every mode of the Waveform
+GWFrames::PointInterpolator::PointInterpolator(const Waveform& W)
+  : spinWeight(W.SpinWeight()), t(W.T()), ell(W.NModes()), m(W.NModes()), frameInverse(1,0,0,0), coefficients()
+{
+  ///
+  /// \param W Waveform to interpolate
+  ///
+  /// The coefficients take four times the memory of the Waveform's
+  /// data.  The tridiagonal system for the second derivatives
+  /// depends only on the times, so it is factored once and then
+  /// solved for each mode (in parallel, when OpenMP is enabled).
+  GWFrames_INSTRUMENT_BYTES("PointInterpolator::PointInterpolator", 4*W.NTimes()*W.NModes()*sizeof(std::complex<double>));
+
+  if(W.NTimes()<4) {
+    INFOTOCERR << "\nError: " << W.NTimes() << " is not enough points to interpolate.\n"
+               << std::endl;
+    throw(GWFrames_BadWaveformInformation);
+  }
+  if(W.NFrames()>1) {
+    INFOTOCERR << "\nError: A PointInterpolator needs a Waveform in an inertial or constant frame."
+               << "\n       This Waveform is in the " << W.FrameTypeString() << " frame, with " << W.NFrames() << " frame rotors."
+               << "\n       Transform it to the inertial frame first.\n" << std::endl;
+    throw(GWFrames_WrongFrameType);
+  }
+  if(W.FrameType() == GWFrames::UnknownFrameType) {
+    INFOTOCERR << "\nWarning: Asking to interpolate a Waveform in the " << GWFrames::WaveformFrameNames[GWFrames::UnknownFrameType] << " frame."
+               << "\n         This assumes that the Waveform::frame member data is correct...\n"
+               << std::endl;
+  }
+  if(W.NFrames()==1) {
+    frameInverse = W.Frame(0).inverse();
+  }
+
+  const int NT = t.size();
+  const int NM = W.NModes();
+  for(int i_m=0; i_m<NM; ++i_m) {
+    ell[i_m] = W.LM(i_m)[0];
+    m[i_m] = W.LM(i_m)[1];
+  }
+
+  // Evaluate one SWSH here.  This initializes the SphericalFunctions
+  // singletons before either Evaluate function starts any threads.
+  if(NM>0) {
+    SphericalFunctions::SWSH Y(spinWeight);
+    Y.SetRotation(frameInverse);
+    Y(ell[0],m[0]);
+  }
+
+  // Factor the system for the interior second derivatives of a
+  // natural spline (which vanish at the ends)
+  vector<double> h(NT-1), cPrime(NT-1), InverseDenominator(NT-1);
+  for(int i=0; i<NT-1; ++i) {
+    h[i] = t[i+1]-t[i];
+  }
+  for(int i=1; i<NT-1; ++i) {
+    const double Denominator = 2*(h[i-1]+h[i]) - (i>1 ? h[i-1]*cPrime[i-1] : 0.0);
+    InverseDenominator[i] = 1.0/Denominator;
+    cPrime[i] = h[i]*InverseDenominator[i];
+  }
+
+  // Coefficient j of the polynomial in (t_i-t[k]) for mode i_m on
+  // interval k is stored at (4*k+j)*NM+i_m, so that all the modes
+  // needed for one time are together
+  coefficients.resize(4*(NT-1)*NM);
+  #pragma omp parallel if(NM>1) num_threads(GWFrames::MaxThreads())
+  {
+    vector<complex<double> > M(NT);
+    #pragma omp for schedule(dynamic)
+    for(int i_m=0; i_m<NM; ++i_m) {
+      const complex<double>* y = W(i_m);
+      M[0] = 0.0;
+      for(int i=1; i<NT-1; ++i) {
+        const complex<double> r = 6.0*((y[i+1]-y[i])/h[i] - (y[i]-y[i-1])/h[i-1]);
+        M[i] = (r - (i>1 ? h[i-1]*M[i-1] : complex<double>(0.0,0.0))) * InverseDenominator[i];
+      }
+      M[NT-1] = 0.0;
+      for(int i=NT-3; i>0; --i) {
+        M[i] -= cPrime[i]*M[i+1];
+      }
+      for(int k=0; k<NT-1; ++k) {
+        complex<double>* c = &coefficients[4*k*NM+i_m];
+        c[0] = y[k];
+        c[NM] = (y[k+1]-y[k])/h[k] - h[k]*(2.0*M[k]+M[k+1])/6.0;
+        c[2*NM] = 0.5*M[k];
+        c[3*NM] = (M[k+1]-M[k])/(6.0*h[k]);
+      }
+    }
+  }
+}
+
+/// Index of the time interval containing t_i, checking Guess first
+unsigned int GWFrames::PointInterpolator::Interval(const double t_i, const unsigned int Guess) const {
+  const unsigned int NIntervals = t.size()-1;
+  if(Guess<NIntervals && t[Guess]<=t_i && (t_i<t[Guess+1] || Guess==NIntervals-1)) {
+    return Guess;
+  }
+  const unsigned int k = std::upper_bound(t.begin(), t.end(), t_i) - t.begin();
+  return std::min(std::max(k,1u)-1, NIntervals-1);
+}
+
+/// Throw if t_i is outside the times of the Waveform
+void GWFrames::PointInterpolator::CheckTime(const double t_i) const {
+  if(t_i<t[0]) {
+    INFOTOCERR << "\nError: (t_i=" << t_i << ") is earlier than the earliest time in the data (T(0)=" << t[0] << ").\n"
+               << std::endl;
+    throw(GWFrames_ValueError);
+  }
+  if(t_i>t.back()) {
+    INFOTOCERR << "\nError: (t_i=" << t_i << ") is later than the latest time in the data (T(" << t.size()-1 << ")=" << t.back() << ").\n"
+               << std::endl;
+    throw(GWFrames_ValueError);
+  }
+}
+
+/// Interpolate to a single point in angle and time
+std::complex<double> GWFrames::PointInterpolator::operator()(const double vartheta, const double varphi, const double t_i) const {
+  ///
+  /// \param vartheta Polar angle of the point
+  /// \param varphi Azimuthal angle of the point
+  /// \param t_i Time of the point
+  ///
+  /// For more than a few points, `Evaluate` is much faster.
+  return Evaluate(std::vector<double>(1, vartheta), std::vector<double>(1, varphi), std::vector<double>(1, t_i))[0];
+}
+
+/// Interpolate to arbitrary points in angle and time
+std::vector<std::complex<double> > GWFrames::PointInterpolator::Evaluate(const std::vector<double>& Vartheta, const std::vector<double>& Varphi,
+                                                                         const std::vector<double>& T) const {
+  ///
+  /// \param Vartheta Polar angle of each point
+  /// \param Varphi Azimuthal angle of each point
+  /// \param T Time of each point
+  ///
+  /// The points are grouped by time, and the modes are interpolated
+  /// once for each distinct time.  Within a group, the harmonics are
+  /// evaluated once for each distinct direction.  The groups are
+  /// divided among threads when compiled with OpenMP.  The returned
+  /// values are in the order of the input points.
+  GWFrames_INSTRUMENT_BYTES("PointInterpolator::Evaluate", T.size()*NModes()*sizeof(std::complex<double>));
+
+  if(Vartheta.size()!=T.size() || Varphi.size()!=T.size()) {
+    INFOTOCERR << "\nError: Vartheta.size()=" << Vartheta.size() << ", Varphi.size()=" << Varphi.size() << ", and T.size()=" << T.size()
+               << "\n       should all be equal.\n" << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  for(unsigned int i=0; i<T.size(); ++i) {
+    CheckTime(T[i]);
+  }
+
+  const int NP = T.size();
+  const int NM = NModes();
+
+  // Order the points, and find where each group of equal times starts
+  vector<int> Order(NP);
+  for(int i=0; i<NP; ++i) { Order[i] = i; }
+  std::sort(Order.begin(), Order.end(), PointOrder(Vartheta, Varphi, T));
+  vector<int> GroupStart;
+  for(int i=0; i<NP; ++i) {
+    if(i==0 || T[Order[i]]!=T[Order[i-1]]) { GroupStart.push_back(i); }
+  }
+  GroupStart.push_back(NP);
+  const int NG = GroupStart.size()-1;
+
+  vector<complex<double> > Values(NP);
+  #pragma omp parallel if(NG>1) num_threads(GWFrames::MaxThreads())
+  {
+    SphericalFunctions::SWSH Y(spinWeight);
+    vector<complex<double> > h(NM), Ylm(NM);
+    unsigned int k = 0;
+    #pragma omp for schedule(dynamic,16)
+    for(int i_g=0; i_g<NG; ++i_g) {
+      // Interpolate every mode to this group's time
+      const double t_i = T[Order[GroupStart[i_g]]];
+      k = Interval(t_i, k);
+      const double s = t_i-t[k];
+      const complex<double>* c = &coefficients[4*k*NM];
+      for(int i_m=0; i_m<NM; ++i_m) {
+        h[i_m] = c[i_m] + s*(c[NM+i_m] + s*(c[2*NM+i_m] + s*c[3*NM+i_m]));
+      }
+      // Sum the modes at each point in the group
+      for(int i=GroupStart[i_g]; i<GroupStart[i_g+1]; ++i) {
+        const int i_p = Order[i];
+        if(i==GroupStart[i_g] || Vartheta[i_p]!=Vartheta[Order[i-1]] || Varphi[i_p]!=Varphi[Order[i-1]]) {
+          Y.SetRotation(frameInverse*Quaternion(Vartheta[i_p], Varphi[i_p]));
+          for(int i_m=0; i_m<NM; ++i_m) {
+            Ylm[i_m] = Y(ell[i_m],m[i_m]);
+          }
+        }
+        complex<double> sum(0.,0.);
+        for(int i_m=0; i_m<NM; ++i_m) {
+          sum += h[i_m] * Ylm[i_m];
+        }
+        Values[i_p] = sum;
+      }
+    }
+  }
+
+  return Values;
+}
+
+/// Interpolate to series of times at each of several directions
+std::vector<std::vector<std::complex<double> > > GWFrames::PointInterpolator::Evaluate(const std::vector<std::vector<double> >& ThetaPhi,
+                                                                                       const std::vector<std::vector<double> >& T) const {
+  ///
+  /// \param ThetaPhi List of [vartheta, varphi] pairs giving the directions
+  /// \param T List of times at which to evaluate, one list for each direction
+  ///
+  /// This suits many retarded times at each of a set of sky
+  /// positions.  The harmonics are evaluated once for each direction
+  /// and contracted with the spline coefficients, so each time costs
+  /// one polynomial evaluation when consecutive times share an
+  /// interval, and four sums over the modes otherwise.  The times for
+  /// each direction need not be sorted, though sorted times find
+  /// their intervals fastest.  The directions are divided among
+  /// threads when compiled with OpenMP.  Element [i][j] of the result
+  /// is the value at direction i and time T[i][j].
+  GWFrames_INSTRUMENT("PointInterpolator::Evaluate(ThetaPhi, T)");
+
+  if(ThetaPhi.size()!=T.size()) {
+    INFOTOCERR << "\nError: ThetaPhi.size()=" << ThetaPhi.size() << " != T.size()=" << T.size() << ".\n" << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  for(unsigned int i_p=0; i_p<ThetaPhi.size(); ++i_p) {
+    if(ThetaPhi[i_p].size()!=2) {
+      INFOTOCERR << "\nError: Point " << i_p << " has " << ThetaPhi[i_p].size() << " components; expected [vartheta, varphi]." << std::endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    for(unsigned int i_t=0; i_t<T[i_p].size(); ++i_t) {
+      CheckTime(T[i_p][i_t]);
+    }
+  }
+
+  const int NP = ThetaPhi.size();
+  const int NM = NModes();
+
+  vector<vector<complex<double> > > Values(NP);
+  #pragma omp parallel if(NP>1) num_threads(GWFrames::MaxThreads())
+  {
+    SphericalFunctions::SWSH Y(spinWeight);
+    vector<complex<double> > Ylm(NM);
+    #pragma omp for schedule(dynamic)
+    for(int i_p=0; i_p<NP; ++i_p) {
+      Y.SetRotation(frameInverse*Quaternion(ThetaPhi[i_p][0], ThetaPhi[i_p][1]));
+      for(int i_m=0; i_m<NM; ++i_m) {
+        Ylm[i_m] = Y(ell[i_m],m[i_m]);
+      }
+      const vector<double>& T_p = T[i_p];
+      vector<complex<double> >& V = Values[i_p];
+      V.resize(T_p.size());
+      unsigned int k = 0;
+      bool HaveInterval = false;
+      complex<double> a[4];
+      for(unsigned int i_t=0; i_t<T_p.size(); ++i_t) {
+        const unsigned int k_i = Interval(T_p[i_t], k);
+        if(!HaveInterval || k_i!=k) {
+          // Contract the harmonics with this interval's coefficients
+          k = k_i;
+          HaveInterval = true;
+          const complex<double>* c = &coefficients[4*k*NM];
+          for(int j=0; j<4; ++j) {
+            complex<double> sum(0.,0.);
+            for(int i_m=0; i_m<NM; ++i_m) {
+              sum += c[j*NM+i_m] * Ylm[i_m];
+            }
+            a[j] = sum;
+          }
+        }
+        const double s = T_p[i_t]-t[k];
+        V[i_t] = a[0] + s*(a[1] + s*(a[2] + s*a[3]));
+      }
+    }
+  }
+
+  return Values;
+}
+
+#ifndef DOXYGEN
+namespace {
+  // Natural cubic spline through four knots (as `gsl_interp_cspline`
+  // constructs it), expressed as linear weights on the data.  The
+  // knot-dependent part is set up once by `Init`, after which the
+  // weights at any point cost only a few multiplications.
+  struct FourPointSpline {
+    double x[4], h[3];
+    double M[4][4]; // Second derivatives at the knots, as linear functions of the data
+    void Init(const double* X) {
+      for(int i=0; i<4; ++i) { x[i] = X[i]; }
+      for(int i=0; i<3; ++i) { h[i] = x[i+1]-x[i]; }
+      // Natural end conditions leave a 2x2 system for the interior second derivatives
+      const double a = 2*(h[0]+h[1]), b = h[1], c = h[1], d = 2*(h[1]+h[2]);
+      const double det = a*d - b*c;
+      for(int j=0; j<4; ++j) {
+        const double r1 = 6*( ((j==2)-(j==1))/h[1] - ((j==1)-(j==0))/h[0] );
+        const double r2 = 6*( ((j==3)-(j==2))/h[2] - ((j==2)-(j==1))/h[1] );
+        M[0][j] = 0.0;
+        M[1][j] = (d*r1 - b*r2)/det;
+        M[2][j] = (a*r2 - c*r1)/det;
+        M[3][j] = 0.0;
+      }
+    }
+    void operator()(const double u, double* w) const {
+      const int k = (u<x[1] ? 0 : (u<x[2] ? 1 : 2));
+      const double t = x[k+1]-u, s = u-x[k], H = h[k];
+      const double c = (t*t*t/H - H*t)/6.0, d = (s*s*s/H - H*s)/6.0;
+      for(int j=0; j<4; ++j) {
+        w[j] = c*M[k][j] + d*M[k+1][j];
+      }
+      w[k] += t/H;
+      w[k+1] += s/H;
+    }
+  };
+
+  // Number of output times handled together by Waveform::Translate
+  const int TranslateBlockSize = 64;
+}
+#endif // DOXYGEN
+
 /// Translate the waveform data by some series of spatial translations
 GWFrames::Waveform GWFrames::Waveform::Translate(const std::vector<std::vector<double> >& deltax) const {
   /// \param deltax Array of 3-vectors by which to translate (function of time)
@@ -3316,11 +5388,16 @@ GWFrames::Waveform GWFrames::Waveform::Translate(const std::vector<std::vector<d
   /// more expensive to transform it first.  (Basically, try not to
   /// bother transforming the Waveform before calling this function.)
   ///
-  /// This function is very slow because it has to interpolate to
-  /// NTimes*(2*ellMax+1)^2 different completely unique points.  Since
-  /// interpolation is so slow, this takes a lot of time.  The
-  /// function also has to transform back from physical space to
-  /// modes, which is another significant chunk of time.
+  /// The data must be interpolated to NTimes*(2*ellMax+1)^2 different
+  /// points in time and angle.  The output times are processed in
+  /// blocks (in parallel, when OpenMP is enabled).  For each block,
+  /// the input data are evaluated on the equi-angular grid once at
+  /// every time the block needs.  Each point is then interpolated
+  /// with the same local cubic spline as `InterpolateToPoint`, whose
+  /// knot-dependent coefficients are shared by all grid points.  The
+  /// grid is transformed back to modes with a cached `SHTPlan`.
+  /// Memory use is proportional to the block size, not to NTimes.
+  GWFrames_INSTRUMENT_BYTES("Waveform::Translate", NTimes()*NModes()*sizeof(std::complex<double>));
 
   if(frameType == GWFrames::UnknownFrameType) {
     INFOTOCERR << "\nWarning: Asking to Translate a Waveform in an `" << GWFrames::WaveformFrameNames[frameType] << "` frame."
@@ -3344,6 +5421,12 @@ GWFrames::Waveform GWFrames::Waveform::Translate(const std::vector<std::vector<d
     }
   }
 
+  if(ntimes<4) {
+    INFOTOCERR << "\nError: " << ntimes << " is not enough points to interpolate.\n"
+               << std::endl;
+    throw(GWFrames_BadWaveformInformation);
+  }
+
   // Copy infrastructure to new Waveform
   const Waveform& A = *this;
   Waveform B = A.CopyWithoutData();
@@ -3352,43 +5435,45 @@ GWFrames::Waveform GWFrames::Waveform::Translate(const std::vector<std::vector<d
   B.frame = std::vector<Quaternions::Quaternion>(0);
   B.frameType = GWFrames::Inertial;
   B.lm = A.lm;
+  B.modeLayout = A.modeLayout;
   B.t = A.t; // B.t will get reset later
 
   // These numbers determine the equi-angular grid on which we will do
   // the interpolation.  For best accuracy, have N_phi > 2*ellMax and
   // N_theta > 2*ellMax; but for speed, don't make them much greater.
   const int ellMax(EllMax());
-  const unsigned int N_phi = 2*ellMax + 1;
-  const unsigned int N_theta = 2*ellMax + 1;
+  const int N_phi = 2*ellMax + 1;
+  const int N_theta = 2*ellMax + 1;
+  const int N_g = N_theta*N_phi;
   const double dtheta = M_PI/double(N_theta-1); // theta should return to M_PI
   const double dphi = 2*M_PI/double(N_phi); // phi should not return to 2*M_PI
-  vector<complex<double> > Grid(N_phi*N_theta);
 
   // Find earliest and latest times we can use for our new data set
   unsigned int iEarliest = 0;
   unsigned int iLatest = ntimes-1;
   const double tEarliest = t[0];
   const double tLatest = t.back();
+  vector<double> deltaxMag(ntimes);
+  for(unsigned int i=0; i<ntimes; ++i) {
+    deltaxMag[i] = std::sqrt(deltax[i][0]*deltax[i][0] + deltax[i][1]*deltax[i][1] + deltax[i][2]*deltax[i][2]);
+  }
   { // Do the 0th point explicitly for earliest time only
     const unsigned int i=0;
-    const double deltaxiMag = std::sqrt(deltax[i][0]*deltax[i][0] + deltax[i][1]*deltax[i][1] + deltax[i][2]*deltax[i][2]);
-    if(t[i]-deltaxiMag<tEarliest) {
+    if(t[i]-deltaxMag[i]<tEarliest) {
       iEarliest = std::max(iEarliest, i+1);
     }
   }
   for(unsigned int i=1; i<ntimes-1; ++i) { // Do all points in between
-    const double deltaxiMag = std::sqrt(deltax[i][0]*deltax[i][0] + deltax[i][1]*deltax[i][1] + deltax[i][2]*deltax[i][2]);
-    if(t[i]-deltaxiMag<tEarliest) {
+    if(t[i]-deltaxMag[i]<tEarliest) {
       iEarliest = std::max(iEarliest, i+1);
     }
-    if(t[i]+deltaxiMag>tLatest) {
+    if(t[i]+deltaxMag[i]>tLatest) {
       iLatest = std::min(iLatest, i-1);
     }
   }
   { // Do the last point explicitly for latest time
     const unsigned int i=ntimes-1;
-    const double deltaxiMag = std::sqrt(deltax[i][0]*deltax[i][0] + deltax[i][1]*deltax[i][1] + deltax[i][2]*deltax[i][2]);
-    if(t[i]+deltaxiMag>tLatest) {
+    if(t[i]+deltaxMag[i]>tLatest) {
       iLatest = std::min(iLatest, i-1);
     }
   }
@@ -3406,112 +5491,202 @@ GWFrames::Waveform GWFrames::Waveform::Translate(const std::vector<std::vector<d
   B.t.erase(B.t.begin(), B.t.begin()+iEarliest);
   B.data.resize(NModes(), B.NTimes()); // Each row (first index, nn) corresponds to a mode
 
-  // We allocate just once, for speed, and pass these to InterpolateToPoint
-  gsl_interp_accel* accRe = gsl_interp_accel_alloc();
-  gsl_interp_accel* accIm = gsl_interp_accel_alloc();
-  gsl_spline* splineRe = gsl_spline_alloc(gsl_interp_cspline, 4);
-  gsl_spline* splineIm = gsl_spline_alloc(gsl_interp_cspline, 4);
-
-  // Main loop over time steps
-  for(unsigned int i_t_B=0; i_t_B<B.NTimes(); ++i_t_B) {
-    // These will hold the input and output data.  Note that spinsfast
-    // has had some weird behavior in the past when the output data is
-    // not initialized to zero, so just do this each time, even though
-    // it's slow.
-    vector<complex<double> > Modes(N_lm(ellMax), 0.0);
-
-    // Construct the data on the translated grid
-    for(int i_g=0, i_theta=0; i_theta<N_theta; ++i_theta) {
-      for(int i_phi=0; i_phi<N_phi; ++i_phi, ++i_g) {
-        const double theta = dtheta*i_theta;
-        const double phi = dphi*i_phi;
-
-        const double rHat_dot_deltax =
-          deltax[i_t_B][0]*std::sin(theta)*std::cos(phi)
-          + deltax[i_t_B][1]*std::sin(theta)*std::sin(phi)
-          + deltax[i_t_B][2]*std::cos(theta);
-
-        // Evaluate the data for the translated frame at this point
-        Grid[i_g] = A.InterpolateToPoint(theta, phi, B.T(i_t_B)-rHat_dot_deltax, accRe, accIm, splineRe, splineIm);
-      }
+  // Precompute everything about the grid that does not depend on time
+  const int NM = NModes();
+  vector<int> ell(NM), m(NM);
+  for(int i_m=0; i_m<NM; ++i_m) {
+    ell[i_m] = A.LM(i_m)[0];
+    m[i_m] = A.LM(i_m)[1];
+  }
+  vector<double> rHat(3*N_g);
+  vector<Quaternion> R_g(N_g);
+  for(int i_g=0, i_theta=0; i_theta<N_theta; ++i_theta) {
+    for(int i_phi=0; i_phi<N_phi; ++i_phi, ++i_g) {
+      const double theta = dtheta*i_theta;
+      const double phi = dphi*i_phi;
+      rHat[3*i_g+0] = std::sin(theta)*std::cos(phi);
+      rHat[3*i_g+1] = std::sin(theta)*std::sin(phi);
+      rHat[3*i_g+2] = std::cos(theta);
+      R_g[i_g] = Quaternion(theta, phi);
     }
-
-    // Decompose the data into modes
-    spinsfast_map2salm(reinterpret_cast<fftw_complex*>(&Grid[0]),
-                       reinterpret_cast<fftw_complex*>(&Modes[0]),
-                       SpinWeight(), N_theta, N_phi, ellMax);
-
-    // Set new data at this time step
-    for(int i_mode=N_lm(std::abs(SpinWeight())-1), ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
-      for(int m=-ell; m<=ell; ++m, ++i_mode) {
-        B.SetData(B.FindModeIndex(ell,m), i_t_B, Modes[i_mode]);
+  }
+  // In an inertial (or fixed) frame, the harmonics at each grid point are constant
+  const bool StaticFrame = (A.NFrames()<2);
+  vector<complex<double> > Y_g(StaticFrame ? N_g*NM : 0);
+  if(StaticFrame) {
+    const Quaternion R_frame = (A.NFrames()==0 ? Quaternion(1,0,0,0) : A.Frame(0).inverse());
+    SphericalFunctions::SWSH Y(SpinWeight());
+    for(int i_g=0; i_g<N_g; ++i_g) {
+      Y.SetRotation(R_frame*R_g[i_g]);
+      for(int i_m=0; i_m<NM; ++i_m) {
+        Y_g[i_g*NM+i_m] = Y(ell[i_m],m[i_m]);
       }
     }
+  }
+  // The output rows that receive each mode of the transformed grid
+  vector<int> Row(N_lm(ellMax), -1);
+  for(int i_mode=N_lm(std::abs(SpinWeight())-1), ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
+    for(int m=-ell; m<=ell; ++m, ++i_mode) {
+      Row[i_mode] = B.FindModeIndex(ell,m);
+    }
+  }
+  const SHTPlan& Plan = SHTPlan::Get(SpinWeight(), ellMax, N_theta, N_phi);
 
-  } // i_t_B loop
-
-  gsl_interp_accel_free(accRe);
-  gsl_interp_accel_free(accIm);
-  gsl_spline_free(splineRe);
-  gsl_spline_free(splineIm);
-
-  return B;
-}
+  // Main loop over blocks of output times
+  const int NTimesB = B.NTimes();
+  const int NBlocks = (NTimesB+TranslateBlockSize-1)/TranslateBlockSize;
+  #pragma omp parallel if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+  {
+    SphericalFunctions::SWSH Y(SpinWeight());
+    vector<complex<double> > F; // F[i_g*NTin+i_t]: input data on the grid at the times this block needs
+    vector<FourPointSpline> Splines;
+    vector<complex<double> > Grid(N_g), Modes(N_lm(ellMax));
+    double w[4];
+    #pragma omp for schedule(dynamic)
+    for(int i_b=0; i_b<NBlocks; ++i_b) {
+      const int i_B_a = i_b*TranslateBlockSize;
+      const int i_B_b = std::min(NTimesB, i_B_a+TranslateBlockSize);
+
+      // Find the range of input times whose data this block needs; the
+      // four-point window starting at i_t_0 is chosen exactly as in
+      // InterpolateToPoint
+      double MaxShift = 0.0;
+      for(int i_B=i_B_a; i_B<i_B_b; ++i_B) {
+        MaxShift = std::max(MaxShift, deltaxMag[iEarliest+i_B]);
+      }
+      const int i_in_a = std::min(std::max(int(Quaternions::hunt(t, B.t[i_B_a]-MaxShift))-1, 0), int(ntimes)-4);
+      const int i_in_b = std::min(std::max(int(Quaternions::hunt(t, B.t[i_B_b-1]+MaxShift))-1, 0), int(ntimes)-4) + 4;
+      const int NTin = i_in_b-i_in_a;
+
+      // Evaluate the input data on the grid at those times
+      F.assign(N_g*NTin, complex<double>(0.0,0.0));
+      if(StaticFrame) {
+        for(int i_g=0; i_g<N_g; ++i_g) {
+          complex<double>* F_g = &F[i_g*NTin];
+          const complex<double>* Y_gm = &Y_g[i_g*NM];
+          for(int i_m=0; i_m<NM; ++i_m) {
+            const complex<double> Ylm = Y_gm[i_m];
+            const complex<double>* D = A(i_m)+i_in_a;
+            for(int i_t=0; i_t<NTin; ++i_t) {
+              F_g[i_t] += D[i_t] * Ylm;
+            }
+          }
+        }
+      } else {
+        for(int i_t=0; i_t<NTin; ++i_t) {
+          const Quaternion R_frame = A.Frame(i_in_a+i_t).inverse();
+          for(int i_g=0; i_g<N_g; ++i_g) {
+            Y.SetRotation(R_frame*R_g[i_g]);
+            complex<double> sum(0.,0.);
+            for(int i_m=0; i_m<NM; ++i_m) {
+              sum += A(i_m)[i_in_a+i_t] * Y(ell[i_m],m[i_m]);
+            }
+            F[i_g*NTin+i_t] = sum;
+          }
+        }
+      }
 
-/// Apply a boost to Psi4 data
-GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<double> >& v) {
-  /// This function does three things.  First, it evaluates the
-  /// Waveform on what will become an equi-angular grid after
-  /// transformation by the boost.  Second, at each point of that
-  /// grid, it takes the appropriate combinations of the present value
-  /// of Psi_4 and its conjugate to give the value of Psi_4 as
-  /// observed in the boosted frame.  Finally, it transforms back to
-  /// Fourier space using that new equi-angular grid.
-  ///
-  /// The input three-velocities are assumed to give the velocities of
-  /// the boosted frame relative to the present frame.
+      // Set up the spline on every four-point window in that range
+      Splines.resize(NTin-3);
+      for(int i_w=0; i_w<NTin-3; ++i_w) {
+        Splines[i_w].Init(&t[i_in_a+i_w]);
+      }
 
-  // Check the size of the input velocity
-  if(v.size()!=NTimes()) {
-    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": (v.size()=" << v.size() << ") != (NTimes()=" << NTimes() << ")" << std::endl;
-    throw(GWFrames_VectorSizeMismatch);
-  }
+      // Interpolate each grid point to its retarded time, and decompose into modes
+      for(int i_B=i_B_a; i_B<i_B_b; ++i_B) {
+        // B.t[i_B] is t[iEarliest+i_B], and deltax is indexed by the
+        // input times.  (Before this function was rewritten, it used
+        // deltax[i_B], the translation at the wrong time whenever
+        // iEarliest>0.)
+        const double t_B = B.t[i_B];
+        const std::vector<double>& dx = deltax[iEarliest+i_B];
+        unsigned int i_t_guess = i_in_a;
+        for(int i_g=0; i_g<N_g; ++i_g) {
+          const double rHat_dot_deltax = dx[0]*rHat[3*i_g+0] + dx[1]*rHat[3*i_g+1] + dx[2]*rHat[3*i_g+2];
+          const double t_i = t_B - rHat_dot_deltax;
+          i_t_guess = Quaternions::hunt(t, t_i, i_t_guess);
+          const int i_t_0 = std::min(std::max(int(i_t_guess)-1, 0), int(ntimes)-4);
+          const int i_w = std::min(std::max(i_t_0-i_in_a, 0), NTin-4);
+          Splines[i_w](t_i, w);
+          const complex<double>* F_g = &F[i_g*NTin+i_w];
+          Grid[i_g] = w[0]*F_g[0] + w[1]*F_g[1] + w[2]*F_g[2] + w[3]*F_g[3];
+        }
+        Plan.Forward(&Grid[0], &Modes[0]);
+        for(int i_mode=0; i_mode<int(Modes.size()); ++i_mode) {
+          if(Row[i_mode]>=0) {
+            B.data[Row[i_mode]][i_B] = Modes[i_mode];
+          }
+        }
+      }
+    } // i_b loop
+  } // omp parallel
 
-  // Set up storage and calculate useful constants
-  const int ellMax = this->EllMax();
-  const int n_thetaRotated= 2*ellMax+1;
-  const int n_phiRotated = 2*ellMax+1;
-  const double dthetaRotated = M_PI/double(n_thetaRotated-1); // thetaRotated should return to M_PI
-  const double dphiRotated = 2*M_PI/double(n_phiRotated); // phiRotated should not return to 2*M_PI
-  vector<complex<double> > Grid(n_phiRotated*n_thetaRotated);
-  SphericalFunctions::SWSH sYlm(SpinWeight());
-
-  SpacetimeAlgebra::vector tPz;
-  tPz.set_gamma_0(1./std::sqrt(2));
-  tPz.set_gamma_3(1./std::sqrt(2));
-  SpacetimeAlgebra::vector tMz;
-  tMz.set_gamma_0(1./std::sqrt(2));
-  tMz.set_gamma_3(-1./std::sqrt(2));
-  SpacetimeAlgebra::vector xPiyRe;
-  xPiyRe.set_gamma_1(1./std::sqrt(2));
-  SpacetimeAlgebra::vector xPiyIm;
-  xPiyIm.set_gamma_2(1./std::sqrt(2));
-  SpacetimeAlgebra::vector xMiyRe;
-  xMiyRe.set_gamma_1(1./std::sqrt(2));
-  SpacetimeAlgebra::vector xMiyIm;
-  xMiyIm.set_gamma_2(-1./std::sqrt(2));
-
-  // Main loop over time steps
-  for(unsigned int i_t=0; i_t<NTimes(); ++i_t) {
-    const vector<double>& v_i = v[i_t];
-    if(v_i.size()!=3) {
-      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": v[" << i_t << "].size()=" << v_i.size()
-                << ".  Input is assumed to be a vector of three-velocities." << std::endl;
-      throw(GWFrames_VectorSizeMismatch);
-    }
+  return B;
+}
+
+#ifndef DOXYGEN
+namespace {
+  // Everything needed to boost data on the equi-angular grid that
+  // depends only on the velocity.  For each point of the grid in the
+  // boosted frame, we store the SWSHs (for ell>=|s|) at the
+  // corresponding point of the present frame, along with the
+  // coefficients multiplying the present value and its conjugate to
+  // give the value in the boosted frame.
+  class BoostedGridCoefficients {
+  private:
+    int s;
+    int ellMax;
+    int n_theta;
+    int n_phi;
+    bool FakeH;
+    std::vector<double> v;
+    std::vector<complex<double> > Y; // Y[i_g*NModes+i_m], where i_m counts modes with ell>=|s|
+    std::vector<complex<double> > a; // Multiplies the value at each point
+    std::vector<complex<double> > b; // Multiplies the conjugate of the value at each point
+  public:
+    BoostedGridCoefficients(const int Spin, const int EllMax, const bool fakeH)
+      : s(Spin), ellMax(EllMax), n_theta(2*EllMax+1), n_phi(2*EllMax+1), FakeH(fakeH) { }
+    inline int NModes() const { return N_lm(ellMax)-N_lm(std::abs(s)-1); }
+    bool Matches(const std::vector<double>& v_i, const double Tolerance) const;
+    void Set(const std::vector<double>& v_i);
+    void Apply(const complex<double>* ModeData, complex<double>* Grid) const;
+  };
+
+  bool BoostedGridCoefficients::Matches(const std::vector<double>& v_i, const double Tolerance) const {
+    if(v.size()!=3) { return false; }
+    const double dv0 = v_i[0]-v[0], dv1 = v_i[1]-v[1], dv2 = v_i[2]-v[2];
+    return (std::sqrt(dv0*dv0 + dv1*dv1 + dv2*dv2) <= Tolerance);
+  }
+
+  void BoostedGridCoefficients::Set(const std::vector<double>& v_i) {
+    // This is the original per-time-step calculation of BoostPsi4,
+    // except that the results are stored rather than used immediately.
+    const int n_g = n_theta*n_phi;
+    const int NM = NModes();
+    const double dthetaRotated = M_PI/double(n_theta-1); // thetaRotated should return to M_PI
+    const double dphiRotated = 2*M_PI/double(n_phi); // phiRotated should not return to 2*M_PI
+    v = v_i;
+    Y.resize(n_g*NM);
+    a.resize(n_g);
+    b.resize(n_g);
+    SphericalFunctions::SWSH sYlm(s);
+
+    SpacetimeAlgebra::vector tPz;
+    tPz.set_gamma_0(1./std::sqrt(2));
+    tPz.set_gamma_3(1./std::sqrt(2));
+    SpacetimeAlgebra::vector tMz;
+    tMz.set_gamma_0(1./std::sqrt(2));
+    tMz.set_gamma_3(-1./std::sqrt(2));
+    SpacetimeAlgebra::vector xPiyRe;
+    xPiyRe.set_gamma_1(1./std::sqrt(2));
+    SpacetimeAlgebra::vector xPiyIm;
+    xPiyIm.set_gamma_2(1./std::sqrt(2));
+    SpacetimeAlgebra::vector xMiyRe;
+    xMiyRe.set_gamma_1(1./std::sqrt(2));
+    SpacetimeAlgebra::vector xMiyIm;
+    xMiyIm.set_gamma_2(-1./std::sqrt(2));
 
     const double beta = std::sqrt(v_i[0]*v_i[0] + v_i[1]*v_i[1] + v_i[2]*v_i[2]);
-    if(beta<1.e-9) { continue; } // TODO: This may need to be adjusted, or other statements made smarter about using the value of gamma
     vector<double> vHat(3);
     vHat[0] = v_i[0]/beta;
     vHat[1] = v_i[1]/beta;
@@ -3519,6 +5694,8 @@ GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<
     const double gamma = 1.0/std::sqrt(1.0-beta*beta);
     const double sqrtplus = std::sqrt((gamma+1)/2);
     const double sqrtminus = std::sqrt((gamma-1)/2);
+    // For BoostHFaked, every point is multiplied by gamma^{-2}
+    const double Factor = (FakeH ? 1.0/(gamma*gamma) : 1.0);
 
     // Calculate the boost rotor
     SpacetimeAlgebra::spinor BoostRotor;
@@ -3527,24 +5704,8 @@ GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<
     BoostRotor.set_gamma_0_gamma_2(sqrtminus*vHat[1]);
     BoostRotor.set_gamma_0_gamma_3(sqrtminus*vHat[2]);
 
-    vector<complex<double> > Modes(N_lm(ellMax), 0.0);
-    vector<complex<double> > Modes2(N_lm(ellMax), 0.0);
-
-    // Fill the Modes data for this time step
-    for(int i_mode=0; i_mode<N_lm(std::abs(SpinWeight())-1); ++i_mode) {
-      // Explicitly zero the modes with ell<|s|
-      Modes[i_mode] = 0.0;
-    }
-    for(int i_mode=N_lm(std::abs(SpinWeight())-1), ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
-      // Now, fill modes with ell>=|s| in the correct order
-      for(int m=-ell; m<=ell; ++m, ++i_mode) {
-        Modes[i_mode] = this->Data(FindModeIndex(ell,m), i_t);
-      }
-    }
-
-    // Construct the data on the distorted grid
-    for(int i_g=0, i_thetaRotated=0; i_thetaRotated<n_thetaRotated; ++i_thetaRotated) {
-      for(int i_phiRotated=0; i_phiRotated<n_phiRotated; ++i_phiRotated, ++i_g) {
+    for(int i_g=0, i_thetaRotated=0; i_thetaRotated<n_theta; ++i_thetaRotated) {
+      for(int i_phiRotated=0; i_phiRotated<n_phi; ++i_phiRotated, ++i_g) {
         const double thetaRotated = dthetaRotated*i_thetaRotated;
         const double phiRotated = dphiRotated*i_phiRotated;
 
@@ -3570,7 +5731,13 @@ GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<
         const SpacetimeAlgebra::vector mBarImRotated(LorentzRotor*xMiyIm*SpacetimeAlgebra::reverse(LorentzRotor), Filler);
 
         // Figure out the coordinates in the present frame
-        // corresponding to the given coordinates in the boosted frame
+        // corresponding to the given coordinates in the boosted frame.
+        // Note that the (theta,phi) coordinates produced here are not
+        // in the same range as the (thetaRotated,phiRotated)
+        // coordinates because of (1) the range of atan2, which is in
+        // (-pi,pi), rather than (0,2*pi); and (2) at (theta=0), the
+        // phi value comes out as 0, even though phiRotated may not be.
+        // Both are handled by taking the tetrad components as we do.
         vector<double> r(3);
         r[0] = lRotated.get_gamma_1();
         r[1] = lRotated.get_gamma_2();
@@ -3579,16 +5746,6 @@ GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<
         const double theta = std::acos(r[2]/rMag);
         const double phi = std::atan2(r[1],r[0]);
 
-        if(i_g==0 && i_t==0) {
-          std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ":\n"
-                    << "    Note that the (theta,phi) coordinates produced here are not in the same range\n"
-                    << "    as the (thetaRotated,phiRotated) coordinates because of (1) the range of atan2,\n"
-                    << "    which is in (-pi,pi), rather than (0,2*pi); and (2) at (theta=0), the phi value\n"
-                    << "    comes out as 0, even though phiRotated may not be.\n\n"
-                    << "    Fortunately, I think both these problems are handled automatically by taking the\n"
-                    << "    tetrad components as we do.  Of course, I may be missing something problematic...\n" << std::endl;
-        }
-
         // This gives us the rotor to get from the z axis to the
         // spherical coordinates in the present frame
         SpacetimeAlgebra::spinor Rotor_theta;
@@ -3601,17 +5758,19 @@ GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<
 
         // The following give the important tetrad elements in the present frame
         const SpacetimeAlgebra::vector l(RotationRotor*tPz*SpacetimeAlgebra::reverse(RotationRotor), Filler);
-        const SpacetimeAlgebra::vector n(RotationRotor*tMz*SpacetimeAlgebra::reverse(RotationRotor), Filler);
         const SpacetimeAlgebra::vector mRe(RotationRotor*xPiyRe*SpacetimeAlgebra::reverse(RotationRotor), Filler);
         const SpacetimeAlgebra::vector mIm(RotationRotor*xPiyIm*SpacetimeAlgebra::reverse(RotationRotor), Filler);
         const SpacetimeAlgebra::vector mBarRe(RotationRotor*xMiyRe*SpacetimeAlgebra::reverse(RotationRotor), Filler);
         const SpacetimeAlgebra::vector mBarIm(RotationRotor*xMiyIm*SpacetimeAlgebra::reverse(RotationRotor), Filler);
 
-        // Get the value of Psi4 in this frame at the appropriate
-        // point of this frame
-        const Quaternion Rp(theta, phi);
-        sYlm.SetRotation(Rp);
-        const complex<double> Psi_4 = sYlm.Evaluate(Modes);
+        // Store the SWSHs at the appropriate point of this frame
+        sYlm.SetRotation(Quaternion(theta, phi));
+        complex<double>* Y_g = &Y[i_g*NM];
+        for(int i_m=0, ell=std::abs(s); ell<=ellMax; ++ell) {
+          for(int m=-ell; m<=ell; ++m, ++i_m) {
+            Y_g[i_m] = sYlm(ell,m);
+          }
+        }
 
         // Get the components of the other frame's tetrad in the basis
         // of this tetrad.  In particular, these are *not* the dot
@@ -3637,44 +5796,153 @@ GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<
           SpacetimeAlgebra::sp(mBarReRotated, mRe) + i_complex*SpacetimeAlgebra::sp(mBarReRotated, mIm)
           + i_complex * ( SpacetimeAlgebra::sp(mBarImRotated, mRe) + i_complex*SpacetimeAlgebra::sp(mBarImRotated, mIm) );
 
-        // Evaluate the data for the boosted frame at this point
-        Grid[i_g] =
+        // The coefficients of the value and its conjugate in the boosted frame
+        a[i_g] = Factor *
           (nRotated_n * mBarRotated_mBar * nRotated_n * mBarRotated_mBar
            - nRotated_mBar * mBarRotated_n * nRotated_n * mBarRotated_mBar
            - nRotated_n * mBarRotated_mBar * nRotated_mBar * mBarRotated_n
-           + nRotated_mBar * mBarRotated_n * nRotated_mBar * mBarRotated_n) * Psi_4
-          + (nRotated_n * mBarRotated_m * nRotated_n * mBarRotated_m
-             - nRotated_m * mBarRotated_n * nRotated_n * mBarRotated_m
-             - nRotated_n * mBarRotated_m * nRotated_m * mBarRotated_n
-             + nRotated_m * mBarRotated_n * nRotated_m * mBarRotated_n) * std::conj(Psi_4);
+           + nRotated_mBar * mBarRotated_n * nRotated_mBar * mBarRotated_n);
+        b[i_g] = Factor *
+          (nRotated_n * mBarRotated_m * nRotated_n * mBarRotated_m
+           - nRotated_m * mBarRotated_n * nRotated_n * mBarRotated_m
+           - nRotated_n * mBarRotated_m * nRotated_m * mBarRotated_n
+           + nRotated_m * mBarRotated_n * nRotated_m * mBarRotated_n);
+      }
+    }
+  }
+
+  void BoostedGridCoefficients::Apply(const complex<double>* ModeData, complex<double>* Grid) const {
+    // ModeData holds the modes with ell>=|s|, in the order of `Modes`
+    const int n_g = n_theta*n_phi;
+    const int NM = NModes();
+    for(int i_g=0; i_g<n_g; ++i_g) {
+      const complex<double>* Y_g = &Y[i_g*NM];
+      complex<double> d(0.0, 0.0);
+      for(int i_m=0; i_m<NM; ++i_m) {
+        d += ModeData[i_m]*Y_g[i_m];
+      }
+      Grid[i_g] = a[i_g]*d + b[i_g]*std::conj(d);
+    }
+  }
 
-        // if(i_t%5000==0) {
-        //   std::cerr << thetaRotated << "," << phiRotated << "; " << theta << "," << phi
-        //             << "; \t" << Grid[i_g] << "," << Psi_4 << std::endl;
-        // }
+  // Shared by BoostPsi4, BoostHFaked, and the batched versions.  The
+  // sizes of the input velocities must already have been checked.
+  void BoostOnGrid(GWFrames::Waveform& W, const std::vector<std::vector<double> >& v,
+                   const double VelocityTolerance, const bool FakeH)
+  {
+    const int s = W.SpinWeight();
+    const int ellMax = W.EllMax();
+    const int n_thetaRotated = 2*ellMax+1;
+    const int n_phiRotated = 2*ellMax+1;
+    const int NTimes = W.NTimes();
+    const int i_m0 = N_lm(std::abs(s)-1);
+    const int NM = N_lm(ellMax)-i_m0;
+
+    // The rows of W holding each mode with ell>=|s|
+    vector<int> Row(NM);
+    for(int i_m=0, ell=std::abs(s); ell<=ellMax; ++ell) {
+      for(int m=-ell; m<=ell; ++m, ++i_m) {
+        Row[i_m] = W.FindModeIndex(ell,m);
       }
     }
+    const GWFrames::SHTPlan& Plan = GWFrames::SHTPlan::Get(s, ellMax, n_thetaRotated, n_phiRotated);
+
+    // Evaluate one SWSH first.  This initializes the SphericalFunctions
+    // singletons before any threads are started.
+    if(NM>0) {
+      SphericalFunctions::SWSH Y(s);
+      Y.SetRotation(Quaternion(1,0,0,0));
+      Y(std::abs(s),0);
+    }
+
+    // Main loop over time steps.  Each thread keeps the coefficients
+    // for the last velocity it saw, so they are only recomputed when
+    // the velocity changes by more than VelocityTolerance.  The static
+    // schedule hands each thread a contiguous run of times, over which
+    // v is most likely to be (nearly) constant.
+    #pragma omp parallel if(NTimes>1) num_threads(GWFrames::MaxThreads())
+    {
+      BoostedGridCoefficients Coefficients(s, ellMax, FakeH);
+      vector<complex<double> > Modes(NM);
+      vector<complex<double> > Grid(n_thetaRotated*n_phiRotated);
+      vector<complex<double> > Modes2(N_lm(ellMax));
+      #pragma omp for schedule(static)
+      for(int i_t=0; i_t<NTimes; ++i_t) {
+        const vector<double>& v_i = v[i_t];
+        const double beta = std::sqrt(v_i[0]*v_i[0] + v_i[1]*v_i[1] + v_i[2]*v_i[2]);
+        if(beta<1.e-9) { continue; } // TODO: This may need to be adjusted, or other statements made smarter about using the value of gamma
+        if(!Coefficients.Matches(v_i, VelocityTolerance)) {
+          Coefficients.Set(v_i);
+        }
 
-    // Decompose the data into modes
-    spinsfast_map2salm(reinterpret_cast<fftw_complex*>(&Grid[0]),
-                       reinterpret_cast<fftw_complex*>(&Modes2[0]),
-                       SpinWeight(), n_thetaRotated, n_phiRotated, ellMax);
+        // Construct the data on the distorted grid, and decompose it into modes
+        for(int i_m=0; i_m<NM; ++i_m) {
+          Modes[i_m] = W.Data(Row[i_m], i_t);
+        }
+        Coefficients.Apply(&Modes[0], &Grid[0]);
+        Plan.Forward(&Grid[0], &Modes2[0]);
+
+        // Set new data at this time step
+        for(int i_m=0; i_m<NM; ++i_m) {
+          W.SetData(Row[i_m], i_t, Modes2[i_m0+i_m]);
+        }
+      }
+    } // omp parallel
+  }
 
-    // Set new data at this time step
-    for(int i_mode=N_lm(std::abs(SpinWeight())-1), ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
-      for(int m=-ell; m<=ell; ++m, ++i_mode) {
-        this->SetData(this->FindModeIndex(ell,m), i_t, Modes2[i_mode]);
+  void CheckBoostVelocities(const std::vector<std::vector<double> >& v) {
+    for(unsigned int i_t=0; i_t<v.size(); ++i_t) {
+      if(v[i_t].size()!=3) {
+        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": v[" << i_t << "].size()=" << v[i_t].size()
+                  << ".  Input is assumed to be a vector of three-velocities." << std::endl;
+        throw(GWFrames_VectorSizeMismatch);
       }
     }
+  }
+}
+#endif // DOXYGEN
+
+/// Apply a boost to Psi4 data
+GWFrames::Waveform& GWFrames::Waveform::BoostPsi4(const std::vector<std::vector<double> >& v, const double VelocityTolerance) {
+  /// \param v Vector of three-velocities, one for each time step
+  /// \param VelocityTolerance Largest change in velocity for which the boost is not recomputed [default: 0.0]
+  ///
+  /// This function does three things.  First, it evaluates the
+  /// Waveform on what will become an equi-angular grid after
+  /// transformation by the boost.  Second, at each point of that
+  /// grid, it takes the appropriate combinations of the present value
+  /// of Psi_4 and its conjugate to give the value of Psi_4 as
+  /// observed in the boosted frame.  Finally, it transforms back to
+  /// Fourier space using that new equi-angular grid.
+  ///
+  /// The input three-velocities are assumed to give the velocities of
+  /// the boosted frame relative to the present frame.
+  ///
+  /// Everything in the first two steps that depends only on the
+  /// velocity is computed once and reused for subsequent time steps
+  /// with the same velocity.  If VelocityTolerance is positive, it is
+  /// also reused for velocities within that distance of the one for
+  /// which it was computed, which is useful when v changes slowly.
+  /// Time steps are processed in parallel when OpenMP is enabled.
+  GWFrames_INSTRUMENT("Waveform::BoostPsi4");
 
+  // Check the size of the input velocity
+  if(v.size()!=NTimes()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": (v.size()=" << v.size() << ") != (NTimes()=" << NTimes() << ")" << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
   }
+  CheckBoostVelocities(v);
+
+  BoostOnGrid(*this, v, VelocityTolerance, false);
 
   return *this;
 }
 
-
 /// Apply a boost to h data, with nontrivial assumptions
-GWFrames::Waveform& GWFrames::Waveform::BoostHFaked(const std::vector<std::vector<double> >& v) {
+GWFrames::Waveform& GWFrames::Waveform::BoostHFaked(const std::vector<std::vector<double> >& v, const double VelocityTolerance) {
+  /// \param v Vector of three-velocities, one for each time step
+  /// \param VelocityTolerance Largest change in velocity for which the boost is not recomputed [default: 0.0]
+  ///
   /// This function does three things.  First, it evaluates the
   /// Waveform on what will become an equi-angular grid after
   /// transformation by the boost.  Second, at each point of that
@@ -3691,238 +5959,486 @@ GWFrames::Waveform& GWFrames::Waveform::BoostHFaked(const std::vector<std::vecto
   /// at each point.  This, of course, assumes that \f$\ddot{h} =
   /// \Psi_4\f$ in both frames.  That need not be the case, which is
   /// why "Faked" is in the name of this function.
+  ///
+  /// See `BoostPsi4` for the meaning of VelocityTolerance.
+  GWFrames_INSTRUMENT("Waveform::BoostHFaked");
 
   // Check the size of the input velocity
   if(v.size()!=NTimes()) {
     std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": (v.size()=" << v.size() << ") != (NTimes()=" << NTimes() << ")" << std::endl;
     throw(GWFrames_VectorSizeMismatch);
   }
+  CheckBoostVelocities(v);
 
   INFOTOCERR << "\nCAUTION!!!  This function relies on an imperfect formula."
              << "\nIt assumes that the second time derivative of h equals"
              << "\n(plus or minus) Psi_4, which need not be exactly true.\n" << std::endl;
 
-  // Set up storage and calculate useful constants
-  const int ellMax = this->EllMax();
-  const int n_thetaRotated= 2*ellMax+1;
-  const int n_phiRotated = 2*ellMax+1;
-  const double dthetaRotated = M_PI/double(n_thetaRotated-1); // thetaRotated should return to M_PI
-  const double dphiRotated = 2*M_PI/double(n_phiRotated); // phiRotated should not return to 2*M_PI
-  vector<complex<double> > Grid(n_phiRotated*n_thetaRotated);
-  SphericalFunctions::SWSH sYlm(SpinWeight());
-
-  SpacetimeAlgebra::vector tPz;
-  tPz.set_gamma_0(1./std::sqrt(2));
-  tPz.set_gamma_3(1./std::sqrt(2));
-  SpacetimeAlgebra::vector tMz;
-  tMz.set_gamma_0(1./std::sqrt(2));
-  tMz.set_gamma_3(-1./std::sqrt(2));
-  SpacetimeAlgebra::vector xPiyRe;
-  xPiyRe.set_gamma_1(1./std::sqrt(2));
-  SpacetimeAlgebra::vector xPiyIm;
-  xPiyIm.set_gamma_2(1./std::sqrt(2));
-  SpacetimeAlgebra::vector xMiyRe;
-  xMiyRe.set_gamma_1(1./std::sqrt(2));
-  SpacetimeAlgebra::vector xMiyIm;
-  xMiyIm.set_gamma_2(-1./std::sqrt(2));
-
-  // Main loop over time steps
-  for(unsigned int i_t=0; i_t<NTimes(); ++i_t) {
-    const vector<double>& v_i = v[i_t];
-    if(v_i.size()!=3) {
-      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": v[" << i_t << "].size()=" << v_i.size()
-                << ".  Input is assumed to be a vector of three-velocities." << std::endl;
-      throw(GWFrames_VectorSizeMismatch);
-    }
-
-    const double beta = std::sqrt(v_i[0]*v_i[0] + v_i[1]*v_i[1] + v_i[2]*v_i[2]);
-    if(beta<1.e-9) { continue; } // TODO: This may need to be adjusted, or other statements made smarter about using the value of gamma
-    vector<double> vHat(3);
-    vHat[0] = v_i[0]/beta;
-    vHat[1] = v_i[1]/beta;
-    vHat[2] = v_i[2]/beta;
-    const double gamma = 1.0/std::sqrt(1.0-beta*beta);
-    const double sqrtplus = std::sqrt((gamma+1)/2);
-    const double sqrtminus = std::sqrt((gamma-1)/2);
-
-    // Calculate the boost rotor
-    SpacetimeAlgebra::spinor BoostRotor;
-    BoostRotor.set_scalar(sqrtplus);
-    BoostRotor.set_gamma_0_gamma_1(sqrtminus*vHat[0]);
-    BoostRotor.set_gamma_0_gamma_2(sqrtminus*vHat[1]);
-    BoostRotor.set_gamma_0_gamma_3(sqrtminus*vHat[2]);
-
-    vector<complex<double> > Modes(N_lm(ellMax), 0.0);
-    vector<complex<double> > Modes2(N_lm(ellMax), 0.0);
-
-    // Fill the Modes data for this time step
-    for(int i_mode=0; i_mode<N_lm(std::abs(SpinWeight())-1); ++i_mode) {
-      // Explicitly zero the modes with ell<|s|
-      Modes[i_mode] = 0.0;
-    }
-    for(int i_mode=N_lm(std::abs(SpinWeight())-1), ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
-      // Now, fill modes with ell>=|s| in the correct order
-      for(int m=-ell; m<=ell; ++m, ++i_mode) {
-        Modes[i_mode] = this->Data(FindModeIndex(ell,m), i_t);
-      }
-    }
-
-    // Construct the data on the distorted grid
-    for(int i_g=0, i_thetaRotated=0; i_thetaRotated<n_thetaRotated; ++i_thetaRotated) {
-      for(int i_phiRotated=0; i_phiRotated<n_phiRotated; ++i_phiRotated, ++i_g) {
-        const double thetaRotated = dthetaRotated*i_thetaRotated;
-        const double phiRotated = dphiRotated*i_phiRotated;
-
-        // Calculate the rotation rotors
-        SpacetimeAlgebra::spinor Rotor_thetaRotated;
-        Rotor_thetaRotated.set_scalar(std::cos(thetaRotated/2));
-        Rotor_thetaRotated.set_gamma_1_gamma_3(std::sin(thetaRotated/2));
-        SpacetimeAlgebra::spinor Rotor_phiRotated;
-        Rotor_phiRotated.set_scalar(std::cos(phiRotated/2));
-        Rotor_phiRotated.set_gamma_1_gamma_2(-std::sin(phiRotated/2));
-        const SpacetimeAlgebra::spinor RotationRotorRotated(Rotor_phiRotated * Rotor_thetaRotated);
-
-        // This is the complete transformation rotor for going from
-        // (t,x,y,z) in the present frame to (t,theta,phi,r) in the
-        // boosted frame:
-        const SpacetimeAlgebra::spinor LorentzRotor(BoostRotor * RotationRotorRotated);
-
-        // The following give the important tetrad elements in the boosted frame
-        const int Filler=0; // Useless constant for Gaigen code
-        const SpacetimeAlgebra::vector lRotated(LorentzRotor*tPz*SpacetimeAlgebra::reverse(LorentzRotor), Filler);
-        const SpacetimeAlgebra::vector nRotated(LorentzRotor*tMz*SpacetimeAlgebra::reverse(LorentzRotor), Filler);
-        const SpacetimeAlgebra::vector mBarReRotated(LorentzRotor*xMiyRe*SpacetimeAlgebra::reverse(LorentzRotor), Filler);
-        const SpacetimeAlgebra::vector mBarImRotated(LorentzRotor*xMiyIm*SpacetimeAlgebra::reverse(LorentzRotor), Filler);
-
-        // Figure out the coordinates in the present frame
-        // corresponding to the given coordinates in the boosted frame
-        vector<double> r(3);
-        r[0] = lRotated.get_gamma_1();
-        r[1] = lRotated.get_gamma_2();
-        r[2] = lRotated.get_gamma_3();
-        const double rMag = std::sqrt(r[0]*r[0]+r[1]*r[1]+r[2]*r[2]);
-        const double theta = std::acos(r[2]/rMag);
-        const double phi = std::atan2(r[1],r[0]);
+  BoostOnGrid(*this, v, VelocityTolerance, true);
 
-        if(i_g==0 && i_t==0) {
-          std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ":\n"
-                    << "    Note that the (theta,phi) coordinates produced here are not in the same range\n"
-                    << "    as the (thetaRotated,phiRotated) coordinates because of (1) the range of atan2,\n"
-                    << "    which is in (-pi,pi), rather than (0,2*pi); and (2) at (theta=0), the phi value\n"
-                    << "    comes out as 0, even though phiRotated may not be.\n\n"
-                    << "    Fortunately, I think both these problems are handled automatically by taking the\n"
-                    << "    tetrad components as we do.  Of course, I may be missing something problematic...\n" << std::endl;
-        }
+  return *this;
+}
 
-        // This gives us the rotor to get from the z axis to the
-        // spherical coordinates in the present frame
-        SpacetimeAlgebra::spinor Rotor_theta;
-        Rotor_theta.set_scalar(std::cos(theta/2));
-        Rotor_theta.set_gamma_1_gamma_3(std::sin(theta/2));
-        SpacetimeAlgebra::spinor Rotor_phi;
-        Rotor_phi.set_scalar(std::cos(phi/2));
-        Rotor_phi.set_gamma_1_gamma_2(-std::sin(phi/2));
-        const SpacetimeAlgebra::spinor RotationRotor(Rotor_phi * Rotor_theta);
+/// Return copies of this Psi4 data boosted by each of several constant velocities
+std::vector<GWFrames::Waveform> GWFrames::Waveform::BoostedPsi4(const std::vector<std::vector<double> >& Velocities) const {
+  /// \param Velocities Vector of three-velocities; one output Waveform is returned for each
+  ///
+  /// Each output is the result of `BoostPsi4` with the corresponding
+  /// velocity at every time step.  This is useful for scanning over
+  /// kick velocities, for example.  The boost-dependent quantities are
+  /// computed once per velocity (and thread).
+  CheckBoostVelocities(Velocities);
+  std::vector<Waveform> Boosted(Velocities.size(), *this);
+  for(unsigned int i_v=0; i_v<Velocities.size(); ++i_v) {
+    BoostOnGrid(Boosted[i_v], vector<vector<double> >(NTimes(), Velocities[i_v]), 0.0, false);
+    Boosted[i_v].history << "this->BoostPsi4(" << setprecision(16) << "[" << Velocities[i_v][0] << ", "
+                         << Velocities[i_v][1] << ", " << Velocities[i_v][2] << "]*NTimes());" << std::endl;
+  }
+  return Boosted;
+}
 
-        // The following give the important tetrad elements in the present frame
-        const SpacetimeAlgebra::vector l(RotationRotor*tPz*SpacetimeAlgebra::reverse(RotationRotor), Filler);
-        const SpacetimeAlgebra::vector n(RotationRotor*tMz*SpacetimeAlgebra::reverse(RotationRotor), Filler);
-        const SpacetimeAlgebra::vector mRe(RotationRotor*xPiyRe*SpacetimeAlgebra::reverse(RotationRotor), Filler);
-        const SpacetimeAlgebra::vector mIm(RotationRotor*xPiyIm*SpacetimeAlgebra::reverse(RotationRotor), Filler);
-        const SpacetimeAlgebra::vector mBarRe(RotationRotor*xMiyRe*SpacetimeAlgebra::reverse(RotationRotor), Filler);
-        const SpacetimeAlgebra::vector mBarIm(RotationRotor*xMiyIm*SpacetimeAlgebra::reverse(RotationRotor), Filler);
+/// Return copies of this h data boosted by each of several constant velocities, with nontrivial assumptions
+std::vector<GWFrames::Waveform> GWFrames::Waveform::BoostedHFaked(const std::vector<std::vector<double> >& Velocities) const {
+  /// \param Velocities Vector of three-velocities; one output Waveform is returned for each
+  ///
+  /// Each output is the result of `BoostHFaked` with the
+  /// corresponding velocity at every time step.  See that function
+  /// for the caveats.
+  CheckBoostVelocities(Velocities);
+  INFOTOCERR << "\nCAUTION!!!  This function relies on an imperfect formula."
+             << "\nIt assumes that the second time derivative of h equals"
+             << "\n(plus or minus) Psi_4, which need not be exactly true.\n" << std::endl;
+  std::vector<Waveform> Boosted(Velocities.size(), *this);
+  for(unsigned int i_v=0; i_v<Velocities.size(); ++i_v) {
+    BoostOnGrid(Boosted[i_v], vector<vector<double> >(NTimes(), Velocities[i_v]), 0.0, true);
+    Boosted[i_v].history << "this->BoostHFaked(" << setprecision(16) << "[" << Velocities[i_v][0] << ", "
+                         << Velocities[i_v][1] << ", " << Velocities[i_v][2] << "]*NTimes());" << std::endl;
+  }
+  return Boosted;
+}
 
-        // Get the value of h in this frame at the appropriate point
-        // of this frame
-        const Quaternion Rp(theta, phi);
-        sYlm.SetRotation(Rp);
-        const complex<double> h = sYlm.Evaluate(Modes);
 
-        // Get the components of the other frame's tetrad in the basis
-        // of this tetrad.  In particular, these are *not* the dot
-        // products of the other frame's basis vectors with this
-        // frame's basis vectors.  Instead, we expand, e.g., nRotated
-        // in terms of this frame's (l,n,m,mbar) basis, and just take
-        // the coefficients in that expansion.  [This distinction
-        // matters because, e.g., n.n = 0 but n.l \neq 0.]  Also note
-        // that we will not need any components involving the l vector
-        // in either frame, because that will just give us terms
-        // proportional to Psi3, etc., which are assumed to fall off
-        // more quickly than we care to bother with.
-        const complex<double> i_complex(0.,1.);
-        const complex<double> nRotated_n = -SpacetimeAlgebra::sp(nRotated, l);
-        const complex<double> nRotated_m = SpacetimeAlgebra::sp(nRotated, mBarRe) + i_complex*SpacetimeAlgebra::sp(nRotated, mBarIm);
-        const complex<double> nRotated_mBar = SpacetimeAlgebra::sp(nRotated, mRe) + i_complex*SpacetimeAlgebra::sp(nRotated, mIm);
-        const complex<double> mBarRotated_n =
-          - ( SpacetimeAlgebra::sp(mBarReRotated, l) + i_complex*SpacetimeAlgebra::sp(mBarImRotated, l) );
-        const complex<double> mBarRotated_m =
-          SpacetimeAlgebra::sp(mBarReRotated, mBarRe) + i_complex*SpacetimeAlgebra::sp(mBarReRotated, mBarIm)
-          + i_complex * ( SpacetimeAlgebra::sp(mBarImRotated, mBarRe) + i_complex*SpacetimeAlgebra::sp(mBarImRotated, mBarIm) );
-        const complex<double> mBarRotated_mBar =
-          SpacetimeAlgebra::sp(mBarReRotated, mRe) + i_complex*SpacetimeAlgebra::sp(mBarReRotated, mIm)
-          + i_complex * ( SpacetimeAlgebra::sp(mBarImRotated, mRe) + i_complex*SpacetimeAlgebra::sp(mBarImRotated, mIm) );
 
-        // Evaluate the data for the boosted frame at this point
-        Grid[i_g] =
-          ( (nRotated_n * mBarRotated_mBar * nRotated_n * mBarRotated_mBar
-             - nRotated_mBar * mBarRotated_n * nRotated_n * mBarRotated_mBar
-             - nRotated_n * mBarRotated_mBar * nRotated_mBar * mBarRotated_n
-             + nRotated_mBar * mBarRotated_n * nRotated_mBar * mBarRotated_n) * h
-            + (nRotated_n * mBarRotated_m * nRotated_n * mBarRotated_m
-               - nRotated_m * mBarRotated_n * nRotated_n * mBarRotated_m
-               - nRotated_n * mBarRotated_m * nRotated_m * mBarRotated_n
-               + nRotated_m * mBarRotated_n * nRotated_m * mBarRotated_n) * std::conj(h) ) / (gamma*gamma);
+/// Output Waveform object to data file.
+const GWFrames::Waveform& GWFrames::Waveform::Output(const std::string& FileName, const unsigned int precision) const {
+  ///
+  /// \param FileName Relative path to output file
+  /// \param precision Number of digits in the text output (0 for the fewest digits that read back exactly)
+  ///
+  /// See the more general version of this function for the file formats.
+  return Output(FileName, vector<vector<int> >(0), -1e300, 1e300, precision);
+}
 
-        // if(i_t%5000==0) {
-        //   std::cerr << thetaRotated << "," << phiRotated << "; " << theta << "," << phi
-        //             << "; \t" << Grid[i_g] << "," << h << std::endl;
-        // }
+/// Output some modes of the Waveform object over some time span to data file.
+const GWFrames::Waveform& GWFrames::Waveform::Output(const std::string& FileName, const std::vector<std::vector<int> >& LM,
+                                                     const double t_a, const double t_b, const unsigned int precision) const {
+  ///
+  /// \param FileName Relative path to output file
+  /// \param LM List of [ell,m] modes to output (all modes if this is empty)
+  /// \param t_a Earliest time to output
+  /// \param t_b Latest time to output
+  /// \param precision Number of digits in the text output (0 for the fewest digits that read back exactly)
+  ///
+  /// The format of the output depends on FileName:
+  ///
+  ///   * If FileName contains '.h5', the data are written in NRAR
+  ///     format as an H5 file (or a group in one, as in
+  ///     'File.h5/Group'); see `OutputH5`.
+  ///   * If FileName ends in '.bin', the data are written in the
+  ///     binary format read by the constructor with DataFormat
+  ///     'Binary'; see `ReadBinaryFile`.
+  ///   * Otherwise, a text file is written with one row per time step,
+  ///     giving the time followed by the real and imaginary parts of
+  ///     each mode.
+  ///
+  /// The modes and times are selected directly from this object's
+  /// data, so there is no need to make a slice first.
+  GWFrames_INSTRUMENT("Waveform::Output");
+
+  // Select the modes and times
+  vector<unsigned int> Modes;
+  if(LM.size()==0) {
+    Modes.resize(NModes());
+    for(unsigned int i_m=0; i_m<NModes(); ++i_m) { Modes[i_m] = i_m; }
+  } else {
+    Modes.resize(LM.size());
+    for(unsigned int i=0; i<LM.size(); ++i) {
+      if(LM[i].size()!=2) {
+        INFOTOCERR << ": Each element of LM should be an [ell,m] pair; element " << i << " has size " << LM[i].size() << endl;
+        throw(GWFrames_VectorSizeMismatch);
       }
+      Modes[i] = FindModeIndex(LM[i][0], LM[i][1]);
     }
+  }
+  unsigned int i_t_a = 0, i_t_b = NTimes();
+  if(t_a>-1e300 || t_b<1e300) {
+    i_t_a = Quaternions::hunt(t, t_a);
+    i_t_b = Quaternions::huntRight(t, t_b, i_t_a);
+  }
 
-    // Decompose the data into modes
-    spinsfast_map2salm(reinterpret_cast<fftw_complex*>(&Grid[0]),
-                       reinterpret_cast<fftw_complex*>(&Modes2[0]),
-                       SpinWeight(), n_thetaRotated, n_phiRotated, ellMax);
-
-    // Set new data at this time step
-    for(int i_mode=N_lm(std::abs(SpinWeight())-1), ell=std::abs(SpinWeight()); ell<=ellMax; ++ell) {
-      for(int m=-ell; m<=ell; ++m, ++i_mode) {
-        this->SetData(this->FindModeIndex(ell,m), i_t, Modes2[i_mode]);
-      }
+  // Describe this call in the output history
+  stringstream Command;
+  Command << setprecision(16) << "this->Output(" << FileName;
+  if(LM.size()>0 || t_a>-1e300 || t_b<1e300) {
+    Command << ", LM=[";
+    for(unsigned int i=0; i<LM.size(); ++i) {
+      Command << (i>0 ? "," : "") << "[" << LM[i][0] << "," << LM[i][1] << "]";
     }
-
+    Command << "], " << t_a << ", " << t_b;
   }
+  Command << ", " << precision << ")";
 
+  const string::size_type Length = FileName.size();
+  if(IsH5FileName(FileName)) {
+    OutputH5(FileName, Modes, i_t_a, i_t_b, Command.str());
+  } else if(Length>=4 && FileName.compare(Length-4, 4, ".bin")==0) {
+    OutputBinary(FileName, Modes, i_t_a, i_t_b, Command.str());
+  } else {
+    OutputText(FileName, Modes, i_t_a, i_t_b, precision, Command.str());
+  }
   return *this;
 }
 
+#ifndef DOXYGEN
+namespace {
+  // Accumulate output in a large buffer, and write it in big blocks
+  class BufferedOutputFile {
+  private:
+    std::string fileName;
+    FILE* f;
+    std::vector<char> buffer;
+    size_t n;
+    BufferedOutputFile(const BufferedOutputFile&);
+    BufferedOutputFile& operator=(const BufferedOutputFile&);
+  public:
+    BufferedOutputFile(const std::string& FileName, const size_t BufferSize=size_t(1)<<20)
+      : fileName(FileName), f(std::fopen(FileName.c_str(), "wb")), buffer(BufferSize), n(0)
+    {
+      if(!f) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << FileName << "' for writing" << endl;
+        throw(GWFrames_BadFileName);
+      }
+    }
+    ~BufferedOutputFile() { if(f) { std::fclose(f); } }
+    // Pointer to at least Size free bytes, which must then be passed to Commit
+    char* Reserve(const size_t Size) {
+      if(n+Size>buffer.size()) {
+        Flush();
+        if(Size>buffer.size()) { buffer.resize(Size); }
+      }
+      return &buffer[n];
+    }
+    void Commit(const char* End) { n = End - &buffer[0]; }
+    void Write(const void* Data, const size_t Size) {
+      if(n+Size<=buffer.size()) {
+        std::memcpy(&buffer[n], Data, Size);
+        n += Size;
+      } else {
+        Flush();
+        WriteOrThrow(Data, Size);
+      }
+    }
+    void Write(const std::string& S) { Write(S.data(), S.size()); }
+    void Flush() {
+      WriteOrThrow(&buffer[0], n);
+      n = 0;
+    }
+    void Close() {
+      Flush();
+      const int Status = std::fclose(f);
+      f = 0;
+      if(Status!=0) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Failed to close '" << fileName << "'" << endl;
+        throw(GWFrames_FailedSystemCall);
+      }
+    }
+  private:
+    void WriteOrThrow(const void* Data, const size_t Size) {
+      if(Size>0 && std::fwrite(Data, 1, Size, f)!=Size) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Failed to write to '" << fileName << "'" << endl;
+        throw(GWFrames_FailedSystemCall);
+      }
+    }
+  };
+
+  // Longest output of FormatDouble, with room to spare
+  const size_t MaxFormattedDoubleLength = 32;
+
+  // Write x into p with the given number of significant digits
+  // (exactly as `ostream << setprecision(precision)` would).  If
+  // precision is 0, write the shortest string that reads back as
+  // exactly x: any normal double with a representation of 15 or fewer
+  // digits is recovered from "%.15g", so only the rest need to try 16
+  // and then 17 digits, the last of which always suffices.  (Subnormal
+  // numbers may get more digits than they need.)  Returns the end of
+  // the written characters.
+  inline char* FormatDouble(char* p, const double x, const unsigned int precision) {
+    if(precision>0) {
+      return p + ::snprintf(p, MaxFormattedDoubleLength, "%.*g", int(std::min(precision, 17u)), x);
+    }
+    int Length = ::snprintf(p, MaxFormattedDoubleLength, "%.15g", x);
+    if(std::strtod(p, 0)!=x && x==x) {
+      Length = ::snprintf(p, MaxFormattedDoubleLength, "%.16g", x);
+      if(std::strtod(p, 0)!=x) {
+        Length = ::snprintf(p, MaxFormattedDoubleLength, "%.17g", x);
+      }
+    }
+    return p + Length;
+  }
+}
+#endif // DOXYGEN
 
-
-/// Output Waveform object to data file.
-const GWFrames::Waveform& GWFrames::Waveform::Output(const std::string& FileName, const unsigned int precision) const {
+/// Output Waveform object to a text file
+void GWFrames::Waveform::OutputText(const std::string& FileName, const std::vector<unsigned int>& Modes,
+                                    const unsigned int i_t_a, const unsigned int i_t_b,
+                                    const unsigned int precision, const std::string& Command,
+                                    const unsigned int BytesPerReal) const {
+  ///
+  /// \param FileName Relative path to output file
+  /// \param Modes Indices of the modes to output
+  /// \param i_t_a Index of the first time to output
+  /// \param i_t_b Index one past the last time to output
+  /// \param precision Number of digits (0 for the fewest digits that read back exactly)
+  /// \param Command Description of the call to be appended to the history
+  /// \param BytesPerReal Precision of the mode data (sizeof(float) for CompactWaveform)
+  ///
+  /// Each row is formatted into a large buffer, which is written to
+  /// the file in big blocks.  Every header line starts with '#', so
+  /// that the file can be read back by the constructor with
+  /// DataFormat 'ReIm'.  The precision is recorded in a header line,
+  /// and single-precision mode data are written with at most 9 digits,
+  /// which is enough for every float to read back exactly.
   const std::string Descriptor = DescriptorString();
-  ofstream ofs(FileName.c_str(), ofstream::out);
-  ofs << setprecision(precision) << flush;
-  ofs << history.str() << "this->Output(" << FileName << ", " << precision << ")" << endl;
-  ofs << "# [1] = Time" << endl;
-  for(unsigned int i_m=0; i_m<NModes(); ++i_m) {
-    ofs << "# [" << 2*i_m+2 << "] = Re{" << Descriptor << "(" << lm[i_m][0] << "," << lm[i_m][1] << ")}" << endl;
-    ofs << "# [" << 2*i_m+3 << "] = Im{" << Descriptor << "(" << lm[i_m][0] << "," << lm[i_m][1] << ")}" << endl;
+  const unsigned int DataPrecision = (BytesPerReal==sizeof(float) && (precision==0 || precision>9) ? 9 : precision);
+  BufferedOutputFile File(FileName);
+  {
+    stringstream Header;
+    istringstream HistoryLines(history.str() + Command + "\n");
+    string Line;
+    while(getline(HistoryLines, Line)) {
+      Header << (Line.size()>0 && (Line[0]=='#' || Line[0]=='%') ? "" : "# ") << Line << "\n";
+    }
+    Header << TextBytesPerRealHeader << BytesPerReal << endl;
+    Header << "# [1] = Time" << endl;
+    for(unsigned int i=0; i<Modes.size(); ++i) {
+      const unsigned int i_m = Modes[i];
+      Header << "# [" << 2*i+2 << "] = Re{" << Descriptor << "(" << lm[i_m][0] << "," << lm[i_m][1] << ")}" << endl;
+      Header << "# [" << 2*i+3 << "] = Im{" << Descriptor << "(" << lm[i_m][0] << "," << lm[i_m][1] << ")}" << endl;
+    }
+    File.Write(Header.str());
+  }
+  const size_t MaxRowLength = (2*Modes.size()+1)*MaxFormattedDoubleLength + 1;
+  for(unsigned int i_t=i_t_a; i_t<i_t_b; ++i_t) {
+    char* p = File.Reserve(MaxRowLength);
+    p = FormatDouble(p, t[i_t], precision);
+    for(unsigned int i=0; i<Modes.size(); ++i) {
+      *p++ = ' ';
+      p = FormatDouble(p, data[Modes[i]][i_t].real(), DataPrecision);
+      *p++ = ' ';
+      p = FormatDouble(p, data[Modes[i]][i_t].imag(), DataPrecision);
+    }
+    *p++ = '\n';
+    File.Commit(p);
   }
-  for(unsigned int i_t=0; i_t<NTimes(); ++i_t) {
-    ofs << T(i_t) << " ";
-    for(unsigned int i_m=0; i_m<NModes()-1; ++i_m) {
-      ofs << data[i_m][i_t].real() << " " << data[i_m][i_t].imag() << " ";
+  File.Close();
+  return;
+}
+
+/// Output Waveform object to a binary file
+void GWFrames::Waveform::OutputBinary(const std::string& FileName, const std::vector<unsigned int>& Modes,
+                                      const unsigned int i_t_a, const unsigned int i_t_b,
+                                      const std::string& Command, const std::complex<float>* SinglePrecisionData) const {
+  ///
+  /// \param FileName Relative path to output file
+  /// \param Modes Indices of the modes to output
+  /// \param i_t_a Index of the first time to output
+  /// \param i_t_b Index one past the last time to output
+  /// \param Command Description of the call to be appended to the history
+  /// \param SinglePrecisionData If nonzero, mode data to write in single precision instead of `data` (used by CompactWaveform)
+  ///
+  /// The file can be read with the constructor using DataFormat
+  /// 'Binary'; see `ReadBinaryFile` for the layout.  Each mode is
+  /// written as a single contiguous block straight from this object's
+  /// storage.
+  const unsigned int NTimesOut = i_t_b-i_t_a;
+  const unsigned int NFrameOut = (frame.size()>1 ? NTimesOut : frame.size());
+  const string History = history.str() + Command + "\n";
+
+  BinaryWaveformHeader Header;
+  std::memset(&Header, 0, sizeof(BinaryWaveformHeader));
+  std::memcpy(Header.Magic, BinaryWaveformMagic, sizeof(BinaryWaveformMagic));
+  Header.ByteOrderMark = BinaryWaveformByteOrderMark;
+  Header.FormatVersion = BinaryWaveformFormatVersion;
+  Header.SpinWeight = spinweight;
+  Header.BoostWeight = boostweight;
+  Header.FrameType = frameType;
+  Header.DataType = dataType;
+  Header.RIsScaledOut = int(rIsScaledOut);
+  Header.MIsScaledOut = int(mIsScaledOut);
+  Header.NModes = Modes.size();
+  Header.NTimes = NTimesOut;
+  Header.NFrame = NFrameOut;
+  Header.NHistory = History.size();
+  Header.BytesPerReal = (SinglePrecisionData ? sizeof(float) : sizeof(double));
+  const BinaryWaveformOffsets Offsets(Header);
+
+  BufferedOutputFile File(FileName);
+  File.Write(&Header, sizeof(BinaryWaveformHeader));
+  for(unsigned int i=0; i<Modes.size(); ++i) {
+    const int32_t ellm[2] = { lm[Modes[i]][0], lm[Modes[i]][1] };
+    File.Write(ellm, sizeof(ellm));
+  }
+  File.Write(History);
+  const char Padding[16] = { 0 };
+  File.Write(Padding, Offsets.T-(Offsets.History+Header.NHistory));
+  if(NTimesOut>0) {
+    File.Write(&t[i_t_a], sizeof(double)*NTimesOut);
+  }
+  for(unsigned int i_f=0; i_f<NFrameOut; ++i_f) {
+    const Quaternion& R = frame[frame.size()>1 ? i_t_a+i_f : i_f];
+    const double Components[4] = { R[0], R[1], R[2], R[3] };
+    File.Write(Components, sizeof(Components));
+  }
+  for(unsigned int i=0; i<Modes.size() && NTimesOut>0; ++i) {
+    if(SinglePrecisionData) {
+      File.Write(SinglePrecisionData+std::size_t(Modes[i])*NTimes()+i_t_a, sizeof(std::complex<float>)*NTimesOut);
+    } else {
+      File.Write(data[Modes[i]]+i_t_a, sizeof(std::complex<double>)*NTimesOut);
     }
-    ofs << data[NModes()-1][i_t].real() << " " << data[NModes()-1][i_t].imag() << endl;
   }
-  ofs.close();
-  return *this;
+  File.Close();
+  return;
 }
 
-GWFrames::Waveform GWFrames::Waveform::operator+(const GWFrames::Waveform& B) const {
-  const Waveform& A = *this;
+/// Output Waveform object to an H5 file in NRAR format
+void GWFrames::Waveform::OutputH5(const std::string& FileName, const std::vector<unsigned int>& Modes,
+                                  const unsigned int i_t_a, const unsigned int i_t_b,
+                                  const std::string& Command, const unsigned int BytesPerReal) const {
+  ///
+  /// \param FileName Relative path to H5 file, optionally followed by a group, as in 'File.h5/Group'
+  /// \param Modes Indices of the modes to output
+  /// \param i_t_a Index of the first time to output
+  /// \param i_t_b Index one past the last time to output
+  /// \param Command Description of the call to be appended to the history
+  /// \param BytesPerReal Precision of the mode data (sizeof(float) for CompactWaveform)
+  ///
+  /// This writes the same layout as `OutputToNRAR` (a dataset of shape
+  /// (NTimes,3) with columns [t, Re, Im] for each mode, along with the
+  /// history, frame, and descriptive attributes), so the result can be
+  /// read by `ReadFromNRAR` or the H5 constructor.  The mode datasets
+  /// are chunked, shuffled, and compressed.  They always hold doubles,
+  /// as NRAR readers expect; the precision of the mode data is recorded
+  /// in the 'BytesPerReal' attribute of the group.  If a group is given, it is
+  /// added to the file (which is created if it does not exist);
+  /// otherwise, the file is overwritten.
+#ifdef USE_HDF5
+  string File, GroupName;
+  SplitH5FileName(FileName, File, GroupName);
+  const bool WriteToRoot = (GroupName=="/");
+  const hid_t FileID_ = (WriteToRoot || access(File.c_str(), F_OK)!=0
+                         ? H5Fcreate(File.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)
+                         : H5Fopen(File.c_str(), H5F_ACC_RDWR, H5P_DEFAULT));
+  H5Handle FileID(FileID_, H5Fclose);
+  if(FileID<0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << File << "' for writing" << endl;
+    throw(GWFrames_BadFileName);
+  }
+  hid_t Group_;
+  if(WriteToRoot) {
+    Group_ = H5Gopen2(FileID, "/", H5P_DEFAULT);
+  } else {
+    H5Handle LinkCreation(H5Check(H5Pcreate(H5P_LINK_CREATE), __LINE__, "H5Pcreate"), H5Pclose);
+    H5Check(H5Pset_create_intermediate_group(LinkCreation, 1), __LINE__, "H5Pset_create_intermediate_group");
+    Group_ = H5Gcreate2(FileID, GroupName.c_str(), LinkCreation, H5P_DEFAULT, H5P_DEFAULT);
+  }
+  H5Handle Group(Group_, H5Gclose);
+  if(Group<0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't create group '" << GroupName << "' in '" << File << "'" << endl;
+    throw(GWFrames_BadFileName);
+  }
+
+  // Descriptive information
+  WriteH5StringAttribute(Group, "OutputFormatVersion", "GWFrames_NRAR");
+  WriteH5IntAttribute(Group, "SpinWeight", spinweight);
+  WriteH5IntAttribute(Group, "BoostWeight", boostweight);
+  WriteH5IntAttribute(Group, "FrameType", frameType);
+  WriteH5IntAttribute(Group, "DataType", dataType);
+  WriteH5IntAttribute(Group, "RIsScaledOut", int(rIsScaledOut));
+  WriteH5IntAttribute(Group, "MIsScaledOut", int(mIsScaledOut));
+  WriteH5IntAttribute(Group, "BytesPerReal", int(BytesPerReal));
+  {
+    const string History = history.str() + Command + "\n";
+    H5Handle Type(H5StringType(History), H5Tclose);
+    H5Handle Space(H5Check(H5Screate(H5S_SCALAR), __LINE__, "H5Screate"), H5Sclose);
+    H5Handle DataSet(H5Check(H5Dcreate2(Group, "History.txt", Type, Space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+                             __LINE__, "History.txt"), H5Dclose);
+    H5Check(H5Dwrite(DataSet, Type, H5S_ALL, H5S_ALL, H5P_DEFAULT, History.c_str()), __LINE__, "History.txt");
+  }
+
+  // The frame
+  if(frame.size()>0) {
+    const hsize_t NFrame = (frame.size()>1 ? i_t_b-i_t_a : 1);
+    const hsize_t Dims[2] = { NFrame, 4 };
+    vector<double> R(4*NFrame);
+    for(unsigned int i_f=0; i_f<NFrame; ++i_f) {
+      const Quaternion& R_f = frame[frame.size()>1 ? i_t_a+i_f : 0];
+      R[4*i_f] = R_f[0];
+      R[4*i_f+1] = R_f[1];
+      R[4*i_f+2] = R_f[2];
+      R[4*i_f+3] = R_f[3];
+    }
+    H5Handle Space(H5Check(H5Screate_simple(2, Dims, 0), __LINE__, "H5Screate_simple"), H5Sclose);
+    H5Handle DataSet(H5Check(H5Dcreate2(Group, "Frame", H5T_NATIVE_DOUBLE, Space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+                             __LINE__, "Frame"), H5Dclose);
+    if(NFrame>0) {
+      H5Check(H5Dwrite(DataSet, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &R[0]), __LINE__, "Frame");
+    }
+  }
+
+  // The modes, each as an (NTimes,3) array of [t, Re, Im]
+  const hsize_t N = i_t_b-i_t_a;
+  const hsize_t Dims[2] = { N, 3 };
+  const hsize_t ChunkDims[2] = { std::min(N, hsize_t(8192)), 3 };
+  H5Handle Space(H5Check(H5Screate_simple(2, Dims, 0), __LINE__, "H5Screate_simple"), H5Sclose);
+  H5Handle Creation(H5Check(H5Pcreate(H5P_DATASET_CREATE), __LINE__, "H5Pcreate"), H5Pclose);
+  if(N>0) {
+    H5Check(H5Pset_chunk(Creation, 2, ChunkDims), __LINE__, "H5Pset_chunk");
+    H5Check(H5Pset_shuffle(Creation), __LINE__, "H5Pset_shuffle");
+    H5Check(H5Pset_deflate(Creation, 4), __LINE__, "H5Pset_deflate");
+  }
+  vector<double> Rows(3*N);
+  for(unsigned int i_t=0; i_t<N; ++i_t) {
+    Rows[3*i_t] = t[i_t_a+i_t];
+  }
+  for(unsigned int i=0; i<Modes.size(); ++i) {
+    const unsigned int i_m = Modes[i];
+    for(unsigned int i_t=0; i_t<N; ++i_t) {
+      Rows[3*i_t+1] = data[i_m][i_t_a+i_t].real();
+      Rows[3*i_t+2] = data[i_m][i_t_a+i_t].imag();
+    }
+    stringstream Name;
+    Name << "Y_l" << lm[i_m][0] << "_m" << lm[i_m][1] << ".dat";
+    H5Handle DataSet(H5Check(H5Dcreate2(Group, Name.str().c_str(), H5T_NATIVE_DOUBLE, Space, H5P_DEFAULT, Creation, H5P_DEFAULT),
+                             __LINE__, Name.str()), H5Dclose);
+    if(N>0) {
+      H5Check(H5Dwrite(DataSet, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &Rows[0]), __LINE__, Name.str());
+    }
+    WriteH5IntAttribute(DataSet, "ell", lm[i_m][0]);
+    WriteH5IntAttribute(DataSet, "m", lm[i_m][1]);
+  }
+#else // USE_HDF5
+  cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Writing '" << FileName << "' requires HDF5.\n"
+       << "Recompile with HDF5_HOME set to enable it." << endl;
+  throw(GWFrames_NotYetImplemented);
+#endif // USE_HDF5
+  return;
+}
+
+/// Add B to this Waveform in place
+GWFrames::Waveform& GWFrames::Waveform::operator+=(const GWFrames::Waveform& B) {
+  /// This avoids the copy made by `A+B`.  The modes of B are matched
+  /// to the modes of this object by (ell,m).
+  Waveform& A = *this;
 
   if(A.spinweight != B.spinweight) {
     INFOTOCERR << "\nError: Asking for the sum of two Waveform objects with different spin weights."
@@ -3954,29 +6470,32 @@ GWFrames::Waveform GWFrames::Waveform::operator+(const GWFrames::Waveform& B) co
     throw(GWFrames_MatrixSizeMismatch);
   }
 
-  // This will be the new object holding the multiplied data
-  GWFrames::Waveform C(A);
-
-  // Store both old histories in C's
-  C.history << "*this = *this+B\n"
-            << "#### B.history.str():\n" << B.history.str()
-            << "#### End of old histories from `A+B`" << std::endl;
+  // Store the old history of B in this one
+  history << "*this = *this+B\n"
+          << "#### B.history.str():\n";
+  history.Include(B.history);
+  history << "#### End of old histories from `A+B`" << std::endl;
 
   // Do the work of addition
   const unsigned int ntimes = NTimes();
   const unsigned int nmodes = NModes();
   for(unsigned int i_A=0; i_A<nmodes; ++i_A) {
     const unsigned int i_B = B.FindModeIndex(lm[i_A][0], lm[i_A][1]);
+    complex<double>* a = data[i_A];
+    const complex<double>* b = B.data[i_B];
     for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
-      C.SetData(i_A, i_t, A.Data(i_A,i_t)+B.Data(i_B,i_t));
+      a[i_t] += b[i_t];
     }
   }
 
-  return C;
+  return *this;
 }
 
-GWFrames::Waveform GWFrames::Waveform::operator-(const GWFrames::Waveform& B) const {
-  const Waveform& A = *this;
+/// Subtract B from this Waveform in place
+GWFrames::Waveform& GWFrames::Waveform::operator-=(const GWFrames::Waveform& B) {
+  /// This avoids the copy made by `A-B`.  The modes of B are matched
+  /// to the modes of this object by (ell,m).
+  Waveform& A = *this;
 
   if(A.spinweight != B.spinweight) {
     INFOTOCERR << "\nError: Asking for the difference of two Waveform objects with different spin weights."
@@ -4008,69 +6527,1658 @@ GWFrames::Waveform GWFrames::Waveform::operator-(const GWFrames::Waveform& B) co
     throw(GWFrames_MatrixSizeMismatch);
   }
 
-  // This will be the new object holding the multiplied data
-  GWFrames::Waveform C(A);
-
-  // Store both old histories in C's
-  C.history << "*this = *this-B\n"
-            << "#### B.history.str():\n" << B.history.str()
-            << "#### End of old histories from `A-B`" << std::endl;
+  // Store the old history of B in this one
+  history << "*this = *this-B\n"
+          << "#### B.history.str():\n";
+  history.Include(B.history);
+  history << "#### End of old histories from `A-B`" << std::endl;
 
-  // Do the work of addition
+  // Do the work of subtraction
   const unsigned int ntimes = NTimes();
   const unsigned int nmodes = NModes();
   for(unsigned int i_A=0; i_A<nmodes; ++i_A) {
     const unsigned int i_B = B.FindModeIndex(lm[i_A][0], lm[i_A][1]);
+    complex<double>* a = data[i_A];
+    const complex<double>* b = B.data[i_B];
     for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
-      C.SetData(i_A, i_t, A.Data(i_A,i_t)-B.Data(i_B,i_t));
+      a[i_t] -= b[i_t];
     }
   }
 
-  return C;
+  return *this;
 }
 
-GWFrames::Waveform GWFrames::Waveform::operator*(const double b) const {
-  const Waveform& A = *this;
+/// Multiply this Waveform by a constant in place
+GWFrames::Waveform& GWFrames::Waveform::operator*=(const double b) {
+  // Record the activity
+  history << "*this = (*this) * " << b << std::endl;
+
+  // Do the work of multiplication
+  const unsigned int N = data.nrows()*data.ncols();
+  complex<double>* a = data[0];
+  for(unsigned int i=0; i<N; ++i) {
+    a[i] *= b;
+  }
 
-  // This will be the new object holding the multiplied data
-  GWFrames::Waveform C(A);
+  return *this;
+}
 
+/// Divide this Waveform by a constant in place
+GWFrames::Waveform& GWFrames::Waveform::operator/=(const double b) {
   // Record the activity
-  C.history << "*this = (*this) * " << b << std::endl;
+  history << "*this = (*this) / " << b << std::endl;
 
-  // Do the work of addition
-  const unsigned int ntimes = NTimes();
-  const unsigned int nmodes = NModes();
-  for(unsigned int i_A=0; i_A<nmodes; ++i_A) {
-    for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
-      C.SetData(i_A, i_t, A.Data(i_A,i_t)*b);
-    }
+  // Do the work of division
+  const unsigned int N = data.nrows()*data.ncols();
+  complex<double>* a = data[0];
+  for(unsigned int i=0; i<N; ++i) {
+    a[i] /= b;
   }
 
+  return *this;
+}
+
+GWFrames::Waveform GWFrames::Waveform::operator+(const GWFrames::Waveform& B) const {
+  GWFrames::Waveform C(*this);
+  C += B;
+  return C;
+}
+
+GWFrames::Waveform GWFrames::Waveform::operator-(const GWFrames::Waveform& B) const {
+  GWFrames::Waveform C(*this);
+  C -= B;
+  return C;
+}
+
+GWFrames::Waveform GWFrames::Waveform::operator*(const double b) const {
+  GWFrames::Waveform C(*this);
+  C *= b;
   return C;
 }
 
 GWFrames::Waveform GWFrames::Waveform::operator/(const double b) const {
-  const Waveform& A = *this;
+  GWFrames::Waveform C(*this);
+  C /= b;
+  return C;
+}
 
-  // This will be the new object holding the multiplied data
-  GWFrames::Waveform C(A);
+// The pointwise templates need SHTPlan from Scri.hpp, and are only
+// instantiated here
+#include "Waveforms_BinaryOp.ipp"
 
-  // Record the activity
-  C.history << "*this = (*this) / " << b << std::endl;
+GWFrames::Waveform GWFrames::Waveform::operator*(const GWFrames::Waveform& B) const { return BinaryOp<std::multiplies<std::complex<double> > >(B); }
+GWFrames::Waveform GWFrames::Waveform::operator/(const GWFrames::Waveform& B) const { return BinaryOp<std::divides<std::complex<double> > >(B); }
 
-  // Do the work of addition
-  const unsigned int ntimes = NTimes();
-  const unsigned int nmodes = NModes();
-  for(unsigned int i_A=0; i_A<nmodes; ++i_A) {
-    for(unsigned int i_t=0; i_t<ntimes; ++i_t) {
-      C.SetData(i_A, i_t, A.Data(i_A,i_t)/b);
+/// Pointwise products of this Waveform with each of several others, sharing its grid
+std::vector<GWFrames::Waveform> GWFrames::Waveform::Products(const std::vector<GWFrames::Waveform>& B, const std::vector<bool>& ConjugateB) const {
+  ///
+  /// \param B Second factor of each product
+  /// \param ConjugateB If ConjugateB[k] is true, the kth product is with the complex conjugate of B[k] [optional]
+  ///
+  /// Each result is the same as `(*this)*B[k]` (or the product with
+  /// conj(B[k])), but this object is transformed to the grid only once
+  /// per time step for all of them.  For example, with B=[h, hdot] and
+  /// ConjugateB=[true, false], this returns h*conj(h) and h*hdot.  If
+  /// an element of B is this object itself (not just a copy of it),
+  /// its grid is also reused.
+  GWFrames_INSTRUMENT("Waveform::Products");
+  std::vector<const Waveform*> Bs(B.size());
+  for(unsigned int k=0; k<B.size(); ++k) {
+    Bs[k] = &B[k];
+  }
+  return BinaryOps<std::multiplies<std::complex<double> > >(Bs, ConjugateB);
+}
+
+
+/// Empty constructor
+GWFrames::CompactWaveform::CompactWaveform()
+  : meta(), data()
+{ }
+
+/// Round the mode data of a Waveform to single precision
+GWFrames::CompactWaveform::CompactWaveform(const GWFrames::Waveform& W)
+  : meta(), data(std::size_t(W.NModes())*W.NTimes())
+{
+  ///
+  /// \param W Waveform to copy
+  ///
+  /// Everything except the mode data is copied exactly.
+  meta.spinweight = W.spinweight;
+  meta.boostweight = W.boostweight;
+  meta.history = W.history;
+  meta.versionHist = W.versionHist;
+  meta.t = W.t;
+  meta.frame = W.frame;
+  meta.frameType = W.frameType;
+  meta.dataType = W.dataType;
+  meta.rIsScaledOut = W.rIsScaledOut;
+  meta.mIsScaledOut = W.mIsScaledOut;
+  meta.lm = W.lm;
+  meta.modeLayout = W.modeLayout;
+  if(data.size()>0) {
+    const std::complex<double>* In = W.data[0];
+    for(std::size_t i=0; i<data.size(); ++i) {
+      data[i] = std::complex<float>(In[i]);
+    }
+  }
+  meta.history << "CompactWaveform(this);" << std::endl;
+}
+
+/// Read a binary Waveform file, keeping the mode data in single precision
+GWFrames::CompactWaveform::CompactWaveform(const std::string& FileName)
+  : meta(), data()
+{
+  ///
+  /// \param FileName Relative path to a file written by `Output`
+  ///
+  /// Files written by `Waveform::Output` (with double-precision data)
+  /// may also be read.  Binary files (with names ending in '.bin') are
+  /// rounded as they are read, so the full-precision data are never
+  /// held in memory; H5 and text files (in 'ReIm' format) are read as
+  /// a Waveform first.
+  const string::size_type Length = FileName.size();
+  if(Length>=4 && FileName.compare(Length-4, 4, ".bin")==0) {
+    meta.history << "CompactWaveform(" << FileName << ");" << std::endl;
+    meta.ReadBinaryFile(FileName, &data);
+    return;
+  }
+  CompactWaveform C(GWFrames::Waveform(FileName, (IsH5FileName(FileName) ? "H5" : "ReIm")));
+  swap(C);
+}
+
+/// Return a Waveform with the data converted to double precision
+GWFrames::Waveform GWFrames::CompactWaveform::Expand() const {
+  GWFrames::Waveform W(meta);
+  W.data.resize(NModes(), NTimes());
+  if(data.size()>0) {
+    std::complex<double>* Out = W.data[0];
+    for(std::size_t i=0; i<data.size(); ++i) {
+      Out[i] = std::complex<double>(data[i]);
+    }
+  }
+  W.history << "this->Expand();" << std::endl;
+  return W;
+}
+
+/// Efficiently swap data between two CompactWaveform objects
+void GWFrames::CompactWaveform::swap(GWFrames::CompactWaveform& b) {
+  meta.swap(b.meta);
+  data.swap(b.data);
+}
+
+/// Find index of mode with given (l,m) data.
+unsigned int GWFrames::CompactWaveform::FindModeIndex(const int l, const int m) const {
+  const int i = meta.modeLayout.Index(l, m);
+  if(i<0) {
+    INFOTOCERR << " Can't find (ell,m)=(" << l << ", " << m << ")" << endl;
+    throw(GWFrames_WaveformMissingLMIndex);
+  }
+  return i;
+}
+
+/// Return the norm (sum of squares of modes) of the waveform
+std::vector<double> GWFrames::CompactWaveform::Norm(const bool TakeSquareRoot) const {
+  ///
+  /// \param TakeSquareRoot If true, the square root is taken at each instant before returning
+  ///
+  /// The sum is accumulated in double precision; see `Waveform::Norm`.
+  return NormOfModes(*this, TakeSquareRoot);
+}
+
+/// Calculate the \f$<LL>\f$ quantity defined in the paper.
+vector<Matrix> GWFrames::CompactWaveform::LLMatrix(vector<int> Lmodes) const {
+  ///
+  /// \param Lmodes L modes to evaluate
+  ///
+  /// The sums are accumulated in double precision; see
+  /// `Waveform::LLMatrix`.
+  GWFrames_INSTRUMENT("CompactWaveform::LLMatrix");
+  return LLMatrixOfModes(*this, Lmodes);
+}
+
+/// Output the data to file
+const GWFrames::CompactWaveform& GWFrames::CompactWaveform::Output(const std::string& FileName) const {
+  ///
+  /// \param FileName Relative path to output file
+  ///
+  /// The format is chosen from FileName just as in `Waveform::Output`,
+  /// and each format records that the mode data are in single
+  /// precision, so that either `CompactWaveform` or `Waveform` can
+  /// read it back.  Binary files hold the data as floats, written
+  /// straight from this object's storage.  H5 and text files are
+  /// written from the data expanded to double precision (H5 files hold
+  /// doubles, and text files use 9 digits for the mode data).
+  GWFrames_INSTRUMENT("CompactWaveform::Output");
+  vector<unsigned int> Modes(NModes());
+  for(unsigned int i_m=0; i_m<NModes(); ++i_m) { Modes[i_m] = i_m; }
+  const std::string Command = "this->Output(" + FileName + ")";
+  const string::size_type Length = FileName.size();
+  if(Length>=4 && FileName.compare(Length-4, 4, ".bin")==0) {
+    meta.OutputBinary(FileName, Modes, 0, NTimes(), Command, (data.size()>0 ? &data[0] : 0));
+  } else if(IsH5FileName(FileName)) {
+    Expand().OutputH5(FileName, Modes, 0, NTimes(), Command, sizeof(float));
+  } else {
+    Expand().OutputText(FileName, Modes, 0, NTimes(), 0, Command, sizeof(float));
+  }
+  return *this;
+}
+
+
+#ifndef DOXYGEN
+namespace {
+  // Write blocks of a file at given byte offsets, in any order
+  class PositionedOutputFile {
+  private:
+    std::string fileName;
+    int fd;
+    PositionedOutputFile(const PositionedOutputFile&);
+    PositionedOutputFile& operator=(const PositionedOutputFile&);
+  public:
+    PositionedOutputFile(const std::string& FileName)
+      : fileName(FileName), fd(open(FileName.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644))
+    {
+      if(fd<0) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Couldn't open '" << FileName << "' for writing" << endl;
+        throw(GWFrames_BadFileName);
+      }
+    }
+    ~PositionedOutputFile() { if(fd>=0) { close(fd); } }
+    void Write(const void* Data, const size_t Size, const uint64_t Offset) {
+      const char* p = static_cast<const char*>(Data);
+      size_t Written = 0;
+      while(Written<Size) {
+        const ssize_t n = pwrite(fd, p+Written, Size-Written, Offset+Written);
+        if(n<=0) {
+          cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Failed to write to '" << fileName << "'" << endl;
+          throw(GWFrames_FailedSystemCall);
+        }
+        Written += n;
+      }
+    }
+    void Close() {
+      const int Status = close(fd);
+      fd = -1;
+      if(Status!=0) {
+        cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Failed to close '" << fileName << "'" << endl;
+        throw(GWFrames_FailedSystemCall);
+      }
+    }
+  };
+}
+#endif // DOXYGEN
+
+/// Prepare to process a Waveform file in windows of time
+GWFrames::WaveformStream::WaveformStream(const std::string& FileName, const unsigned int ChunkSize)
+  : fileName(FileName), isH5(IsH5FileName(FileName)), chunkSize(ChunkSize), t(), steps()
+{
+  ///
+  /// \param FileName Relative path to a binary file (ending in '.bin') or an H5 file (as in 'File.h5/Group')
+  /// \param ChunkSize Number of time steps processed at once
+  ///
+  /// Only the times are read here.
+  if(chunkSize==0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": ChunkSize must be positive" << endl;
+    throw(GWFrames_ValueError);
+  }
+  if(isH5) {
+    t = ReadH5Times(FileName);
+  } else {
+    const BinaryWaveformMap File(FileName);
+    t.resize(File.Header.NTimes);
+    if(t.size()>0) {
+      std::memcpy(&t[0], File.Bytes+File.Offsets.T, sizeof(double)*t.size());
+    }
+  }
+  if(t.size()==0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": '" << FileName << "' contains no times" << endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+}
+
+/// Number of extra time steps read at each end of a chunk
+unsigned int GWFrames::WaveformStream::Halo() const {
+  /// Each derivative uses a five-point stencil, so it needs two more
+  /// time steps at each end of the chunk.
+  unsigned int NDerivatives = 0;
+  for(unsigned int i=0; i<steps.size(); ++i) {
+    if(steps[i].Type==DifferentiateStep) { ++NDerivatives; }
+  }
+  return 2*NDerivatives;
+}
+
+/// Rotate the physical content of each chunk by a constant rotor
+GWFrames::WaveformStream& GWFrames::WaveformStream::RotatePhysicalSystem(const Quaternions::Quaternion& R_phys) {
+  Step S = { RotatePhysicalSystemStep, R_phys };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Rotate the basis in which each chunk is decomposed by a constant rotor
+GWFrames::WaveformStream& GWFrames::WaveformStream::RotateDecompositionBasis(const Quaternions::Quaternion& R_frame) {
+  Step S = { RotateDecompositionBasisStep, R_frame };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Transform each chunk to the inertial frame, using its stored frame
+GWFrames::WaveformStream& GWFrames::WaveformStream::TransformToInertialFrame() {
+  Step S = { TransformToInertialFrameStep, Quaternions::Quaternion() };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Differentiate each chunk with respect to time
+GWFrames::WaveformStream& GWFrames::WaveformStream::Differentiate() {
+  Step S = { DifferentiateStep, Quaternions::Quaternion() };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Read the times [i_t_a,i_t_b) of the file
+GWFrames::Waveform GWFrames::WaveformStream::Read(const unsigned int i_t_a, const unsigned int i_t_b) const {
+  if(isH5) {
+    // The selection of times in the H5 reader is by value, and the
+    // times are strictly increasing, so this gives exactly these
+    // indices
+    return Waveform(fileName, vector<vector<int> >(), t[i_t_a], t[i_t_b-1]);
+  }
+  Waveform W;
+  W.history << "WaveformStream(" << fileName << ", " << chunkSize << "); // Reading times [" << i_t_a << "," << i_t_b << ")" << endl;
+  W.ReadBinaryFile(fileName, 0, i_t_a, i_t_b);
+  return W;
+}
+
+/// Read the times [i_t_a,i_t_b) with the halo, apply the operations, and drop the halo
+GWFrames::Waveform GWFrames::WaveformStream::Chunk(const unsigned int i_t_a, const unsigned int i_t_b) const {
+  GWFrames_INSTRUMENT("WaveformStream::Chunk");
+  const unsigned int H = Halo();
+  const unsigned int i_a = (i_t_a>H ? i_t_a-H : 0);
+  const unsigned int i_b = std::min(NTimes(), i_t_b+H);
+  Waveform W = Read(i_a, i_b);
+  if(W.NTimes()!=i_b-i_a) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Read " << W.NTimes() << " times from '" << fileName
+         << "'; expected " << i_b-i_a << ".  Has the file changed?" << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  for(unsigned int i=0; i<steps.size(); ++i) {
+    switch(steps[i].Type) {
+    case RotatePhysicalSystemStep:
+      W.RotatePhysicalSystem(steps[i].R);
+      break;
+    case RotateDecompositionBasisStep:
+      W.RotateDecompositionBasis(steps[i].R);
+      break;
+    case TransformToInertialFrameStep:
+      W.TransformToInertialFrame();
+      break;
+    case DifferentiateStep:
+      W.Differentiate();
+      break;
+    }
+  }
+  if(i_a==i_t_a && i_b==i_t_b) { return W; }
+  return W.SliceOfTimeIndices(i_t_a-i_a, i_t_b-i_a);
+}
+
+/// Return the norm (sum of squares of modes) of the processed data
+std::vector<double> GWFrames::WaveformStream::Norm(const bool TakeSquareRoot) const {
+  ///
+  /// \param TakeSquareRoot If true, the square root is taken at each instant before returning
+  vector<double> N;
+  N.reserve(NTimes());
+  for(unsigned int i_c=0; i_c<NChunks(); ++i_c) {
+    const unsigned int i_t_a = i_c*chunkSize;
+    const unsigned int i_t_b = std::min(NTimes(), i_t_a+chunkSize);
+    const vector<double> N_c = Chunk(i_t_a, i_t_b).Norm(TakeSquareRoot);
+    N.insert(N.end(), N_c.begin(), N_c.end());
+  }
+  return N;
+}
+
+/// Evaluate the processed data at a point on the sphere
+std::vector<std::complex<double> > GWFrames::WaveformStream::EvaluateAtPoint(const double vartheta, const double varphi) const {
+  ///
+  /// \param vartheta Polar angle of the point
+  /// \param varphi Azimuthal angle of the point
+  vector<complex<double> > F;
+  F.reserve(NTimes());
+  for(unsigned int i_c=0; i_c<NChunks(); ++i_c) {
+    const unsigned int i_t_a = i_c*chunkSize;
+    const unsigned int i_t_b = std::min(NTimes(), i_t_a+chunkSize);
+    const vector<complex<double> > F_c = Chunk(i_t_a, i_t_b).EvaluateAtPoint(vartheta, varphi);
+    F.insert(F.end(), F_c.begin(), F_c.end());
+  }
+  return F;
+}
+
+/// Write the processed data to a binary file, chunk by chunk
+void GWFrames::WaveformStream::Output(const std::string& FileName) const {
+  ///
+  /// \param FileName Relative path to output file, which should end in '.bin'
+  ///
+  /// The file has the same format as `Waveform::Output` writes for
+  /// names ending in '.bin', and can be read by the Waveform
+  /// constructor (or by another WaveformStream).  The header and
+  /// history are taken from the first chunk; each chunk's frame and
+  /// mode data are then written directly into place.
+  GWFrames_INSTRUMENT("WaveformStream::Output");
+  const unsigned int NTimesOut = NTimes();
+  PositionedOutputFile File(FileName);
+  BinaryWaveformHeader Header;
+  std::memset(&Header, 0, sizeof(BinaryWaveformHeader));
+  for(unsigned int i_c=0; i_c<NChunks(); ++i_c) {
+    const unsigned int i_t_a = i_c*chunkSize;
+    const unsigned int i_t_b = std::min(NTimes(), i_t_a+chunkSize);
+    const Waveform W = Chunk(i_t_a, i_t_b);
+    if(i_c==0) {
+      const string History = W.history.str() + "WaveformStream::Output(" + FileName + ");\n";
+      std::memcpy(Header.Magic, BinaryWaveformMagic, sizeof(BinaryWaveformMagic));
+      Header.ByteOrderMark = BinaryWaveformByteOrderMark;
+      Header.FormatVersion = BinaryWaveformFormatVersion;
+      Header.SpinWeight = W.spinweight;
+      Header.BoostWeight = W.boostweight;
+      Header.FrameType = W.frameType;
+      Header.DataType = W.dataType;
+      Header.RIsScaledOut = int(W.rIsScaledOut);
+      Header.MIsScaledOut = int(W.mIsScaledOut);
+      Header.NModes = W.NModes();
+      Header.NTimes = NTimesOut;
+      Header.NFrame = (W.frame.size()>1 ? NTimesOut : W.frame.size());
+      Header.NHistory = History.size();
+      Header.BytesPerReal = sizeof(double);
+      const BinaryWaveformOffsets Offsets(Header);
+      File.Write(&Header, sizeof(BinaryWaveformHeader), 0);
+      for(unsigned int i_m=0; i_m<W.NModes(); ++i_m) {
+        const int32_t ellm[2] = { W.lm[i_m][0], W.lm[i_m][1] };
+        File.Write(ellm, sizeof(ellm), Offsets.LM+sizeof(ellm)*i_m);
+      }
+      File.Write(History.data(), History.size(), Offsets.History);
+      const char Padding[16] = { 0 };
+      File.Write(Padding, Offsets.T-(Offsets.History+Header.NHistory), Offsets.History+Header.NHistory);
+      File.Write(&t[0], sizeof(double)*NTimesOut, Offsets.T);
+    } else if(W.NModes()!=Header.NModes || (Header.NFrame>1 ? W.frame.size()!=W.NTimes() : W.frame.size()!=Header.NFrame)) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Chunk " << i_c << " has " << W.NModes() << " modes and "
+           << W.frame.size() << " frames, which is inconsistent with the first chunk" << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    const BinaryWaveformOffsets Offsets(Header);
+    const unsigned int NChunkTimes = i_t_b-i_t_a;
+    if(Header.NFrame>1 || i_c==0) {
+      const uint64_t i_f_a = (Header.NFrame>1 ? i_t_a : 0);
+      for(unsigned int i_f=0; i_f<W.frame.size(); ++i_f) {
+        const Quaternion& R = W.frame[i_f];
+        const double Components[4] = { R[0], R[1], R[2], R[3] };
+        File.Write(Components, sizeof(Components), Offsets.Frame+sizeof(Components)*(i_f_a+i_f));
+      }
+    }
+    for(unsigned int i_m=0; i_m<W.NModes(); ++i_m) {
+      File.Write(W.data[i_m], sizeof(std::complex<double>)*NChunkTimes,
+                 Offsets.Data+sizeof(std::complex<double>)*(uint64_t(i_m)*NTimesOut+i_t_a));
+    }
+  }
+  File.Close();
+  return;
+}
+
+
+#ifndef DOXYGEN
+namespace {
+  // Read a Waveform in the format given by the file name.  Reading
+  // H5 files is serialized, because the HDF5 library is not generally
+  // thread-safe.
+  GWFrames::Waveform ReadCatalogWaveform(const std::string& FileName) {
+    if(!IsH5FileName(FileName)) {
+      const bool IsBinary = (FileName.size()>=4 && FileName.compare(FileName.size()-4, 4, ".bin")==0);
+      return GWFrames::Waveform(FileName, (IsBinary ? "Binary" : "ReIm"));
+    }
+    GWFrames::Waveform W;
+    int Error = -1;
+    #pragma omp critical(GWFrames_H5IO)
+    {
+      // Exceptions may not leave the critical section
+      try {
+        GWFrames::Waveform H5(FileName, "H5");
+        W.swap(H5);
+      } catch(int e) {
+        Error = e;
+      }
+    }
+    if(Error>=0) { throw(Error); }
+    return W;
+  }
+
+  // Write a Waveform, serializing H5 output as above
+  void OutputCatalogWaveform(const GWFrames::Waveform& W, const std::string& FileName) {
+    if(!IsH5FileName(FileName)) {
+      W.Output(FileName);
+      return;
+    }
+    int Error = -1;
+    #pragma omp critical(GWFrames_H5IO)
+    {
+      try {
+        W.Output(FileName);
+      } catch(int e) {
+        Error = e;
+      }
+    }
+    if(Error>=0) { throw(Error); }
+  }
+
+  // Size of the file holding FileName on disk, or 0 if it can't be found
+  double SizeOnDisk(const std::string& FileName) {
+    const string::size_type i_h5 = H5ExtensionEnd(FileName);
+    const string Path = (i_h5==string::npos ? FileName : FileName.substr(0, i_h5));
+    struct stat Info;
+    if(stat(Path.c_str(), &Info)!=0) { return 0.0; }
+    return double(Info.st_size);
+  }
+
+  // Value of the error code for a simulation that was processed successfully
+  const int CatalogSuccess = -1;
+}
+#endif // DOXYGEN
+
+/// Prepare to process a list of simulations
+GWFrames::CatalogProcessor::CatalogProcessor(const std::vector<std::string>& InputFileNames, const std::vector<std::string>& OutputFileNames)
+  : inputFileNames(InputFileNames), outputFileNames(OutputFileNames), referenceFileNames(), steps(),
+    memoryBudget(0.0), memoryPerByteOnDisk(4.0), errorCodes()
+{
+  ///
+  /// \param InputFileNames Files from which each simulation is read
+  /// \param OutputFileNames Files to which each result is written
+  ///
+  /// Names containing '.h5' are read and written in NRAR format;
+  /// names ending in '.bin' use the binary format; other names are
+  /// text files (read as 'ReIm').  Nothing is read until `Run` is
+  /// called.
+  if(inputFileNames.size()!=outputFileNames.size()) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": InputFileNames.size()=" << inputFileNames.size()
+         << "; OutputFileNames.size()=" << outputFileNames.size() << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+}
+
+/// Set the reference Waveform files used for alignment and hybridization
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::SetReferenceFileNames(const std::vector<std::string>& ReferenceFileNames) {
+  ///
+  /// \param ReferenceFileNames One file for each simulation, in the same order as the inputs
+  if(ReferenceFileNames.size()!=inputFileNames.size()) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": ReferenceFileNames.size()=" << ReferenceFileNames.size()
+         << "; NSimulations()=" << NSimulations() << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  referenceFileNames = ReferenceFileNames;
+  return *this;
+}
+
+/// Limit the estimated memory of the simulations in progress
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::SetMemoryBudget(const double Bytes, const double MemoryPerByteOnDisk) {
+  ///
+  /// \param Bytes Memory available to the simulations in progress (0 for no limit)
+  /// \param MemoryPerByteOnDisk Estimated peak memory of a simulation per byte of its input files
+  ///
+  /// The memory a simulation needs is estimated as
+  /// `MemoryPerByteOnDisk` times the sizes of its input and reference
+  /// files.  The default allows for the input, a transformed copy,
+  /// and the reference.  A simulation whose estimate alone exceeds
+  /// the budget is still processed, but only when nothing else is in
+  /// progress.
+  if(Bytes<0.0 || MemoryPerByteOnDisk<=0.0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Bytes=" << Bytes << "; MemoryPerByteOnDisk=" << MemoryPerByteOnDisk << endl;
+    throw(GWFrames_ValueError);
+  }
+  memoryBudget = Bytes;
+  memoryPerByteOnDisk = MemoryPerByteOnDisk;
+  return *this;
+}
+
+/// Return true if simulation `i` was processed without error by the last `Run`
+bool GWFrames::CatalogProcessor::Succeeded(const unsigned int i) const {
+  return ErrorCode(i)==CatalogSuccess;
+}
+
+/// Return the error code thrown while processing simulation `i` in the last `Run`, or -1 if none
+int GWFrames::CatalogProcessor::ErrorCode(const unsigned int i) const {
+  if(i>=errorCodes.size()) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": i=" << i << "; " << errorCodes.size()
+         << " simulations have been run" << endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  return errorCodes[i];
+}
+
+/// Remove data at times outside [t_a,t_b] of each simulation
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::DropTimesOutside(const double t_a, const double t_b) {
+  Step S = { DropTimesOutsideStep, t_a, t_b, 0.0, 0 };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Transform each simulation to its corotating frame
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::TransformToCorotatingFrame() {
+  Step S = { TransformToCorotatingFrameStep, 0.0, 0.0, 0.0, 0 };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Transform each simulation to its coprecessing frame
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::TransformToCoprecessingFrame() {
+  Step S = { TransformToCoprecessingFrameStep, 0.0, 0.0, 0.0, 0 };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Transform each simulation to the inertial frame
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::TransformToInertialFrame() {
+  Step S = { TransformToInertialFrameStep, 0.0, 0.0, 0.0, 0 };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Align each simulation to its reference Waveform
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::AlignToReference(const double t_1, const double t_2, const unsigned int InitialEvaluations) {
+  ///
+  /// \param t_1 Beginning of alignment interval
+  /// \param t_2 End of alignment interval
+  /// \param InitialEvaluations Number of evaluations for dumb initial optimization
+  ///
+  /// This is `AlignWaveforms(Reference, Simulation, ...)`, so the
+  /// simulation is adjusted in time and attitude, and both are left
+  /// in their corotating frames.
+  Step S = { AlignToReferenceStep, t_1, t_2, 0.0, InitialEvaluations };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Replace each simulation by its hybrid with its reference Waveform
+GWFrames::CatalogProcessor& GWFrames::CatalogProcessor::HybridizeWithReference(const double t_1, const double t_2, const double tMinStep) {
+  ///
+  /// \param t_1 Beginning of time over which to transition
+  /// \param t_2 End of time over which to transition
+  /// \param tMinStep Lower limit on time step appearing in the output
+  ///
+  /// This is `Reference.Hybridize(Simulation, ...)`, so the result
+  /// has the reference data before `t_1` and the simulation data
+  /// after `t_2`.
+  Step S = { HybridizeWithReferenceStep, t_1, t_2, tMinStep, 0 };
+  steps.push_back(S);
+  return *this;
+}
+
+/// Estimated peak memory needed to process simulation `i`
+double GWFrames::CatalogProcessor::EstimatedMemory(const unsigned int i) const {
+  double Bytes = SizeOnDisk(inputFileNames[i]);
+  if(referenceFileNames.size()>0) { Bytes += SizeOnDisk(referenceFileNames[i]); }
+  return memoryPerByteOnDisk*Bytes;
+}
+
+/// Read, transform, and write simulation `i`
+void GWFrames::CatalogProcessor::Process(const unsigned int i) const {
+  GWFrames_INSTRUMENT("CatalogProcessor::Process");
+  Waveform W = ReadCatalogWaveform(inputFileNames[i]);
+  Waveform Reference;
+  bool HaveReference = false;
+  for(unsigned int i_s=0; i_s<steps.size(); ++i_s) {
+    const Step& S = steps[i_s];
+    if((S.Type==AlignToReferenceStep || S.Type==HybridizeWithReferenceStep) && !HaveReference) {
+      Waveform R = ReadCatalogWaveform(referenceFileNames[i]);
+      Reference.swap(R);
+      HaveReference = true;
+    }
+    switch(S.Type) {
+    case DropTimesOutsideStep:
+      W.DropTimesOutside(S.t_1, S.t_2);
+      break;
+    case TransformToCorotatingFrameStep:
+      W.TransformToCorotatingFrame();
+      break;
+    case TransformToCoprecessingFrameStep:
+      W.TransformToCoprecessingFrame();
+      break;
+    case TransformToInertialFrameStep:
+      W.TransformToInertialFrame();
+      break;
+    case AlignToReferenceStep:
+      AlignWaveforms(Reference, W, S.t_1, S.t_2, S.InitialEvaluations);
+      break;
+    case HybridizeWithReferenceStep: {
+      Waveform Hybrid = Reference.Hybridize(W, S.t_1, S.t_2, S.tMinStep);
+      W.swap(Hybrid);
+      break;
+    }
+    }
+  }
+  OutputCatalogWaveform(W, outputFileNames[i]);
+}
+
+/// Process every simulation, returning the number that failed
+unsigned int GWFrames::CatalogProcessor::Run() {
+  ///
+  /// An error in one simulation does not stop the others; a message
+  /// is printed, and the error code is available from `ErrorCode`.
+  ///
+  /// When compiled with OpenMP, each worker processes one simulation
+  /// at a time, and the parallel routines called within it run on
+  /// that worker alone (unless nested parallelism is enabled), so the
+  /// node is kept busy by the simulations rather than by the loops
+  /// within each of them.
+  ///
+  /// With a memory budget, a worker whose next simulation does not
+  /// fit sleeps until another simulation finishes and releases its
+  /// memory.  A simulation whose estimate alone exceeds the budget
+  /// is admitted as soon as nothing else is in progress, and then
+  /// runs alone.
+  GWFrames_INSTRUMENT("CatalogProcessor::Run");
+  for(unsigned int i_s=0; i_s<steps.size(); ++i_s) {
+    if((steps[i_s].Type==AlignToReferenceStep || steps[i_s].Type==HybridizeWithReferenceStep)
+       && referenceFileNames.size()!=inputFileNames.size()) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Step " << i_s << " needs reference Waveforms;"
+           << " call SetReferenceFileNames first" << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+
+  const int N = NSimulations();
+  errorCodes.assign(N, CatalogSuccess);
+  vector<double> Estimates(N, 0.0);
+  if(memoryBudget>0.0) {
+    for(int i=0; i<N; ++i) { Estimates[i] = EstimatedMemory(i); }
+  }
+
+  // Make sure the shared session History exists before the workers
+  // start copying it
+  History::Session();
+
+  double MemoryInProgress = 0.0;
+  int NInProgress = 0;
+  GWFrames::Mutex MemoryMutex;
+  GWFrames::Condition MemoryReleased;
+  #pragma omp parallel for schedule(dynamic,1) if(N>1) num_threads(GWFrames::MaxThreads())
+  for(int i=0; i<N; ++i) {
+    // Wait until there is room for this simulation, or nothing else
+    // is in progress
+    if(memoryBudget>0.0) {
+      const GWFrames::MutexLock Lock(MemoryMutex);
+      while(NInProgress>0 && MemoryInProgress+Estimates[i]>memoryBudget) {
+        MemoryReleased.Wait(MemoryMutex);
+      }
+      MemoryInProgress += Estimates[i];
+      ++NInProgress;
+    }
+
+    // Exceptions may not leave the parallel loop
+    try {
+      Process(i);
+    } catch(int e) {
+      errorCodes[i] = e;
+    } catch(...) {
+      errorCodes[i] = GWFrames_FailedSystemCall;
+    }
+    if(errorCodes[i]!=CatalogSuccess) {
+      #pragma omp critical(GWFrames_CatalogOutput)
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Failed to process '" << inputFileNames[i]
+           << "' (error code " << errorCodes[i] << ")" << endl;
+    }
+
+    if(memoryBudget>0.0) {
+      {
+        const GWFrames::MutexLock Lock(MemoryMutex);
+        MemoryInProgress -= Estimates[i];
+        --NInProgress;
+      }
+      MemoryReleased.NotifyAll();
+    }
+  }
+
+  unsigned int NFailed = 0;
+  for(int i=0; i<N; ++i) {
+    if(errorCodes[i]!=CatalogSuccess) { ++NFailed; }
+  }
+  return NFailed;
+}
+
+
+/// Interpolate finite-radius Waveforms and their radii to a common set of times
+void GWFrames::SetCommonTime(std::vector<Waveform>& Ws, std::vector<std::vector<double> >& Radii,
+                             const double MinTimeStep, const double EarliestTime, const double LatestTime) {
+  ///
+  /// \param Ws Waveforms, which are interpolated in place
+  /// \param Radii Radius of extraction at each time of the corresponding Waveform, interpolated in place
+  /// \param MinTimeStep Lower limit on the step size of the common times
+  /// \param EarliestTime Lower limit on the common times
+  /// \param LatestTime Upper limit on the common times
+  ///
+  /// The common times are the intersection of the times of all the
+  /// Waveforms, as in `GWFrames.Extrapolation.SetCommonTime`.  Each
+  /// Waveform and its radii are interpolated by the same spline plan,
+  /// so the factorization is done once per Waveform.
+  GWFrames_INSTRUMENT("SetCommonTime");
+  const unsigned int NWaveforms = Ws.size();
+  if(Radii.size()!=NWaveforms) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Ws.size()=" << NWaveforms << "; Radii.size()=" << Radii.size() << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  if(NWaveforms==0) { return; }
+  vector<double> TLimits(2);
+  TLimits[0] = EarliestTime;
+  TLimits[1] = LatestTime;
+  vector<double> T = Intersection(TLimits, Ws[0].T(), MinTimeStep, EarliestTime, LatestTime);
+  for(unsigned int i_W=1; i_W<NWaveforms; ++i_W) {
+    T = Intersection(T, Ws[i_W].T());
+  }
+  for(unsigned int i_W=0; i_W<NWaveforms; ++i_W) {
+    if(Radii[i_W].size()!=Ws[i_W].NTimes()) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Radii[" << i_W << "].size()=" << Radii[i_W].size()
+           << "; Ws[" << i_W << "].NTimes()=" << Ws[i_W].NTimes() << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    const SplineInterpolationPlan Plan(Ws[i_W].T(), T);
+    const vector<complex<double> > R(Radii[i_W].begin(), Radii[i_W].end());
+    vector<complex<double> > RNew(T.size()), Work;
+    Plan.Interpolate(&R[0], &RNew[0], Work);
+    for(unsigned int i_t=0; i_t<T.size(); ++i_t) {
+      Radii[i_W][i_t] = RNew[i_t].real();
+    }
+    Radii[i_W].resize(T.size());
+    Ws[i_W].InterpolateInPlace(T);
+  }
+}
+
+/// Return finite-radius Waveforms and their radii, interpolated to a common set of times
+std::pair<std::vector<GWFrames::Waveform>, std::vector<std::vector<double> > >
+GWFrames::WaveformsOnCommonTime(const std::vector<Waveform>& Ws, const std::vector<std::vector<double> >& Radii,
+                                const double MinTimeStep, const double EarliestTime, const double LatestTime) {
+  ///
+  /// \param Ws Waveforms
+  /// \param Radii Radius of extraction at each time of the corresponding Waveform
+  /// \param MinTimeStep Lower limit on the step size of the common times
+  /// \param EarliestTime Lower limit on the common times
+  /// \param LatestTime Upper limit on the common times
+  ///
+  /// This is `SetCommonTime` for callers that can't see changes made
+  /// to their arguments, like python.  The first element of the
+  /// result holds the interpolated Waveforms; the second holds their
+  /// interpolated radii.
+  std::pair<std::vector<Waveform>, std::vector<std::vector<double> > > Interpolated(Ws, Radii);
+  SetCommonTime(Interpolated.first, Interpolated.second, MinTimeStep, EarliestTime, LatestTime);
+  return Interpolated;
+}
+
+
+#ifndef DOXYGEN
+namespace {
+  // Number of time steps for which the extrapolation weights are
+  // computed together, before being applied to every mode
+  const int ExtrapolationBlockSize = 256;
+
+  // Lower limit on the size of each new orthogonal direction in the
+  // fits, below which the radii can't support the fit
+  const double ExtrapolationTolerance = 1.e-12;
+
+  // Find the weights w, such that sum_i w[i]*y[i] is the value at x=0
+  // of the least-squares polynomial of degree N fit to the points
+  // (X[i], y[i]), for each degree N in Orders.  The polynomials are
+  // built up by Arnoldi orthogonalization on the shifted and scaled
+  // abscissas, rather than from the Vandermonde matrix, so that this
+  // is well conditioned even for radii that are large and close
+  // together.  Q and P are workspace.  Returns false if the points
+  // can't support the highest-order fit.
+  bool ExtrapolationWeights(const double* X, const int NPoints, const std::vector<int>& Orders, const int MaxN,
+                            double* Weights, std::vector<double>& Q, std::vector<double>& P) {
+    const int NCoefficients = MaxN+1;
+    Q.resize(NPoints*NCoefficients);
+    P.resize(NCoefficients);
+    double Mean = 0.0;
+    for(int i=0; i<NPoints; ++i) { Mean += X[i]; }
+    Mean /= NPoints;
+    double Scale = 0.0;
+    for(int i=0; i<NPoints; ++i) { Scale = std::max(Scale, std::fabs(X[i]-Mean)); }
+    if(Scale==0.0) { Scale = 1.0; }
+    const double x0 = -Mean/Scale;
+
+    // Column k of Q holds the orthonormal polynomial p_k at the points;
+    // P[k] is p_k(x0)
+    for(int i=0; i<NPoints; ++i) { Q[i] = 1.0/std::sqrt(double(NPoints)); }
+    P[0] = 1.0/std::sqrt(double(NPoints));
+    for(int k=1; k<NCoefficients; ++k) {
+      double* q = &Q[k*NPoints];
+      for(int i=0; i<NPoints; ++i) { q[i] = ((X[i]-Mean)/Scale) * Q[(k-1)*NPoints+i]; }
+      double p = x0*P[k-1];
+      for(int pass=0; pass<2; ++pass) { // Orthogonalize twice for stability
+        for(int j=0; j<k; ++j) {
+          const double* qj = &Q[j*NPoints];
+          double h = 0.0;
+          for(int i=0; i<NPoints; ++i) { h += qj[i]*q[i]; }
+          for(int i=0; i<NPoints; ++i) { q[i] -= h*qj[i]; }
+          p -= h*P[j];
+        }
+      }
+      double Norm = 0.0;
+      for(int i=0; i<NPoints; ++i) { Norm += q[i]*q[i]; }
+      Norm = std::sqrt(Norm);
+      if(Norm<ExtrapolationTolerance) { return false; }
+      for(int i=0; i<NPoints; ++i) { q[i] /= Norm; }
+      P[k] = p/Norm;
+    }
+
+    // The fit of degree N at x0 is sum_k P[k] (q_k . y) for k<=N
+    for(unsigned int i_N=0; i_N<Orders.size(); ++i_N) {
+      double* w = Weights+i_N*NPoints;
+      std::fill(w, w+NPoints, 0.0);
+      for(int k=0; k<=Orders[i_N]; ++k) {
+        const double* q = &Q[k*NPoints];
+        for(int i=0; i<NPoints; ++i) { w[i] += P[k]*q[i]; }
+      }
+    }
+    return true;
+  }
+}
+#endif // DOXYGEN
+
+/// Extrapolate finite-radius Waveforms to infinite radius
+std::vector<GWFrames::Waveform> GWFrames::ExtrapolatedWaveforms(const std::vector<Waveform>& FiniteRadiusWaveforms,
+                                                                const std::vector<std::vector<double> >& Radii,
+                                                                const std::vector<int>& ExtrapolationOrders,
+                                                                const std::vector<double>& Omegas) {
+  ///
+  /// \param FiniteRadiusWaveforms Waveforms extracted at finite radii, all on the same times, outermost last
+  /// \param Radii Radius of extraction of each Waveform at each time
+  /// \param ExtrapolationOrders Polynomial orders in 1/r of the fits; negative N returns the Nth Waveform from the end
+  /// \param Omegas Orbital frequency at each time, to fit in 1/(r*m*Omega) rather than 1/r [optional]
+  ///
+  /// This is the native version of `_Extrapolate` in
+  /// `GWFrames/Extrapolation.py`.  It computes the same least-squares
+  /// fits, but by orthogonalization rather than from the Vandermonde
+  /// matrix, so results agree with that version only to within its
+  /// rounding error, which grows with the order of the fit.  At
+  /// each time, the real and imaginary parts of each mode are fit by
+  /// least squares to a polynomial in 1/r of each requested order,
+  /// and the extrapolated value is the constant term of the fit.
+  /// The fits are linear in the data, so at each time (and value of
+  /// m, when Omegas are given) the weights giving the constant term
+  /// are found once for all orders, and then applied to every mode.
+  /// The Waveforms should have been interpolated to common times
+  /// (see `SetCommonTime`) before calling this function.
+  ///
+  /// When compiled with OpenMP, blocks of times are distributed over
+  /// threads.
+  GWFrames_INSTRUMENT("ExtrapolatedWaveforms");
+
+  const int NFiniteRadii = FiniteRadiusWaveforms.size();
+  const int NExtrapolations = ExtrapolationOrders.size();
+  const bool UseOmegas = (Omegas.size()!=0);
+  if(NExtrapolations==0) { return vector<Waveform>(0); }
+  if(NFiniteRadii==0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": No finite-radius Waveforms to extrapolate" << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  const int MaxN = *std::max_element(ExtrapolationOrders.begin(), ExtrapolationOrders.end());
+  const int MinN = *std::min_element(ExtrapolationOrders.begin(), ExtrapolationOrders.end());
+  const int NTimes = FiniteRadiusWaveforms[0].NTimes();
+  const int NModes = FiniteRadiusWaveforms[0].NModes();
+
+  // Make sure everyone is playing with a full deck
+  if(std::abs(MinN)>NFiniteRadii) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Asking for finite-radius waveform " << MinN << ", but only got "
+         << NFiniteRadii << " finite-radius Waveform objects" << endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  if(MaxN>0 && (MaxN+1)>=NFiniteRadii) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Asking for extrapolation up to order " << MaxN << ", but only got "
+         << NFiniteRadii << " finite-radius Waveform objects; need at least " << MaxN+2 << endl;
+    throw(GWFrames_IndexOutOfBounds);
+  }
+  if(int(Radii.size())!=NFiniteRadii) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": FiniteRadiusWaveforms.size()=" << NFiniteRadii
+         << "; Radii.size()=" << Radii.size() << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  if(UseOmegas && int(Omegas.size())!=NTimes) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": FiniteRadiusWaveforms[0].NTimes()=" << NTimes
+         << "; Omegas.size()=" << Omegas.size() << endl;
+    throw(GWFrames_VectorSizeMismatch);
+  }
+  for(int i_W=0; i_W<NFiniteRadii; ++i_W) {
+    if(int(FiniteRadiusWaveforms[i_W].NTimes())!=NTimes || int(FiniteRadiusWaveforms[i_W].NModes())!=NModes
+       || int(Radii[i_W].size())!=NTimes) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": FiniteRadiusWaveforms[0] has " << NModes << " modes and "
+           << NTimes << " times; FiniteRadiusWaveforms[" << i_W << "] has " << FiniteRadiusWaveforms[i_W].NModes()
+           << " modes and " << FiniteRadiusWaveforms[i_W].NTimes() << " times, with " << Radii[i_W].size() << " radii" << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+
+  // Set up the output data, recording everything but the mode data
+  const Waveform& W_outer = FiniteRadiusWaveforms[NFiniteRadii-1];
+  vector<Waveform> Extrapolated(NExtrapolations);
+  vector<int> FitOrders;
+  vector<int> FitIndices;
+  for(int i_N=0; i_N<NExtrapolations; ++i_N) {
+    const int N = ExtrapolationOrders[i_N];
+    if(N<0) {
+      Extrapolated[i_N] = FiniteRadiusWaveforms[NFiniteRadii+N];
+    } else {
+      Waveform E = W_outer.CopyWithoutData();
+      std::ostringstream Comment;
+      Comment << "### Extrapolating with N=" << N << "\n";
+      E.AppendHistory(Comment.str());
+      E.SetT(W_outer.T());
+      E.SetFrame(W_outer.Frame());
+      E.SetLM(W_outer.LM());
+      E.ResizeData(NModes, NTimes);
+      Extrapolated[i_N].swap(E);
+      FitOrders.push_back(N);
+      FitIndices.push_back(i_N);
+    }
+  }
+  if(MaxN<0) { return Extrapolated; }
+  const int NFits = FitOrders.size();
+
+  // With Omegas, the abscissa depends on m, so the weights are found
+  // once for each distinct value of m
+  vector<int> MValues(1, 0);
+  vector<int> MIndex(NModes, 0);
+  if(UseOmegas) {
+    MValues.clear();
+    for(int i_m=0; i_m<NModes; ++i_m) {
+      const int M = FiniteRadiusWaveforms[0].LM()[i_m][1];
+      const vector<int>::iterator it = std::find(MValues.begin(), MValues.end(), M);
+      MIndex[i_m] = it-MValues.begin();
+      if(it==MValues.end()) { MValues.push_back(M); }
+    }
+  }
+  const int NMValues = MValues.size();
+
+  vector<const complex<double>*> Input(NFiniteRadii);
+  for(int i_W=0; i_W<NFiniteRadii; ++i_W) { Input[i_W] = FiniteRadiusWaveforms[i_W](0); }
+  vector<complex<double>*> Output(NFits);
+  for(int i_F=0; i_F<NFits; ++i_F) { Output[i_F] = Extrapolated[FitIndices[i_F]].DataPointer(); }
+
+  const int NBlocks = (NTimes+ExtrapolationBlockSize-1)/ExtrapolationBlockSize;
+  vector<int> FailedTime(NBlocks, -1);
+  #pragma omp parallel if(NBlocks>1) num_threads(GWFrames::MaxThreads())
+  {
+    vector<double> X(NFiniteRadii), Q, P;
+    vector<double> Weights(ExtrapolationBlockSize*NMValues*NFits*NFiniteRadii);
+    #pragma omp for schedule(static)
+    for(int i_B=0; i_B<NBlocks; ++i_B) {
+      const int i_t_a = i_B*ExtrapolationBlockSize;
+      const int i_t_b = std::min(NTimes, i_t_a+ExtrapolationBlockSize);
+
+      // Find the weights for every time, value of m, and order in this block
+      for(int i_t=i_t_a; i_t<i_t_b && FailedTime[i_B]<0; ++i_t) {
+        for(int i_M=0; i_M<NMValues; ++i_M) {
+          const int M = MValues[i_M];
+          for(int i_W=0; i_W<NFiniteRadii; ++i_W) {
+            X[i_W] = ((UseOmegas && M!=0) ? 1.0/(Radii[i_W][i_t]*M*Omegas[i_t]) : 1.0/Radii[i_W][i_t]);
+          }
+          double* w = &Weights[((i_t-i_t_a)*NMValues+i_M)*NFits*NFiniteRadii];
+          if(!ExtrapolationWeights(&X[0], NFiniteRadii, FitOrders, MaxN, w, Q, P)) {
+            FailedTime[i_B] = i_t;
+            break;
+          }
+        }
+      }
+      if(FailedTime[i_B]>=0) { continue; }
+
+      // Apply them to every mode
+      for(int i_m=0; i_m<NModes; ++i_m) {
+        const int i_M = MIndex[i_m];
+        for(int i_F=0; i_F<NFits; ++i_F) {
+          complex<double>* out = Output[i_F]+i_m*NTimes;
+          for(int i_t=i_t_a; i_t<i_t_b; ++i_t) {
+            const double* w = &Weights[(((i_t-i_t_a)*NMValues+i_M)*NFits+i_F)*NFiniteRadii];
+            complex<double> Sum = 0.0;
+            for(int i_W=0; i_W<NFiniteRadii; ++i_W) {
+              Sum += w[i_W]*Input[i_W][i_m*NTimes+i_t];
+            }
+            out[i_t] = Sum;
+          }
+        }
+      }
+    }
+  }
+  for(int i_B=0; i_B<NBlocks; ++i_B) {
+    if(FailedTime[i_B]>=0) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": The radii at t=" << FiniteRadiusWaveforms[0].T(FailedTime[i_B])
+           << " are too close together for extrapolation with N=" << MaxN << endl;
+      throw(GWFrames_ValueError);
+    }
+  }
+
+  return Extrapolated;
+}
+
+
+#ifndef DOXYGEN
+namespace {
+  // Number of time steps needed by the five-point derivative stencils
+  const unsigned int FrameTrackerMinimumTimes = 5;
+
+  // Cubic through the angular velocity at t[k0..k0+3], evaluated at t_i
+  Quaternion InterpolatedAngularVelocity(const vector<double>& t, const vector<vector<double> >& omega,
+                                         const unsigned int k0, const double t_i) {
+    vector<double> w(3, 0.0);
+    for(unsigned int k=k0; k<k0+4; ++k) {
+      double L = 1.0;
+      for(unsigned int j=k0; j<k0+4; ++j) {
+        if(j!=k) { L *= (t_i-t[j])/(t[k]-t[j]); }
+      }
+      for(unsigned int c=0; c<3; ++c) {
+        w[c] += L*omega[k][c];
+      }
+    }
+    return Quaternion(w);
+  }
+}
+#endif // DOXYGEN
+
+/// Set up to track a frame of an incoming Waveform
+GWFrames::FrameTracker::FrameTracker(const WaveformFrameType FrameType, const std::vector<int>& Lmodes)
+  : frameType(FrameType), lModes(Lmodes), tail(), i_tail(0), ellHat(Quaternions::zHat), t(), omega(), frame(), modes()
+{
+  ///
+  /// \param FrameType Either `Corotating` or `Coprecessing`
+  /// \param Lmodes L modes to evaluate, as in `TransformToCorotatingFrame` (default: all)
+  if(frameType!=GWFrames::Corotating && frameType!=GWFrames::Coprecessing) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": FrameTracker can follow the " << GWFrames::WaveformFrameNames[GWFrames::Corotating]
+         << " or " << GWFrames::WaveformFrameNames[GWFrames::Coprecessing] << " frame, not the "
+         << GWFrames::WaveformFrameNames[frameType] << " frame." << endl;
+    throw(GWFrames_ValueError);
+  }
+}
+
+/// Add later time steps to the tracked Waveform
+GWFrames::FrameTracker& GWFrames::FrameTracker::Append(const Waveform& W) {
+  ///
+  /// \param W Inertial-frame Waveform, with the same modes as before, and times after all previous times
+  ///
+  /// Only the data at the last four time steps already appended are
+  /// kept, along with the new data.  Angular velocities are recomputed
+  /// from two time steps before the previous end, where the
+  /// derivative stencils first reach the new data; rotors and modes
+  /// are recomputed from one step earlier, since each Runge-Kutta
+  /// step uses the angular velocity at the two time steps on either
+  /// side of it.
+  GWFrames_INSTRUMENT_BYTES("FrameTracker::Append", W.NTimes()*W.NModes()*sizeof(std::complex<double>));
+
+  if(W.NTimes()==0) { return *this; }
+  if(W.NFrames()!=0) {
+    INFOTOCERR << "\nError: FrameTracker takes Waveforms in the " << GWFrames::WaveformFrameNames[GWFrames::Inertial] << " frame."
+               << "\n       This Waveform has " << W.NFrames() << " frame rotors.\n" << std::endl;
+    throw(GWFrames_WrongFrameType);
+  }
+  if(NTimes()>0) {
+    if(W.LM()!=tail.LM()) {
+      INFOTOCERR << "\nError: The appended Waveform has different modes from the previous data.\n" << std::endl;
+      throw(GWFrames_BadWaveformInformation);
+    }
+    if(W.T(0)<=t.back()) {
+      INFOTOCERR << "\nError: The appended Waveform starts at t=" << W.T(0) << ", but the previous data end at t=" << t.back() << ".\n" << std::endl;
+      throw(GWFrames_ValueError);
+    }
+  }
+
+  // Join the retained data and the new data into one segment, which
+  // starts at time step i_seg
+  const unsigned int i_seg = i_tail;
+  Waveform Segment;
+  if(NTimes()==0) {
+    Segment = W;
+  } else {
+    const unsigned int NTail = tail.NTimes();
+    const unsigned int NW = W.NTimes();
+    const unsigned int NM = W.NModes();
+    vector<double> T_seg(tail.T());
+    T_seg.insert(T_seg.end(), W.T().begin(), W.T().end());
+    Segment = tail.CopyWithoutData();
+    Segment.SetT(T_seg).SetLM(tail.LM()).ResizeData(NM, NTail+NW);
+    complex<double>* d = Segment.DataPointer();
+    for(unsigned int i_m=0; i_m<NM; ++i_m) {
+      std::copy(tail(i_m), tail(i_m)+NTail, d+i_m*(NTail+NW));
+      std::copy(W(i_m), W(i_m)+NW, d+i_m*(NTail+NW)+NTail);
+    }
+  }
+  t.insert(t.end(), W.T().begin(), W.T().end());
+  const unsigned int N = t.size();
+  const unsigned int NSeg = Segment.NTimes();
+
+  if(N<FrameTrackerMinimumTimes) {
+    tail.swap(Segment);
+    return *this;
+  }
+
+  // The first angular velocity to change is the first one whose
+  // stencil lies entirely inside the segment
+  const unsigned int i_omega = (i_seg==0 ? 0 : i_seg+2);
+  const unsigned int i_R = (i_seg==0 ? 0 : i_omega-1);
+  vector<Quaternion> ellHat_seg;
+  vector<vector<double> > omega_seg;
+  if(frameType==GWFrames::Corotating) {
+    omega_seg = Segment.AngularVelocityVector(lModes);
+  } else {
+    Quaternion RoughInitialEllDirection = ellHat;
+    const unsigned int NPointsForDeriv = 7;
+    if(i_seg==0 && NSeg>NPointsForDeriv) {
+      const WaveformView Start = Segment.ViewOfTimeIndices(0, NPointsForDeriv);
+      RoughInitialEllDirection = Quaternion(Start.AngularVelocityVector(lModes)[NPointsForDeriv/2]); // Using integer division
+    }
+    ellHat_seg = Quaternions::normalized(QuaternionArray(Segment.LLDominantEigenvector(lModes, RoughInitialEllDirection)));
+    // The minimal rotation that keeps the Z axis on ellHat has angular velocity ellHat x d(ellHat)/dt
+    const GWFrames::DerivativePlan Derivative(Segment.T());
+    vector<vector<double> > Components(3, vector<double>(NSeg)), Derivatives(3, vector<double>(NSeg));
+    for(unsigned int i=0; i<NSeg; ++i) {
+      for(unsigned int c=0; c<3; ++c) {
+        Components[c][i] = ellHat_seg[i][c+1];
+      }
+    }
+    for(unsigned int c=0; c<3; ++c) {
+      Derivative.Differentiate(&Components[c][0], &Derivatives[c][0]);
+    }
+    omega_seg.resize(NSeg, vector<double>(3));
+    for(unsigned int i=0; i<NSeg; ++i) {
+      const vector<double>& Z = ellHat_seg[i].vec();
+      omega_seg[i][0] = Z[1]*Derivatives[2][i] - Z[2]*Derivatives[1][i];
+      omega_seg[i][1] = Z[2]*Derivatives[0][i] - Z[0]*Derivatives[2][i];
+      omega_seg[i][2] = Z[0]*Derivatives[1][i] - Z[1]*Derivatives[0][i];
+    }
+  }
+  omega.resize(N);
+  for(unsigned int i=i_omega; i<N; ++i) {
+    omega[i] = omega_seg[i-i_seg];
+  }
+
+  // Integrate dR/dt = omega*R/2 from the last rotor that will not change
+  frame.resize(N);
+  if(i_R==0) {
+    frame[0] = (frameType==GWFrames::Corotating ? Quaternion(1,0,0,0) : Quaternions::sqrtOfRotor(-ellHat_seg[0]*Quaternions::zHat));
+  }
+  for(unsigned int i=std::max(i_R,1u); i<N; ++i) {
+    const unsigned int j = i-1;
+    const unsigned int k0 = std::min(std::max(j,1u)-1, N-4);
+    const double h = t[i]-t[j];
+    const Quaternion Omega_a(omega[j]);
+    const Quaternion Omega_m = InterpolatedAngularVelocity(t, omega, k0, t[j]+h/2.0);
+    const Quaternion Omega_b(omega[i]);
+    const Quaternion& R = frame[j];
+    const Quaternion k1 = 0.5*Omega_a*R;
+    const Quaternion k2 = 0.5*Omega_m*(R+(h/2.0)*k1);
+    const Quaternion k3 = 0.5*Omega_m*(R+(h/2.0)*k2);
+    const Quaternion k4 = 0.5*Omega_b*(R+h*k3);
+    frame[i] = Quaternions::normalized(R + (h/6.0)*(k1+2.0*k2+2.0*k3+k4));
+    if(frameType==GWFrames::Coprecessing) {
+      // Remove the integration error in the direction of the Z axis
+      const Quaternion Z = frame[i]*Quaternions::zHat*frame[i].conjugate();
+      frame[i] = Quaternions::sqrtOfRotor(-ellHat_seg[i-i_seg]*Z) * frame[i];
+    }
+  }
+
+  // Rotate the modes at those time steps
+  Waveform Rotated = Segment.SliceOfTimeIndices(i_R-i_seg, NSeg);
+  Rotated.RotateDecompositionBasis(vector<Quaternion>(frame.begin()+i_R, frame.end()));
+  const unsigned int NM = Rotated.NModes();
+  modes.resize(N*NM);
+  for(unsigned int i_m=0; i_m<NM; ++i_m) {
+    const complex<double>* d = Rotated(i_m);
+    for(unsigned int i=i_R; i<N; ++i) {
+      modes[i*NM+i_m] = d[i-i_R];
+    }
+  }
+
+  // Keep just the data that the next update will need
+  const unsigned int i_tail_new = N-(FrameTrackerMinimumTimes-1);
+  tail = Segment.SliceOfTimeIndices(i_tail_new-i_seg, NSeg);
+  if(frameType==GWFrames::Coprecessing) {
+    ellHat = ellHat_seg[i_tail_new-i_seg];
+  }
+  i_tail = i_tail_new;
+
+  return *this;
+}
+
+/// Return the Waveform in the tracked frame, at every time step so far
+GWFrames::Waveform GWFrames::FrameTracker::Result() const {
+  ///
+  /// The values at time steps from `NFinal()` on are provisional.
+  if(frame.size()==0) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": FrameTracker has " << NTimes() << " time steps; at least "
+         << FrameTrackerMinimumTimes << " are needed." << endl;
+    throw(GWFrames_NotEnoughPointsForDerivative);
+  }
+  const unsigned int NT = NTimes();
+  const unsigned int NM = NModes();
+  Waveform W = tail.CopyWithoutData();
+  W.SetT(t).SetLM(tail.LM()).SetFrame(frame).SetFrameType(frameType).ResizeData(NM, NT);
+  complex<double>* d = W.DataPointer();
+  for(unsigned int i_m=0; i_m<NM; ++i_m) {
+    for(unsigned int i=0; i<NT; ++i) {
+      d[i_m*NT+i] = modes[i*NM+i_m];
+    }
+  }
+  W.AppendHistory("*this = FrameTracker(" + GWFrames::WaveformFrameNames[frameType] + ", " + StringForm(lModes) + ").Result();\n");
+  return W;
+}
+
+
+//////////////////
+// WaveformPair //
+//////////////////
+
+/// Interpolate A and B onto the grid used by `A.Hybridize(B, t1, t2, tMinStep)`
+GWFrames::WaveformPair::WaveformPair(const GWFrames::Waveform& A, const GWFrames::Waveform& B, const double tMinStep)
+  : t(GWFrames::Union(A.T(), B.T(), tMinStep)), i_A0(0), i_A1(0), i_B0(0), i_B1(0), a(), b()
+{
+  ///
+  /// \param A Waveform with the earlier data in any hybrid
+  /// \param B Waveform with the later data in any hybrid
+  /// \param tMinStep Lower limit on time step appearing in the grid
+  GWFrames_INSTRUMENT("WaveformPair::WaveformPair");
+  // Make sure the time stops at the end of B's time, as in Hybridize
+  int i_t=t.size()-1;
+  while(t[i_t]>B.T().back() && i_t>0) { --i_t; }
+  t.erase(t.begin()+i_t, t.end());
+  Initialize(A, B);
+}
+
+/// Interpolate A and B onto the given grid
+GWFrames::WaveformPair::WaveformPair(const GWFrames::Waveform& A, const GWFrames::Waveform& B, const std::vector<double>& T)
+  : t(T), i_A0(0), i_A1(0), i_B0(0), i_B1(0), a(), b()
+{
+  ///
+  /// \param A First Waveform
+  /// \param B Second Waveform
+  /// \param T Strictly increasing times, each within the times of A or B (or both)
+  GWFrames_INSTRUMENT("WaveformPair::WaveformPair");
+  Initialize(A, B);
+}
+
+/// Find the parts of the grid covered by each Waveform, and interpolate them there
+void GWFrames::WaveformPair::Initialize(const GWFrames::Waveform& A, const GWFrames::Waveform& B) {
+  // Check to see if the various type flags agree
+  if(A.spinweight != B.spinweight || A.frameType != B.frameType || A.dataType != B.dataType) {
+    INFOTOCERR << "\nWarning:"
+               << "\n       The first Waveform has spin weight " << A.spinweight << ", data type " << GWFrames::WaveformDataNames[A.dataType]
+               << ", and is in the " << GWFrames::WaveformFrameNames[A.frameType] << " frame."
+               << "\n       The second Waveform has spin weight " << B.spinweight << ", data type " << GWFrames::WaveformDataNames[B.dataType]
+               << ", and is in the " << GWFrames::WaveformFrameNames[B.frameType] << " frame."
+               << "\n       Comparing or hybridizing them probably does not make sense.\n"
+               << std::endl;
+  }
+
+  // Make sure we have the same modes in the input data
+  if(A.NModes() != B.NModes()) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Trying to pair Waveforms with mismatched LM data."
+              << "\nA.NModes()=" << A.NModes() << "\tB.NModes()=" << B.NModes() << std::endl;
+    throw(GWFrames_WaveformMissingLMIndex);
+  }
+  const unsigned int NM = A.NModes();
+  vector<unsigned int> BModes(NM);
+  bool Reordered = false;
+  for(unsigned int i_m=0; i_m<NM; ++i_m) {
+    BModes[i_m] = B.FindModeIndex(A.lm[i_m][0], A.lm[i_m][1]);
+    if(BModes[i_m]!=i_m) { Reordered = true; }
+  }
+
+  // Find the ranges of the grid within each Waveform's times
+  const unsigned int NT = t.size();
+  i_A0 = 0;
+  while(i_A0<NT && t[i_A0]<A.t[0]) { ++i_A0; }
+  i_A1 = i_A0;
+  while(i_A1<NT && t[i_A1]<=A.t.back()) { ++i_A1; }
+  i_B0 = 0;
+  while(i_B0<NT && t[i_B0]<B.t[0]) { ++i_B0; }
+  i_B1 = i_B0;
+  while(i_B1<NT && t[i_B1]<=B.t.back()) { ++i_B1; }
+  if(IndexOverlapBegin()>=IndexOverlapEnd()) {
+    INFOTOCERR << ": These Waveforms do not overlap on the grid."
+               << "\nA.T(0)=" << A.t[0] << "\tB.T(0)=" << B.t[0] << "\tT[0]=" << (NT>0 ? t[0] : 0.0)
+               << "\nA.T(-1)=" << A.t.back() << "\tB.T(-1)=" << B.t.back() << "\tT[-1]=" << (NT>0 ? t.back() : 0.0) << std::endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+  if((i_A0>0 && i_B0>0) || (i_A1<NT && i_B1<NT)) {
+    INFOTOCERR << ": The grid extends beyond both Waveforms."
+               << "\nA.T(0)=" << A.t[0] << "\tB.T(0)=" << B.t[0] << "\tT[0]=" << t[0]
+               << "\nA.T(-1)=" << A.t.back() << "\tB.T(-1)=" << B.t.back() << "\tT[-1]=" << t.back() << std::endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+
+  // Interpolate each Waveform just once
+  a = A.Interpolate(vector<double>(t.begin()+i_A0, t.begin()+i_A1));
+  b = B.Interpolate(vector<double>(t.begin()+i_B0, t.begin()+i_B1));
+  if(Reordered) {
+    const unsigned int NTB = b.NTimes();
+    MatrixC Data(NM, NTB);
+    for(unsigned int i_m=0; i_m<NM; ++i_m) {
+      std::copy(b.data[BModes[i_m]], b.data[BModes[i_m]]+NTB, Data[i_m]);
+    }
+    b.data.swap(Data);
+    b.lm = a.lm;
+    b.modeLayout = a.modeLayout;
+  }
+}
+
+/// Return a Waveform with differences between A and B on their overlap
+GWFrames::Waveform GWFrames::WaveformPair::Compare() const {
+  /// As with `B.Compare(A)`, the data are those of A minus those of
+  /// B, and the frame is the rotation needed to take B's frame into
+  /// A's.
+  GWFrames_INSTRUMENT("WaveformPair::Compare");
+  const unsigned int i_0 = IndexOverlapBegin();
+  const unsigned int i_1 = IndexOverlapEnd();
+  const unsigned int NT = i_1-i_0;
+  const unsigned int NM = NModes();
+  const unsigned int o_a = i_0-i_A0; // Offsets of the overlap in a and b
+  const unsigned int o_b = i_0-i_B0;
+
+  // We'll put all the data in a new Waveform C
+  GWFrames::Waveform C;
+  C.history << "WaveformPair(A, B).Compare()\n"
+            << "#### A.history.str():\n";
+  C.history.Include(a.history);
+  C.history << "#### B.history.str():\n";
+  C.history.Include(b.history);
+  C.history << "#### End of old histories from `Compare`" << std::endl;
+  C.t = vector<double>(t.begin()+i_0, t.begin()+i_1);
+  C.frameType = b.frameType;
+  C.dataType = b.dataType;
+  C.rIsScaledOut = b.rIsScaledOut;
+  C.mIsScaledOut = b.mIsScaledOut;
+  C.lm = a.lm;
+  C.modeLayout = a.modeLayout;
+
+  // The frame is A's times the inverse of B's, when either is given
+  if(a.NFrames()>1 || b.NFrames()>1) {
+    C.frame.resize(NT);
+    for(unsigned int i_t=0; i_t<NT; ++i_t) {
+      const Quaternion R_a = (a.NFrames()>0 ? a.Frame(i_t+o_a) : Quaternions::One);
+      const Quaternion R_b = (b.NFrames()>0 ? b.Frame(i_t+o_b) : Quaternions::One);
+      C.frame[i_t] = R_a * Quaternions::inverse(R_b);
+    }
+  } else if(a.NFrames()==1 || b.NFrames()==1) {
+    const Quaternion R_a = (a.NFrames()>0 ? a.frame[0] : Quaternions::One);
+    const Quaternion R_b = (b.NFrames()>0 ? b.frame[0] : Quaternions::One);
+    C.frame = vector<Quaternion>(1, R_a * Quaternions::inverse(R_b));
+  } // else, leave the frame data empty
+
+  // If the average frame rotor is closer to -1 than to 1, flip the sign
+  if(C.frame.size()==C.NTimes() && C.NTimes()>1) {
+    const Quaternions::Quaternion R_m = Quaternions::ApproximateMeanRotor(C.frame, C.t);
+    if( Quaternions::ChordalDistance(R_m, -Quaternions::One) < Quaternions::ChordalDistance(R_m, Quaternions::One) ) {
+      for(unsigned int i_t=0; i_t<C.NTimes(); ++i_t) {
+        C.frame[i_t] = -C.frame[i_t];
+      }
+    }
+  } else if(C.frame.size()==1) {
+    if( Quaternions::ChordalDistance(C.frame[0], -Quaternions::One) < Quaternions::ChordalDistance(C.frame[0], Quaternions::One) ) {
+      C.frame[0] = -C.frame[0];
+    }
+  }
+
+  // Subtract the data
+  C.data.resize(NM, NT);
+  #pragma omp parallel for schedule(static) if(NM>1) num_threads(GWFrames::MaxThreads())
+  for(int i_m=0; i_m<int(NM); ++i_m) {
+    const complex<double>* A_m = a.data[i_m]+o_a;
+    const complex<double>* B_m = b.data[i_m]+o_b;
+    complex<double>* C_m = C.data[i_m];
+    for(unsigned int i_t=0; i_t<NT; ++i_t) {
+      C_m[i_t] = A_m[i_t] - B_m[i_t];
     }
   }
 
   return C;
 }
 
+/// Return the L^2 norm over modes of A-B at each time of the overlap
+std::vector<double> GWFrames::WaveformPair::DifferenceNorm(const bool TakeSqrt) const {
+  ///
+  /// \param TakeSqrt If false, return the squared norm
+  ///
+  /// This is the same as `Compare().Norm(TakeSqrt)`, without
+  /// constructing the difference Waveform.
+  GWFrames_INSTRUMENT("WaveformPair::DifferenceNorm");
+  const unsigned int i_0 = IndexOverlapBegin();
+  const unsigned int NT = IndexOverlapEnd()-i_0;
+  const unsigned int NM = NModes();
+  const unsigned int o_a = i_0-i_A0;
+  const unsigned int o_b = i_0-i_B0;
+  vector<double> N(NT, 0.0);
+  #pragma omp parallel for schedule(static) if(NT>1) num_threads(GWFrames::MaxThreads())
+  for(int i_t=0; i_t<int(NT); ++i_t) {
+    double n = 0.0;
+    for(unsigned int i_m=0; i_m<NM; ++i_m) {
+      n += std::norm(a.data[i_m][i_t+o_a] - b.data[i_m][i_t+o_b]);
+    }
+    N[i_t] = (TakeSqrt ? std::sqrt(n) : n);
+  }
+  return N;
+}
+
+/// Return the norm of A-B relative to that of A on part of the overlap
+double GWFrames::WaveformPair::RelativeDifference(const double t1, const double t2) const {
+  ///
+  /// \param t1 Earliest time to include
+  /// \param t2 Latest time to include
+  ///
+  /// This is \f$\sqrt{\int |A-B|^2\, dt / \int |A|^2\, dt}\f$, with
+  /// the integrands summed over modes and the integrals taken by the
+  /// trapezoid rule over the times of the overlap between `t1` and
+  /// `t2`.
+  GWFrames_INSTRUMENT("WaveformPair::RelativeDifference");
+  const unsigned int i_0 = IndexOverlapBegin();
+  const unsigned int i_1 = IndexOverlapEnd();
+  const unsigned int NM = NModes();
+  const vector<double> Diff = DifferenceNorm(false);
+  double IntegralDiff = 0.0;
+  double IntegralA = 0.0;
+  double tPrev = 0.0, DiffPrev = 0.0, APrev = 0.0;
+  bool HavePrev = false;
+  for(unsigned int i=i_0; i<i_1; ++i) {
+    if(t[i]<t1 || t[i]>t2) { continue; }
+    double A2 = 0.0;
+    for(unsigned int i_m=0; i_m<NM; ++i_m) {
+      A2 += std::norm(a.data[i_m][i-i_A0]);
+    }
+    if(HavePrev) {
+      IntegralDiff += 0.5*(t[i]-tPrev)*(Diff[i-i_0]+DiffPrev);
+      IntegralA += 0.5*(t[i]-tPrev)*(A2+APrev);
+    }
+    tPrev = t[i];
+    DiffPrev = Diff[i-i_0];
+    APrev = A2;
+    HavePrev = true;
+  }
+  if(IntegralA==0.0) {
+    INFOTOCERR << ": A vanishes on the overlap within [t1=" << t1 << ", t2=" << t2 << "]." << std::endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+  return std::sqrt(IntegralDiff/IntegralA);
+}
 
-GWFrames::Waveform GWFrames::Waveform::operator*(const GWFrames::Waveform& B) const { return BinaryOp<std::multiplies<std::complex<double> > >(B); }
-GWFrames::Waveform GWFrames::Waveform::operator/(const GWFrames::Waveform& B) const { return BinaryOp<std::divides<std::complex<double> > >(B); }
+/// Hybridize A with B, as in `A.Hybridize(B, t1, t2, tMinStep)`
+GWFrames::Waveform GWFrames::WaveformPair::Hybridize(const double t1, const double t2) const {
+  ///
+  /// \param t1 Beginning of time over which to transition
+  /// \param t2 End of time over which to transition
+  ///
+  /// The output has A's data before `t1`, B's data after `t2`, and
+  /// the smooth blend of `Waveform::Hybridize` in between, on the
+  /// whole grid.  This needs the grid to start within A's times and
+  /// end within B's.
+  GWFrames_INSTRUMENT("WaveformPair::Hybridize");
+  const unsigned int NT = NTimes();
+  const unsigned int NM = NModes();
+
+  // Make sure we have sufficient times for the requested hybrid
+  if(t1<a.t[0] || t1<b.t[0] || t2>a.t.back() || t2>b.t.back() || i_A0>0 || i_B1<NT) {
+    INFOTOCERR << ": These Waveforms do not cover the requested hybrid on this grid."
+               << "\nA.T(0)=" << a.t[0] << "\tB.T(0)" << b.t[0] << "\tt1=" << t1
+               << "\nA.T(-1)=" << a.t.back() << "\tB.T(-1)" << b.t.back() << "\tt2=" << t2
+               << "\nT(0)=" << t[0] << "\tT(-1)=" << t.back() << std::endl;
+    throw(GWFrames_EmptyIntersection);
+  }
+
+  // We'll put all the data in a new Waveform C
+  GWFrames::Waveform C;
+  C.spinweight = a.spinweight;
+  C.boostweight = a.boostweight;
+  C.frameType = a.frameType;
+  C.dataType = a.dataType;
+  C.rIsScaledOut = a.rIsScaledOut;
+  C.mIsScaledOut = a.mIsScaledOut;
+  C.history << "WaveformPair(A, B).Hybridize(" << t1 << ", " << t2 << ")\n"
+            << "#### A.history.str():\n";
+  C.history.Include(a.history);
+  C.history << "#### B.history.str():\n";
+  C.history.Include(b.history);
+  C.history << "#### End of old histories from `Hybridize`" << std::endl;
+  C.versionHist = a.versionHist;
+  C.t = t;
+  C.lm = a.lm;
+  C.modeLayout = a.modeLayout;
+
+  // Find the indices of the transition points
+  unsigned int J01=0, J12=NT-1;
+  while(C.T(J01)<t1 && J01<NT) { J01++; }
+  while(C.T(J12)>t2 && J12>0) { J12--; }
+  const double T01 = C.T(J01);
+  const double TransitionLength = C.T(J12)-T01;
+  vector<double> Transition(NT, 0.0);
+  for(unsigned int j=J01; j<J12; ++j) {
+    Transition[j] = TransitionFunction_Smooth((C.T(j)-T01)/TransitionLength);
+  }
+  for(unsigned int j=J12; j<NT; ++j) {
+    Transition[j] = 1.0;
+  }
+
+  // Blend the frames, if there are any
+  if(a.NFrames()>0 || b.NFrames()>0) {
+    C.frame.resize(NT);
+    for(unsigned int j=0; j<NT; ++j) {
+      const Quaternion R_a = (j<J12 ? (a.NFrames()>0 ? a.Frame(j) : Quaternions::One) : Quaternions::One);
+      const Quaternion R_b = (j>=J01 ? (b.NFrames()>0 ? b.Frame(j-i_B0) : Quaternions::One) : Quaternions::One);
+      C.frame[j] = (j<J01 ? R_a : (j>=J12 ? R_b : Quaternions::Slerp(Transition[j], R_a, R_b)));
+    }
+  }
+
+  // Blend the data
+  C.data.resize(NM, NT);
+  #pragma omp parallel for schedule(static) if(NM>1) num_threads(GWFrames::MaxThreads())
+  for(int i_m=0; i_m<int(NM); ++i_m) {
+    const complex<double>* A_m = a.data[i_m];
+    const complex<double>* B_m = b.data[i_m];
+    complex<double>* C_m = C.data[i_m];
+    for(unsigned int j=0; j<J01; ++j) {
+      C_m[j] = A_m[j];
+    }
+    for(unsigned int j=J01; j<J12; ++j) {
+      C_m[j] = A_m[j] * (1.0-Transition[j]) + B_m[j-i_B0] * Transition[j];
+    }
+    for(unsigned int j=J12; j<NT; ++j) {
+      C_m[j] = B_m[j-i_B0];
+    }
+  }
+
+  return C;
+}
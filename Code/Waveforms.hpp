@@ -20,6 +20,7 @@ extern "C" {
 #undef complex
 #endif // DOXYGEN
 #include <cmath>
+#include <climits>
 #include <string>
 #include <sstream>
 
@@ -36,13 +37,61 @@ namespace GWFrames {
   static const std::string WaveformDataNamesLaTeX[8] = { "\\mathrm{unknown data type}", "h", "\\dot{h}", "\\Psi_4", "\\Psi_3", "\\Psi_2", "\\Psi_1", "\\Psi_0" };
   const int WeightError = 1000;
 
+  class WaveformView;
+
+  /// Quality diagnostics of a Waveform, as found together by `Waveform::Diagnostics`
+  ///
+  /// Each member holds what the Waveform member function of the same
+  /// name would return (with default arguments, except as noted
+  /// there).
+  struct WaveformDiagnostics {
+    std::vector<double> Norm;
+    unsigned int MaxNormIndex;
+    std::vector<double> XParityViolationSquared;
+    std::vector<double> YParityViolationSquared;
+    std::vector<double> ZParityViolationSquared;
+    std::vector<double> ParityViolationSquared;
+    std::vector<double> NormalizedAntisymmetry;
+    std::vector<std::vector<double> > DipoleMoment;
+  };
+
+  /// Lookup table from (ell,m) to the index of that mode in a Waveform
+  class ModeLayout {
+  private:
+    unsigned int nModes;
+    int ellMin, ellMax;
+    bool canonical, completeElls;
+    std::vector<int> index;
+  public:
+    ModeLayout();
+    explicit ModeLayout(const std::vector<std::vector<int> >& LM);
+    inline unsigned int NModes() const { return nModes; }
+    inline int EllMin() const { return ellMin; }
+    inline int EllMax() const { return ellMax; }
+    /// True if the modes are stored as (ell,m) with m=-ell..ell for each ell=EllMin()..EllMax() in turn
+    inline bool IsCanonical() const { return canonical; }
+    /// True if every m of every ell from EllMin() to EllMax() is present exactly once
+    inline bool HasCompleteElls() const { return completeElls; }
+    /// Index of the mode (ell,m), or -1 if it is not present
+    inline int Index(const int ell, const int m) const {
+      if(ell<ellMin || ell>ellMax || m<-ell || m>ell) { return -1; }
+      const int i = ell*(ell+1) + m - ellMin*ellMin;
+      return (canonical ? i : index[i]);
+    }
+  };
+
   /// Object storing data and other information for a single waveform
   class Waveform {
 
+    friend class WaveformView;
+    friend class CompactWaveform;
+    friend class WaveformStream;
+    friend class WaveformPair;
+
   protected:  // Member data
     int spinweight;
     int boostweight;
-    std::stringstream history;
+    History history;
     std::vector<std::pair<std::string,std::string> > versionHist;
     std::vector<double> t;
     std::vector<Quaternions::Quaternion> frame;
@@ -51,16 +100,42 @@ namespace GWFrames {
     bool rIsScaledOut;
     bool mIsScaledOut;
     std::vector<std::vector<int> > lm;
+    ModeLayout modeLayout; // Must be updated whenever lm changes
     MatrixC data; // Each row (first index, nn) corresponds to a mode
 
   public:  // Constructors and Destructor
     Waveform();
     Waveform(const Waveform& W);
     Waveform(const std::string& FileName, const std::string& DataFormat);
+    Waveform(const std::string& FileName, const std::vector<std::vector<int> >& LM,
+             const double t_a=-1e300, const double t_b=1e300);
     Waveform(const std::vector<double>& T, const std::vector<std::vector<int> >& LM,
              const std::vector<std::vector<std::complex<double> > >& Data);
     ~Waveform() { }
     Waveform& operator=(const Waveform&);
+    #ifdef GWFrames_MoveSemantics
+    Waveform(Waveform&& W);
+    Waveform& operator=(Waveform&&);
+    #endif
+
+  private: // Private functions for use in the file constructors and Output
+    void ReadBinaryFile(const std::string& FileName, std::vector<std::complex<float> >* SinglePrecisionData=0,
+                        const unsigned int i_t_a=0, unsigned int i_t_b=UINT_MAX);
+    void ReadH5File(const std::string& FileName, const std::vector<std::vector<int> >& LM,
+                    const double t_a=-1e300, const double t_b=1e300);
+    void OutputText(const std::string& FileName, const std::vector<unsigned int>& Modes,
+                    const unsigned int i_t_a, const unsigned int i_t_b,
+                    const unsigned int precision, const std::string& Command,
+                    const unsigned int BytesPerReal=sizeof(double)) const;
+    void OutputBinary(const std::string& FileName, const std::vector<unsigned int>& Modes,
+                      const unsigned int i_t_a, const unsigned int i_t_b, const std::string& Command,
+                      const std::complex<float>* SinglePrecisionData=0) const;
+    void OutputH5(const std::string& FileName, const std::vector<unsigned int>& Modes,
+                  const unsigned int i_t_a, const unsigned int i_t_b, const std::string& Command,
+                  const unsigned int BytesPerReal=sizeof(double)) const;
+
+  protected: // Rebuild modeLayout from lm
+    inline void UpdateModeLayout() { modeLayout = ModeLayout(lm); }
 
   public:  // Copy-ish constructoroids
     Waveform CopyWithoutData() const;
@@ -72,6 +147,10 @@ namespace GWFrames {
     Waveform SliceOfTimesWithoutModes(const double t_a=-1e300, const double t_b=1e300) const;
     Waveform Interpolate(const std::vector<double>& NewTime, const bool AllowTimesOutsideCurrentDomain=false) const;
     Waveform& InterpolateInPlace(const std::vector<double>& NewTime);
+    Waveform Decimate(const double Tolerance=1.e-6, const bool AmplitudePhase=false) const;
+    WaveformView View() const;
+    WaveformView ViewOfTimeIndices(const unsigned int i_t_a, const unsigned int i_t_b) const;
+    WaveformView ViewOfTimes(const double t_a=-1e300, const double t_b=1e300) const;
 
   public: // Data alteration functions -- USE AT YOUR OWN RISK!
     Waveform& DropTimesOutside(const double ta, const double tb);
@@ -81,7 +160,7 @@ namespace GWFrames {
     inline Waveform& SetSpinWeight(const int NewSpinWeight) { spinweight=NewSpinWeight; return *this; }
     inline Waveform& SetBoostWeight(const int NewBoostWeight) { boostweight=NewBoostWeight; return *this; }
     inline Waveform& AppendHistory(const std::string& Hist) { history << Hist; return *this; }
-    inline Waveform& SetHistory(const std::string& Hist) { history.str(Hist); history.seekp(0, std::ios_base::end); return *this; }
+    inline Waveform& SetHistory(const std::string& Hist) { history.str(Hist); return *this; }
     inline Waveform& SetVersionHist(const std::vector<std::pair<std::string,std::string> >& VerHist) { versionHist = VerHist; return *this; }
     inline Waveform& SetT(const std::vector<double>& a) { t = a; return *this; }
     inline Waveform& SetTime(const std::vector<double>& a) { t = a; return *this; }
@@ -90,7 +169,7 @@ namespace GWFrames {
     inline Waveform& SetDataType(const WaveformDataType Type) { dataType = Type; return *this; }
     inline Waveform& SetRIsScaledOut(const bool Scaled) { rIsScaledOut = Scaled; return *this; }
     inline Waveform& SetMIsScaledOut(const bool Scaled) { mIsScaledOut = Scaled; return *this; }
-    inline Waveform& SetLM(const std::vector<std::vector<int> >& a) { lm = a; return *this; }
+    inline Waveform& SetLM(const std::vector<std::vector<int> >& a) { lm = a; UpdateModeLayout(); return *this; }
     inline Waveform& SetData(const std::vector<std::vector<std::complex<double> > >& a) { data = MatrixC(a); return *this; }
     inline Waveform& SetData(const unsigned int i_Mode, const unsigned int i_Time, const std::complex<double>& a) { data[i_Mode][i_Time] = a; return *this; }
     inline Waveform& ResizeData(const unsigned int NModes, const unsigned int NTimes) { data.resize(NModes, NTimes); return *this; }
@@ -102,7 +181,7 @@ namespace GWFrames {
     inline int SpinWeight() const { return spinweight; }
     inline int BoostWeight() const { return boostweight; }
     inline std::string HistoryStr() const { return history.str(); }
-    inline std::stringstream& HistoryStream() { return history; }
+    inline History& HistoryStream() { return history; }
     inline std::vector<std::pair<std::string,std::string> > VersionHist() const { return versionHist; }
     inline int FrameType() const { return frameType; }
     inline int DataType() const { return dataType; }
@@ -128,9 +207,16 @@ namespace GWFrames {
     inline std::vector<double> ArgUnwrapped(const unsigned int Mode) const { return Unwrap(Arg(Mode)); }
     std::vector<std::complex<double> > Data(const unsigned int Mode) const;
     inline const std::complex<double>* operator()(const unsigned int Mode) const { return data[Mode]; }
+    // The mode data are stored contiguously, mode by mode, so that mode i starts at element i*NDataTimes();
+    // NDataTimes() is NTimes() unless the data have been resized independently of the times
+    inline const std::complex<double>* DataPointer() const { return (data.nrows()>0 ? data[0] : 0); }
+    inline std::complex<double>* DataPointer() { return (data.nrows()>0 ? data[0] : 0); }
+    inline unsigned int NDataTimes() const { return data.ncols(); }
     inline const std::vector<double>& T() const { return t; }
     inline const std::vector<Quaternions::Quaternion>& Frame() const { return frame; }
     inline const std::vector<std::vector<int> >& LM() const { return lm; }
+    inline const ModeLayout& Layout() const { return modeLayout; }
+    inline unsigned int NFrames() const { return frame.size(); }
     std::vector<std::vector<double> > Re() const;
     std::vector<std::vector<double> > Im() const;
     std::vector<std::vector<double> > Abs() const;
@@ -170,7 +256,8 @@ namespace GWFrames {
     inline std::complex<double> ConjugateAntipodalEvaluation(const unsigned int i_m, const unsigned int i_mm, const unsigned int i_t) const {
       return this->ParityConjugate(i_m, i_mm, i_t);
     }
-    std::vector<double> InvolutionViolationSquared(WaveformInvolutionFunction Invol, std::vector<int> Lmodes=std::vector<int>(0)) const;
+    enum InvolutionType { XParityInvolutionType, YParityInvolutionType, ZParityInvolutionType, ParityInvolutionType };
+    std::vector<double> InvolutionViolationSquared(const InvolutionType Invol, const std::vector<int>& Lmodes=std::vector<int>(0)) const;
     Waveform Involution(WaveformInvolutionFunction WInvol, QuaternionInvolutionFunction QInvol) const;
     Waveform InvolutionSymmetricPart(WaveformInvolutionFunction Invol, QuaternionInvolutionFunction QInvol) const;
     Waveform InvolutionAntisymmetricPart(WaveformInvolutionFunction Invol, QuaternionInvolutionFunction QInvol) const;
@@ -178,6 +265,8 @@ namespace GWFrames {
     std::vector<double> NormalizedAntisymmetry(std::vector<int> LModesForAsymmetry=std::vector<int>(0)) const;
     std::vector<std::vector<double> > DipoleMoment(int ellMax=0) const;
     std::vector<double> MinimalParityViolation() const;
+    WaveformDiagnostics Diagnostics(const unsigned int SkipFraction=4, const std::vector<int>& LModesForAsymmetry=std::vector<int>(0),
+                                    const int ellMaxForDipole=0) const;
     inline Waveform XParityInvolution() const {
       return Involution(&Waveform::XParityConjugate, &Quaternions::XParityConjugateSpinor);
     }
@@ -188,7 +277,7 @@ namespace GWFrames {
       return InvolutionAntisymmetricPart(&Waveform::XParityConjugate, &Quaternions::XParityConjugateSpinor);
     }
     inline std::vector<double> XParityViolationSquared(std::vector<int> Lmodes=std::vector<int>(0)) const {
-      return InvolutionViolationSquared(&Waveform::XParityConjugate, Lmodes);
+      return InvolutionViolationSquared(XParityInvolutionType, Lmodes);
     }
     inline std::vector<double> XParityViolationNormalized(std::vector<int> Lmodes=std::vector<int>(0)) const {
       return GWFrames::sqrt(XParityViolationSquared(Lmodes) / Norm());
@@ -203,7 +292,7 @@ namespace GWFrames {
       return InvolutionAntisymmetricPart(&Waveform::YParityConjugate, &Quaternions::YParityConjugateSpinor);
     }
     inline std::vector<double> YParityViolationSquared(std::vector<int> Lmodes=std::vector<int>(0)) const {
-      return InvolutionViolationSquared(&Waveform::YParityConjugate, Lmodes);
+      return InvolutionViolationSquared(YParityInvolutionType, Lmodes);
     }
     inline std::vector<double> YParityViolationNormalized(std::vector<int> Lmodes=std::vector<int>(0)) const {
       return GWFrames::sqrt(YParityViolationSquared(Lmodes) / Norm());
@@ -218,7 +307,7 @@ namespace GWFrames {
       return InvolutionAntisymmetricPart(&Waveform::ZParityConjugate, &Quaternions::ZParityConjugateSpinor);
     }
     inline std::vector<double> ZParityViolationSquared(std::vector<int> Lmodes=std::vector<int>(0)) const {
-      return InvolutionViolationSquared(&Waveform::ZParityConjugate, Lmodes);
+      return InvolutionViolationSquared(ZParityInvolutionType, Lmodes);
     }
     inline std::vector<double> ZParityViolationNormalized(std::vector<int> Lmodes=std::vector<int>(0)) const {
       return GWFrames::sqrt(ZParityViolationSquared(Lmodes) / Norm());
@@ -233,7 +322,7 @@ namespace GWFrames {
       return InvolutionAntisymmetricPart(&Waveform::ParityConjugate, &Quaternions::ParityConjugateSpinor);
     }
     inline std::vector<double> ParityViolationSquared(std::vector<int> Lmodes=std::vector<int>(0)) const {
-      return InvolutionViolationSquared(&Waveform::ParityConjugate, Lmodes);
+      return InvolutionViolationSquared(ParityInvolutionType, Lmodes);
     }
     inline std::vector<double> ParityViolationNormalized(std::vector<int> Lmodes=std::vector<int>(0)) const {
       return GWFrames::sqrt(ParityViolationSquared(Lmodes) / Norm());
@@ -287,29 +376,431 @@ namespace GWFrames {
     // Pointwise operations and spin-weight operators
     std::vector<std::complex<double> > EvaluateAtPoint(const double vartheta, const double varphi,
                                                        const unsigned int i_0=0, int i_1=-1) const;
+    std::vector<std::vector<std::complex<double> > > EvaluateAtPoints(const std::vector<std::vector<double> >& ThetaPhi,
+                                                                      const unsigned int i_0=0, int i_1=-1) const;
     std::complex<double> InterpolateToPoint(const double vartheta, const double varphi, const double t_i,
                                             gsl_interp_accel* accRe=0, gsl_interp_accel* accIm=0, gsl_spline* splineRe=0, gsl_spline* splineIm=0) const;
     template <typename Op> Waveform BinaryOp(const Waveform& b) const;
+    template <typename Op> std::vector<Waveform> BinaryOps(const std::vector<const Waveform*>& B, const std::vector<bool>& ConjugateB) const;
+    std::vector<Waveform> Products(const std::vector<Waveform>& B, const std::vector<bool>& ConjugateB=std::vector<bool>(0)) const;
     Waveform operator+(const Waveform& B) const;
     Waveform operator-(const Waveform& B) const;
     Waveform operator*(const Waveform& B) const;
     Waveform operator/(const Waveform& B) const;
     Waveform operator*(const double b) const;
     Waveform operator/(const double b) const;
+    Waveform& operator+=(const Waveform& B);
+    Waveform& operator-=(const Waveform& B);
+    Waveform& operator*=(const double b);
+    Waveform& operator/=(const double b);
 
     Waveform Translate(const std::vector<std::vector<double> >& deltax) const;
-    Waveform& BoostPsi4(const std::vector<std::vector<double> >& v);
-    Waveform& BoostHFaked(const std::vector<std::vector<double> >& v);
+    Waveform& BoostPsi4(const std::vector<std::vector<double> >& v, const double VelocityTolerance=0.0);
+    Waveform& BoostHFaked(const std::vector<std::vector<double> >& v, const double VelocityTolerance=0.0);
+    std::vector<Waveform> BoostedPsi4(const std::vector<std::vector<double> >& Velocities) const;
+    std::vector<Waveform> BoostedHFaked(const std::vector<std::vector<double> >& Velocities) const;
 
     // Output to data file
     const Waveform& Output(const std::string& FileName, const unsigned int precision=14) const;
+    const Waveform& Output(const std::string& FileName, const std::vector<std::vector<int> >& LM,
+                           const double t_a=-1e300, const double t_b=1e300, const unsigned int precision=14) const;
 
   }; // class Waveform
   inline Waveform operator*(const double b, const Waveform& A) { return A*b; }
-  #include "Waveforms_BinaryOp.ipp"
+  #ifdef GWFrames_MoveSemantics
+  // Reuse the storage of temporaries in chained arithmetic like `A*2.0+B`
+  inline Waveform operator+(Waveform&& A, const Waveform& B) { A += B; return std::move(A); }
+  inline Waveform operator-(Waveform&& A, const Waveform& B) { A -= B; return std::move(A); }
+  inline Waveform operator*(Waveform&& A, const double b) { A *= b; return std::move(A); }
+  inline Waveform operator/(Waveform&& A, const double b) { A /= b; return std::move(A); }
+  inline Waveform operator*(const double b, Waveform&& A) { A *= b; return std::move(A); }
+  #endif
 
   void AlignWaveforms(Waveform& A, Waveform& B, const double t_1, const double t_2, unsigned int InitialEvaluations=0,
                       std::vector<double> nHat_A=std::vector<double>(0), const bool Debug=false);
+  std::vector<Waveform> AlignedWaveforms(const Waveform& A, const std::vector<Waveform>& B,
+                                         const std::vector<double>& t_1, const std::vector<double>& t_2,
+                                         unsigned int InitialEvaluations=0, std::vector<double> nHat_A=std::vector<double>(0));
+
+  void SetCommonTime(std::vector<Waveform>& Ws, std::vector<std::vector<double> >& Radii, const double MinTimeStep=0.005,
+                     const double EarliestTime=-3e300, const double LatestTime=3e300);
+  std::pair<std::vector<Waveform>, std::vector<std::vector<double> > >
+  WaveformsOnCommonTime(const std::vector<Waveform>& Ws, const std::vector<std::vector<double> >& Radii,
+                        const double MinTimeStep=0.005, const double EarliestTime=-3e300, const double LatestTime=3e300);
+  std::vector<Waveform> ExtrapolatedWaveforms(const std::vector<Waveform>& FiniteRadiusWaveforms,
+                                              const std::vector<std::vector<double> >& Radii,
+                                              const std::vector<int>& ExtrapolationOrders,
+                                              const std::vector<double>& Omegas=std::vector<double>(0));
+
+
+  /// Read-only view of a range of times and a subset of modes of a Waveform
+  ///
+  /// The view does not copy any data; it just refers to the parent
+  /// Waveform, which must outlive the view and must not be resized
+  /// while the view is in use.  Time and mode indices are relative to
+  /// the view.  The read-only analyses (`Norm`, `LdtVector`,
+  /// `LLMatrix`, `AngularVelocityVector`, `EvaluateAtPoint`,
+  /// `EvaluateAtPoints`) give the same results as they would on the
+  /// equivalent slice, but cost nothing in memory.  Use `Copy` to get
+  /// an independent Waveform.
+  class WaveformView {
+  private:
+    const Waveform* parent;
+    unsigned int i_t_a;
+    unsigned int i_t_b;
+    std::vector<unsigned int> modes; // Index in parent of each mode in the view
+
+  public:  // Constructors
+    WaveformView(const Waveform& W);
+    WaveformView(const Waveform& W, const unsigned int i_t_a, const unsigned int i_t_b);
+    WaveformView(const Waveform& W, const unsigned int i_t_a, const unsigned int i_t_b, const std::vector<unsigned int>& ModeIndices);
+    WaveformView ViewOfTimeIndices(const unsigned int i_t_a, const unsigned int i_t_b) const;
+    WaveformView ViewOfTimes(const double t_a=-1e300, const double t_b=1e300) const;
+    WaveformView ViewOfEllModes(const std::vector<int>& Lmodes) const;
+    Waveform Copy() const;
+
+  public:  // Data access functions
+    inline const Waveform& Parent() const { return *parent; }
+    inline unsigned int ParentTimeIndex(const unsigned int TimeIndex) const { return i_t_a+TimeIndex; }
+    inline unsigned int ParentModeIndex(const unsigned int Mode) const { return modes[Mode]; }
+    inline unsigned int NTimes() const { return i_t_b-i_t_a; }
+    inline unsigned int NModes() const { return modes.size(); }
+    inline int SpinWeight() const { return parent->SpinWeight(); }
+    inline int BoostWeight() const { return parent->BoostWeight(); }
+    inline int FrameType() const { return parent->FrameType(); }
+    inline int DataType() const { return parent->DataType(); }
+    inline double T(const unsigned int TimeIndex) const { return parent->T(i_t_a+TimeIndex); }
+    inline std::vector<double> T() const { return std::vector<double>(parent->T().begin()+i_t_a, parent->T().begin()+i_t_b); }
+    inline unsigned int NFrames() const { return (parent->NFrames()>1 ? NTimes() : parent->NFrames()); }
+    inline Quaternions::Quaternion Frame(const unsigned int TimeIndex) const { return parent->Frame(i_t_a+TimeIndex); }
+    inline std::complex<double> Data(const unsigned int Mode, const unsigned int TimeIndex) const { return (*parent)(modes[Mode], i_t_a+TimeIndex); }
+    inline std::complex<double> operator()(const unsigned int Mode, const unsigned int TimeIndex) const { return (*parent)(modes[Mode], i_t_a+TimeIndex); }
+    inline const std::complex<double>* operator()(const unsigned int Mode) const { return (*parent)(modes[Mode])+i_t_a; }
+    inline const std::vector<int>& LM(const unsigned int Mode) const { return parent->LM(modes[Mode]); }
+    unsigned int FindModeIndex(const int L, const int M) const;
+    std::vector<std::complex<double> > DataDot(const unsigned int Mode) const;
+
+  public:  // Read-only analyses
+    std::vector<double> Norm(const bool TakeSquareRoot=false) const;
+    std::vector<std::vector<double> > LdtVector(std::vector<int> Lmodes=std::vector<int>(0)) const;
+    std::vector<Matrix> LLMatrix(std::vector<int> Lmodes=std::vector<int>(0)) const;
+    std::vector<std::vector<double> > AngularVelocityVector(const std::vector<int>& Lmodes=std::vector<int>(0)) const;
+    std::vector<std::complex<double> > EvaluateAtPoint(const double vartheta, const double varphi,
+                                                       const unsigned int i_0=0, int i_1=-1) const;
+    std::vector<std::vector<std::complex<double> > > EvaluateAtPoints(const std::vector<std::vector<double> >& ThetaPhi,
+                                                                      const unsigned int i_0=0, int i_1=-1) const;
+  }; // class WaveformView
+
+
+  /// Waveform whose mode data are stored in single precision
+  ///
+  /// The mode data take half the memory of a Waveform, which is useful
+  /// for holding large catalogs in memory.  The time, frame, and all
+  /// other information are kept exactly as in the original Waveform.
+  /// Reductions over the modes (Norm, LLMatrix) convert each element
+  /// to double precision and accumulate in double precision.  Other
+  /// operations should be applied to the result of `Expand()`.
+  class CompactWaveform {
+  private:  // Member data
+    Waveform meta; // Everything except the mode data, which is left empty
+    std::vector<std::complex<float> > data; // Mode by mode, each contiguous in time
+
+  public:  // Constructors
+    CompactWaveform();
+    explicit CompactWaveform(const Waveform& W);
+    explicit CompactWaveform(const std::string& FileName);
+    Waveform Expand() const;
+    void swap(CompactWaveform& b);
+
+  public:  // Data access functions
+    inline unsigned int NTimes() const { return meta.NTimes(); }
+    inline unsigned int NModes() const { return meta.lm.size(); }
+    inline int SpinWeight() const { return meta.SpinWeight(); }
+    inline int BoostWeight() const { return meta.BoostWeight(); }
+    inline int FrameType() const { return meta.FrameType(); }
+    inline int DataType() const { return meta.DataType(); }
+    inline std::string HistoryStr() const { return meta.HistoryStr(); }
+    inline double T(const unsigned int TimeIndex) const { return meta.T(TimeIndex); }
+    inline const std::vector<double>& T() const { return meta.T(); }
+    inline unsigned int NFrames() const { return meta.NFrames(); }
+    inline Quaternions::Quaternion Frame(const unsigned int TimeIndex) const { return meta.Frame(TimeIndex); }
+    inline const std::vector<Quaternions::Quaternion>& Frame() const { return meta.Frame(); }
+    inline const std::vector<int>& LM(const unsigned int Mode) const { return meta.LM(Mode); }
+    inline const std::vector<std::vector<int> >& LM() const { return meta.LM(); }
+    inline const ModeLayout& Layout() const { return meta.Layout(); }
+    inline std::complex<double> Data(const unsigned int Mode, const unsigned int TimeIndex) const {
+      return std::complex<double>(data[std::size_t(Mode)*NTimes()+TimeIndex]);
+    }
+    inline const std::complex<float>* operator()(const unsigned int Mode) const { return &data[std::size_t(Mode)*NTimes()]; }
+    inline std::size_t DataBytes() const { return data.size()*sizeof(std::complex<float>); }
+    unsigned int FindModeIndex(const int L, const int M) const;
+
+  public:  // Read-only analyses
+    std::vector<double> Norm(const bool TakeSquareRoot=false) const;
+    std::vector<Matrix> LLMatrix(std::vector<int> Lmodes=std::vector<int>(0)) const;
+
+  public:  // Output to data file
+    const CompactWaveform& Output(const std::string& FileName) const;
+  }; // class CompactWaveform
+
+
+  /// Interpolate a Waveform to many points in angle and time
+  ///
+  /// The cubic-spline coefficients of every mode (a natural spline
+  /// through all the time steps) are found once by the constructor;
+  /// each point then costs one bracket search and a sum over the
+  /// modes.  This replaces repeated calls to
+  /// `Waveform::InterpolateToPoint`, which spline just the four time
+  /// steps nearest each point, so the results differ slightly.  The
+  /// Waveform must be in an inertial frame (or a constant frame given
+  /// by a single rotor); the angles are measured in that frame.
+  class PointInterpolator {
+  private:  // Member data
+    int spinWeight;
+    std::vector<double> t;
+    std::vector<int> ell;
+    std::vector<int> m;
+    Quaternions::Quaternion frameInverse;
+    std::vector<std::complex<double> > coefficients;
+
+  private:  // Helper functions
+    unsigned int Interval(const double t_i, const unsigned int Guess) const;
+    void CheckTime(const double t_i) const;
+
+  public:  // Constructor
+    PointInterpolator(const Waveform& W);
+
+  public:  // Data access functions
+    inline int SpinWeight() const { return spinWeight; }
+    inline unsigned int NTimes() const { return t.size(); }
+    inline unsigned int NModes() const { return ell.size(); }
+    inline double TMin() const { return t[0]; }
+    inline double TMax() const { return t.back(); }
+
+  public:  // Evaluation
+    std::complex<double> operator()(const double vartheta, const double varphi, const double t_i) const;
+    std::vector<std::complex<double> > Evaluate(const std::vector<double>& Vartheta, const std::vector<double>& Varphi,
+                                                const std::vector<double>& T) const;
+    std::vector<std::vector<std::complex<double> > > Evaluate(const std::vector<std::vector<double> >& ThetaPhi,
+                                                              const std::vector<std::vector<double> >& T) const;
+  }; // class PointInterpolator
+
+
+  /// Follow the corotating or coprecessing frame of a Waveform as new data arrive
+  ///
+  /// This is meant for monitoring a running simulation.  Each call to
+  /// `Append` adds later time steps of an inertial-frame Waveform.
+  /// The angular velocity of the frame, its rotors, and the modes in
+  /// that frame are then found only for the new time steps and the
+  /// few before them that the derivative stencils reach, so the cost
+  /// of an update is proportional to the new data.  The values at the
+  /// last few time steps are provisional, and are revised by the next
+  /// call to `Append`; the first `NFinal()` will not change again.
+  /// Nothing is computed until there are at least five time steps.
+  ///
+  /// The rotor equation is integrated with one fourth-order
+  /// Runge-Kutta step per time step, so the frame agrees with that of
+  /// `TransformToCorotatingFrame` or `TransformToCoprecessingFrame`
+  /// up to the integration error.
+  class FrameTracker {
+  private:  // Member data
+    WaveformFrameType frameType;
+    std::vector<int> lModes;
+    Waveform tail; // Input data from time step i_tail on
+    unsigned int i_tail;
+    Quaternions::Quaternion ellHat; // Dominant eigenvector of <LL> at i_tail, for the coprecessing frame
+    std::vector<double> t;
+    std::vector<std::vector<double> > omega;
+    std::vector<Quaternions::Quaternion> frame;
+    std::vector<std::complex<double> > modes; // NModes() values at each time step in turn
+
+  public:  // Constructor
+    FrameTracker(const WaveformFrameType FrameType=Corotating, const std::vector<int>& Lmodes=std::vector<int>(0));
+
+  public:  // Data access functions
+    inline WaveformFrameType FrameType() const { return frameType; }
+    inline unsigned int NTimes() const { return t.size(); }
+    inline unsigned int NModes() const { return tail.NModes(); }
+    inline unsigned int NFinal() const { return (frame.size()<3 ? 0 : frame.size()-3); }
+    inline const std::vector<double>& T() const { return t; }
+    inline const std::vector<std::vector<double> >& AngularVelocityVector() const { return omega; }
+    inline const std::vector<Quaternions::Quaternion>& Frame() const { return frame; }
+
+  public:  // Updates and results
+    FrameTracker& Append(const Waveform& W);
+    Waveform Result() const;
+  }; // class FrameTracker
+
+
+  /// Interpolate two Waveforms onto one time grid once, for repeated comparisons and hybrids
+  ///
+  /// `Waveform::Compare`, `Waveform::Hybridize`, and norms of their
+  /// difference each interpolate both inputs again.  This object
+  /// interpolates A onto the part of the grid within A's times and B
+  /// onto the part within B's times just once; each of the results
+  /// below only combines the stored data.  The default grid is the
+  /// one used by `A.Hybridize(B, t1, t2, tMinStep)`, so `Hybridize`
+  /// gives the same result as that function up to the method of
+  /// interpolation.  Comparisons are made on the part of the grid
+  /// where A and B overlap, rather than on `Intersection(A.T(),
+  /// B.T())`.  Given a uniform grid, the hybrid can be passed to
+  /// `WaveformAtAPointFT` with the same time step, which then uses
+  /// the data as they are.
+  class WaveformPair {
+  private:  // Member data
+    std::vector<double> t;
+    unsigned int i_A0, i_A1; // Indices [i_A0,i_A1) of t within A's times
+    unsigned int i_B0, i_B1; // Indices [i_B0,i_B1) of t within B's times
+    Waveform a; // Waveform A, interpolated to t[i_A0,...,i_A1)
+    Waveform b; // Waveform B, interpolated to t[i_B0,...,i_B1), with its modes in the order of A's
+
+  private:  // Helper functions
+    void Initialize(const Waveform& A, const Waveform& B);
+
+  public:  // Constructors
+    WaveformPair(const Waveform& A, const Waveform& B, const double tMinStep=0.005);
+    WaveformPair(const Waveform& A, const Waveform& B, const std::vector<double>& T);
+
+  public:  // Data access functions
+    inline unsigned int NTimes() const { return t.size(); }
+    inline unsigned int NModes() const { return a.NModes(); }
+    inline const std::vector<double>& T() const { return t; }
+    inline unsigned int IndexOverlapBegin() const { return (i_A0>i_B0 ? i_A0 : i_B0); }
+    inline unsigned int IndexOverlapEnd() const { return (i_A1<i_B1 ? i_A1 : i_B1); }
+    inline const Waveform& A() const { return a; }
+    inline const Waveform& B() const { return b; }
+
+  public:  // Results
+    Waveform Compare() const;
+    std::vector<double> DifferenceNorm(const bool TakeSqrt=true) const;
+    double RelativeDifference(const double t1=-3.0e300, const double t2=3.0e300) const;
+    Waveform Hybridize(const double t1, const double t2) const;
+  }; // class WaveformPair
+
+
+  /// Apply operations that are local in time to a Waveform file, one window of times at a time
+  ///
+  /// Only one window of the data (plus a few extra samples at each
+  /// end, as needed by derivatives) is in memory at any time, so very
+  /// long or high-resolution waveforms can be processed with limited
+  /// memory.  The operations are recorded by the member functions
+  /// named like those of Waveform, and applied when one of the
+  /// results (`Norm`, `EvaluateAtPoint`, or `Output`) is requested.
+  /// Each result agrees with what the same operations would give if
+  /// applied to the whole Waveform, up to rounding.  Operations that
+  /// are not local in time (like the transformations to the
+  /// corotating or coprecessing frames, which integrate over time)
+  /// are not available.
+  ///
+  /// The input may be a binary file (as written by `Waveform::Output`
+  /// with a name ending in '.bin') or an H5 file in NRAR format.
+  class WaveformStream {
+  private:  // Member data
+    enum StepType { RotatePhysicalSystemStep, RotateDecompositionBasisStep, TransformToInertialFrameStep, DifferentiateStep };
+    struct Step {
+      StepType Type;
+      Quaternions::Quaternion R;
+    };
+    std::string fileName;
+    bool isH5;
+    unsigned int chunkSize;
+    std::vector<double> t;
+    std::vector<Step> steps;
+
+  private:  // Helper functions
+    Waveform Read(const unsigned int i_t_a, const unsigned int i_t_b) const;
+    Waveform Chunk(const unsigned int i_t_a, const unsigned int i_t_b) const;
+
+  public:  // Constructor
+    WaveformStream(const std::string& FileName, const unsigned int ChunkSize=65536);
+
+  public:  // Data access functions
+    inline unsigned int NTimes() const { return t.size(); }
+    inline const std::vector<double>& T() const { return t; }
+    inline unsigned int ChunkSize() const { return chunkSize; }
+    unsigned int Halo() const;
+    inline unsigned int NChunks() const { return (NTimes()+chunkSize-1)/chunkSize; }
+
+  public:  // Operations, applied to each chunk in order
+    WaveformStream& RotatePhysicalSystem(const Quaternions::Quaternion& R_phys);
+    WaveformStream& RotateDecompositionBasis(const Quaternions::Quaternion& R_frame);
+    WaveformStream& TransformToInertialFrame();
+    WaveformStream& Differentiate();
+
+  public:  // Results, computed chunk by chunk
+    std::vector<double> Norm(const bool TakeSquareRoot=false) const;
+    std::vector<std::complex<double> > EvaluateAtPoint(const double vartheta, const double varphi) const;
+    void Output(const std::string& FileName) const;
+  }; // class WaveformStream
+
+
+  /// Apply the same chain of operations to many Waveform files
+  ///
+  /// Each simulation is read from its input file, passed through
+  /// the recorded operations, and written to its output file.  When
+  /// compiled with OpenMP, `Run` distributes the simulations over a
+  /// pool of `MaxThreads()` workers, so that reading, computing, and
+  /// writing of different simulations overlap.  A memory budget may
+  /// be set, in which case a worker waits before reading another
+  /// simulation until the estimated memory of the simulations in
+  /// progress leaves room for it; a simulation larger than the
+  /// whole budget is processed alone.  Reading and writing of H5 files
+  /// is serialized, because the HDF5 library is not generally
+  /// thread-safe.
+  ///
+  /// The alignment and hybridization steps use a reference Waveform
+  /// for each simulation (typically a PN waveform, written to file
+  /// beforehand), which is read when first needed and kept through
+  /// the rest of the chain, so that hybridization sees the reference
+  /// as it was aligned.
+  class CatalogProcessor {
+  private:  // Member data
+    enum StepType { DropTimesOutsideStep, TransformToCorotatingFrameStep, TransformToCoprecessingFrameStep,
+                    TransformToInertialFrameStep, AlignToReferenceStep, HybridizeWithReferenceStep };
+    struct Step {
+      StepType Type;
+      double t_1;
+      double t_2;
+      double tMinStep;
+      unsigned int InitialEvaluations;
+    };
+    std::vector<std::string> inputFileNames;
+    std::vector<std::string> outputFileNames;
+    std::vector<std::string> referenceFileNames;
+    std::vector<Step> steps;
+    double memoryBudget;
+    double memoryPerByteOnDisk;
+    std::vector<int> errorCodes;
+
+  private:  // Helper functions
+    double EstimatedMemory(const unsigned int i) const;
+    void Process(const unsigned int i) const;
+
+  public:  // Constructor
+    CatalogProcessor(const std::vector<std::string>& InputFileNames, const std::vector<std::string>& OutputFileNames);
+
+  public:  // Settings
+    CatalogProcessor& SetReferenceFileNames(const std::vector<std::string>& ReferenceFileNames);
+    CatalogProcessor& SetMemoryBudget(const double Bytes, const double MemoryPerByteOnDisk=4.0);
+
+  public:  // Data access functions
+    inline unsigned int NSimulations() const { return inputFileNames.size(); }
+    inline unsigned int NSteps() const { return steps.size(); }
+    inline double MemoryBudget() const { return memoryBudget; }
+    bool Succeeded(const unsigned int i) const;
+    int ErrorCode(const unsigned int i) const;
+
+  public:  // Operations, applied to each simulation in order
+    CatalogProcessor& DropTimesOutside(const double t_a, const double t_b);
+    CatalogProcessor& TransformToCorotatingFrame();
+    CatalogProcessor& TransformToCoprecessingFrame();
+    CatalogProcessor& TransformToInertialFrame();
+    CatalogProcessor& AlignToReference(const double t_1, const double t_2, const unsigned int InitialEvaluations=0);
+    CatalogProcessor& HybridizeWithReference(const double t_1, const double t_2, const double tMinStep=0.005);
+
+  public:  // Processing
+    unsigned int Run();
+  }; // class CatalogProcessor
 
 } // namespace GWFrames
 
@@ -19,7 +19,6 @@ using GWFrames::operator-;
 
 namespace {
 
-  double sqr(const double& a) { return a*a; }
   double cube(const double& a) { return a*a*a; }
 
   double BumpFunction(const double x, const double x0, const double x1) {
@@ -29,6 +28,66 @@ namespace {
     return 1.0 / (1.0 + exp(1.0/t - 1.0/(1-t)));
   }
 
+  // Ensure that B and InversePSD can be compared to A, throwing if not
+  void CheckCompatibility(const GWFrames::WaveformAtAPointFT& A,
+                          const GWFrames::WaveformAtAPointFT& B,
+                          const vector<double>& InversePSD) {
+    const unsigned int n = A.NFreq();
+    if(n != B.NFreq() || n != InversePSD.size()) {
+      cerr << "Waveform sizes, " << n << " and " << B.NFreq()
+           << ", are not compatible with InversePSD size, " << InversePSD.size() << "." << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    const double eps = 1e-8;
+    const double df = A.F(1)-A.F(0);
+    const double df_B = B.F(1)-B.F(0);
+    const double rel_diff_df = std::fabs(1 - df/df_B);
+    if(rel_diff_df > eps) {
+      cerr << "Waveform frequency steps, " << df << " and " << df_B
+           << ", are not compatible in Match: rel_diff="<< rel_diff_df << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+  }
+
+  // Find the time offset, phase offset, and match from the inverse
+  // FFT of the weighted product of two waveforms
+  void PeakOfMatch(const vector<complex<double> >& data, const double df, const bool RefinePeak,
+                   double& timeOffset, double& phaseOffset, double& match) {
+    const unsigned int N = data.size();
+    unsigned int maxi=0;
+    double maxmag = std::abs(data[0]);
+    for(unsigned int i=1; i<N; ++i) {
+      const double mag = std::abs(data[i]);
+      if(mag>maxmag) { maxmag = mag; maxi = int(i); }
+    }
+    double Peak = maxi;
+    double PeakMag = maxmag;
+    complex<double> PeakValue = data[maxi];
+    if(RefinePeak && N>2) {
+      // Fit a parabola to the magnitude at the peak and its (periodic)
+      // neighbors, and interpolate the complex value to its maximum
+      const complex<double>& Before = data[(maxi+N-1)%N];
+      const complex<double>& After = data[(maxi+1)%N];
+      const double Curvature = std::abs(Before) - 2*maxmag + std::abs(After);
+      if(Curvature<0.0) {
+        const double delta = 0.5*(std::abs(Before)-std::abs(After))/Curvature;
+        Peak += delta;
+        PeakMag = maxmag - 0.25*(std::abs(Before)-std::abs(After))*delta;
+        PeakValue += (0.5*delta)*(After-Before) + (0.5*delta*delta)*(After-2.0*PeakValue+Before);
+      }
+    }
+    // note: assumes N is even and N >= maxi
+    timeOffset = (Peak<N/2.0 ? Peak/(N*df) : -(N-Peak)/(N*df));
+    phaseOffset = atan2(PeakValue.imag(), PeakValue.real())/2.0;
+    // The return from ifft is just the bare FFT sum, so we multiply by
+    // df to get the continuum-analog FT.  This is correct because the
+    // input data (re,im) are the continuum-analog data, rather than
+    // just the return from the bare FFT sum.  See, e.g., Eq. (A.33)
+    // [as opposed to Eq. (A.35)] of my (Mike Boyle's) thesis:
+    // <http://thesis.library.caltech.edu/143>.
+    match = 4.0*df*PeakMag;
+  }
+
   // // Unused:
   // double DoubleSidedF(const unsigned int i, const unsigned int N, const double df) {
   //   if(i<N/2) { return i*df; }
@@ -37,6 +96,10 @@ namespace {
 
 }
 
+GWFrames::WaveformAtAPointFT::WaveformAtAPointFT()
+  : mDt(0.0), mVartheta(0.0), mVarphi(0.0), mRealF(), mImagF(), mFreqs(), mNormalized(false)
+{ }
+
 GWFrames::WaveformAtAPointFT::WaveformAtAPointFT(const GWFrames::Waveform& W,
                                                  const double Dt,
                                                  const double Vartheta,
@@ -48,20 +111,34 @@ GWFrames::WaveformAtAPointFT::WaveformAtAPointFT(const GWFrames::Waveform& W,
                                                  const unsigned int ExtraZeroPadPowers)
 : mDt(Dt), mVartheta(Vartheta), mVarphi(Varphi), mNormalized(false)
 {
+  GWFrames_INSTRUMENT("WaveformAtAPointFT::WaveformAtAPointFT");
 
-  // Interpolate to an even time spacing dt whose size is the next power of 2
+  // Interpolate to an even time spacing dt whose size is the next even size
+  // with no prime factors beyond 7 (which FFTW handles efficiently)
   // Then zero pad for additional powers of 2 if requested (may be needed for
   // more fine-grained control of time and phase offsets)
   const unsigned int N1 = (unsigned int)(std::floor((W.T().back()-W.T(0))/Dt));
-  const unsigned int NPow = ceil(log2(N1)) + ExtraZeroPadPowers;
-  const unsigned int N2 = (unsigned int)(std::pow(2.0, double(NPow)));
+  const unsigned int N2 = WU::FFTFriendlySize(N1) << ExtraZeroPadPowers;
   vector<double> NewTimes(N2);
   for(unsigned int i=0; i<N2; ++i) {
     NewTimes[i] = W.T(0) + i*Dt;
   }
 
-  GWFrames::Waveform W2 = W.Interpolate(NewTimes, true);
-  const vector<complex<double> > ComplexHData = W2.EvaluateAtPoint(Vartheta, Varphi);
+  // If W is already sampled at the first of these times (as with the
+  // results of a WaveformPair on a uniform grid), the data are used as
+  // they are, and just padded with zeros
+  bool AlreadySampled = (W.NTimes()<=N2);
+  for(unsigned int i=0; AlreadySampled && i<W.NTimes(); ++i) {
+    if(std::fabs(W.T(i)-NewTimes[i]) > 1.e-10*Dt) { AlreadySampled = false; }
+  }
+  vector<complex<double> > ComplexHData;
+  if(AlreadySampled) {
+    ComplexHData = W.EvaluateAtPoint(Vartheta, Varphi);
+    ComplexHData.resize(N2, complex<double>(0.0, 0.0));
+  } else {
+    GWFrames::Waveform W2 = W.Interpolate(NewTimes, true);
+    ComplexHData = W2.EvaluateAtPoint(Vartheta, Varphi);
+  }
 
   // Construct initial real,imag H as a function of time
   vector<double> InitRealT(ComplexHData.size());
@@ -121,7 +198,10 @@ GWFrames::WaveformAtAPointFT::WaveformAtAPointFT(const GWFrames::Waveform& W,
 
   // Construct real,imag H as a function of frequency
   // The return from realdft needs to be multiplied by dt to correspond to the continuum FT
-  WU::realdft(RealT);
+  {
+    GWFrames_INSTRUMENT("WaveformAtAPointFT::WaveformAtAPointFT: FFT");
+    WU::realdft(RealT);
+  }
   if (mFreqs.size() != RealT.size()/2+1) {
     cerr << "Time and frequency data size mismatch: "
          << mFreqs.size() << "," << RealT.size()/2+1 << endl;
@@ -154,7 +234,7 @@ namespace GWFrames {
 
   WaveformAtAPointFT& WaveformAtAPointFT::Normalize(const std::string& Detector)
   {
-    return Normalize(WU::InverseNoiseCurve(F(), Detector));
+    return Normalize(WU::CachedInverseNoiseCurve(F(), Detector));
   }
 
   WaveformAtAPointFT& WaveformAtAPointFT::ZeroAbove(const double Frequency)
@@ -190,7 +270,7 @@ namespace GWFrames {
 
   vector<double> WaveformAtAPointFT::InversePSD(const std::string& Detector) const
   {
-    return WU::InverseNoiseCurve(F(), Detector);
+    return WU::CachedInverseNoiseCurve(F(), Detector);
   }
 
   double WaveformAtAPointFT::SNR(const std::vector<double>& InversePSD) const
@@ -211,7 +291,7 @@ namespace GWFrames {
   double WaveformAtAPointFT::SNR(const std::string& Detector) const
   {
     /// \param[in] Detector Noise spectrum from this detector
-    return SNR(WU::InverseNoiseCurve(F(), Detector));
+    return SNR(WU::CachedInverseNoiseCurve(F(), Detector));
   }
 
   /// Compute the match between two WaveformAtAPointFT
@@ -228,48 +308,22 @@ namespace GWFrames {
     /// \param[out] timeOffset Time offset (in seconds) between the waveforms
     /// \param[out] phaseOffset Phase offset used between the waveforms
     /// \param[out] match Match between the two waveforms
+    GWFrames_INSTRUMENT("WaveformAtAPointFT::Match");
     const unsigned int n = NFreq(); // Only positive frequencies are stored in t
     const unsigned int N = 2*(n-1);  // But this is how many there really are
     if(!IsNormalized() || !B.IsNormalized()) {
       cerr << "\n\nWARNING!!! Matching non-normalized WaveformAtAPointFT objects. WARNING!!!\n" << endl;
     }
-    if(n != B.NFreq() || n != InversePSD.size()) {
-      cerr << "Waveform sizes, " << n << " and " << B.NFreq()
-           << ", are not compatible with InversePSD size, " << InversePSD.size() << "." << endl;
-      throw(GWFrames_VectorSizeMismatch);
-    }
-    const double eps = 1e-8;
+    CheckCompatibility(*this, B, InversePSD);
     const double df = F(1)-F(0);
-    const double df_B = B.F(1)-B.F(0);
-    const double rel_diff_df = std::fabs(1 - df/df_B);
-    if(rel_diff_df > eps) {
-      cerr << "Waveform frequency steps, " << df << " and " << df_B
-           << ", are not compatible in Match: rel_diff="<< rel_diff_df << endl;
-      throw(GWFrames_VectorSizeMismatch);
-    }
     // s1 s2* = (a1 + i b1) (a2 - i b2) = (a1 a2 + b1 b2) + i(b1 a2 - a1 b2)
-    WU::WrapVecDoub data(2*N);
+    vector<complex<double> > data(N);
     for(unsigned int i=0; i<n; ++i) {
-      data.real(i) = (Re(i)*B.Re(i)+Im(i)*B.Im(i))*InversePSD[i];
-      data.imag(i) = (Im(i)*B.Re(i)-Re(i)*B.Im(i))*InversePSD[i];
+      data[i] = complex<double>((Re(i)*B.Re(i)+Im(i)*B.Im(i))*InversePSD[i],
+                                (Im(i)*B.Re(i)-Re(i)*B.Im(i))*InversePSD[i]);
     }
-    idft(data);
-    unsigned int maxi=0;
-    double maxmag = std::sqrt(sqr(data.real(0)) + sqr(data.imag(0)));
-    for(unsigned int i=1; i<N; ++i) {
-      const double mag = std::sqrt(sqr(data.real(i)) + sqr(data.imag(i)));
-      if(mag>maxmag) { maxmag = mag; maxi = int(i); }
-    }
-    // note: assumes N is even and N >= maxi
-    timeOffset = (maxi<N/2 ? double(maxi)/(N*df) : -double(N-maxi)/(N*df));
-    phaseOffset = atan2(data.imag(maxi), data.real(maxi))/2.0;
-    /// The return from ifft is just the bare FFT sum, so we multiply by
-    /// df to get the continuum-analog FT.  This is correct because the
-    /// input data (re,im) are the continuum-analog data, rather than
-    /// just the return from the bare FFT sum.  See, e.g., Eq. (A.33)
-    /// [as opposed to Eq. (A.35)] of my (Mike Boyle's) thesis:
-    /// <http://thesis.library.caltech.edu/143>.
-    match = 4.0*df*maxmag;
+    WU::idft(data);
+    PeakOfMatch(data, df, false, timeOffset, phaseOffset, match);
     return;
   }
 
@@ -281,7 +335,92 @@ namespace GWFrames {
                                  double& phaseOffset, double& match,
                                  const std::string& Detector) const
   {
-    Match(B, WU::InverseNoiseCurve(F(), Detector), timeOffset, phaseOffset, match);
+    Match(B, WU::CachedInverseNoiseCurve(F(), Detector), timeOffset, phaseOffset, match);
+    return;
+  }
+
+  /// Compute the matches between this signal and a bank of templates
+  /// NOTE: in python, the values for timeOffsets, phaseOffsets, and
+  /// matches are returned as arrays, e.g.:
+  ///   timeOffsets, phaseOffsets, matches = Match(Templates, InversePSD)
+  void WaveformAtAPointFT::Match(const std::vector<WaveformAtAPointFT>& Templates,
+                                 const std::vector<double>& InversePSD,
+                                 std::vector<double>& timeOffsets,
+                                 std::vector<double>& phaseOffsets,
+                                 std::vector<double>& matches,
+                                 const bool RefinePeak) const
+  {
+    /// \param[in] Templates WaveformAtAPointFT objects to compute matches with
+    /// \param[in] InversePSD Spectrum used to weight contributions by frequencies to match
+    /// \param[out] timeOffsets Time offsets (in seconds) between this and each template
+    /// \param[out] phaseOffsets Phase offsets used between this and each template
+    /// \param[out] matches Match between this and each template
+    /// \param[in] RefinePeak If true, interpolate between samples to find the peak
+    ///
+    /// The signal is weighted by InversePSD once, and the inverse
+    /// FFTs for the various templates are run in parallel when
+    /// compiled with OpenMP.  With RefinePeak, a parabola is fitted
+    /// through the largest sample and its neighbors, which resolves
+    /// the offsets much more finely than the sample spacing, without
+    /// needing `ExtraZeroPadPowers`.
+    GWFrames_INSTRUMENT("WaveformAtAPointFT::Match(Templates)");
+    const unsigned int NT = Templates.size();
+    timeOffsets.resize(NT);
+    phaseOffsets.resize(NT);
+    matches.resize(NT);
+    if(NT==0) { return; }
+    const unsigned int n = NFreq(); // Only positive frequencies are stored in t
+    const unsigned int N = 2*(n-1);  // But this is how many there really are
+    bool AllNormalized = IsNormalized();
+    for(unsigned int t=0; t<NT; ++t) {
+      CheckCompatibility(*this, Templates[t], InversePSD);
+      AllNormalized = (AllNormalized && Templates[t].IsNormalized());
+    }
+    if(!AllNormalized) {
+      cerr << "\n\nWARNING!!! Matching non-normalized WaveformAtAPointFT objects. WARNING!!!\n" << endl;
+    }
+    const double df = F(1)-F(0);
+    vector<complex<double> > WeightedSignal(n);
+    for(unsigned int i=0; i<n; ++i) {
+      WeightedSignal[i] = complex<double>(Re(i)*InversePSD[i], Im(i)*InversePSD[i]);
+    }
+    // Make the FFTW plan out here, where a failure can still be thrown
+    {
+      vector<complex<double> > data(N);
+      WU::idft(data);
+    }
+    #pragma omp parallel if(NT>1) num_threads(GWFrames::MaxThreads())
+    {
+      vector<complex<double> > data(N);
+      #pragma omp for schedule(dynamic)
+      for(int t=0; t<int(NT); ++t) {
+        const WaveformAtAPointFT& B = Templates[t];
+        // s1 s2* = (a1 + i b1) (a2 - i b2)
+        for(unsigned int i=0; i<n; ++i) {
+          data[i] = WeightedSignal[i] * complex<double>(B.Re(i), -B.Im(i));
+        }
+        for(unsigned int i=n; i<N; ++i) {
+          data[i] = 0.0;
+        }
+        WU::idft(data);
+        PeakOfMatch(data, df, RefinePeak, timeOffsets[t], phaseOffsets[t], matches[t]);
+      }
+    }
+    return;
+  }
+
+  /// Compute the matches between this signal and a bank of templates
+  /// NOTE: in python, the values for timeOffsets, phaseOffsets, and
+  /// matches are returned as arrays, e.g.:
+  ///   timeOffsets, phaseOffsets, matches = Match(Templates)
+  void WaveformAtAPointFT::Match(const std::vector<WaveformAtAPointFT>& Templates,
+                                 std::vector<double>& timeOffsets,
+                                 std::vector<double>& phaseOffsets,
+                                 std::vector<double>& matches,
+                                 const std::string& Detector,
+                                 const bool RefinePeak) const
+  {
+    Match(Templates, WU::CachedInverseNoiseCurve(F(), Detector), timeOffsets, phaseOffsets, matches, RefinePeak);
     return;
   }
 
@@ -298,7 +437,7 @@ namespace GWFrames {
   double WaveformAtAPointFT::Match(const WaveformAtAPointFT& B,
                                    const std::string& Detector) const
   {
-    return Match(B, WU::InverseNoiseCurve(F(), Detector));
+    return Match(B, WU::CachedInverseNoiseCurve(F(), Detector));
   }
 
 }
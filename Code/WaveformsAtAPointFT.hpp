@@ -21,6 +21,7 @@ namespace GWFrames {
     bool mNormalized;
 
   public:  // Constructors and Destructor
+    WaveformAtAPointFT();
     WaveformAtAPointFT(const GWFrames::Waveform& W,
                        const double Dt,
                        const double Vartheta,
@@ -62,6 +63,15 @@ namespace GWFrames {
     void Match(const WaveformAtAPointFT& B, double& timeOffset,
                double& phaseOffset, double& match,
                const std::string& Detector="AdvLIGO_ZeroDet_HighP") const;
+    void Match(const std::vector<WaveformAtAPointFT>& Templates,
+               const std::vector<double>& InversePSD,
+               std::vector<double>& timeOffsets, std::vector<double>& phaseOffsets,
+               std::vector<double>& matches, const bool RefinePeak=false) const;
+    void Match(const std::vector<WaveformAtAPointFT>& Templates,
+               std::vector<double>& timeOffsets, std::vector<double>& phaseOffsets,
+               std::vector<double>& matches,
+               const std::string& Detector="AdvLIGO_ZeroDet_HighP",
+               const bool RefinePeak=false) const;
   public:
     WaveformAtAPointFT& Normalize(const std::vector<double>& InversePSD);
     WaveformAtAPointFT& Normalize(const std::string& Detector="AdvLIGO_ZeroDet_HighP");
@@ -1,161 +1,231 @@
-/// Pointwise multiply this object by another Waveform object
+#ifndef DOXYGEN
+namespace {
+  // Index into the mode data of W of each (l,m) up to lMax, in the
+  // ordering used by the transforms, or -1 for modes that are absent
+  std::vector<int> BinaryOpModeIndices(const GWFrames::Waveform& W, const int lMax) {
+    std::vector<int> Indices((lMax+1)*(lMax+1), -1);
+    for(int l=std::abs(W.SpinWeight()); l<=lMax; ++l) {
+      for(int m=-l; m<=l; ++m) {
+        const unsigned int i = W.FindModeIndexWithoutError(l, m);
+        if(i<W.NModes()) { Indices[l*l+l+m] = i; }
+      }
+    }
+    return Indices;
+  }
+}
+#endif // DOXYGEN
+
+/// Pointwise combine this object with each of several other Waveform objects
 template <typename Op>
-GWFrames::Waveform GWFrames::Waveform::BinaryOp(const GWFrames::Waveform& B) const {
+std::vector<GWFrames::Waveform> GWFrames::Waveform::BinaryOps(const std::vector<const GWFrames::Waveform*>& Bs,
+                                                              const std::vector<bool>& ConjugateB) const {
+  ///
+  /// \param Bs Second operand of each result
+  /// \param ConjugateB If ConjugateB[k] is true, the complex conjugate of `*Bs[k]` is used [optional]
+  ///
+  /// The data are transformed to an equi-angular grid at each time,
+  /// combined pointwise, and transformed back.  The grid of this
+  /// Waveform is found once per time step and shared by all the
+  /// results (as is the grid of B, if B is this object), so forming
+  /// several products with a common first operand costs little more
+  /// than forming one.  The transforms use the cached `SHTPlan`s, and
+  /// when compiled with OpenMP, the time steps are distributed over
+  /// threads.
   const Waveform& A = *this;
-
-  if(A.NTimes() != B.NTimes()) {
-    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-              << "\nError: Asking for the product of two Waveform objects with different time data."
-              << "\n       A.NTimes()=" << A.NTimes() << "\tB.NTimes()=" << B.NTimes()
-              << "\n       Interpolate to a common set of times first.\n"
-              << std::endl;
-    throw(GWFrames_MatrixSizeMismatch);
+  const unsigned int NResults = Bs.size();
+  if(ConjugateB.size()!=0 && ConjugateB.size()!=NResults) {
+    std::cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Bs.size()=" << NResults
+              << "; ConjugateB.size()=" << ConjugateB.size() << std::endl;
+    throw(GWFrames_VectorSizeMismatch);
   }
 
-  if(A.frameType != GWFrames::Inertial || B.frameType != GWFrames::Inertial) {
-    if(A.frameType != B.frameType) {
-      std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-                << "\nError: Asking for the pointwise product of Waveforms in " << GWFrames::WaveformFrameNames[A.frameType]
-                << " and " << GWFrames::WaveformFrameNames[B.frameType] << " frames."
-                << "\n       This should only be applied to Waveforms in the same frame.\n"
-                << std::endl;
-      throw(GWFrames_WrongFrameType);
-    } else if(A.frame.size() != B.frame.size()) {
+  for(unsigned int k=0; k<NResults; ++k) {
+    const Waveform& B = *Bs[k];
+
+    if(A.NTimes() != B.NTimes()) {
       std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
-                << "\nError: Asking for the pointwise product of Waveforms with " << A.frame.size() << " and " << B.frame.size() << " frame data points."
-                << "\n       This should only be applied to Waveforms in the same frame.\n"
+                << "\nError: Asking for the product of two Waveform objects with different time data."
+                << "\n       A.NTimes()=" << A.NTimes() << "\tB.NTimes()=" << B.NTimes()
+                << "\n       Interpolate to a common set of times first.\n"
                 << std::endl;
-      throw(GWFrames_WrongFrameType);
+      throw(GWFrames_MatrixSizeMismatch);
     }
-  }
 
-  // This will be the new object holding the multiplied data
-  GWFrames::Waveform C;
-
-  // The new spin weight is the sum of the old ones
-  C.spinweight = A.spinweight + B.spinweight;
-
-  // Store both old histories in C's
-  C.history << "### *this = A*B\n"
-            << "#### A.history.str():\n" << A.history.str()
-            << "#### B.history.str():\n" << B.history.str()
-            << "#### End of old histories from `A*B`" << std::endl;
-
-  // Just copy other data from A
-  C.t = A.t;
-  C.frame = A.frame;
-  C.frameType = A.frameType;
-  C.dataType = A.dataType;
-  C.rIsScaledOut = A.rIsScaledOut;
-  C.mIsScaledOut = A.mIsScaledOut;
-
-  // Determine the ranges of l that the output should have
-  int lMinA = std::abs(A.SpinWeight());
-  int lMinB = std::abs(B.SpinWeight());
-  int lMin = std::abs(C.SpinWeight());
-  int lMax = lMin;
-  {
-    int lMaxA = lMin;
-    for(unsigned int i=0; i<A.NModes(); ++i) {
-      if(A.lm[i][0]>lMaxA) { lMaxA = A.lm[i][0]; }
-    }
-    int lMaxB = lMin;
-    for(unsigned int i=0; i<B.NModes(); ++i) {
-      if(B.lm[i][0]>lMaxB) { lMaxB = B.lm[i][0]; }
-    }
-    lMax = (lMaxA>lMaxB ? lMaxB : lMaxA); // Take the smaller
-  }
-  int Nlm = N_lm(lMax);
-
-  // Set the output lm data
-  C.lm = std::vector<std::vector<int> >(lMax*(2+lMax)-lMin*lMin+1, std::vector<int>(2,0));
-  {
-    unsigned int i=0;
-    for(int l=lMin; l<=lMax; ++l) {
-      for(int m=-l; m<=l; ++m) {
-        C.lm[i][0] = l;
-        C.lm[i][1] = m;
-        ++i;
+    if(A.frameType != GWFrames::Inertial || B.frameType != GWFrames::Inertial) {
+      if(A.frameType != B.frameType) {
+        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                  << "\nError: Asking for the pointwise product of Waveforms in " << GWFrames::WaveformFrameNames[A.frameType]
+                  << " and " << GWFrames::WaveformFrameNames[B.frameType] << " frames."
+                  << "\n       This should only be applied to Waveforms in the same frame.\n"
+                  << std::endl;
+        throw(GWFrames_WrongFrameType);
+      } else if(A.frame.size() != B.frame.size()) {
+        std::cerr << "\n\n" << __FILE__ << ":" << __LINE__
+                  << "\nError: Asking for the pointwise product of Waveforms with " << A.frame.size() << " and " << B.frame.size() << " frame data points."
+                  << "\n       This should only be applied to Waveforms in the same frame.\n"
+                  << std::endl;
+        throw(GWFrames_WrongFrameType);
       }
     }
   }
 
-  // These numbers determine the equi-angular grid on which we will do
-  // the pointwise multiplication.  For best accuracy, have N_phi>
-  // 2*lMax and N_theta > 2*lMax; but for speed, don't make them much
-  // greater.
-  int N_phi = 2*lMax + 1;
-  int N_theta = 2*lMax + 1;
-
-  // These will be work arrays
-  // const std::complex<double> I(0.0,1.0);
-  const std::complex<double> zero(0.0,0.0);
-  std::vector<std::complex<double> > almA(Nlm);
-  std::vector<std::complex<double> > almB(Nlm);
-  std::vector<std::complex<double> > almC(Nlm);
+  int lMaxA = 0;
+  for(unsigned int i=0; i<A.NModes(); ++i) {
+    if(A.lm[i][0]>lMaxA) { lMaxA = A.lm[i][0]; }
+  }
 
-  // Now, loop through each time step doing the work
-  C.data.resize(C.lm.size(), C.t.size());
-  for(unsigned int i_t=0; i_t<C.t.size(); ++i_t) {
-    std::vector<std::complex<double> > fA(N_phi*N_theta, zero);
-    std::vector<std::complex<double> > fB(N_phi*N_theta, zero);
-    std::vector<std::complex<double> > fC(N_phi*N_theta, zero);
+  std::vector<GWFrames::Waveform> Cs(NResults);
+  std::vector<int> lMins(NResults);
+  std::vector<int> GridlMax; // ellMax of each distinct grid on which A is needed
+  std::vector<unsigned int> GridIndex(NResults);
+  std::vector<bool> Conjugate(NResults, false);
+  std::vector<bool> SameAsA(NResults, false);
+  for(unsigned int k=0; k<NResults; ++k) {
+    const Waveform& B = *Bs[k];
+    GWFrames::Waveform& C = Cs[k];
+    Conjugate[k] = (ConjugateB.size()>0 && ConjugateB[k]);
+    SameAsA[k] = (&B == &A);
+
+    // The new spin weight is the sum of the old ones
+    C.spinweight = A.spinweight + (Conjugate[k] ? -B.spinweight : B.spinweight);
+
+    // Store both old histories in C's
+    C.history << (Conjugate[k] ? "### *this = A*conj(B)\n" : "### *this = A*B\n")
+              << "#### A.history.str():\n";
+    C.history.Include(A.history);
+    C.history << "#### B.history.str():\n";
+    C.history.Include(B.history);
+    C.history << "#### End of old histories from `A*B`" << std::endl;
+
+    // Just copy other data from A
+    C.t = A.t;
+    C.frame = A.frame;
+    C.frameType = A.frameType;
+    C.dataType = A.dataType;
+    C.rIsScaledOut = A.rIsScaledOut;
+    C.mIsScaledOut = A.mIsScaledOut;
+
+    // Determine the ranges of l that the output should have
+    const int lMin = std::abs(C.SpinWeight());
+    int lMaxB = 0;
+    for(unsigned int i=0; i<B.NModes(); ++i) {
+      if(B.lm[i][0]>lMaxB) { lMaxB = B.lm[i][0]; }
+    }
+    const int lMax = std::max(lMin, std::min(lMaxA, lMaxB)); // Take the smaller
+    lMins[k] = lMin;
 
-    { // Set the a_lm coefficients of A
+    // Set the output lm data
+    C.lm = std::vector<std::vector<int> >(lMax*(2+lMax)-lMin*lMin+1, std::vector<int>(2,0));
+    {
       unsigned int i=0;
-      for(int l=0; l<lMinA; ++l) {
-        for(int m=-l; m<=-l; ++m) {
-          almA[i] = zero;
-          ++i;
-        }
-      }
-      for(int l=lMinA; l<=lMax; ++l) {
-        for(int m=-l; m<=-l; ++m) {
-          const unsigned int iA = A.FindModeIndexWithoutError(l, m);
-          almA[i] = A.Data(iA, i_t);
+      for(int l=lMin; l<=lMax; ++l) {
+        for(int m=-l; m<=l; ++m) {
+          C.lm[i][0] = l;
+          C.lm[i][1] = m;
           ++i;
         }
       }
     }
+    C.UpdateModeLayout();
+    C.data.resize(C.lm.size(), C.t.size());
 
-    { // Set the a_lm coefficients of B
-      unsigned int i=0;
-      for(int l=0; l<lMinB; ++l) {
-        for(int m=-l; m<=-l; ++m) {
-          almB[i] = zero;
-          ++i;
+    const std::vector<int>::iterator it = std::find(GridlMax.begin(), GridlMax.end(), lMax);
+    GridIndex[k] = it-GridlMax.begin();
+    if(it==GridlMax.end()) { GridlMax.push_back(lMax); }
+  }
+  const unsigned int NGrids = GridlMax.size();
+
+  // The grids have N_phi = N_theta = 2*lMax+1 points.  For best
+  // accuracy, have N_phi> 2*lMax and N_theta > 2*lMax; but for speed,
+  // don't make them much greater.
+  std::vector<const GWFrames::SHTPlan*> AToGrid(NGrids);
+  std::vector<std::vector<int> > IndicesA(NGrids);
+  for(unsigned int g=0; g<NGrids; ++g) {
+    const int N = 2*GridlMax[g]+1;
+    AToGrid[g] = &GWFrames::SHTPlan::Get(A.SpinWeight(), GridlMax[g], N, N);
+    IndicesA[g] = BinaryOpModeIndices(A, GridlMax[g]);
+  }
+  std::vector<const GWFrames::SHTPlan*> BToGrid(NResults, 0);
+  std::vector<const GWFrames::SHTPlan*> GridToC(NResults);
+  std::vector<std::vector<int> > IndicesB(NResults);
+  for(unsigned int k=0; k<NResults; ++k) {
+    const int lMax = GridlMax[GridIndex[k]];
+    const int N = 2*lMax+1;
+    if(!SameAsA[k]) {
+      BToGrid[k] = &GWFrames::SHTPlan::Get(Bs[k]->SpinWeight(), lMax, N, N);
+      IndicesB[k] = BinaryOpModeIndices(*Bs[k], lMax);
+    }
+    GridToC[k] = &GWFrames::SHTPlan::Get(Cs[k].SpinWeight(), lMax, N, N);
+  }
+
+  // Now, loop through each time step doing the work
+  const std::complex<double> zero(0.0,0.0);
+  const int NTimes = A.NTimes();
+  #pragma omp parallel if(NTimes>1) num_threads(GWFrames::MaxThreads())
+  {
+    std::vector<std::vector<std::complex<double> > > fA(NGrids);
+    std::vector<std::complex<double> > alm, fB, fC;
+
+    #pragma omp for schedule(static)
+    for(int i_t=0; i_t<NTimes; ++i_t) {
+      // Transform A to each grid
+      for(unsigned int g=0; g<NGrids; ++g) {
+        const int N = 2*GridlMax[g]+1;
+        const std::vector<int>& Indices = IndicesA[g];
+        alm.assign(Indices.size(), zero);
+        for(unsigned int i=0; i<Indices.size(); ++i) {
+          if(Indices[i]>=0) { alm[i] = A.data[Indices[i]][i_t]; }
         }
+        fA[g].resize(N*N);
+        AToGrid[g]->Backward(&alm[0], &fA[g][0]);
       }
-      for(int l=lMinB; l<=lMax; ++l) {
-        for(int m=-l; m<=-l; ++m) {
-          const unsigned int iB = B.FindModeIndexWithoutError(l, m);
-          almB[i] = B.Data(iB, i_t);
-          ++i;
+
+      for(unsigned int k=0; k<NResults; ++k) {
+        const std::vector<std::complex<double> >& FA = fA[GridIndex[k]];
+        const int NPoints = FA.size();
+
+        // Transform B, unless it's A
+        const std::complex<double>* FB = &FA[0];
+        if(!SameAsA[k]) {
+          const Waveform& B = *Bs[k];
+          const std::vector<int>& Indices = IndicesB[k];
+          alm.assign(Indices.size(), zero);
+          for(unsigned int i=0; i<Indices.size(); ++i) {
+            if(Indices[i]>=0) { alm[i] = B.data[Indices[i]][i_t]; }
+          }
+          fB.resize(NPoints);
+          BToGrid[k]->Backward(&alm[0], &fB[0]);
+          FB = &fB[0];
         }
-      }
-    }
 
-    { // Transform each and multiply pointwise
-      spinsfast_salm2map(reinterpret_cast<fftw_complex*>(&almA[0]),
-                         reinterpret_cast<fftw_complex*>(&fA[0]),
-                         A.SpinWeight(), N_theta, N_phi, lMax);
-      spinsfast_salm2map(reinterpret_cast<fftw_complex*>(&almB[0]),
-                         reinterpret_cast<fftw_complex*>(&fB[0]),
-                         B.SpinWeight(), N_theta, N_phi, lMax);
-      for(int i=0; i<N_phi*N_theta; ++i) {
-        fC[i] = Op()(fA[i], fB[i]);
-      }
-    }
+        // Multiply pointwise
+        fC.resize(NPoints);
+        if(Conjugate[k]) {
+          for(int i=0; i<NPoints; ++i) { fC[i] = Op()(FA[i], std::conj(FB[i])); }
+        } else {
+          for(int i=0; i<NPoints; ++i) { fC[i] = Op()(FA[i], FB[i]); }
+        }
 
-    // Transform back and record the new data in C
-    spinsfast_map2salm(reinterpret_cast<fftw_complex*>(&fC[0]),
-                       reinterpret_cast<fftw_complex*>(&almC[0]),
-                       C.SpinWeight(), N_theta, N_phi, lMax);
-    for(unsigned int i_m=0; i_m<C.NModes(); ++i_m) {
-      C.SetData(i_m, i_t, almC[i_m+lMin*lMin]);
-    }
+        // Transform back and record the new data in C
+        GWFrames::Waveform& C = Cs[k];
+        alm.resize(IndicesA[GridIndex[k]].size());
+        GridToC[k]->Forward(&fC[0], &alm[0]);
+        const unsigned int Offset = lMins[k]*lMins[k];
+        for(unsigned int i_m=0; i_m<C.NModes(); ++i_m) {
+          C.data[i_m][i_t] = alm[i_m+Offset];
+        }
+      }
+    } // Finish loop over time
+  }
 
-  } // Finish loop over time
+  return Cs;
+}
 
-  return C;
+/// Pointwise multiply this object by another Waveform object
+template <typename Op>
+GWFrames::Waveform GWFrames::Waveform::BinaryOp(const GWFrames::Waveform& B) const {
+  std::vector<GWFrames::Waveform> C = BinaryOps<Op>(std::vector<const GWFrames::Waveform*>(1, &B), std::vector<bool>(0));
+  GWFrames::Waveform Result;
+  Result.swap(C[0]);
+  return Result;
 }
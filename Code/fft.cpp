@@ -1,6 +1,10 @@
 #include "fft.hpp"
 
+#include <map>
+#include <cstdlib>
+#include <fftw3.h>
 #include "Utilities.hpp"
+#include "Errors.hpp"
 
 using namespace std;
 namespace WU = WaveformUtilities;
@@ -8,16 +12,16 @@ namespace WU = WaveformUtilities;
 vector<double> WU::TimeToFrequency(const vector<double>& Time) {
   /// This returns the double-sided frequency-space equivalent of a time vector
   const unsigned int N = Time.size();
-  if(N&(N-1)) {
-    cerr << "\nN=" << N << " is not a power of 2." << endl;
-    throw;
+  if(N<2) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": N=" << N << " is too short to have frequencies." << endl;
+    throw(GWFrames_VectorSizeMismatch);
   }
   const double df = 1.0 / (N*(Time[1]-Time[0]));
   vector<double> Freq(N, 0.0);
-  for(unsigned int i=0; i<N/2;  ++i) {
+  for(unsigned int i=0; i<(N+1)/2;  ++i) {
     Freq[i] = i*df;
   }
-  for(unsigned int i=N/2; i<N; ++i) {
+  for(unsigned int i=(N+1)/2; i<N; ++i) {
     Freq[i] = i*df - N*df;
   }
   return Freq;
@@ -26,9 +30,9 @@ vector<double> WU::TimeToFrequency(const vector<double>& Time) {
 vector<double> WU::TimeToPositiveFrequencies(const vector<double>& Time) {
   /// This returns the single-sided frequency-space equivalent of a time vector
   const unsigned int N = Time.size();
-  if(N&(N-1)) {
-    cerr << "\nN=" << N << " is not a power of 2." << endl;
-    throw;
+  if(N<2) {
+    cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": N=" << N << " is too short to have frequencies." << endl;
+    throw(GWFrames_VectorSizeMismatch);
   }
   const unsigned int n = 1 + (N/2);
   const double df = 1.0 / (N*(Time[1]-Time[0]));
@@ -47,19 +51,144 @@ void WU::WrapVecDoub::validate() {
   }
 }
 
-void four1(vector<double>& data, const int isign);
+GWFrames::Mutex& WU::FFTWPlannerMutex() {
+  static GWFrames::Mutex Planner;
+  return Planner;
+}
+
+#ifndef DOXYGEN
+namespace {
+
+  // Kinds of transform for which plans are cached
+  enum FFTKind { ForwardC2C, BackwardC2C, ForwardR2C, BackwardC2R };
+
+  // Planner state; only touched while holding FFTWPlannerMutex,
+  // because the FFTW planner is not thread safe (though executing plans is)
+  bool MeasurePlans = false;
+  bool WisdomChecked = false;
+  std::map<std::pair<int,int>, fftw_plan> Plans;
+
+  void ImportWisdomFromEnvironment() {
+    if(!WisdomChecked) {
+      WisdomChecked = true;
+      const char* Wisdom = getenv("GWFRAMES_FFTW_WISDOM");
+      if(Wisdom && !fftw_import_wisdom_from_filename(Wisdom)) {
+        cerr << "\n" << __FILE__ << ":" << __LINE__ << ": Could not import FFTW wisdom from '" << Wisdom << "'; continuing without it." << endl;
+      }
+    }
+  }
+
+  // Return the cached plan for this kind and size of transform, making it if needed
+  fftw_plan Plan(const FFTKind Kind, const int N) {
+    fftw_plan plan = 0;
+    {
+      const GWFrames::MutexLock Lock(WU::FFTWPlannerMutex());
+      ImportWisdomFromEnvironment();
+      const std::pair<int,int> Key(int(Kind), N);
+      std::map<std::pair<int,int>, fftw_plan>::const_iterator Cached = Plans.find(Key);
+      if(Cached != Plans.end()) {
+        plan = Cached->second;
+      } else {
+        // Plan on scratch arrays, because FFTW_MEASURE overwrites them.
+        // FFTW_UNALIGNED lets the plan be executed on any other arrays.
+        const unsigned int Flags = (MeasurePlans ? FFTW_MEASURE : FFTW_ESTIMATE) | FFTW_UNALIGNED;
+        fftw_complex* a = (fftw_complex*) fftw_malloc(sizeof(fftw_complex)*(N/2+1));
+        fftw_complex* c = (fftw_complex*) fftw_malloc(sizeof(fftw_complex)*N);
+        double* r = (double*) fftw_malloc(sizeof(double)*N);
+        switch(Kind) {
+        case ForwardC2C:  plan = fftw_plan_dft_1d(N, c, c, FFTW_FORWARD, Flags); break;
+        case BackwardC2C: plan = fftw_plan_dft_1d(N, c, c, FFTW_BACKWARD, Flags); break;
+        case ForwardR2C:  plan = fftw_plan_dft_r2c_1d(N, r, a, Flags); break;
+        case BackwardC2R: plan = fftw_plan_dft_c2r_1d(N, a, r, Flags); break;
+        }
+        fftw_free(r);
+        fftw_free(c);
+        fftw_free(a);
+        if(plan) { Plans[Key] = plan; }
+      }
+    }
+    if(!plan) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": FFTW could not plan a transform of size " << N << endl;
+      throw(GWFrames_FailedSystemCall);
+    }
+    return plan;
+  }
+
+  // In-place complex transform of N points
+  inline void ComplexDFT(complex<double>* data, const int N, const FFTKind Kind) {
+    if(N<1) { return; }
+    fftw_complex* d = reinterpret_cast<fftw_complex*>(data);
+    fftw_execute_dft(Plan(Kind, N), d, d);
+  }
+
+  // Number of complex points in interleaved (re,im) data
+  int NComplex(const vector<double>& data) {
+    if(data.size()%2) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": Interleaved complex data has odd length " << data.size() << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    return data.size()/2;
+  }
+
+  // FFT of real data, packed as in Numerical Recipes' `realft`
+  void realft(vector<double>& data, const int isign) {
+    /// With isign=1, data is replaced by the positive-frequency half
+    /// of its transform (with the NR sign convention, exp(+2 pi i jk/N)),
+    /// as data[2k]+i*data[2k+1], except that data[1] holds the real
+    /// value at the Nyquist frequency.  With isign=-1, this is the
+    /// inverse, times N/2.
+    const int N = data.size();
+    if(N%2 || N<2) {
+      cerr << "\n\n" << __FILE__ << ":" << __LINE__ << ": realft needs an even length; got " << N << endl;
+      throw(GWFrames_VectorSizeMismatch);
+    }
+    vector<complex<double> > F(N/2+1);
+    fftw_complex* f = reinterpret_cast<fftw_complex*>(&F[0]);
+    if(isign == 1) {
+      fftw_execute_dft_r2c(Plan(ForwardR2C, N), &data[0], f);
+      data[0] = F[0].real();
+      data[1] = F[N/2].real();
+      for(int k=1; k<N/2; ++k) {
+        data[2*k] = F[k].real();
+        data[2*k+1] = -F[k].imag();
+      }
+    } else {
+      F[0] = data[0];
+      F[N/2] = data[1];
+      for(int k=1; k<N/2; ++k) {
+        F[k] = complex<double>(data[2*k], -data[2*k+1]);
+      }
+      fftw_execute_dft_c2r(Plan(BackwardC2R, N), f, &data[0]);
+      for(int i=0; i<N; ++i) {
+        data[i] *= 0.5;
+      }
+    }
+  }
+
+}
+#endif // DOXYGEN
 
 void WU::dft(vector<double>& data) {
-  four1(data, -1);
+  const int N = NComplex(data);
+  if(N>0) { ComplexDFT(reinterpret_cast<complex<double>*>(&data[0]), N, ForwardC2C); }
   return;
 }
 
 void WU::idft(vector<double>& data) {
-  four1(data, 1);
+  const int N = NComplex(data);
+  if(N>0) { ComplexDFT(reinterpret_cast<complex<double>*>(&data[0]), N, BackwardC2C); }
   return;
 }
 
-void realft(vector<double> &Data, const int isign);
+void WU::dft(vector<complex<double> >& data) {
+  if(data.size()>0) { ComplexDFT(&data[0], data.size(), ForwardC2C); }
+  return;
+}
+
+void WU::idft(vector<complex<double> >& data) {
+  if(data.size()>0) { ComplexDFT(&data[0], data.size(), BackwardC2C); }
+  return;
+}
 
 void  WU::realdft(std::vector<double>& data) {
   realft(data, 1);
@@ -69,103 +198,39 @@ void  WU::realdft(std::vector<double>& data) {
   return;
 }
 
-
-//// Numerical Recipes routines
-template<class T>
-inline void SWAP(T &a, T &b) {T dum=a; a=b; b=dum;}
-template<class T>
-inline T SQR(const T a) {return a*a;}
-
-void four1(double *data, const int n, const int isign) {
-  int nn,mmax,m,j,istep,i;
-  double wtemp,wr,wpr,wpi,wi,theta,tempr,tempi;
-  if (n<2 || n&(n-1)) {
-    cerr << "n must be power of 2 in four1" << endl;
-    throw;
-  }
-  nn = n << 1;
-  j = 1;
-  for (i=1;i<nn;i+=2) {
-    if (j > i) {
-      SWAP(data[j-1],data[i-1]);
-      SWAP(data[j],data[i]);
-    }
-    m=n;
-    while (m >= 2 && j > m) {
-      j -= m;
-      m >>= 1;
-    }
-    j += m;
-  }
-  mmax=2;
-  while (nn > mmax) {
-    istep=mmax << 1;
-    theta=isign*(6.28318530717959/mmax);
-    wtemp=sin(0.5*theta);
-    wpr = -2.0*wtemp*wtemp;
-    wpi=sin(theta);
-    wr=1.0;
-    wi=0.0;
-    for (m=1;m<mmax;m+=2) {
-      for (i=m;i<=nn;i+=istep) {
-	j=i+mmax;
-	tempr=wr*data[j-1]-wi*data[j];
-	tempi=wr*data[j]+wi*data[j-1];
-	data[j-1]=data[i-1]-tempr;
-	data[j]=data[i]-tempi;
-	data[i-1] += tempr;
-	data[i] += tempi;
-      }
-      wr=(wtemp=wr)*wpr-wi*wpi+wr;
-      wi=wi*wpr+wtemp*wpi+wi;
-    }
-    mmax=istep;
+unsigned int WU::FFTFriendlySize(const unsigned int N) {
+  for(unsigned int M=(N<2 ? 2 : N+N%2); ; M+=2) {
+    unsigned int m = M;
+    while(m%2==0) { m /= 2; }
+    while(m%3==0) { m /= 3; }
+    while(m%5==0) { m /= 5; }
+    while(m%7==0) { m /= 7; }
+    if(m==1) { return M; }
   }
 }
-void four1(vector<double> &data, const int isign) {
-  four1(&data[0],data.size()/2,isign);
+
+bool WU::ImportFFTWisdom(const std::string& FileName) {
+  const GWFrames::MutexLock Lock(WU::FFTWPlannerMutex());
+  ImportWisdomFromEnvironment();
+  return fftw_import_wisdom_from_filename(FileName.c_str());
 }
 
-void realft(vector<double> &data, const int isign) {
-  int i,i1,i2,i3,i4,n=data.size();
-  double c1=0.5,c2,h1r,h1i,h2r,h2i,wr,wi,wpr,wpi,wtemp;
-  double theta=3.141592653589793238/double(n>>1);
-  if (isign == 1) {
-    c2 = -0.5;
-    four1(data,1);
-  } else {
-    c2=0.5;
-    theta = -theta;
-  }
-  wtemp=sin(0.5*theta);
-  wpr = -2.0*wtemp*wtemp;
-  wpi=sin(theta);
-  wr=1.0+wpr;
-  wi=wpi;
-  for (i=1;i<(n>>2);i++) {
-    i2=1+(i1=i+i);
-    i4=1+(i3=n-i1);
-    h1r=c1*(data[i1]+data[i3]);
-    h1i=c1*(data[i2]-data[i4]);
-    h2r= -c2*(data[i2]+data[i4]);
-    h2i=c2*(data[i1]-data[i3]);
-    data[i1]=h1r+wr*h2r-wi*h2i;
-    data[i2]=h1i+wr*h2i+wi*h2r;
-    data[i3]=h1r-wr*h2r+wi*h2i;
-    data[i4]= -h1i+wr*h2i+wi*h2r;
-    wr=(wtemp=wr)*wpr-wi*wpi+wr;
-    wi=wi*wpr+wtemp*wpi+wi;
-  }
-  if (isign == 1) {
-    data[0] = (h1r=data[0])+data[1];
-    data[1] = h1r-data[1];
-  } else {
-    data[0]=c1*((h1r=data[0])+data[1]);
-    data[1]=c1*(h1r-data[1]);
-    four1(data,-1);
-  }
+bool WU::ExportFFTWisdom(const std::string& FileName) {
+  const GWFrames::MutexLock Lock(WU::FFTWPlannerMutex());
+  return fftw_export_wisdom_to_filename(FileName.c_str());
 }
 
+void WU::SetFFTPlanningEffort(const bool Measure) {
+  const GWFrames::MutexLock Lock(WU::FFTWPlannerMutex());
+  MeasurePlans = Measure;
+  return;
+}
+
+
+//// Numerical Recipes routines
+template<class T>
+inline T SQR(const T a) {return a*a;}
+
 void convlv(const vector<double> &data, const vector<double> &respns, const int isign, vector<double> &ans) {
   int i,no2,n=data.size(),m=respns.size();
   double mag2,tmp;
@@ -213,8 +278,8 @@ void convlv(const vector<double> &data, const vector<double> &respns, const int
   realft(ans,-1);
 }
 
-vector<double> convlv(const vector<double>& data, const vector<double>& respns, const int isign) {
+vector<double> WU::convlv(const vector<double>& data, const vector<double>& respns, const int isign) {
   vector<double> ans(data.size());
-  convlv(data, respns, isign, ans);
+  ::convlv(data, respns, isign, ans);
   return ans;
 }
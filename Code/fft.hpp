@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <complex>
+#include <string>
+#include "Utilities.hpp"
 
 namespace WaveformUtilities {
   
@@ -28,13 +30,40 @@ namespace WaveformUtilities {
   /// This function returns the positive half of the frequencies, so returned size is 1/2 input size + 1
   std::vector<double> TimeToPositiveFrequencies(const std::vector<double>& Time);
   
-  /// The following call the Numerical Recipes fft routines (from fourier.h)
+  /// The following transforms are computed by FFTW, and may have any
+  /// length, though lengths with only small prime factors (see
+  /// `FFTFriendlySize`) are fastest.  One plan is made for each kind
+  /// and size of transform the first time it is needed, and reused
+  /// (from any thread) afterwards.  The storage conventions are those
+  /// of the Numerical Recipes routines these replace (from fourier.h).
   /// Note that the returned quantities represent the bare fft sum, with no normalization constants
   void dft(std::vector<double>& data);
   void idft(std::vector<double>& data);
+  void dft(std::vector<std::complex<double> >& data);
+  void idft(std::vector<std::complex<double> >& data);
   void realdft(std::vector<double>& data);
   std::vector<double> convlv(const std::vector<double>& data, const std::vector<double>& respns, const int isign);
   
+  /// Smallest even length >= N whose only prime factors are 2, 3, 5, and 7
+  unsigned int FFTFriendlySize(const unsigned int N);
+  
+  /// FFTW wisdom, to speed up planning.  If the environment variable
+  /// GWFRAMES_FFTW_WISDOM names a file, it is imported before the
+  /// first plan is made.  Both functions return true on success.
+  bool ImportFFTWisdom(const std::string& FileName);
+  bool ExportFFTWisdom(const std::string& FileName);
+  
+  /// With Measure=true, new plans are chosen by timing (FFTW_MEASURE)
+  /// rather than heuristics (FFTW_ESTIMATE, the default).  This is
+  /// worthwhile when many transforms of the same size will be done,
+  /// or when wisdom covering those sizes has been imported.
+  void SetFFTPlanningEffort(const bool Measure);
+  
+  /// The FFTW planner is not thread safe (though executing plans is),
+  /// so this must be held while making or destroying any plan,
+  /// including plans made inside other libraries.
+  GWFrames::Mutex& FFTWPlannerMutex();
+  
 }
 
 #endif // FFT_HPP
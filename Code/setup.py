@@ -119,6 +119,28 @@ if "FFTW3_HOME" in environ :
     IncDirs += [environ["FFTW3_HOME"]+'/include']
     LibDirs += [environ["FFTW3_HOME"]+'/lib']
 
+## See if HDF5_HOME is set; if so, compile in native H5 input/output
+Libraries = ['gsl', 'gslcblas', 'fftw3']
+DefineMacros = []
+if "HDF5_HOME" in environ :
+    IncDirs += [environ["HDF5_HOME"]+'/include']
+    LibDirs += [environ["HDF5_HOME"]+'/lib']
+    Libraries += ['hdf5']
+    DefineMacros += [('USE_HDF5', None)]
+
+## See if USE_OPENMP is set; if so, parallelize the loops over time.
+## Otherwise, the `#pragma omp` lines are ignored without comment.
+OpenMPArgs = []
+PragmaArgs = ['-Wno-unknown-pragmas']
+if "USE_OPENMP" in environ :
+    OpenMPArgs = ['-fopenmp']
+    PragmaArgs = []
+    DefineMacros += [('USE_OPENMP', None)]
+
+## See if USE_INSTRUMENTATION is set; if so, count calls and time in the hot paths
+if "USE_INSTRUMENTATION" in environ :
+    DefineMacros += [('USE_INSTRUMENTATION', None)]
+
 # If /opt/local directories exist, use them
 if isdir('/opt/local/include'):
     IncDirs += ['/opt/local/include']
@@ -228,14 +250,14 @@ setup(name="GWFrames",
                              'GWFrames_Doc.i'],
                   include_dirs=IncDirs,
                   library_dirs=LibDirs,
-                  libraries=['gsl', 'gslcblas', 'fftw3'],
-                  define_macros = [('CodeRevision', CodeRevision)],
+                  libraries=Libraries,
+                  define_macros = [('CodeRevision', CodeRevision)]+DefineMacros,
                   language='c++',
                   swig_opts=swig_opts,
                   extra_objects = glob.glob('spinsfast/build/temp/*/*.o'),
-                  extra_link_args = ['-fPIC',],
+                  extra_link_args = ['-fPIC',]+OpenMPArgs,
                   # extra_link_args=['-Wl,-undefined,error'], # `-undefined,error` is not defined on some platforms...
-                  extra_compile_args=['-Wno-deprecated', '-Wno-unused-variable', '-DUSE_GSL', '-O3', '-ffast-math', '-ftree-vectorize'],
+                  extra_compile_args=['-Wno-deprecated', '-Wno-unused-variable', '-DUSE_GSL', '-O3', '-ffast-math', '-ftree-vectorize']+OpenMPArgs+PragmaArgs,
                   ),
         ],
       # classifiers = ,